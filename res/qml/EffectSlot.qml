@@ -38,6 +38,21 @@ Item {
             activeColor: Theme.effectColor
         }
 
+        Rectangle {
+            id: effectLoadBar
+
+            // Fraction of the audio callback spent in this effect. The bar
+            // turns red while the effect is bypassed to keep the audio
+            // processing within the latency budget.
+            anchors.left: effectEnableButton.left
+            anchors.top: effectEnableButton.bottom
+            anchors.topMargin: 1
+            width: effectEnableButton.width * Math.min(1, root.slot.bypassed ? 1 : root.slot.audioLatencyUsage * 4)
+            height: 3
+            color: root.slot.bypassed ? Theme.red : Theme.effectColor
+            visible: root.slot.bypassed || root.slot.audioLatencyUsage > 0
+        }
+
         Skin.ComboBox {
             id: effectSelector
 
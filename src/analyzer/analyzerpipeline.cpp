@@ -0,0 +1,137 @@
+#include "analyzer/analyzerpipeline.h"
+
+#include <algorithm>
+
+#include "analyzer/constants.h"
+#include "util/assert.h"
+#include "util/compatibility/qmutex.h"
+#include "util/logger.h"
+
+namespace {
+
+mixxx::Logger kLogger("AnalyzerPipeline");
+
+} // anonymous namespace
+
+class AnalyzerPipeline::Consumer : public QThread {
+  public:
+    Consumer(AnalyzerPipeline* pPipeline, int analyzerIndex)
+            : m_pPipeline(pPipeline),
+              m_analyzerIndex(analyzerIndex) {
+        setObjectName(QStringLiteral("AnalyzerPipeline %1").arg(analyzerIndex));
+    }
+
+  protected:
+    void run() override {
+        m_pPipeline->consumeChunks(m_analyzerIndex);
+    }
+
+  private:
+    AnalyzerPipeline* const m_pPipeline;
+    const int m_analyzerIndex;
+};
+
+AnalyzerPipeline::AnalyzerPipeline(
+        std::vector<AnalyzerWithState>* pAnalyzers,
+        QThread::Priority priority)
+        : m_pAnalyzers(pAnalyzers),
+          m_sampleBuffer(mixxx::kAnalysisSamplesPerChunk * kNumSlots),
+          m_slots{},
+          m_numPublishedChunks(0),
+          m_numConsumedChunks(pAnalyzers->size(), 0),
+          m_numConsumedSamples(pAnalyzers->size(), 0),
+          m_discard(false),
+          m_quit(false) {
+    DEBUG_ASSERT(!m_pAnalyzers->empty());
+    m_consumers.reserve(m_pAnalyzers->size());
+    for (int i = 0; i < static_cast<int>(m_pAnalyzers->size()); ++i) {
+        m_consumers.push_back(std::make_unique<Consumer>(this, i));
+        m_consumers.back()->start(priority);
+    }
+    kLogger.debug()
+            << "Started" << m_consumers.size() << "analyzer threads";
+}
+
+AnalyzerPipeline::~AnalyzerPipeline() {
+    {
+        const auto locker = lockMutex(&m_mutex);
+        m_quit = true;
+        m_chunkPublished.wakeAll();
+    }
+    for (const auto& pConsumer : m_consumers) {
+        pConsumer->wait();
+    }
+}
+
+quint64 AnalyzerPipeline::minConsumedChunks() const {
+    return *std::min_element(m_numConsumedChunks.begin(), m_numConsumedChunks.end());
+}
+
+quint64 AnalyzerPipeline::numAnalyzedSamples() const {
+    const auto locker = lockMutex(&m_mutex);
+    return *std::min_element(m_numConsumedSamples.begin(), m_numConsumedSamples.end());
+}
+
+mixxx::SampleBuffer::WritableSlice AnalyzerPipeline::nextWritableSlot() {
+    const auto locker = lockMutex(&m_mutex);
+    while (m_numPublishedChunks - minConsumedChunks() >= kNumSlots) {
+        m_chunkConsumed.wait(&m_mutex);
+    }
+    const int slot = static_cast<int>(m_numPublishedChunks % kNumSlots);
+    return mixxx::SampleBuffer::WritableSlice(
+            m_sampleBuffer,
+            slot * mixxx::kAnalysisSamplesPerChunk,
+            mixxx::kAnalysisSamplesPerChunk);
+}
+
+void AnalyzerPipeline::publishChunk(const CSAMPLE* pSamples, SINT numSamples) {
+    const auto locker = lockMutex(&m_mutex);
+    DEBUG_ASSERT(m_numPublishedChunks - minConsumedChunks() < kNumSlots);
+    Slot& slot = m_slots[m_numPublishedChunks % kNumSlots];
+    slot.pSamples = pSamples;
+    slot.numSamples = numSamples;
+    ++m_numPublishedChunks;
+    m_chunkPublished.wakeAll();
+}
+
+void AnalyzerPipeline::drain() {
+    const auto locker = lockMutex(&m_mutex);
+    while (minConsumedChunks() < m_numPublishedChunks) {
+        m_chunkConsumed.wait(&m_mutex);
+    }
+}
+
+void AnalyzerPipeline::discard() {
+    const auto locker = lockMutex(&m_mutex);
+    m_discard = true;
+    while (minConsumedChunks() < m_numPublishedChunks) {
+        m_chunkConsumed.wait(&m_mutex);
+    }
+    m_discard = false;
+}
+
+void AnalyzerPipeline::consumeChunks(int analyzerIndex) {
+    AnalyzerWithState& analyzer = (*m_pAnalyzers)[analyzerIndex];
+    auto locker = lockMutex(&m_mutex);
+    while (true) {
+        quint64& numConsumedChunks = m_numConsumedChunks[analyzerIndex];
+        while (!m_quit && numConsumedChunks == m_numPublishedChunks) {
+            m_chunkPublished.wait(&m_mutex);
+        }
+        if (m_quit) {
+            break;
+        }
+        const Slot slot = m_slots[numConsumedChunks % kNumSlots];
+        const bool discard = m_discard;
+        locker.unlock();
+        if (!discard) {
+            // The analyzer is only accessed by this thread until the
+            // pipeline has been drained
+            analyzer.processSamples(slot.pSamples, slot.numSamples);
+        }
+        locker.relock();
+        ++numConsumedChunks;
+        m_numConsumedSamples[analyzerIndex] += slot.numSamples;
+        m_chunkConsumed.wakeAll();
+    }
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <QMutex>
+#include <QThread>
+#include <QWaitCondition>
+#include <memory>
+#include <vector>
+
+#include "analyzer/analyzer.h"
+#include "util/samplebuffer.h"
+
+/// AnalyzerPipeline runs each analyzer of an AnalyzerThread on its own
+/// thread while the AnalyzerThread itself only decodes the audio data.
+///
+/// Every chunk is decoded once into a slot of a ring buffer and then
+/// processed by all analyzers concurrently. The analyzers only read from
+/// the slots. A slot is reused after all analyzers have processed it, i.e.
+/// the slowest analyzer throttles decoding and the memory consumption is
+/// bounded by kNumSlots chunks.
+///
+/// The analyzers are owned by the AnalyzerThread. Only initialize(),
+/// finish() and cancel() are invoked from the AnalyzerThread and only while
+/// the pipeline is drained, i.e. after drain() or discard() returned.
+class AnalyzerPipeline final {
+  public:
+    /// The number of chunks that could be decoded ahead of the slowest
+    /// analyzer. Covers ~1.5 s of audio at 44.1 kHz.
+    static constexpr int kNumSlots = 16;
+
+    AnalyzerPipeline(
+            std::vector<AnalyzerWithState>* pAnalyzers,
+            QThread::Priority priority);
+    ~AnalyzerPipeline();
+
+    /// Returns a slot for the next chunk with room for
+    /// mixxx::kAnalysisSamplesPerChunk samples. Blocks until the analyzers
+    /// have released the slot. The same slot is returned again until the
+    /// chunk is published.
+    mixxx::SampleBuffer::WritableSlice nextWritableSlot();
+
+    /// Hands over the samples of the next chunk to all analyzers. The data
+    /// must be located within the slot returned by nextWritableSlot().
+    void publishChunk(const CSAMPLE* pSamples, SINT numSamples);
+
+    /// The total number of samples that all analyzers have processed,
+    /// including those of previous tracks.
+    quint64 numAnalyzedSamples() const;
+
+    /// Blocks until all published chunks have been processed.
+    void drain();
+
+    /// Same as drain(), but the analyzers skip all pending chunks.
+    void discard();
+
+  private:
+    class Consumer;
+    struct Slot {
+        const CSAMPLE* pSamples;
+        SINT numSamples;
+    };
+
+    void consumeChunks(int analyzerIndex);
+
+    // Must be called while holding m_mutex
+    quint64 minConsumedChunks() const;
+
+    std::vector<AnalyzerWithState>* const m_pAnalyzers;
+
+    mixxx::SampleBuffer m_sampleBuffer;
+    Slot m_slots[kNumSlots];
+
+    mutable QMutex m_mutex;
+    QWaitCondition m_chunkPublished;
+    QWaitCondition m_chunkConsumed;
+    // Sequence numbers that are never reset between tracks
+    quint64 m_numPublishedChunks;
+    std::vector<quint64> m_numConsumedChunks;
+    std::vector<quint64> m_numConsumedSamples;
+    bool m_discard;
+    bool m_quit;
+
+    std::vector<std::unique_ptr<Consumer>> m_consumers;
+};
@@ -71,6 +71,30 @@ AnalyzerThread::Pointer AnalyzerThread::createInstance(
             deleteAnalyzerThread);
 }
 
+//static
+int AnalyzerThread::numThreadsPerTrack(
+        const UserSettingsPointer& pConfig,
+        AnalyzerModeFlags modeFlags) {
+    if (!(modeFlags & AnalyzerModeFlags::Pipelined)) {
+        return 1;
+    }
+    // The decoding thread and one thread per analyzer. Must match the
+    // analyzers that are created in doRun().
+    int numThreads = 1;
+    if (modeFlags & AnalyzerModeFlags::WithWaveform) {
+        ++numThreads;
+    }
+    if (AnalyzerGain::isEnabled(ReplayGainSettings(pConfig))) {
+        ++numThreads;
+    }
+    if (AnalyzerEbur128::isEnabled(ReplayGainSettings(pConfig))) {
+        ++numThreads;
+    }
+    // Beats, key, and silence
+    numThreads += 3;
+    return numThreads;
+}
+
 AnalyzerThread::AnalyzerThread(
         int id,
         mixxx::DbConnectionPoolPtr dbConnectionPool,
@@ -120,6 +144,14 @@ void AnalyzerThread::doRun() {
     DEBUG_ASSERT(!m_analyzers.empty());
     kLogger.debug() << "Activated" << m_analyzers.size() << "analyzers";
 
+    if (m_modeFlags & AnalyzerModeFlags::Pipelined) {
+        DEBUG_ASSERT(numThreadsPerTrack(m_pConfig, m_modeFlags) ==
+                1 + static_cast<int>(m_analyzers.size()));
+        m_pPipeline = std::make_unique<AnalyzerPipeline>(
+                &m_analyzers,
+                priority());
+    }
+
     m_lastBusyProgressEmittedTimer.start();
 
     mixxx::AudioSource::OpenParams openParams;
@@ -154,6 +186,15 @@ void AnalyzerThread::doRun() {
         if (processTrack) {
             const auto analysisResult = analyzeAudioSource(audioSource);
             DEBUG_ASSERT(analysisResult != AnalysisResult::Pending);
+            if (m_pPipeline) {
+                // The analyzers must not be accessed from this thread
+                // before they have processed all pending chunks
+                if (analysisResult == AnalysisResult::Finished) {
+                    m_pPipeline->drain();
+                } else {
+                    m_pPipeline->discard();
+                }
+            }
             if (analysisResult == AnalysisResult::Finished) {
                 // The analysis has been finished, and is either complete without
                 // any errors or partial if it has been aborted due to a corrupt
@@ -181,6 +222,7 @@ void AnalyzerThread::doRun() {
     DEBUG_ASSERT(!m_currentTrack);
     DEBUG_ASSERT(isStopping());
 
+    m_pPipeline.reset();
     m_analyzers.clear();
 
     kLogger.debug() << "Exiting worker thread";
@@ -229,6 +271,12 @@ AnalyzerThread::AnalysisResult AnalyzerThread::analyzeAudioSource(
             audioSourceProxy.getSignalInfo().getChannelCount() ==
             mixxx::kAnalysisChannels);
 
+    // In pipelined mode the progress of the slowest analyzer is reported
+    // instead of the decoding progress. The pipeline is drained between
+    // tracks, i.e. all samples that have been published before belong to
+    // previous tracks.
+    const quint64 firstAnalyzedSample = m_pPipeline ? m_pPipeline->numAnalyzedSamples() : 0;
+
     // Analysis starts now
     emitBusyProgress(kAnalyzerProgressNone);
 
@@ -247,12 +295,16 @@ AnalyzerThread::AnalysisResult AnalyzerThread::analyzeAudioSource(
                         math_min(mixxx::kAnalysisFramesPerChunk, remainingFrameRange.length()));
         DEBUG_ASSERT(!chunkFrameRange.empty());
 
-        // Request the next chunk of audio data
+        // Request the next chunk of audio data. In pipelined mode the
+        // data is decoded directly into the ring buffer of the pipeline.
         const auto readableSampleFrames =
                 audioSourceProxy.readSampleFrames(
                         mixxx::WritableSampleFrames(
                                 chunkFrameRange,
-                                mixxx::SampleBuffer::WritableSlice(m_sampleBuffer)));
+                                m_pPipeline
+                                        ? m_pPipeline->nextWritableSlot()
+                                        : mixxx::SampleBuffer::WritableSlice(
+                                                  m_sampleBuffer)));
         // The returned range fits into the requested range
         DEBUG_ASSERT(readableSampleFrames.frameIndexRange().isSubrangeOf(chunkFrameRange));
 
@@ -297,10 +349,16 @@ AnalyzerThread::AnalysisResult AnalyzerThread::analyzeAudioSource(
 
         // 2nd: step: Analyze chunk of decoded audio data
         if (!readableSampleFrames.frameIndexRange().empty()) {
-            for (auto&& analyzer : m_analyzers) {
-                analyzer.processSamples(
+            if (m_pPipeline) {
+                m_pPipeline->publishChunk(
                         readableSampleFrames.readableData(),
                         readableSampleFrames.readableLength());
+            } else {
+                for (auto&& analyzer : m_analyzers) {
+                    analyzer.processSamples(
+                            readableSampleFrames.readableData(),
+                            readableSampleFrames.readableLength());
+                }
             }
         }
 
@@ -309,15 +367,22 @@ AnalyzerThread::AnalysisResult AnalyzerThread::analyzeAudioSource(
 
         // 3rd step: Update & emit progress
         if (audioSource->frameLength() > 0) {
+            const SINT progressFrames = m_pPipeline
+                    ? static_cast<SINT>(
+                              (m_pPipeline->numAnalyzedSamples() - firstAnalyzedSample) /
+                              mixxx::kAnalysisChannels)
+                    : audioSource->frameLength() - remainingFrameRange.length();
             const double frameProgress =
-                    double(audioSource->frameLength() - remainingFrameRange.length()) /
+                    double(progressFrames) /
                     double(audioSource->frameLength());
             // math_min is required to compensate rounding errors
             const AnalyzerProgress progress =
                     math_min(kAnalyzerProgressFinalizing,
                             frameProgress *
                                     (kAnalyzerProgressFinalizing - kAnalyzerProgressNone));
-            DEBUG_ASSERT(progress > kAnalyzerProgressNone);
+            // The analyzers might not have processed any chunk yet
+            DEBUG_ASSERT(progress > kAnalyzerProgressNone ||
+                    (m_pPipeline && progress == kAnalyzerProgressNone));
             emitBusyProgress(progress);
         } else {
             // Unreadable audio source
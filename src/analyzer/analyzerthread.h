@@ -4,6 +4,7 @@
 #include <vector>
 
 #include "analyzer/analyzer.h"
+#include "analyzer/analyzerpipeline.h"
 #include "analyzer/analyzerprogress.h"
 #include "analyzer/analyzertrack.h"
 #include "preferences/usersettings.h"
@@ -22,6 +23,9 @@ enum AnalyzerModeFlags {
     WithBeats = 0x01,
     WithWaveform = 0x02,
     LowPriority = 0x04,
+    // Decode each track once and run the analyzers concurrently
+    // (see AnalyzerPipeline)
+    Pipelined = 0x08,
     All = WithBeats | WithWaveform,
 };
 
@@ -68,6 +72,13 @@ class AnalyzerThread : public WorkerThread {
             AnalyzerModeFlags modeFlags);
     ~AnalyzerThread() override = default;
 
+    /// The number of threads that a single AnalyzerThread keeps busy
+    /// while analyzing a track, i.e. including the analyzer threads of
+    /// the pipeline in pipelined mode.
+    static int numThreadsPerTrack(
+            const UserSettingsPointer& pConfig,
+            AnalyzerModeFlags modeFlags);
+
     int id() const {
         return m_id;
     }
@@ -118,6 +129,9 @@ class AnalyzerThread : public WorkerThread {
 
     std::vector<AnalyzerWithState> m_analyzers;
 
+    // Only used with AnalyzerModeFlags::Pipelined
+    std::unique_ptr<AnalyzerPipeline> m_pPipeline;
+
     mixxx::SampleBuffer m_sampleBuffer;
 
     std::optional<AnalyzerTrack> m_currentTrack;
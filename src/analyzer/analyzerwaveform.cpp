@@ -270,6 +270,8 @@ void AnalyzerWaveform::storeResults(TrackPointer tio) {
     if (m_waveform) {
         m_waveform->setSaveState(Waveform::SaveState::SavePending);
         m_waveform->setCompletion(m_waveform->getDataSize());
+        // Stored together with the waveform for rendering when zoomed out
+        m_waveform->buildLevels();
         m_waveform->setVersion(WaveformFactory::currentWaveformVersion());
         m_waveform->setDescription(WaveformFactory::currentWaveformDescription());
     }
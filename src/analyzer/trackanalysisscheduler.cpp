@@ -1,11 +1,14 @@
 #include "analyzer/trackanalysisscheduler.h"
 
+#include <algorithm>
+
 #include "analyzer/analyzerscheduledtrack.h"
 #include "analyzer/analyzertrack.h"
 #include "moc_trackanalysisscheduler.cpp"
 #include "track/track.h"
 #include "track/trackid.h"
 #include "util/logger.h"
+#include "util/stat.h"
 
 namespace {
 
@@ -16,6 +19,30 @@ constexpr QThread::Priority kWorkerThreadPriority = QThread::LowPriority;
 // Maximum frequency of progress updates
 constexpr std::chrono::milliseconds kProgressInhibitDuration(100);
 
+// Decoding and analysis costs per second of audio relative to
+// uncompressed PCM. Rough estimates that only need to be accurate
+// enough to order the tracks.
+double analysisCostFactor(const QString& fileType) {
+    const QString type = fileType.toLower();
+    if (type == QLatin1String("wav") ||
+            type == QLatin1String("aif") ||
+            type == QLatin1String("aiff")) {
+        return 1.0;
+    }
+    if (type == QLatin1String("flac") ||
+            type == QLatin1String("wv")) {
+        return 1.2;
+    }
+    if (type == QLatin1String("mp3")) {
+        return 1.4;
+    }
+    if (type == QLatin1String("opus")) {
+        return 1.6;
+    }
+    // m4a, aac, ogg, ...
+    return 1.5;
+}
+
 void deleteTrackAnalysisScheduler(TrackAnalysisScheduler* plainPtr) {
     if (plainPtr) {
         // Trigger stop
@@ -58,7 +85,9 @@ TrackAnalysisScheduler::TrackAnalysisScheduler(
           m_currentTrackNumber(0),
           m_dequeuedTracksCount(0),
           // The first signal should always be emitted
-          m_lastProgressEmittedAt(Clock::now() - kProgressInhibitDuration) {
+          m_lastProgressEmittedAt(Clock::now() - kProgressInhibitDuration),
+          m_pipelined((modeFlags & AnalyzerModeFlags::Pipelined) != 0),
+          m_batchAnalyzedTracksCount(0) {
     DEBUG_ASSERT(m_pEnvironment);
     VERIFY_OR_DEBUG_ASSERT(numWorkerThreads > 0) {
             kLogger.warning()
@@ -99,6 +128,7 @@ void TrackAnalysisScheduler::emitProgressOrFinished() {
     // The finished() signal is emitted regardless of when the last
     // signal has been emitted
     if (allTracksFinished()) {
+        reportThroughput();
         m_currentTrackProgress = kAnalyzerProgressUnknown;
         m_currentTrackNumber = 0;
         m_dequeuedTracksCount = 0;
@@ -180,6 +210,45 @@ void TrackAnalysisScheduler::emitProgressOrFinished() {
             totalTracksCount);
 }
 
+void TrackAnalysisScheduler::reportThroughput() {
+    if (m_batchAnalyzedTracksCount <= 0) {
+        return;
+    }
+    const double elapsedSeconds =
+            std::chrono::duration<double>(Clock::now() - m_batchStartedAt).count();
+    if (elapsedSeconds > 0) {
+        const double tracksPerHour = m_batchAnalyzedTracksCount * 3600.0 / elapsedSeconds;
+        const double tracksPerMinute = tracksPerHour / 60.0;
+        kLogger.info()
+                << "Analyzed"
+                << m_batchAnalyzedTracksCount
+                << "tracks in"
+                << elapsedSeconds
+                << "s using"
+                << m_workers.size()
+                << (m_pipelined ? "pipelined workers:" : "workers:")
+                << tracksPerMinute
+                << "tracks/minute,"
+                << tracksPerHour
+                << "tracks/hour";
+        Stat::track(m_pipelined
+                        ? QStringLiteral("TrackAnalysisScheduler pipelined tracks/hour")
+                        : QStringLiteral("TrackAnalysisScheduler tracks/hour"),
+                Stat::UNSPECIFIED,
+                Stat::experimentFlags(
+                        Stat::COUNT | Stat::AVERAGE | Stat::MIN | Stat::MAX),
+                tracksPerHour);
+        Stat::track(m_pipelined
+                        ? QStringLiteral("TrackAnalysisScheduler pipelined tracks/minute")
+                        : QStringLiteral("TrackAnalysisScheduler tracks/minute"),
+                Stat::UNSPECIFIED,
+                Stat::experimentFlags(
+                        Stat::COUNT | Stat::AVERAGE | Stat::MIN | Stat::MAX),
+                tracksPerMinute);
+    }
+    m_batchAnalyzedTracksCount = 0;
+}
+
 void TrackAnalysisScheduler::onWorkerThreadProgress(
         int threadId,
         AnalyzerThreadState threadState,
@@ -221,6 +290,7 @@ void TrackAnalysisScheduler::onWorkerThreadProgress(
             DEBUG_ASSERT((analyzerProgress == kAnalyzerProgressDone) // success
                     || (analyzerProgress == kAnalyzerProgressUnknown)); // failure
             m_pendingTrackIds.erase(trackId);
+            ++m_batchAnalyzedTracksCount;
             worker.onAnalyzerProgress(analyzerProgress);
             emit trackProgress(trackId, analyzerProgress);
         }
@@ -237,31 +307,80 @@ void TrackAnalysisScheduler::onWorkerThreadProgress(
     emitProgressOrFinished();
 }
 
-bool TrackAnalysisScheduler::scheduleTrack(AnalyzerScheduledTrack track) {
+bool TrackAnalysisScheduler::enqueueTrack(AnalyzerScheduledTrack track) {
     VERIFY_OR_DEBUG_ASSERT(track.getTrackId().isValid()) {
         qWarning()
                 << "Cannot schedule track with invalid id"
                 << track.getTrackId();
         return false;
     }
-    m_queuedTracks.push_back(track);
+    m_queuedTracks.push_back(QueuedTrack{std::move(track), 0.0, Clock::now()});
+    return true;
+}
+
+bool TrackAnalysisScheduler::scheduleTrack(AnalyzerScheduledTrack track) {
     // Don't wake up the suspended thread now to avoid race conditions
     // if multiple threads are added in a row by calling this function
     // multiple times. The caller is responsible to finish the scheduling
     // of multiple tracks with resume().
-    return true;
+    return enqueueTrack(std::move(track));
 }
 
 int TrackAnalysisScheduler::scheduleTracks(const QList<AnalyzerScheduledTrack>& tracks) {
+    const std::size_t firstIndex = m_queuedTracks.size();
     int scheduledCount = 0;
     for (auto track : tracks) {
-        if (scheduleTrack(std::move(track))) {
+        if (enqueueTrack(std::move(track))) {
             ++scheduledCount;
         }
     }
+    if (scheduledCount > 1) {
+        sortQueuedTracksByCost(firstIndex);
+    }
     return scheduledCount;
 }
 
+void TrackAnalysisScheduler::sortQueuedTracksByCost(std::size_t firstIndex) {
+    DEBUG_ASSERT(firstIndex <= m_queuedTracks.size());
+    const auto first = m_queuedTracks.begin() + firstIndex;
+    QSet<TrackId> trackIds;
+    trackIds.reserve(static_cast<int>(m_queuedTracks.end() - first));
+    for (auto it = first; it != m_queuedTracks.end(); ++it) {
+        trackIds.insert(it->track.getTrackId());
+    }
+    const auto costInfos = m_pEnvironment->loadTrackCostInfos(trackIds);
+    sortTracksByCost(first, m_queuedTracks.end(), costInfos);
+    if (kLogger.debugEnabled()) {
+        kLogger.debug()
+                << "Ordered"
+                << trackIds.size()
+                << "tracks by estimated costs, found"
+                << costInfos.size()
+                << "in the library";
+    }
+}
+
+// static
+void TrackAnalysisScheduler::sortTracksByCost(
+        std::deque<QueuedTrack>::iterator first,
+        std::deque<QueuedTrack>::iterator last,
+        const QHash<TrackId, TrackAnalysisSchedulerEnvironment::TrackCostInfo>& costInfos) {
+    for (auto it = first; it != last; ++it) {
+        const auto costInfo = costInfos.constFind(it->track.getTrackId());
+        if (costInfo != costInfos.constEnd()) {
+            it->cost = costInfo->duration.toDoubleSeconds() *
+                    analysisCostFactor(costInfo->fileType);
+        }
+    }
+    // Tracks with unknown costs are moved to the end while preserving
+    // the order in which they have been scheduled
+    std::stable_sort(first,
+            last,
+            [](const QueuedTrack& lhs, const QueuedTrack& rhs) {
+                return lhs.cost > rhs.cost;
+            });
+}
+
 void TrackAnalysisScheduler::suspend() {
     kLogger.debug() << "Suspending";
     for (auto& worker: m_workers) {
@@ -279,7 +398,8 @@ void TrackAnalysisScheduler::resume() {
 bool TrackAnalysisScheduler::submitNextTrack(Worker* worker) {
     DEBUG_ASSERT(worker);
     while (!m_queuedTracks.empty()) {
-        AnalyzerScheduledTrack nextScheduledTrack = m_queuedTracks.front();
+        const QueuedTrack& nextQueuedTrack = m_queuedTracks.front();
+        const AnalyzerScheduledTrack nextScheduledTrack = nextQueuedTrack.track;
         TrackId nextTrackId = nextScheduledTrack.getTrackId();
         DEBUG_ASSERT(nextTrackId.isValid());
         if (nextTrackId.isValid()) {
@@ -289,6 +409,18 @@ bool TrackAnalysisScheduler::submitNextTrack(Worker* worker) {
                 AnalyzerTrack nextTrack(nextTrackPtr, nextScheduledTrack.getOptions());
                 if (m_pendingTrackIds.insert(nextTrackId).second) {
                     if (worker->submitNextTrack(std::move(nextTrack))) {
+                        const auto now = Clock::now();
+                        if (m_batchAnalyzedTracksCount == 0 &&
+                                m_pendingTrackIds.size() == 1) {
+                            m_batchStartedAt = now;
+                        }
+                        Stat::track(QStringLiteral("TrackAnalysisScheduler queue time"),
+                                Stat::DURATION_MSEC,
+                                Stat::experimentFlags(Stat::COUNT |
+                                        Stat::AVERAGE | Stat::MIN | Stat::MAX),
+                                std::chrono::duration<double, std::milli>(
+                                        now - nextQueuedTrack.queuedAt)
+                                        .count());
                         m_queuedTracks.pop_front();
                         ++m_dequeuedTracksCount;
                         return true;
@@ -1,6 +1,8 @@
 #pragma once
 
+#include <QHash>
 #include <QList>
+#include <QSet>
 #include <deque>
 #include <memory>
 #include <set>
@@ -10,6 +12,7 @@
 #include "analyzer/analyzerthread.h"
 #include "analyzer/analyzertrack.h"
 #include "util/db/dbconnectionpool.h"
+#include "util/duration.h"
 
 /// Callbacks for triggering side-effects in the outer context of
 /// TrackAnalysisScheduler.
@@ -21,8 +24,27 @@ class TrackAnalysisSchedulerEnvironment {
     virtual ~TrackAnalysisSchedulerEnvironment() = default;
 
     virtual TrackPointer loadTrackById(TrackId trackId) const = 0;
+
+    /// Library metadata for estimating how long the analysis of a
+    /// track will take without actually loading the track.
+    struct TrackCostInfo {
+        mixxx::Duration duration;
+        QString fileType;
+    };
+
+    /// Tracks without any information are omitted from the result.
+    virtual QHash<TrackId, TrackCostInfo> loadTrackCostInfos(
+            const QSet<TrackId>& trackIds) const = 0;
 };
 
+/// Distributes the analysis of scheduled tracks among multiple worker
+/// threads.
+///
+/// Workers pull the next track from a shared queue as soon as they become
+/// idle. The tracks of a batch that is scheduled at once are ordered by
+/// their estimated analysis cost, longest first. Short tracks at the end of
+/// the queue fill the gaps between workers and the batch is not delayed by
+/// a single worker that picked a long track last.
 class TrackAnalysisScheduler : public QObject {
     Q_OBJECT
 
@@ -50,7 +72,8 @@ class TrackAnalysisScheduler : public QObject {
     ~TrackAnalysisScheduler() override;
 
     // Schedule single or multiple tracks. After all tracks have been scheduled
-    // the caller must invoke resume() once.
+    // the caller must invoke resume() once. Single tracks are analyzed in
+    // the order they have been scheduled.
     bool scheduleTrack(AnalyzerScheduledTrack track);
     int scheduleTracks(const QList<AnalyzerScheduledTrack>& tracks);
 
@@ -75,6 +98,8 @@ class TrackAnalysisScheduler : public QObject {
     void onWorkerThreadProgress(int threadId, AnalyzerThreadState threadState, TrackId trackId, AnalyzerProgress analyzerProgress);
 
   private:
+    friend class TrackAnalysisSchedulerTest;
+
     // Owns an analyzer thread and buffers the most recent progress update
     // received from this thread during analysis. It does not need to be
     // thread-safe, because all functions are invoked from the host thread
@@ -140,9 +165,30 @@ class TrackAnalysisScheduler : public QObject {
         AnalyzerProgress m_analyzerProgress;
     };
 
+    typedef std::chrono::steady_clock Clock;
+
+    struct QueuedTrack {
+        AnalyzerScheduledTrack track;
+        // Estimated relative costs, 0 if unknown
+        double cost;
+        Clock::time_point queuedAt;
+    };
+
+    bool enqueueTrack(AnalyzerScheduledTrack track);
+    // Orders the tracks in the queue from the given position until the end
+    void sortQueuedTracksByCost(std::size_t firstIndex);
+    static void sortTracksByCost(
+            std::deque<QueuedTrack>::iterator first,
+            std::deque<QueuedTrack>::iterator last,
+            const QHash<TrackId, TrackAnalysisSchedulerEnvironment::TrackCostInfo>&
+                    costInfos);
+
     bool submitNextTrack(Worker* worker);
     void emitProgressOrFinished();
 
+    // Logs the throughput of the batch of tracks that has just finished
+    void reportThroughput();
+
     bool allTracksFinished() const {
         return m_queuedTracks.empty() &&
                 m_pendingTrackIds.empty();
@@ -152,7 +198,7 @@ class TrackAnalysisScheduler : public QObject {
 
     std::vector<Worker> m_workers;
 
-    std::deque<AnalyzerScheduledTrack> m_queuedTracks;
+    std::deque<QueuedTrack> m_queuedTracks;
 
     // Tracks that have already been submitted to workers
     // and not yet reported back as finished.
@@ -164,6 +210,11 @@ class TrackAnalysisScheduler : public QObject {
 
     int m_dequeuedTracksCount;
 
-    typedef std::chrono::steady_clock Clock;
     Clock::time_point m_lastProgressEmittedAt;
+
+    // Throughput of the current batch, i.e. since the first track has been
+    // submitted after all previous tracks finished
+    const bool m_pipelined;
+    Clock::time_point m_batchStartedAt;
+    int m_batchAnalyzedTracksCount;
 };
@@ -1,5 +1,6 @@
 #include "control/controlobjectscript.h"
 
+#include "controllers/scripting/legacy/scriptconnectionbatcher.h"
 #include "moc_controlobjectscript.cpp"
 
 ControlObjectScript::ControlObjectScript(
@@ -7,7 +8,14 @@ ControlObjectScript::ControlObjectScript(
         : ControlProxy(key, pParent, ControlFlag::AllowMissingOrInvalid),
           m_logger(logger),
           m_proxy(key, logger, this),
-          m_skipSuperseded(false) {
+          m_skipSuperseded(false),
+          m_pBatcher(nullptr) {
+}
+
+ControlObjectScript::~ControlObjectScript() {
+    if (m_pBatcher) {
+        m_pBatcher->removeControl(this);
+    }
 }
 
 bool ControlObjectScript::addScriptConnection(const ScriptConnection& conn) {
@@ -128,6 +136,10 @@ void ControlObjectScript::disconnectAllConnectionsToFunction(const QJSValue& fun
 }
 
 void ControlObjectScript::slotValueChanged(double value, QObject*) {
+    if (m_pBatcher && m_pBatcher->isEnabled()) {
+        m_pBatcher->queueValueChange(this, value);
+        return;
+    }
     // Make a local copy of m_connectedScriptFunctions first.
     // This allows a script to disconnect a callback from inside the
     // the callback. Otherwise the this may crash since the disconnect call
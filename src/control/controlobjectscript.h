@@ -7,6 +7,8 @@
 #include "controllers/scripting/legacy/scriptconnection.h"
 #include "util/runtimeloggingcategory.h"
 
+class ScriptConnectionBatcher;
+
 // this is used for communicate with controller scripts
 class ControlObjectScript : public ControlProxy {
     Q_OBJECT
@@ -14,6 +16,7 @@ class ControlObjectScript : public ControlProxy {
     explicit ControlObjectScript(const ConfigKey& key,
             const RuntimeLoggingCategory& logger,
             QObject* pParent = nullptr);
+    ~ControlObjectScript() override;
 
     bool addScriptConnection(const ScriptConnection& conn);
 
@@ -26,6 +29,16 @@ class ControlObjectScript : public ControlProxy {
             return m_scriptConnections.first(); };
     void disconnectAllConnectionsToFunction(const QJSValue& function);
 
+    const QVector<ScriptConnection>& scriptConnections() const {
+        return m_scriptConnections;
+    }
+
+    /// Value changes are passed to the batcher instead of executing the
+    /// callbacks directly while batching is enabled
+    void setBatcher(ScriptConnectionBatcher* pBatcher) {
+        m_pBatcher = pBatcher;
+    }
+
     // Called from update();
     void emitValueChanged() override {
         emit trigger(get(), this);
@@ -45,4 +58,5 @@ class ControlObjectScript : public ControlProxy {
     const RuntimeLoggingCategory m_logger;
     CompressingProxy m_proxy;
     bool m_skipSuperseded; // This flag is combined for all connections of this Control Object
+    ScriptConnectionBatcher* m_pBatcher;
 };
@@ -143,15 +143,6 @@ class Controller : public QObject {
 
     virtual int open() = 0;
     virtual int close() = 0;
-    // Requests that the device poll if it is a polling device. Returns true
-    // if events were handled.
-    virtual bool poll() { return false; }
-
-    // Returns true if this device should receive polling signals via calls to
-    // its poll() method.
-    virtual bool isPolling() const {
-        return false;
-    }
 
   private:
     ControllerScriptEngineLegacy* m_pScriptEngineLegacy;
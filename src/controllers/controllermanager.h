@@ -2,7 +2,6 @@
 
 #include <QMutex>
 #include <QSharedPointer>
-#include <QTimer>
 
 #include "controllers/controllerenumerator.h"
 #include "controllers/controllermappinginfo.h"
@@ -24,8 +23,6 @@ class ControllerManager : public QObject {
     ControllerManager(UserSettingsPointer pConfig);
     virtual ~ControllerManager();
 
-    static const mixxx::Duration kPollInterval;
-
     QList<Controller*> getControllers() const;
     QList<Controller*> getControllerList(bool outputDevices=true, bool inputDevices=true);
     ControllerLearningEventFilter* getControllerLearningEventFilter() const;
@@ -67,21 +64,14 @@ class ControllerManager : public QObject {
     /// preferences dialog on apply, and only open/close changed devices
     void slotSetUpDevices();
     void slotShutdown();
-    /// Calls poll() on all devices that have isPolling() true.
-    void pollDevices();
-    void startPolling();
-    void stopPolling();
-    void pollIfAnyControllersOpen();
 
   private:
     UserSettingsPointer m_pConfig;
     ControllerLearningEventFilter* m_pControllerLearningEventFilter;
-    QTimer m_pollTimer;
     mutable QMutex m_mutex;
     QList<ControllerEnumerator*> m_enumerators;
     QList<Controller*> m_controllers;
     QThread* m_pThread;
     QSharedPointer<MappingInfoEnumerator> m_pMainThreadUserMappingEnumerator;
     QSharedPointer<MappingInfoEnumerator> m_pMainThreadSystemMappingEnumerator;
-    bool m_skipPoll;
 };
@@ -1,12 +1,64 @@
 #include "controllers/midi/legacymidicontrollermappingfilehandler.h"
 
 #include "controllers/midi/midiutils.h"
+#include "util/assert.h"
 
 #define DEFAULT_OUTPUT_MAX 1.0
 #define DEFAULT_OUTPUT_MIN 0.0 // Anything above 0 is "on"
 #define DEFAULT_OUTPUT_ON 0x7F
 #define DEFAULT_OUTPUT_OFF 0x00
 
+namespace {
+
+const QString kScaledTransform = QStringLiteral("scaled");
+const QString kRelativeTransform = QStringLiteral("relative");
+const QString kDeltaTransform = QStringLiteral("delta");
+
+void parseTransformValue(const QDomElement& transformNode,
+        const QString& elementName,
+        double* pValue) {
+    const QDomElement node = transformNode.firstChildElement(elementName);
+    if (node.isNull()) {
+        return;
+    }
+    bool ok = false;
+    const double value = node.text().toDouble(&ok);
+    if (ok) {
+        *pValue = value;
+    } else {
+        qWarning() << "Invalid value for" << elementName
+                   << "in" << transformNode.nodeName() << ":" << node.text();
+    }
+}
+
+/// Parses the optional <scaled>, <relative>, or <delta> element of
+/// an input control
+MidiInputTransform parseTransform(const QDomElement& control) {
+    MidiInputTransform transform;
+    QDomElement transformNode = control.firstChildElement(kScaledTransform);
+    if (!transformNode.isNull()) {
+        transform.mode = MidiInputTransform::Mode::Scaled;
+    } else {
+        transformNode = control.firstChildElement(kRelativeTransform);
+        if (!transformNode.isNull()) {
+            transform.mode = MidiInputTransform::Mode::Relative;
+        } else {
+            transformNode = control.firstChildElement(kDeltaTransform);
+            if (transformNode.isNull()) {
+                return transform;
+            }
+            transform.mode = MidiInputTransform::Mode::Delta;
+        }
+    }
+    parseTransformValue(transformNode, QStringLiteral("minimum"), &transform.minimum);
+    parseTransformValue(transformNode, QStringLiteral("maximum"), &transform.maximum);
+    parseTransformValue(transformNode, QStringLiteral("center"), &transform.center);
+    parseTransformValue(transformNode, QStringLiteral("factor"), &transform.factor);
+    return transform;
+}
+
+} // anonymous namespace
+
 std::shared_ptr<LegacyControllerMapping>
 LegacyMidiControllerMappingFileHandler::load(const QDomElement& root,
         const QString& filePath,
@@ -107,6 +159,7 @@ LegacyMidiControllerMappingFileHandler::load(const QDomElement& root,
         inputMapping.description = controlDescription;
         inputMapping.options = options;
         inputMapping.key = MidiKey(midiStatusByte, midiControl);
+        inputMapping.transform = parseTransform(control);
 
         // qDebug() << "New inputMapping:" << QString::number(inputMapping.key.key, 16).toUpper()
         //          << QString::number(inputMapping.key.status, 16).toUpper()
@@ -361,6 +414,38 @@ QDomElement LegacyMidiControllerMappingFileHandler::inputMappingToXML(
     }
     controlNode.appendChild(optionsNode);
 
+    if (!mapping.transform.isNone()) {
+        const MidiInputTransform& transform = mapping.transform;
+        QDomElement transformNode;
+        switch (transform.mode) {
+        case MidiInputTransform::Mode::Scaled:
+            transformNode = doc->createElement(kScaledTransform);
+            break;
+        case MidiInputTransform::Mode::Relative:
+            transformNode = doc->createElement(kRelativeTransform);
+            break;
+        case MidiInputTransform::Mode::Delta:
+            transformNode = doc->createElement(kDeltaTransform);
+            break;
+        case MidiInputTransform::Mode::None:
+            DEBUG_ASSERT(!"unreachable");
+            break;
+        }
+        if (transform.mode != MidiInputTransform::Mode::Scaled) {
+            transformNode.appendChild(makeTextElement(
+                    doc, "center", QString::number(transform.center)));
+            transformNode.appendChild(makeTextElement(
+                    doc, "factor", QString::number(transform.factor)));
+        }
+        if (transform.mode != MidiInputTransform::Mode::Delta) {
+            transformNode.appendChild(makeTextElement(
+                    doc, "minimum", QString::number(transform.minimum)));
+            transformNode.appendChild(makeTextElement(
+                    doc, "maximum", QString::number(transform.maximum)));
+        }
+        controlNode.appendChild(transformNode);
+    }
+
     return controlNode;
 }
 
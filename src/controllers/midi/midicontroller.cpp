@@ -294,6 +294,12 @@ void MidiController::processInputMapping(const MidiInputMapping& mapping,
 
     double newValue = value;
 
+    // Buttons, switches and inverted controls depend on the MIDI parameter
+    // conversion of the control and ignore the transform
+    const bool useTransform = !mapping.transform.isNone() &&
+            !(mapping.options &
+                    (MidiOption::Button | MidiOption::Switch | MidiOption::Invert));
+
     const bool mapping_is_14bit = mapping.options &
             (MidiOption::FourteenBitMSB | MidiOption::FourteenBitLSB);
     if (!mapping_is_14bit && !m_fourteen_bit_queued_mappings.isEmpty()) {
@@ -368,11 +374,26 @@ void MidiController::processInputMapping(const MidiInputMapping& mapping,
         // ControlPotmeterBehavior for more fun of this variety :).
         newValue = static_cast<double>(iValue) / 128.0;
         newValue = math_min(newValue, 127.0);
-    } else {
+    } else if (!useTransform) {
         double currControlValue = pCO->getMidiParameter();
         newValue = computeValue(mapping.options, currControlValue, value);
     }
 
+    if (useTransform) {
+        // Native replacement for script functions that only scale the value
+        // and set a single control
+        newValue = transformValue(mapping.transform, pCO->get(), newValue);
+        if (mapping.transform.mode == MidiInputTransform::Mode::Scaled &&
+                mapping.options.testFlag(MidiOption::SoftTakeover)) {
+            m_st.enable(pCO);
+            if (m_st.ignore(pCO, pCO->getParameterForValue(newValue))) {
+                return;
+            }
+        }
+        pCO->set(newValue);
+        return;
+    }
+
     // ControlPushButton ControlObjects only accept NOTE_ON, so if the midi
     // mapping is <button> we override the Midi 'status' appropriately.
     if (mapping.options & (MidiOption::Button | MidiOption::Switch)) {
@@ -491,6 +512,29 @@ double MidiController::computeValue(
     return newmidivalue;
 }
 
+// static
+double MidiController::transformValue(const MidiInputTransform& transform,
+        double currentValue,
+        double midiValue) {
+    switch (transform.mode) {
+    case MidiInputTransform::Mode::None:
+        return currentValue;
+    case MidiInputTransform::Mode::Scaled:
+        return transform.minimum +
+                (transform.maximum - transform.minimum) *
+                math_min(midiValue / 127.0, 1.0);
+    case MidiInputTransform::Mode::Relative:
+        return math_clamp(
+                currentValue + transform.difference(midiValue) * transform.factor,
+                math_min(transform.minimum, transform.maximum),
+                math_max(transform.minimum, transform.maximum));
+    case MidiInputTransform::Mode::Delta:
+        return transform.difference(midiValue) * transform.factor;
+    }
+    DEBUG_ASSERT(!"unreachable");
+    return currentValue;
+}
+
 void MidiController::receive(const QByteArray& data, mixxx::Duration timestamp) {
     qCDebug(m_logInput) << QStringLiteral("incoming: ")
                         << MidiUtils::formatSysexMessage(
@@ -83,6 +83,9 @@ class MidiController : public Controller {
             mixxx::Duration timestamp);
 
     double computeValue(MidiOptions options, double _prevmidivalue, double _newmidivalue);
+    static double transformValue(const MidiInputTransform& transform,
+            double currentValue,
+            double midiValue);
     void createOutputHandlers();
     void updateAllOutputs();
     void destroyOutputHandlers();
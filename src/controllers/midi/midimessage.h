@@ -178,6 +178,52 @@ struct MidiKey {
     };
 };
 
+/// A declarative transformation of the received value of an input mapping
+/// that is executed natively instead of by a script function.
+///
+/// The result is set as the value of the control like engine.setValue()
+/// would do and bypasses the MIDI parameter conversion of the control.
+/// Mappings with the button, switch or invert option ignore the transform.
+struct MidiInputTransform {
+    enum class Mode : uint8_t {
+        /// The value is converted by the control (default)
+        None,
+        /// Maps the value from 0 to 127 linearly onto [minimum, maximum]
+        Scaled,
+        /// Adds the signed difference from center multiplied by factor to the
+        /// current value of the control and limits it to [minimum, maximum]
+        Relative,
+        /// Sets the signed difference from center multiplied by factor,
+        /// e.g. for jog wheels
+        Delta,
+    };
+
+    bool operator==(const MidiInputTransform& other) const {
+        return mode == other.mode && minimum == other.minimum &&
+                maximum == other.maximum && center == other.center &&
+                factor == other.factor;
+    }
+
+    bool isNone() const {
+        return mode == Mode::None;
+    }
+
+    /// Returns the signed difference of a relative value. A center of 0
+    /// interprets the value as 7-bit two's complement.
+    double difference(double value) const {
+        if (center == 0.0 && value >= 64.0) {
+            return value - 128.0;
+        }
+        return value - center;
+    }
+
+    Mode mode = Mode::None;
+    double minimum = 0.0;
+    double maximum = 1.0;
+    double center = 64.0;
+    double factor = 1.0;
+};
+
 struct MidiInputMapping {
     MidiInputMapping() {
     }
@@ -205,13 +251,15 @@ struct MidiInputMapping {
 
     bool operator==(const MidiInputMapping& other) const {
         return key == other.key && options == other.options &&
-                control == other.control && description == other.description;
+                control == other.control && description == other.description &&
+                transform == other.transform;
     }
 
     MidiKey key;
     MidiOptions options;
     ConfigKey control;
     QString description;
+    MidiInputTransform transform;
 };
 typedef QList<MidiInputMapping> MidiInputMappings;
 
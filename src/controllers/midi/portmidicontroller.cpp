@@ -1,10 +1,29 @@
 #include "controllers/midi/portmidicontroller.h"
 
 #include "controllers/midi/midiutils.h"
+#include "controllers/midi/portmidiinputthread.h"
 #include "moc_portmidicontroller.cpp"
+#include "util/compatibility/qmutex.h"
+#include "util/stat.h"
+#include "util/time.h"
+#include "util/timer.h"
 
 namespace {
 const QString kUnknownControllerName = QStringLiteral("Unknown PortMidiController");
+
+// Input messages that have not been processed by the controller thread
+// yet. Messages are dropped if the controller thread is not able to keep
+// up with the input for ~1.3 s at the full bandwidth of 3x speed devices.
+constexpr std::size_t kInputQueueCapacity = 4 * MIXXX_PORTMIDI_BUFFER_LEN;
+
+// The time from reading a message until it has been processed, i.e. until
+// the mapped control has been set or the script function has returned
+const QString kInputLatencyStatKey = QStringLiteral("PortMidiController input latency");
+
+// PortMidi is not thread-safe. Input devices are read on their input
+// threads while all other operations are performed on the controller
+// thread.
+QMutex s_portMidiMutex;
 }
 
 PortMidiController::PortMidiController(const PmDeviceInfo* inputDeviceInfo,
@@ -16,6 +35,8 @@ PortMidiController::PortMidiController(const PmDeviceInfo* inputDeviceInfo,
                                             ? inputDeviceInfo->name
                                             : outputDeviceInfo->name)
                           : kUnknownControllerName),
+          m_inputQueue(kInputQueueCapacity),
+          m_inputPending(0),
           m_cReceiveMsg_index(0),
           m_bInSysex(false) {
     for (int k = 0; k < MIXXX_PORTMIDI_BUFFER_LEN; ++k) {
@@ -56,6 +77,7 @@ int PortMidiController::open() {
     m_bInSysex = false;
     m_cReceiveMsg_index = 0;
 
+    auto locker = lockMutex(&s_portMidiMutex);
     if (m_pInputDevice && isInputDevice()) {
         qCInfo(m_logBase) << "PortMidiController: Opening"
                           << m_pInputDevice->info()->name << "index"
@@ -78,9 +100,23 @@ int PortMidiController::open() {
             return -2;
         }
     }
+    locker.unlock();
 
     setOpen(true);
     startEngine();
+
+    if (m_pInputDevice && m_pInputDevice->isOpen()) {
+        m_pInputThread = std::make_unique<PortMidiInputThread>(this);
+        m_pInputThread->setObjectName(QStringLiteral("PortMidiInputThread ") + getName());
+        connect(m_pInputThread.get(),
+                &PortMidiInputThread::inputAvailable,
+                this,
+                &PortMidiController::slotProcessInput,
+                Qt::QueuedConnection);
+        // Controller input needs to be prioritized since it can affect the
+        // audio directly, like when scratching
+        m_pInputThread->start(QThread::HighPriority);
+    }
     return 0;
 }
 
@@ -90,11 +126,22 @@ int PortMidiController::close() {
         return -1;
     }
 
+    if (m_pInputThread) {
+        m_pInputThread->stop();
+        m_pInputThread.reset();
+    }
+    // Discard all messages that have not been processed yet
+    while (m_inputQueue.front()) {
+        m_inputQueue.pop();
+    }
+    m_inputPending.storeRelease(0);
+
     stopEngine();
     MidiController::close();
 
     int result = 0;
 
+    auto locker = lockMutex(&s_portMidiMutex);
     if (m_pInputDevice && m_pInputDevice->isOpen()) {
         PmError err = m_pInputDevice->close();
         if (err != pmNoError) {
@@ -111,28 +158,61 @@ int PortMidiController::close() {
         }
     }
 
+    locker.unlock();
+
     setOpen(false);
     return result;
 }
 
 bool PortMidiController::poll() {
+    readInput();
+    return processInput();
+}
+
+void PortMidiController::slotProcessInput() {
+    // Reset the flag before processing the queue to not miss any
+    // messages that are queued concurrently
+    m_inputPending.storeRelease(0);
+    processInput();
+}
+
+int PortMidiController::readInput() {
     // Poll the controller for new data if it's an input device
+    auto locker = lockMutex(&s_portMidiMutex);
     if (m_pInputDevice.isNull() || !m_pInputDevice->isOpen()) {
-        return false;
+        return 0;
     }
 
-    int numEvents = m_pInputDevice->read(m_midiBuffer, MIXXX_PORTMIDI_BUFFER_LEN);
-
-    //qDebug() << "PortMidiController::poll()" << numEvents;
+    const int numEvents = m_pInputDevice->read(m_midiBuffer, MIXXX_PORTMIDI_BUFFER_LEN);
+    locker.unlock();
 
     if (numEvents < 0) {
         qCWarning(m_logInput) << "PortMidi error:" << Pm_GetErrorText((PmError)numEvents);
-        return false;
+        return numEvents;
     }
 
+    // The timestamps of PortMidi only have a resolution of 1 ms and are
+    // based on a different clock than the timestamps of other controllers.
+    const mixxx::Duration timestamp = mixxx::Time::elapsed();
     for (int i = 0; i < numEvents; i++) {
-        unsigned char status = Pm_MessageStatus(m_midiBuffer[i].message);
-        mixxx::Duration timestamp = mixxx::Duration::fromMillis(m_midiBuffer[i].timestamp);
+        if (!m_inputQueue.try_push(InputEvent{m_midiBuffer[i].message, timestamp})) {
+            qCWarning(m_logInput) << "Input queue overflow, dropping"
+                                  << (numEvents - i) << "messages";
+            break;
+        }
+    }
+    return numEvents;
+}
+
+bool PortMidiController::processInput() {
+    bool processed = false;
+    while (const InputEvent* pEvent = m_inputQueue.front()) {
+        const InputEvent event = *pEvent;
+        m_inputQueue.pop();
+        processed = true;
+
+        unsigned char status = Pm_MessageStatus(event.message);
+        const mixxx::Duration timestamp = event.timestamp;
 
         if ((status & 0xF8) == 0xF8) {
             // Handle real-time MIDI messages at any time
@@ -148,8 +228,8 @@ bool PortMidiController::poll() {
                 status = 0;
             } else {
                 //unsigned char channel = status & 0x0F;
-                unsigned char note = Pm_MessageData1(m_midiBuffer[i].message);
-                unsigned char velocity = Pm_MessageData2(m_midiBuffer[i].message);
+                unsigned char note = Pm_MessageData1(event.message);
+                unsigned char velocity = Pm_MessageData2(event.message);
                 receivedShortMessage(status, note, velocity, timestamp);
             }
         }
@@ -172,7 +252,7 @@ bool PortMidiController::poll() {
                 // TODO(rryan): This prevents buffer overflow if the sysex is
                 // larger than 1024 bytes. I don't want to radically change
                 // anything before the 2.0 release so this will do for now.
-                data = (m_midiBuffer[i].message >> shift) & 0xFF;
+                data = (event.message >> shift) & 0xFF;
                 if (m_cReceiveMsg_index < MIXXX_SYSEX_BUFFER_LEN) {
                     m_cReceiveMsg[m_cReceiveMsg_index++] = data;
                 }
@@ -187,8 +267,14 @@ bool PortMidiController::poll() {
                 m_cReceiveMsg_index = 0;
             }
         }
+
+        Stat::track(kInputLatencyStatKey,
+                Stat::DURATION_NANOSEC,
+                kDefaultComputeFlags,
+                static_cast<double>(
+                        (mixxx::Time::elapsed() - timestamp).toIntegerNanos()));
     }
-    return numEvents > 0;
+    return processed;
 }
 
 void PortMidiController::sendShortMsg(unsigned char status, unsigned char byte1,
@@ -200,7 +286,9 @@ void PortMidiController::sendShortMsg(unsigned char status, unsigned char byte1,
     unsigned int word = (((unsigned int)byte2) << 16) |
                          (((unsigned int)byte1) << 8) | status;
 
+    auto locker = lockMutex(&s_portMidiMutex);
     PmError err = m_pOutputDevice->writeShort(word);
+    locker.unlock();
     if (err == pmNoError) {
         qCDebug(m_logOutput) << QStringLiteral("outgoing: ")
                              << MidiUtils::formatMidiOpCode(getName(),
@@ -236,7 +324,9 @@ void PortMidiController::sendBytes(const QByteArray& data) {
         return;
     }
 
+    auto locker = lockMutex(&s_portMidiMutex);
     PmError err = m_pOutputDevice->writeSysEx((unsigned char*)data.constData());
+    locker.unlock();
     if (err == pmNoError) {
         qCDebug(m_logOutput) << QStringLiteral("outgoing: ")
                              << MidiUtils::formatSysexMessage(getName(), data);
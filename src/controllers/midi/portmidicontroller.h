@@ -2,10 +2,16 @@
 
 #include <portmidi.h>
 
+#include <QAtomicInt>
 #include <QScopedPointer>
+#include <memory>
 
 #include "controllers/midi/midicontroller.h"
 #include "controllers/midi/portmididevice.h"
+#include "rigtorp/SPSCQueue.h"
+#include "util/duration.h"
+
+class PortMidiInputThread;
 
 // Note:
 // A standard Midi device runs at 31.25 kbps, with 10 bits / byte
@@ -46,6 +52,9 @@
 /// physical device as two separate half-duplex devices. In this class, we wrap
 /// those together into a single device, which is why the constructor takes
 /// both arguments pertaining to both input and output "devices".
+///
+/// The input device is read by a PortMidiInputThread while the controller is
+/// open. The messages are processed on the controller thread.
 class PortMidiController : public MidiController {
     Q_OBJECT
   public:
@@ -58,7 +67,8 @@ class PortMidiController : public MidiController {
   private slots:
     int open() override;
     int close() override;
-    bool poll() override;
+
+    void slotProcessInput();
 
   protected:
     // MockPortMidiController needs this to not be private.
@@ -70,9 +80,22 @@ class PortMidiController : public MidiController {
     // 0xf7.
     void sendBytes(const QByteArray& data) override;
 
-    bool isPolling() const override {
-        return true;
-    }
+    /// A message that has been read from the input device
+    struct InputEvent {
+        PmMessage message;
+        /// The time when the message has been read, see mixxx::Time
+        mixxx::Duration timestamp;
+    };
+
+    /// Reads the pending messages from the input device and appends
+    /// them to the input queue. Invoked by PortMidiInputThread.
+    /// Returns the number of messages or a negative PmError.
+    int readInput();
+    /// Processes all messages in the input queue. Returns true if
+    /// messages have been processed.
+    bool processInput();
+    /// Reads and processes all pending messages synchronously
+    bool poll();
 
     // For testing only so that test fixtures can install mock PortMidiDevices.
     void setPortMidiInputDevice(PortMidiDevice* device) {
@@ -85,12 +108,21 @@ class PortMidiController : public MidiController {
     QScopedPointer<PortMidiDevice> m_pInputDevice;
     QScopedPointer<PortMidiDevice> m_pOutputDevice;
 
+    // Only accessed while reading the input device
     PmEvent m_midiBuffer[MIXXX_PORTMIDI_BUFFER_LEN];
 
+    // Single producer (input thread), single consumer (controller thread)
+    rigtorp::SPSCQueue<InputEvent> m_inputQueue;
+    // Set when the controller thread has been requested to process
+    // the input queue
+    QAtomicInt m_inputPending;
+    std::unique_ptr<PortMidiInputThread> m_pInputThread;
+
     // Storage for SysEx messages
     unsigned char m_cReceiveMsg[MIXXX_SYSEX_BUFFER_LEN];
     int m_cReceiveMsg_index;
     bool m_bInSysex;
 
     friend class PortMidiControllerTest;
+    friend class PortMidiInputThread;
 };
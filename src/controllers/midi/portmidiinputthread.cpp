@@ -0,0 +1,55 @@
+#include "controllers/midi/portmidiinputthread.h"
+
+#include "controllers/midi/portmidicontroller.h"
+#include "moc_portmidiinputthread.cpp"
+#include "util/time.h"
+
+namespace {
+
+// The polling interval while messages are arriving, e.g. while turning
+// a jog wheel. Messages are timestamped on arrival, i.e. this interval
+// only adds latency but not jitter.
+constexpr unsigned long kActivePollIntervalMicros = 500;
+
+// The polling interval after the device has been idle for
+// kIdleTimeout, which is the interval that has been used by
+// ControllerManager on Linux before.
+constexpr unsigned long kIdlePollIntervalMicros = 5000;
+
+const mixxx::Duration kIdleTimeout = mixxx::Duration::fromSeconds(1);
+
+} // anonymous namespace
+
+PortMidiInputThread::PortMidiInputThread(PortMidiController* pController)
+        : QThread(),
+          m_pController(pController),
+          m_stop(0) {
+}
+
+PortMidiInputThread::~PortMidiInputThread() {
+    stop();
+}
+
+void PortMidiInputThread::run() {
+    mixxx::Duration lastInputTime = mixxx::Time::elapsed();
+    while (m_stop.loadAcquire() == 0) {
+        if (m_pController->readInput() > 0) {
+            lastInputTime = mixxx::Time::elapsed();
+            if (m_pController->m_inputPending.testAndSetOrdered(0, 1)) {
+                emit inputAvailable();
+            }
+            // Continue reading without sleeping
+            continue;
+        }
+        if (mixxx::Time::elapsed() - lastInputTime < kIdleTimeout) {
+            usleep(kActivePollIntervalMicros);
+        } else {
+            usleep(kIdlePollIntervalMicros);
+        }
+    }
+}
+
+void PortMidiInputThread::stop() {
+    m_stop.storeRelease(1);
+    wait();
+}
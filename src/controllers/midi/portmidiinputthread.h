@@ -0,0 +1,37 @@
+#pragma once
+
+#include <QAtomicInt>
+#include <QThread>
+
+class PortMidiController;
+
+/// Reads the input of a PortMidiController on a dedicated thread.
+///
+/// Each message is timestamped when it is read from the device and then
+/// passed to the controller thread through a lock-free queue. The controller
+/// thread is only woken up once for all messages that have been queued
+/// since it processed the queue for the last time.
+///
+/// PortMidi does not provide file descriptors that could be waited on.
+/// Instead the device is polled with a short interval while messages are
+/// arriving and with a longer interval if the device is idle.
+class PortMidiInputThread : public QThread {
+    Q_OBJECT
+  public:
+    explicit PortMidiInputThread(PortMidiController* pController);
+    ~PortMidiInputThread() override;
+
+    void run() override;
+
+    /// Stops reading and waits until the thread has finished.
+    void stop();
+
+  signals:
+    /// Emitted when new messages have been queued while the controller
+    /// thread was idle.
+    void inputAvailable();
+
+  private:
+    PortMidiController* const m_pController;
+    QAtomicInt m_stop;
+};
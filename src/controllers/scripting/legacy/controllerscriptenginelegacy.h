@@ -50,6 +50,7 @@ class ControllerScriptEngineLegacy : public ControllerScriptEngineBase {
     // There is lots of tight coupling between ControllerScriptEngineLegacy
     // and ControllerScriptInterface. This is probably not worth improving in legacy code.
     friend class ControllerScriptInterfaceLegacy;
+    friend class ScriptConnectionBatcher;
     std::shared_ptr<QJSEngine> jsEngine() const {
         return m_pJSEngine;
     }
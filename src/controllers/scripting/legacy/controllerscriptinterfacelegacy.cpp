@@ -3,6 +3,7 @@
 #include "control/controlobject.h"
 #include "control/controlobjectscript.h"
 #include "controllers/scripting/legacy/controllerscriptenginelegacy.h"
+#include "controllers/scripting/legacy/scriptconnectionbatcher.h"
 #include "controllers/scripting/legacy/scriptconnectionjsproxy.h"
 #include "mixer/playermanager.h"
 #include "moc_controllerscriptinterfacelegacy.cpp"
@@ -98,6 +99,7 @@ ControlObjectScript* ControllerScriptInterfaceLegacy::getControlObjectScript(
         // create COT
         coScript = new ControlObjectScript(key, m_logger, this);
         if (coScript->valid()) {
+            coScript->setBatcher(m_pConnectionBatcher.get());
             m_controlCache.insert(key, coScript);
         } else {
             delete coScript;
@@ -432,6 +434,22 @@ void ControllerScriptInterfaceLegacy::trigger(const QString& group, const QStrin
     }
 }
 
+void ControllerScriptInterfaceLegacy::setCallbackBatchInterval(int intervalMillis) {
+    if (!m_pConnectionBatcher) {
+        if (intervalMillis <= 0) {
+            return;
+        }
+        m_pConnectionBatcher = std::make_unique<ScriptConnectionBatcher>(
+                m_pScriptEngineLegacy, m_logger);
+        for (ControlObjectScript* coScript : std::as_const(m_controlCache)) {
+            coScript->setBatcher(m_pConnectionBatcher.get());
+        }
+    }
+    qCDebug(m_logger) << "Batching connection callbacks every"
+                      << intervalMillis << "ms";
+    m_pConnectionBatcher->setInterval(intervalMillis);
+}
+
 void ControllerScriptInterfaceLegacy::log(const QString& message) {
     qCDebug(m_logger) << "engine.log is deprecated. Use console.log instead.";
     qCDebug(m_logger) << message;
@@ -2,6 +2,7 @@
 
 #include <QJSValue>
 #include <QObject>
+#include <memory>
 
 #include "controllers/softtakeover.h"
 #include "util/alphabetafilter.h"
@@ -10,6 +11,7 @@
 class ControllerScriptEngineLegacy;
 class ControlObjectScript;
 class ScriptConnection;
+class ScriptConnectionBatcher;
 class ConfigKey;
 
 /// ControllerScriptInterfaceLegacy is the legacy API for controller scripts to interact
@@ -44,6 +46,9 @@ class ControllerScriptInterfaceLegacy : public QObject {
             bool disconnect = false);
     // Called indirectly by the objects returned by connectControl
     Q_INVOKABLE void trigger(const QString& group, const QString& name);
+    /// Executes the callbacks of all connections at most once per interval
+    /// with the latest values. 0 disables batching (default).
+    Q_INVOKABLE void setCallbackBatchInterval(int intervalMillis);
     Q_INVOKABLE void log(const QString& message);
     Q_INVOKABLE int beginTimer(int interval, QJSValue scriptCode, bool oneShot = false);
     Q_INVOKABLE void stopTimer(int timerId);
@@ -82,6 +87,8 @@ class ControllerScriptInterfaceLegacy : public QObject {
             bool skipSuperseded = false);
     QHash<ConfigKey, ControlObjectScript*> m_controlCache;
     ControlObjectScript* getControlObjectScript(const QString& group, const QString& name);
+    // Created on demand and deleted after all ControlObjectScripts
+    std::unique_ptr<ScriptConnectionBatcher> m_pConnectionBatcher;
 
     SoftTakeoverCtrl m_st;
 
@@ -0,0 +1,138 @@
+#include "controllers/scripting/legacy/scriptconnectionbatcher.h"
+
+#include <QJSEngine>
+
+#include "control/controlobjectscript.h"
+#include "controllers/scripting/legacy/controllerscriptenginelegacy.h"
+#include "moc_scriptconnectionbatcher.cpp"
+#include "util/assert.h"
+#include "util/math.h"
+#include "util/trace.h"
+
+namespace {
+
+// The batch is a flat array of (callback, value, group, item) tuples.
+// Exceptions are collected and returned to not skip the remaining
+// callbacks. The callbacks are invoked without a 'this' object, just
+// like by QJSValue::call().
+const QString kDispatchFunctionCode = QStringLiteral(
+        "(function (batch) {"
+        "    var errors = [];"
+        "    for (var i = 0; i < batch.length; i += 4) {"
+        "        var callback = batch[i];"
+        "        try {"
+        "            callback(batch[i + 1], batch[i + 2], batch[i + 3]);"
+        "        } catch (error) {"
+        "            errors.push(error);"
+        "        }"
+        "    }"
+        "    return errors;"
+        "})");
+
+} // anonymous namespace
+
+ScriptConnectionBatcher::ScriptConnectionBatcher(
+        ControllerScriptEngineLegacy* pScriptEngineLegacy,
+        const RuntimeLoggingCategory& logger,
+        QObject* pParent)
+        : QObject(pParent),
+          m_pScriptEngineLegacy(pScriptEngineLegacy),
+          m_logger(logger),
+          m_intervalMillis(0),
+          m_timer(this) {
+    m_timer.setSingleShot(true);
+    m_timer.setTimerType(Qt::PreciseTimer);
+    connect(&m_timer, &QTimer::timeout, this, &ScriptConnectionBatcher::flush);
+}
+
+void ScriptConnectionBatcher::setInterval(int intervalMillis) {
+    m_intervalMillis = math_max(intervalMillis, 0);
+    if (isEnabled()) {
+        m_timer.setInterval(m_intervalMillis);
+    } else {
+        m_timer.stop();
+        flush();
+    }
+}
+
+void ScriptConnectionBatcher::queueValueChange(
+        ControlObjectScript* pControl, double value) {
+    const auto it = m_pendingIndices.constFind(pControl);
+    if (it != m_pendingIndices.constEnd()) {
+        // Keep the position of the first change
+        m_pendingChanges[it.value()].value = value;
+        return;
+    }
+    m_pendingIndices.insert(pControl, m_pendingChanges.size());
+    m_pendingChanges.append(PendingChange{pControl, value});
+    if (!m_timer.isActive()) {
+        // The timer only runs while changes are pending
+        m_timer.start();
+    }
+}
+
+void ScriptConnectionBatcher::removeControl(ControlObjectScript* pControl) {
+    const int index = m_pendingIndices.take(pControl);
+    if (index < m_pendingChanges.size() &&
+            m_pendingChanges[index].pControl == pControl) {
+        // Keep the indices of the other changes valid
+        m_pendingChanges[index].pControl = nullptr;
+    }
+}
+
+void ScriptConnectionBatcher::flush() {
+    if (m_pendingChanges.isEmpty()) {
+        return;
+    }
+    // Changes that are caused by the callbacks are queued for the next batch
+    const QVector<PendingChange> pendingChanges = std::move(m_pendingChanges);
+    m_pendingChanges.clear();
+    m_pendingIndices.clear();
+
+    auto pJsEngine = m_pScriptEngineLegacy->jsEngine();
+    if (!pJsEngine) {
+        return;
+    }
+    if (m_dispatchFunction.isUndefined()) {
+        m_dispatchFunction = pJsEngine->evaluate(kDispatchFunctionCode);
+        VERIFY_OR_DEBUG_ASSERT(m_dispatchFunction.isCallable()) {
+            return;
+        }
+    }
+
+    Trace flushTrace("JS batch of %1 controls", static_cast<int>(pendingChanges.size()));
+    QJSValue batch = pJsEngine->newArray();
+    quint32 batchIndex = 0;
+    for (const auto& change : pendingChanges) {
+        if (!change.pControl) {
+            continue;
+        }
+        // Connections that have been removed in the meantime are skipped
+        const ConfigKey key = change.pControl->getKey();
+        for (const auto& connection : change.pControl->scriptConnections()) {
+            batch.setProperty(batchIndex++, connection.callback);
+            batch.setProperty(batchIndex++, change.value);
+            batch.setProperty(batchIndex++, key.group);
+            batch.setProperty(batchIndex++, key.item);
+        }
+    }
+    if (batchIndex == 0) {
+        return;
+    }
+
+    const QJSValue errors = m_dispatchFunction.call(QJSValueList{batch});
+    if (errors.isError()) {
+        m_pScriptEngineLegacy->showScriptExceptionDialog(errors);
+        return;
+    }
+    const int errorCount = errors.property(QStringLiteral("length")).toInt();
+    for (int i = 0; i < errorCount; ++i) {
+        const QJSValue error = errors.property(i);
+        if (error.isError()) {
+            m_pScriptEngineLegacy->showScriptExceptionDialog(error);
+        } else {
+            qCWarning(m_logger) << "ControllerEngine: Invocation of a batched"
+                                << "connection callback failed:" << error.toString();
+        }
+    }
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <QHash>
+#include <QJSValue>
+#include <QObject>
+#include <QTimer>
+#include <QVector>
+
+#include "util/runtimeloggingcategory.h"
+
+class ControllerScriptEngineLegacy;
+class ControlObjectScript;
+
+/// Coalesces the value changes of all ControlObjectScripts of a controller
+/// and executes the connected callbacks in a single call into the JS engine
+/// once per frame interval.
+///
+/// Multiple changes of a control within a frame are merged, i.e. only the
+/// latest value is passed to its callbacks. Controls are processed in the
+/// order of their first change within the frame and the callbacks of each
+/// control in the order in which they have been connected.
+class ScriptConnectionBatcher : public QObject {
+    Q_OBJECT
+  public:
+    ScriptConnectionBatcher(
+            ControllerScriptEngineLegacy* pScriptEngineLegacy,
+            const RuntimeLoggingCategory& logger,
+            QObject* pParent = nullptr);
+
+    /// 0 disables batching and executes all pending callbacks immediately.
+    void setInterval(int intervalMillis);
+
+    bool isEnabled() const {
+        return m_intervalMillis > 0;
+    }
+
+    void queueValueChange(ControlObjectScript* pControl, double value);
+    /// Discards the pending change of a control that is about to be deleted
+    void removeControl(ControlObjectScript* pControl);
+
+  public slots:
+    /// Executes the callbacks of all pending changes
+    void flush();
+
+  private:
+    struct PendingChange {
+        ControlObjectScript* pControl;
+        double value;
+    };
+
+    ControllerScriptEngineLegacy* const m_pScriptEngineLegacy;
+    const RuntimeLoggingCategory m_logger;
+
+    int m_intervalMillis;
+    QTimer m_timer;
+    QJSValue m_dispatchFunction;
+
+    QVector<PendingChange> m_pendingChanges;
+    QHash<ControlObjectScript*, int> m_pendingIndices;
+};
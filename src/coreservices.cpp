@@ -13,6 +13,7 @@
 #include "controllers/keyboard/keyboardeventfilter.h"
 #include "database/mixxxdb.h"
 #include "effects/effectsmanager.h"
+#include "engine/cachingreader/cachingreader.h"
 #include "engine/enginemaster.h"
 #include "library/coverartcache.h"
 #include "library/library.h"
@@ -27,10 +28,13 @@
 #include "preferences/dialog/dlgprefmodplug.h"
 #endif
 #include "soundio/soundmanager.h"
+#include "sources/decodedaudiocache.h"
+#include "sources/seekindex.h"
 #include "sources/soundsourceproxy.h"
 #include "util/db/dbconnectionpooled.h"
 #include "util/font.h"
 #include "util/logger.h"
+#include "util/samplekernels.h"
 #include "util/screensaver.h"
 #include "util/screensavermanager.h"
 #include "util/statsmanager.h"
@@ -232,8 +236,15 @@ void CoreServices::initialize(QApplication* pApp) {
 
     UserSettingsPointer pConfig = m_pSettingsManager->settings();
 
+    mixxx::SampleKernels::initialize();
+
     Sandbox::setPermissionsFilePath(QDir(pConfig->getSettingsPath()).filePath("sandbox.cfg"));
 
+    // Seek indexes are stored next to the analysis data
+    mixxx::SeekIndex::setDirectory(
+            QDir(pConfig->getSettingsPath()).filePath("analysis/seekindex"));
+    CachingReader::configureDecodedAudioCache(pConfig);
+
     QString resourcePath = pConfig->getResourcePath();
 
     emit initializationProgressUpdate(0, tr("fonts"));
@@ -568,6 +579,7 @@ void CoreServices::finalize() {
     qDebug() << t.elapsed(false).debugMillisWithUnit() << "stopping pending Library tasks";
     m_pTrackCollectionManager->stopLibraryScan();
     m_pLibrary->stopPendingTasks();
+    mixxx::DecodedAudioCache::shutdown();
 
     qDebug() << t.elapsed(false).debugMillisWithUnit() << "saving configuration";
     m_pSettingsManager->save();
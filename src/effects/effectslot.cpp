@@ -18,6 +18,8 @@
 // The maximum number of effect parameters we're going to support.
 constexpr unsigned int kDefaultMaxParameters = 16;
 
+constexpr int kProcessingLoadUpdateIntervalMillis = 250;
+
 EffectSlot::EffectSlot(const QString& group,
         EffectsManager* pEffectsManager,
         EffectsMessengerPointer pEffectsMessenger,
@@ -127,6 +129,19 @@ EffectSlot::EffectSlot(const QString& group,
     m_pControlMetaParameter->set(0.0);
     m_pControlMetaParameter->setDefaultValue(0.0);
 
+    m_pControlAudioLatencyUsage = std::make_unique<ControlObject>(
+            ConfigKey(m_group, "audio_latency_usage"));
+    m_pControlAudioLatencyUsage->setReadOnly();
+    m_pControlBypassed = std::make_unique<ControlObject>(
+            ConfigKey(m_group, "bypassed"));
+    m_pControlBypassed->setReadOnly();
+
+    m_processingLoadTimer.setInterval(kProcessingLoadUpdateIntervalMillis);
+    connect(&m_processingLoadTimer,
+            &QTimer::timeout,
+            this,
+            &EffectSlot::slotUpdateProcessingLoad);
+
     m_pControlLoaded->forceSet(0.0);
 }
 
@@ -157,6 +172,8 @@ void EffectSlot::addToEngine() {
     request->AddEffectToChain.pEffect = m_pEngineEffect;
     request->AddEffectToChain.iIndex = m_iEffectNumber;
     m_pMessenger->writeRequest(request);
+
+    m_processingLoadTimer.start();
 }
 
 void EffectSlot::removeFromEngine() {
@@ -172,6 +189,8 @@ void EffectSlot::removeFromEngine() {
     m_pMessenger->writeRequest(request);
 
     m_pEngineEffect = nullptr;
+    m_processingLoadTimer.stop();
+    slotUpdateProcessingLoad();
 }
 
 void EffectSlot::updateEngineState() {
@@ -192,6 +211,28 @@ void EffectSlot::updateEngineState() {
     }
 }
 
+void EffectSlot::slotUpdateProcessingLoad() {
+    // The EngineEffect is only deleted after the engine has removed it,
+    // so it is safe to read from it as long as it is loaded.
+    const double audioLatencyUsage =
+            m_pEngineEffect ? m_pEngineEffect->processingLoad() : 0.0;
+    const bool bypassed = m_pEngineEffect && m_pEngineEffect->isBypassed();
+    if (audioLatencyUsage != m_pControlAudioLatencyUsage->get()) {
+        m_pControlAudioLatencyUsage->forceSet(audioLatencyUsage);
+        emit audioLatencyUsageChanged(audioLatencyUsage);
+    }
+    if (bypassed != m_pControlBypassed->toBool()) {
+        if (bypassed) {
+            qWarning() << debugString()
+                       << "bypassed" << m_pEngineEffect->name()
+                       << "to keep the audio callback within its time budget,"
+                       << "audio latency usage:" << audioLatencyUsage;
+        }
+        m_pControlBypassed->forceSet(bypassed ? 1.0 : 0.0);
+        emit bypassedChanged(bypassed);
+    }
+}
+
 void EffectSlot::initalizeInputChannel(ChannelHandle inputChannel) {
     if (!m_pEngineEffect) {
         return;
@@ -3,6 +3,7 @@
 #include <QObject>
 #include <QSharedPointer>
 #include <QString>
+#include <QTimer>
 
 #include "control/controlencoder.h"
 #include "control/controlobject.h"
@@ -131,6 +132,19 @@ class EffectSlot : public QObject {
 
     void setEnabled(bool enabled);
 
+    /// The fraction of the audio callback period that is spent processing
+    /// the loaded effect, summed up over all channels.
+    double getAudioLatencyUsage() const {
+        return m_pControlAudioLatencyUsage->get();
+    }
+
+    /// The effect has been faded out by the engine to keep the audio
+    /// callback within its time budget. Toggling the enable switch
+    /// enables it again.
+    bool isBypassed() const {
+        return m_pControlBypassed->toBool();
+    }
+
   public slots:
     void setMetaParameter(double v, bool force = false);
 
@@ -144,10 +158,13 @@ class EffectSlot : public QObject {
   signals:
     void effectChanged();
     void parametersChanged();
+    void audioLatencyUsageChanged(double audioLatencyUsage);
+    void bypassedChanged(bool bypassed);
 
   private slots:
     void updateEngineState();
     void visibleEffectsListChanged();
+    void slotUpdateProcessingLoad();
 
   private:
     QString debugString() const {
@@ -194,6 +211,11 @@ class EffectSlot : public QObject {
     std::unique_ptr<ControlEncoder> m_pControlEffectSelector;
     std::unique_ptr<ControlObject> m_pControlClear;
     std::unique_ptr<ControlPotmeter> m_pControlMetaParameter;
+    std::unique_ptr<ControlObject> m_pControlAudioLatencyUsage;
+    std::unique_ptr<ControlObject> m_pControlBypassed;
+
+    // Polls the EngineEffect while an effect is loaded
+    QTimer m_processingLoadTimer;
 
     SoftTakeover m_metaknobSoftTakeover;
 
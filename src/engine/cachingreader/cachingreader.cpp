@@ -1,10 +1,12 @@
 #include "engine/cachingreader/cachingreader.h"
 
+#include <QDir>
 #include <QFileInfo>
 #include <QtDebug>
 
 #include "control/controlobject.h"
 #include "moc_cachingreader.cpp"
+#include "sources/decodedaudiocache.h"
 #include "track/track.h"
 #include "util/assert.h"
 #include "util/compatibility/qatomic.h"
@@ -25,22 +27,43 @@ constexpr SINT kDefaultHintFrames = 1024;
 // With CachingReaderChunk::kFrames = 8192 each chunk consumes
 // 8192 frames * 2 channels/frame * 4-bytes per sample = 65 kB.
 //
-//     80 chunks ->  5120 KB =  5 MB
+//   1024 chunks -> 65536 KB = 64 MB, i.e. about 190 s (3.2 minutes) of
+//   audio @ 44.1 kHz
 //
-// Each deck (including sample decks) will use their own CachingReader.
-// Consequently the total memory required for all allocated chunks depends
-// on the number of decks. The amount of memory reserved for a single
-// CachingReader must be multiplied by the number of decks to calculate
-// the total amount!
+// The chunks are borrowed from the shared CachingReaderChunkArena. This
+// limit only prevents a single deck from draining the whole arena and
+// determines the capacity of the FIFOs.
 //
-// NOTE(uklotzde, 2019-09-05): Reduce this number to just few chunks
-// (kNumberOfCachedChunksInMemory = 1, 2, 3, ...) for testing purposes
-// to verify that the MRU/LRU cache works as expected. Even though
-// massive drop outs are expected to occur Mixxx should run reliably!
-constexpr SINT kNumberOfCachedChunksInMemory = 80;
+// NOTE(uklotzde, 2019-09-05): Reduce the memory budget of the arena to just
+// a few chunks for testing purposes to verify that the MRU/LRU cache works
+// as expected. Even though massive drop outs are expected to occur Mixxx
+// should run reliably!
+constexpr SINT kMaxChunksPerReader = 1024;
+
+constexpr SINT kMaxPendingReadRequests = 20;
+
+// Bounds the work in the engine thread while the arena is under pressure
+constexpr int kMaxChunksReleasedPerPass = 8;
 
 } // anonymous namespace
 
+const ConfigKey CachingReader::kPreloadTracksConfigKey =
+        ConfigKey(QStringLiteral("[Soundcard]"), QStringLiteral("CachingReaderPreloadTracks"));
+const ConfigKey CachingReader::kDecodedAudioCacheSizeConfigKey =
+        ConfigKey(QStringLiteral("[Soundcard]"), QStringLiteral("DecodedAudioCacheSizeMB"));
+const ConfigKey CachingReader::kDecodedAudioCacheInt16ConfigKey =
+        ConfigKey(QStringLiteral("[Soundcard]"), QStringLiteral("DecodedAudioCacheInt16"));
+
+// static
+void CachingReader::configureDecodedAudioCache(const UserSettingsPointer& pConfig) {
+    mixxx::DecodedAudioCache::configure(
+            QDir(pConfig->getSettingsPath()).filePath("decodedaudiocache"),
+            qint64(pConfig->getValue(kDecodedAudioCacheSizeConfigKey, 0)) * 1024 * 1024,
+            pConfig->getValue(kDecodedAudioCacheInt16ConfigKey, false)
+                    ? mixxx::DecodedAudioCache::SampleFormat::Int16
+                    : mixxx::DecodedAudioCache::SampleFormat::Float32);
+}
+
 CachingReader::CachingReader(const QString& group,
         UserSettingsPointer config)
         : m_pConfig(config),
@@ -53,30 +76,32 @@ CachingReader::CachingReader(const QString& group,
           // buffer, where new requests replace old requests when full. Those
           // old requests need to be returned immediately to the CachingReader
           // that must take ownership and free them!!!
-          m_chunkReadRequestFIFO(kNumberOfCachedChunksInMemory / 4),
-          // The capacity of the back channel must be equal to the number of
-          // allocated chunks, because the worker use writeBlocking(). Otherwise
-          // the worker could get stuck in a hot loop!!!
-          m_readerStatusUpdateFIFO(kNumberOfCachedChunksInMemory),
+          m_chunkReadRequestFIFO(kMaxPendingReadRequests),
+          // The capacity of the back channel must be equal to the maximum
+          // number of allocated chunks, because the worker use writeBlocking().
+          // Otherwise the worker could get stuck in a hot loop!!!
+          m_readerStatusUpdateFIFO(kMaxChunksPerReader),
           m_state(STATE_IDLE),
+          m_pArena(CachingReaderChunkArena::sharedInstance(config)),
+          m_numAllocatedChunks(0),
+          m_hintPass(0),
           m_mruCachingReaderChunk(nullptr),
           m_lruCachingReaderChunk(nullptr),
-          m_sampleBuffer(CachingReaderChunk::kSamples * kNumberOfCachedChunksInMemory),
+          m_pPreloadBuffer(nullptr),
+          m_cacheHits(0),
+          m_cacheMisses(0),
+          m_cacheUnderruns(0),
+          m_pCacheHits(std::make_unique<ControlObject>(
+                  ConfigKey(group, QStringLiteral("cachingreader_hits")))),
+          m_pCacheMisses(std::make_unique<ControlObject>(
+                  ConfigKey(group, QStringLiteral("cachingreader_misses")))),
+          m_pCacheUnderruns(std::make_unique<ControlObject>(
+                  ConfigKey(group, QStringLiteral("cachingreader_underruns")))),
           m_worker(group, &m_chunkReadRequestFIFO, &m_readerStatusUpdateFIFO) {
-    m_allocatedCachingReaderChunks.reserve(kNumberOfCachedChunksInMemory);
-    // Divide up the allocated raw memory buffer into total_chunks
-    // chunks. Initialize each chunk to hold nothing and add it to the free
-    // list.
-    for (SINT i = 0; i < kNumberOfCachedChunksInMemory; ++i) {
-        CachingReaderChunkForOwner* c =
-                new CachingReaderChunkForOwner(
-                        mixxx::SampleBuffer::WritableSlice(
-                                m_sampleBuffer,
-                                CachingReaderChunk::kSamples * i,
-                                CachingReaderChunk::kSamples));
-        m_chunks.push_back(c);
-        m_freeChunks.push_back(c);
-    }
+    m_allocatedCachingReaderChunks.reserve(kMaxChunksPerReader);
+    m_pCacheHits->setReadOnly();
+    m_pCacheMisses->setReadOnly();
+    m_pCacheUnderruns->setReadOnly();
 
     // Forward signals from worker
     connect(&m_worker, &CachingReaderWorker::trackLoading,
@@ -94,15 +119,45 @@ CachingReader::CachingReader(const QString& group,
 
 CachingReader::~CachingReader() {
     m_worker.quitWait();
-    qDeleteAll(m_chunks);
+
+    // Take back the chunks of all requests and status updates that are
+    // still in flight. Those that are not referenced by
+    // m_allocatedCachingReaderChunks anymore must be returned individually.
+    const auto releaseIfOrphaned = [this](CachingReaderChunkForOwner* pChunk) {
+        if (m_allocatedCachingReaderChunks.value(pChunk->getIndex()) != pChunk) {
+            releaseChunk(pChunk);
+        }
+    };
+    CachingReaderChunkReadRequest request;
+    while (m_chunkReadRequestFIFO.read(&request, 1) == 1) {
+        DEBUG_ASSERT(dynamic_cast<CachingReaderChunkForOwner*>(request.chunk));
+        auto* pChunk = static_cast<CachingReaderChunkForOwner*>(request.chunk);
+        pChunk->takeFromWorker();
+        releaseIfOrphaned(pChunk);
+    }
+    ReaderStatusUpdate update;
+    while (m_readerStatusUpdateFIFO.read(&update, 1) == 1) {
+        auto* pChunk = update.takeFromWorker();
+        if (pChunk) {
+            releaseIfOrphaned(pChunk);
+        }
+    }
+    freeAllChunks();
+    DEBUG_ASSERT(m_numAllocatedChunks == 0);
+}
+
+void CachingReader::releaseChunk(CachingReaderChunkForOwner* pChunk) {
+    pChunk->free();
+    m_pArena->freeChunk(pChunk);
+    DEBUG_ASSERT(m_numAllocatedChunks > 0);
+    --m_numAllocatedChunks;
 }
 
 void CachingReader::freeChunkFromList(CachingReaderChunkForOwner* pChunk) {
     pChunk->removeFromList(
             &m_mruCachingReaderChunk,
             &m_lruCachingReaderChunk);
-    pChunk->free();
-    m_freeChunks.push_back(pChunk);
+    releaseChunk(pChunk);
 }
 
 void CachingReader::freeChunk(CachingReaderChunkForOwner* pChunk) {
@@ -119,16 +174,13 @@ void CachingReader::freeChunk(CachingReaderChunkForOwner* pChunk) {
 }
 
 void CachingReader::freeAllChunks() {
-    for (const auto& pChunk: qAsConst(m_chunks)) {
+    for (auto* pChunk : qAsConst(m_allocatedCachingReaderChunks)) {
         // We will receive CHUNK_READ_INVALID for all pending chunk reads
         // which should free the chunks individually.
         if (pChunk->getState() == CachingReaderChunkForOwner::READ_PENDING) {
             continue;
         }
-
-        if (pChunk->getState() != CachingReaderChunkForOwner::FREE) {
-            freeChunkFromList(pChunk);
-        }
+        freeChunkFromList(pChunk);
     }
     DEBUG_ASSERT(!m_mruCachingReaderChunk);
     DEBUG_ASSERT(!m_lruCachingReaderChunk);
@@ -137,11 +189,14 @@ void CachingReader::freeAllChunks() {
 }
 
 CachingReaderChunkForOwner* CachingReader::allocateChunk(SINT chunkIndex) {
-    if (m_freeChunks.empty()) {
+    if (m_numAllocatedChunks >= kMaxChunksPerReader) {
         return nullptr;
     }
-    CachingReaderChunkForOwner* pChunk = m_freeChunks.front();
-    m_freeChunks.pop_front();
+    CachingReaderChunkForOwner* pChunk = m_pArena->allocateChunk();
+    if (!pChunk) {
+        return nullptr;
+    }
+    ++m_numAllocatedChunks;
 
     pChunk->init(chunkIndex);
 
@@ -150,14 +205,25 @@ CachingReaderChunkForOwner* CachingReader::allocateChunk(SINT chunkIndex) {
     return pChunk;
 }
 
-CachingReaderChunkForOwner* CachingReader::allocateChunkExpireLRU(SINT chunkIndex) {
+CachingReaderChunkForOwner* CachingReader::allocateChunkExpireLRU(
+        SINT chunkIndex, int hintPriority) {
     auto* pChunk = allocateChunk(chunkIndex);
     if (!pChunk) {
-        if (m_lruCachingReaderChunk) {
-            freeChunk(m_lruCachingReaderChunk);
-            pChunk = allocateChunk(chunkIndex);
+        pChunk = findChunkToExpire(hintPriority);
+        if (pChunk) {
+            // Reuse the chunk directly instead of returning it to the arena,
+            // where it could be grabbed by another deck in the meantime.
+            const int removed = m_allocatedCachingReaderChunks.remove(pChunk->getIndex());
+            Q_UNUSED(removed); // only used in DEBUG_ASSERT
+            DEBUG_ASSERT(removed == 1);
+            pChunk->removeFromList(
+                    &m_mruCachingReaderChunk,
+                    &m_lruCachingReaderChunk);
+            pChunk->free();
+            pChunk->init(chunkIndex);
+            m_allocatedCachingReaderChunks.insert(chunkIndex, pChunk);
         } else {
-            kLogger.warning() << "No cached LRU chunk available for freeing";
+            kLogger.warning() << "No cached chunk available for freeing";
         }
     }
     if (kLogger.traceEnabled()) {
@@ -166,6 +232,71 @@ CachingReaderChunkForOwner* CachingReader::allocateChunkExpireLRU(SINT chunkInde
     return pChunk;
 }
 
+CachingReaderChunkForOwner* CachingReader::findChunkToExpire(int hintPriority) const {
+    CachingReaderChunkForOwner* pLeastImportantChunk = nullptr;
+    for (auto* pChunk = m_lruCachingReaderChunk; pChunk; pChunk = pChunk->getPrev()) {
+        if (!pChunk->wasHintedInPass(m_hintPass)) {
+            return pChunk;
+        }
+        if (!pLeastImportantChunk ||
+                pChunk->getHintPriority() > pLeastImportantChunk->getHintPriority()) {
+            pLeastImportantChunk = pChunk;
+        }
+    }
+    if (pLeastImportantChunk && pLeastImportantChunk->getHintPriority() > hintPriority) {
+        return pLeastImportantChunk;
+    }
+    return nullptr;
+}
+
+void CachingReader::releaseColdChunks() {
+    // Chunks that are hinted during the current pass have been moved to the
+    // MRU end of the list, so all cold chunks are at the LRU end
+    for (int i = 0; i < kMaxChunksReleasedPerPass; ++i) {
+        auto* pChunk = m_lruCachingReaderChunk;
+        if (!pChunk || pChunk->wasHintedInPass(m_hintPass)) {
+            break;
+        }
+        freeChunk(pChunk);
+    }
+}
+
+void CachingReader::publishCacheStats() {
+    // Only the lower 53 bits are significant for a double, which is
+    // still plenty
+    if (m_pCacheHits->get() != static_cast<double>(m_cacheHits)) {
+        m_pCacheHits->forceSet(static_cast<double>(m_cacheHits));
+    }
+    if (m_pCacheMisses->get() != static_cast<double>(m_cacheMisses)) {
+        m_pCacheMisses->forceSet(static_cast<double>(m_cacheMisses));
+    }
+    if (m_pCacheUnderruns->get() != static_cast<double>(m_cacheUnderruns)) {
+        m_pCacheUnderruns->forceSet(static_cast<double>(m_cacheUnderruns));
+    }
+}
+
+// static
+int CachingReader::hintPriority(Hint::Type type) {
+    switch (type) {
+    case Hint::Type::SlipPosition:
+    case Hint::Type::CurrentPosition:
+        return 1;
+    case Hint::Type::LoopStartEnabled:
+        return 2;
+    case Hint::Type::MainCue:
+    case Hint::Type::HotCue:
+    case Hint::Type::LoopEndEnabled:
+    case Hint::Type::LoopStart:
+        return 10;
+    case Hint::Type::FirstSound:
+    case Hint::Type::IntroStart:
+    case Hint::Type::IntroEnd:
+    case Hint::Type::OutroStart:
+        break;
+    }
+    return 20;
+}
+
 CachingReaderChunkForOwner* CachingReader::lookupChunk(SINT chunkIndex) {
     // Defaults to nullptr if it's not in the hash.
     auto* pChunk = m_allocatedCachingReaderChunks.value(chunkIndex, nullptr);
@@ -206,7 +337,9 @@ CachingReaderChunkForOwner* CachingReader::lookupChunkAndFreshen(SINT chunkIndex
 // Invoked from the UI thread!!
 void CachingReader::newTrack(TrackPointer pTrack) {
     auto newState = pTrack ? STATE_TRACK_LOADING : STATE_TRACK_UNLOADING;
-    auto oldState = m_state.fetchAndStoreAcquire(newState);
+    // The worker frees the preload buffer after being notified below, i.e.
+    // the engine must see the new state first
+    auto oldState = m_state.fetchAndStoreOrdered(newState);
 
     // TODO():
     // BaseTrackPlayerImpl::slotLoadTrack() distributes the new track via
@@ -219,7 +352,9 @@ void CachingReader::newTrack(TrackPointer pTrack) {
         kLogger.warning()
                 << "Loading a new track while loading a track may lead to inconsistent states";
     }
-    m_worker.newTrack(std::move(pTrack));
+    const bool preload = pTrack && m_pConfig &&
+            m_pConfig->getValue(kPreloadTracksConfigKey, false);
+    m_worker.newTrack(std::move(pTrack), preload);
 }
 
 // Called from the engine thread
@@ -235,19 +370,21 @@ void CachingReader::process() {
                     update.status == CHUNK_READ_EOF ||
                     update.status == CHUNK_READ_INVALID ||
                     update.status == CHUNK_READ_DISCARDED);
-            if (m_state.loadAcquire() == STATE_TRACK_LOADING) {
+            if (m_state.loadAcquire() != STATE_TRACK_LOADED) {
                 // Discard all results from pending read requests for the
-                // previous track before the next track has been loaded.
+                // previous track before the next track has been loaded
+                // or while the track is unloaded.
                 freeChunk(pChunk);
                 continue;
             }
-            DEBUG_ASSERT(atomicLoadRelaxed(m_state) == STATE_TRACK_LOADED);
-            if (update.status == CHUNK_READ_SUCCESS) {
+            if (update.status == CHUNK_READ_SUCCESS &&
+                    !isPreloadedChunk(pChunk->getIndex())) {
                 // Insert or freshen the chunk in the MRU/LRU list after
                 // obtaining ownership from the worker.
                 freshenChunk(pChunk);
             } else {
-                // Discard chunks that don't carry any data
+                // Discard chunks that don't carry any data or that have
+                // been preloaded in the meantime
                 freeChunk(pChunk);
             }
             // Adjust the readable frame index range (if available)
@@ -275,9 +412,15 @@ void CachingReader::process() {
                 }
                 // Reset the readable frame index range
                 m_readableFrameIndexRange = update.readableFrameIndexRange();
+                m_pPreloadBuffer = update.getPreloadBuffer();
                 m_state.storeRelease(STATE_TRACK_LOADED);
             } else {
                 DEBUG_ASSERT(update.status == TRACK_UNLOADED);
+                // Return the chunks of the unloaded track to the arena,
+                // because an inactive deck is not processed anymore and
+                // would never release them under pressure.
+                freeAllChunks();
+                m_pPreloadBuffer = nullptr;
                 // This message could be processed later when a new
                 // track is already loading! In this case the TRACK_LOADED will
                 // be the very next status update.
@@ -423,8 +566,28 @@ CachingReader::ReadResult CachingReader::read(SINT startSample, SINT numSamples,
                 }
 
                 mixxx::IndexRange bufferedFrameIndexRange;
-                const CachingReaderChunkForOwner* const pChunk = lookupChunkAndFreshen(chunkIndex);
-                if (pChunk && (pChunk->getState() == CachingReaderChunkForOwner::READY)) {
+                const CachingReaderPreloadBuffer* const pPreloadBuffer =
+                        isPreloadedChunk(chunkIndex) ? preloadBuffer() : nullptr;
+                const CachingReaderChunkForOwner* const pChunk =
+                        pPreloadBuffer ? nullptr : lookupChunkAndFreshen(chunkIndex);
+                if (pPreloadBuffer) {
+                    ++m_cacheHits;
+                    if (reverse) {
+                        bufferedFrameIndexRange =
+                                pPreloadBuffer->readSampleFramesReverse(
+                                        chunkIndex,
+                                        &buffer[samplesRemaining],
+                                        remainingFrameIndexRange);
+                    } else {
+                        bufferedFrameIndexRange =
+                                pPreloadBuffer->readSampleFrames(
+                                        chunkIndex,
+                                        buffer,
+                                        remainingFrameIndexRange);
+                    }
+                } else if (pChunk &&
+                        (pChunk->getState() == CachingReaderChunkForOwner::READY)) {
+                    ++m_cacheHits;
                     if (reverse) {
                         bufferedFrameIndexRange =
                                 pChunk->readBufferedSampleFramesReverse(
@@ -443,6 +606,7 @@ CachingReader::ReadResult CachingReader::read(SINT startSample, SINT numSamples,
                     DEBUG_ASSERT(!pChunk ||
                             (pChunk->getState() == CachingReaderChunkForOwner::READ_PENDING));
                     Counter("CachingReader::read(): Failed to read chunk on cache miss")++;
+                    ++m_cacheUnderruns;
                     if (kLogger.traceEnabled()) {
                         kLogger.trace()
                                 << "Cache miss for chunk with index"
@@ -514,11 +678,28 @@ void CachingReader::hintAndMaybeWake(const HintVector& hintList) {
         return;
     }
 
+    const CachingReaderPreloadBuffer* const pPreloadBuffer = preloadBuffer();
+    if (pPreloadBuffer && pPreloadBuffer->isComplete()) {
+        // Nothing left to request. Return the chunks that have been cached
+        // while preloading to the arena.
+        if (m_mruCachingReaderChunk) {
+            freeAllChunks();
+        }
+        publishCacheStats();
+        return;
+    }
+
+    if (++m_hintPass == 0) {
+        // 0 is reserved for chunks that have not been hinted yet
+        m_hintPass = 1;
+    }
+
     // For every chunk that the hints indicated, check if it is in the cache. If
     // any are not, then wake.
     bool shouldWake = false;
 
     for (const auto& hint: hintList) {
+        const int priority = hintPriority(hint.type);
         SINT hintFrame = hint.frame;
         SINT hintFrameCount = hint.frameCount;
 
@@ -552,10 +733,14 @@ void CachingReader::hintAndMaybeWake(const HintVector& hintList) {
         const int firstChunkIndex = CachingReaderChunk::indexForFrame(readableFrameIndexRange.start());
         const int lastChunkIndex = CachingReaderChunk::indexForFrame(readableFrameIndexRange.end() - 1);
         for (int chunkIndex = firstChunkIndex; chunkIndex <= lastChunkIndex; ++chunkIndex) {
+            if (isPreloadedChunk(chunkIndex)) {
+                continue;
+            }
             CachingReaderChunkForOwner* pChunk = lookupChunk(chunkIndex);
             if (!pChunk) {
+                ++m_cacheMisses;
                 shouldWake = true;
-                pChunk = allocateChunkExpireLRU(chunkIndex);
+                pChunk = allocateChunkExpireLRU(chunkIndex, priority);
                 if (!pChunk) {
                     kLogger.warning()
                             << "Failed to allocate chunk"
@@ -563,6 +748,7 @@ void CachingReader::hintAndMaybeWake(const HintVector& hintList) {
                             << "for read request";
                     continue;
                 }
+                pChunk->markHinted(m_hintPass, priority);
                 // Do not insert the allocated chunk into the MRU/LRU list,
                 // because it will be handed over to the worker immediately
                 CachingReaderChunkReadRequest request;
@@ -580,14 +766,22 @@ void CachingReader::hintAndMaybeWake(const HintVector& hintList) {
                     pChunk->takeFromWorker();
                     freeChunk(pChunk);
                 }
-            } else if (pChunk->getState() == CachingReaderChunkForOwner::READY) {
-                // This will cause the chunk to be 'freshened' in the cache. The
-                // chunk will be moved to the end of the LRU list.
-                freshenChunk(pChunk);
+            } else {
+                pChunk->markHinted(m_hintPass, priority);
+                if (pChunk->getState() == CachingReaderChunkForOwner::READY) {
+                    // This will cause the chunk to be 'freshened' in the cache. The
+                    // chunk will be moved to the end of the LRU list.
+                    freshenChunk(pChunk);
+                }
             }
         }
     }
 
+    if (m_pArena->isUnderPressure()) {
+        releaseColdChunks();
+    }
+    publishCacheStats();
+
     // If there are chunks to be read, wake up.
     if (shouldWake) {
         m_worker.workReady();
@@ -4,9 +4,9 @@
 #include <QHash>
 #include <QList>
 #include <QVarLengthArray>
-#include <QVector>
-#include <list>
+#include <memory>
 
+#include "engine/cachingreader/cachingreaderchunkarena.h"
 #include "engine/cachingreader/cachingreaderworker.h"
 #include "engine/engineworker.h"
 #include "preferences/usersettings.h"
@@ -14,6 +14,8 @@
 #include "util/fifo.h"
 #include "util/types.h"
 
+class ControlObject;
+
 // A Hint is an indication to the CachingReader that a certain section of a
 // SoundSource will be used 'soon' and so it should be brought into memory by
 // the reader work thread.
@@ -37,8 +39,8 @@ typedef struct Hint {
     // If a range of frames should be present, use frameCount to indicate that the
     // range (frame, frame + frameCount) should be present in memory.
     SINT frameCount;
-    // Currently unused -- but in the future could be used to prioritize certain
-    // hints over others.
+    // Decides which chunks are kept in memory when the cache runs full,
+    // see CachingReader::hintPriority().
     Type type;
 
     // for the default frame count in forward direction
@@ -74,13 +76,52 @@ typedef QVarLengthArray<Hint, 512> HintVector;
 // The least recently used policy is implemented by keeping a linked list of the
 // least recently used chunks. When a chunk is "freshened" (i.e. accessed via
 // read or hinted via hintAndMaybeWake) then it is moved to the back of the
-// least-recently-used list. When a chunk needs to be allocated and there are no
-// free chunks then the least recently used chunk is free'd (see
-// allocateChunkExpireLRU).
+// least-recently-used list.
+//
+// The chunks are borrowed from a CachingReaderChunkArena that is shared by all
+// instances. When a chunk needs to be allocated and the arena is exhausted
+// then the least recently used chunk that has not been hinted during the
+// current callback is free'd. If all chunks are still hinted the chunk with
+// the least important hint type is replaced (see allocateChunkExpireLRU).
+// While the arena is under pressure each reader returns its chunks that are
+// not hinted anymore, so that they become available to the other decks.
+//
+// On machines with plenty of memory the whole track can be preloaded instead
+// (see kPreloadTracksConfigKey). The worker then decodes all chunks into a
+// CachingReaderPreloadBuffer in the background, starting after the chunks
+// that have been requested by the hints. Chunks that are available in the
+// preload buffer are neither hinted nor cached anymore and once the track has
+// been preloaded completely read() never misses.
+//
+// Completely decoded tracks are stored in the optional DecodedAudioCache on
+// disk (see kDecodedAudioCacheSizeConfigKey). When a cached track is loaded
+// again its samples are read from the memory-mapped cache without decoding.
+// Preloaded tracks are stored from the preload buffer, all other tracks are
+// decoded again from a separate audio source in the background.
+//
+// The number of cache hits (chunks found by read()), misses (hinted chunks
+// that had to be requested from the worker) and underruns (reads that could
+// not be served because the chunk was not ready) are published as the
+// read-only controls [ChannelN],cachingreader_hits, cachingreader_misses and
+// cachingreader_underruns.
 class CachingReader : public QObject {
     Q_OBJECT
 
   public:
+    // Decode the whole track into memory when it is loaded (bool). The
+    // setting is read whenever a new track is loaded.
+    static const ConfigKey kPreloadTracksConfigKey;
+    // The maximum size of the DecodedAudioCache in MiB (int), 0 disables
+    // the cache.
+    static const ConfigKey kDecodedAudioCacheSizeConfigKey;
+    // Store 16-bit instead of 32-bit float samples in the DecodedAudioCache
+    // (bool).
+    static const ConfigKey kDecodedAudioCacheInt16ConfigKey;
+
+    // Applies the DecodedAudioCache settings. Called on startup and
+    // whenever the settings have been changed in the preferences.
+    static void configureDecodedAudioCache(const UserSettingsPointer& pConfig);
+
     // Construct a CachingReader with the given group.
     CachingReader(const QString& group,
             UserSettingsPointer _config);
@@ -144,18 +185,48 @@ class CachingReader : public QObject {
     // Moves the provided chunk to the MRU position.
     void freshenChunk(CachingReaderChunkForOwner* pChunk);
 
-    // Returns a CachingReaderChunk to the free list
+    // Returns a CachingReaderChunk to the arena
     void freeChunk(CachingReaderChunkForOwner* pChunk);
     void freeChunkFromList(CachingReaderChunkForOwner* pChunk);
+    void releaseChunk(CachingReaderChunkForOwner* pChunk);
 
-    // Returns all allocated chunks to the free list
+    // Returns all allocated chunks to the arena
     void freeAllChunks();
 
-    // Gets a chunk from the free list. Returns nullptr if none available.
+    // Gets a chunk from the arena. Returns nullptr if none available.
     CachingReaderChunkForOwner* allocateChunk(SINT chunkIndex);
 
-    // Gets a chunk from the free list, frees the LRU CachingReaderChunk if none available.
-    CachingReaderChunkForOwner* allocateChunkExpireLRU(SINT chunkIndex);
+    // Gets a chunk from the arena or replaces the chunk returned by
+    // findChunkToExpire() if none is available.
+    CachingReaderChunkForOwner* allocateChunkExpireLRU(SINT chunkIndex, int hintPriority);
+
+    // Returns the least recently used chunk that has not been hinted during
+    // the current pass or, if there is none, the chunk with the least
+    // important hint if it is less important than hintPriority.
+    CachingReaderChunkForOwner* findChunkToExpire(int hintPriority) const;
+
+    // Returns chunks that have not been hinted during the current pass to
+    // the arena.
+    void releaseColdChunks();
+
+    void publishCacheStats();
+
+    // Smaller values are more important
+    static int hintPriority(Hint::Type type);
+
+    // The worker frees the preload buffer after the state has been changed
+    // by newTrack(), even if the engine has not received TRACK_UNLOADED yet.
+    const CachingReaderPreloadBuffer* preloadBuffer() const {
+        if (m_state.loadAcquire() != STATE_TRACK_LOADED) {
+            return nullptr;
+        }
+        return m_pPreloadBuffer;
+    }
+
+    bool isPreloadedChunk(SINT chunkIndex) const {
+        const CachingReaderPreloadBuffer* pPreloadBuffer = preloadBuffer();
+        return pPreloadBuffer && pPreloadBuffer->isChunkReady(chunkIndex);
+    }
 
     enum State {
         STATE_IDLE,
@@ -165,12 +236,14 @@ class CachingReader : public QObject {
     };
     QAtomicInt m_state;
 
-    // Keeps track of all CachingReaderChunks we've allocated.
-    QVector<CachingReaderChunkForOwner*> m_chunks;
+    // The shared pool all chunks are borrowed from
+    const std::shared_ptr<CachingReaderChunkArena> m_pArena;
+
+    // The number of chunks borrowed from the arena
+    SINT m_numAllocatedChunks;
 
-    // List of free chunks. Linked list so that we have constant time insertions
-    // and deletions. Iteration is not necessary.
-    std::list<CachingReaderChunkForOwner*> m_freeChunks;
+    // Incremented on every call of hintAndMaybeWake(), never 0
+    quint32 m_hintPass;
 
     // Keeps track of what CachingReaderChunks we've allocated and indexes them based on what
     // chunk number they are allocated to.
@@ -180,11 +253,20 @@ class CachingReader : public QObject {
     CachingReaderChunkForOwner* m_mruCachingReaderChunk;
     CachingReaderChunkForOwner* m_lruCachingReaderChunk;
 
-    // The raw memory buffer which is divided up into chunks.
-    mixxx::SampleBuffer m_sampleBuffer;
-
     // The readable frame index range as reported by the worker.
     mixxx::IndexRange m_readableFrameIndexRange;
 
+    // The preload buffer of the current track as reported by the worker or
+    // nullptr. Only valid in STATE_TRACK_LOADED, use preloadBuffer().
+    const CachingReaderPreloadBuffer* m_pPreloadBuffer;
+
+    // Only accessed from the engine thread and published once per callback
+    quint64 m_cacheHits;
+    quint64 m_cacheMisses;
+    quint64 m_cacheUnderruns;
+    std::unique_ptr<ControlObject> m_pCacheHits;
+    std::unique_ptr<ControlObject> m_pCacheMisses;
+    std::unique_ptr<ControlObject> m_pCacheUnderruns;
+
     CachingReaderWorker m_worker;
 };
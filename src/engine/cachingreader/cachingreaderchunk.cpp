@@ -123,6 +123,8 @@ CachingReaderChunkForOwner::CachingReaderChunkForOwner(
         mixxx::SampleBuffer::WritableSlice sampleBuffer)
         : CachingReaderChunk(std::move(sampleBuffer)),
           m_state(FREE),
+          m_hintPass(0),
+          m_hintPriority(0),
           m_pPrev(nullptr),
           m_pNext(nullptr) {
 }
@@ -136,6 +138,8 @@ void CachingReaderChunkForOwner::init(SINT index) {
 
     CachingReaderChunk::init(index);
     m_state = READY;
+    m_hintPass = 0;
+    m_hintPriority = 0;
 }
 
 void CachingReaderChunkForOwner::free() {
@@ -105,6 +105,24 @@ public:
         return m_state;
     }
 
+    // Records that a hint with the given priority (smaller values are more
+    // important) referred to this chunk during the given hint pass. The
+    // priority of a pass is the one of the most important hint.
+    void markHinted(quint32 hintPass, int hintPriority) {
+        if (m_hintPass != hintPass) {
+            m_hintPass = hintPass;
+            m_hintPriority = hintPriority;
+        } else if (hintPriority < m_hintPriority) {
+            m_hintPriority = hintPriority;
+        }
+    }
+    bool wasHintedInPass(quint32 hintPass) const {
+        return m_hintPass == hintPass;
+    }
+    int getHintPriority() const {
+        return m_hintPriority;
+    }
+
     // The state is controlled by the cache as the owner of each chunk!
     void giveToWorker() {
         // Must not be referenced in MRU/LRU list!
@@ -135,9 +153,18 @@ public:
             CachingReaderChunkForOwner** ppHead,
             CachingReaderChunkForOwner** ppTail);
 
+    // The adjacent item in the double-linked list towards the head
+    CachingReaderChunkForOwner* getPrev() const {
+        return m_pPrev;
+    }
+
 private:
     State m_state;
 
+    // Hint pass 0 is never used by the owner
+    quint32 m_hintPass;
+    int m_hintPriority;
+
     CachingReaderChunkForOwner* m_pPrev; // previous item in double-linked list
     CachingReaderChunkForOwner* m_pNext; // next item in double-linked list
 };
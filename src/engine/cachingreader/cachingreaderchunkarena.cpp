@@ -0,0 +1,146 @@
+#include "engine/cachingreader/cachingreaderchunkarena.h"
+
+#include <QMutex>
+#include <algorithm>
+
+#include "util/assert.h"
+#include "util/compatibility/qmutex.h"
+#include "util/logger.h"
+
+namespace {
+
+mixxx::Logger kLogger("CachingReaderChunkArena");
+
+// The number of chunks that were reserved for each deck before the arena was
+// introduced. The arena never gets smaller than this to leave room for at
+// least a single deck.
+constexpr SINT kMinChunks = 80;
+
+constexpr quint64 kSlotMask = 0xFFFFFFFF;
+
+QMutex s_sharedInstanceMutex;
+std::weak_ptr<CachingReaderChunkArena> s_pSharedInstance;
+
+} // anonymous namespace
+
+const ConfigKey CachingReaderChunkArena::kMemoryBudgetConfigKey =
+        ConfigKey(QStringLiteral("[Soundcard]"), QStringLiteral("CachingReaderMemoryBudgetMB"));
+
+CachingReaderChunkArena::CachingReaderChunkArena(SINT numChunks)
+        : m_sampleBuffer(CachingReaderChunk::kSamples * numChunks),
+          m_nextFreeSlot(std::make_unique<std::atomic<int>[]>(numChunks)),
+          m_freeSlotHead(0),
+          m_numFreeChunks(0) {
+    DEBUG_ASSERT(numChunks > 0);
+    m_chunks.reserve(numChunks);
+    m_slots.reserve(numChunks);
+    for (SINT i = 0; i < numChunks; ++i) {
+        m_chunks.push_back(std::make_unique<CachingReaderChunkForOwner>(
+                mixxx::SampleBuffer::WritableSlice(
+                        m_sampleBuffer,
+                        CachingReaderChunk::kSamples * i,
+                        CachingReaderChunk::kSamples)));
+        m_slots.insert(m_chunks.back().get(), static_cast<int>(i));
+    }
+    // Push in reverse order to hand out the chunks from the start of the
+    // buffer first
+    for (SINT i = numChunks - 1; i >= 0; --i) {
+        pushFreeSlot(static_cast<int>(i));
+    }
+}
+
+CachingReaderChunkArena::~CachingReaderChunkArena() {
+    // All readers share the ownership, so they must be gone by now
+    DEBUG_ASSERT(numFreeChunks() == capacity());
+}
+
+// static
+SINT CachingReaderChunkArena::numChunksForMemoryBudget(int memoryBudgetMB) {
+    const qint64 budgetBytes = static_cast<qint64>(
+                                       std::clamp(memoryBudgetMB,
+                                               kMinMemoryBudgetMB,
+                                               kMaxMemoryBudgetMB)) *
+            1024 * 1024;
+    const qint64 chunkBytes = CachingReaderChunk::kSamples * sizeof(CSAMPLE);
+    return std::max(static_cast<SINT>(budgetBytes / chunkBytes), kMinChunks);
+}
+
+// static
+std::shared_ptr<CachingReaderChunkArena> CachingReaderChunkArena::sharedInstance(
+        const UserSettingsPointer& pConfig) {
+    const auto locker = lockMutex(&s_sharedInstanceMutex);
+    auto pArena = s_pSharedInstance.lock();
+    if (!pArena) {
+        const int memoryBudgetMB = pConfig
+                ? pConfig->getValue(kMemoryBudgetConfigKey, kDefaultMemoryBudgetMB)
+                : kDefaultMemoryBudgetMB;
+        const SINT numChunks = numChunksForMemoryBudget(memoryBudgetMB);
+        kLogger.info()
+                << "Reserving" << numChunks << "chunks for a memory budget of"
+                << memoryBudgetMB << "MB";
+        pArena = std::make_shared<CachingReaderChunkArena>(numChunks);
+        s_pSharedInstance = pArena;
+    }
+    return pArena;
+}
+
+CachingReaderChunkForOwner* CachingReaderChunkArena::allocateChunk() {
+    const int slot = popFreeSlot();
+    if (slot < 0) {
+        return nullptr;
+    }
+    CachingReaderChunkForOwner* pChunk = m_chunks[slot].get();
+    DEBUG_ASSERT(pChunk->getState() == CachingReaderChunkForOwner::FREE);
+    return pChunk;
+}
+
+void CachingReaderChunkArena::freeChunk(CachingReaderChunkForOwner* pChunk) {
+    VERIFY_OR_DEBUG_ASSERT(pChunk) {
+        return;
+    }
+    DEBUG_ASSERT(pChunk->getState() == CachingReaderChunkForOwner::FREE);
+    const int slot = m_slots.value(pChunk, -1);
+    VERIFY_OR_DEBUG_ASSERT(slot >= 0) {
+        kLogger.warning() << "Ignoring chunk that does not belong to the arena";
+        return;
+    }
+    pushFreeSlot(slot);
+}
+
+void CachingReaderChunkArena::pushFreeSlot(int slot) {
+    quint64 head = m_freeSlotHead.load(std::memory_order_relaxed);
+    quint64 newHead;
+    do {
+        m_nextFreeSlot[slot].store(
+                static_cast<int>(head & kSlotMask) - 1, std::memory_order_relaxed);
+        newHead = ((head & ~kSlotMask) + (kSlotMask + 1)) |
+                static_cast<quint64>(slot + 1);
+    } while (!m_freeSlotHead.compare_exchange_weak(head,
+            newHead,
+            std::memory_order_release,
+            std::memory_order_relaxed));
+    m_numFreeChunks.fetch_add(1, std::memory_order_relaxed);
+}
+
+int CachingReaderChunkArena::popFreeSlot() {
+    quint64 head = m_freeSlotHead.load(std::memory_order_acquire);
+    int slot;
+    quint64 newHead;
+    do {
+        slot = static_cast<int>(head & kSlotMask) - 1;
+        if (slot < 0) {
+            return -1;
+        }
+        // The tag in the upper bits is incremented on every change, so the
+        // exchange fails if the slot has been popped and pushed again in the
+        // meantime
+        const int nextSlot = m_nextFreeSlot[slot].load(std::memory_order_relaxed);
+        newHead = ((head & ~kSlotMask) + (kSlotMask + 1)) |
+                static_cast<quint64>(nextSlot + 1);
+    } while (!m_freeSlotHead.compare_exchange_weak(head,
+            newHead,
+            std::memory_order_acquire,
+            std::memory_order_acquire));
+    m_numFreeChunks.fetch_sub(1, std::memory_order_relaxed);
+    return slot;
+}
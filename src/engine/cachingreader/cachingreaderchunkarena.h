@@ -0,0 +1,83 @@
+#pragma once
+
+#include <QHash>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "engine/cachingreader/cachingreaderchunk.h"
+#include "preferences/usersettings.h"
+#include "util/samplebuffer.h"
+
+// CachingReaderChunkArena is the process-wide pool of chunks that is shared
+// by all CachingReader instances. The number of chunks is derived from a
+// configurable memory budget instead of reserving a fixed number of chunks
+// per deck. This allows a deck playing long loops with many hotcues to keep
+// more chunks in memory than a sampler that only plays short one-shots.
+//
+// The memory for all chunks is reserved up front, but the operating system
+// only commits the pages when the worker thread decodes into a chunk for the
+// first time.
+//
+// Allocating and freeing chunks is lock-free and may be done concurrently
+// from all engine threads. Chunks are never taken away from a reader. Each
+// reader returns its cold chunks voluntarily while the arena is under
+// pressure, see CachingReader::hintAndMaybeWake().
+class CachingReaderChunkArena {
+  public:
+    // The memory budget for all chunks in MB
+    static const ConfigKey kMemoryBudgetConfigKey;
+    static constexpr int kDefaultMemoryBudgetMB = 128;
+    static constexpr int kMinMemoryBudgetMB = 16;
+    static constexpr int kMaxMemoryBudgetMB = 4096;
+
+    explicit CachingReaderChunkArena(SINT numChunks);
+    ~CachingReaderChunkArena();
+
+    // Returns the arena that is shared by all readers. A new arena with the
+    // configured memory budget is created if none exists. The budget is only
+    // read when the arena is created, i.e. changes take effect after all
+    // readers have been destroyed (usually on restart).
+    static std::shared_ptr<CachingReaderChunkArena> sharedInstance(
+            const UserSettingsPointer& pConfig);
+
+    static SINT numChunksForMemoryBudget(int memoryBudgetMB);
+
+    SINT capacity() const {
+        return static_cast<SINT>(m_chunks.size());
+    }
+
+    // Only a snapshot while other threads are allocating or freeing chunks
+    SINT numFreeChunks() const {
+        return m_numFreeChunks.load(std::memory_order_relaxed);
+    }
+
+    // Readers should return their chunks that are not referred to by any
+    // hint while the arena is running out of free chunks.
+    bool isUnderPressure() const {
+        return numFreeChunks() < capacity() / 8;
+    }
+
+    // Returns a free chunk or nullptr if the arena is exhausted.
+    CachingReaderChunkForOwner* allocateChunk();
+
+    // Returns a chunk to the arena. The chunk must be in state FREE.
+    void freeChunk(CachingReaderChunkForOwner* pChunk);
+
+  private:
+    void pushFreeSlot(int slot);
+    int popFreeSlot();
+
+    mixxx::SampleBuffer m_sampleBuffer;
+    std::vector<std::unique_ptr<CachingReaderChunkForOwner>> m_chunks;
+
+    // Maps each chunk to its index in m_chunks. Not modified after
+    // construction and thus safe for concurrent lookups.
+    QHash<const CachingReaderChunkForOwner*, int> m_slots;
+
+    // Lock-free stack of free slots. The head contains an ABA tag in the
+    // upper 32 bits and the top slot + 1 in the lower 32 bits (0 if empty).
+    std::unique_ptr<std::atomic<int>[]> m_nextFreeSlot;
+    std::atomic<quint64> m_freeSlotHead;
+    std::atomic<SINT> m_numFreeChunks;
+};
@@ -0,0 +1,216 @@
+#include "engine/cachingreader/cachingreaderpreloadbuffer.h"
+
+#include <cstring>
+
+#include "sources/audiosourcestereoproxy.h"
+#include "util/logger.h"
+#include "util/sample.h"
+
+namespace {
+
+mixxx::Logger kLogger("CachingReaderPreloadBuffer");
+
+} // anonymous namespace
+
+// static
+std::unique_ptr<CachingReaderPreloadBuffer> CachingReaderPreloadBuffer::allocate(
+        mixxx::IndexRange frameIndexRange) {
+    VERIFY_OR_DEBUG_ASSERT(!frameIndexRange.empty()) {
+        return nullptr;
+    }
+    const SINT numSamples = CachingReaderChunk::frames2samples(frameIndexRange.length());
+    const qint64 numBytes = static_cast<qint64>(numSamples) * sizeof(CSAMPLE);
+    if (numBytes > kMaxBytes) {
+        kLogger.info()
+                << "Not preloading" << frameIndexRange.length()
+                << "frames that would occupy" << numBytes / (1024 * 1024) << "MB";
+        return nullptr;
+    }
+    mixxx::SampleBuffer sampleBuffer(numSamples);
+    if (sampleBuffer.size() != numSamples) {
+        kLogger.warning()
+                << "Failed to allocate" << numBytes / (1024 * 1024)
+                << "MB for preloading";
+        return nullptr;
+    }
+    const SINT firstChunkIndex =
+            CachingReaderChunk::indexForFrame(frameIndexRange.start());
+    const SINT numChunks =
+            CachingReaderChunk::indexForFrame(frameIndexRange.end() - 1) -
+            firstChunkIndex + 1;
+    return std::unique_ptr<CachingReaderPreloadBuffer>(
+            new CachingReaderPreloadBuffer(
+                    frameIndexRange,
+                    firstChunkIndex,
+                    numChunks,
+                    std::move(sampleBuffer)));
+}
+
+CachingReaderPreloadBuffer::CachingReaderPreloadBuffer(
+        mixxx::IndexRange frameIndexRange,
+        SINT firstChunkIndex,
+        SINT numChunks,
+        mixxx::SampleBuffer sampleBuffer)
+        : m_frameIndexRange(frameIndexRange),
+          m_firstChunkIndex(firstChunkIndex),
+          m_numChunks(numChunks),
+          m_sampleBuffer(std::move(sampleBuffer)),
+          m_chunkReady(std::make_unique<std::atomic<bool>[]>(numChunks)),
+          m_numReadyChunks(0) {
+    for (SINT i = 0; i < m_numChunks; ++i) {
+        m_chunkReady[i].store(false, std::memory_order_relaxed);
+    }
+}
+
+mixxx::IndexRange CachingReaderPreloadBuffer::chunkFrameIndexRange(SINT chunkIndex) const {
+    DEBUG_ASSERT(containsChunk(chunkIndex));
+    return intersect(
+            mixxx::IndexRange::forward(
+                    chunkIndex * CachingReaderChunk::kFrames,
+                    CachingReaderChunk::kFrames),
+            m_frameIndexRange);
+}
+
+void CachingReaderPreloadBuffer::publishChunk(SINT chunkIndex) {
+    DEBUG_ASSERT(!isChunkReady(chunkIndex));
+    m_chunkReady[chunkIndex - m_firstChunkIndex].store(true, std::memory_order_release);
+    m_numReadyChunks.fetch_add(1, std::memory_order_release);
+}
+
+mixxx::IndexRange CachingReaderPreloadBuffer::readSampleFrames(
+        SINT chunkIndex,
+        CSAMPLE* sampleBuffer,
+        const mixxx::IndexRange& frameIndexRange) const {
+    DEBUG_ASSERT(isChunkReady(chunkIndex));
+    const auto copyableFrameIndexRange =
+            intersect(frameIndexRange, chunkFrameIndexRange(chunkIndex));
+    if (!copyableFrameIndexRange.empty()) {
+        const SINT dstSampleOffset = CachingReaderChunk::frames2samples(
+                copyableFrameIndexRange.start() - frameIndexRange.start());
+        const SINT sampleCount =
+                CachingReaderChunk::frames2samples(copyableFrameIndexRange.length());
+        SampleUtil::copy(
+                sampleBuffer + dstSampleOffset,
+                sampleData(copyableFrameIndexRange.start()),
+                sampleCount);
+    }
+    return copyableFrameIndexRange;
+}
+
+mixxx::IndexRange CachingReaderPreloadBuffer::readSampleFramesReverse(
+        SINT chunkIndex,
+        CSAMPLE* reverseSampleBuffer,
+        const mixxx::IndexRange& frameIndexRange) const {
+    DEBUG_ASSERT(isChunkReady(chunkIndex));
+    const auto copyableFrameIndexRange =
+            intersect(frameIndexRange, chunkFrameIndexRange(chunkIndex));
+    if (!copyableFrameIndexRange.empty()) {
+        const SINT dstSampleOffset = CachingReaderChunk::frames2samples(
+                copyableFrameIndexRange.start() - frameIndexRange.start());
+        const SINT sampleCount =
+                CachingReaderChunk::frames2samples(copyableFrameIndexRange.length());
+        SampleUtil::copyReverse(
+                reverseSampleBuffer - dstSampleOffset - sampleCount,
+                sampleData(copyableFrameIndexRange.start()),
+                sampleCount);
+    }
+    return copyableFrameIndexRange;
+}
+
+SINT CachingReaderPreloadBuffer::nextMissingChunk(SINT chunkIndex) const {
+    if (isComplete()) {
+        return -1;
+    }
+    if (!containsChunk(chunkIndex)) {
+        chunkIndex = m_firstChunkIndex;
+    }
+    for (SINT i = 0; i < m_numChunks; ++i) {
+        const SINT nextChunkIndex = m_firstChunkIndex +
+                (chunkIndex - m_firstChunkIndex + i) % m_numChunks;
+        if (!isChunkReady(nextChunkIndex)) {
+            return nextChunkIndex;
+        }
+    }
+    DEBUG_ASSERT(!"unreachable");
+    return -1;
+}
+
+void CachingReaderPreloadBuffer::bufferChunk(
+        SINT chunkIndex,
+        const mixxx::AudioSourcePointer& pAudioSource,
+        mixxx::SampleBuffer::WritableSlice tempOutputBuffer) {
+    VERIFY_OR_DEBUG_ASSERT(containsChunk(chunkIndex) && !isChunkReady(chunkIndex)) {
+        return;
+    }
+    const auto frameIndexRange = chunkFrameIndexRange(chunkIndex);
+    // The readable range of the audio source shrinks on decoding errors
+    const auto readableFrameIndexRange = pAudioSource
+            ? intersect(frameIndexRange, pAudioSource->frameIndexRange())
+            : mixxx::IndexRange();
+    mixxx::IndexRange bufferedFrameIndexRange;
+    if (!readableFrameIndexRange.empty()) {
+        mixxx::AudioSourceStereoProxy audioSourceProxy(
+                pAudioSource,
+                tempOutputBuffer);
+        DEBUG_ASSERT(audioSourceProxy.getSignalInfo().getChannelCount() ==
+                CachingReaderChunk::kChannels);
+        const auto readableSampleFrames = audioSourceProxy.readSampleFrames(
+                mixxx::WritableSampleFrames(
+                        readableFrameIndexRange,
+                        mixxx::SampleBuffer::WritableSlice(
+                                sampleData(readableFrameIndexRange.start()),
+                                CachingReaderChunk::frames2samples(
+                                        readableFrameIndexRange.length()))));
+        bufferedFrameIndexRange = readableSampleFrames.frameIndexRange();
+        DEBUG_ASSERT(bufferedFrameIndexRange.empty() ||
+                bufferedFrameIndexRange.isSubrangeOf(readableFrameIndexRange));
+        if (!bufferedFrameIndexRange.empty()) {
+            // The decoded samples start with the first frame that could be
+            // read and need to be moved if any frames have been skipped
+            CSAMPLE* pDest = sampleData(bufferedFrameIndexRange.start());
+            if (readableSampleFrames.readableData() != pDest) {
+                std::memmove(pDest,
+                        readableSampleFrames.readableData(),
+                        CachingReaderChunk::frames2samples(
+                                bufferedFrameIndexRange.length()) *
+                                sizeof(CSAMPLE));
+            }
+        }
+    }
+    if (bufferedFrameIndexRange != frameIndexRange) {
+        kLogger.warning()
+                << "Filling unreadable frames with silence:"
+                << "expected =" << frameIndexRange
+                << ", actual =" << bufferedFrameIndexRange;
+        if (bufferedFrameIndexRange.empty()) {
+            SampleUtil::clear(
+                    sampleData(frameIndexRange.start()),
+                    CachingReaderChunk::frames2samples(frameIndexRange.length()));
+        } else {
+            SampleUtil::clear(
+                    sampleData(frameIndexRange.start()),
+                    CachingReaderChunk::frames2samples(
+                            bufferedFrameIndexRange.start() - frameIndexRange.start()));
+            SampleUtil::clear(
+                    sampleData(bufferedFrameIndexRange.end()),
+                    CachingReaderChunk::frames2samples(
+                            frameIndexRange.end() - bufferedFrameIndexRange.end()));
+        }
+    }
+    publishChunk(chunkIndex);
+}
+
+void CachingReaderPreloadBuffer::storeChunk(const CachingReaderChunk& chunk) {
+    const SINT chunkIndex = chunk.getIndex();
+    if (!containsChunk(chunkIndex) || isChunkReady(chunkIndex)) {
+        return;
+    }
+    const auto frameIndexRange = chunkFrameIndexRange(chunkIndex);
+    const auto copiedFrameIndexRange = chunk.readBufferedSampleFrames(
+            sampleData(frameIndexRange.start()),
+            frameIndexRange);
+    if (copiedFrameIndexRange != frameIndexRange) {
+        return;
+    }
+    publishChunk(chunkIndex);
+}
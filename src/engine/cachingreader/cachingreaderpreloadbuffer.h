@@ -0,0 +1,122 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+
+#include "engine/cachingreader/cachingreaderchunk.h"
+#include "sources/audiosource.h"
+#include "util/samplebuffer.h"
+
+// CachingReaderPreloadBuffer holds the decoded samples of a whole track in a
+// single contiguous buffer. It is filled chunk by chunk by the
+// CachingReaderWorker in the background and read by the CachingReader in the
+// engine thread without any locking.
+//
+// The buffer uses the same chunk indices as the cache, i.e. they are
+// counted from frame 0 and not from the start of the readable range. The
+// first and the last chunk may be partial. Each chunk is written
+// only once by the worker before it is published. Published chunks are never
+// modified again. Frames that could not be decoded are filled with silence,
+// i.e. a ready chunk always provides all of its frames.
+class CachingReaderPreloadBuffer {
+  public:
+    // Tracks that would need more memory are not preloaded. 2 GB are
+    // sufficient for more than 1.5 hours of stereo audio at 44.1 kHz.
+    static constexpr qint64 kMaxBytes = qint64(2) * 1024 * 1024 * 1024;
+
+    // Returns nullptr if the track is too long or if the memory could
+    // not be allocated.
+    static std::unique_ptr<CachingReaderPreloadBuffer> allocate(
+            mixxx::IndexRange frameIndexRange);
+
+    mixxx::IndexRange frameIndexRange() const {
+        return m_frameIndexRange;
+    }
+
+    SINT firstChunkIndex() const {
+        return m_firstChunkIndex;
+    }
+    SINT numChunks() const {
+        return m_numChunks;
+    }
+
+    // May be called from any thread
+    bool isChunkReady(SINT chunkIndex) const {
+        return containsChunk(chunkIndex) &&
+                m_chunkReady[chunkIndex - m_firstChunkIndex].load(
+                        std::memory_order_acquire);
+    }
+    SINT numReadyChunks() const {
+        return m_numReadyChunks.load(std::memory_order_acquire);
+    }
+    bool isComplete() const {
+        return numReadyChunks() == m_numChunks;
+    }
+
+    // The samples of all frames in frameIndexRange(). Only valid if the
+    // buffer is complete.
+    const CSAMPLE* data() const {
+        DEBUG_ASSERT(isComplete());
+        return m_sampleBuffer.data();
+    }
+
+    // Same as the corresponding functions of CachingReaderChunk. The chunk
+    // must be ready.
+    mixxx::IndexRange readSampleFrames(
+            SINT chunkIndex,
+            CSAMPLE* sampleBuffer,
+            const mixxx::IndexRange& frameIndexRange) const;
+    mixxx::IndexRange readSampleFramesReverse(
+            SINT chunkIndex,
+            CSAMPLE* reverseSampleBuffer,
+            const mixxx::IndexRange& frameIndexRange) const;
+
+    // Returns the first chunk that is not ready yet, starting the search at
+    // chunkIndex and wrapping around at the end of the track. Returns -1 if
+    // the buffer is complete. Only called by the worker.
+    SINT nextMissingChunk(SINT chunkIndex) const;
+
+    // Decodes and publishes a chunk that is not ready yet. Only called by
+    // the worker.
+    void bufferChunk(
+            SINT chunkIndex,
+            const mixxx::AudioSourcePointer& pAudioSource,
+            mixxx::SampleBuffer::WritableSlice tempOutputBuffer);
+
+    // Copies and publishes a chunk that has been decoded on request by the
+    // worker. Incomplete chunks are ignored and decoded again by
+    // bufferChunk() later. Only called by the worker.
+    void storeChunk(const CachingReaderChunk& chunk);
+
+  private:
+    CachingReaderPreloadBuffer(
+            mixxx::IndexRange frameIndexRange,
+            SINT firstChunkIndex,
+            SINT numChunks,
+            mixxx::SampleBuffer sampleBuffer);
+
+    bool containsChunk(SINT chunkIndex) const {
+        return chunkIndex >= m_firstChunkIndex &&
+                chunkIndex < m_firstChunkIndex + m_numChunks;
+    }
+
+    mixxx::IndexRange chunkFrameIndexRange(SINT chunkIndex) const;
+
+    CSAMPLE* sampleData(SINT frameIndex) {
+        return m_sampleBuffer.data(CachingReaderChunk::frames2samples(
+                frameIndex - m_frameIndexRange.start()));
+    }
+    const CSAMPLE* sampleData(SINT frameIndex) const {
+        return m_sampleBuffer.data(CachingReaderChunk::frames2samples(
+                frameIndex - m_frameIndexRange.start()));
+    }
+
+    void publishChunk(SINT chunkIndex);
+
+    const mixxx::IndexRange m_frameIndexRange;
+    const SINT m_firstChunkIndex;
+    const SINT m_numChunks;
+    mixxx::SampleBuffer m_sampleBuffer;
+    std::unique_ptr<std::atomic<bool>[]> m_chunkReady;
+    std::atomic<SINT> m_numReadyChunks;
+};
@@ -2,16 +2,21 @@
 
 #include <QAtomicInt>
 #include <QFileInfo>
+#include <QThreadPool>
+#include <QtConcurrentRun>
 #include <QtDebug>
+#include <atomic>
 
 #include "analyzer/analyzersilence.h"
 #include "control/controlobject.h"
 #include "moc_cachingreaderworker.cpp"
+#include "sources/decodedaudiocache.h"
 #include "sources/soundsourceproxy.h"
 #include "track/track.h"
 #include "util/compatibility/qmutex.h"
 #include "util/event.h"
 #include "util/logger.h"
+#include "util/math.h"
 #include "util/span.h"
 
 namespace {
@@ -21,6 +26,27 @@ mixxx::Logger kLogger("CachingReaderWorker");
 // we need the last silence frame and the first sound frame
 constexpr SINT kNumSoundFrameToVerify = 2;
 
+// The maximum number of chunks that are read concurrently per deck,
+// including the chunk that is read by the worker thread itself.
+constexpr int kMaxConcurrentReadRequests = 4;
+
+// The threads for decoding chunks concurrently are shared by all decks
+QThreadPool* chunkDecoderThreadPool() {
+    static const auto s_pThreadPool = [] {
+        auto pThreadPool = std::make_unique<QThreadPool>();
+        pThreadPool->setMaxThreadCount(
+                math_max(2, QThread::idealThreadCount() / 2));
+        return pThreadPool;
+    }();
+    return s_pThreadPool.get();
+}
+
+mixxx::AudioSourcePointer openAudioSource(const TrackPointer& pTrack) {
+    mixxx::AudioSource::OpenParams config;
+    config.setChannelCount(CachingReaderChunk::kChannels);
+    return SoundSourceProxy(pTrack).openAudioSource(config);
+}
+
 } // anonymous namespace
 
 CachingReaderWorker::CachingReaderWorker(
@@ -30,41 +56,163 @@ CachingReaderWorker::CachingReaderWorker(
         : m_group(group),
           m_tag(QString("CachingReaderWorker %1").arg(m_group)),
           m_pChunkReadRequestFIFO(pChunkReadRequestFIFO),
-          m_pReaderStatusFIFO(pReaderStatusFIFO) {
+          m_pReaderStatusFIFO(pReaderStatusFIFO),
+          m_newTrackPreload(false),
+          m_audioSourceCached(false),
+          m_preloadChunkIndex(0) {
+}
+
+void CachingReaderWorker::processReadRequests() {
+    if (m_newTrackAvailable.loadAcquire()) {
+        // All pending requests will be discarded when loading the track
+        return;
+    }
+    CachingReaderChunkReadRequest requests[kMaxConcurrentReadRequests];
+    const int requestCount = m_pChunkReadRequestFIFO->read(
+            requests,
+            1 + static_cast<int>(m_chunkDecoders.size()));
+    if (requestCount <= 0) {
+        return;
+    }
+
+    // Requests after the first one are read concurrently by the decoders.
+    // They are independent, because each chunk is only requested once and
+    // each decoder has its own audio source. Finished decoders are signaled
+    // through the semaphore.
+    std::optional<ReaderStatusUpdate> decodedChunks[kMaxConcurrentReadRequests];
+    std::atomic<bool> decoded[kMaxConcurrentReadRequests] = {};
+    QSemaphore decodedCount;
+    for (int i = 1; i < requestCount; ++i) {
+        ChunkDecoder* pDecoder = m_chunkDecoders[i - 1].get();
+        CachingReaderChunk* pChunk = requests[i].chunk;
+        static_cast<void>(QtConcurrent::run(chunkDecoderThreadPool(),
+                [group = m_group,
+                        pTrack = m_pTrack,
+                        pDecoder,
+                        pChunk,
+                        pDecodedChunk = &decodedChunks[i],
+                        pDecoded = &decoded[i],
+                        pDecodedCount = &decodedCount] {
+                    *pDecodedChunk = decodeChunk(group, pTrack, pDecoder, pChunk);
+                    pDecoded->store(true, std::memory_order_release);
+                    pDecodedCount->release();
+                }));
+    }
+
+    // The first request has the highest priority and is reported as
+    // soon as it is available
+    const ReaderStatusUpdate update = processReadRequest(requests[0]);
+    m_pReaderStatusFIFO->writeBlocking(&update, 1);
+
+    // The other chunks are reported in the order they become available.
+    // All decoders must have finished before returning, because the
+    // audio source of the track might be closed afterwards.
+    bool reported[kMaxConcurrentReadRequests] = {};
+    for (int pending = requestCount - 1; pending > 0; --pending) {
+        decodedCount.acquire();
+        int i = 1;
+        while (reported[i] || !decoded[i].load(std::memory_order_acquire)) {
+            ++i;
+            DEBUG_ASSERT(i < requestCount);
+        }
+        reported[i] = true;
+        if (decodedChunks[i]) {
+            finishReadRequest(requests[i].chunk, decodedChunks[i]->status);
+            m_pReaderStatusFIFO->writeBlocking(&*decodedChunks[i], 1);
+        } else if (m_newTrackAvailable.loadAcquire()) {
+            // Don't delay loading the next track
+            const auto discardedUpdate =
+                    ReaderStatusUpdate::readDiscarded(requests[i].chunk);
+            m_pReaderStatusFIFO->writeBlocking(&discardedUpdate, 1);
+        } else {
+            // Fall back to the audio source of the worker
+            const ReaderStatusUpdate fallbackUpdate = processReadRequest(requests[i]);
+            m_pReaderStatusFIFO->writeBlocking(&fallbackUpdate, 1);
+        }
+    }
 }
 
 ReaderStatusUpdate CachingReaderWorker::processReadRequest(
         const CachingReaderChunkReadRequest& request) {
     CachingReaderChunk* pChunk = request.chunk;
     DEBUG_ASSERT(pChunk);
+    const ReaderStatusUpdate result = readChunk(
+            m_group,
+            m_pAudioSource,
+            &m_tempReadBuffer,
+            pChunk);
+    finishReadRequest(pChunk, result.status);
+    return result;
+}
+
+// static
+std::optional<ReaderStatusUpdate> CachingReaderWorker::decodeChunk(
+        const QString& group,
+        const TrackPointer& pTrack,
+        ChunkDecoder* pDecoder,
+        CachingReaderChunk* pChunk) {
+    DEBUG_ASSERT(pDecoder);
+    if (!pDecoder->pAudioSource) {
+        if (pDecoder->failed || !pTrack) {
+            return std::nullopt;
+        }
+        pDecoder->pAudioSource = openAudioSource(pTrack);
+        if (!pDecoder->pAudioSource) {
+            kLogger.warning()
+                    << group
+                    << "Failed to open additional decoder for"
+                    << pTrack->getFileInfo();
+            pDecoder->failed = true;
+            return std::nullopt;
+        }
+        const SINT tempReadBufferSize =
+                pDecoder->pAudioSource->getSignalInfo().frames2samples(
+                        CachingReaderChunk::kFrames);
+        mixxx::SampleBuffer(tempReadBufferSize).swap(pDecoder->tempReadBuffer);
+    }
+    return readChunk(
+            group,
+            pDecoder->pAudioSource,
+            &pDecoder->tempReadBuffer,
+            pChunk);
+}
+
+// static
+ReaderStatusUpdate CachingReaderWorker::readChunk(
+        const QString& group,
+        const mixxx::AudioSourcePointer& pAudioSource,
+        mixxx::SampleBuffer* pTempReadBuffer,
+        CachingReaderChunk* pChunk) {
+    DEBUG_ASSERT(pTempReadBuffer);
+    DEBUG_ASSERT(pChunk);
 
     // Before trying to read any data we need to check if the audio source
     // is available and if any audio data that is needed by the chunk is
     // actually available.
-    auto chunkFrameIndexRange = pChunk->frameIndexRange(m_pAudioSource);
-    DEBUG_ASSERT(!m_pAudioSource ||
-            chunkFrameIndexRange.isSubrangeOf(m_pAudioSource->frameIndexRange()));
+    auto chunkFrameIndexRange = pChunk->frameIndexRange(pAudioSource);
+    DEBUG_ASSERT(!pAudioSource ||
+            chunkFrameIndexRange.isSubrangeOf(pAudioSource->frameIndexRange()));
     if (chunkFrameIndexRange.empty()) {
         ReaderStatusUpdate result;
-        result.init(CHUNK_READ_INVALID, pChunk, m_pAudioSource ? m_pAudioSource->frameIndexRange() : mixxx::IndexRange());
+        result.init(CHUNK_READ_INVALID, pChunk, pAudioSource ? pAudioSource->frameIndexRange() : mixxx::IndexRange());
         return result;
     }
 
     // Try to read the data required for the chunk from the audio source
     const mixxx::IndexRange bufferedFrameIndexRange = pChunk->bufferSampleFrames(
-            m_pAudioSource,
-            mixxx::SampleBuffer::WritableSlice(m_tempReadBuffer));
-    DEBUG_ASSERT(!m_pAudioSource ||
-            bufferedFrameIndexRange.isSubrangeOf(m_pAudioSource->frameIndexRange()));
+            pAudioSource,
+            mixxx::SampleBuffer::WritableSlice(*pTempReadBuffer));
+    DEBUG_ASSERT(!pAudioSource ||
+            bufferedFrameIndexRange.isSubrangeOf(pAudioSource->frameIndexRange()));
     // The readable frame range might have changed
-    chunkFrameIndexRange = intersect(chunkFrameIndexRange, m_pAudioSource->frameIndexRange());
+    chunkFrameIndexRange = intersect(chunkFrameIndexRange, pAudioSource->frameIndexRange());
     DEBUG_ASSERT(bufferedFrameIndexRange.empty() ||
             bufferedFrameIndexRange.isSubrangeOf(chunkFrameIndexRange));
 
     ReaderStatus status = bufferedFrameIndexRange.empty() ? CHUNK_READ_EOF : CHUNK_READ_SUCCESS;
     if (bufferedFrameIndexRange != chunkFrameIndexRange) {
         kLogger.warning()
-                << m_group
+                << group
                 << "Failed to read chunk samples for frame index range:"
                 << "expected =" << chunkFrameIndexRange
                 << ", actual =" << bufferedFrameIndexRange;
@@ -73,6 +221,18 @@ ReaderStatusUpdate CachingReaderWorker::processReadRequest(
         }
     }
 
+    ReaderStatusUpdate result;
+    result.init(status, pChunk, pAudioSource ? pAudioSource->frameIndexRange() : mixxx::IndexRange());
+    return result;
+}
+
+void CachingReaderWorker::finishReadRequest(
+        const CachingReaderChunk* pChunk, ReaderStatus status) {
+    if (status == CHUNK_READ_INVALID && pChunk->frameIndexRange(m_pAudioSource).empty()) {
+        // Nothing has been read
+        return;
+    }
+
     // This call here assumes that the caching reader will read the first sound cue at
     // one of the first chunks. The check serves as a sanity check to ensure that the
     // sample data has not changed since it has ben analyzed. This could happen because
@@ -85,16 +245,21 @@ ReaderStatusUpdate CachingReaderWorker::processReadRequest(
     // Failures of the sanity check only result in an entry into the log at the moment.
     verifyFirstSound(pChunk);
 
-    ReaderStatusUpdate result;
-    result.init(status, pChunk, m_pAudioSource ? m_pAudioSource->frameIndexRange() : mixxx::IndexRange());
-    return result;
+    if (m_pPreloadBuffer) {
+        if (status == CHUNK_READ_SUCCESS) {
+            m_pPreloadBuffer->storeChunk(*pChunk);
+        }
+        // Continue preloading where the engine is about to read
+        m_preloadChunkIndex = pChunk->getIndex() + 1;
+    }
 }
 
 // WARNING: Always called from a different thread (GUI)
-void CachingReaderWorker::newTrack(TrackPointer pTrack) {
+void CachingReaderWorker::newTrack(TrackPointer pTrack, bool preload) {
     {
         const auto locker = lockMutex(&m_newTrackMutex);
         m_pNewTrack = pTrack;
+        m_newTrackPreload = preload;
         m_newTrackAvailable.storeRelease(1);
     }
     workReady();
@@ -109,27 +274,30 @@ void CachingReaderWorker::run() {
 
     Event::start(m_tag);
     while (!m_stop.loadAcquire()) {
-        // Request is initialized by reading from FIFO
-        CachingReaderChunkReadRequest request;
         if (m_newTrackAvailable.loadAcquire()) {
             TrackPointer pLoadTrack;
+            bool preload = false;
             { // locking scope
                 const auto locker = lockMutex(&m_newTrackMutex);
                 pLoadTrack = m_pNewTrack;
+                preload = m_newTrackPreload;
                 m_pNewTrack.reset();
                 m_newTrackAvailable.storeRelease(0);
             } // implicitly unlocks the mutex
             if (pLoadTrack) {
                 // in this case the engine is still running with the old track
-                loadTrack(pLoadTrack);
+                loadTrack(pLoadTrack, preload);
             } else {
                 // here, the engine is already stopped
                 unloadTrack();
             }
-        } else if (m_pChunkReadRequestFIFO->read(&request, 1) == 1) {
-            // Read the requested chunk and send the result
-            const ReaderStatusUpdate update = processReadRequest(request);
-            m_pReaderStatusFIFO->writeBlocking(&update, 1);
+        } else if (m_pChunkReadRequestFIFO->readAvailable() > 0) {
+            // Read the requested chunks and send the results
+            processReadRequests();
+        } else if (preloadNextChunk()) {
+            // Decode a single chunk at a time to pick up new requests
+            // from the engine timely
+            continue;
         } else {
             Event::end(m_tag);
             m_semaRun.acquire();
@@ -146,9 +314,58 @@ void CachingReaderWorker::discardAllPendingRequests() {
     }
 }
 
+bool CachingReaderWorker::preloadNextChunk() {
+    if (!m_pPreloadBuffer) {
+        return false;
+    }
+    const SINT chunkIndex = m_pPreloadBuffer->nextMissingChunk(m_preloadChunkIndex);
+    if (chunkIndex < 0) {
+        return false;
+    }
+    m_pPreloadBuffer->bufferChunk(
+            chunkIndex,
+            m_pAudioSource,
+            mixxx::SampleBuffer::WritableSlice(m_tempReadBuffer));
+    m_preloadChunkIndex = chunkIndex + 1;
+    if (m_pPreloadBuffer->isComplete()) {
+        kLogger.info()
+                << m_group
+                << "Preloaded all"
+                << m_pPreloadBuffer->numChunks()
+                << "chunks of the track";
+        if (!m_audioSourceCached && m_pTrack &&
+                mixxx::DecodedAudioCache::canStore(
+                        m_pPreloadBuffer->frameIndexRange())) {
+            // Written in the background to keep this worker responsive for
+            // loading the next track. The buffer is shared until then.
+            mixxx::DecodedAudioCache::storeAsync(
+                    m_pTrack->getFileInfo().asQFileInfo(),
+                    m_pAudioSource->getSignalInfo().getSampleRate(),
+                    m_pPreloadBuffer->frameIndexRange(),
+                    std::shared_ptr<const CSAMPLE>(
+                            m_pPreloadBuffer, m_pPreloadBuffer->data()));
+        }
+    }
+    return true;
+}
+
 void CachingReaderWorker::closeAudioSource() {
     discardAllPendingRequests();
 
+    // The reader does not access the preload buffer anymore since
+    // newTrack() has changed its state
+    m_pPreloadBuffer.reset();
+
+    // The decoders are idle between read requests
+    for (const auto& pDecoder : m_chunkDecoders) {
+        if (pDecoder->pAudioSource) {
+            pDecoder->pAudioSource->close();
+        }
+    }
+    m_chunkDecoders.clear();
+    m_pTrack.reset();
+    m_audioSourceCached = false;
+
     if (m_pAudioSource) {
         // Closes open file handles of the old track.
         m_pAudioSource->close();
@@ -167,7 +384,7 @@ void CachingReaderWorker::unloadTrack() {
     m_pReaderStatusFIFO->writeBlocking(&update, 1);
 }
 
-void CachingReaderWorker::loadTrack(const TrackPointer& pTrack) {
+void CachingReaderWorker::loadTrack(const TrackPointer& pTrack, bool preload) {
     // This emit is directly connected and returns synchronized
     // after the engine has been stopped.
     emit trackLoading();
@@ -187,9 +404,18 @@ void CachingReaderWorker::loadTrack(const TrackPointer& pTrack) {
         return;
     }
 
-    mixxx::AudioSource::OpenParams config;
-    config.setChannelCount(CachingReaderChunk::kChannels);
-    m_pAudioSource = SoundSourceProxy(pTrack).openAudioSource(config);
+    // Decoded samples are read from the cache without decoding
+    m_pAudioSource = mixxx::DecodedAudioCache::open(
+            pTrack->getFileInfo().asQFileInfo());
+    m_audioSourceCached = m_pAudioSource != nullptr;
+    if (m_audioSourceCached) {
+        kLogger.info()
+                << m_group
+                << "Reading decoded samples from cache"
+                << pTrack->getFileInfo();
+    } else {
+        m_pAudioSource = openAudioSource(pTrack);
+    }
     if (!m_pAudioSource) {
         kLogger.warning()
                 << m_group
@@ -228,9 +454,33 @@ void CachingReaderWorker::loadTrack(const TrackPointer& pTrack) {
         mixxx::SampleBuffer(tempReadBufferSize).swap(m_tempReadBuffer);
     }
 
+    // Additional decoders for reading multiple chunks concurrently,
+    // e.g. after seeking when hints for the play position, loops and
+    // hotcues arrive at once. Their audio sources are opened on demand.
+    m_pTrack = pTrack;
+    if (!m_audioSourceCached) {
+        for (int i = 1; i < kMaxConcurrentReadRequests; ++i) {
+            m_chunkDecoders.push_back(std::make_unique<ChunkDecoder>());
+        }
+    }
+
+    if (preload) {
+        m_pPreloadBuffer = CachingReaderPreloadBuffer::allocate(
+                m_pAudioSource->frameIndexRange());
+        if (m_pPreloadBuffer) {
+            m_preloadChunkIndex = m_pPreloadBuffer->firstChunkIndex();
+        }
+    }
+    if (!m_audioSourceCached && !m_pPreloadBuffer &&
+            mixxx::DecodedAudioCache::canStore(m_pAudioSource->frameIndexRange())) {
+        // Filling the cache must not preload the track into memory
+        mixxx::DecodedAudioCache::storeAsync(pTrack);
+    }
+
     const auto update =
             ReaderStatusUpdate::trackLoaded(
-                    m_pAudioSource->frameIndexRange());
+                    m_pAudioSource->frameIndexRange(),
+                    m_pPreloadBuffer.get());
     m_pReaderStatusFIFO->writeBlocking(&update, 1);
 
     // Emit that the track is loaded.
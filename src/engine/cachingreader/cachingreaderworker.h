@@ -5,9 +5,13 @@
 #include <QString>
 #include <QThread>
 #include <QtDebug>
+#include <memory>
+#include <optional>
+#include <vector>
 
 #include "audio/frame.h"
 #include "engine/cachingreader/cachingreaderchunk.h"
+#include "engine/cachingreader/cachingreaderpreloadbuffer.h"
 #include "engine/engineworker.h"
 #include "sources/audiosource.h"
 #include "track/track_decl.h"
@@ -37,6 +41,7 @@ enum ReaderStatus {
 typedef struct ReaderStatusUpdate {
   private:
     CachingReaderChunk* chunk;
+    const CachingReaderPreloadBuffer* preloadBuffer;
     SINT readableFrameIndexRangeStart;
     SINT readableFrameIndexRangeEnd;
 
@@ -49,6 +54,7 @@ typedef struct ReaderStatusUpdate {
             const mixxx::IndexRange& readableFrameIndexRangeArg) {
         status = statusArg;
         chunk = chunkArg;
+        preloadBuffer = nullptr;
         readableFrameIndexRangeStart = readableFrameIndexRangeArg.start();
         readableFrameIndexRangeEnd = readableFrameIndexRangeArg.end();
     }
@@ -60,11 +66,16 @@ typedef struct ReaderStatusUpdate {
         return update;
     }
 
+    // The preload buffer is optional and owned by the worker. It is freed
+    // when the next track is loaded or the track is unloaded, i.e. the
+    // reader must only access it until newTrack() is invoked again.
     static ReaderStatusUpdate trackLoaded(
-            const mixxx::IndexRange& readableFrameIndexRange) {
+            const mixxx::IndexRange& readableFrameIndexRange,
+            const CachingReaderPreloadBuffer* preloadBufferArg) {
         DEBUG_ASSERT(!readableFrameIndexRange.empty());
         ReaderStatusUpdate update;
         update.init(TRACK_LOADED, nullptr, readableFrameIndexRange);
+        update.preloadBuffer = preloadBufferArg;
         return update;
     }
 
@@ -90,6 +101,10 @@ typedef struct ReaderStatusUpdate {
                 readableFrameIndexRangeStart,
                 readableFrameIndexRangeEnd);
     }
+
+    const CachingReaderPreloadBuffer* getPreloadBuffer() const {
+        return preloadBuffer;
+    }
 } ReaderStatusUpdate;
 
 class CachingReaderWorker : public EngineWorker {
@@ -103,7 +118,9 @@ class CachingReaderWorker : public EngineWorker {
     ~CachingReaderWorker() override = default;
 
     // Request to load a new track. wake() must be called afterwards.
-    void newTrack(TrackPointer pTrack);
+    // If preload is true the whole track is decoded into a
+    // CachingReaderPreloadBuffer in the background.
+    void newTrack(TrackPointer pTrack, bool preload);
 
     // Run upkeep operations like loading tracks and reading from file. Run by a
     // thread pool via the EngineWorkerScheduler.
@@ -118,6 +135,8 @@ class CachingReaderWorker : public EngineWorker {
     void trackLoadFailed(TrackPointer pTrack, const QString& reason);
 
   private:
+    friend class CachingReaderWorkerTest;
+
     const QString m_group;
     QString m_tag;
 
@@ -131,6 +150,7 @@ class CachingReaderWorker : public EngineWorker {
     QMutex m_newTrackMutex;
     QAtomicInt m_newTrackAvailable;
     TrackPointer m_pNewTrack;
+    bool m_newTrackPreload;
 
     void discardAllPendingRequests();
 
@@ -143,18 +163,72 @@ class CachingReaderWorker : public EngineWorker {
     void unloadTrack();
 
     /// Internal method to load a track. Emits trackLoaded when finished.
-    void loadTrack(const TrackPointer& pTrack);
+    void loadTrack(const TrackPointer& pTrack, bool preload);
+
+    /// An additional audio source of the current track with its own
+    /// seek position for reading chunks concurrently.
+    struct ChunkDecoder {
+        mixxx::AudioSourcePointer pAudioSource;
+        mixxx::SampleBuffer tempReadBuffer;
+        // Opening the audio source has failed and will not be retried
+        bool failed = false;
+    };
+
+    /// Reads all pending requests. Independent requests are read
+    /// concurrently by the decoders. The first request is reported first,
+    /// the others as soon as they are decoded. Returns without reading
+    /// if a new track is pending.
+    void processReadRequests();
 
     ReaderStatusUpdate processReadRequest(
             const CachingReaderChunkReadRequest& request);
 
+    /// Reads a chunk on the shared thread pool. Returns std::nullopt
+    /// if the audio source of the decoder could not be opened.
+    static std::optional<ReaderStatusUpdate> decodeChunk(
+            const QString& group,
+            const TrackPointer& pTrack,
+            ChunkDecoder* pDecoder,
+            CachingReaderChunk* pChunk);
+
+    /// Reads a chunk from an audio source. Thread-safe as long as the
+    /// audio source is not accessed concurrently.
+    static ReaderStatusUpdate readChunk(
+            const QString& group,
+            const mixxx::AudioSourcePointer& pAudioSource,
+            mixxx::SampleBuffer* pTempReadBuffer,
+            CachingReaderChunk* pChunk);
+
+    /// Post-processing of a read chunk on the worker thread
+    void finishReadRequest(const CachingReaderChunk* pChunk, ReaderStatus status);
+
     void verifyFirstSound(const CachingReaderChunk* pChunk);
 
+    // Decodes the next chunk into the preload buffer. Returns false if
+    // there is nothing left to do.
+    bool preloadNextChunk();
+
     // The current audio source of the track loaded
     mixxx::AudioSourcePointer m_pAudioSource;
+    // m_pAudioSource reads from the DecodedAudioCache
+    bool m_audioSourceCached;
+
+    // The track of m_pAudioSource for opening additional decoders
+    TrackPointer m_pTrack;
+    // The decoders are opened on first use and closed together with
+    // m_pAudioSource
+    std::vector<std::unique_ptr<ChunkDecoder>> m_chunkDecoders;
 
     mixxx::audio::FramePos m_firstSoundFrameToVerify;
 
+    // The whole decoded track if preloading is enabled. The reader
+    // stops accessing it when newTrack() is invoked, i.e. before the
+    // worker closes the audio source on both the load and the unload
+    // path. Shared with the DecodedAudioCache while it is written.
+    std::shared_ptr<CachingReaderPreloadBuffer> m_pPreloadBuffer;
+    // Preloading continues after the most recently requested chunk
+    SINT m_preloadChunkIndex;
+
     // Temporary buffer for reading samples from all channels
     // before conversion to a stereo signal.
     mixxx::SampleBuffer m_tempReadBuffer;
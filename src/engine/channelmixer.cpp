@@ -60,15 +60,18 @@ void ChannelMixer::applyEffectsInPlaceAndMixChannels(
         const ChannelHandle& outputHandle,
         unsigned int iBufferSize,
         unsigned int iSampleRate,
-        EngineEffectsManager* pEngineEffectsManager) {
+        EngineEffectsManager* pEngineEffectsManager,
+        EngineRealtimeWorkerPool* pWorkerPool) {
     // Signal flow overview:
     // 1. Calculate gains for each channel
     // 2. Pass each channel's calculated gain and input buffer to pEngineEffectsManager, which then:
     //    A) Applies the calculated gain to the channel buffer, modifying the original input buffer
     //    B) Applies effects to the buffer, modifying the original input buffer
+    //    Channels are independent of each other until they are mixed, so
+    //    this may happen concurrently.
     // 4. Mix the channel buffers together to make pOutput, overwriting the pOutput buffer from the last engine callback
     ScopedTimer t("EngineMaster::applyEffectsInPlaceAndMixChannels");
-    SampleUtil::clear(pOutput, iBufferSize);
+    EngineEffectsManager::InPlaceChannels channels;
     for (auto* pChannelInfo : activeChannels) {
         EngineMaster::GainCache& gainCache = (*channelGainCache)[pChannelInfo->m_index];
         CSAMPLE_GAIN oldGain = gainCache.m_gain;
@@ -83,15 +86,23 @@ void ChannelMixer::applyEffectsInPlaceAndMixChannels(
             newGain = gainCalculator.getGain(pChannelInfo);
         }
         gainCache.m_gain = newGain;
-        pEngineEffectsManager->processPostFaderInPlace(pChannelInfo->m_handle,
-                outputHandle,
+        channels.append(EngineEffectsManager::InPlaceChannel{
+                pChannelInfo->m_handle,
                 pChannelInfo->m_pBuffer,
-                iBufferSize,
-                iSampleRate,
-                pChannelInfo->m_features,
+                &pChannelInfo->m_features,
                 oldGain,
                 newGain,
-                fadeout);
+                fadeout});
+    }
+    pEngineEffectsManager->processPostFaderInPlace(outputHandle,
+            channels,
+            iBufferSize,
+            iSampleRate,
+            pWorkerPool);
+    // Mix in the original order to get the same result regardless of
+    // whether the channels have been processed concurrently
+    SampleUtil::clear(pOutput, iBufferSize);
+    for (auto* pChannelInfo : activeChannels) {
         SampleUtil::add(pOutput, pChannelInfo->m_pBuffer, iBufferSize);
     }
 }
@@ -2,13 +2,18 @@
 
 #include "engine/engine.h"
 #include "util/defs.h"
+#include "util/performancetimer.h"
 #include "util/sample.h"
+#include "util/timer.h"
 
 namespace {
 
 // Used during initialization where the SoundSevice is not set up
 constexpr auto kInitalSampleRate = mixxx::audio::SampleRate(96000);
 
+// Weight of the latest callback in the smoothed processing load
+constexpr float kProcessingLoadSmoothingFactor = 0.1f;
+
 } // namespace
 
 EngineEffect::EngineEffect(EffectManifestPointer pManifest,
@@ -18,6 +23,9 @@ EngineEffect::EngineEffect(EffectManifestPointer pManifest,
         const QSet<ChannelHandleAndGroup>& registeredOutputChannels)
         : m_pManifest(pManifest),
           m_pProcessor(pBackendManager->createProcessor(pManifest)),
+          m_callbackProcessingNanos(0),
+          m_processingLoad(0),
+          m_bypassed(false),
           m_parameters(pManifest->parameters().size()) {
     const QList<EffectManifestParameterPointer>& parameters = m_pManifest->parameters();
     for (int i = 0; i < parameters.size(); ++i) {
@@ -33,6 +41,9 @@ EngineEffect::EngineEffect(EffectManifestPointer pManifest,
             outputChannelMap.insert(outputChannel.handle(), EffectEnableState::Disabled);
         }
         m_effectEnableStateForChannelMatrix.insert(inputChannel.handle(), outputChannelMap);
+        m_processingTimeStatKeys.insert(inputChannel.handle(),
+                QStringLiteral("EngineEffect %1 %2")
+                        .arg(pManifest->name(), inputChannel.name()));
     }
 
     m_pProcessor->loadEngineEffectParameters(m_parametersById);
@@ -76,6 +87,8 @@ bool EngineEffect::processEffectsRequest(EffectsRequest& message,
             qDebug() << debugString() << "SET_EFFECT_PARAMETERS"
                      << "enabled" << message.SetEffectParameters.enabled;
         }
+        // The enable switch overrides the budget guard
+        m_bypassed.store(false, std::memory_order_relaxed);
 
         for (auto& outputMap : m_effectEnableStateForChannelMatrix) {
             for (auto& enableState : outputMap) {
@@ -181,6 +194,8 @@ bool EngineEffect::process(const ChannelHandle& inputHandle,
                 mixxx::audio::SampleRate(sampleRate),
                 numSamples / mixxx::kEngineChannelCount);
 
+        PerformanceTimer timer;
+        timer.start();
         m_pProcessor->process(inputHandle,
                 outputHandle,
                 pInput,
@@ -188,6 +203,14 @@ bool EngineEffect::process(const ChannelHandle& inputHandle,
                 engineParameters,
                 effectiveEffectEnableState,
                 groupFeatures);
+        const qint64 processingNanos = timer.elapsed().toIntegerNanos();
+        m_callbackProcessingNanos += processingNanos;
+        if (static_cast<int>(inputHandle) < m_processingTimeStatKeys.size()) {
+            Stat::track(m_processingTimeStatKeys.at(inputHandle),
+                    Stat::DURATION_NANOSEC,
+                    kDefaultComputeFlags,
+                    static_cast<double>(processingNanos));
+        }
 
         processingOccured = true;
 
@@ -222,3 +245,28 @@ bool EngineEffect::process(const ChannelHandle& inputHandle,
 
     return processingOccured;
 }
+
+void EngineEffect::finishCallback(mixxx::Duration callbackPeriod) {
+    float load = 0;
+    if (callbackPeriod > mixxx::Duration::empty()) {
+        load = static_cast<float>(m_callbackProcessingNanos / callbackPeriod.toDoubleNanos());
+    }
+    m_callbackProcessingNanos = 0;
+    const float oldLoad = m_processingLoad.load(std::memory_order_relaxed);
+    m_processingLoad.store(oldLoad + kProcessingLoadSmoothingFactor * (load - oldLoad),
+            std::memory_order_relaxed);
+}
+
+void EngineEffect::bypass() {
+    if (kEffectDebugOutput) {
+        qDebug() << debugString() << "bypassed";
+    }
+    for (auto& outputMap : m_effectEnableStateForChannelMatrix) {
+        for (auto& enableState : outputMap) {
+            if (enableState != EffectEnableState::Disabled) {
+                enableState = EffectEnableState::Disabling;
+            }
+        }
+    }
+    m_bypassed.store(true, std::memory_order_relaxed);
+}
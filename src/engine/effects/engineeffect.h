@@ -6,6 +6,7 @@
 #include <QString>
 #include <QVector>
 #include <QtDebug>
+#include <atomic>
 
 #include "effects/backends/effectmanifest.h"
 #include "effects/backends/effectprocessor.h"
@@ -14,6 +15,7 @@
 #include "engine/effects/engineeffectparameter.h"
 #include "engine/effects/groupfeaturestate.h"
 #include "engine/effects/message.h"
+#include "util/duration.h"
 #include "util/memory.h"
 #include "util/types.h"
 
@@ -62,6 +64,34 @@ class EngineEffect final : public EffectsRequestHandler {
         return m_pProcessor->getGroupDelayFrames();
     }
 
+    /// Called in audio thread at the end of each engine callback
+    /// Updates processingLoad() with the time that has been spent in the
+    /// EffectProcessor during the callback.
+    void finishCallback(mixxx::Duration callbackPeriod);
+
+    /// Called in audio thread
+    /// Fades out the effect on all channels like switching it off, without
+    /// changing the state of the enable switch of the EffectSlot. The effect
+    /// stays bypassed until the EffectSlot enables it again.
+    void bypass();
+
+    /// Equalizers are part of the mix and must never be bypassed.
+    bool isEssential() const {
+        return m_pManifest->isMixingEQ() || m_pManifest->isMasterEQ();
+    }
+
+    /// Thread-safe
+    bool isBypassed() const {
+        return m_bypassed.load(std::memory_order_relaxed);
+    }
+
+    /// Thread-safe
+    /// The smoothed fraction of the engine callback period that is spent
+    /// in the EffectProcessor, summed up over all channels.
+    double processingLoad() const {
+        return m_processingLoad.load(std::memory_order_relaxed);
+    }
+
   private:
     QString debugString() const {
         return QString("EngineEffect(%1)").arg(m_pManifest->name());
@@ -71,6 +101,13 @@ class EngineEffect final : public EffectsRequestHandler {
     std::unique_ptr<EffectProcessor> m_pProcessor;
     ChannelHandleMap<ChannelHandleMap<EffectEnableState>> m_effectEnableStateForChannelMatrix;
     bool m_effectRampsFromDry;
+    // StatsManager keys for the processing time per input channel
+    ChannelHandleMap<QString> m_processingTimeStatKeys;
+    // Only accessed by the audio thread. Channels that are processed by
+    // the same EngineEffect are never processed concurrently.
+    qint64 m_callbackProcessingNanos;
+    std::atomic<float> m_processingLoad;
+    std::atomic<bool> m_bypassed;
     // Must not be modified after construction.
     QVector<EngineEffectParameterPointer> m_parameters;
     QMap<QString, EngineEffectParameterPointer> m_parametersById;
@@ -171,6 +171,19 @@ bool EngineEffectChain::disableForInputChannel(ChannelHandle inputHandle) {
     return true;
 }
 
+bool EngineEffectChain::isActiveForChannel(const ChannelHandle& inputHandle,
+        const ChannelHandle& outputHandle) const {
+    if (static_cast<int>(inputHandle) >= m_chainStatusForChannelMatrix.size()) {
+        // process() would need to insert a ChannelStatus
+        return true;
+    }
+    const auto& outputMap = m_chainStatusForChannelMatrix.at(inputHandle);
+    if (static_cast<int>(outputHandle) >= outputMap.size()) {
+        return true;
+    }
+    return outputMap.at(outputHandle).enableState != EffectEnableState::Disabled;
+}
+
 bool EngineEffectChain::process(const ChannelHandle& inputHandle,
         const ChannelHandle& outputHandle,
         CSAMPLE* pIn,
@@ -46,6 +46,22 @@ class EngineEffectChain final : public EffectsRequestHandler {
             const GroupFeatureState& groupFeatures,
             bool fadeout);
 
+    /// called from audio thread
+    /// Returns true if process() will invoke the effects of this chain or
+    /// change the state of the chain shared by all channels. A channel that
+    /// is not routed to the chain only accesses its own ChannelStatus.
+    bool isActiveForChannel(const ChannelHandle& inputHandle,
+            const ChannelHandle& outputHandle) const;
+
+    /// called from audio thread
+    /// The intermediate enabling/disabling state of the chain is consumed by
+    /// the first channel that is processed in a callback, regardless of its
+    /// routing.
+    bool isEnableStateChanging() const {
+        return m_enableState == EffectEnableState::Enabling ||
+                m_enableState == EffectEnableState::Disabling;
+    }
+
   private:
     struct ChannelStatus {
         ChannelStatus()
@@ -1,14 +1,76 @@
 #include "engine/effects/engineeffectsmanager.h"
 
+#include <algorithm>
+
 #include "engine/effects/engineeffect.h"
 #include "engine/effects/engineeffectchain.h"
+#include "engine/enginerealtimeworkerpool.h"
 #include "util/defs.h"
 #include "util/sample.h"
 
+namespace {
+
+// The budget guard intervenes if the engine has used more than this
+// fraction of the callback period in multiple consecutive callbacks. The
+// remaining time is needed by the sound device and for scheduling jitter.
+constexpr double kBudgetGuardMaxCallbackLoad = 0.8;
+constexpr int kBudgetGuardMaxOverBudgetCallbacks = 2;
+
+} // anonymous namespace
+
+// Processes the channels of one group per task, see groupChannelsByChains().
+class EngineEffectsManager::InPlaceChannelGroupsJob : public EngineRealtimeWorkerPool::Job {
+  public:
+    explicit InPlaceChannelGroupsJob(EngineEffectsManager* pEngineEffectsManager)
+            : m_pEngineEffectsManager(pEngineEffectsManager),
+              m_pOutputHandle(nullptr),
+              m_pChannels(nullptr),
+              m_numSamples(0),
+              m_sampleRate(0) {
+    }
+
+    void prepare(const ChannelHandle* pOutputHandle,
+            const InPlaceChannels* pChannels,
+            unsigned int numSamples,
+            unsigned int sampleRate) {
+        m_pOutputHandle = pOutputHandle;
+        m_pChannels = pChannels;
+        m_numSamples = numSamples;
+        m_sampleRate = sampleRate;
+    }
+
+    void processTask(int taskIndex) override {
+        for (int i = 0; i < m_pChannels->size(); ++i) {
+            if (m_pEngineEffectsManager->m_channelGroups[i] != taskIndex) {
+                continue;
+            }
+            const InPlaceChannel& channel = m_pChannels->at(i);
+            m_pEngineEffectsManager->processPostFaderInPlace(channel.inputHandle,
+                    *m_pOutputHandle,
+                    channel.pInOut,
+                    m_numSamples,
+                    m_sampleRate,
+                    *channel.pGroupFeatures,
+                    channel.oldGain,
+                    channel.newGain,
+                    channel.fadeout);
+        }
+    }
+
+  private:
+    EngineEffectsManager* const m_pEngineEffectsManager;
+    const ChannelHandle* m_pOutputHandle;
+    const InPlaceChannels* m_pChannels;
+    unsigned int m_numSamples;
+    unsigned int m_sampleRate;
+};
+
 EngineEffectsManager::EngineEffectsManager(EffectsResponsePipe* pResponsePipe)
         : m_pResponsePipe(pResponsePipe),
           m_buffer1(MAX_BUFFER_LEN),
-          m_buffer2(MAX_BUFFER_LEN) {
+          m_buffer2(MAX_BUFFER_LEN),
+          m_overBudgetCallbacks(0),
+          m_pInPlaceChannelGroupsJob(std::make_unique<InPlaceChannelGroupsJob>(this)) {
     // Try to prevent memory allocation.
     m_effects.reserve(256);
 }
@@ -94,6 +156,49 @@ void EngineEffectsManager::onCallbackStart() {
     }
 }
 
+bool EngineEffectsManager::onCallbackEnd(mixxx::Duration callbackDuration,
+        mixxx::Duration callbackPeriod,
+        bool budgetGuardEnabled) {
+    for (EngineEffect* pEffect : std::as_const(m_effects)) {
+        pEffect->finishCallback(callbackPeriod);
+    }
+
+    if (!budgetGuardEnabled ||
+            callbackDuration.toDoubleNanos() <=
+                    callbackPeriod.toDoubleNanos() * kBudgetGuardMaxCallbackLoad) {
+        m_overBudgetCallbacks = 0;
+        return false;
+    }
+    if (++m_overBudgetCallbacks < kBudgetGuardMaxOverBudgetCallbacks) {
+        return false;
+    }
+    m_overBudgetCallbacks = 0;
+    // Logging is not allowed in the audio thread. The EffectSlot
+    // publishes the bypass and logs it when polling the EngineEffect.
+    EngineEffect* pEffect = findEffectToBypass();
+    if (!pEffect) {
+        return false;
+    }
+    pEffect->bypass();
+    return true;
+}
+
+EngineEffect* EngineEffectsManager::findEffectToBypass() const {
+    EngineEffect* pMostExpensiveEffect = nullptr;
+    double maxProcessingLoad = 0;
+    for (EngineEffect* pEffect : m_effects) {
+        if (pEffect->isEssential() || pEffect->isBypassed()) {
+            continue;
+        }
+        const double processingLoad = pEffect->processingLoad();
+        if (processingLoad > maxProcessingLoad) {
+            maxProcessingLoad = processingLoad;
+            pMostExpensiveEffect = pEffect;
+        }
+    }
+    return pMostExpensiveEffect;
+}
+
 void EngineEffectsManager::processPreFaderInPlace(const ChannelHandle& inputHandle,
         const ChannelHandle& outputHandle,
         CSAMPLE* pInOut,
@@ -135,6 +240,101 @@ void EngineEffectsManager::processPostFaderInPlace(
             fadeout);
 }
 
+void EngineEffectsManager::processPostFaderInPlace(
+        const ChannelHandle& outputHandle,
+        const InPlaceChannels& channels,
+        unsigned int numSamples,
+        unsigned int sampleRate,
+        EngineRealtimeWorkerPool* pWorkerPool) {
+    bool concurrent = pWorkerPool && channels.size() > 1;
+    if (concurrent) {
+        const QList<EngineEffectChain*>& chains =
+                m_chainsByStage.value(SignalProcessingStage::Postfader);
+        for (const EngineEffectChain* pChain : chains) {
+            if (pChain && pChain->isEnableStateChanging()) {
+                // The order of the channels determines which one receives
+                // the intermediate state
+                concurrent = false;
+                break;
+            }
+        }
+    }
+    if (!concurrent) {
+        for (const InPlaceChannel& channel : channels) {
+            processPostFaderInPlace(channel.inputHandle,
+                    outputHandle,
+                    channel.pInOut,
+                    numSamples,
+                    sampleRate,
+                    *channel.pGroupFeatures,
+                    channel.oldGain,
+                    channel.newGain,
+                    channel.fadeout);
+        }
+        return;
+    }
+
+    const int numGroups = groupChannelsByChains(
+            SignalProcessingStage::Postfader, outputHandle, channels);
+    m_pInPlaceChannelGroupsJob->prepare(&outputHandle, &channels, numSamples, sampleRate);
+    pWorkerPool->run(m_pInPlaceChannelGroupsJob.get(), numGroups);
+}
+
+int EngineEffectsManager::groupChannelsByChains(
+        const SignalProcessingStage stage,
+        const ChannelHandle& outputHandle,
+        const InPlaceChannels& channels) {
+    const QList<EngineEffectChain*>& chains = m_chainsByStage.value(stage);
+    const int numChannels = channels.size();
+
+    // Merge the channels that share a chain into disjoint sets, using the
+    // lowest index as the representative of each set.
+    m_channelGroups.resize(numChannels);
+    for (int i = 0; i < numChannels; ++i) {
+        m_channelGroups[i] = i;
+    }
+    const auto findRepresentative = [this](int i) {
+        while (m_channelGroups[i] != i) {
+            i = m_channelGroups[i];
+        }
+        return i;
+    };
+    for (const EngineEffectChain* pChain : chains) {
+        if (!pChain) {
+            continue;
+        }
+        int representative = -1;
+        for (int i = 0; i < numChannels; ++i) {
+            if (!pChain->isActiveForChannel(channels[i].inputHandle, outputHandle)) {
+                continue;
+            }
+            const int channelRepresentative = findRepresentative(i);
+            if (representative < 0) {
+                representative = channelRepresentative;
+            } else if (channelRepresentative != representative) {
+                m_channelGroups[std::max(representative, channelRepresentative)] =
+                        std::min(representative, channelRepresentative);
+                representative = std::min(representative, channelRepresentative);
+            }
+        }
+    }
+
+    // Number the groups in the order of their first channel
+    m_groupIndices.resize(numChannels);
+    for (int i = 0; i < numChannels; ++i) {
+        m_groupIndices[i] = findRepresentative(i);
+    }
+    int numGroups = 0;
+    for (int i = 0; i < numChannels; ++i) {
+        const int representative = m_groupIndices[i];
+        // The representative precedes all other channels of the group
+        m_channelGroups[i] = representative == i
+                ? numGroups++
+                : m_channelGroups[representative];
+    }
+    return numGroups;
+}
+
 void EngineEffectsManager::processPostFaderAndMix(
         const ChannelHandle& inputHandle,
         const ChannelHandle& outputHandle,
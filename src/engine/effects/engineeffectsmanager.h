@@ -1,16 +1,20 @@
 #pragma once
 
 #include <QScopedPointer>
+#include <QVarLengthArray>
+#include <memory>
 
 #include "engine/channelhandle.h"
 #include "engine/effects/groupfeaturestate.h"
 #include "engine/effects/message.h"
+#include "util/duration.h"
 #include "util/fifo.h"
 #include "util/samplebuffer.h"
 #include "util/types.h"
 
 class EngineEffectChain;
 class EngineEffect;
+class EngineRealtimeWorkerPool;
 
 /// EngineEffectsManager is the entry point for processing effects in the audio
 /// thread. It also passes EffectsRequests from EffectsMessenger down to the
@@ -22,11 +26,32 @@ class EngineEffect;
 ///                                      PFL switch --> QuickEffectChains & StandardEffectChains --> mix channels into headphone mix --> headphone effect processing
 class EngineEffectsManager final : public EffectsRequestHandler {
   public:
+    /// The arguments of processPostFaderInPlace() for a single input channel
+    struct InPlaceChannel {
+        ChannelHandle inputHandle;
+        CSAMPLE* pInOut;
+        const GroupFeatureState* pGroupFeatures;
+        CSAMPLE_GAIN oldGain;
+        CSAMPLE_GAIN newGain;
+        bool fadeout;
+    };
+    static constexpr int kPreallocatedInPlaceChannels = 64;
+    typedef QVarLengthArray<InPlaceChannel, kPreallocatedInPlaceChannels> InPlaceChannels;
+
     EngineEffectsManager(EffectsResponsePipe* pResponsePipe);
     ~EngineEffectsManager();
 
     void onCallbackStart();
 
+    /// Accounts the processing time of the effects to the finished callback.
+    /// If the budget guard is enabled and the callback has used too much of
+    /// its period, the most expensive effect that is not essential for the mix
+    /// is bypassed to prevent buffer underruns. Returns true if an effect
+    /// has been bypassed.
+    bool onCallbackEnd(mixxx::Duration callbackDuration,
+            mixxx::Duration callbackPeriod,
+            bool budgetGuardEnabled);
+
     /// Process the prefader EngineEffectChains on the pInOut buffer, modifying
     /// the contents of the input buffer.
     void processPreFaderInPlace(
@@ -49,6 +74,22 @@ class EngineEffectsManager final : public EffectsRequestHandler {
             CSAMPLE_GAIN newGain = CSAMPLE_GAIN_ONE,
             bool fadeout = false);
 
+    /// Process the postfader EngineEffectChains of multiple input channels in
+    /// place, with the same result as calling processPostFaderInPlace() for
+    /// each of them in order.
+    ///
+    /// Channels are grouped by the EngineEffectChains they are routed to.
+    /// Groups that do not share a chain are processed concurrently on
+    /// pWorkerPool, the channels of a group are processed in order. All
+    /// channels are processed on the calling thread if pWorkerPool is nullptr
+    /// or while the enable switch of a chain is toggled.
+    void processPostFaderInPlace(
+            const ChannelHandle& outputHandle,
+            const InPlaceChannels& channels,
+            unsigned int numSamples,
+            unsigned int sampleRate,
+            EngineRealtimeWorkerPool* pWorkerPool);
+
     /// Process the postfader EngineEffectChains, leaving the pIn buffer unmodified
     /// and mixing the output into the pOut buffer. Using EngineEffectsManager's
     /// temporary buffers for this avoids the need for ChannelMixer to allocate a
@@ -71,10 +112,21 @@ class EngineEffectsManager final : public EffectsRequestHandler {
             EffectsResponsePipe* pResponsePipe) override;
 
   private:
+    class InPlaceChannelGroupsJob;
+
     QString debugString() const {
         return QString("EngineEffectsManager");
     }
 
+    /// Assigns each channel to a group of channels that share an
+    /// EngineEffectChain of the given stage and returns the number of groups.
+    int groupChannelsByChains(const SignalProcessingStage stage,
+            const ChannelHandle& outputHandle,
+            const InPlaceChannels& channels);
+
+    /// Returns the most expensive effect that may be bypassed or nullptr
+    EngineEffect* findEffectToBypass() const;
+
     bool addEffectChain(EngineEffectChain* pChain, SignalProcessingStage stage);
     bool removeEffectChain(EngineEffectChain* pChain, SignalProcessingStage stage);
 
@@ -103,4 +155,13 @@ class EngineEffectsManager final : public EffectsRequestHandler {
 
     mixxx::SampleBuffer m_buffer1;
     mixxx::SampleBuffer m_buffer2;
+
+    // Number of consecutive callbacks that exceeded the budget
+    int m_overBudgetCallbacks;
+
+    // The group of each channel for processPostFaderInPlace(). Preallocated
+    // to avoid allocations in the audio thread.
+    QVarLengthArray<int, kPreallocatedInPlaceChannels> m_channelGroups;
+    QVarLengthArray<int, kPreallocatedInPlaceChannels> m_groupIndices;
+    std::unique_ptr<InPlaceChannelGroupsJob> m_pInPlaceChannelGroupsJob;
 };
@@ -100,7 +100,8 @@ EngineBuffer::EngineBuffer(const QString& group,
           m_bPlayAfterLoading(false),
           m_pCrossfadeBuffer(SampleUtil::alloc(MAX_BUFFER_LEN)),
           m_bCrossfadeReady(false),
-          m_iLastBufferSize(0) {
+          m_iLastBufferSize(0),
+          m_bProcessingConcurrently(false) {
     // This should be a static assertion, but isValid() is not constexpr.
     DEBUG_ASSERT(kInitialPlayPosition.isValid());
 
@@ -1211,7 +1212,23 @@ void EngineBuffer::processSlip(int iBufferSize) {
     }
 }
 
+bool EngineBuffer::prepareConcurrentProcessing() {
+    m_bProcessingConcurrently =
+            m_pSyncControl->getSyncMode() == SyncMode::None &&
+            m_iEnableSyncQueued.loadAcquire() == SYNC_REQUEST_NONE &&
+            m_iSyncModeQueued.loadAcquire() == static_cast<int>(SyncMode::Invalid) &&
+            m_iSeekPhaseQueued.loadAcquire() == 0 &&
+            m_pChannelToCloneFrom.loadAcquire() == nullptr &&
+            m_queuedSeek.getValue().seekType == SEEK_NONE;
+    return m_bProcessingConcurrently;
+}
+
 void EngineBuffer::processSyncRequests() {
+    if (m_bProcessingConcurrently) {
+        // EngineSync must only be accessed by one deck at a time. The
+        // requests are processed in the next callback.
+        return;
+    }
     SyncRequestQueued enable_request =
             static_cast<SyncRequestQueued>(
                     m_iEnableSyncQueued.fetchAndStoreRelease(SYNC_REQUEST_NONE));
@@ -1241,7 +1258,11 @@ void EngineBuffer::processSyncRequests() {
 void EngineBuffer::processSeek(bool paused) {
     m_previousBufferSeek = false;
     // Check if we are cloning another channel before doing any seeking.
-    EngineChannel* pChannel = m_pChannelToCloneFrom.fetchAndStoreRelaxed(nullptr);
+    // Other decks must not be accessed while processing concurrently, so
+    // requests that have been queued meanwhile are deferred.
+    EngineChannel* pChannel = m_bProcessingConcurrently
+            ? nullptr
+            : m_pChannelToCloneFrom.fetchAndStoreRelaxed(nullptr);
     if (pChannel) {
         seekCloneBuffer(pChannel->getEngineBuffer());
     }
@@ -1252,7 +1273,7 @@ void EngineBuffer::processSeek(bool paused) {
     mixxx::audio::FramePos position = queuedSeek.position;
 
     // Add SEEK_PHASE bit, if any
-    if (m_iSeekPhaseQueued.fetchAndStoreRelease(0)) {
+    if (!m_bProcessingConcurrently && m_iSeekPhaseQueued.fetchAndStoreRelease(0)) {
         seekType |= SEEK_PHASE;
     }
 
@@ -1284,6 +1305,12 @@ void EngineBuffer::processSeek(bool paused) {
         return;
     }
 
+    if (m_bProcessingConcurrently && !paused && (seekType & SEEK_PHASE)) {
+        // Seeking in phase reads the position of the sync target. Keep the
+        // seek queued for the next callback.
+        return;
+    }
+
     // Don't allow the playposition to go past the end.
     position = std::min<mixxx::audio::FramePos>(position, m_trackEndPositionOld);
 
@@ -1314,6 +1341,7 @@ void EngineBuffer::processSeek(bool paused) {
 }
 
 void EngineBuffer::postProcess(const int iBufferSize) {
+    m_bProcessingConcurrently = false;
     // The order of events here is very delicate.  It's necessary to update
     // some values before others, because the later updates may require
     // values from the first update. Do not make calls here that could affect
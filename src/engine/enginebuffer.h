@@ -123,6 +123,12 @@ class EngineBuffer : public EngineObject {
 
     // The process methods all run in the audio callback.
     void process(CSAMPLE* pOut, const int iBufferSize) override;
+    /// Returns true if the next process() call may run concurrently to the
+    /// processing of other decks. This is not the case if the deck is synced
+    /// or has pending sync, clone or seek requests, which access EngineSync
+    /// or other decks. Requests that are queued after this call are deferred
+    /// to the next callback. Must be called on the engine thread.
+    bool prepareConcurrentProcessing();
     void processSlip(int iBufferSize);
     void postProcess(const int iBufferSize);
 
@@ -443,6 +449,9 @@ class EngineBuffer : public EngineObject {
     bool m_bCrossfadeReady;
     int m_iLastBufferSize;
 
+    // Set by prepareConcurrentProcessing() until postProcess()
+    bool m_bProcessingConcurrently;
+
     QSharedPointer<VisualPlayPosition> m_visualPlayPos;
 };
 
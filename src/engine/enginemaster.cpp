@@ -3,6 +3,7 @@
 #include <QList>
 #include <QPair>
 #include <QtDebug>
+#include <utility>
 
 #include "control/controlaudiotaperpot.h"
 #include "control/controlpotmeter.h"
@@ -14,6 +15,7 @@
 #include "engine/effects/engineeffectsmanager.h"
 #include "engine/enginebuffer.h"
 #include "engine/enginedelay.h"
+#include "engine/enginerealtimeworkerpool.h"
 #include "engine/enginetalkoverducking.h"
 #include "engine/enginevumeter.h"
 #include "engine/engineworkerscheduler.h"
@@ -24,10 +26,61 @@
 #include "moc_enginemaster.cpp"
 #include "preferences/usersettings.h"
 #include "util/defs.h"
+#include "util/performancetimer.h"
 #include "util/sample.h"
 #include "util/timer.h"
 #include "util/trace.h"
 
+namespace {
+
+// Adds the lifetime of the object to the given duration unless it is null.
+class ScopedStageTimer {
+  public:
+    explicit ScopedStageTimer(mixxx::Duration* pDuration)
+            : m_pDuration(pDuration) {
+        if (m_pDuration) {
+            m_timer.start();
+        }
+    }
+    ~ScopedStageTimer() {
+        if (m_pDuration) {
+            *m_pDuration += m_timer.elapsed();
+        }
+    }
+
+  private:
+    mixxx::Duration* const m_pDuration;
+    PerformanceTimer m_timer;
+};
+
+} // anonymous namespace
+
+// Processes a contiguous range of m_activeChannels, one channel per task.
+class EngineMaster::ChannelProcessingJob : public EngineRealtimeWorkerPool::Job {
+  public:
+    explicit ChannelProcessingJob(EngineMaster* pEngineMaster)
+            : m_pEngineMaster(pEngineMaster),
+              m_firstChannelIndex(0),
+              m_iBufferSize(0) {
+    }
+
+    void prepare(int firstChannelIndex, int iBufferSize) {
+        m_firstChannelIndex = firstChannelIndex;
+        m_iBufferSize = iBufferSize;
+    }
+
+    void processTask(int taskIndex) override {
+        m_pEngineMaster->processChannel(
+                m_pEngineMaster->m_activeChannels[m_firstChannelIndex + taskIndex],
+                m_iBufferSize);
+    }
+
+  private:
+    EngineMaster* const m_pEngineMaster;
+    int m_firstChannelIndex;
+    int m_iBufferSize;
+};
+
 EngineMaster::EngineMaster(
         UserSettingsPointer pConfig,
         const QString& group,
@@ -48,7 +101,8 @@ EngineMaster::EngineMaster(
           m_busTalkoverHandle(registerChannelGroup("[BusTalkover]")),
           m_busCrossfaderLeftHandle(registerChannelGroup("[BusLeft]")),
           m_busCrossfaderCenterHandle(registerChannelGroup("[BusCenter]")),
-          m_busCrossfaderRightHandle(registerChannelGroup("[BusRight]")) {
+          m_busCrossfaderRightHandle(registerChannelGroup("[BusRight]")),
+          m_bStageTimingEnabled(false) {
     pEffectsManager->registerInputChannel(m_masterHandle);
     pEffectsManager->registerInputChannel(m_headphoneHandle);
     pEffectsManager->registerOutputChannel(m_masterHandle);
@@ -65,6 +119,9 @@ EngineMaster::EngineMaster(
     m_bExternalRecordBroadcastInputConnected = false;
     m_pWorkerScheduler = new EngineWorkerScheduler(this);
     m_pWorkerScheduler->start(QThread::HighPriority);
+    m_pRealtimeWorkerPool = std::make_unique<EngineRealtimeWorkerPool>(
+            EngineRealtimeWorkerPool::defaultNumWorkers());
+    m_pChannelProcessingJob = std::make_unique<ChannelProcessingJob>(this);
 
     // Master sample rate
     m_pMasterSampleRate = new ControlObject(ConfigKey(group, "samplerate"), true, true);
@@ -176,6 +233,20 @@ EngineMaster::EngineMaster(
     m_pKeylockEngine->set(pConfig->getValue(ConfigKey(group, "keylock_engine"),
             static_cast<double>(EngineBuffer::defaultKeylockEngine())));
 
+    // Process independent channels concurrently on the real-time worker
+    // pool. Disabled by default.
+    m_pParallelProcessing = new ControlObject(ConfigKey(group, "parallel_processing"),
+            true, false, true);  // persist = true
+
+    // Bypass expensive effects if the engine is about to miss the deadline
+    // of the sound device. Disabled by default.
+    m_pEffectsBudgetGuard = new ControlObject(ConfigKey(group, "effects_budget_guard"),
+            true, false, true);  // persist = true
+    // Counts the effects that have been bypassed by the budget guard
+    m_pEffectsBudgetGuardBypassCount = new ControlObject(
+            ConfigKey(group, "effects_budget_guard_bypass_count"), true, true);
+    m_pEffectsBudgetGuardBypassCount->setReadOnly();
+
     // TODO: Make this read only and make EngineMaster decide whether
     // processing the master mix is necessary.
     m_pMasterEnabled = new ControlObject(ConfigKey(group, "enabled"),
@@ -195,6 +266,9 @@ EngineMaster::EngineMaster(
 EngineMaster::~EngineMaster() {
     //qDebug() << "in ~EngineMaster()";
     delete m_pKeylockEngine;
+    delete m_pParallelProcessing;
+    delete m_pEffectsBudgetGuard;
+    delete m_pEffectsBudgetGuardBypassCount;
     delete m_pCrossfader;
     delete m_pBalance;
     delete m_pHeadMix;
@@ -357,17 +431,35 @@ void EngineMaster::processChannels(int iBufferSize) {
     }
 
     // Now that the list is built and ordered, do the processing.
-    for (int i = activeChannelsStartIndex;
-             i < m_activeChannels.size(); ++i) {
-        ChannelInfo* pChannelInfo = m_activeChannels[i];
-        EngineChannel* pChannel = pChannelInfo->m_pChannel;
-        pChannel->process(pChannelInfo->m_pBuffer, iBufferSize);
-
-        // Collect metadata for effects
-        if (m_pEngineEffectsManager) {
-            GroupFeatureState features;
-            pChannel->collectFeatures(&features);
-            pChannelInfo->m_features = features;
+    if (m_pParallelProcessing->toBool() && m_pRealtimeWorkerPool->numWorkers() > 0) {
+        // The sync leader must be processed before all followers, which
+        // are independent of each other and can be processed concurrently.
+        int firstFollowerIndex = activeChannelsStartIndex;
+        if (activeChannelsStartIndex == 0) {
+            processChannel(m_activeChannels[0], iBufferSize);
+            firstFollowerIndex = 1;
+        }
+        // Synced decks and decks with pending sync, clone or seek requests
+        // access EngineSync or other decks. Process them one after another
+        // on this thread and move them in front of the concurrent ones,
+        // keeping their order.
+        int firstConcurrentIndex = firstFollowerIndex;
+        for (int i = firstFollowerIndex; i < m_activeChannels.size(); ++i) {
+            EngineBuffer* pBuffer = m_activeChannels[i]->m_pChannel->getEngineBuffer();
+            if (pBuffer && !pBuffer->prepareConcurrentProcessing()) {
+                processChannel(m_activeChannels[i], iBufferSize);
+                std::swap(m_activeChannels[i], m_activeChannels[firstConcurrentIndex]);
+                ++firstConcurrentIndex;
+            }
+        }
+        m_pChannelProcessingJob->prepare(firstConcurrentIndex, iBufferSize);
+        m_pRealtimeWorkerPool->run(m_pChannelProcessingJob.get(),
+                m_activeChannels.size() - firstConcurrentIndex);
+    } else {
+        for (int i = activeChannelsStartIndex;
+                i < m_activeChannels.size();
+                ++i) {
+            processChannel(m_activeChannels[i], iBufferSize);
         }
     }
 
@@ -388,6 +480,18 @@ void EngineMaster::processChannels(int iBufferSize) {
     }
 }
 
+void EngineMaster::processChannel(ChannelInfo* pChannelInfo, int iBufferSize) {
+    EngineChannel* pChannel = pChannelInfo->m_pChannel;
+    pChannel->process(pChannelInfo->m_pBuffer, iBufferSize);
+
+    // Collect metadata for effects
+    if (m_pEngineEffectsManager) {
+        GroupFeatureState features;
+        pChannel->collectFeatures(&features);
+        pChannelInfo->m_features = features;
+    }
+}
+
 void EngineMaster::process(const int iBufferSize) {
     static bool haveSetName = false;
     if (!haveSetName) {
@@ -395,10 +499,20 @@ void EngineMaster::process(const int iBufferSize) {
         haveSetName = true;
     }
     //Trace t("EngineMaster::process");
+    if (m_bStageTimingEnabled) {
+        m_stageTimes = StageTimes();
+    }
+    ScopedStageTimer totalTimer(stageTime(&StageTimes::total));
+    PerformanceTimer callbackTimer;
+    callbackTimer.start();
 
     bool masterEnabled = m_pMasterEnabled->toBool();
     bool boothEnabled = m_pBoothEnabled->toBool();
     bool headphoneEnabled = m_pHeadphoneEnabled->toBool();
+    // Post-fader effects of channels that are not routed to the same
+    // effect chain are processed concurrently as well
+    EngineRealtimeWorkerPool* pRealtimeWorkerPool =
+            m_pParallelProcessing->toBool() ? m_pRealtimeWorkerPool.get() : nullptr;
 
     m_sampleRate = mixxx::audio::SampleRate::fromDouble(m_pMasterSampleRate->get());
     m_iBufferSize = iBufferSize;
@@ -411,7 +525,10 @@ void EngineMaster::process(const int iBufferSize) {
     }
 
     // Prepare all channels for output
-    processChannels(m_iBufferSize);
+    {
+        ScopedStageTimer timer(stageTime(&StageTimes::channels));
+        processChannels(m_iBufferSize);
+    }
 
     // Compute headphone mix
     // Head phone left/right mix
@@ -432,18 +549,22 @@ void EngineMaster::process(const int iBufferSize) {
         // Process effects and mix PFL channels together for the headphones.
         // Effects will be reprocessed post-fader for the crossfader buses
         // and master mix, so the channel input buffers cannot be modified here.
-        ChannelMixer::applyEffectsAndMixChannels(
-                m_headphoneGain,
-                m_activeHeadphoneChannels,
-                &m_channelHeadphoneGainCache,
-                m_pHead,
-                m_headphoneHandle.handle(),
-                m_iBufferSize,
-                static_cast<int>(m_sampleRate.value()),
-                m_pEngineEffectsManager);
+        {
+            ScopedStageTimer timer(stageTime(&StageTimes::mixing));
+            ChannelMixer::applyEffectsAndMixChannels(
+                    m_headphoneGain,
+                    m_activeHeadphoneChannels,
+                    &m_channelHeadphoneGainCache,
+                    m_pHead,
+                    m_headphoneHandle.handle(),
+                    m_iBufferSize,
+                    static_cast<int>(m_sampleRate.value()),
+                    m_pEngineEffectsManager);
+        }
 
         // Process headphone channel effects
         if (m_pEngineEffectsManager) {
+            ScopedStageTimer timer(stageTime(&StageTimes::effects));
             GroupFeatureState headphoneFeatures;
             // If there is only one channel in the headphone mix, use its features
             // for effects processing. This allows for previewing how an effect will
@@ -466,20 +587,25 @@ void EngineMaster::process(const int iBufferSize) {
 
     // Mix all the talkover enabled channels together.
     // Effects processing is done in place to avoid unnecessary buffer copying.
-    ChannelMixer::applyEffectsInPlaceAndMixChannels(
-            m_talkoverGain,
-            m_activeTalkoverChannels,
-            &m_channelTalkoverGainCache,
-            m_pTalkover,
-            m_masterHandle.handle(),
-            m_iBufferSize,
-            static_cast<int>(m_sampleRate.value()),
-            m_pEngineEffectsManager);
+    {
+        ScopedStageTimer timer(stageTime(&StageTimes::mixing));
+        ChannelMixer::applyEffectsInPlaceAndMixChannels(
+                m_talkoverGain,
+                m_activeTalkoverChannels,
+                &m_channelTalkoverGainCache,
+                m_pTalkover,
+                m_masterHandle.handle(),
+                m_iBufferSize,
+                static_cast<int>(m_sampleRate.value()),
+                m_pEngineEffectsManager,
+                pRealtimeWorkerPool);
+    }
 
     // Process effects on all microphones mixed together
     // We have no metadata for mixed effect buses, so use an empty GroupFeatureState.
     GroupFeatureState busFeatures;
     if (m_pEngineEffectsManager) {
+        ScopedStageTimer timer(stageTime(&StageTimes::effects));
         m_pEngineEffectsManager->processPostFaderInPlace(
                 m_busTalkoverHandle.handle(),
                 m_masterHandle.handle(),
@@ -525,19 +651,24 @@ void EngineMaster::process(const int iBufferSize) {
             crossfaderRightGain,
             m_pTalkoverDucking->getGain(m_iBufferSize / 2));
 
-    for (int o = EngineChannel::LEFT; o <= EngineChannel::RIGHT; o++) {
-        ChannelMixer::applyEffectsInPlaceAndMixChannels(m_masterGain,
-                m_activeBusChannels[o],
-                &m_channelMasterGainCache, // no [o] because the old gain follows an orientation switch
-                m_pOutputBusBuffers[o],
-                m_masterHandle.handle(),
-                m_iBufferSize,
-                static_cast<int>(m_sampleRate.value()),
-                m_pEngineEffectsManager);
+    {
+        ScopedStageTimer timer(stageTime(&StageTimes::mixing));
+        for (int o = EngineChannel::LEFT; o <= EngineChannel::RIGHT; o++) {
+            ChannelMixer::applyEffectsInPlaceAndMixChannels(m_masterGain,
+                    m_activeBusChannels[o],
+                    &m_channelMasterGainCache, // no [o] because the old gain follows an orientation switch
+                    m_pOutputBusBuffers[o],
+                    m_masterHandle.handle(),
+                    m_iBufferSize,
+                    static_cast<int>(m_sampleRate.value()),
+                    m_pEngineEffectsManager,
+                    pRealtimeWorkerPool);
+        }
     }
 
     // Process crossfader orientation bus channel effects
     if (m_pEngineEffectsManager) {
+        ScopedStageTimer timer(stageTime(&StageTimes::effects));
         m_pEngineEffectsManager->processPostFaderInPlace(
                 m_busCrossfaderLeftHandle.handle(),
                 m_masterHandle.handle(),
@@ -724,12 +855,14 @@ void EngineMaster::process(const int iBufferSize) {
         // EngineSideChain::receiveBuffer has copied the input buffer to m_pSidechainMix
         // via before (called by SoundManager::pushInputBuffers())
         if (m_pEngineSideChain) {
+            ScopedStageTimer timer(stageTime(&StageTimes::sidechain));
             m_pEngineSideChain->writeSamples(m_pSidechainMix, iFrames);
         }
 
         // Process effects that apply to master hardware output only but not
         // record/broadcast signal
         if (m_pEngineEffectsManager) {
+            ScopedStageTimer timer(stageTime(&StageTimes::effects));
             GroupFeatureState masterFeatures;
             masterFeatures.has_gain = true;
             masterFeatures.gain = m_pMasterGain->get();
@@ -782,6 +915,14 @@ void EngineMaster::process(const int iBufferSize) {
         m_pBoothDelay->process(m_pBooth, m_iBufferSize);
     }
 
+    if (m_pEngineEffectsManager &&
+            m_pEngineEffectsManager->onCallbackEnd(callbackTimer.elapsed(),
+                    mixxx::Duration::fromSeconds(iFrames / m_sampleRate.toDouble()),
+                    m_pEffectsBudgetGuard->toBool())) {
+        m_pEffectsBudgetGuardBypassCount->forceSet(
+                m_pEffectsBudgetGuardBypassCount->get() + 1);
+    }
+
     // We're close to the end of the callback. Wake up the engine worker
     // scheduler so that it runs the workers.
     m_pWorkerScheduler->runWorkers();
@@ -790,6 +931,7 @@ void EngineMaster::process(const int iBufferSize) {
 void EngineMaster::applyMasterEffects() {
     // Apply master effects
     if (m_pEngineEffectsManager) {
+        ScopedStageTimer timer(stageTime(&StageTimes::effects));
         GroupFeatureState masterFeatures;
         masterFeatures.has_gain = true;
         masterFeatures.gain = m_pMasterGain->get();
@@ -2,6 +2,7 @@
 
 #include <QObject>
 #include <QVarLengthArray>
+#include <memory>
 
 #include "audio/types.h"
 #include "control/controlobject.h"
@@ -13,7 +14,9 @@
 #include "recording/recordingmanager.h"
 #include "soundio/soundmanager.h"
 #include "soundio/soundmanagerutil.h"
+#include "util/duration.h"
 
+class EngineRealtimeWorkerPool;
 class EngineWorkerScheduler;
 class EngineBuffer;
 class EngineChannel;
@@ -108,6 +111,29 @@ class EngineMaster : public QObject, public AudioSource {
 
     CSAMPLE_GAIN getMasterGain(int channelIndex) const;
 
+    /// Wall clock durations of the processing stages of the last callback.
+    /// Only measured while enabled with setStageTimingEnabled().
+    struct StageTimes {
+        // EngineChannel::process() of all active channels, including the
+        // pre-fader effects
+        mixxx::Duration channels;
+        // ChannelMixer, including the post-fader effects of the channels
+        mixxx::Duration mixing;
+        // Effects of the headphone, talkover, crossfader and master buses
+        mixxx::Duration effects;
+        // Passing the record/broadcast mix to EngineSideChain
+        mixxx::Duration sidechain;
+        // The whole callback
+        mixxx::Duration total;
+    };
+
+    void setStageTimingEnabled(bool enabled) {
+        m_bStageTimingEnabled = enabled;
+    }
+    const StageTimes& getStageTimes() const {
+        return m_stageTimes;
+    }
+
     struct ChannelInfo {
         ChannelInfo(int index)
                 : m_pChannel(NULL),
@@ -261,6 +287,19 @@ class EngineMaster : public QObject, public AudioSource {
     // m_activeTalkoverChannels with each channel that is active for the
     // respective output.
     void processChannels(int iBufferSize);
+    // Processes a single active channel and collects its features for
+    // effects. Called concurrently for independent channels if parallel
+    // processing is enabled. Synced decks are always processed on the
+    // engine thread, see EngineBuffer::prepareConcurrentProcessing().
+    void processChannel(ChannelInfo* pChannelInfo, int iBufferSize);
+
+    class ChannelProcessingJob;
+
+    // Returns the accumulator for the given stage or nullptr if stage timing
+    // is disabled.
+    mixxx::Duration* stageTime(mixxx::Duration StageTimes::*pStage) {
+        return m_bStageTimingEnabled ? &(m_stageTimes.*pStage) : nullptr;
+    }
 
     ChannelHandleFactoryPointer m_pChannelHandleFactory;
     void applyMasterEffects();
@@ -296,6 +335,8 @@ class EngineMaster : public QObject, public AudioSource {
     CSAMPLE* m_pSidechainMix;
 
     EngineWorkerScheduler* m_pWorkerScheduler;
+    std::unique_ptr<EngineRealtimeWorkerPool> m_pRealtimeWorkerPool;
+    std::unique_ptr<ChannelProcessingJob> m_pChannelProcessingJob;
     EngineSync* m_pEngineSync;
 
     ControlObject* m_pMasterGain;
@@ -326,6 +367,9 @@ class EngineMaster : public QObject, public AudioSource {
     ControlPushButton* m_pXFaderReverse;
     ControlPushButton* m_pHeadSplitEnabled;
     ControlObject* m_pKeylockEngine;
+    ControlObject* m_pParallelProcessing;
+    ControlObject* m_pEffectsBudgetGuard;
+    ControlObject* m_pEffectsBudgetGuardBypassCount;
 
     PflGainCalculator m_headphoneGain;
     TalkoverGainCalculator m_talkoverGain;
@@ -348,6 +392,9 @@ class EngineMaster : public QObject, public AudioSource {
     ControlObject* m_pMasterMonoMixdown;
     ControlObject* m_pMicMonitorMode;
 
+    bool m_bStageTimingEnabled;
+    StageTimes m_stageTimes;
+
     volatile bool m_bBusOutputConnected[3];
     bool m_bExternalRecordBroadcastInputConnected;
 };
@@ -0,0 +1,213 @@
+#include "engine/enginerealtimeworkerpool.h"
+
+#include <QtDebug>
+#include <algorithm>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#include <immintrin.h>
+#endif
+
+#ifdef __LINUX__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include "util/assert.h"
+#include "util/performancetimer.h"
+#include "util/timer.h"
+
+namespace {
+
+// The number of polling iterations a worker spends waiting for the next job
+// before going to sleep. With the pause instruction taking in the order of
+// 100 cycles on current CPUs this keeps the workers hot for a few hundred
+// microseconds, which covers the gap between two callbacks at small buffer
+// sizes without burning a core when the engine is idle.
+constexpr int kSpinIterations = 4096;
+
+constexpr int kMaxDefaultWorkers = 7;
+
+inline void cpuRelax() {
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+    _mm_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+    __asm__ __volatile__("yield");
+#endif
+}
+
+inline quint32 generationOf(quint64 counter) {
+    return static_cast<quint32>(counter >> 32);
+}
+
+inline int numTasksOf(quint64 counter) {
+    return static_cast<int>((counter >> 16) & EngineRealtimeWorkerPool::kMaxTasks);
+}
+
+inline int taskIndexOf(quint64 counter) {
+    return static_cast<int>(counter & EngineRealtimeWorkerPool::kMaxTasks);
+}
+
+} // anonymous namespace
+
+class EngineRealtimeWorkerPool::Worker : public QThread {
+  public:
+    Worker(EngineRealtimeWorkerPool* pPool, int index)
+            : m_pPool(pPool),
+              m_index(index),
+              m_statKey(QStringLiteral("EngineRealtimeWorkerPool worker %1 busy")
+                                .arg(index)) {
+        setObjectName(QStringLiteral("EngineWorker %1").arg(index));
+    }
+
+    const QString& statKey() const {
+        return m_statKey;
+    }
+
+  protected:
+    void run() override {
+#ifdef __LINUX__
+        // Pin each worker to its own core, leaving the first one to the
+        // engine thread, so that the caches stay warm between callbacks.
+        const int numCpus = QThread::idealThreadCount();
+        if (numCpus > 1) {
+            cpu_set_t cpuSet;
+            CPU_ZERO(&cpuSet);
+            CPU_SET((m_index + 1) % numCpus, &cpuSet);
+            if (pthread_setaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet) != 0) {
+                qWarning() << objectName() << "failed to set CPU affinity";
+            }
+        }
+#endif
+        m_pPool->workerLoop(this);
+    }
+
+  private:
+    EngineRealtimeWorkerPool* const m_pPool;
+    const int m_index;
+    const QString m_statKey;
+};
+
+EngineRealtimeWorkerPool::EngineRealtimeWorkerPool(int numWorkers)
+        : m_pJob(nullptr),
+          m_taskCounter(0),
+          m_pendingTasks(0),
+          m_wakeGeneration(0),
+          m_sleepingWorkers(0),
+          m_quit(false) {
+    m_workers.reserve(std::max(numWorkers, 0));
+    for (int i = 0; i < numWorkers; ++i) {
+        m_workers.push_back(std::make_unique<Worker>(this, i));
+        m_workers.back()->start(QThread::TimeCriticalPriority);
+    }
+}
+
+EngineRealtimeWorkerPool::~EngineRealtimeWorkerPool() {
+    m_quit.store(true, std::memory_order_release);
+    m_wakeGeneration.fetch_add(1);
+    m_wakeGeneration.notify_all();
+    for (const auto& pWorker : m_workers) {
+        pWorker->wait();
+    }
+}
+
+// static
+int EngineRealtimeWorkerPool::defaultNumWorkers() {
+    return std::clamp(QThread::idealThreadCount() - 2, 0, kMaxDefaultWorkers);
+}
+
+void EngineRealtimeWorkerPool::run(Job* pJob, int numTasks) {
+    VERIFY_OR_DEBUG_ASSERT(numTasks <= kMaxTasks) {
+        numTasks = kMaxTasks;
+    }
+    if (numTasks <= 0) {
+        return;
+    }
+    if (m_workers.empty() || numTasks == 1) {
+        // Nothing to share, avoid the handoff overhead
+        for (int i = 0; i < numTasks; ++i) {
+            pJob->processTask(i);
+        }
+        return;
+    }
+
+    // Publish the job. The release store of the task counter makes the job
+    // pointer and the pending count visible to every worker that claims a
+    // task of this generation.
+    m_pJob.store(pJob, std::memory_order_relaxed);
+    m_pendingTasks.store(numTasks, std::memory_order_relaxed);
+    const quint32 generation =
+            generationOf(m_taskCounter.load(std::memory_order_relaxed)) + 1;
+    m_taskCounter.store((static_cast<quint64>(generation) << 32) |
+                    (static_cast<quint64>(numTasks) << 16),
+            std::memory_order_release);
+
+    // Wake up the workers. The syscall is only issued if at least one of
+    // them has given up spinning.
+    m_wakeGeneration.store(generation);
+    if (m_sleepingWorkers.load() > 0) {
+        m_wakeGeneration.notify_all();
+    }
+
+    const int processed = processTasks(generation);
+    if (processed > 0) {
+        m_pendingTasks.fetch_sub(processed, std::memory_order_acq_rel);
+    }
+
+    // Join: the remaining tasks are already running on the workers
+    while (m_pendingTasks.load(std::memory_order_acquire) > 0) {
+        cpuRelax();
+    }
+}
+
+int EngineRealtimeWorkerPool::processTasks(quint32 generation) {
+    int processed = 0;
+    quint64 counter = m_taskCounter.load(std::memory_order_acquire);
+    while (generationOf(counter) == generation &&
+            taskIndexOf(counter) < numTasksOf(counter)) {
+        if (m_taskCounter.compare_exchange_weak(counter,
+                    counter + 1,
+                    std::memory_order_acq_rel,
+                    std::memory_order_acquire)) {
+            m_pJob.load(std::memory_order_relaxed)->processTask(taskIndexOf(counter));
+            ++processed;
+            ++counter;
+        }
+    }
+    return processed;
+}
+
+void EngineRealtimeWorkerPool::workerLoop(Worker* pWorker) {
+    quint32 seenGeneration = m_wakeGeneration.load();
+    PerformanceTimer timer;
+    while (true) {
+        quint32 generation = m_wakeGeneration.load(std::memory_order_acquire);
+        for (int i = 0; generation == seenGeneration && i < kSpinIterations; ++i) {
+            cpuRelax();
+            generation = m_wakeGeneration.load(std::memory_order_acquire);
+        }
+        if (generation == seenGeneration) {
+            m_sleepingWorkers.fetch_add(1);
+            m_wakeGeneration.wait(seenGeneration);
+            m_sleepingWorkers.fetch_sub(1);
+            generation = m_wakeGeneration.load();
+        }
+        if (m_quit.load(std::memory_order_acquire)) {
+            return;
+        }
+        if (generation == seenGeneration) {
+            // spurious wakeup
+            continue;
+        }
+        seenGeneration = generation;
+
+        timer.start();
+        const int processed = processTasks(generation);
+        if (processed > 0) {
+            m_pendingTasks.fetch_sub(processed, std::memory_order_release);
+            Stat::track(pWorker->statKey(),
+                    Stat::DURATION_NANOSEC,
+                    kDefaultComputeFlags,
+                    static_cast<double>(timer.elapsed().toIntegerNanos()));
+        }
+    }
+}
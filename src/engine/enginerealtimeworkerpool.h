@@ -0,0 +1,69 @@
+#pragma once
+
+#include <QString>
+#include <QThread>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+/// EngineRealtimeWorkerPool is a fork/join pool of pre-spawned worker threads
+/// that help the engine thread with independent work items of a single audio
+/// callback. Unlike EngineWorker, which runs background work after the
+/// callback, the tasks submitted here are part of the callback itself and
+/// run() returns only after all of them have been processed.
+///
+/// No locks are taken on the hot path. Workers spin for a short while after
+/// each callback and then sleep on an atomic (a futex on Linux) until the
+/// engine thread publishes the next job.
+class EngineRealtimeWorkerPool {
+  public:
+    /// A batch of independent tasks that may be processed concurrently and
+    /// in any order.
+    class Job {
+      public:
+        virtual ~Job() = default;
+        virtual void processTask(int taskIndex) = 0;
+    };
+
+    /// The upper bound for the number of tasks per job.
+    static constexpr int kMaxTasks = 0xFFFF;
+
+    explicit EngineRealtimeWorkerPool(int numWorkers);
+    ~EngineRealtimeWorkerPool();
+
+    /// A sensible number of helper threads for this machine, which leaves
+    /// one core for the engine thread itself and one for the GUI.
+    static int defaultNumWorkers();
+
+    int numWorkers() const {
+        return static_cast<int>(m_workers.size());
+    }
+
+    /// Processes all tasks of pJob, using the calling thread and all workers,
+    /// and returns when every task has been completed. Must only be called
+    /// from the engine thread and is not reentrant.
+    void run(Job* pJob, int numTasks);
+
+  private:
+    class Worker;
+
+    /// Claims and processes tasks of the given generation until none are
+    /// left. Returns the number of processed tasks.
+    int processTasks(quint32 generation);
+    void workerLoop(Worker* pWorker);
+
+    std::vector<std::unique_ptr<Worker>> m_workers;
+
+    // Only written by the engine thread while no job is in flight.
+    std::atomic<Job*> m_pJob;
+
+    // Packed job state: generation (high 32 bits), number of tasks
+    // (16 bits) and index of the next unclaimed task (low 16 bits). Packing
+    // them into a single atomic guarantees that a late worker can never
+    // claim a task of a job it has not seen being published.
+    alignas(64) std::atomic<quint64> m_taskCounter;
+    alignas(64) std::atomic<int> m_pendingTasks;
+    alignas(64) std::atomic<quint32> m_wakeGeneration;
+    std::atomic<int> m_sleepingWorkers;
+    std::atomic<bool> m_quit;
+};
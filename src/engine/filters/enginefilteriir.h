@@ -6,6 +6,14 @@
 #define MIXXX
 #include <fidlib.h>
 
+#include <QtGlobal>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#include <arm_neon.h>
+#endif
+
 #include "engine/engineobject.h"
 #include "util/sample.h"
 
@@ -35,9 +43,159 @@ class EngineFilterIIRBase : public EngineObjectConstIn {
 // length of the 3rd argument to fid_design_coef
 #define FIDSPEC_LENGTH 40
 
+#if defined(__SSE2__) || defined(_M_X64)
+#define ENGINEFILTERIIR_SSE2
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define ENGINEFILTERIIR_NEON
+#endif
+
+/// Both channels of a stereo frame that pass through a filter in lock step.
+///
+/// The state of a filter is stored as one instance per delay element, i.e.
+/// as a structure of arrays. Every operation of the difference equations
+/// is done for both channels by a single SSE2 or NEON instruction in double
+/// precision. Other architectures use scalar code.
+class EngineFilterIIRStereoLanes {
+  public:
+#if defined(ENGINEFILTERIIR_SSE2)
+    typedef __m128d Vec;
+#elif defined(ENGINEFILTERIIR_NEON)
+    typedef float64x2_t Vec;
+#else
+    struct Vec {
+        double left;
+        double right;
+    };
+#endif
+
+    EngineFilterIIRStereoLanes() = default;
+    explicit EngineFilterIIRStereoLanes(Vec vec)
+            : m_vec(vec) {
+    }
+
+    static EngineFilterIIRStereoLanes broadcast(double value) {
+#if defined(ENGINEFILTERIIR_SSE2)
+        return EngineFilterIIRStereoLanes(_mm_set1_pd(value));
+#elif defined(ENGINEFILTERIIR_NEON)
+        return EngineFilterIIRStereoLanes(vdupq_n_f64(value));
+#else
+        return EngineFilterIIRStereoLanes(Vec{value, value});
+#endif
+    }
+
+    /// Loads an interleaved stereo frame
+    static EngineFilterIIRStereoLanes load(const CSAMPLE* pFrame) {
+#if defined(ENGINEFILTERIIR_SSE2)
+        return EngineFilterIIRStereoLanes(_mm_cvtps_pd(_mm_castsi128_ps(
+                _mm_loadl_epi64(reinterpret_cast<const __m128i*>(pFrame)))));
+#elif defined(ENGINEFILTERIIR_NEON)
+        return EngineFilterIIRStereoLanes(vcvt_f64_f32(vld1_f32(pFrame)));
+#else
+        return EngineFilterIIRStereoLanes(Vec{pFrame[0], pFrame[1]});
+#endif
+    }
+
+    /// Stores an interleaved stereo frame
+    void store(CSAMPLE* pFrame) const {
+#if defined(ENGINEFILTERIIR_SSE2)
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(pFrame),
+                _mm_castps_si128(_mm_cvtpd_ps(m_vec)));
+#elif defined(ENGINEFILTERIIR_NEON)
+        vst1_f32(pFrame, vcvt_f32_f64(m_vec));
+#else
+        pFrame[0] = static_cast<CSAMPLE>(m_vec.left);
+        pFrame[1] = static_cast<CSAMPLE>(m_vec.right);
+#endif
+    }
+
+    double left() const {
+#if defined(ENGINEFILTERIIR_SSE2)
+        return _mm_cvtsd_f64(m_vec);
+#elif defined(ENGINEFILTERIIR_NEON)
+        return vgetq_lane_f64(m_vec, 0);
+#else
+        return m_vec.left;
+#endif
+    }
+
+    double right() const {
+#if defined(ENGINEFILTERIIR_SSE2)
+        return _mm_cvtsd_f64(_mm_unpackhi_pd(m_vec, m_vec));
+#elif defined(ENGINEFILTERIIR_NEON)
+        return vgetq_lane_f64(m_vec, 1);
+#else
+        return m_vec.right;
+#endif
+    }
+
+    friend EngineFilterIIRStereoLanes operator+(
+            EngineFilterIIRStereoLanes lhs, EngineFilterIIRStereoLanes rhs) {
+#if defined(ENGINEFILTERIIR_SSE2)
+        return EngineFilterIIRStereoLanes(_mm_add_pd(lhs.m_vec, rhs.m_vec));
+#elif defined(ENGINEFILTERIIR_NEON)
+        return EngineFilterIIRStereoLanes(vaddq_f64(lhs.m_vec, rhs.m_vec));
+#else
+        return EngineFilterIIRStereoLanes(Vec{
+                lhs.m_vec.left + rhs.m_vec.left,
+                lhs.m_vec.right + rhs.m_vec.right});
+#endif
+    }
+
+    friend EngineFilterIIRStereoLanes operator-(
+            EngineFilterIIRStereoLanes lhs, EngineFilterIIRStereoLanes rhs) {
+#if defined(ENGINEFILTERIIR_SSE2)
+        return EngineFilterIIRStereoLanes(_mm_sub_pd(lhs.m_vec, rhs.m_vec));
+#elif defined(ENGINEFILTERIIR_NEON)
+        return EngineFilterIIRStereoLanes(vsubq_f64(lhs.m_vec, rhs.m_vec));
+#else
+        return EngineFilterIIRStereoLanes(Vec{
+                lhs.m_vec.left - rhs.m_vec.left,
+                lhs.m_vec.right - rhs.m_vec.right});
+#endif
+    }
+
+    friend EngineFilterIIRStereoLanes operator*(
+            EngineFilterIIRStereoLanes lhs, EngineFilterIIRStereoLanes rhs) {
+#if defined(ENGINEFILTERIIR_SSE2)
+        return EngineFilterIIRStereoLanes(_mm_mul_pd(lhs.m_vec, rhs.m_vec));
+#elif defined(ENGINEFILTERIIR_NEON)
+        return EngineFilterIIRStereoLanes(vmulq_f64(lhs.m_vec, rhs.m_vec));
+#else
+        return EngineFilterIIRStereoLanes(Vec{
+                lhs.m_vec.left * rhs.m_vec.left,
+                lhs.m_vec.right * rhs.m_vec.right});
+#endif
+    }
+
+    EngineFilterIIRStereoLanes operator-() const {
+        return broadcast(0.0) - *this;
+    }
+
+    EngineFilterIIRStereoLanes& operator+=(EngineFilterIIRStereoLanes rhs) {
+        return *this = *this + rhs;
+    }
+
+    EngineFilterIIRStereoLanes& operator-=(EngineFilterIIRStereoLanes rhs) {
+        return *this = *this - rhs;
+    }
+
+  private:
+    Vec m_vec;
+};
+
+/// The difference equations of the supported filter topologies for a single
+/// channel (V = C = double) or for both channels of a stereo frame
+/// (V = C = EngineFilterIIRStereoLanes). The functions are always inlined
+/// into the processing loops to keep the state in registers.
+template<unsigned int SIZE, enum IIRPass PASS>
+struct EngineFilterIIRKernel;
+
 template<unsigned int SIZE, enum IIRPass PASS>
 class EngineFilterIIR : public EngineFilterIIRBase {
   public:
+    typedef EngineFilterIIRKernel<SIZE, PASS> Kernel;
+    typedef EngineFilterIIRStereoLanes StereoLanes;
+
     EngineFilterIIR()
             : m_doRamping(false),
               m_doStart(false),
@@ -83,11 +241,9 @@ class EngineFilterIIR : public EngineFilterIIRBase {
 
     void initBuffers() {
         // Copy the current buffers into the old buffers
-        memcpy(m_oldBuf1, m_buf1, sizeof(m_buf1));
-        memcpy(m_oldBuf2, m_buf2, sizeof(m_buf2));
+        memcpy(m_oldBuf, m_buf, sizeof(m_buf));
         // Set the current buffers to 0
-        memset(m_buf1, 0, sizeof(m_buf1));
-        memset(m_buf2, 0, sizeof(m_buf2));
+        memset(m_buf, 0, sizeof(m_buf));
         m_doRamping = true;
     }
 
@@ -228,14 +384,26 @@ class EngineFilterIIR : public EngineFilterIIRBase {
         m_doStart = false;
     }
 
+
     virtual void process(const CSAMPLE* pIn, CSAMPLE* pOutput,
                          const int iBufferSize) {
+        // Work on local copies of the state and of the coefficients that
+        // are broadcast to both lanes in advance. The compiler is able to
+        // keep them in registers.
+        StereoLanes coef[SIZE + 1];
+        broadcastCoefs(coef, m_coef);
+        StereoLanes buf[SIZE];
+        memcpy(buf, m_buf, sizeof(buf));
         if (!m_doRamping) {
             for (int i = 0; i < iBufferSize; i += 2) {
-                pOutput[i] = static_cast<CSAMPLE>(processSample(m_coef, m_buf1, pIn[i]));
-                pOutput[i + 1] = static_cast<CSAMPLE>(processSample(m_coef, m_buf2, pIn[i + 1]));
+                Kernel::processSample(coef, buf, StereoLanes::load(pIn + i))
+                        .store(pOutput + i);
             }
         } else {
+            StereoLanes oldCoef[SIZE + 1];
+            broadcastCoefs(oldCoef, m_oldCoef);
+            StereoLanes oldBuf[SIZE];
+            memcpy(oldBuf, m_oldBuf, sizeof(oldBuf));
             double cross_mix = 0.0;
             double cross_inc = 4.0 / static_cast<double>(iBufferSize);
             for (int i = 0; i < iBufferSize; i += 2) {
@@ -250,12 +418,14 @@ class EngineFilterIIR : public EngineFilterIIRBase {
                 // of the new filter but it turns out that this produces
                 // a gain drop due to the filter delay which is more
                 // conspicuous than the settling noise.
+                const StereoLanes in = StereoLanes::load(pIn + i);
                 double old1;
                 double old2;
                 if (!m_doStart) {
                     // Process old filter, but only if we do not do a fresh start
-                    old1 = static_cast<CSAMPLE>(processSample(m_oldCoef, m_oldBuf1, pIn[i]));
-                    old2 = static_cast<CSAMPLE>(processSample(m_oldCoef, m_oldBuf2, pIn[i + 1]));
+                    const StereoLanes old = Kernel::processSample(oldCoef, oldBuf, in);
+                    old1 = static_cast<CSAMPLE>(old.left());
+                    old2 = static_cast<CSAMPLE>(old.right());
                 } else {
                     if (m_startFromDry) {
                         old1 = pIn[i];
@@ -265,8 +435,9 @@ class EngineFilterIIR : public EngineFilterIIRBase {
                         old2 = 0;
                     }
                 }
-                double new1 = static_cast<CSAMPLE>(processSample(m_coef, m_buf1, pIn[i]));
-                double new2 = static_cast<CSAMPLE>(processSample(m_coef, m_buf2, pIn[i + 1]));
+                const StereoLanes out = Kernel::processSample(coef, buf, in);
+                double new1 = static_cast<CSAMPLE>(out.left());
+                double new2 = static_cast<CSAMPLE>(out.right());
 
                 if (i < iBufferSize / 2) {
                     pOutput[i] = static_cast<CSAMPLE>(old1);
@@ -278,17 +449,23 @@ class EngineFilterIIR : public EngineFilterIIRBase {
                     cross_mix += cross_inc;
                 }
             }
+            memcpy(m_oldBuf, oldBuf, sizeof(m_oldBuf));
             m_doRamping = false;
             m_doStart = false;
         }
+        memcpy(m_buf, buf, sizeof(m_buf));
     }
 
   protected:
-    inline double processSample(double* coef, double* buf, double val);
+    static void broadcastCoefs(StereoLanes* pLanes, const double* pCoef) {
+        for (unsigned int k = 0; k < SIZE + 1; ++k) {
+            pLanes[k] = StereoLanes::broadcast(pCoef[k]);
+        }
+    }
+
     inline void pauseFilterInner() {
         // Set the current buffers to 0
-        memset(m_buf1, 0, sizeof(m_buf1));
-        memset(m_buf2, 0, sizeof(m_buf2));
+        memset(m_buf, 0, sizeof(m_buf));
         m_doRamping = true;
         m_doStart = true;
     }
@@ -297,15 +474,10 @@ class EngineFilterIIR : public EngineFilterIIRBase {
     // Old coefficients needed for ramping
     double m_oldCoef[SIZE + 1];
 
-    // Channel 1 state
-    double m_buf1[SIZE];
-    // Old channel 1 buffer needed for ramping
-    double m_oldBuf1[SIZE];
-
-    // Channel 2 state
-    double m_buf2[SIZE];
-    // Old channel 2 buffer needed for ramping
-    double m_oldBuf2[SIZE];
+    // State of both channels
+    StereoLanes m_buf[SIZE];
+    // Old buffer needed for ramping
+    StereoLanes m_oldBuf[SIZE];
 
     // Flag set to true if ramping needs to be done
     bool m_doRamping;
@@ -316,330 +488,344 @@ class EngineFilterIIR : public EngineFilterIIRBase {
 };
 
 template<>
-inline double EngineFilterIIR<2, IIR_LP>::processSample(double* coef,
-                                                        double* buf,
-                                                        double val) {
-    double tmp, fir, iir;
-    tmp = buf[0]; buf[0] = buf[1];
-    iir = val * coef[0];
-    iir -= coef[1] * tmp; fir = tmp;
-    iir -= coef[2] * buf[0]; fir += buf[0] + buf[0];
-    fir += iir;
-    buf[1] = iir; val = fir;
-    return val;
-}
+struct EngineFilterIIRKernel<2, IIR_LP> {
+    template<typename C, typename V>
+    static Q_ALWAYS_INLINE V processSample(const C* coef, V* buf, V val) {
+        V tmp, fir, iir;
+        tmp = buf[0]; buf[0] = buf[1];
+        iir = val * coef[0];
+        iir -= coef[1] * tmp; fir = tmp;
+        iir -= coef[2] * buf[0]; fir += buf[0] + buf[0];
+        fir += iir;
+        buf[1] = iir; val = fir;
+        return val;
+    }
+};
 
 template<>
-inline double EngineFilterIIR<2, IIR_BP>::processSample(double* coef,
-                                                        double* buf,
-                                                        double val) {
-    double tmp, fir, iir;
-    tmp = buf[0]; buf[0] = buf[1];
-    iir = val * coef[0];
-    iir -= coef[1] * tmp; fir = -tmp;
-    iir -= coef[2] * buf[0];
-    fir += iir;
-    buf[1] = iir; val = fir;
-    return val;
-}
+struct EngineFilterIIRKernel<2, IIR_BP> {
+    template<typename C, typename V>
+    static Q_ALWAYS_INLINE V processSample(const C* coef, V* buf, V val) {
+        V tmp, fir, iir;
+        tmp = buf[0]; buf[0] = buf[1];
+        iir = val * coef[0];
+        iir -= coef[1] * tmp; fir = -tmp;
+        iir -= coef[2] * buf[0];
+        fir += iir;
+        buf[1] = iir; val = fir;
+        return val;
+    }
+};
 
 template<>
-inline double EngineFilterIIR<2, IIR_HP>::processSample(double* coef,
-                                                        double* buf,
-                                                        double val) {
-    double tmp, fir, iir;
-    tmp = buf[0]; buf[0] = buf[1];
-    iir = val * coef[0];
-    iir -= coef[1] * tmp; fir = tmp;
-    iir -= coef[2] * buf[0]; fir += -buf[0] - buf[0];
-    fir += iir;
-    buf[1] = iir; val = fir;
-    return val;
-}
+struct EngineFilterIIRKernel<2, IIR_HP> {
+    template<typename C, typename V>
+    static Q_ALWAYS_INLINE V processSample(const C* coef, V* buf, V val) {
+        V tmp, fir, iir;
+        tmp = buf[0]; buf[0] = buf[1];
+        iir = val * coef[0];
+        iir -= coef[1] * tmp; fir = tmp;
+        iir -= coef[2] * buf[0]; fir += -buf[0] - buf[0];
+        fir += iir;
+        buf[1] = iir; val = fir;
+        return val;
+    }
+};
 
 template<>
-inline double EngineFilterIIR<4, IIR_LP>::processSample(double* coef,
-                                                        double* buf,
-                                                        double val) {
-    double tmp, fir, iir;
-    tmp = buf[0]; buf[0] = buf[1]; buf[1] = buf[2]; buf[2] = buf[3];
-    iir = val * coef[0];
-    iir -= coef[1] * tmp; fir = tmp;
-    iir -= coef[2] * buf[0]; fir += buf[0] + buf[0];
-    fir += iir;
-    tmp = buf[1]; buf[1] = iir; val = fir;
-    iir = val;
-    iir -= coef[3] * tmp; fir = tmp;
-    iir -= coef[4] * buf[2]; fir += buf[2] + buf[2];
-    fir += iir;
-    buf[3] = iir; val = fir;
-    return val;
-}
+struct EngineFilterIIRKernel<4, IIR_LP> {
+    template<typename C, typename V>
+    static Q_ALWAYS_INLINE V processSample(const C* coef, V* buf, V val) {
+        V tmp, fir, iir;
+        tmp = buf[0]; buf[0] = buf[1]; buf[1] = buf[2]; buf[2] = buf[3];
+        iir = val * coef[0];
+        iir -= coef[1] * tmp; fir = tmp;
+        iir -= coef[2] * buf[0]; fir += buf[0] + buf[0];
+        fir += iir;
+        tmp = buf[1]; buf[1] = iir; val = fir;
+        iir = val;
+        iir -= coef[3] * tmp; fir = tmp;
+        iir -= coef[4] * buf[2]; fir += buf[2] + buf[2];
+        fir += iir;
+        buf[3] = iir; val = fir;
+        return val;
+    }
+};
 
 template<>
-inline double EngineFilterIIR<8, IIR_BP>::processSample(double* coef,
-                                                        double* buf,
-                                                        double val) {
-    double tmp, fir, iir;
-    tmp = buf[0]; buf[0] = buf[1]; buf[1] = buf[2]; buf[2] = buf[3];
-    buf[3] = buf[4]; buf[4] = buf[5]; buf[5] = buf[6]; buf[6] = buf[7];
-    iir = val * coef[0];
-    iir -= coef[1] * tmp; fir = tmp;
-    iir -= coef[2] * buf[0]; fir += -buf[0] - buf[0];
-    fir += iir;
-    tmp = buf[1]; buf[1] = iir; val= fir;
-    iir = val;
-    iir -= coef[3] * tmp; fir = tmp;
-    iir -= coef[4] * buf[2]; fir += -buf[2] - buf[2];
-    fir += iir;
-    tmp = buf[3]; buf[3] = iir; val= fir;
-    iir = val;
-    iir -= coef[5] * tmp; fir = tmp;
-    iir -= coef[6] * buf[4]; fir += buf[4] + buf[4];
-    fir += iir;
-    tmp = buf[5]; buf[5] = iir; val= fir;
-    iir = val;
-    iir -= coef[7] * tmp; fir = tmp;
-    iir -= coef[8] * buf[6]; fir += buf[6] + buf[6];
-    fir += iir;
-    buf[7] = iir; val = fir;
-    return val;
-}
+struct EngineFilterIIRKernel<8, IIR_BP> {
+    template<typename C, typename V>
+    static Q_ALWAYS_INLINE V processSample(const C* coef, V* buf, V val) {
+        V tmp, fir, iir;
+        tmp = buf[0]; buf[0] = buf[1]; buf[1] = buf[2]; buf[2] = buf[3];
+        buf[3] = buf[4]; buf[4] = buf[5]; buf[5] = buf[6]; buf[6] = buf[7];
+        iir = val * coef[0];
+        iir -= coef[1] * tmp; fir = tmp;
+        iir -= coef[2] * buf[0]; fir += -buf[0] - buf[0];
+        fir += iir;
+        tmp = buf[1]; buf[1] = iir; val= fir;
+        iir = val;
+        iir -= coef[3] * tmp; fir = tmp;
+        iir -= coef[4] * buf[2]; fir += -buf[2] - buf[2];
+        fir += iir;
+        tmp = buf[3]; buf[3] = iir; val= fir;
+        iir = val;
+        iir -= coef[5] * tmp; fir = tmp;
+        iir -= coef[6] * buf[4]; fir += buf[4] + buf[4];
+        fir += iir;
+        tmp = buf[5]; buf[5] = iir; val= fir;
+        iir = val;
+        iir -= coef[7] * tmp; fir = tmp;
+        iir -= coef[8] * buf[6]; fir += buf[6] + buf[6];
+        fir += iir;
+        buf[7] = iir; val = fir;
+        return val;
+    }
+};
 
 template<>
-inline double EngineFilterIIR<4, IIR_HP>::processSample(double* coef,
-                                                        double* buf,
-                                                        double val) {
-    double tmp, fir, iir;
-    tmp = buf[0]; buf[0] = buf[1]; buf[1] = buf[2]; buf[2] = buf[3];
-    iir= val * coef[0];
-    iir -= coef[1] * tmp; fir = tmp;
-    iir -= coef[2] * buf[0]; fir += -buf[0] - buf[0];
-    fir += iir;
-    tmp = buf[1]; buf[1] = iir; val = fir;
-    iir = val;
-    iir -= coef[3] * tmp; fir = tmp;
-    iir -= coef[4] * buf[2]; fir += -buf[2] - buf[2];
-    fir += iir;
-    buf[3] = iir; val = fir;
-    return val;
-}
+struct EngineFilterIIRKernel<4, IIR_HP> {
+    template<typename C, typename V>
+    static Q_ALWAYS_INLINE V processSample(const C* coef, V* buf, V val) {
+        V tmp, fir, iir;
+        tmp = buf[0]; buf[0] = buf[1]; buf[1] = buf[2]; buf[2] = buf[3];
+        iir= val * coef[0];
+        iir -= coef[1] * tmp; fir = tmp;
+        iir -= coef[2] * buf[0]; fir += -buf[0] - buf[0];
+        fir += iir;
+        tmp = buf[1]; buf[1] = iir; val = fir;
+        iir = val;
+        iir -= coef[3] * tmp; fir = tmp;
+        iir -= coef[4] * buf[2]; fir += -buf[2] - buf[2];
+        fir += iir;
+        buf[3] = iir; val = fir;
+        return val;
+    }
+};
 
 template<>
-inline double EngineFilterIIR<8, IIR_LP>::processSample(double* coef,
-                                                        double* buf,
-                                                        double val) {
-    double tmp, fir, iir;
-    tmp = buf[0]; buf[0] = buf[1]; buf[1] = buf[2]; buf[2] = buf[3];
-    buf[3] = buf[4]; buf[4] = buf[5]; buf[5] = buf[6]; buf[6] = buf[7];
-    iir = val * coef[0];
-    iir -= coef[1] * tmp; fir = tmp;
-    iir -= coef[2] * buf[0]; fir += buf[0] + buf[0];
-    fir += iir;
-    tmp = buf[1]; buf[1] = iir; val = fir;
-    iir = val;
-    iir -= coef[3] * tmp; fir = tmp;
-    iir -= coef[4] * buf[2]; fir += buf[2] + buf[2];
-    fir += iir;
-    tmp = buf[3]; buf[3] = iir; val = fir;
-    iir = val;
-    iir -= coef[5] * tmp; fir = tmp;
-    iir -= coef[6] * buf[4]; fir += buf[4] + buf[4];
-    fir += iir;
-    tmp = buf[5]; buf[5] = iir; val = fir;
-    iir = val;
-    iir -= coef[7] * tmp; fir = tmp;
-    iir -= coef[8] * buf[6]; fir += buf[6] + buf[6];
-    fir += iir;
-    buf[7] = iir; val = fir;
-    return val;
-}
+struct EngineFilterIIRKernel<8, IIR_LP> {
+    template<typename C, typename V>
+    static Q_ALWAYS_INLINE V processSample(const C* coef, V* buf, V val) {
+        V tmp, fir, iir;
+        tmp = buf[0]; buf[0] = buf[1]; buf[1] = buf[2]; buf[2] = buf[3];
+        buf[3] = buf[4]; buf[4] = buf[5]; buf[5] = buf[6]; buf[6] = buf[7];
+        iir = val * coef[0];
+        iir -= coef[1] * tmp; fir = tmp;
+        iir -= coef[2] * buf[0]; fir += buf[0] + buf[0];
+        fir += iir;
+        tmp = buf[1]; buf[1] = iir; val = fir;
+        iir = val;
+        iir -= coef[3] * tmp; fir = tmp;
+        iir -= coef[4] * buf[2]; fir += buf[2] + buf[2];
+        fir += iir;
+        tmp = buf[3]; buf[3] = iir; val = fir;
+        iir = val;
+        iir -= coef[5] * tmp; fir = tmp;
+        iir -= coef[6] * buf[4]; fir += buf[4] + buf[4];
+        fir += iir;
+        tmp = buf[5]; buf[5] = iir; val = fir;
+        iir = val;
+        iir -= coef[7] * tmp; fir = tmp;
+        iir -= coef[8] * buf[6]; fir += buf[6] + buf[6];
+        fir += iir;
+        buf[7] = iir; val = fir;
+        return val;
+    }
+};
 
 template<>
-inline double EngineFilterIIR<16, IIR_BP>::processSample(double* coef,
-                                                         double* buf,
-                                                         double val) {
-    double tmp, fir, iir;
-    tmp = buf[0]; buf[0] = buf[1]; buf[1] = buf[2]; buf[2] = buf[3];
-    buf[3] = buf[4]; buf[4] = buf[5]; buf[5] = buf[6]; buf[6] = buf[7];
-    buf[7] = buf[8]; buf[8] = buf[9]; buf[9] = buf[10]; buf[10] = buf[11];
-    buf[11] = buf[12]; buf[12] = buf[13]; buf[13] = buf[14]; buf[14] = buf[15];
-    iir = val * coef[0];
-    iir -= coef[1] * tmp; fir = tmp;
-    iir -= coef[2] * buf[0]; fir += -buf[0] - buf[0];
-    fir += iir;
-    tmp = buf[1]; buf[1] = iir; val = fir;
-    iir = val;
-    iir -= coef[3] * tmp; fir = tmp;
-    iir -= coef[4] * buf[2]; fir += -buf[2] - buf[2];
-    fir += iir;
-    tmp = buf[3]; buf[3] = iir; val = fir;
-    iir = val;
-    iir -= coef[5] * tmp; fir = tmp;
-    iir -= coef[6] * buf[4]; fir += -buf[4] - buf[4];
-    fir += iir;
-    tmp = buf[5]; buf[5] = iir; val = fir;
-    iir = val;
-    iir -= coef[7] * tmp; fir = tmp;
-    iir -= coef[8] * buf[6]; fir += -buf[6] - buf[6];
-    fir += iir;
-    tmp = buf[7]; buf[7]= iir; val= fir;
-    iir = val;
-    iir -= coef[9] * tmp; fir = tmp;
-    iir -= coef[10] * buf[8]; fir += buf[8] + buf[8];
-    fir += iir;
-    tmp = buf[9]; buf[9] = iir; val = fir;
-    iir = val;
-    iir -= coef[11] * tmp; fir = tmp;
-    iir -= coef[12] * buf[10]; fir += buf[10] + buf[10];
-    fir += iir;
-    tmp = buf[11]; buf[11] = iir; val = fir;
-    iir = val;
-    iir -= coef[13] * tmp; fir = tmp;
-    iir -= coef[14] * buf[12]; fir += buf[12] + buf[12];
-    fir += iir;
-    tmp = buf[13]; buf[13] = iir; val = fir;
-    iir = val;
-    iir -= coef[15] * tmp; fir = tmp;
-    iir -= coef[16] * buf[14]; fir += buf[14] + buf[14];
-    fir += iir;
-    buf[15] = iir; val = fir;
-    return val;
-}
+struct EngineFilterIIRKernel<16, IIR_BP> {
+    template<typename C, typename V>
+    static Q_ALWAYS_INLINE V processSample(const C* coef, V* buf, V val) {
+        V tmp, fir, iir;
+        tmp = buf[0]; buf[0] = buf[1]; buf[1] = buf[2]; buf[2] = buf[3];
+        buf[3] = buf[4]; buf[4] = buf[5]; buf[5] = buf[6]; buf[6] = buf[7];
+        buf[7] = buf[8]; buf[8] = buf[9]; buf[9] = buf[10]; buf[10] = buf[11];
+        buf[11] = buf[12]; buf[12] = buf[13]; buf[13] = buf[14]; buf[14] = buf[15];
+        iir = val * coef[0];
+        iir -= coef[1] * tmp; fir = tmp;
+        iir -= coef[2] * buf[0]; fir += -buf[0] - buf[0];
+        fir += iir;
+        tmp = buf[1]; buf[1] = iir; val = fir;
+        iir = val;
+        iir -= coef[3] * tmp; fir = tmp;
+        iir -= coef[4] * buf[2]; fir += -buf[2] - buf[2];
+        fir += iir;
+        tmp = buf[3]; buf[3] = iir; val = fir;
+        iir = val;
+        iir -= coef[5] * tmp; fir = tmp;
+        iir -= coef[6] * buf[4]; fir += -buf[4] - buf[4];
+        fir += iir;
+        tmp = buf[5]; buf[5] = iir; val = fir;
+        iir = val;
+        iir -= coef[7] * tmp; fir = tmp;
+        iir -= coef[8] * buf[6]; fir += -buf[6] - buf[6];
+        fir += iir;
+        tmp = buf[7]; buf[7]= iir; val= fir;
+        iir = val;
+        iir -= coef[9] * tmp; fir = tmp;
+        iir -= coef[10] * buf[8]; fir += buf[8] + buf[8];
+        fir += iir;
+        tmp = buf[9]; buf[9] = iir; val = fir;
+        iir = val;
+        iir -= coef[11] * tmp; fir = tmp;
+        iir -= coef[12] * buf[10]; fir += buf[10] + buf[10];
+        fir += iir;
+        tmp = buf[11]; buf[11] = iir; val = fir;
+        iir = val;
+        iir -= coef[13] * tmp; fir = tmp;
+        iir -= coef[14] * buf[12]; fir += buf[12] + buf[12];
+        fir += iir;
+        tmp = buf[13]; buf[13] = iir; val = fir;
+        iir = val;
+        iir -= coef[15] * tmp; fir = tmp;
+        iir -= coef[16] * buf[14]; fir += buf[14] + buf[14];
+        fir += iir;
+        buf[15] = iir; val = fir;
+        return val;
+    }
+};
 
 template<>
-inline double EngineFilterIIR<8, IIR_HP>::processSample(double* coef,
-                                                        double* buf,
-                                                        double val) {
-    double tmp, fir, iir;
-    tmp = buf[0]; buf[0] = buf[1]; buf[1] = buf[2]; buf[2] = buf[3];
-    buf[3] = buf[4]; buf[4] = buf[5]; buf[5] = buf[6]; buf[6] = buf[7];
-    iir = val * coef[0];
-    iir -= coef[1] * tmp; fir = tmp;
-    iir -= coef[2] * buf[0]; fir += -buf[0] - buf[0];
-    fir += iir;
-    tmp = buf[1]; buf[1] = iir; val = fir;
-    iir = val;
-    iir -= coef[3] * tmp; fir = tmp;
-    iir -= coef[4] * buf[2]; fir += -buf[2] - buf[2];
-    fir += iir;
-    tmp = buf[3]; buf[3] = iir; val = fir;
-    iir = val;
-    iir -= coef[5] * tmp; fir = tmp;
-    iir -= coef[6] * buf[4]; fir += -buf[4] - buf[4];
-    fir += iir;
-    tmp = buf[5]; buf[5] = iir; val = fir;
-    iir = val;
-    iir -= coef[7] * tmp; fir = tmp;
-    iir -= coef[8] * buf[6]; fir += -buf[6] - buf[6];
-    fir += iir;
-    buf[7] = iir; val = fir;
-    return val;
-}
+struct EngineFilterIIRKernel<8, IIR_HP> {
+    template<typename C, typename V>
+    static Q_ALWAYS_INLINE V processSample(const C* coef, V* buf, V val) {
+        V tmp, fir, iir;
+        tmp = buf[0]; buf[0] = buf[1]; buf[1] = buf[2]; buf[2] = buf[3];
+        buf[3] = buf[4]; buf[4] = buf[5]; buf[5] = buf[6]; buf[6] = buf[7];
+        iir = val * coef[0];
+        iir -= coef[1] * tmp; fir = tmp;
+        iir -= coef[2] * buf[0]; fir += -buf[0] - buf[0];
+        fir += iir;
+        tmp = buf[1]; buf[1] = iir; val = fir;
+        iir = val;
+        iir -= coef[3] * tmp; fir = tmp;
+        iir -= coef[4] * buf[2]; fir += -buf[2] - buf[2];
+        fir += iir;
+        tmp = buf[3]; buf[3] = iir; val = fir;
+        iir = val;
+        iir -= coef[5] * tmp; fir = tmp;
+        iir -= coef[6] * buf[4]; fir += -buf[4] - buf[4];
+        fir += iir;
+        tmp = buf[5]; buf[5] = iir; val = fir;
+        iir = val;
+        iir -= coef[7] * tmp; fir = tmp;
+        iir -= coef[8] * buf[6]; fir += -buf[6] - buf[6];
+        fir += iir;
+        buf[7] = iir; val = fir;
+        return val;
+    }
+};
 
 // IIR_LP and IIR_HP use the same processSample routine
 template<>
-inline double EngineFilterIIR<5, IIR_BP>::processSample(double* coef,
-                                                        double* buf,
-                                                        double val) {
-    double tmp, fir, iir;
-    tmp = buf[0]; buf[0] = buf[1];
-    iir = val * coef[0];
-    iir -= coef[1] * tmp; fir = coef[2] * tmp;
-    iir -= coef[3] * buf[0]; fir += coef[4] * buf[0];
-    fir += coef[5] * iir;
-    buf[1] = iir; val = fir;
-    return val;
-}
+struct EngineFilterIIRKernel<5, IIR_BP> {
+    template<typename C, typename V>
+    static Q_ALWAYS_INLINE V processSample(const C* coef, V* buf, V val) {
+        V tmp, fir, iir;
+        tmp = buf[0]; buf[0] = buf[1];
+        iir = val * coef[0];
+        iir -= coef[1] * tmp; fir = coef[2] * tmp;
+        iir -= coef[3] * buf[0]; fir += coef[4] * buf[0];
+        fir += coef[5] * iir;
+        buf[1] = iir; val = fir;
+        return val;
+    }
+};
 
 template<>
-inline double EngineFilterIIR<4, IIR_LPMO>::processSample(double* coef,
-                                                        double* buf,
-                                                        double val) {
-   double tmp, fir, iir;
-   tmp= buf[0]; buf[0] = buf[1]; buf[1] = buf[2]; buf[2] = buf[3];
-   iir= val * coef[0];
-   iir -= coef[1]*tmp; fir= tmp;
-   fir += iir;
-   tmp= buf[0]; buf[0]= iir; val= fir;
-   iir= val;
-   iir -= coef[2]*tmp; fir= tmp;
-   fir += iir;
-   tmp= buf[1]; buf[1]= iir; val= fir;
-   iir= val;
-   iir -= coef[3]*tmp; fir= tmp;
-   fir += iir;
-   tmp= buf[2]; buf[2]= iir; val= fir;
-   iir= val;
-   iir -= coef[4]*tmp; fir= tmp;
-   fir += iir;
-   buf[3]= iir; val= fir;
-   return val;
-}
+struct EngineFilterIIRKernel<4, IIR_LPMO> {
+    template<typename C, typename V>
+    static Q_ALWAYS_INLINE V processSample(const C* coef, V* buf, V val) {
+        V tmp, fir, iir;
+        tmp= buf[0]; buf[0] = buf[1]; buf[1] = buf[2]; buf[2] = buf[3];
+        iir= val * coef[0];
+        iir -= coef[1]*tmp; fir= tmp;
+        fir += iir;
+        tmp= buf[0]; buf[0]= iir; val= fir;
+        iir= val;
+        iir -= coef[2]*tmp; fir= tmp;
+        fir += iir;
+        tmp= buf[1]; buf[1]= iir; val= fir;
+        iir= val;
+        iir -= coef[3]*tmp; fir= tmp;
+        fir += iir;
+        tmp= buf[2]; buf[2]= iir; val= fir;
+        iir= val;
+        iir -= coef[4]*tmp; fir= tmp;
+        fir += iir;
+        buf[3]= iir; val= fir;
+        return val;
+    }
+};
 
 
 template<>
-inline double EngineFilterIIR<4, IIR_HPMO>::processSample(double* coef,
-                                                        double* buf,
-                                                        double val) {
-   double tmp, fir, iir;
-   tmp= buf[0]; buf[0] = buf[1]; buf[1] = buf[2]; buf[2] = buf[3];
-   iir= val * coef[0];
-   iir -= coef[1]*tmp; fir= -tmp;
-   fir += iir;
-   tmp= buf[0]; buf[0]= iir; val= fir;
-   iir= val;
-   iir -= coef[2]*tmp; fir= -tmp;
-   fir += iir;
-   tmp= buf[1]; buf[1]= iir; val= fir;
-   iir= val;
-   iir -= coef[3]*tmp; fir= -tmp;
-   fir += iir;
-   tmp= buf[2]; buf[2]= iir; val= fir;
-   iir= val;
-   iir -= coef[4]*tmp; fir= -tmp;
-   fir += iir;
-   buf[3]= iir; val= fir;
-   return val;
-}
+struct EngineFilterIIRKernel<4, IIR_HPMO> {
+    template<typename C, typename V>
+    static Q_ALWAYS_INLINE V processSample(const C* coef, V* buf, V val) {
+        V tmp, fir, iir;
+        tmp= buf[0]; buf[0] = buf[1]; buf[1] = buf[2]; buf[2] = buf[3];
+        iir= val * coef[0];
+        iir -= coef[1]*tmp; fir= -tmp;
+        fir += iir;
+        tmp= buf[0]; buf[0]= iir; val= fir;
+        iir= val;
+        iir -= coef[2]*tmp; fir= -tmp;
+        fir += iir;
+        tmp= buf[1]; buf[1]= iir; val= fir;
+        iir= val;
+        iir -= coef[3]*tmp; fir= -tmp;
+        fir += iir;
+        tmp= buf[2]; buf[2]= iir; val= fir;
+        iir= val;
+        iir -= coef[4]*tmp; fir= -tmp;
+        fir += iir;
+        buf[3]= iir; val= fir;
+        return val;
+    }
+};
 
 template<>
-inline double EngineFilterIIR<2, IIR_LP2>::processSample(double* coef,
-                                                        double* buf,
-                                                        double val) {
-    double tmp, fir, iir;
-    tmp = buf[0];
-    iir = val * coef[0];
-    iir -= coef[1] * tmp; fir = tmp;
-    fir += iir;
-    buf[0] = iir; val = fir;
-
-    tmp = buf[1];
-    iir = val;
-    iir -= coef[2] * tmp; fir = tmp;
-    fir += iir;
-    buf[1] = iir; val = fir;
-
-    return val;
-}
+struct EngineFilterIIRKernel<2, IIR_LP2> {
+    template<typename C, typename V>
+    static Q_ALWAYS_INLINE V processSample(const C* coef, V* buf, V val) {
+        V tmp, fir, iir;
+        tmp = buf[0];
+        iir = val * coef[0];
+        iir -= coef[1] * tmp; fir = tmp;
+        fir += iir;
+        buf[0] = iir; val = fir;
+
+        tmp = buf[1];
+        iir = val;
+        iir -= coef[2] * tmp; fir = tmp;
+        fir += iir;
+        buf[1] = iir; val = fir;
+
+        return val;
+    }
+};
 
 
 template<>
-inline double EngineFilterIIR<2, IIR_HP2>::processSample(double* coef,
-                                                        double* buf,
-                                                        double val) {
-    double tmp, fir, iir;
-    tmp = buf[0];
-    iir = val * -coef[0]; // swap gain to be in phase with LP2
-    iir -= coef[1] * tmp; fir = -tmp;
-    fir += iir;
-    buf[0] = iir; val = fir;
-
-    tmp = buf[1];
-    iir = val;
-    iir -= coef[2] * tmp; fir = -tmp;
-    fir += iir;
-    buf[1] = iir; val = fir;
-
-    return val;
-}
+struct EngineFilterIIRKernel<2, IIR_HP2> {
+    template<typename C, typename V>
+    static Q_ALWAYS_INLINE V processSample(const C* coef, V* buf, V val) {
+        V tmp, fir, iir;
+        tmp = buf[0];
+        iir = val * -coef[0]; // swap gain to be in phase with LP2
+        iir -= coef[1] * tmp; fir = -tmp;
+        fir += iir;
+        buf[0] = iir; val = fir;
+
+        tmp = buf[1];
+        iir = val;
+        iir -= coef[2] * tmp; fir = -tmp;
+        fir += iir;
+        buf[1] = iir; val = fir;
+
+        return val;
+    }
+};
@@ -26,9 +26,19 @@ const QString kViewName = QStringLiteral("Analysis");
 // Utilize all available cores for batch analysis of tracks
 const int kNumberOfAnalyzerThreads = math_max(1, QThread::idealThreadCount());
 
+const ConfigKey kAnalyzerPipelineConfigKey =
+        ConfigKey(QStringLiteral("[Library]"), QStringLiteral("AnalyzerPipeline"));
+
 inline
-int numberOfAnalyzerThreads() {
-    return kNumberOfAnalyzerThreads;
+int numberOfAnalyzerThreads(
+        const UserSettingsPointer& pConfig,
+        AnalyzerModeFlags modeFlags) {
+    // In pipelined mode each track is decoded on its own thread and
+    // analyzed by one thread per analyzer. All of them share the same
+    // budget of threads.
+    return math_max(1,
+            kNumberOfAnalyzerThreads /
+                    AnalyzerThread::numThreadsPerTrack(pConfig, modeFlags));
 }
 
 inline
@@ -43,6 +53,9 @@ AnalyzerModeFlags getAnalyzerModeFlags(
     if (pConfig->getValue<bool>(ConfigKey("[Library]", "EnableWaveformGenerationWithAnalysis"), true)) {
         modeFlags |= AnalyzerModeFlags::WithWaveform;
     }
+    if (pConfig->getValue<bool>(kAnalyzerPipelineConfigKey, false)) {
+        modeFlags |= AnalyzerModeFlags::Pipelined;
+    }
     return static_cast<AnalyzerModeFlags>(modeFlags);
 }
 
@@ -135,14 +148,17 @@ void AnalysisFeature::activate() {
 
 void AnalysisFeature::analyzeTracks(const QList<AnalyzerScheduledTrack>& tracks) {
     if (!m_pTrackAnalysisScheduler) {
-        const int numAnalyzerThreads = numberOfAnalyzerThreads();
+        const AnalyzerModeFlags modeFlags = getAnalyzerModeFlags(m_pConfig);
+        const int numAnalyzerThreads = numberOfAnalyzerThreads(m_pConfig, modeFlags);
         kLogger.info()
                 << "Starting analysis using"
                 << numAnalyzerThreads
-                << "analyzer threads";
+                << ((modeFlags & AnalyzerModeFlags::Pipelined)
+                                   ? "pipelined analyzer threads"
+                                   : "analyzer threads");
         m_pTrackAnalysisScheduler = m_pLibrary->createTrackAnalysisScheduler(
                 numAnalyzerThreads,
-                getAnalyzerModeFlags(m_pConfig));
+                modeFlags);
 
         connect(m_pTrackAnalysisScheduler.get(),
                 &TrackAnalysisScheduler::progress,
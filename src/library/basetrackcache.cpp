@@ -13,6 +13,59 @@ namespace {
 
 constexpr bool sDebug = false;
 
+/// The columns of the in-memory index with the same sort order as
+/// ColumnCache::columnSortForFieldIndex()
+QVector<TrackCacheIndex::Column> indexColumns(
+        const ColumnCache& columnCache,
+        const QStringList& columns) {
+    QVector<TrackCacheIndex::Column> indexColumns;
+    indexColumns.reserve(columns.size());
+    for (const auto& column : columns) {
+        indexColumns.append(TrackCacheIndex::Column{column});
+    }
+    const auto setSortType = [&](ColumnCache::Column column,
+                                     TrackCacheIndex::SortType sortType) {
+        const int index = columnCache.fieldIndex(column);
+        if (index >= 0 && index < indexColumns.size()) {
+            indexColumns[index].sortType = sortType;
+        }
+    };
+    for (const auto column : {
+                 ColumnCache::COLUMN_LIBRARYTABLE_ARTIST,
+                 ColumnCache::COLUMN_LIBRARYTABLE_TITLE,
+                 ColumnCache::COLUMN_LIBRARYTABLE_ALBUM,
+                 ColumnCache::COLUMN_LIBRARYTABLE_ALBUMARTIST,
+                 ColumnCache::COLUMN_LIBRARYTABLE_GENRE,
+                 ColumnCache::COLUMN_LIBRARYTABLE_COMPOSER,
+                 ColumnCache::COLUMN_LIBRARYTABLE_GROUPING,
+                 ColumnCache::COLUMN_LIBRARYTABLE_COMMENT,
+         }) {
+        setSortType(column, TrackCacheIndex::SortType::Collated);
+    }
+    for (const auto column : {
+                 ColumnCache::COLUMN_LIBRARYTABLE_YEAR,
+                 ColumnCache::COLUMN_LIBRARYTABLE_FILETYPE,
+                 ColumnCache::COLUMN_TRACKLOCATIONSTABLE_LOCATION,
+         }) {
+        setSortType(column, TrackCacheIndex::SortType::CaseInsensitive);
+    }
+    for (const auto column : {
+                 ColumnCache::COLUMN_LIBRARYTABLE_TRACKNUMBER,
+                 ColumnCache::COLUMN_LIBRARYTABLE_BITRATE,
+                 ColumnCache::COLUMN_LIBRARYTABLE_SAMPLERATE,
+                 ColumnCache::COLUMN_LIBRARYTABLE_TIMESPLAYED,
+         }) {
+        setSortType(column, TrackCacheIndex::SortType::Integer);
+    }
+    setSortType(ColumnCache::COLUMN_LIBRARYTABLE_KEY, TrackCacheIndex::SortType::Key);
+    const int locationIndex =
+            columnCache.fieldIndex(ColumnCache::COLUMN_TRACKLOCATIONSTABLE_LOCATION);
+    if (locationIndex >= 0 && locationIndex < indexColumns.size()) {
+        indexColumns[locationIndex].isLocation = true;
+    }
+    return indexColumns;
+}
+
 }  // namespace
 
 BaseTrackCache::BaseTrackCache(TrackCollection* pTrackCollection,
@@ -26,6 +79,7 @@ BaseTrackCache::BaseTrackCache(TrackCollection* pTrackCollection,
           m_columnsJoined(columns.join(",")),
           m_columnCache(columns),
           m_pQueryParser(new SearchQueryParser(pTrackCollection)),
+          m_index(indexColumns(m_columnCache, columns)),
           m_bIndexBuilt(false),
           m_bIsCaching(isCaching),
           m_database(pTrackCollection->database()) {
@@ -92,6 +146,7 @@ void BaseTrackCache::slotTracksRemoved(const QSet<TrackId>& trackIds) {
     }
     for (const auto& trackId : qAsConst(trackIds)) {
         m_trackInfo.remove(trackId);
+        m_index.removeRow(trackId);
         m_dirtyTracks.remove(trackId);
     }
 }
@@ -226,6 +281,7 @@ bool BaseTrackCache::updateTrackInIndex(
         for (int i = 0; i < numColumns; ++i) {
             getTrackValueForColumn(pTrack, i, record[i]);
         }
+        m_index.updateRow(trackId, record);
         if (m_bIsCaching) {
             replaceRecentTrack(std::move(trackId), std::move(pTrack));
         }
@@ -281,6 +337,7 @@ bool BaseTrackCache::updateIndexWithQuery(const QString& queryString) {
                 record[i] = query.value(i);
             }
         }
+        m_index.updateRow(trackId, record);
     }
 
     qDebug() << this << "updateIndexWithQuery took" << timer.elapsed().debugMillisWithUnit();
@@ -303,6 +360,7 @@ void BaseTrackCache::buildIndex() {
     // clear the table, and keep track of what IDs we see, then delete the ones
     // we don't see.
     m_trackInfo.clear();
+    m_index.invalidate();
 
     if (!updateIndexWithQuery(queryString)) {
         qDebug() << "buildIndex failed!";
@@ -470,72 +528,62 @@ void BaseTrackCache::filterAndSort(const QSet<TrackId>& trackIds,
         buildIndex();
     }
 
-    QStringList idStrings;
     // TODO(rryan) consider making this the data passed in and a separate
     // QVector for output
     QSet<TrackId> dirtyTracks;
     for (const auto& trackId: trackIds) {
-        idStrings << trackId.toString();
         if (m_dirtyTracks.contains(trackId)) {
             dirtyTracks.insert(trackId);
         }
     }
 
-    QStringList queryFragments;
-    if (!extraFilter.isNull() && extraFilter != "") {
-        queryFragments << QString("(%1)").arg(extraFilter);
-    }
-    if (idStrings.size() > 0) {
-        queryFragments << QString("%1 in (%2)")
-                .arg(m_idColumn, idStrings.join(","));
-    }
-
-    const std::unique_ptr<QueryNode> pQuery =
-            m_pQueryParser->parseQuery(
-                    searchQuery,
-                    m_searchColumns,
-                    queryFragments.join(" AND "));
-
-    QString filter = pQuery->toSql();
-    if (!filter.isEmpty()) {
-        filter.prepend("WHERE ");
-    }
+    PerformanceTimer timer;
+    timer.start();
 
-    QString queryString = QString("SELECT %1 FROM %2 %3 %4")
-            .arg(m_idColumn, m_tableName, filter, orderByClause);
+    m_trackOrder.resize(0); // keeps allocated memory
 
-    if (sDebug) {
-        qDebug() << this << "select() executing:" << queryString;
+    std::unique_ptr<QueryNode> pQuery;
+    if (extraFilter.isEmpty()) {
+        pQuery = m_pQueryParser->parseQuery(
+                searchQuery,
+                m_searchColumns,
+                QString());
+        if (!filterAndSortInIndex(
+                    trackIds, *pQuery, orderByClause, sortColumns, columnOffset)) {
+            pQuery.reset();
+        }
     }
+    if (!pQuery) {
+        QStringList idStrings;
+        idStrings.reserve(trackIds.size());
+        for (const auto& trackId : trackIds) {
+            idStrings << trackId.toString();
+        }
 
-    QSqlQuery query(m_database);
-    // This causes a memory savings since QSqlCachedResult (what QtSQLite uses)
-    // won't allocate a giant in-memory table that we won't use at all.
-    query.setForwardOnly(true);
-    query.prepare(queryString);
+        QStringList queryFragments;
+        if (!extraFilter.isNull() && extraFilter != "") {
+            queryFragments << QString("(%1)").arg(extraFilter);
+        }
+        if (idStrings.size() > 0) {
+            queryFragments << QString("%1 in (%2)")
+                    .arg(m_idColumn, idStrings.join(","));
+        }
 
-    if (!query.exec()) {
-        LOG_FAILED_QUERY(query);
+        pQuery = m_pQueryParser->parseQuery(
+                searchQuery,
+                m_searchColumns,
+                queryFragments.join(" AND "));
+        filterAndSortInDatabase(*pQuery, orderByClause);
     }
 
-    int idColumn = query.record().indexOf(m_idColumn);
-    int rows = query.size();
-
     if (sDebug) {
-        qDebug() << "Rows returned:" << rows;
+        qDebug() << this << "filterAndSort took" << timer.elapsed().debugMillisWithUnit();
     }
 
-    m_trackOrder.resize(0); // keeps allocated memory
     trackToIndex->clear();
-    if (rows > 0) {
-        trackToIndex->reserve(rows);
-        m_trackOrder.reserve(rows);
-    }
-
-    while (query.next()) {
-        TrackId trackId(query.value(idColumn));
-        (*trackToIndex)[trackId] = m_trackOrder.size();
-        m_trackOrder.append(trackId);
+    trackToIndex->reserve(m_trackOrder.size());
+    for (int i = 0; i < m_trackOrder.size(); ++i) {
+        (*trackToIndex)[m_trackOrder[i]] = i;
     }
 
     // At this point, the original set of tracks have been divided into two
@@ -613,6 +661,115 @@ void BaseTrackCache::filterAndSort(const QSet<TrackId>& trackIds,
     }
 }
 
+bool BaseTrackCache::filterAndSortInIndex(const QSet<TrackId>& trackIds,
+        const QueryNode& query,
+        const QString& orderByClause,
+        const QList<SortColumn>& sortColumns,
+        const int columnOffset) {
+    // The columns that are sorted by orderByClause, see
+    // BaseSqlTableModel::setSort()
+    std::vector<TrackCacheIndex::SortKey> sortKeys;
+    if (!orderByClause.isEmpty()) {
+        if (orderByClause.contains(QStringLiteral("RANDOM()"), Qt::CaseInsensitive)) {
+            return false;
+        }
+        for (const auto& sc : sortColumns) {
+            int column = sc.m_column - columnOffset;
+            if (column <= 0) {
+                if (sc.m_column != 0) {
+                    // Columns of the table model are not sorted
+                    continue;
+                }
+                // The id column
+                column = 0;
+            }
+            sortKeys.push_back(TrackCacheIndex::SortKey{column, sc.m_order});
+        }
+    }
+
+    if (!m_index.isValid()) {
+        PerformanceTimer timer;
+        timer.start();
+        m_index.build(m_trackInfo);
+        qDebug() << this << "Building the in-memory index of"
+                 << m_index.rowCount() << "tracks took"
+                 << timer.elapsed().debugMillisWithUnit();
+    }
+    m_index.setKeyNotation(m_columnCache.keyNotation());
+
+    TrackCacheIndex::Selection selection;
+    if (!query.select(m_index, &selection)) {
+        if (sDebug) {
+            qDebug() << this << "Query cannot be evaluated in memory:" << query.toSql();
+        }
+        return false;
+    }
+
+    const TrackCacheIndex::Selection trackSelection = m_index.selectTracks(
+            std::vector<TrackId>(trackIds.begin(), trackIds.end()));
+    if (trackSelection.matched.count() != trackIds.size()) {
+        // Some tracks are only available in the database
+        return false;
+    }
+    selection.matched &= trackSelection.matched;
+
+    std::vector<int> rows;
+    rows.reserve(selection.matched.count());
+    selection.matched.forEach([&rows](int row) {
+        rows.push_back(row);
+    });
+    if (!m_index.sortRows(&rows, sortKeys)) {
+        return false;
+    }
+
+    m_trackOrder.reserve(static_cast<int>(rows.size()));
+    for (const int row : rows) {
+        m_trackOrder.append(m_index.trackIdForRow(row));
+    }
+    return true;
+}
+
+void BaseTrackCache::filterAndSortInDatabase(
+        const QueryNode& query,
+        const QString& orderByClause) {
+    QString filter = query.toSql();
+    if (!filter.isEmpty()) {
+        filter.prepend("WHERE ");
+    }
+
+    QString queryString = QString("SELECT %1 FROM %2 %3 %4")
+            .arg(m_idColumn, m_tableName, filter, orderByClause);
+
+    if (sDebug) {
+        qDebug() << this << "select() executing:" << queryString;
+    }
+
+    QSqlQuery sqlQuery(m_database);
+    // This causes a memory savings since QSqlCachedResult (what QtSQLite uses)
+    // won't allocate a giant in-memory table that we won't use at all.
+    sqlQuery.setForwardOnly(true);
+    sqlQuery.prepare(queryString);
+
+    if (!sqlQuery.exec()) {
+        LOG_FAILED_QUERY(sqlQuery);
+    }
+
+    int idColumn = sqlQuery.record().indexOf(m_idColumn);
+    int rows = sqlQuery.size();
+
+    if (sDebug) {
+        qDebug() << "Rows returned:" << rows;
+    }
+
+    if (rows > 0) {
+        m_trackOrder.reserve(rows);
+    }
+
+    while (sqlQuery.next()) {
+        m_trackOrder.append(TrackId(sqlQuery.value(idColumn)));
+    }
+}
+
 int BaseTrackCache::findSortInsertionPoint(TrackPointer pTrack,
         const QList<SortColumn>& sortColumns,
         const int columnOffset,
@@ -11,11 +11,13 @@
 #include <memory>
 
 #include "library/columncache.h"
+#include "library/trackcacheindex.h"
 #include "track/track_decl.h"
 #include "track/trackid.h"
 #include "util/class.h"
 #include "util/string.h"
 
+class QueryNode;
 class SearchQueryParser;
 class TrackCollection;
 
@@ -35,6 +37,10 @@ class SortColumn {
 // waste of memory because all the table-models were caching the same data
 // (track properties). Furthermore, the base SQL tables of these table-models
 // involve complicated joins, which are very slow.
+//
+// filterAndSort() evaluates search queries and the sort order in memory with
+// a TrackCacheIndex and only falls back to querying the database for queries
+// that cannot be evaluated in memory, e.g. with an extra SQL filter.
 class BaseTrackCache : public QObject {
     Q_OBJECT
   public:
@@ -99,6 +105,17 @@ class BaseTrackCache : public QObject {
     void getTrackValueForColumn(TrackPointer pTrack, int column,
                                 QVariant& trackValue) const;
 
+    // Evaluates the query and the sort order in memory. Returns false if
+    // the query or the sort order cannot be evaluated by m_index.
+    bool filterAndSortInIndex(const QSet<TrackId>& trackIds,
+            const QueryNode& query,
+            const QString& orderByClause,
+            const QList<SortColumn>& sortColumns,
+            const int columnOffset);
+    void filterAndSortInDatabase(
+            const QueryNode& query,
+            const QString& orderByClause);
+
     int findSortInsertionPoint(TrackPointer pTrack,
                                const QList<SortColumn>& sortColumns,
                                const int columnOffset,
@@ -126,6 +143,10 @@ class BaseTrackCache : public QObject {
 
     const mixxx::StringCollator m_collator;
 
+    // Column oriented copy of m_trackInfo for filterAndSort(). Built on
+    // demand and updated together with m_trackInfo.
+    TrackCacheIndex m_index;
+
     QStringList m_searchColumns;
     QVector<int> m_searchColumnIndices;
 
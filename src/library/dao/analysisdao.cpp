@@ -17,6 +17,24 @@ const QString AnalysisDao::s_analysisTableName = "track_analysis";
 // CPU time so I think we should stick with the default. rryan 4/3/2012
 constexpr int kCompressionLevel = -1;
 
+namespace {
+
+// Uncompressed waveforms for memory-mapping are stored next to the
+// compressed analysis data
+const QString kMappedDataFileSuffix = QStringLiteral(".mapped");
+
+bool isWaveformAnalysis(AnalysisDao::AnalysisType type) {
+    return type == AnalysisDao::TYPE_WAVEFORM ||
+            type == AnalysisDao::TYPE_WAVESUMMARY;
+}
+
+QString mappedDataFilePath(const QDir& analysisPath, int analysisId) {
+    return analysisPath.absoluteFilePath(
+            QString::number(analysisId) + kMappedDataFileSuffix);
+}
+
+} // anonymous namespace
+
 AnalysisDao::AnalysisDao(UserSettingsPointer pConfig)
         : m_pConfig(pConfig) {
     QDir storagePath = getAnalysisStoragePath();
@@ -66,6 +84,9 @@ QList<AnalysisDao::AnalysisInfo> AnalysisDao::loadAnalysesFromQuery(TrackId trac
     }
 
     int bytes = 0;
+    int mappedCount = 0;
+    const bool mappedWaveformCacheEnabled =
+            WaveformSettings(m_pConfig).mappedWaveformCacheEnabled();
     QSqlRecord queryRecord = query->record();
     const int idColumn = queryRecord.indexOf("id");
     const int typeColumn = queryRecord.indexOf("type");
@@ -81,28 +102,30 @@ QList<AnalysisDao::AnalysisInfo> AnalysisDao::loadAnalysesFromQuery(TrackId trac
         info.type = static_cast<AnalysisType>(query->value(typeColumn).toInt());
         info.description = query->value(descriptionColumn).toString();
         info.version = query->value(versionColumn).toString();
-        int checksum = query->value(dataChecksumColumn).toInt();
-        QString dataPath = analysisPath.absoluteFilePath(
-            QString::number(info.analysisId));
-        const QByteArray compressedData = loadDataFromFile(dataPath);
-#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
-        const int file_checksum = qChecksum(
-                compressedData);
-#else
-        const int file_checksum = qChecksum(
-                compressedData.constData(),
-                compressedData.length());
-#endif
-        if (checksum != file_checksum) {
-            qDebug() << "WARNING: Corrupt analysis loaded from" << dataPath
-                     << "length" << compressedData.length();
+        info.dataPath = analysisPath.absoluteFilePath(
+                QString::number(info.analysisId));
+        info.dataChecksum = static_cast<quint32>(
+                query->value(dataChecksumColumn).toInt());
+        if (mappedWaveformCacheEnabled && isWaveformAnalysis(info.type)) {
+            // Outdated or missing files are (re-)created from the
+            // compressed data when loading the waveform. If mapping fails
+            // after this check the data is loaded from dataPath instead.
+            info.mappedDataPath = mappedDataFilePath(analysisPath, info.analysisId);
+            if (Waveform::isMappableFile(info.mappedDataPath, info.dataChecksum)) {
+                ++mappedCount;
+                analyses.append(info);
+                continue;
+            }
+        }
+        info.data = loadAnalysisData(info.dataPath, info.dataChecksum);
+        if (info.data.isEmpty()) {
             continue;
         }
-        info.data = qUncompress(compressedData);
         bytes += info.data.length();
         analyses.append(info);
     }
     qDebug() << "AnalysisDAO fetched" << analyses.size() << "analyses,"
+             << mappedCount << "mapped,"
              << bytes << "bytes for track"
              << trackId << "in" << time.elapsed().debugMillisWithUnit();
     return analyses;
@@ -176,6 +199,8 @@ bool AnalysisDao::saveAnalysis(AnalysisDao::AnalysisInfo* info) {
         qDebug() << "WARNING: Couldn't save analysis data to file" << dataPath;
         return false;
     }
+    // The checksum of the new data might collide with the old one
+    deleteFile(mappedDataFilePath(getAnalysisStoragePath(), info->analysisId));
 
     qDebug() << "AnalysisDAO saved analysis" << info->analysisId
              << QString("%1 (%2 compressed)").arg(QString::number(info->data.length()),
@@ -199,9 +224,11 @@ bool AnalysisDao::deleteAnalysis(const int analysisId) {
         return false;
     }
 
-    QString dataPath = getAnalysisStoragePath().absoluteFilePath(
+    const QDir analysisPath = getAnalysisStoragePath();
+    QString dataPath = analysisPath.absoluteFilePath(
         QString::number(analysisId));
     deleteFile(dataPath);
+    deleteFile(mappedDataFilePath(analysisPath, analysisId));
     return true;
 }
 
@@ -222,6 +249,7 @@ void AnalysisDao::deleteAnalyses(const QList<TrackId>& trackIds) {
         int id = query.value(idColumn).toInt();
         QString dataPath = analysisPath.absoluteFilePath(QString::number(id));
         deleteFile(dataPath);
+        deleteFile(mappedDataFilePath(analysisPath, id));
     }
     query.prepare(QString("DELETE FROM track_analysis "
                           "WHERE track_id in (%1)").arg(idList.join(",")));
@@ -262,7 +290,27 @@ QDir AnalysisDao::getAnalysisStoragePath() const {
     return dir.absolutePath().append("/");
 }
 
-QByteArray AnalysisDao::loadDataFromFile(const QString& filename) const {
+// static
+QByteArray AnalysisDao::loadAnalysisData(const QString& dataPath, quint32 dataChecksum) {
+    const QByteArray compressedData = loadDataFromFile(dataPath);
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+    const quint32 fileChecksum = qChecksum(
+            compressedData);
+#else
+    const quint32 fileChecksum = qChecksum(
+            compressedData.constData(),
+            compressedData.length());
+#endif
+    if (dataChecksum != fileChecksum) {
+        qDebug() << "WARNING: Corrupt analysis loaded from" << dataPath
+                 << "length" << compressedData.length();
+        return QByteArray();
+    }
+    return qUncompress(compressedData);
+}
+
+// static
+QByteArray AnalysisDao::loadDataFromFile(const QString& filename) {
     QFile file(filename);
     if (!file.exists()) {
         return QByteArray();
@@ -385,6 +433,12 @@ size_t AnalysisDao::getDiskUsageInBytes(
     while (query.next()) {
         total += QFileInfo(analysisPath.absoluteFilePath(
                 query.value(idColumn).toString())).size();
+        // Mapped files are sparse and usually occupy less space
+        const QFileInfo mappedFileInfo(mappedDataFilePath(
+                analysisPath, query.value(idColumn).toInt()));
+        if (mappedFileInfo.exists()) {
+            total += mappedFileInfo.size();
+        }
     }
     return total;
 }
@@ -407,6 +461,7 @@ bool AnalysisDao::deleteAnalysesByType(
     while (query.next()) {
         QString dataPath = analysisPath.absoluteFilePath(query.value(idColumn).toString());
         deleteFile(dataPath);
+        deleteFile(mappedDataFilePath(analysisPath, query.value(idColumn).toInt()));
     }
     query.prepare(QString("DELETE FROM %1 WHERE type=:type").arg(s_analysisTableName));
     query.bindValue(":type", type);
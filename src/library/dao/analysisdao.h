@@ -22,7 +22,8 @@ class AnalysisDao : public DAO {
     struct AnalysisInfo {
         AnalysisInfo()
                 : analysisId(-1),
-                  type(TYPE_UNKNOWN) {
+                  type(TYPE_UNKNOWN),
+                  dataChecksum(0) {
         }
         int analysisId;
         TrackId trackId;
@@ -30,8 +31,19 @@ class AnalysisDao : public DAO {
         QString description;
         QString version;
         QByteArray data;
+        // Path and checksum of the compressed data, see loadAnalysisData().
+        QString dataPath;
+        quint32 dataChecksum;
+        // Only set for waveforms if the mapped waveform cache is enabled.
+        // If the mapped file is already up-to-date data is not loaded and
+        // remains empty.
+        QString mappedDataPath;
     };
 
+    /// Loads and decompresses the data of an analysis. Returns an empty
+    /// array if the file is missing or does not match the checksum.
+    static QByteArray loadAnalysisData(const QString& dataPath, quint32 dataChecksum);
+
     explicit AnalysisDao(UserSettingsPointer pConfig);
     ~AnalysisDao() override = default;
 
@@ -59,7 +71,7 @@ class AnalysisDao : public DAO {
 
   private:
     QDir getAnalysisStoragePath() const;
-    QByteArray loadDataFromFile(const QString& fileName) const;
+    static QByteArray loadDataFromFile(const QString& fileName);
     bool saveDataToFile(const QString& fileName, const QByteArray& data) const;
     bool deleteFile(const QString& filename) const;
     QList<AnalysisInfo> loadAnalysesFromQuery(TrackId trackId, QSqlQuery* query);
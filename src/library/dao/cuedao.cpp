@@ -3,6 +3,7 @@
 #include <QVariant>
 #include <QtDebug>
 #include <QtSql>
+#include <algorithm>
 
 #include "engine/engine.h"
 #include "library/queryutil.h"
@@ -10,6 +11,7 @@
 #include "util/assert.h"
 #include "util/color/rgbcolor.h"
 #include "util/db/fwdsqlquery.h"
+#include "util/db/sqlite.h"
 #include "util/logger.h"
 #include "util/performancetimer.h"
 
@@ -17,6 +19,16 @@ namespace {
 
 const mixxx::Logger kLogger = mixxx::Logger("CueDAO");
 
+const QStringList kCueInsertColumns = {
+        QStringLiteral("track_id"),
+        QStringLiteral("type"),
+        QStringLiteral("position"),
+        QStringLiteral("length"),
+        QStringLiteral("hotcue"),
+        QStringLiteral("label"),
+        QStringLiteral("color"),
+};
+
 /// Wrap a `QString` label in a `QVariant`. The label column is not nullable,
 /// so this function also makes sure that the label an empty string, not null.
 inline const QVariant labelToQVariant(const QString& label) {
@@ -249,3 +261,44 @@ void CueDAO::saveTrackCues(
                 << trackId;
     }
 }
+
+bool CueDAO::insertNewTrackCues(
+        const QList<std::pair<TrackId, CuePointer>>& trackCues) const {
+    const int maxRows = mixxx::sqlite::maxRowsPerInsert(kCueInsertColumns.size());
+    QSqlQuery query(m_database);
+    int preparedRows = 0;
+    for (int first = 0; first < trackCues.size(); first += maxRows) {
+        const int rows = std::min(maxRows, static_cast<int>(trackCues.size()) - first);
+        // Only the statement for the last chunk needs to be prepared again
+        if (rows != preparedRows) {
+            query.prepare(QStringLiteral("INSERT INTO " CUE_TABLE " (%1) VALUES %2")
+                                  .arg(kCueInsertColumns.join(QChar(',')),
+                                          mixxx::sqlite::multiRowValuesPlaceholders(
+                                                  kCueInsertColumns, rows)));
+            preparedRows = rows;
+        }
+        for (int row = 0; row < rows; ++row) {
+            const auto& [trackId, pCue] = trackCues[first + row];
+            DEBUG_ASSERT(trackId.isValid());
+            DEBUG_ASSERT(pCue);
+            DEBUG_ASSERT(!pCue->getId().isValid());
+            const auto bind = [&query, row](const QString& column, const QVariant& value) {
+                query.bindValue(mixxx::sqlite::multiRowPlaceholder(column, row), value);
+            };
+            bind(QStringLiteral("track_id"), trackId.toVariant());
+            bind(QStringLiteral("type"), static_cast<int>(pCue->getType()));
+            bind(QStringLiteral("position"),
+                    pCue->getPosition().toEngineSamplePosMaybeInvalid());
+            bind(QStringLiteral("length"),
+                    pCue->getLengthFrames() * mixxx::kEngineChannelCount);
+            bind(QStringLiteral("hotcue"), pCue->getHotCue());
+            bind(QStringLiteral("label"), labelToQVariant(pCue->getLabel()));
+            bind(QStringLiteral("color"), mixxx::RgbColor::toQVariant(pCue->getColor()));
+        }
+        if (!query.exec()) {
+            LOG_FAILED_QUERY(query);
+            return false;
+        }
+    }
+    return true;
+}
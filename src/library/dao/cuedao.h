@@ -1,6 +1,7 @@
 #pragma once
 
 #include <QSqlDatabase>
+#include <utility>
 
 #include "library/dao/dao.h"
 #include "track/cue.h"
@@ -17,6 +18,9 @@ class CueDAO : public DAO {
     QList<CuePointer> getCuesForTrack(TrackId trackId) const;
 
     void saveTrackCues(TrackId trackId, const QList<CuePointer>& cueList) const;
+    /// Inserts the cues of newly added tracks with multi-row statements.
+    /// The ids of the inserted rows are not assigned to the cue objects.
+    bool insertNewTrackCues(const QList<std::pair<TrackId, CuePointer>>& trackCues) const;
     bool deleteCuesForTrack(TrackId trackId) const;
     bool deleteCuesForTracks(const QList<TrackId>& trackIds) const;
 
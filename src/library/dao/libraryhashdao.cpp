@@ -16,6 +16,15 @@ inline constexpr mixxx::cache_key_signed_t dbHash(mixxx::cache_key_t hash) {
     return mixxx::signedCacheKey(hash);
 }
 
+QVariant dbModifiedMillis(const ScannerFileStat& fileStat) {
+    return fileStat.isValid() ? QVariant(fileStat.modifiedMillis) : QVariant();
+}
+
+QVariant dbInode(const ScannerFileStat& fileStat) {
+    // Stored as a signed 64-bit integer like hash values
+    return fileStat.isValid() ? QVariant(static_cast<qint64>(fileStat.inode)) : QVariant();
+}
+
 } // anonymous namespace
 
 QHash<QString, mixxx::cache_key_t> LibraryHashDAO::getDirectoryHashes() {
@@ -36,6 +45,28 @@ QHash<QString, mixxx::cache_key_t> LibraryHashDAO::getDirectoryHashes() {
     return hashes;
 }
 
+QHash<QString, ScannerFileStat> LibraryHashDAO::getDirectoryStats() {
+    QSqlQuery query(m_database);
+    query.prepare("SELECT directory_path, directory_mtime_ms, directory_inode "
+                  "FROM LibraryHashes WHERE directory_mtime_ms IS NOT NULL");
+    QHash<QString, ScannerFileStat> dirStats;
+    if (!query.exec()) {
+        LOG_FAILED_QUERY(query);
+    }
+
+    const int directoryPathColumn = query.record().indexOf("directory_path");
+    const int mtimeColumn = query.record().indexOf("directory_mtime_ms");
+    const int inodeColumn = query.record().indexOf("directory_inode");
+    while (query.next()) {
+        ScannerFileStat dirStat;
+        dirStat.modifiedMillis = query.value(mtimeColumn).toLongLong();
+        dirStat.inode = static_cast<quint64>(query.value(inodeColumn).toLongLong());
+        dirStats.insert(query.value(directoryPathColumn).toString(), dirStat);
+    }
+
+    return dirStats;
+}
+
 mixxx::cache_key_t LibraryHashDAO::getDirectoryHash(const QString& dirPath) {
     //qDebug() << "LibraryHashDAO::getDirectoryHash" << QThread::currentThread() << m_database.connectionName();
     mixxx::cache_key_t hash = mixxx::invalidCacheKey();
@@ -59,14 +90,20 @@ mixxx::cache_key_t LibraryHashDAO::getDirectoryHash(const QString& dirPath) {
     return hash;
 }
 
-void LibraryHashDAO::saveDirectoryHash(const QString& dirPath, mixxx::cache_key_t hash) {
+void LibraryHashDAO::saveDirectoryHash(const QString& dirPath,
+        mixxx::cache_key_t hash,
+        const ScannerFileStat& dirStat) {
     //qDebug() << "LibraryHashDAO::saveDirectoryHash" << QThread::currentThread() << m_database.connectionName();
     QSqlQuery query(m_database);
-    query.prepare("INSERT INTO LibraryHashes (directory_path, hash, directory_deleted) "
-                    "VALUES (:directory_path, :hash, :directory_deleted)");
+    query.prepare("INSERT INTO LibraryHashes (directory_path, hash, directory_deleted, "
+                  "directory_mtime_ms, directory_inode) "
+                  "VALUES (:directory_path, :hash, :directory_deleted, "
+                  ":directory_mtime_ms, :directory_inode)");
     query.bindValue(":directory_path", dirPath);
     query.bindValue(":hash", dbHash(hash));
     query.bindValue(":directory_deleted", 0);
+    query.bindValue(":directory_mtime_ms", dbModifiedMillis(dirStat));
+    query.bindValue(":directory_inode", dbInode(dirStat));
 
     if (!query.exec()) {
         LOG_FAILED_QUERY(query) << "Creating new dirhash failed.";
@@ -75,18 +112,22 @@ void LibraryHashDAO::saveDirectoryHash(const QString& dirPath, mixxx::cache_key_
 }
 
 void LibraryHashDAO::updateDirectoryHash(const QString& dirPath,
-                                         mixxx::cache_key_t newHash,
-                                         int dir_deleted) {
+        mixxx::cache_key_t newHash,
+        int dir_deleted,
+        const ScannerFileStat& dirStat) {
     //qDebug() << "LibraryHashDAO::updateDirectoryHash" << QThread::currentThread() << m_database.connectionName();
     QSqlQuery query(m_database);
     // By definition if we have calculated a new hash for a directory then it
     // exists and no longer needs verification.
     query.prepare("UPDATE LibraryHashes "
             "SET hash=:hash, directory_deleted=:directory_deleted, "
-            "needs_verification=0 "
+            "needs_verification=0, "
+            "directory_mtime_ms=:directory_mtime_ms, directory_inode=:directory_inode "
             "WHERE directory_path=:directory_path");
     query.bindValue(":hash", dbHash(newHash));
     query.bindValue(":directory_deleted", dir_deleted);
+    query.bindValue(":directory_mtime_ms", dbModifiedMillis(dirStat));
+    query.bindValue(":directory_inode", dbInode(dirStat));
     query.bindValue(":directory_path", dirPath);
 
     if (!query.exec()) {
@@ -98,6 +139,20 @@ void LibraryHashDAO::updateDirectoryHash(const QString& dirPath,
     //qDebug() << getDirectoryHash(dirPath);
 }
 
+void LibraryHashDAO::updateDirectoryStat(const QString& dirPath,
+        const ScannerFileStat& dirStat) {
+    QSqlQuery query(m_database);
+    query.prepare("UPDATE LibraryHashes "
+            "SET directory_mtime_ms=:directory_mtime_ms, directory_inode=:directory_inode "
+            "WHERE directory_path=:directory_path");
+    query.bindValue(":directory_mtime_ms", dbModifiedMillis(dirStat));
+    query.bindValue(":directory_inode", dbInode(dirStat));
+    query.bindValue(":directory_path", dirPath);
+    if (!query.exec()) {
+        LOG_FAILED_QUERY(query) << "Updating directory stat failed.";
+    }
+}
+
 void LibraryHashDAO::updateDirectoryStatuses(const QStringList& dirPaths,
                                              const bool deleted,
                                              const bool verified) {
@@ -144,6 +199,31 @@ void LibraryHashDAO::invalidateAllDirectories() {
     }
 }
 
+void LibraryHashDAO::invalidateDirectories(const QStringList& dirPaths) {
+    QSqlQuery query(m_database);
+    query.prepare("UPDATE LibraryHashes "
+                  "SET needs_verification=1 "
+                  "WHERE directory_path=:directory_path");
+    QSqlQuery subdirQuery(m_database);
+    subdirQuery.prepare("UPDATE LibraryHashes "
+                        "SET needs_verification=1 "
+                        "WHERE INSTR(directory_path,:directory_path_prefix)=1");
+    for (const auto& dirPath : dirPaths) {
+        query.bindValue(":directory_path", dirPath);
+        if (!query.exec()) {
+            LOG_FAILED_QUERY(query)
+                    << "Couldn't mark directory as needing verification.";
+        }
+        if (!QDir(dirPath).exists()) {
+            subdirQuery.bindValue(":directory_path_prefix", dirPath + '/');
+            if (!subdirQuery.exec()) {
+                LOG_FAILED_QUERY(subdirQuery)
+                        << "Couldn't mark subdirectories as needing verification.";
+            }
+        }
+    }
+}
+
 void LibraryHashDAO::markUnverifiedDirectoriesAsDeleted() {
     //qDebug() << "LibraryHashDAO::markUnverifiedDirectoriesAsDeleted"
     //<< QThread::currentThread() << m_database.connectionName();
@@ -6,6 +6,7 @@
 #include <QSqlDatabase>
 
 #include "library/dao/dao.h"
+#include "library/scanner/scannerutil.h"
 #include "util/cache.h"
 
 class LibraryHashDAO : public DAO {
@@ -13,12 +14,24 @@ class LibraryHashDAO : public DAO {
     ~LibraryHashDAO() override = default;
 
     QHash<QString, mixxx::cache_key_t> getDirectoryHashes();
+    // The file system stats of all directories that have been stored
+    // by an incremental scan.
+    QHash<QString, ScannerFileStat> getDirectoryStats();
     mixxx::cache_key_t getDirectoryHash(const QString& dirPath);
-    void saveDirectoryHash(const QString& dirPath, mixxx::cache_key_t hash);
-    void updateDirectoryHash(const QString& dirPath, mixxx::cache_key_t newHash,
-                             int dir_deleted);
+    void saveDirectoryHash(const QString& dirPath,
+            mixxx::cache_key_t hash,
+            const ScannerFileStat& dirStat = ScannerFileStat());
+    void updateDirectoryHash(const QString& dirPath,
+            mixxx::cache_key_t newHash,
+            int dir_deleted,
+            const ScannerFileStat& dirStat = ScannerFileStat());
+    void updateDirectoryStat(const QString& dirPath, const ScannerFileStat& dirStat);
     void markAsExisting(const QString& dirPath);
     void invalidateAllDirectories();
+    // Marks the given directories as needing verification. For
+    // directories that do not exist anymore all subdirectories are
+    // marked, too.
+    void invalidateDirectories(const QStringList& dirPaths);
     void markUnverifiedDirectoriesAsDeleted();
     void removeDeletedDirectoryHashes();
     void updateDirectoryStatuses(const QStringList& dirPaths,
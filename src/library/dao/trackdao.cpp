@@ -7,6 +7,8 @@
 #include <QImage>
 #include <QtDebug>
 #include <QtSql>
+#include <algorithm>
+#include <utility>
 
 #ifdef __SQLITE3__
 #include <sqlite3.h>
@@ -39,6 +41,7 @@
 #include "util/fileinfo.h"
 #include "util/logger.h"
 #include "util/math.h"
+#include "util/performancetimer.h"
 #include "util/qt.h"
 #include "util/timer.h"
 
@@ -62,13 +65,118 @@ void markTrackLocationsAsDeleted(const QSqlDatabase& database, const QString& di
     }
 }
 
-QString joinTrackIdList(const QSet<TrackId>& trackIds) {
-    QStringList trackIdList;
-    trackIdList.reserve(trackIds.size());
+/// Sets of track ids are passed to queries through this temporary table.
+/// Splicing them into the SQL statement could exceed the maximum length
+/// of a statement (SQLITE_MAX_SQL_LENGTH) for large sets.
+const QString kTrackIdsTempTable = QStringLiteral("temp_track_ids");
+
+void dropTrackIdsTempTable(const QSqlDatabase& database) {
+    QSqlQuery query(database);
+    query.prepare(QStringLiteral("DROP TABLE IF EXISTS %1").arg(kTrackIdsTempTable));
+    if (!query.exec()) {
+        LOG_FAILED_QUERY(query);
+    }
+}
+
+bool createTrackIdsTempTable(
+        const QSqlDatabase& database,
+        const QSet<TrackId>& trackIds) {
+    // Left over from a previous failure
+    dropTrackIdsTempTable(database);
+    QSqlQuery query(database);
+    query.prepare(QStringLiteral("CREATE TEMP TABLE %1 (id INTEGER PRIMARY KEY)")
+                          .arg(kTrackIdsTempTable));
+    if (!query.exec()) {
+        LOG_FAILED_QUERY(query);
+        return false;
+    }
+    query.prepare(QStringLiteral("INSERT INTO %1 (id) VALUES (:id)")
+                          .arg(kTrackIdsTempTable));
     for (const auto& trackId : trackIds) {
-        trackIdList.append(trackId.toString());
+        query.bindValue(":id", trackId.toVariant());
+        if (!query.exec()) {
+            LOG_FAILED_QUERY(query);
+            dropTrackIdsTempTable(database);
+            return false;
+        }
     }
-    return trackIdList.join(QChar(','));
+    return true;
+}
+
+const QStringList kTrackLocationInsertColumns = {
+        QStringLiteral("location"),
+        QStringLiteral("directory"),
+        QStringLiteral("filename"),
+        QStringLiteral("filesize"),
+        QStringLiteral("fs_deleted"),
+        QStringLiteral("needs_verification"),
+        QStringLiteral("fs_mtime_ms"),
+        QStringLiteral("fs_inode"),
+};
+
+const QStringList kLibraryInsertColumns = {
+        QStringLiteral("artist"),
+        QStringLiteral("title"),
+        QStringLiteral("album"),
+        QStringLiteral("album_artist"),
+        QStringLiteral("year"),
+        QStringLiteral("genre"),
+        QStringLiteral("tracknumber"),
+        QStringLiteral("tracktotal"),
+        QStringLiteral("composer"),
+        QStringLiteral("grouping"),
+        QStringLiteral("filetype"),
+        QStringLiteral("location"),
+        QStringLiteral("color"),
+        QStringLiteral("comment"),
+        QStringLiteral("url"),
+        QStringLiteral("rating"),
+        QStringLiteral("key"),
+        QStringLiteral("key_id"),
+        QStringLiteral("cuepoint"),
+        QStringLiteral("bpm"),
+        QStringLiteral("replaygain"),
+        QStringLiteral("replaygain_peak"),
+        QStringLiteral("wavesummaryhex"),
+        QStringLiteral("timesplayed"),
+        QStringLiteral("last_played_at"),
+        QStringLiteral("played"),
+        QStringLiteral("mixxx_deleted"),
+        QStringLiteral("header_parsed"),
+        QStringLiteral("source_synchronized_ms"),
+        QStringLiteral("channels"),
+        QStringLiteral("samplerate"),
+        QStringLiteral("bitrate"),
+        QStringLiteral("duration"),
+        QStringLiteral("beats_version"),
+        QStringLiteral("beats_sub_version"),
+        QStringLiteral("beats"),
+        QStringLiteral("bpm_lock"),
+        QStringLiteral("keys_version"),
+        QStringLiteral("keys_sub_version"),
+        QStringLiteral("keys"),
+        QStringLiteral("coverart_source"),
+        QStringLiteral("coverart_type"),
+        QStringLiteral("coverart_location"),
+        QStringLiteral("coverart_color"),
+        QStringLiteral("coverart_digest"),
+        QStringLiteral("coverart_hash"),
+        QStringLiteral("datetime_added"),
+};
+
+/// Tracks that are added by addTrackRecords() are committed in
+/// transactions of this size.
+constexpr int kBulkInsertRowsPerTransaction = 10000;
+
+/// The maximum number of values in the IN list of a SELECT statement
+/// to stay well below the maximum length of an SQL statement.
+constexpr int kMaxValuesPerSelect = 500;
+
+QString singleRowInsertStatement(const QString& table, const QStringList& columns) {
+    return QStringLiteral("INSERT INTO %1 (%2) VALUES (:%3)")
+            .arg(table,
+                    columns.join(QChar(',')),
+                    columns.join(QStringLiteral(",:")));
 }
 
 QString locationPathPrefixFromRootDir(const QDir& rootDir) {
@@ -202,10 +310,6 @@ QList<TrackId> TrackDAO::resolveTrackIds(
     }
 
     if (flags & ResolveTrackIdFlag::AddMissing) {
-        // Prepare to add tracks to the database.
-        // This also begins an SQL transaction.
-        addTracksPrepare();
-
         // Any tracks not already in the database need to be added.
         query.prepare("SELECT location FROM playlist_import "
                 "WHERE NOT EXISTS (SELECT location FROM track_locations "
@@ -215,13 +319,18 @@ QList<TrackId> TrackDAO::resolveTrackIds(
             DEBUG_ASSERT(!"Failed query");
         }
         const int locationColumn = query.record().indexOf("location");
+        std::vector<NewTrackRecord> records;
         while (query.next()) {
-            QString location = query.value(locationColumn).toString();
-            addTracksAddFile(location, true);
+            auto record = importNewTrackRecord(
+                    mixxx::FileInfo(query.value(locationColumn).toString()));
+            if (record) {
+                records.push_back(std::move(*record));
+            }
         }
 
-        // Finish adding tracks to the database.
-        addTracksFinish();
+        // None of these tracks is in the database yet, i.e. they are
+        // not loaded and can be added at once.
+        addTrackRecords(records, true);
     }
 
     query.prepare(
@@ -285,6 +394,33 @@ QSet<QString> TrackDAO::getAllTrackLocations() const {
 
 // Some code (eg. drag and drop) needs to just get a track's location, and it's
 // not worth retrieving a whole Track.
+QHash<QString, ScannerFileStat> TrackDAO::getAllTrackLocationStats() const {
+    QHash<QString, ScannerFileStat> fileStats;
+    QSqlQuery query(m_database);
+    query.prepare("SELECT track_locations.location, track_locations.filesize, "
+                  "track_locations.fs_mtime_ms, track_locations.fs_inode "
+                  "FROM track_locations "
+                  "INNER JOIN library on library.location = track_locations.id "
+                  "WHERE track_locations.fs_mtime_ms IS NOT NULL");
+    if (!query.exec()) {
+        LOG_FAILED_QUERY(query);
+        DEBUG_ASSERT(!"Failed query");
+    }
+
+    const int locationColumn = query.record().indexOf("location");
+    const int filesizeColumn = query.record().indexOf("filesize");
+    const int mtimeColumn = query.record().indexOf("fs_mtime_ms");
+    const int inodeColumn = query.record().indexOf("fs_inode");
+    while (query.next()) {
+        ScannerFileStat fileStat;
+        fileStat.modifiedMillis = query.value(mtimeColumn).toLongLong();
+        fileStat.sizeInBytes = query.value(filesizeColumn).toLongLong();
+        fileStat.inode = static_cast<quint64>(query.value(inodeColumn).toLongLong());
+        fileStats.insert(query.value(locationColumn).toString(), fileStat);
+    }
+    return fileStats;
+}
+
 QString TrackDAO::getTrackLocation(TrackId trackId) const {
     qDebug() << "TrackDAO::getTrackLocation"
              << QThread::currentThread() << m_database.connectionName();
@@ -307,6 +443,46 @@ QString TrackDAO::getTrackLocation(TrackId trackId) const {
     return trackLocation;
 }
 
+QHash<TrackId, std::pair<mixxx::Duration, QString>> TrackDAO::getTrackDurationsAndFileTypes(
+        const QSet<TrackId>& trackIds) const {
+    QHash<TrackId, std::pair<mixxx::Duration, QString>> result;
+    if (trackIds.isEmpty()) {
+        return result;
+    }
+    result.reserve(trackIds.size());
+    // The ids are bound in chunks to stay below the limits for the
+    // length of SQL statements and the number of bound values
+    const QList<TrackId> trackIdList = trackIds.values();
+    for (int chunk = 0; chunk < trackIdList.size(); chunk += kMaxValuesPerSelect) {
+        const QList<TrackId> chunkTrackIds = trackIdList.mid(chunk, kMaxValuesPerSelect);
+        QStringList placeholders;
+        placeholders.reserve(chunkTrackIds.size());
+        for (int i = 0; i < chunkTrackIds.size(); ++i) {
+            placeholders.append(QStringLiteral("?"));
+        }
+        QSqlQuery query(m_database);
+        query.prepare(QStringLiteral("SELECT %1,%2,%3 FROM library WHERE %1 IN (%4)")
+                              .arg(LIBRARYTABLE_ID,
+                                      LIBRARYTABLE_DURATION,
+                                      LIBRARYTABLE_FILETYPE,
+                                      placeholders.join(QChar(','))));
+        for (const auto& trackId : chunkTrackIds) {
+            query.addBindValue(trackId.toVariant());
+        }
+        if (!query.exec()) {
+            LOG_FAILED_QUERY(query);
+            return result;
+        }
+        while (query.next()) {
+            result.insert(TrackId(query.value(0)),
+                    std::make_pair(
+                            mixxx::Duration::fromSeconds(query.value(1).toDouble()),
+                            query.value(2).toString()));
+        }
+    }
+    return result;
+}
+
 bool TrackDAO::saveTrack(Track* pTrack) const {
     VERIFY_OR_DEBUG_ASSERT(pTrack) {
         return false;
@@ -380,114 +556,17 @@ void TrackDAO::addTracksPrepare() {
     m_pQueryLibraryUpdate = std::make_unique<QSqlQuery>(m_database);
     m_pQueryLibrarySelect = std::make_unique<QSqlQuery>(m_database);
 
-    m_pQueryTrackLocationInsert->prepare("INSERT INTO track_locations "
-            "("
-            "location,directory,filename,filesize,fs_deleted,needs_verification"
-            ") VALUES ("
-            ":location,:directory,:filename,:filesize,:fs_deleted,:needs_verification"
-            ")");
+    m_pQueryTrackLocationInsert->prepare(
+            singleRowInsertStatement(
+                    QStringLiteral("track_locations"),
+                    kTrackLocationInsertColumns));
 
     m_pQueryTrackLocationSelect->prepare("SELECT id FROM track_locations WHERE location=:location");
 
     m_pQueryLibraryInsert->prepare(
-            "INSERT INTO library "
-            "("
-            "artist,"
-            "title,"
-            "album,"
-            "album_artist,"
-            "year,"
-            "genre,"
-            "tracknumber,"
-            "tracktotal,"
-            "composer,"
-            "grouping,"
-            "filetype,"
-            "location,"
-            "color,"
-            "comment,"
-            "url,"
-            "rating,"
-            "key,"
-            "key_id,"
-            "cuepoint,"
-            "bpm,"
-            "replaygain,"
-            "replaygain_peak,"
-            "wavesummaryhex,"
-            "timesplayed,"
-            "last_played_at,"
-            "played,"
-            "mixxx_deleted,"
-            "header_parsed,"
-            "source_synchronized_ms,"
-            "channels,"
-            "samplerate,"
-            "bitrate,"
-            "duration,"
-            "beats_version,"
-            "beats_sub_version,"
-            "beats,"
-            "bpm_lock,"
-            "keys_version,"
-            "keys_sub_version,"
-            "keys,"
-            "coverart_source,"
-            "coverart_type,"
-            "coverart_location,"
-            "coverart_color,"
-            "coverart_digest,"
-            "coverart_hash,"
-            "datetime_added"
-            ") VALUES ("
-            ":artist,"
-            ":title,"
-            ":album,"
-            ":album_artist,"
-            ":year,"
-            ":genre,"
-            ":tracknumber,"
-            ":tracktotal,"
-            ":composer,"
-            ":grouping,"
-            ":filetype,"
-            ":location,"
-            ":color,"
-            ":comment,"
-            ":url,"
-            ":rating,"
-            ":key,"
-            ":key_id,"
-            ":cuepoint,"
-            ":bpm,"
-            ":replaygain,"
-            ":replaygain_peak,"
-            ":wavesummaryhex,"
-            ":timesplayed,"
-            ":last_played_at,"
-            ":played,"
-            ":mixxx_deleted,"
-            ":header_parsed,"
-            ":source_synchronized_ms,"
-            ":channels,"
-            ":samplerate,"
-            ":bitrate,"
-            ":duration,"
-            ":beats_version,"
-            ":beats_sub_version,"
-            ":beats,"
-            ":bpm_lock,"
-            ":keys_version,"
-            ":keys_sub_version,"
-            ":keys,"
-            ":coverart_source,"
-            ":coverart_type,"
-            ":coverart_location,"
-            ":coverart_color,"
-            ":coverart_digest,"
-            ":coverart_hash,"
-            ":datetime_added"
-            ")");
+            singleRowInsertStatement(
+                    QStringLiteral("library"),
+                    kLibraryInsertColumns));
 
     m_pQueryLibraryUpdate->prepare("UPDATE library SET mixxx_deleted = 0 "
             "WHERE id=:id");
@@ -517,16 +596,58 @@ void TrackDAO::addTracksFinish(bool rollback) {
 
 namespace {
 
-bool insertTrackLocation(
-        QSqlQuery* pTrackLocationInsert,
+/// Binds the values of a single row of a multi-row INSERT statement
+/// by the placeholders of the corresponding single-row statement.
+class MultiRowBinder final {
+  public:
+    MultiRowBinder(QSqlQuery* pQuery, int row)
+            : m_pQuery(pQuery),
+              m_suffix(QChar('_') + QString::number(row)) {
+    }
+
+    void bindValue(const QString& placeholder, const QVariant& value) {
+        m_pQuery->bindValue(placeholder + m_suffix, value);
+    }
+
+  private:
+    QSqlQuery* const m_pQuery;
+    const QString m_suffix;
+};
+
+// The values are bound either to a QSqlQuery or to a MultiRowBinder
+template<typename Binder>
+void bindTrackLocationStat(
+        Binder* pTrackLocationQuery,
+        const ScannerFileStat& fileStat) {
+    if (fileStat.isValid()) {
+        pTrackLocationQuery->bindValue(":fs_mtime_ms", fileStat.modifiedMillis);
+        // Stored as a signed 64-bit integer
+        pTrackLocationQuery->bindValue(":fs_inode", static_cast<qint64>(fileStat.inode));
+    } else {
+        pTrackLocationQuery->bindValue(":fs_mtime_ms", QVariant());
+        pTrackLocationQuery->bindValue(":fs_inode", QVariant());
+    }
+}
+
+template<typename Binder>
+void bindTrackLocationValues(
+        Binder* pTrackLocationInsert,
         const mixxx::FileInfo& fileInfo) {
-    DEBUG_ASSERT(pTrackLocationInsert);
     pTrackLocationInsert->bindValue(":location", fileInfo.location());
     pTrackLocationInsert->bindValue(":directory", fileInfo.locationPath());
     pTrackLocationInsert->bindValue(":filename", fileInfo.fileName());
     pTrackLocationInsert->bindValue(":filesize", fileInfo.sizeInBytes());
     pTrackLocationInsert->bindValue(":fs_deleted", 0);
     pTrackLocationInsert->bindValue(":needs_verification", 0);
+    bindTrackLocationStat(pTrackLocationInsert,
+            ScannerFileStat::fromPath(fileInfo.location()));
+}
+
+bool insertTrackLocation(
+        QSqlQuery* pTrackLocationInsert,
+        const mixxx::FileInfo& fileInfo) {
+    DEBUG_ASSERT(pTrackLocationInsert);
+    bindTrackLocationValues(pTrackLocationInsert, fileInfo);
     if (pTrackLocationInsert->exec()) {
         return true;
     } else {
@@ -537,8 +658,9 @@ bool insertTrackLocation(
 }
 
 // Bind common values for insert/update
+template<typename Binder>
 void bindTrackLibraryValues(
-        QSqlQuery* pTrackLibraryQuery,
+        Binder* pTrackLibraryQuery,
         const mixxx::TrackRecord& track,
         const mixxx::BeatsPointer& pBeats) {
     const mixxx::TrackMetadata& trackMetadata = track.getMetadata();
@@ -642,21 +764,16 @@ void bindTrackLibraryValues(
     pTrackLibraryQuery->bindValue(":key", keyText);
 }
 
-bool insertTrackLibrary(
-        QSqlQuery* pTrackLibraryInsert,
+// Bind all values for inserting a new track
+template<typename Binder>
+void bindNewTrackLibraryValues(
+        Binder* pTrackLibraryInsert,
         const mixxx::TrackRecord& trackRecord,
         const mixxx::BeatsPointer& pBeats,
         DbId trackLocationId,
-        const mixxx::FileInfo& fileInfo,
         const QDateTime& trackDateAdded) {
     bindTrackLibraryValues(pTrackLibraryInsert, trackRecord, pBeats);
 
-    if (!trackRecord.getDateAdded().isNull()) {
-        qDebug() << "insertTrackLibrary: Track"
-                 << fileInfo
-                 << "was added"
-                 << trackRecord.getDateAdded();
-    }
     pTrackLibraryInsert->bindValue(":datetime_added", trackDateAdded);
 
     // Written only once upon insert
@@ -673,6 +790,27 @@ bool insertTrackLibrary(
 #else
     pTrackLibraryInsert->bindValue(":wavesummaryhex", QVariant(QVariant::ByteArray));
 #endif
+}
+
+bool insertTrackLibrary(
+        QSqlQuery* pTrackLibraryInsert,
+        const mixxx::TrackRecord& trackRecord,
+        const mixxx::BeatsPointer& pBeats,
+        DbId trackLocationId,
+        const mixxx::FileInfo& fileInfo,
+        const QDateTime& trackDateAdded) {
+    if (!trackRecord.getDateAdded().isNull()) {
+        qDebug() << "insertTrackLibrary: Track"
+                 << fileInfo
+                 << "was added"
+                 << trackRecord.getDateAdded();
+    }
+    bindNewTrackLibraryValues(
+            pTrackLibraryInsert,
+            trackRecord,
+            pBeats,
+            trackLocationId,
+            trackDateAdded);
 
     if (!pTrackLibraryInsert->exec()) {
         // We failed to insert the track. Maybe it is already in the library
@@ -827,7 +965,8 @@ TrackId TrackDAO::addTracksAddTrack(const TrackPointer& pTrack, bool unremove) {
 
 TrackPointer TrackDAO::addTracksAddFile(
         const mixxx::FileAccess& fileAccess,
-        bool unremove) {
+        bool unremove,
+        const SoundSourceProxy::ImportedMetadata* pImportedMetadata) {
     // Check that track is a supported extension.
     // TODO(uklotzde): The following check can be skipped if
     // the track is already in the library. A refactoring is
@@ -877,7 +1016,8 @@ TrackPointer TrackDAO::addTracksAddFile(
     // from the file.
     SoundSourceProxy(pTrack).updateTrackFromSource(
             SoundSourceProxy::UpdateTrackFromSourceMode::Once,
-            SyncTrackMetadataParams::readFromUserSettings(*m_pConfig));
+            SyncTrackMetadataParams::readFromUserSettings(*m_pConfig),
+            pImportedMetadata);
     if (!pTrack->checkSourceSynchronized()) {
         qWarning() << "TrackDAO::addTracksAddFile:"
                 << "Failed to parse track metadata from file"
@@ -909,6 +1049,295 @@ TrackPointer TrackDAO::addTracksAddFile(
     return pTrack;
 }
 
+std::optional<TrackDAO::NewTrackRecord> TrackDAO::importNewTrackRecord(
+        mixxx::FileInfo fileInfo) const {
+    if (!SoundSourceProxy::isFileSupported(fileInfo)) {
+        qWarning() << "TrackDAO::importNewTrackRecord:"
+                   << "Unsupported file type"
+                   << fileInfo.location();
+        return std::nullopt;
+    }
+    if (!fileInfo.checkFileExists()) {
+        qWarning() << "TrackDAO::importNewTrackRecord:"
+                   << "File not found"
+                   << fileInfo.location();
+        return std::nullopt;
+    }
+    // Import the metadata into a temporary track object that is not
+    // cached to reuse all the conversions of addTracksAddFile()
+    const TrackPointer pTrack = Track::newTemporary(mixxx::FileAccess(fileInfo));
+    SoundSourceProxy(pTrack).updateTrackFromSource(
+            SoundSourceProxy::UpdateTrackFromSourceMode::Once,
+            SyncTrackMetadataParams::readFromUserSettings(*m_pConfig));
+    if (!pTrack->checkSourceSynchronized()) {
+        qWarning() << "TrackDAO::importNewTrackRecord:"
+                   << "Failed to parse track metadata from file"
+                   << fileInfo.location();
+        // Continue with adding the track to the library, no matter
+        // if parsing the metadata from file succeeded or failed.
+    }
+    NewTrackRecord record;
+    record.fileInfo = std::move(fileInfo);
+    record.trackRecord = pTrack->getRecord();
+    record.pBeats = pTrack->getBeats();
+    record.cuePoints = pTrack->getCuePoints();
+    return record;
+}
+
+QList<TrackId> TrackDAO::addTrackRecords(
+        const std::vector<NewTrackRecord>& records,
+        bool unremove) {
+    VERIFY_OR_DEBUG_ASSERT(!m_pTransaction) {
+        kLogger.warning()
+                << "Cannot add track records while adding tracks";
+        return QList<TrackId>();
+    }
+    PerformanceTimer timer;
+    timer.start();
+
+    QList<TrackId> trackIds;
+    trackIds.reserve(static_cast<int>(records.size()));
+    for (std::size_t i = 0; i < records.size(); ++i) {
+        trackIds.append(TrackId());
+    }
+
+    int addedTrackCount = 0;
+    const int recordCount = static_cast<int>(records.size());
+    for (int first = 0; first < recordCount; first += kBulkInsertRowsPerTransaction) {
+        const int last = std::min(first + kBulkInsertRowsPerTransaction, recordCount);
+        QSet<TrackId> addedTrackIds;
+        SqlTransaction transaction(m_database);
+        if (!addTrackRecordsInTransaction(
+                    records, first, last, unremove, &trackIds, &addedTrackIds) ||
+                !transaction.commit()) {
+            transaction.rollback();
+            for (int i = first; i < recordCount; ++i) {
+                trackIds[i] = TrackId();
+            }
+            kLogger.warning()
+                    << "Failed to add track records"
+                    << first
+                    << "to"
+                    << recordCount;
+            break;
+        }
+        addedTrackCount += addedTrackIds.size();
+        if (!addedTrackIds.isEmpty()) {
+            emit tracksAdded(addedTrackIds);
+        }
+    }
+
+    const auto elapsed = timer.elapsed();
+    const double elapsedSeconds = elapsed.toDoubleSeconds();
+    kLogger.info()
+            << "Added"
+            << addedTrackCount
+            << "of"
+            << recordCount
+            << "track records in"
+            << elapsed.debugMillisWithUnit()
+            << QStringLiteral("(%1 rows/s)")
+                       .arg(elapsedSeconds > 0
+                                       ? static_cast<int>(recordCount / elapsedSeconds)
+                                       : recordCount);
+    return trackIds;
+}
+
+bool TrackDAO::addTrackRecordsInTransaction(
+        const std::vector<NewTrackRecord>& records,
+        int first,
+        int last,
+        bool unremove,
+        QList<TrackId>* pTrackIds,
+        QSet<TrackId>* pAddedTrackIds) {
+    DEBUG_ASSERT(pTrackIds);
+    DEBUG_ASSERT(pAddedTrackIds);
+
+    // Records with duplicate locations are only added once
+    QHash<QString, int> recordsByLocation;
+    QList<int> uniqueRecords;
+    for (int i = first; i < last; ++i) {
+        const QString location = records[i].fileInfo.location();
+        if (!recordsByLocation.contains(location)) {
+            recordsByLocation.insert(location, i);
+            uniqueRecords.append(i);
+        }
+    }
+
+    // Insert all track locations. Existing rows are kept as is.
+    {
+        const int maxRows = mixxx::sqlite::maxRowsPerInsert(
+                kTrackLocationInsertColumns.size());
+        QSqlQuery query(m_database);
+        int preparedRows = 0;
+        for (int chunk = 0; chunk < uniqueRecords.size(); chunk += maxRows) {
+            const int rows = std::min(maxRows,
+                    static_cast<int>(uniqueRecords.size()) - chunk);
+            if (rows != preparedRows) {
+                query.prepare(QStringLiteral(
+                        "INSERT OR IGNORE INTO track_locations (%1) VALUES %2")
+                                      .arg(kTrackLocationInsertColumns.join(QChar(',')),
+                                              mixxx::sqlite::multiRowValuesPlaceholders(
+                                                      kTrackLocationInsertColumns,
+                                                      rows)));
+                preparedRows = rows;
+            }
+            for (int row = 0; row < rows; ++row) {
+                MultiRowBinder binder(&query, row);
+                bindTrackLocationValues(
+                        &binder,
+                        records[uniqueRecords[chunk + row]].fileInfo);
+            }
+            if (!query.exec()) {
+                LOG_FAILED_QUERY(query);
+                return false;
+            }
+        }
+    }
+
+    // Resolve the ids of all track locations and of existing tracks at
+    // once instead of querying them for each track
+    QHash<DbId, int> recordsByLocationId;
+    QStringList locationIds;
+    for (int chunk = 0; chunk < uniqueRecords.size(); chunk += kMaxValuesPerSelect) {
+        QStringList locations;
+        for (int i = chunk;
+                i < std::min(chunk + kMaxValuesPerSelect,
+                        static_cast<int>(uniqueRecords.size()));
+                ++i) {
+            locations.append(records[uniqueRecords[i]].fileInfo.location());
+        }
+        QSqlQuery query(m_database);
+        query.prepare(QStringLiteral(
+                "SELECT id,location FROM track_locations WHERE location IN (%1)")
+                              .arg(SqlStringFormatter::formatList(m_database, locations)));
+        if (!query.exec()) {
+            LOG_FAILED_QUERY(query);
+            return false;
+        }
+        while (query.next()) {
+            const DbId locationId(query.value(0));
+            recordsByLocationId.insert(
+                    locationId,
+                    recordsByLocation.value(query.value(1).toString()));
+            locationIds.append(locationId.toString());
+        }
+    }
+    VERIFY_OR_DEBUG_ASSERT(recordsByLocationId.size() == uniqueRecords.size()) {
+        return false;
+    }
+
+    // Tracks that are already in the library are skipped
+    QList<TrackId> hiddenTrackIds;
+    for (int chunk = 0; chunk < locationIds.size(); chunk += kMaxValuesPerSelect) {
+        QSqlQuery query(m_database);
+        query.prepare(QStringLiteral(
+                "SELECT id,location,mixxx_deleted FROM library WHERE location IN (%1)")
+                              .arg(locationIds.mid(chunk, kMaxValuesPerSelect)
+                                              .join(QChar(','))));
+        if (!query.exec()) {
+            LOG_FAILED_QUERY(query);
+            return false;
+        }
+        while (query.next()) {
+            const TrackId trackId(query.value(0));
+            const int record = recordsByLocationId.take(DbId(query.value(1)));
+            (*pTrackIds)[record] = trackId;
+            if (query.value(2).toBool()) {
+                hiddenTrackIds.append(trackId);
+            }
+        }
+    }
+    if (unremove && !hiddenTrackIds.isEmpty() && !unhideTracks(hiddenTrackIds)) {
+        return false;
+    }
+
+    // Insert the remaining new tracks
+    std::vector<std::pair<DbId, int>> newTracks(
+            recordsByLocationId.keyValueBegin(),
+            recordsByLocationId.keyValueEnd());
+    // Preserve the order of the records
+    std::sort(newTracks.begin(),
+            newTracks.end(),
+            [](const auto& lhs, const auto& rhs) {
+                return lhs.second < rhs.second;
+            });
+    // Time stamps are stored with timezone UTC in the database
+    const auto trackDateAdded = QDateTime::currentDateTimeUtc();
+    {
+        const int maxRows = mixxx::sqlite::maxRowsPerInsert(
+                kLibraryInsertColumns.size());
+        QSqlQuery query(m_database);
+        int preparedRows = 0;
+        const int newTrackCount = static_cast<int>(newTracks.size());
+        for (int chunk = 0; chunk < newTrackCount; chunk += maxRows) {
+            const int rows = std::min(maxRows, newTrackCount - chunk);
+            if (rows != preparedRows) {
+                query.prepare(QStringLiteral("INSERT INTO library (%1) VALUES %2")
+                                      .arg(kLibraryInsertColumns.join(QChar(',')),
+                                              mixxx::sqlite::multiRowValuesPlaceholders(
+                                                      kLibraryInsertColumns,
+                                                      rows)));
+                preparedRows = rows;
+            }
+            for (int row = 0; row < rows; ++row) {
+                const auto& [locationId, record] = newTracks[chunk + row];
+                MultiRowBinder binder(&query, row);
+                bindNewTrackLibraryValues(
+                        &binder,
+                        records[record].trackRecord,
+                        records[record].pBeats,
+                        locationId,
+                        trackDateAdded);
+            }
+            if (!query.exec()) {
+                LOG_FAILED_QUERY(query);
+                return false;
+            }
+        }
+    }
+
+    // Resolve the ids of the new tracks
+    QList<std::pair<TrackId, CuePointer>> newTrackCues;
+    for (std::size_t chunk = 0; chunk < newTracks.size(); chunk += kMaxValuesPerSelect) {
+        QStringList newLocationIds;
+        for (std::size_t i = chunk;
+                i < std::min(chunk + kMaxValuesPerSelect, newTracks.size());
+                ++i) {
+            newLocationIds.append(newTracks[i].first.toString());
+        }
+        QSqlQuery query(m_database);
+        query.prepare(QStringLiteral("SELECT id,location FROM library WHERE location IN (%1)")
+                              .arg(newLocationIds.join(QChar(','))));
+        if (!query.exec()) {
+            LOG_FAILED_QUERY(query);
+            return false;
+        }
+        while (query.next()) {
+            const TrackId trackId(query.value(0));
+            const int record = recordsByLocationId.value(DbId(query.value(1)));
+            (*pTrackIds)[record] = trackId;
+            pAddedTrackIds->insert(trackId);
+            for (const auto& pCue : records[record].cuePoints) {
+                newTrackCues.append(std::make_pair(trackId, pCue));
+            }
+        }
+    }
+    VERIFY_OR_DEBUG_ASSERT(pAddedTrackIds->size() == static_cast<int>(newTracks.size())) {
+        return false;
+    }
+    if (!m_cueDao.insertNewTrackCues(newTrackCues)) {
+        return false;
+    }
+
+    // Duplicate records share the id of the first record
+    for (int i = first; i < last; ++i) {
+        const int record = recordsByLocation.value(records[i].fileInfo.location());
+        (*pTrackIds)[i] = (*pTrackIds)[record];
+    }
+    return true;
+}
+
 bool TrackDAO::hideTracks(
         const QList<TrackId>& trackIds) const {
     QStringList idList;
@@ -1540,6 +1969,10 @@ TrackPointer TrackDAO::getTrackById(TrackId trackId) const {
         // file. This import might have never been completed successfully
         // before, so just check and try for every track that has been
         // freshly loaded from the database.
+        // This import stays synchronous and is not deferred to the
+        // TrackMetadataImportService: Callers like loading into a deck
+        // expect the returned track to be up-to-date. The file is only
+        // parsed if it has never been imported or if it has been modified.
         auto updateTrackFromSourceMode =
                 SoundSourceProxy::UpdateTrackFromSourceMode::Once;
         if (m_pConfig &&
@@ -1764,6 +2197,56 @@ void TrackDAO::invalidateTrackLocationsInLibrary() const {
     }
 }
 
+void TrackDAO::invalidateTrackLocationsInDirectories(const QStringList& directories) const {
+    QSqlQuery query(m_database);
+    query.prepare(
+            QString("UPDATE track_locations "
+                    "SET needs_verification=1 "
+                    "WHERE directory IN (%1)")
+                    .arg(SqlStringFormatter::formatList(m_database, directories)));
+    if (!query.exec()) {
+        LOG_FAILED_QUERY(query)
+                << "Couldn't mark tracks in" << directories.size()
+                << "directories as needing verification.";
+        DEBUG_ASSERT(!"Failed query");
+    }
+
+    query.prepare(QStringLiteral(
+            "UPDATE track_locations "
+            "SET needs_verification=1 "
+            "WHERE INSTR(directory,:directoryPrefix)=1"));
+    for (const auto& directory : directories) {
+        if (QDir(directory).exists()) {
+            continue;
+        }
+        query.bindValue(":directoryPrefix", directory + '/');
+        if (!query.exec()) {
+            LOG_FAILED_QUERY(query)
+                    << "Couldn't mark tracks in subdirectories of" << directory
+                    << "as needing verification.";
+            DEBUG_ASSERT(!"Failed query");
+        }
+    }
+}
+
+void TrackDAO::updateTrackLocationStat(
+        const QString& location,
+        const ScannerFileStat& fileStat) const {
+    QSqlQuery query(m_database);
+    query.prepare(QStringLiteral(
+            "UPDATE track_locations "
+            "SET filesize=:filesize,fs_mtime_ms=:fs_mtime_ms,fs_inode=:fs_inode "
+            "WHERE location=:location"));
+    query.bindValue(":filesize", fileStat.sizeInBytes);
+    bindTrackLocationStat(&query, fileStat);
+    query.bindValue(":location", location);
+    if (!query.exec()) {
+        LOG_FAILED_QUERY(query)
+                << "Couldn't update file stats of" << location;
+        DEBUG_ASSERT(!"Failed query");
+    }
+}
+
 void TrackDAO::markTrackLocationsAsVerified(const QStringList& locations) const {
     //qDebug() << "TrackDAO::markTrackLocationsAsVerified" << QThread::currentThread() << m_database.connectionName();
 
@@ -2315,7 +2798,9 @@ bool TrackDAO::updatePlayCounterFromPlayedHistory(
 #ifdef __SQLITE3__
     if (sqlite3_libversion_number() >= 3033000) {
 #endif // __SQLITE3__
-        const QString trackIdList = joinTrackIdList(trackIds);
+        VERIFY_OR_DEBUG_ASSERT(createTrackIdsTempTable(m_database, trackIds)) {
+            return false;
+        }
         auto updatePlayed = FwdSqlQuery(
                 m_database,
                 QStringLiteral(
@@ -2334,15 +2819,17 @@ bool TrackDAO::updatePlayCounterFromPlayedHistory(
                         "GROUP BY PlaylistTracks.track_id"
                         ") q "
                         "WHERE library.id=q.id "
-                        "AND library.id IN (%1)")
-                        .arg(trackIdList));
+                        "AND library.id IN (SELECT id FROM %1)")
+                        .arg(kTrackIdsTempTable));
         updatePlayed.bindValue(
                 QStringLiteral(":playlistHidden"),
                 PlaylistDAO::PLHT_SET_LOG);
         VERIFY_OR_DEBUG_ASSERT(!updatePlayed.hasError()) {
+            dropTrackIdsTempTable(m_database);
             return false;
         }
         VERIFY_OR_DEBUG_ASSERT(updatePlayed.execPrepared()) {
+            dropTrackIdsTempTable(m_database);
             return false;
         }
         auto updateNotPlayed = FwdSqlQuery(
@@ -2357,17 +2844,20 @@ bool TrackDAO::updatePlayCounterFromPlayedHistory(
                         "JOIN Playlists ON "
                         "PlaylistTracks.playlist_id=Playlists.id "
                         "WHERE Playlists.hidden=:playlistHidden "
-                        "AND PlaylistTracks.track_id IN (%1))")
-                        .arg(trackIdList));
+                        "AND PlaylistTracks.track_id IN (SELECT id FROM %1))")
+                        .arg(kTrackIdsTempTable));
         updateNotPlayed.bindValue(
                 QStringLiteral(":playlistHidden"),
                 PlaylistDAO::PLHT_SET_LOG);
         VERIFY_OR_DEBUG_ASSERT(!updateNotPlayed.hasError()) {
+            dropTrackIdsTempTable(m_database);
             return false;
         }
         VERIFY_OR_DEBUG_ASSERT(updateNotPlayed.execPrepared()) {
+            dropTrackIdsTempTable(m_database);
             return false;
         }
+        dropTrackIdsTempTable(m_database);
 #ifdef __SQLITE3__
     } else {
         // TODO: Remove this workaround after dropping support for Ubuntu 20.04
@@ -1,17 +1,27 @@
 #pragma once
 
 #include <QFileInfo>
+#include <QHash>
 #include <QList>
 #include <QObject>
 #include <QSet>
 #include <QSqlDatabase>
 #include <QString>
+#include <optional>
+#include <vector>
 
 #include "library/dao/dao.h"
 #include "library/relocatedtrack.h"
+#include "library/scanner/scannerutil.h"
 #include "preferences/usersettings.h"
+#include "sources/soundsourceproxy.h"
+#include "track/beats.h"
+#include "track/cue.h"
 #include "track/globaltrackcache.h"
+#include "track/trackrecord.h"
 #include "util/class.h"
+#include "util/duration.h"
+#include "util/fileinfo.h"
 #include "util/memory.h"
 
 class FwdSqlQuery;
@@ -21,13 +31,6 @@ class AnalysisDao;
 class CueDAO;
 class LibraryHashDAO;
 
-namespace mixxx {
-
-class FileInfo;
-class TrackRecord;
-
-} // namespace mixxx
-
 class TrackDAO : public QObject, public virtual DAO, public virtual GlobalTrackCacheRelocator {
     Q_OBJECT
   public:
@@ -65,8 +68,17 @@ class TrackDAO : public QObject, public virtual DAO, public virtual GlobalTrackC
 
     // Returns a set of all track locations in the library.
     QSet<QString> getAllTrackLocations() const;
+    // Returns the file system stats of all track locations in the library
+    // that have been stored when adding or rescanning the files.
+    QHash<QString, ScannerFileStat> getAllTrackLocationStats() const;
     QString getTrackLocation(TrackId trackId) const;
 
+    // Fetches the duration and the file type of multiple tracks without
+    // loading them, e.g. for estimating the costs of analyzing them.
+    // Tracks that do not exist are omitted.
+    QHash<TrackId, std::pair<mixxx::Duration, QString>> getTrackDurationsAndFileTypes(
+            const QSet<TrackId>& trackIds) const;
+
     // Only used by friend class LibraryScanner, but public for testing!
     bool detectMovedTracks(
             QList<RelocatedTrack>* pRelocatedTracks,
@@ -76,6 +88,30 @@ class TrackDAO : public QObject, public virtual DAO, public virtual GlobalTrackC
     // Only used by friend class TrackCollection, but public for testing!
     bool saveTrack(Track* pTrack) const;
 
+    /// A new track with all properties that have been imported from
+    /// the file or from an external library.
+    struct NewTrackRecord {
+        mixxx::FileInfo fileInfo;
+        mixxx::TrackRecord trackRecord;
+        mixxx::BeatsPointer pBeats;
+        QList<CuePointer> cuePoints;
+    };
+
+    /// Adds many tracks at once, e.g. the missing tracks of an imported
+    /// playlist or external library in resolveTrackIds().
+    ///
+    /// The rows are written with multi-row INSERT statements in large
+    /// transactions instead of executing multiple statements per track.
+    /// Existing tracks are skipped and only unhidden if requested. The
+    /// returned ids correspond to the records, the id is invalid if
+    /// adding the record failed.
+    ///
+    /// The caller must ensure that the tracks are not loaded, i.e. the
+    /// records must not be modified concurrently through Track objects.
+    QList<TrackId> addTrackRecords(
+            const std::vector<NewTrackRecord>& records,
+            bool unremove);
+
     /// Update the play counter properties according to the corresponding
     /// aggregated properties obtained from the played history.
     bool updatePlayCounterFromPlayedHistory(
@@ -151,9 +187,13 @@ class TrackDAO : public QObject, public virtual DAO, public virtual GlobalTrackC
     TrackId addTracksAddTrack(
             const TrackPointer& pTrack,
             bool unremove);
+    /// Metadata that has already been imported from the file is
+    /// reused when adding a new track instead of parsing the file
+    /// again.
     TrackPointer addTracksAddFile(
             const mixxx::FileAccess& fileAccess,
-            bool unremove);
+            bool unremove,
+            const SoundSourceProxy::ImportedMetadata* pImportedMetadata = nullptr);
     TrackPointer addTracksAddFile(
             const QString& filePath,
             bool unremove) {
@@ -163,6 +203,21 @@ class TrackDAO : public QObject, public virtual DAO, public virtual GlobalTrackC
     }
     void addTracksFinish(bool rollback = false);
 
+    /// Imports the metadata of a file that is not in the library yet
+    /// for addTrackRecords(). Returns std::nullopt if the file is not
+    /// supported or missing.
+    std::optional<NewTrackRecord> importNewTrackRecord(
+            mixxx::FileInfo fileInfo) const;
+
+    // Adds the records [first, last) within a single transaction
+    bool addTrackRecordsInTransaction(
+            const std::vector<NewTrackRecord>& records,
+            int first,
+            int last,
+            bool unremove,
+            QList<TrackId>* pTrackIds,
+            QSet<TrackId>* pAddedTrackIds);
+
     bool updateTrack(const Track& track) const;
 
     void hideAllTracks(const QDir& rootDir) const;
@@ -186,6 +241,13 @@ class TrackDAO : public QObject, public virtual DAO, public virtual GlobalTrackC
     void markTrackLocationsAsVerified(const QStringList& locations) const;
     void markTracksInDirectoriesAsVerified(const QStringList& directories) const;
     void invalidateTrackLocationsInLibrary() const;
+    // Only invalidates the tracks in the given directories. For
+    // directories that do not exist anymore the tracks in all
+    // subdirectories are invalidated, too.
+    void invalidateTrackLocationsInDirectories(const QStringList& directories) const;
+    void updateTrackLocationStat(
+            const QString& location,
+            const ScannerFileStat& fileStat) const;
     void markUnverifiedTracksAsDeleted();
 
     bool verifyRemainingTracks(
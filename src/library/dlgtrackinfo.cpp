@@ -1,8 +1,10 @@
 #include "library/dlgtrackinfo.h"
 
+#include <QFutureWatcher>
 #include <QSignalBlocker>
 #include <QStringBuilder>
 #include <QTreeWidget>
+#include <QtConcurrentRun>
 #include <QtDebug>
 
 #include "defs_urls.h"
@@ -35,6 +37,36 @@ constexpr int kMinBpm = 30;
 const mixxx::Duration kMaxInterval = mixxx::Duration::fromMillis(
         static_cast<qint64>(1000.0 * (60.0 / kMinBpm)));
 
+struct ImportedMetadataFromFile {
+    mixxx::MetadataSource::ImportResult importResult;
+    QDateTime sourceSynchronizedAt;
+    mixxx::TrackMetadata trackMetadata;
+    CoverInfoRelative coverInfo;
+};
+
+/// Reads the file tags on a worker thread.
+ImportedMetadataFromFile importMetadataFromFile(
+        const TrackPointer& pTrack,
+        mixxx::TrackMetadata trackMetadata,
+        bool resetMissingTagMetadata) {
+    QImage coverImage;
+    const auto [importResult, sourceSynchronizedAt] =
+            SoundSourceProxy(pTrack).importTrackMetadataAndCoverImage(
+                    &trackMetadata, &coverImage, resetMissingTagMetadata);
+    if (importResult != mixxx::MetadataSource::ImportResult::Succeeded) {
+        return ImportedMetadataFromFile{importResult, QDateTime(), {}, {}};
+    }
+    auto coverInfo = CoverInfoGuesser().guessCoverInfo(
+            pTrack->getFileInfo(),
+            trackMetadata.getAlbumInfo().getTitle(),
+            coverImage);
+    return ImportedMetadataFromFile{
+            importResult,
+            sourceSynchronizedAt,
+            std::move(trackMetadata),
+            std::move(coverInfo)};
+}
+
 } // namespace
 
 DlgTrackInfo::DlgTrackInfo(
@@ -668,34 +700,45 @@ void DlgTrackInfo::slotImportMetadataFromFile() {
     // losing existing metadata or to lose the beat grid by replacing
     // it with a default grid created from an imprecise BPM.
     // See also: https://bugs.launchpad.net/mixxx/+bug/1929311
-    // In addition we need to preserve all other track properties
-    // that are stored in TrackRecord, which serves as the underlying
-    // model for this dialog.
-    mixxx::TrackRecord trackRecord = m_pLoadedTrack->getRecord();
-    mixxx::TrackMetadata trackMetadata = trackRecord.getMetadata();
-    QImage coverImage;
     const auto resetMissingTagMetadata = m_pUserSettings->getValue<bool>(
             mixxx::library::prefs::kResetMissingTagMetadataOnImportConfigKey);
-    const auto [importResult, sourceSynchronizedAt] =
-            SoundSourceProxy(m_pLoadedTrack)
-                    .importTrackMetadataAndCoverImage(
-                            &trackMetadata, &coverImage, resetMissingTagMetadata);
-    if (importResult != mixxx::MetadataSource::ImportResult::Succeeded) {
-        return;
-    }
-    auto fileAccess = m_pLoadedTrack->getFileAccess();
-    auto guessedCoverInfo = CoverInfoGuesser().guessCoverInfo(
-            fileAccess.info(),
-            trackMetadata.getAlbumInfo().getTitle(),
-            coverImage);
-    trackRecord.replaceMetadataFromSource(
-            std::move(trackMetadata),
-            sourceSynchronizedAt);
-    trackRecord.setCoverInfo(
-            std::move(guessedCoverInfo));
-    replaceTrackRecord(
-            std::move(trackRecord),
-            fileAccess.info().location());
+    // Reading the file might block on slow storage. The dialog is
+    // updated when reading has finished.
+    btnImportMetadataFromFile->setEnabled(false);
+    auto* pWatcher = new QFutureWatcher<ImportedMetadataFromFile>(this);
+    connect(pWatcher,
+            &QFutureWatcher<ImportedMetadataFromFile>::finished,
+            this,
+            [this, pWatcher, pTrack = m_pLoadedTrack] {
+                pWatcher->deleteLater();
+                btnImportMetadataFromFile->setEnabled(true);
+                if (m_pLoadedTrack != pTrack) {
+                    // Another track has been loaded in the meantime
+                    return;
+                }
+                ImportedMetadataFromFile imported = pWatcher->result();
+                if (imported.importResult !=
+                        mixxx::MetadataSource::ImportResult::Succeeded) {
+                    return;
+                }
+                // We need to preserve all other track properties that
+                // are stored in TrackRecord, which serves as the
+                // underlying model for this dialog.
+                mixxx::TrackRecord trackRecord = m_pLoadedTrack->getRecord();
+                trackRecord.replaceMetadataFromSource(
+                        std::move(imported.trackMetadata),
+                        imported.sourceSynchronizedAt);
+                trackRecord.setCoverInfo(
+                        std::move(imported.coverInfo));
+                replaceTrackRecord(
+                        std::move(trackRecord),
+                        m_pLoadedTrack->getLocation());
+            });
+    pWatcher->setFuture(QtConcurrent::run(
+            importMetadataFromFile,
+            m_pLoadedTrack,
+            m_pLoadedTrack->getMetadata(),
+            resetMissingTagMetadata));
 }
 
 void DlgTrackInfo::slotTrackChanged(TrackId trackId) {
@@ -280,6 +280,23 @@ class TrackAnalysisSchedulerEnvironmentImpl final : public TrackAnalysisSchedule
         return m_pLibrary->trackCollectionManager()->getTrackById(trackId);
     }
 
+    QHash<TrackId, TrackCostInfo> loadTrackCostInfos(
+            const QSet<TrackId>& trackIds) const final {
+        const auto durationsAndFileTypes =
+                m_pLibrary->trackCollectionManager()
+                        ->internalCollection()
+                        ->getTrackDAO()
+                        .getTrackDurationsAndFileTypes(trackIds);
+        QHash<TrackId, TrackCostInfo> costInfos;
+        costInfos.reserve(durationsAndFileTypes.size());
+        for (auto it = durationsAndFileTypes.constBegin();
+                it != durationsAndFileTypes.constEnd();
+                ++it) {
+            costInfos.insert(it.key(), TrackCostInfo{it.value().first, it.value().second});
+        }
+        return costInfos;
+    }
+
   private:
     // TODO: Use std::shared_ptr or std::weak_ptr instead of a plain pointer?
     const Library* const m_pLibrary;
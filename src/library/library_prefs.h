@@ -14,6 +14,15 @@ extern const QString kConfigGroup;
 
 extern const ConfigKey kRescanOnStartupConfigKey;
 
+// Incremental rescans skip directories and files whose modification time
+// and inode are unchanged. The stats are only stored by incremental scans,
+// so the first incremental scan after upgrading the database compares and
+// re-imports the metadata of all tracks. Changes on network mounts (NAS,
+// SMB/CIFS, NFS) may not be detected, see ScannerFileStat.
+extern const ConfigKey kIncrementalRescanConfigKey;
+
+const bool kIncrementalRescanDefault = false;
+
 extern const ConfigKey kKeyNotationConfigKey;
 
 extern const ConfigKey kTrackDoubleClickActionConfigKey;
@@ -2,6 +2,7 @@
 
 #include "library/scanner/libraryscanner.h"
 #include "moc_importfilestask.cpp"
+#include "sources/soundsourceproxy.h"
 #include "util/timer.h"
 
 ImportFilesTask::ImportFilesTask(LibraryScanner* pScanner,
@@ -9,6 +10,7 @@ ImportFilesTask::ImportFilesTask(LibraryScanner* pScanner,
         const QString& dirPath,
         const bool prevHashExists,
         const mixxx::cache_key_t newHash,
+        const ScannerFileStat& dirStat,
         const std::list<QFileInfo>& filesToImport,
         const std::list<QFileInfo>& possibleCovers,
         SecurityTokenPointer pToken)
@@ -16,6 +18,7 @@ ImportFilesTask::ImportFilesTask(LibraryScanner* pScanner,
           m_dirPath(dirPath),
           m_prevHashExists(prevHashExists),
           m_newHash(newHash),
+          m_dirStat(dirStat),
           m_filesToImport(filesToImport),
           m_possibleCovers(possibleCovers),
           m_pToken(pToken) {
@@ -42,6 +45,17 @@ void ImportFilesTask::run() {
             // executed when other files in the same directory have changed (the
             // directory hash has changed).
             emit trackExists(trackLocation);
+            if (m_scannerGlobal->isIncremental()) {
+                // Detect modified files, e.g. after editing the tags
+                // with an external application
+                const auto fileStat = ScannerFileStat::fromPath(trackLocation);
+                if (fileStat.isValid() &&
+                        fileStat !=
+                                m_scannerGlobal->trackLocationStatInDatabase(
+                                        trackLocation)) {
+                    emit trackFileChanged(trackLocation, fileStat);
+                }
+            }
         } else {
             if (!fileInfo.exists()) {
                 qWarning() << "ImportFilesTask: Skipping inaccessible file"
@@ -50,10 +64,19 @@ void ImportFilesTask::run() {
             }
             qDebug() << "Importing track" << trackLocation;
 
+            // Parse the file tags on this worker thread. Only the database
+            // insertion remains for the scanner thread.
+            auto importedMetadata = SoundSourceProxy::importMetadataOfUncachedFile(
+                    mixxx::FileAccess(mixxx::FileInfo(fileInfo), m_pToken),
+                    m_scannerGlobal->resetMissingTagMetadataOnImport());
+            if (importedMetadata) {
+                m_scannerGlobal->addImportedMetadata(
+                        trackLocation, std::move(*importedMetadata));
+            }
             emit addNewTrack(trackLocation);
         }
     }
     // Insert or update the hash in the database.
-    emit directoryHashedAndScanned(m_dirPath, !m_prevHashExists, m_newHash);
+    emit directoryHashedAndScanned(m_dirPath, !m_prevHashExists, m_newHash, m_dirStat);
     setSuccess(true);
 }
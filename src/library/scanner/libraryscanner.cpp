@@ -1,8 +1,13 @@
 #include "library/scanner/libraryscanner.h"
 
+#include <algorithm>
+#include <optional>
+
 #include "library/coverartutils.h"
+#include "library/library_prefs.h"
 #include "library/queryutil.h"
 #include "library/scanner/libraryscannerdlg.h"
+#include "library/scanner/librarywatcher.h"
 #include "library/scanner/recursivescandirectorytask.h"
 #include "library/scanner/scannertask.h"
 #include "library/scanner/scannerutil.h"
@@ -19,8 +24,12 @@
 
 namespace {
 
-// TODO(rryan) make configurable
-constexpr int kScannerThreadPoolSize = 1;
+// Directories are listed and hashed and the tags of new files are
+// parsed concurrently by the worker threads. Only the database is
+// accessed exclusively by the scanner thread.
+int scannerThreadPoolSize() {
+    return std::max(QThread::idealThreadCount(), 1);
+}
 
 mixxx::Logger kLogger("LibraryScanner");
 
@@ -92,12 +101,33 @@ void updateQueryPlannerStatisticsForDatabase(const QSqlDatabase& database) {
     }
 }
 
+QStringList rootDirLocations(const QList<mixxx::FileInfo>& rootDirs) {
+    QStringList locations;
+    locations.reserve(rootDirs.size());
+    for (const auto& rootDir : rootDirs) {
+        locations.append(rootDir.location());
+    }
+    locations.sort();
+    return locations;
+}
+
+bool isInRootDir(const QString& dirPath, const QStringList& rootDirLocations) {
+    for (const auto& rootDirLocation : rootDirLocations) {
+        if (dirPath == rootDirLocation ||
+                dirPath.startsWith(rootDirLocation + QChar('/'))) {
+            return true;
+        }
+    }
+    return false;
+}
+
 } // anonymous namespace
 
 LibraryScanner::LibraryScanner(
         mixxx::DbConnectionPoolPtr pDbConnectionPool,
         const UserSettingsPointer& pConfig)
         : m_pDbConnectionPool(std::move(pDbConnectionPool)),
+          m_pConfig(pConfig),
           m_analysisDao(pConfig),
           m_trackDao(m_cueDao, m_playlistDao,
                   m_analysisDao, m_libraryHashDao,
@@ -112,7 +142,9 @@ LibraryScanner::LibraryScanner(
     const int instanceId = s_instanceCounter.fetchAndAddAcquire(1) + 1;
     setObjectName(QString("LibraryScanner %1").arg(instanceId));
 
-    m_pool.setMaxThreadCount(kScannerThreadPoolSize);
+    m_pool.setMaxThreadCount(scannerThreadPoolSize());
+
+    qRegisterMetaType<ScannerFileStat>("ScannerFileStat");
 
     // Listen to signals from our public methods (invoked by other threads) and
     // connect them to our slots to run the command on the scanner thread.
@@ -174,10 +206,16 @@ void LibraryScanner::run() {
         m_analysisDao.initialize(dbConnection);
         m_directoryDao.initialize(dbConnection);
 
+        if (LibraryWatcher::isSupported()) {
+            m_pWatcher = std::make_unique<LibraryWatcher>();
+        }
+
         // Start the event loop.
         kLogger.debug() << "Event loop starting";
         exec();
         kLogger.debug() << "Event loop stopped";
+
+        m_pWatcher.reset();
     }
     kLogger.debug() << "Exiting thread";
 }
@@ -186,16 +224,51 @@ void LibraryScanner::slotStartScan() {
     kLogger.debug() << "slotStartScan()";
     DEBUG_ASSERT(m_state == STARTING);
 
-    cleanUpDatabase(m_libraryHashDao.database());
+    const bool incremental = m_pConfig->getValue(
+            mixxx::library::prefs::kIncrementalRescanConfigKey,
+            mixxx::library::prefs::kIncrementalRescanDefault);
 
     // Recursively scan each directory in the directories table.
     m_libraryRootDirs = m_directoryDao.loadAllDirectories();
+    const QStringList rootDirs = rootDirLocations(m_libraryRootDirs);
+
+    // Only the directories that have changed since the previous scan
+    // need to be scanned if all library directories have been watched
+    // in the meantime.
+    std::optional<QSet<QString>> changedDirectories;
+    if (m_pWatcher) {
+        if (!incremental) {
+            m_pWatcher->invalidate();
+        } else if (m_pWatcher->isValid() && rootDirs == m_watchedRootDirs) {
+            changedDirectories = QSet<QString>();
+            const QSet<QString> watchedDirectories = m_pWatcher->takeChangedDirectories();
+            for (const auto& dirPath : watchedDirectories) {
+                if (isInRootDir(dirPath, rootDirs)) {
+                    changedDirectories->insert(dirPath);
+                }
+            }
+        } else {
+            // All changes are covered by scanning all directories
+            m_pWatcher->takeChangedDirectories();
+        }
+    }
+
     // If there are no directories then we have nothing to do. Cleanup and
     // finish the scan immediately.
     if (m_libraryRootDirs.isEmpty()) {
         changeScannerState(IDLE);
         return;
     }
+    if (changedDirectories && changedDirectories->isEmpty()) {
+        kLogger.info() << "No changes in the library directories since the previous scan";
+        changeScannerState(IDLE);
+        return;
+    }
+
+    if (!changedDirectories) {
+        cleanUpDatabase(m_libraryHashDao.database());
+    }
+
     changeScannerState(SCANNING);
 
     QSet<QString> trackLocations = m_trackDao.getAllTrackLocations();
@@ -207,23 +280,47 @@ void LibraryScanner::slotStartScan() {
     QStringList directoryBlacklist = ScannerUtil::getDirectoryBlacklist();
 
     m_scannerGlobal = ScannerGlobalPointer(
-            new ScannerGlobal(trackLocations, directoryHashes, extensionFilter,
-                              coverExtensionFilter, directoryBlacklist));
+            new ScannerGlobal(trackLocations,
+                    directoryHashes,
+                    extensionFilter,
+                    coverExtensionFilter,
+                    directoryBlacklist,
+                    SyncTrackMetadataParams::readFromUserSettings(*m_pConfig)
+                            .resetMissingTagMetadataOnImport));
+    if (incremental) {
+        m_scannerGlobal->setIncremental(
+                m_libraryHashDao.getDirectoryStats(),
+                m_trackDao.getAllTrackLocationStats(),
+                changedDirectories.has_value());
+    }
 
     m_scannerGlobal->startTimer();
 
     emit scanStarted();
 
-    // First, we're going to mark all the directories that we've previously
-    // hashed as needing verification. As we search through the directory tree
-    // when we rescan, we'll mark any directory that does still exist as
-    // verified.
-    m_libraryHashDao.invalidateAllDirectories();
-
-    // Mark all the tracks in the library as needing verification of their
-    // existence. (ie. we want to check they're still on your hard drive where
-    // we think they are)
-    m_trackDao.invalidateTrackLocationsInLibrary();
+    if (changedDirectories) {
+        kLogger.info()
+                << "Scanning"
+                << changedDirectories->size()
+                << "changed directories";
+        // Only the changed directories and the subdirectories of
+        // removed directories need to be verified.
+        const QStringList dirPaths(
+                changedDirectories->begin(), changedDirectories->end());
+        m_libraryHashDao.invalidateDirectories(dirPaths);
+        m_trackDao.invalidateTrackLocationsInDirectories(dirPaths);
+    } else {
+        // First, we're going to mark all the directories that we've previously
+        // hashed as needing verification. As we search through the directory tree
+        // when we rescan, we'll mark any directory that does still exist as
+        // verified.
+        m_libraryHashDao.invalidateAllDirectories();
+
+        // Mark all the tracks in the library as needing verification of their
+        // existence. (ie. we want to check they're still on your hard drive where
+        // we think they are)
+        m_trackDao.invalidateTrackLocationsInLibrary();
+    }
 
     kLogger.debug() << "Recursively scanning library.";
 
@@ -245,6 +342,22 @@ void LibraryScanner::slotStartScan() {
             this,
             &LibraryScanner::slotFinishHashedScan);
 
+    if (changedDirectories) {
+        for (const auto& dirPath : qAsConst(*changedDirectories)) {
+            const mixxx::FileInfo dirInfo(dirPath);
+            if (!dirInfo.exists() || !dirInfo.isDir()) {
+                // Removed directories remain unverified
+                continue;
+            }
+            if (!m_scannerGlobal->testAndMarkDirectoryScanned(dirInfo.toQDir())) {
+                queueTask(new RecursiveScanDirectoryTask(
+                        this, m_scannerGlobal, mixxx::FileAccess(dirInfo), false));
+            }
+        }
+        pWatcher->taskDone();
+        return;
+    }
+
     for (const mixxx::FileInfo& rootDir : qAsConst(m_libraryRootDirs)) {
         // Acquire a security bookmark for this directory if we are in a
         // sandbox. For speed we avoid opening security bookmarks when recursive
@@ -411,6 +524,26 @@ void LibraryScanner::slotFinishUnhashedScan() {
         cleanUpScan();
     }
 
+    if (!m_scannerGlobal->shouldCancel() && bScanFinishedCleanly) {
+        reimportModifiedTracks();
+    }
+
+    if (m_pWatcher) {
+        if (m_scannerGlobal->isIncremental() &&
+                !m_scannerGlobal->shouldCancel() && bScanFinishedCleanly) {
+            if (m_scannerGlobal->changedDirectoriesOnly()) {
+                m_pWatcher->addDirectories(m_scannerGlobal->scannedDirectoryLocations());
+            } else {
+                m_pWatcher->watchDirectories(m_scannerGlobal->scannedDirectoryLocations());
+                m_watchedRootDirs = rootDirLocations(m_libraryRootDirs);
+            }
+        } else {
+            // Changes that have been taken from the watcher might not
+            // have been scanned
+            m_pWatcher->invalidate();
+        }
+    }
+
     if (!m_scannerGlobal->shouldCancel() && bScanFinishedCleanly) {
         const auto dbConnection = mixxx::DbConnectionPooled(m_pDbConnectionPool);
         updateQueryPlannerStatisticsForDatabase(dbConnection);
@@ -423,16 +556,24 @@ void LibraryScanner::slotFinishUnhashedScan() {
     }
 
     // TODO(XXX) doesn't take into account verifyRemainingTracks.
+    const mixxx::Duration elapsed = m_scannerGlobal->timerElapsed();
+    const int numScannedFiles = m_scannerGlobal->numScannedFiles();
     qDebug("Scan took: %s. "
            "%d unchanged directories. "
            "%d changed/added directories. "
            "%d tracks verified from changed/added directories. "
-           "%d new tracks.",
-            m_scannerGlobal->timerElapsed().formatNanosWithUnit().toLocal8Bit().constData(),
+           "%d new tracks. "
+           "%d files scanned with %d threads (%.1f files/s).",
+            elapsed.formatNanosWithUnit().toLocal8Bit().constData(),
             static_cast<int>(m_scannerGlobal->verifiedDirectories().size()),
             m_scannerGlobal->numScannedDirectories(),
             static_cast<int>(m_scannerGlobal->verifiedTracks().size()),
-            static_cast<int>(m_scannerGlobal->addedTracks().size()));
+            static_cast<int>(m_scannerGlobal->addedTracks().size()),
+            numScannedFiles,
+            m_pool.maxThreadCount(),
+            elapsed.toDoubleSeconds() > 0
+                    ? numScannedFiles / elapsed.toDoubleSeconds()
+                    : 0.0);
 
     m_scannerGlobal.clear();
     changeScannerState(FINISHED);
@@ -441,6 +582,32 @@ void LibraryScanner::slotFinishUnhashedScan() {
     emit scanFinished();
 }
 
+void LibraryScanner::reimportModifiedTracks() {
+    const QStringList& modifiedTracks = m_scannerGlobal->modifiedTracks();
+    if (modifiedTracks.isEmpty()) {
+        return;
+    }
+    kLogger.info()
+            << "Re-importing metadata of"
+            << modifiedTracks.size()
+            << "modified track file(s)";
+    const auto syncParams = SyncTrackMetadataParams::readFromUserSettings(*m_pConfig);
+    for (const auto& trackLocation : modifiedTracks) {
+        if (m_scannerGlobal->shouldCancel()) {
+            return;
+        }
+        const TrackPointer pTrack = m_trackDao.getTrackByRef(
+                TrackRef::fromFilePath(trackLocation));
+        if (!pTrack) {
+            continue;
+        }
+        // Modified tracks are saved implicitly when released
+        SoundSourceProxy(pTrack).updateTrackFromSource(
+                SoundSourceProxy::UpdateTrackFromSourceMode::Newer,
+                syncParams);
+    }
+}
+
 void LibraryScanner::scan() {
     if (changeScannerState(STARTING)) {
         emit startScan();
@@ -510,6 +677,10 @@ void LibraryScanner::queueTask(ScannerTask* pTask) {
             &ScannerTask::trackExists,
             this,
             &LibraryScanner::slotTrackExists);
+    connect(pTask,
+            &ScannerTask::trackFileChanged,
+            this,
+            &LibraryScanner::slotTrackFileChanged);
     connect(pTask,
             &ScannerTask::addNewTrack,
             this,
@@ -530,7 +701,9 @@ void LibraryScanner::queueTask(ScannerTask* pTask) {
 }
 
 void LibraryScanner::slotDirectoryHashedAndScanned(const QString& directoryPath,
-                                               bool newDirectory, mixxx::cache_key_t hash) {
+        bool newDirectory,
+        mixxx::cache_key_t hash,
+        const ScannerFileStat& directoryStat) {
     ScopedTimer timer("LibraryScanner::slotDirectoryHashedAndScanned");
     //kLogger.debug() << "sloDirectoryHashedAndScanned" << directoryPath
     //          << newDirectory << hash;
@@ -542,22 +715,40 @@ void LibraryScanner::slotDirectoryHashedAndScanned(const QString& directoryPath,
     }
 
     if (newDirectory) {
-        m_libraryHashDao.saveDirectoryHash(directoryPath, hash);
+        m_libraryHashDao.saveDirectoryHash(directoryPath, hash, directoryStat);
     } else {
-        m_libraryHashDao.updateDirectoryHash(directoryPath, hash, 0);
+        m_libraryHashDao.updateDirectoryHash(directoryPath, hash, 0, directoryStat);
     }
     emit progressHashing(directoryPath);
 }
 
-void LibraryScanner::slotDirectoryUnchanged(const QString& directoryPath) {
+void LibraryScanner::slotDirectoryUnchanged(const QString& directoryPath,
+        const ScannerFileStat& directoryStat) {
     ScopedTimer timer("LibraryScanner::slotDirectoryUnchanged");
     //kLogger.debug() << "slotDirectoryUnchanged" << directoryPath;
     if (m_scannerGlobal) {
         m_scannerGlobal->addVerifiedDirectory(directoryPath);
+        if (m_scannerGlobal->isIncremental() && directoryStat.isValid() &&
+                directoryStat !=
+                        m_scannerGlobal->directoryStatInDatabase(directoryPath)) {
+            m_libraryHashDao.updateDirectoryStat(directoryPath, directoryStat);
+        }
     }
     emit progressHashing(directoryPath);
 }
 
+void LibraryScanner::slotTrackFileChanged(const QString& trackPath,
+        const ScannerFileStat& fileStat) {
+    ScopedTimer timer("LibraryScanner::slotTrackFileChanged");
+    m_trackDao.updateTrackLocationStat(trackPath, fileStat);
+    if (m_scannerGlobal &&
+            m_scannerGlobal->trackLocationStatInDatabase(trackPath).isValid()) {
+        // The file has actually been modified and has not only been
+        // scanned incrementally for the first time
+        m_scannerGlobal->trackModified(trackPath);
+    }
+}
+
 void LibraryScanner::slotTrackExists(const QString& trackPath) {
     //kLogger.debug() << "slotTrackExists" << trackPath;
     ScopedTimer timer("LibraryScanner::slotTrackExists");
@@ -569,10 +760,15 @@ void LibraryScanner::slotTrackExists(const QString& trackPath) {
 void LibraryScanner::slotAddNewTrack(const QString& trackPath) {
     //kLogger.debug() << "slotAddNewTrack" << trackPath;
     ScopedTimer timer("LibraryScanner::addNewTrack");
+    std::optional<SoundSourceProxy::ImportedMetadata> importedMetadata;
+    if (m_scannerGlobal) {
+        importedMetadata = m_scannerGlobal->takeImportedMetadata(trackPath);
+    }
     // For statistics tracking and to detect moved tracks
     TrackPointer pTrack = m_trackDao.addTracksAddFile(
-            trackPath,
-            false);
+            mixxx::FileAccess(mixxx::FileInfo(trackPath)),
+            false,
+            importedMetadata ? &*importedMetadata : nullptr);
     if (pTrack) {
         DEBUG_ASSERT(!pTrack->isDirty());
         // The track's actual location might differ from the
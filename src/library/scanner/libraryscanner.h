@@ -8,6 +8,7 @@
 #include <QString>
 #include <QThread>
 #include <QThreadPool>
+#include <memory>
 
 #include "library/dao/analysisdao.h"
 #include "library/dao/cuedao.h"
@@ -22,6 +23,7 @@
 
 class ScannerTask;
 class LibraryScannerDlg;
+class LibraryWatcher;
 
 class LibraryScanner : public QThread {
     FRIEND_TEST(LibraryScannerTest, ScannerRoundtrip);
@@ -67,9 +69,14 @@ class LibraryScanner : public QThread {
 
     // ScannerTask signal handlers.
     void slotDirectoryHashedAndScanned(const QString& directoryPath,
-                                   bool newDirectory, mixxx::cache_key_t hash);
-    void slotDirectoryUnchanged(const QString& directoryPath);
+            bool newDirectory,
+            mixxx::cache_key_t hash,
+            const ScannerFileStat& directoryStat);
+    void slotDirectoryUnchanged(const QString& directoryPath,
+            const ScannerFileStat& directoryStat);
     void slotTrackExists(const QString& trackPath);
+    void slotTrackFileChanged(const QString& trackPath,
+            const ScannerFileStat& fileStat);
     void slotAddNewTrack(const QString& trackPath);
 
   private:
@@ -95,8 +102,10 @@ class LibraryScanner : public QThread {
     bool changeScannerState(LibraryScanner::ScannerState newState);
 
     void cleanUpScan();
+    void reimportModifiedTracks();
 
     mixxx::DbConnectionPoolPtr m_pDbConnectionPool;
+    const UserSettingsPointer m_pConfig;
 
     // The pool of threads used for worker tasks.
     QThreadPool m_pool;
@@ -120,5 +129,10 @@ class LibraryScanner : public QThread {
     volatile ScannerState m_state;
 
     QList<mixxx::FileInfo> m_libraryRootDirs;
+
+    // Only created and accessed in the scanner thread
+    std::unique_ptr<LibraryWatcher> m_pWatcher;
+    // The library root directories when the watcher has been armed
+    QStringList m_watchedRootDirs;
     QScopedPointer<LibraryScannerDlg> m_pProgressDlg;
 };
@@ -0,0 +1,221 @@
+#include "library/scanner/librarywatcher.h"
+
+#include <QFile>
+#include <QSocketNotifier>
+
+#include "moc_librarywatcher.cpp"
+#include "util/logger.h"
+
+#ifdef __LINUX__
+#include <errno.h>
+#include <string.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+const mixxx::Logger kLogger("LibraryWatcher");
+
+#ifdef __LINUX__
+// Files that are modified in place are reported by IN_CLOSE_WRITE.
+constexpr uint32_t kWatchMask = IN_CREATE | IN_DELETE | IN_MOVED_FROM |
+        IN_MOVED_TO | IN_CLOSE_WRITE | IN_DELETE_SELF | IN_MOVE_SELF |
+        IN_ONLYDIR;
+#endif
+
+} // anonymous namespace
+
+LibraryWatcher::LibraryWatcher(QObject* pParent)
+        : QObject(pParent),
+          m_fd(-1),
+          m_valid(false) {
+#ifdef __LINUX__
+    m_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (m_fd < 0) {
+        kLogger.warning()
+                << "Failed to initialize inotify:"
+                << strerror(errno);
+        return;
+    }
+    m_pNotifier = std::make_unique<QSocketNotifier>(m_fd, QSocketNotifier::Read);
+    connect(m_pNotifier.get(),
+            &QSocketNotifier::activated,
+            this,
+            &LibraryWatcher::slotReadEvents);
+#endif
+}
+
+LibraryWatcher::~LibraryWatcher() {
+    m_pNotifier.reset();
+#ifdef __LINUX__
+    if (m_fd >= 0) {
+        // Closing the file descriptor removes all watches
+        close(m_fd);
+    }
+#endif
+}
+
+// static
+bool LibraryWatcher::isSupported() {
+#ifdef __LINUX__
+    return true;
+#else
+    return false;
+#endif
+}
+
+void LibraryWatcher::watchDirectories(const QStringList& dirPaths) {
+    if (m_fd < 0) {
+        m_valid = false;
+        return;
+    }
+    // Existing watches are kept to not miss any changes
+    const QSet<QString> newDirPaths(dirPaths.begin(), dirPaths.end());
+    for (auto it = m_watchesByPath.begin(); it != m_watchesByPath.end();) {
+        if (newDirPaths.contains(it.key())) {
+            ++it;
+            continue;
+        }
+#ifdef __LINUX__
+        inotify_rm_watch(m_fd, it.value());
+#endif
+        m_pathsByWatch.remove(it.value());
+        it = m_watchesByPath.erase(it);
+    }
+    m_valid = true;
+    for (const auto& dirPath : newDirPaths) {
+        if (!m_watchesByPath.contains(dirPath) && !addWatch(dirPath)) {
+            invalidate();
+            return;
+        }
+    }
+    kLogger.info()
+            << "Watching"
+            << m_pathsByWatch.size()
+            << "library directories";
+}
+
+void LibraryWatcher::addDirectories(const QStringList& dirPaths) {
+    if (!m_valid) {
+        return;
+    }
+    for (const auto& dirPath : dirPaths) {
+        if (!addWatch(dirPath)) {
+            invalidate();
+            return;
+        }
+    }
+}
+
+void LibraryWatcher::invalidate() {
+    removeAllWatches();
+    m_changedDirectories.clear();
+    m_valid = false;
+}
+
+QSet<QString> LibraryWatcher::takeChangedDirectories() {
+    QSet<QString> changedDirectories;
+    changedDirectories.swap(m_changedDirectories);
+    return changedDirectories;
+}
+
+bool LibraryWatcher::addWatch(const QString& dirPath) {
+#ifdef __LINUX__
+    const int wd = inotify_add_watch(
+            m_fd, QFile::encodeName(dirPath).constData(), kWatchMask);
+    if (wd < 0) {
+        if (errno == ENOENT || errno == ENOTDIR) {
+            // The directory has been removed in the meantime which
+            // has already been reported by its parent directory
+            return true;
+        }
+        kLogger.warning()
+                << "Failed to watch directory"
+                << dirPath
+                << ":"
+                << strerror(errno)
+                << "- the maximum number of watches might need to be increased"
+                << "(fs.inotify.max_user_watches)";
+        return false;
+    }
+    // A renamed directory keeps its watch descriptor
+    const QString oldPath = m_pathsByWatch.value(wd);
+    if (!oldPath.isNull()) {
+        m_watchesByPath.remove(oldPath);
+    }
+    m_pathsByWatch.insert(wd, dirPath);
+    m_watchesByPath.insert(dirPath, wd);
+    return true;
+#else
+    Q_UNUSED(dirPath);
+    return false;
+#endif
+}
+
+void LibraryWatcher::removeAllWatches() {
+#ifdef __LINUX__
+    for (auto it = m_pathsByWatch.constBegin(); it != m_pathsByWatch.constEnd(); ++it) {
+        inotify_rm_watch(m_fd, it.key());
+    }
+#endif
+    m_pathsByWatch.clear();
+    m_watchesByPath.clear();
+}
+
+void LibraryWatcher::slotReadEvents() {
+#ifdef __LINUX__
+    const int changedDirectoriesBefore = m_changedDirectories.size();
+    alignas(struct inotify_event) char buffer[4096];
+    while (true) {
+        const ssize_t length = read(m_fd, buffer, sizeof(buffer));
+        if (length <= 0) {
+            // EAGAIN if all events have been read
+            break;
+        }
+        for (const char* pEvent = buffer; pEvent < buffer + length;) {
+            const auto* pInotifyEvent = reinterpret_cast<const struct inotify_event*>(pEvent);
+            pEvent += sizeof(struct inotify_event) + pInotifyEvent->len;
+            if (!m_valid) {
+                continue;
+            }
+            if (pInotifyEvent->mask & IN_Q_OVERFLOW) {
+                kLogger.warning()
+                        << "Too many changes, all library directories"
+                        << "need to be rescanned";
+                invalidate();
+                continue;
+            }
+            const QString dirPath = m_pathsByWatch.value(pInotifyEvent->wd);
+            if (dirPath.isNull()) {
+                continue;
+            }
+            if (pInotifyEvent->mask & IN_IGNORED) {
+                // The watch has been removed implicitly
+                m_pathsByWatch.remove(pInotifyEvent->wd);
+                m_watchesByPath.remove(dirPath);
+                continue;
+            }
+            m_changedDirectories.insert(dirPath);
+            if ((pInotifyEvent->mask & IN_ISDIR) && pInotifyEvent->len > 0) {
+                const QString subdirPath =
+                        dirPath + '/' + QFile::decodeName(pInotifyEvent->name);
+                if (pInotifyEvent->mask & (IN_DELETE | IN_MOVED_FROM)) {
+                    // The whole subtree of the removed directory needs
+                    // to be verified
+                    m_changedDirectories.insert(subdirPath);
+                } else if (pInotifyEvent->mask & (IN_CREATE | IN_MOVED_TO)) {
+                    // Watch new directories immediately. Their contents are
+                    // scanned together with the parent directory.
+                    if (!addWatch(subdirPath)) {
+                        invalidate();
+                    }
+                }
+            }
+        }
+    }
+    if (m_valid && m_changedDirectories.size() > changedDirectoriesBefore) {
+        emit directoriesChanged();
+    }
+#endif
+}
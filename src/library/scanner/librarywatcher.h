@@ -0,0 +1,68 @@
+#pragma once
+
+#include <QHash>
+#include <QObject>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <memory>
+
+class QSocketNotifier;
+
+/// Watches the directories of the library for added, removed, renamed,
+/// or modified entries while Mixxx is running.
+///
+/// If the watcher has been watching all library directories continuously
+/// since the previous scan the library scanner only needs to scan the
+/// directories that have changed in the meantime.
+///
+/// Only implemented for Linux (inotify). On other platforms the watcher
+/// never becomes valid and all directories are scanned.
+class LibraryWatcher : public QObject {
+    Q_OBJECT
+  public:
+    explicit LibraryWatcher(QObject* pParent = nullptr);
+    ~LibraryWatcher() override;
+
+    static bool isSupported();
+
+    /// Replaces all watches. The watcher becomes valid if all directories
+    /// could be watched. Pending changes are kept.
+    void watchDirectories(const QStringList& dirPaths);
+    /// Adds watches without affecting the validity of the watcher.
+    void addDirectories(const QStringList& dirPaths);
+    /// Removes all watches and discards all changes.
+    void invalidate();
+
+    /// Whether all directories have been watched continuously since
+    /// the last invocation of watchDirectories().
+    bool isValid() const {
+        return m_valid;
+    }
+
+    int watchCount() const {
+        return m_pathsByWatch.size();
+    }
+
+    /// Returns and resets the directories that have changed. Removed
+    /// directories are included.
+    QSet<QString> takeChangedDirectories();
+
+  signals:
+    void directoriesChanged();
+
+  private slots:
+    void slotReadEvents();
+
+  private:
+    bool addWatch(const QString& dirPath);
+    void removeAllWatches();
+
+    int m_fd;
+    std::unique_ptr<QSocketNotifier> m_pNotifier;
+    bool m_valid;
+
+    QHash<int, QString> m_pathsByWatch;
+    QHash<QString, int> m_watchesByPath;
+    QSet<QString> m_changedDirectories;
+};
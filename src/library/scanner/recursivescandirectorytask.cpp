@@ -30,11 +30,49 @@ void RecursiveScanDirectoryTask::run() {
     //qDebug() << "Burn CPU";
     //for (int i = 0;i < 1000000000; i++) asm("nop");
 
+    const QString dirLocation = m_dirAccess.info().location();
+    m_scannerGlobal->addScannedDirectoryLocation(dirLocation);
+
+    // Try to retrieve a hash from the last time that directory was scanned.
+    const mixxx::cache_key_t prevHash = m_scannerGlobal->directoryHashInDatabase(dirLocation);
+    const bool prevHashExists = mixxx::isValidCacheKey(prevHash);
+
+    // The directory needs to be stat'ed before listing it. Otherwise
+    // entries that are added while listing the directory might not
+    // be detected by the next incremental scan.
+    ScannerFileStat dirStat;
+    bool dirStatChanged = false;
+    if (m_scannerGlobal->isIncremental()) {
+        dirStat = ScannerFileStat::fromDirectoryPath(dirLocation);
+        dirStatChanged = !dirStat.isValid() ||
+                dirStat != m_scannerGlobal->directoryStatInDatabase(dirLocation);
+    }
+
     // Note, we save on filesystem operations (and random work) by initializing
     // a QDirIterator with a QDir instead of a QString -- but it inherits its
     // Filter from the QDir so we have to set it first. If the QDir has not done
     // any FS operations yet then this should be lightweight.
     auto dir = m_dirAccess.info().toQDir();
+
+    if (prevHashExists && m_scannerGlobal->isIncremental() && !dirStatChanged &&
+            !m_scannerGlobal->changedDirectoriesOnly()) {
+        // No entries have been added, removed, or renamed since the
+        // previous scan. Only the subdirectories need to be scanned.
+        dir.setFilter(QDir::Dirs | QDir::NoDotAndDotDot);
+        std::list<mixxx::FileInfo> dirsToScan;
+        const QFileInfoList children = dir.entryInfoList();
+        for (const auto& currentFileInfo : children) {
+            if (m_scannerGlobal->directoryBlacklisted(currentFileInfo.filePath())) {
+                continue;
+            }
+            dirsToScan.push_back(mixxx::FileInfo(currentFileInfo));
+        }
+        emit directoryUnchanged(dirLocation, dirStat);
+        queueSubdirectories(dirsToScan);
+        setSuccess(true);
+        return;
+    }
+
     dir.setFilter(QDir::Dirs | QDir::Files | QDir::NoDotAndDotDot | QDir::System);
     // sort directory by file name to increase chance that files are sorted sensible
     dir.setSorting(QDir::SortFlag::DirsFirst | QDir::SortFlag::Name);
@@ -84,16 +122,18 @@ void RecursiveScanDirectoryTask::run() {
     // Calculate a hash of the directory's file list.
     const mixxx::cache_key_t newHash = mixxx::cacheKeyFromMessageDigest(hasher.result());
 
-    QString dirLocation = m_dirAccess.info().location();
-
-    // Try to retrieve a hash from the last time that directory was scanned.
-    const mixxx::cache_key_t prevHash = m_scannerGlobal->directoryHashInDatabase(dirLocation);
-    const bool prevHashExists = mixxx::isValidCacheKey(prevHash);
-
     if (prevHashExists || m_scanUnhashed) {
+        m_scannerGlobal->filesScanned(static_cast<int>(filesToImport.size()));
+        // Incremental scans also compare the files of modified directories
+        // with an unchanged file list, e.g. if a tag editor has replaced
+        // a file. Directories that are scanned because they have changed
+        // are always compared.
+        const bool compareFiles = prevHashExists &&
+                m_scannerGlobal->isIncremental() &&
+                (dirStatChanged || m_scannerGlobal->changedDirectoriesOnly());
         // Compare the hashes, and if they don't match, rescan the files in that
         // directory!
-        if (prevHash != newHash) {
+        if (prevHash != newHash || compareFiles) {
             // Rescan that mofo! If importing fails then the scan was cancelled so
             // we return immediately.
             if (!filesToImport.empty()) {
@@ -102,21 +142,35 @@ void RecursiveScanDirectoryTask::run() {
                         dirLocation,
                         prevHashExists,
                         newHash,
+                        dirStat,
                         filesToImport,
                         possibleCovers,
                         m_dirAccess.token()));
             } else {
-                emit directoryHashedAndScanned(dirLocation, !prevHashExists, newHash);
+                emit directoryHashedAndScanned(dirLocation, !prevHashExists, newHash, dirStat);
             }
         } else {
-            emit directoryUnchanged(dirLocation);
+            emit directoryUnchanged(dirLocation, dirStat);
         }
     } else {
         m_scannerGlobal->addUnhashedDir(m_dirAccess);
     }
 
+    queueSubdirectories(dirsToScan);
+    setSuccess(true);
+}
+
+void RecursiveScanDirectoryTask::queueSubdirectories(
+        const std::list<mixxx::FileInfo>& dirsToScan) {
     // Process all of the sub-directories.
     for (const mixxx::FileInfo& dirInfo : dirsToScan) {
+        if (m_scannerGlobal->changedDirectoriesOnly() &&
+                mixxx::isValidCacheKey(
+                        m_scannerGlobal->directoryHashInDatabase(dirInfo.location()))) {
+            // Known subdirectories are only scanned if they have
+            // changed themselves.
+            continue;
+        }
         // Atomically test and mark the directory as scanned to avoid
         // that the same directory is scanned multiple times by different
         // tasks.
@@ -129,5 +183,4 @@ void RecursiveScanDirectoryTask::run() {
                             m_scanUnhashed));
         }
     }
-    setSuccess(true);
 }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <QDir>
+#include <list>
 
 #include "library/scanner/scannertask.h"
 #include "util/fileaccess.h"
@@ -10,6 +11,9 @@
 /// performing a hash of the directory's file list, and those hashes are stored
 /// in the database. Successful if the scan completed without being
 /// cancelled. False if the scan was cancelled part-way through.
+///
+/// Incremental scans only list the subdirectories of a directory if its
+/// modification time and inode are unchanged since the previous scan.
 class RecursiveScanDirectoryTask : public ScannerTask {
     Q_OBJECT
   public:
@@ -22,6 +26,8 @@ class RecursiveScanDirectoryTask : public ScannerTask {
     void run() override;
 
   private:
+    void queueSubdirectories(const std::list<mixxx::FileInfo>& dirsToScan);
+
     const mixxx::FileAccess m_dirAccess;
     const bool m_scanUnhashed;
 };
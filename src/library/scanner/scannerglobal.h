@@ -1,5 +1,6 @@
 #pragma once
 
+#include <QAtomicInt>
 #include <QDir>
 #include <QHash>
 #include <QMutex>
@@ -7,8 +8,13 @@
 #include <QSet>
 #include <QSharedPointer>
 #include <QStringList>
+#include <QWaitCondition>
+#include <optional>
 
+#include "library/scanner/scannerutil.h"
+#include "sources/soundsourceproxy.h"
 #include "util/cache.h"
+#include "util/compatibility/qatomic.h"
 #include "util/compatibility/qmutex.h"
 #include "util/fileaccess.h"
 #include "util/performancetimer.h"
@@ -16,20 +22,27 @@
 
 class ScannerGlobal {
   public:
+    // Bounds the memory that is occupied by imported metadata. The
+    // limit is far above the number of worker threads.
+    static constexpr int kMaxPendingImportedMetadata = 256;
+
     ScannerGlobal(const QSet<QString>& trackLocations,
             const QHash<QString, mixxx::cache_key_t>& directoryHashes,
             const QRegularExpression& supportedExtensionsMatcher,
             const QRegularExpression& supportedCoverExtensionsMatcher,
-            const QStringList& directoriesBlacklist)
+            const QStringList& directoriesBlacklist,
+            bool resetMissingTagMetadataOnImport)
             : m_trackLocations(trackLocations),
               m_directoryHashes(directoryHashes),
               m_supportedExtensionsMatcher(supportedExtensionsMatcher),
               m_supportedCoverExtensionsMatcher(supportedCoverExtensionsMatcher),
               m_directoriesBlacklist(directoriesBlacklist),
+              m_resetMissingTagMetadataOnImport(resetMissingTagMetadataOnImport),
               // Unless marked un-clean, we assume it will finish cleanly.
               m_scanFinishedCleanly(true),
               m_shouldCancel(false),
-              m_numScannedDirectories(0) {
+              m_numScannedDirectories(0),
+              m_numScannedFiles(0) {
     }
 
     TaskWatcher& getTaskWatcher() {
@@ -46,6 +59,51 @@ class ScannerGlobal {
         return m_directoryHashes.value(directoryPath, mixxx::invalidCacheKey());
     }
 
+    // Enables the incremental scan mode that skips directories that have
+    // not been modified since the previous scan. Only the directories in
+    // changedDirectories are scanned if the scan is restricted to them.
+    // Must be invoked before the first task is started.
+    void setIncremental(
+            const QHash<QString, ScannerFileStat>& directoryStats,
+            const QHash<QString, ScannerFileStat>& trackLocationStats,
+            bool changedDirectoriesOnly) {
+        m_incremental = true;
+        m_changedDirectoriesOnly = changedDirectoriesOnly;
+        m_directoryStats = directoryStats;
+        m_trackLocationStats = trackLocationStats;
+    }
+
+    bool isIncremental() const {
+        return m_incremental;
+    }
+
+    // Only the changed directories and new subdirectories are scanned
+    bool changedDirectoriesOnly() const {
+        return m_changedDirectoriesOnly;
+    }
+
+    // Returns an invalid stat if unknown
+    ScannerFileStat directoryStatInDatabase(const QString& directoryPath) const {
+        return m_directoryStats.value(directoryPath);
+    }
+
+    // Returns an invalid stat if unknown
+    ScannerFileStat trackLocationStatInDatabase(const QString& trackLocation) const {
+        return m_trackLocationStats.value(trackLocation);
+    }
+
+    // All directory locations that have been listed by the scan
+    void addScannedDirectoryLocation(const QString& directoryPath) {
+        const auto locker = lockMutex(&m_scannedDirectoryLocationsMutex);
+        m_scannedDirectoryLocations.insert(directoryPath);
+    }
+
+    QStringList scannedDirectoryLocations() const {
+        const auto locker = lockMutex(&m_scannedDirectoryLocationsMutex);
+        return QStringList(m_scannedDirectoryLocations.begin(),
+                m_scannedDirectoryLocations.end());
+    }
+
     bool directoryBlacklisted(const QString& directoryPath) const {
         return m_directoriesBlacklist.contains(directoryPath);
     }
@@ -94,6 +152,47 @@ class ScannerGlobal {
         return match.hasMatch();
     }
 
+    bool resetMissingTagMetadataOnImport() const {
+        return m_resetMissingTagMetadataOnImport;
+    }
+
+    // Metadata of new tracks is imported by the worker threads and
+    // then handed over to the scanner thread that adds the tracks
+    // to the database. The workers are blocked while the scanner
+    // thread lags behind by kMaxPendingImportedMetadata tracks.
+    void addImportedMetadata(const QString& trackLocation,
+            SoundSourceProxy::ImportedMetadata&& importedMetadata) {
+        const auto locker = lockMutex(&m_importedMetadataMutex);
+        while (m_importedMetadata.size() >= kMaxPendingImportedMetadata) {
+            if (m_shouldCancel) {
+                // The scanner thread might not pick up the metadata anymore
+                return;
+            }
+            m_importedMetadataTaken.wait(
+                    &m_importedMetadataMutex, kImportedMetadataWaitMillis);
+        }
+        m_importedMetadata.insert(trackLocation, std::move(importedMetadata));
+    }
+
+    std::optional<SoundSourceProxy::ImportedMetadata> takeImportedMetadata(
+            const QString& trackLocation) {
+        const auto locker = lockMutex(&m_importedMetadataMutex);
+        const auto it = m_importedMetadata.find(trackLocation);
+        if (it == m_importedMetadata.end()) {
+            return std::nullopt;
+        }
+        std::optional<SoundSourceProxy::ImportedMetadata> importedMetadata =
+                std::move(it.value());
+        m_importedMetadata.erase(it);
+        m_importedMetadataTaken.wakeOne();
+        return importedMetadata;
+    }
+
+    int numPendingImportedMetadata() const {
+        const auto locker = lockMutex(&m_importedMetadataMutex);
+        return static_cast<int>(m_importedMetadata.size());
+    }
+
     bool shouldCancel() const {
         return m_shouldCancel;
     }
@@ -104,6 +203,7 @@ class ScannerGlobal {
 
     void cancel() {
         m_shouldCancel = true;
+        m_importedMetadataTaken.wakeAll();
     }
 
     bool scanFinishedCleanly() const {
@@ -139,6 +239,14 @@ class ScannerGlobal {
         return m_timer.elapsed();
     }
 
+    // Tracks with modified files that need to be re-imported
+    const QStringList& modifiedTracks() const {
+        return m_modifiedTracks;
+    }
+    void trackModified(const QString& trackLocation) {
+        m_modifiedTracks << trackLocation;
+    }
+
     const QStringList& addedTracks() const {
         return m_addedTracks;
     }
@@ -153,6 +261,15 @@ class ScannerGlobal {
         m_numScannedDirectories++;
     }
 
+    // The number of supported files in all listed directories,
+    // including unchanged directories. Updated by the worker threads.
+    int numScannedFiles() const {
+        return atomicLoadRelaxed(m_numScannedFiles);
+    }
+    void filesScanned(int numFiles) {
+        m_numScannedFiles.fetchAndAddRelaxed(numFiles);
+    }
+
   private:
     TaskWatcher m_watcher;
 
@@ -182,6 +299,23 @@ class ScannerGlobal {
     // this has never been investigated.
     QStringList m_directoriesBlacklist;
 
+    const bool m_resetMissingTagMetadataOnImport;
+
+    bool m_incremental = false;
+    bool m_changedDirectoriesOnly = false;
+    QHash<QString, ScannerFileStat> m_directoryStats;
+    QHash<QString, ScannerFileStat> m_trackLocationStats;
+
+    mutable QMutex m_scannedDirectoryLocationsMutex;
+    QSet<QString> m_scannedDirectoryLocations;
+
+    // Waiting workers check periodically if the scan has been canceled
+    static constexpr unsigned long kImportedMetadataWaitMillis = 100;
+
+    mutable QMutex m_importedMetadataMutex;
+    QWaitCondition m_importedMetadataTaken;
+    QHash<QString, SoundSourceProxy::ImportedMetadata> m_importedMetadata;
+
     // The list of directories verified by the scan.
     QStringList m_verifiedDirectories;
 
@@ -191,12 +325,16 @@ class ScannerGlobal {
     // The list of tracks added by the scan.
     QStringList m_addedTracks;
 
+    // The list of tracks with modified files.
+    QStringList m_modifiedTracks;
+
     volatile bool m_scanFinishedCleanly;
     volatile bool m_shouldCancel;
 
     // Stats tracking.
     PerformanceTimer m_timer;
     int m_numScannedDirectories;
+    QAtomicInt m_numScannedFiles;
 };
 
 typedef QSharedPointer<ScannerGlobal> ScannerGlobalPointer;
@@ -20,9 +20,16 @@ class ScannerTask : public QObject, public QRunnable {
     void taskDone(bool success);
     void queueTask(ScannerTask* pTask);
     void directoryHashedAndScanned(const QString& directoryPath,
-                                   bool newDirectory, mixxx::cache_key_t hash);
-    void directoryUnchanged(const QString& directoryPath);
+            bool newDirectory,
+            mixxx::cache_key_t hash,
+            const ScannerFileStat& directoryStat);
+    void directoryUnchanged(const QString& directoryPath,
+            const ScannerFileStat& directoryStat);
     void trackExists(const QString& filePath);
+    // The file of an existing track has been modified or its stats have
+    // not been stored yet. Only emitted by incremental scans.
+    void trackFileChanged(const QString& filePath,
+            const ScannerFileStat& fileStat);
     void addNewTrack(const QString& filePath);
 
     // Feedback to GUI
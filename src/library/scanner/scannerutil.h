@@ -1,9 +1,86 @@
 #pragma once
 
+#include <QDateTime>
 #include <QDir>
+#include <QFileInfo>
+#include <QMetaType>
 #include <QStandardPaths>
 #include <QStringList>
 
+#ifdef Q_OS_UNIX
+#include <sys/stat.h>
+#endif
+
+/// The properties of a file system entry that are compared by an
+/// incremental library scan. The modification time of a directory
+/// changes when entries are added, removed or renamed, but not when
+/// the content of a file is modified.
+///
+/// Network file systems like NFS, SMB/CIFS or mounted NAS shares may
+/// report coarse or cached modification times and don't deliver inotify
+/// events for changes made by other hosts. Libraries on these mounts
+/// should be rescanned with a regular (non incremental) scan after they
+/// have been modified remotely.
+struct ScannerFileStat {
+    /// Milliseconds since 1970-01-01T00:00:00.000 UTC or -1 if unknown
+    qint64 modifiedMillis = -1;
+    qint64 sizeInBytes = -1;
+    /// 0 if not available
+    quint64 inode = 0;
+
+    bool isValid() const {
+        return modifiedMillis >= 0;
+    }
+
+    static ScannerFileStat fromPath(const QString& path) {
+        ScannerFileStat fileStat;
+#ifdef Q_OS_UNIX
+        struct stat statBuf;
+        if (::stat(QFile::encodeName(path).constData(), &statBuf) != 0) {
+            return fileStat;
+        }
+#ifdef Q_OS_MACOS
+        const auto& modified = statBuf.st_mtimespec;
+#else
+        const auto& modified = statBuf.st_mtim;
+#endif
+        fileStat.modifiedMillis = static_cast<qint64>(modified.tv_sec) * 1000 +
+                modified.tv_nsec / 1000000;
+        fileStat.sizeInBytes = statBuf.st_size;
+        fileStat.inode = statBuf.st_ino;
+#else
+        const QFileInfo fileInfo(path);
+        if (!fileInfo.exists()) {
+            return fileStat;
+        }
+        fileStat.modifiedMillis = fileInfo.lastModified().toMSecsSinceEpoch();
+        fileStat.sizeInBytes = fileInfo.size();
+#endif
+        return fileStat;
+    }
+
+    /// The size of a directory depends on the file system and is not
+    /// stored in the database. It is reset to make the stat comparable
+    /// with the stats from LibraryHashDAO::getDirectoryStats().
+    static ScannerFileStat fromDirectoryPath(const QString& path) {
+        ScannerFileStat dirStat = fromPath(path);
+        dirStat.sizeInBytes = -1;
+        return dirStat;
+    }
+};
+
+inline bool operator==(const ScannerFileStat& lhs, const ScannerFileStat& rhs) {
+    return lhs.modifiedMillis == rhs.modifiedMillis &&
+            lhs.sizeInBytes == rhs.sizeInBytes &&
+            lhs.inode == rhs.inode;
+}
+
+inline bool operator!=(const ScannerFileStat& lhs, const ScannerFileStat& rhs) {
+    return !(lhs == rhs);
+}
+
+Q_DECLARE_METATYPE(ScannerFileStat);
+
 // Library scanner utility methods.
 class ScannerUtil {
   public:
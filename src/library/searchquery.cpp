@@ -2,6 +2,7 @@
 
 #include <QRegularExpression>
 #include <QtDebug>
+#include <array>
 
 #include "library/dao/trackschema.h"
 #include "library/queryutil.h"
@@ -22,6 +23,47 @@ const QRegularExpression kDurationRegex(QStringLiteral("^(\\d+)(m|:)?([0-5]?\\d)
 // > the entire expression matches, is the one that is chosen. This means that alternatives
 // > are not necessarily greedy.
 const QRegularExpression kNumericOperatorRegex(QStringLiteral("^(<=|>=|=|<|>)(.*)$"));
+
+// Combines the selections of the clauses of an SQL OR expression
+void orSelection(TrackCacheIndex::Selection* pSelection,
+        const TrackCacheIndex::Selection& other) {
+    pSelection->matched |= other.matched;
+    pSelection->unknown |= other.unknown;
+    pSelection->unknown.subtract(pSelection->matched);
+}
+
+// Combines the selections of the clauses of an SQL AND expression
+void andSelection(TrackCacheIndex::Selection* pSelection,
+        const TrackCacheIndex::Selection& other) {
+    TrackCacheIndex::RowSet notFalse = pSelection->matched;
+    notFalse |= pSelection->unknown;
+    TrackCacheIndex::RowSet otherNotFalse = other.matched;
+    otherNotFalse |= other.unknown;
+    pSelection->matched &= other.matched;
+    pSelection->unknown = std::move(notFalse);
+    pSelection->unknown &= otherNotFalse;
+    pSelection->unknown.subtract(pSelection->matched);
+}
+
+// Selects the rows for which the predicate is true for any of the columns
+template<typename Predicate>
+bool selectAnyNumeric(const TrackCacheIndex& index,
+        const QStringList& sqlColumns,
+        Predicate pred,
+        TrackCacheIndex::Selection* pSelection) {
+    *pSelection = TrackCacheIndex::Selection{
+            TrackCacheIndex::RowSet(index.rowCount()),
+            TrackCacheIndex::RowSet(index.rowCount())};
+    for (const auto& sqlColumn : sqlColumns) {
+        TrackCacheIndex::Selection columnSelection;
+        if (!index.selectNumeric(sqlColumn, pred, &columnSelection)) {
+            return false;
+        }
+        orSelection(pSelection, columnSelection);
+    }
+    return true;
+}
+
 } // namespace
 
 QVariant getTrackValueForColumn(const TrackPointer& pTrack, const QString& column) {
@@ -103,6 +145,19 @@ bool AndNode::match(const TrackPointer& pTrack) const {
     return true;
 }
 
+bool AndNode::select(const TrackCacheIndex& index,
+        TrackCacheIndex::Selection* pSelection) const {
+    *pSelection = index.selectAll();
+    for (const auto& pNode : m_nodes) {
+        TrackCacheIndex::Selection nodeSelection;
+        if (!pNode->select(index, &nodeSelection)) {
+            return false;
+        }
+        andSelection(pSelection, nodeSelection);
+    }
+    return true;
+}
+
 QString AndNode::toSql() const {
     QStringList queryFragments;
     queryFragments.reserve(static_cast<int>(m_nodes.size()));
@@ -132,6 +187,26 @@ bool OrNode::match(const TrackPointer& pTrack) const {
     return false;
 }
 
+bool OrNode::select(const TrackCacheIndex& index,
+        TrackCacheIndex::Selection* pSelection) const {
+    VERIFY_OR_DEBUG_ASSERT(!m_nodes.empty()) {
+        // Consistent with match()
+        *pSelection = index.selectAll();
+        return true;
+    }
+    *pSelection = TrackCacheIndex::Selection{
+            TrackCacheIndex::RowSet(index.rowCount()),
+            TrackCacheIndex::RowSet(index.rowCount())};
+    for (const auto& pNode : m_nodes) {
+        TrackCacheIndex::Selection nodeSelection;
+        if (!pNode->select(index, &nodeSelection)) {
+            return false;
+        }
+        orSelection(pSelection, nodeSelection);
+    }
+    return true;
+}
+
 QString OrNode::toSql() const {
     QStringList queryFragments;
     queryFragments.reserve(static_cast<int>(m_nodes.size()));
@@ -148,6 +223,20 @@ bool NotNode::match(const TrackPointer& pTrack) const {
     return !m_pNode->match(pTrack);
 }
 
+bool NotNode::select(const TrackCacheIndex& index,
+        TrackCacheIndex::Selection* pSelection) const {
+    TrackCacheIndex::Selection nodeSelection;
+    if (!m_pNode->select(index, &nodeSelection)) {
+        return false;
+    }
+    // NOT NULL is still NULL
+    *pSelection = index.selectAll();
+    pSelection->matched.subtract(nodeSelection.matched);
+    pSelection->matched.subtract(nodeSelection.unknown);
+    pSelection->unknown = std::move(nodeSelection.unknown);
+    return true;
+}
+
 QString NotNode::toSql() const {
     QString sql(m_pNode->toSql());
     if (sql.isEmpty()) {
@@ -185,6 +274,29 @@ bool TextFilterNode::match(const TrackPointer& pTrack) const {
     return false;
 }
 
+bool TextFilterNode::select(const TrackCacheIndex& index,
+        TrackCacheIndex::Selection* pSelection) const {
+    if (m_sqlColumns.isEmpty()) {
+        *pSelection = index.selectAll();
+        return true;
+    }
+    // See toSql()
+    const bool requireSuffix =
+            !m_argument.isEmpty() && m_argument[m_argument.size() - 1].isSpace();
+    *pSelection = TrackCacheIndex::Selection{
+            TrackCacheIndex::RowSet(index.rowCount()),
+            TrackCacheIndex::RowSet(index.rowCount())};
+    for (const auto& sqlColumn : m_sqlColumns) {
+        TrackCacheIndex::Selection columnSelection;
+        if (!index.selectContaining(
+                    sqlColumn, m_argument, requireSuffix, &columnSelection)) {
+            return false;
+        }
+        orSelection(pSelection, columnSelection);
+    }
+    return true;
+}
+
 QString TextFilterNode::toSql() const {
     FieldEscaper escaper(m_database);
     QString argument = m_argument;
@@ -216,6 +328,16 @@ bool NullOrEmptyTextFilterNode::match(const TrackPointer& pTrack) const {
     return false;
 }
 
+bool NullOrEmptyTextFilterNode::select(const TrackCacheIndex& index,
+        TrackCacheIndex::Selection* pSelection) const {
+    if (m_sqlColumns.isEmpty()) {
+        *pSelection = index.selectAll();
+        return true;
+    }
+    // only use the major column
+    return index.selectNullOrEmpty(m_sqlColumns.first(), pSelection);
+}
+
 QString NullOrEmptyTextFilterNode::toSql() const {
     if (!m_sqlColumns.isEmpty()) {
         // only use the major column
@@ -231,7 +353,7 @@ CrateFilterNode::CrateFilterNode(const CrateStorage* pCrateStorage,
           m_matchInitialized(false) {
 }
 
-bool CrateFilterNode::match(const TrackPointer& pTrack) const {
+const std::vector<TrackId>& CrateFilterNode::matchingTrackIds() const {
     if (!m_matchInitialized) {
         CrateTrackSelectResult crateTracks(
                 m_pCrateStorage->selectTracksSortedByCrateNameLike(m_crateNameLike));
@@ -242,8 +364,18 @@ bool CrateFilterNode::match(const TrackPointer& pTrack) const {
 
         m_matchInitialized = true;
     }
+    return m_matchingTrackIds;
+}
+
+bool CrateFilterNode::match(const TrackPointer& pTrack) const {
+    const auto& trackIds = matchingTrackIds();
+    return std::binary_search(trackIds.begin(), trackIds.end(), pTrack->getId());
+}
 
-    return std::binary_search(m_matchingTrackIds.begin(), m_matchingTrackIds.end(), pTrack->getId());
+bool CrateFilterNode::select(const TrackCacheIndex& index,
+        TrackCacheIndex::Selection* pSelection) const {
+    *pSelection = index.selectTracks(matchingTrackIds());
+    return true;
 }
 
 QString CrateFilterNode::toSql() const {
@@ -257,7 +389,7 @@ NoCrateFilterNode::NoCrateFilterNode(const CrateStorage* pCrateStorage)
           m_matchInitialized(false) {
 }
 
-bool NoCrateFilterNode::match(const TrackPointer& pTrack) const {
+const std::vector<TrackId>& NoCrateFilterNode::matchingTrackIds() const {
     if (!m_matchInitialized) {
         TrackSelectResult tracks(
                 m_pCrateStorage->selectAllTracksSorted());
@@ -268,8 +400,19 @@ bool NoCrateFilterNode::match(const TrackPointer& pTrack) const {
 
         m_matchInitialized = true;
     }
+    return m_matchingTrackIds;
+}
 
-    return !std::binary_search(m_matchingTrackIds.begin(), m_matchingTrackIds.end(), pTrack->getId());
+bool NoCrateFilterNode::match(const TrackPointer& pTrack) const {
+    const auto& trackIds = matchingTrackIds();
+    return !std::binary_search(trackIds.begin(), trackIds.end(), pTrack->getId());
+}
+
+bool NoCrateFilterNode::select(const TrackCacheIndex& index,
+        TrackCacheIndex::Selection* pSelection) const {
+    *pSelection = index.selectAll();
+    pSelection->matched.subtract(index.selectTracks(matchingTrackIds()).matched);
+    return true;
 }
 
 QString NoCrateFilterNode::toSql() const {
@@ -358,6 +501,52 @@ bool NumericFilterNode::match(const TrackPointer& pTrack) const {
     return false;
 }
 
+bool NumericFilterNode::select(const TrackCacheIndex& index,
+        TrackCacheIndex::Selection* pSelection) const {
+    if (m_bNullQuery) {
+        if (m_sqlColumns.isEmpty()) {
+            *pSelection = index.selectAll();
+            return true;
+        }
+        // only use the major column
+        return index.selectNull(m_sqlColumns.first(), pSelection);
+    }
+
+    if (m_bOperatorQuery) {
+        const double arg = m_dOperatorArgument;
+        if (m_operator == "=") {
+            return selectAnyNumeric(
+                    index, m_sqlColumns, [arg](double value) { return value == arg; }, pSelection);
+        } else if (m_operator == "<") {
+            return selectAnyNumeric(
+                    index, m_sqlColumns, [arg](double value) { return value < arg; }, pSelection);
+        } else if (m_operator == ">") {
+            return selectAnyNumeric(
+                    index, m_sqlColumns, [arg](double value) { return value > arg; }, pSelection);
+        } else if (m_operator == "<=") {
+            return selectAnyNumeric(
+                    index, m_sqlColumns, [arg](double value) { return value <= arg; }, pSelection);
+        } else if (m_operator == ">=") {
+            return selectAnyNumeric(
+                    index, m_sqlColumns, [arg](double value) { return value >= arg; }, pSelection);
+        }
+        return false;
+    }
+
+    if (m_bRangeQuery) {
+        const double low = m_dRangeLow;
+        const double high = m_dRangeHigh;
+        return selectAnyNumeric(
+                index,
+                m_sqlColumns,
+                [low, high](double value) { return value >= low && value <= high; },
+                pSelection);
+    }
+
+    *pSelection = index.selectAll();
+    return true;
+}
+
 QString NumericFilterNode::toSql() const {
     if (m_bNullQuery) {
         for (const auto& sqlColumn : m_sqlColumns) {
@@ -408,6 +597,16 @@ bool NullNumericFilterNode::match(const TrackPointer& pTrack) const {
     return false;
 }
 
+bool NullNumericFilterNode::select(const TrackCacheIndex& index,
+        TrackCacheIndex::Selection* pSelection) const {
+    if (m_sqlColumns.isEmpty()) {
+        *pSelection = index.selectAll();
+        return true;
+    }
+    // only use the major column
+    return index.selectNull(m_sqlColumns.first(), pSelection);
+}
+
 QString NullNumericFilterNode::toSql() const {
     if (!m_sqlColumns.isEmpty()) {
         // only use the major column
@@ -466,6 +665,35 @@ bool KeyFilterNode::match(const TrackPointer& pTrack) const {
     return m_matchKeys.contains(pTrack->getKey());
 }
 
+bool KeyFilterNode::select(const TrackCacheIndex& index,
+        TrackCacheIndex::Selection* pSelection) const {
+    if (m_matchKeys.isEmpty()) {
+        *pSelection = index.selectAll();
+        return true;
+    }
+    std::array<bool, 25> matchKeyIds{};
+    for (const auto& matchKey : m_matchKeys) {
+        if (matchKey >= 0 && matchKey < static_cast<int>(matchKeyIds.size())) {
+            matchKeyIds[matchKey] = true;
+        }
+    }
+    if (!index.selectNumeric(
+                LIBRARYTABLE_KEY_ID,
+                [&matchKeyIds](double value) {
+                    // Also false for NaN
+                    return value >= 0 &&
+                            value < static_cast<double>(matchKeyIds.size()) &&
+                            matchKeyIds[static_cast<int>(value)] &&
+                            value == static_cast<int>(value);
+                },
+                pSelection)) {
+        return false;
+    }
+    // key_id IS NULL is false and not NULL
+    pSelection->unknown = TrackCacheIndex::RowSet(index.rowCount());
+    return true;
+}
+
 QString KeyFilterNode::toSql() const {
     QStringList searchClauses;
     for (const auto& matchKey : m_matchKeys) {
@@ -8,6 +8,7 @@
 #include <utility>
 #include <vector>
 
+#include "library/trackcacheindex.h"
 #include "library/trackset/crate/cratestorage.h"
 #include "proto/keys.pb.h"
 #include "track/track_decl.h"
@@ -26,6 +27,15 @@ class QueryNode {
     virtual bool match(const TrackPointer& pTrack) const = 0;
     virtual QString toSql() const = 0;
 
+    /// Evaluates the query for all rows of the index with the same result
+    /// as the SQL query. Returns false if this is not possible.
+    virtual bool select(const TrackCacheIndex& index,
+            TrackCacheIndex::Selection* pSelection) const {
+        Q_UNUSED(index);
+        Q_UNUSED(pSelection);
+        return false;
+    }
+
   protected:
     QueryNode() = default;
 
@@ -50,12 +60,16 @@ class OrNode : public GroupNode {
   public:
     bool match(const TrackPointer& pTrack) const override;
     QString toSql() const override;
+    bool select(const TrackCacheIndex& index,
+            TrackCacheIndex::Selection* pSelection) const override;
 };
 
 class AndNode : public GroupNode {
   public:
     bool match(const TrackPointer& pTrack) const override;
     QString toSql() const override;
+    bool select(const TrackCacheIndex& index,
+            TrackCacheIndex::Selection* pSelection) const override;
 };
 
 class NotNode : public QueryNode {
@@ -67,6 +81,8 @@ class NotNode : public QueryNode {
 
     bool match(const TrackPointer& pTrack) const override;
     QString toSql() const override;
+    bool select(const TrackCacheIndex& index,
+            TrackCacheIndex::Selection* pSelection) const override;
 
   private:
     std::unique_ptr<QueryNode> m_pNode;
@@ -80,6 +96,8 @@ class TextFilterNode : public QueryNode {
 
     bool match(const TrackPointer& pTrack) const override;
     QString toSql() const override;
+    bool select(const TrackCacheIndex& index,
+            TrackCacheIndex::Selection* pSelection) const override;
 
   private:
     QSqlDatabase m_database;
@@ -97,6 +115,8 @@ class NullOrEmptyTextFilterNode : public QueryNode {
 
     bool match(const TrackPointer& pTrack) const override;
     QString toSql() const override;
+    bool select(const TrackCacheIndex& index,
+            TrackCacheIndex::Selection* pSelection) const override;
 
   private:
     QSqlDatabase m_database;
@@ -110,8 +130,12 @@ class CrateFilterNode : public QueryNode {
 
     bool match(const TrackPointer& pTrack) const override;
     QString toSql() const override;
+    bool select(const TrackCacheIndex& index,
+            TrackCacheIndex::Selection* pSelection) const override;
 
   private:
+    const std::vector<TrackId>& matchingTrackIds() const;
+
     const CrateStorage* m_pCrateStorage;
     QString m_crateNameLike;
     mutable bool m_matchInitialized;
@@ -124,8 +148,12 @@ class NoCrateFilterNode : public QueryNode {
 
     bool match(const TrackPointer& pTrack) const override;
     QString toSql() const override;
+    bool select(const TrackCacheIndex& index,
+            TrackCacheIndex::Selection* pSelection) const override;
 
   private:
+    const std::vector<TrackId>& matchingTrackIds() const;
+
     const CrateStorage* m_pCrateStorage;
     QString m_crateNameLike;
     mutable bool m_matchInitialized;
@@ -138,6 +166,8 @@ class NumericFilterNode : public QueryNode {
 
     bool match(const TrackPointer& pTrack) const override;
     QString toSql() const override;
+    bool select(const TrackCacheIndex& index,
+            TrackCacheIndex::Selection* pSelection) const override;
 
   protected:
     // Single argument constructor for that does not call init()
@@ -168,6 +198,8 @@ class NullNumericFilterNode : public QueryNode {
 
     bool match(const TrackPointer& pTrack) const override;
     QString toSql() const override;
+    bool select(const TrackCacheIndex& index,
+            TrackCacheIndex::Selection* pSelection) const override;
 
     QStringList m_sqlColumns;
 };
@@ -186,6 +218,8 @@ class KeyFilterNode : public QueryNode {
 
     bool match(const TrackPointer& pTrack) const override;
     QString toSql() const override;
+    bool select(const TrackCacheIndex& index,
+            TrackCacheIndex::Selection* pSelection) const override;
 
   private:
     QList<mixxx::track::io::key::ChromaticKey> m_matchKeys;
@@ -211,6 +245,16 @@ class SqlNode : public QueryNode {
         return m_sql;
     }
 
+    bool select(const TrackCacheIndex& index,
+            TrackCacheIndex::Selection* pSelection) const override {
+        if (!m_sql.isEmpty()) {
+            // Arbitrary SQL cannot be evaluated in memory
+            return false;
+        }
+        *pSelection = index.selectAll();
+        return true;
+    }
+
   private:
     QString m_sql;
 };
@@ -0,0 +1,640 @@
+#include "library/trackcacheindex.h"
+
+#include <QDir>
+#include <algorithm>
+#include <functional>
+#include <limits>
+
+#include "library/dao/trackschema.h"
+#include "util/assert.h"
+#include "util/db/dbconnection.h"
+
+namespace {
+
+constexpr double kNullNumber = std::numeric_limits<double>::quiet_NaN();
+
+/// SQLite: cast(value as integer) for a text value uses the longest
+/// prefix that is a valid integer and 0 otherwise.
+qint64 castStringToInteger(const QString& value) {
+    int pos = 0;
+    while (pos < value.size() && value.at(pos).isSpace()) {
+        ++pos;
+    }
+    bool negative = false;
+    if (pos < value.size() && (value.at(pos) == '-' || value.at(pos) == '+')) {
+        negative = value.at(pos) == '-';
+        ++pos;
+    }
+    qint64 result = 0;
+    while (pos < value.size() && value.at(pos) >= '0' && value.at(pos) <= '9') {
+        result = result * 10 + (value.at(pos).unicode() - '0');
+        ++pos;
+    }
+    return negative ? -result : result;
+}
+
+/// SQLite: lower() only folds ASCII characters unless built with ICU
+QString toLowerAscii(const QString& value) {
+    QString result = value;
+    for (auto& ch : result) {
+        if (ch >= 'A' && ch <= 'Z') {
+            ch = QChar(ch.unicode() + ('a' - 'A'));
+        }
+    }
+    return result;
+}
+
+/// Assigns dense ranks starting at 1 to the values of a column that are
+/// sorted by lessThan. Values that compare equal share the same rank.
+template<typename T, typename LessThan>
+std::vector<int> rankValues(const std::vector<T>& values, LessThan lessThan) {
+    std::vector<int> order(values.size());
+    for (int i = 0; i < static_cast<int>(order.size()); ++i) {
+        order[i] = i;
+    }
+    std::sort(order.begin(), order.end(), [&values, &lessThan](int lhs, int rhs) {
+        return lessThan(values[lhs], values[rhs]);
+    });
+    std::vector<int> ranks(values.size());
+    int rank = 0;
+    for (int i = 0; i < static_cast<int>(order.size()); ++i) {
+        if (i == 0 || lessThan(values[order[i - 1]], values[order[i]])) {
+            ++rank;
+        }
+        ranks[order[i]] = rank;
+    }
+    return ranks;
+}
+
+} // anonymous namespace
+
+TrackCacheIndex::RowSet::RowSet(int size, bool value)
+        : m_size(size),
+          m_words((size + kBitsPerWord - 1) / kBitsPerWord,
+                  value ? ~quint64(0) : quint64(0)) {
+    trim();
+}
+
+void TrackCacheIndex::RowSet::resize(int size) {
+    DEBUG_ASSERT(size >= m_size);
+    m_size = size;
+    m_words.resize((size + kBitsPerWord - 1) / kBitsPerWord, 0);
+}
+
+void TrackCacheIndex::RowSet::trim() {
+    const int unusedBits = static_cast<int>(m_words.size()) * kBitsPerWord - m_size;
+    if (unusedBits > 0) {
+        m_words.back() &= ~quint64(0) >> unusedBits;
+    }
+}
+
+TrackCacheIndex::RowSet& TrackCacheIndex::RowSet::operator&=(const RowSet& other) {
+    DEBUG_ASSERT(m_size == other.m_size);
+    for (std::size_t i = 0; i < m_words.size(); ++i) {
+        m_words[i] &= other.m_words[i];
+    }
+    return *this;
+}
+
+TrackCacheIndex::RowSet& TrackCacheIndex::RowSet::operator|=(const RowSet& other) {
+    DEBUG_ASSERT(m_size == other.m_size);
+    for (std::size_t i = 0; i < m_words.size(); ++i) {
+        m_words[i] |= other.m_words[i];
+    }
+    return *this;
+}
+
+TrackCacheIndex::RowSet& TrackCacheIndex::RowSet::subtract(const RowSet& other) {
+    DEBUG_ASSERT(m_size == other.m_size);
+    for (std::size_t i = 0; i < m_words.size(); ++i) {
+        m_words[i] &= ~other.m_words[i];
+    }
+    return *this;
+}
+
+bool TrackCacheIndex::RowSet::isEmpty() const {
+    return std::all_of(m_words.begin(), m_words.end(), [](quint64 word) {
+        return word == 0;
+    });
+}
+
+int TrackCacheIndex::RowSet::count() const {
+    int result = 0;
+    for (quint64 word : m_words) {
+#if defined(__GNUC__)
+        result += __builtin_popcountll(word);
+#else
+        while (word != 0) {
+            word &= word - 1;
+            ++result;
+        }
+#endif
+    }
+    return result;
+}
+
+// static
+int TrackCacheIndex::RowSet::countTrailingZeros(quint64 word) {
+    DEBUG_ASSERT(word != 0);
+#if defined(__GNUC__)
+    return __builtin_ctzll(word);
+#else
+    int result = 0;
+    while ((word & 1) == 0) {
+        word >>= 1;
+        ++result;
+    }
+    return result;
+#endif
+}
+
+TrackCacheIndex::TrackCacheIndex(QVector<Column> columns)
+        : m_columns(std::move(columns)),
+          m_keyNotation(KeyUtils::KeyNotation::Custom),
+          m_valid(false) {
+    for (int i = 0; i < m_columns.size(); ++i) {
+        m_columnIndicesByName.insert(m_columns[i].name, i);
+    }
+}
+
+void TrackCacheIndex::invalidate() {
+    m_valid = false;
+    m_columnData.clear();
+    m_trackIds.clear();
+    m_rowsByTrackId.clear();
+    m_liveRows = RowSet();
+}
+
+void TrackCacheIndex::build(const QHash<TrackId, QVector<QVariant>>& trackInfo) {
+    invalidate();
+    const int numRows = trackInfo.size();
+    m_columnData.resize(m_columns.size());
+    for (int i = 0; i < m_columns.size(); ++i) {
+        ColumnData& column = m_columnData[i];
+        column.info = m_columns[i];
+        // A single string turns the whole column into a string column
+        for (auto it = trackInfo.constBegin(); it != trackInfo.constEnd(); ++it) {
+            const ColumnType type = typeOfValue(it.value().value(i));
+            if (type == ColumnType::String) {
+                column.type = ColumnType::String;
+                break;
+            } else if (type == ColumnType::Numeric) {
+                column.type = ColumnType::Numeric;
+            }
+        }
+    }
+    m_trackIds.reserve(numRows);
+    m_rowsByTrackId.reserve(numRows);
+    m_valid = true;
+    for (auto it = trackInfo.constBegin(); it != trackInfo.constEnd(); ++it) {
+        updateRow(it.key(), it.value());
+        VERIFY_OR_DEBUG_ASSERT(m_valid) {
+            return;
+        }
+    }
+}
+
+// static
+TrackCacheIndex::ColumnType TrackCacheIndex::typeOfValue(const QVariant& value) {
+    if (value.isNull()) {
+        return ColumnType::Null;
+    }
+    switch (value.userType()) {
+    case QMetaType::Bool:
+    case QMetaType::Int:
+    case QMetaType::UInt:
+    case QMetaType::LongLong:
+    case QMetaType::ULongLong:
+    case QMetaType::Float:
+    case QMetaType::Double:
+        return ColumnType::Numeric;
+    default:
+        return ColumnType::String;
+    }
+}
+
+int TrackCacheIndex::appendRow(TrackId trackId) {
+    const int row = rowCount();
+    m_trackIds.push_back(trackId);
+    m_rowsByTrackId.insert(trackId, row);
+    m_liveRows.resize(row + 1);
+    m_liveRows.set(row);
+    for (auto& column : m_columnData) {
+        column.nullRows.resize(row + 1);
+        column.nullRows.set(row);
+        if (column.type == ColumnType::Numeric) {
+            column.numbers.push_back(kNullNumber);
+        } else if (column.type == ColumnType::String) {
+            column.stringIds.push_back(-1);
+        }
+        column.sortKeys.clear();
+    }
+    return row;
+}
+
+void TrackCacheIndex::updateRow(TrackId trackId, const QVector<QVariant>& values) {
+    if (!m_valid) {
+        return;
+    }
+    int row = rowForTrackId(trackId);
+    if (row < 0) {
+        if (rowCount() > 2 * m_rowsByTrackId.size() + 1024) {
+            // Too many rows of removed tracks
+            invalidate();
+            return;
+        }
+        row = appendRow(trackId);
+    }
+    for (int i = 0; i < static_cast<int>(m_columnData.size()); ++i) {
+        if (!setValue(&m_columnData[i], row, values.value(i))) {
+            invalidate();
+            return;
+        }
+    }
+}
+
+bool TrackCacheIndex::setValue(ColumnData* pColumn, int row, const QVariant& value) {
+    const ColumnType type = typeOfValue(value);
+    if (type == ColumnType::Null) {
+        if (pColumn->nullRows.test(row)) {
+            return true;
+        }
+        pColumn->nullRows.set(row);
+        if (pColumn->type == ColumnType::Numeric) {
+            pColumn->numbers[row] = kNullNumber;
+        } else {
+            setStringId(pColumn, row, -1);
+        }
+        pColumn->sortKeys.clear();
+        return true;
+    }
+    if (pColumn->type == ColumnType::Null) {
+        // All other values are NULL
+        pColumn->type = type;
+        if (type == ColumnType::Numeric) {
+            pColumn->numbers.assign(rowCount(), kNullNumber);
+        } else {
+            pColumn->stringIds.assign(rowCount(), -1);
+        }
+    }
+    pColumn->nullRows.reset(row);
+    if (pColumn->type == ColumnType::Numeric) {
+        if (type != ColumnType::Numeric) {
+            // Needs to be converted into a string column
+            return false;
+        }
+        const double number = value.toDouble();
+        if (pColumn->numbers[row] != number) {
+            pColumn->numbers[row] = number;
+            pColumn->sortKeys.clear();
+        }
+    } else {
+        const int stringId = internString(pColumn, value.toString());
+        if (pColumn->stringIds[row] != stringId) {
+            setStringId(pColumn, row, stringId);
+            pColumn->sortKeys.clear();
+        }
+    }
+    return true;
+}
+
+int TrackCacheIndex::internString(ColumnData* pColumn, const QString& value) {
+    const auto it = pColumn->stringIdsByValue.constFind(value);
+    if (it != pColumn->stringIdsByValue.constEnd()) {
+        return it.value();
+    }
+    QString folded = pColumn->info.isLocation
+            ? QDir::fromNativeSeparators(value)
+            : value;
+    mixxx::DbConnection::makeStringLatinLow(&folded);
+    int stringId;
+    if (pColumn->freeStringIds.empty()) {
+        stringId = static_cast<int>(pColumn->strings.size());
+        pColumn->strings.push_back(value);
+        pColumn->foldedStrings.push_back(folded);
+        pColumn->stringRefCounts.push_back(0);
+    } else {
+        stringId = pColumn->freeStringIds.back();
+        pColumn->freeStringIds.pop_back();
+        pColumn->strings[stringId] = value;
+        pColumn->foldedStrings[stringId] = folded;
+    }
+    pColumn->stringIdsByValue.insert(value, stringId);
+    return stringId;
+}
+
+void TrackCacheIndex::setStringId(ColumnData* pColumn, int row, int stringId) {
+    const int oldStringId = pColumn->stringIds[row];
+    if (oldStringId == stringId) {
+        return;
+    }
+    if (stringId >= 0) {
+        ++pColumn->stringRefCounts[stringId];
+    }
+    pColumn->stringIds[row] = stringId;
+    if (oldStringId >= 0 && --pColumn->stringRefCounts[oldStringId] == 0) {
+        // Released strings keep their slot and are skipped by all rows
+        pColumn->stringIdsByValue.remove(pColumn->strings[oldStringId]);
+        pColumn->strings[oldStringId] = QString();
+        pColumn->foldedStrings[oldStringId] = QString();
+        pColumn->freeStringIds.push_back(oldStringId);
+    }
+}
+
+void TrackCacheIndex::removeRow(TrackId trackId) {
+    const auto it = m_rowsByTrackId.find(trackId);
+    if (it == m_rowsByTrackId.end()) {
+        return;
+    }
+    const int row = it.value();
+    m_liveRows.reset(row);
+    m_rowsByTrackId.erase(it);
+    // Release the strings of the removed track
+    for (auto& column : m_columnData) {
+        if (column.type == ColumnType::String && !column.nullRows.test(row)) {
+            column.nullRows.set(row);
+            setStringId(&column, row, -1);
+        }
+    }
+}
+
+void TrackCacheIndex::setKeyNotation(KeyUtils::KeyNotation keyNotation) {
+    if (m_keyNotation == keyNotation) {
+        return;
+    }
+    m_keyNotation = keyNotation;
+    for (auto& column : m_columnData) {
+        if (column.info.sortType == SortType::Key) {
+            column.sortKeys.clear();
+        }
+    }
+}
+
+const TrackCacheIndex::ColumnData* TrackCacheIndex::numericColumn(
+        const QString& column) const {
+    const int index = columnIndex(column);
+    if (index < 0 || index >= static_cast<int>(m_columnData.size())) {
+        return nullptr;
+    }
+    const ColumnData& columnData = m_columnData[index];
+    if (columnData.type == ColumnType::String) {
+        // SQLite compares text with numbers as text
+        return nullptr;
+    }
+    return &columnData;
+}
+
+const TrackCacheIndex::ColumnData* TrackCacheIndex::stringColumn(
+        const QString& column) const {
+    const int index = columnIndex(column);
+    if (index < 0 || index >= static_cast<int>(m_columnData.size())) {
+        return nullptr;
+    }
+    const ColumnData& columnData = m_columnData[index];
+    if (columnData.type == ColumnType::Numeric) {
+        // SQLite formats numbers differently than QVariant
+        return nullptr;
+    }
+    return &columnData;
+}
+
+TrackCacheIndex::Selection TrackCacheIndex::selectAll() const {
+    return Selection{m_liveRows, RowSet(rowCount())};
+}
+
+TrackCacheIndex::Selection TrackCacheIndex::selectTracks(
+        const std::vector<TrackId>& trackIds) const {
+    Selection selection{RowSet(rowCount()), RowSet(rowCount())};
+    for (const auto& trackId : trackIds) {
+        const int row = rowForTrackId(trackId);
+        if (row >= 0) {
+            selection.matched.set(row);
+        }
+    }
+    return selection;
+}
+
+bool TrackCacheIndex::selectContaining(
+        const QString& column,
+        const QString& foldedNeedle,
+        bool requireSuffix,
+        Selection* pSelection) const {
+    if (foldedNeedle.contains('%') || foldedNeedle.contains('_')) {
+        // Wildcards of the LIKE operator
+        return false;
+    }
+    const ColumnData* pColumn = stringColumn(column);
+    if (!pColumn) {
+        return false;
+    }
+    *pSelection = Selection{RowSet(rowCount()), pColumn->nullRows};
+    pSelection->unknown &= m_liveRows;
+    if (pColumn->type == ColumnType::Null) {
+        return true;
+    }
+
+    // Match each distinct string only once
+    std::vector<char> stringMatches(pColumn->foldedStrings.size());
+    for (std::size_t i = 0; i < stringMatches.size(); ++i) {
+        const QString& folded = pColumn->foldedStrings[i];
+        if (requireSuffix) {
+            // The last possible match must be followed by a character
+            stringMatches[i] = folded.size() > foldedNeedle.size() &&
+                    folded.lastIndexOf(foldedNeedle,
+                            folded.size() - foldedNeedle.size() - 1) >= 0;
+        } else {
+            stringMatches[i] = folded.contains(foldedNeedle);
+        }
+    }
+
+    const int* pStringIds = pColumn->stringIds.data();
+    const char* pStringMatches = stringMatches.data();
+    for (int row = 0; row < rowCount(); ++row) {
+        const int stringId = pStringIds[row];
+        if (stringId >= 0 && pStringMatches[stringId]) {
+            pSelection->matched.set(row);
+        }
+    }
+    pSelection->matched &= m_liveRows;
+    return true;
+}
+
+bool TrackCacheIndex::selectNullOrEmpty(
+        const QString& column, Selection* pSelection) const {
+    const ColumnData* pColumn = stringColumn(column);
+    if (!pColumn) {
+        return false;
+    }
+    *pSelection = Selection{pColumn->nullRows, RowSet(rowCount())};
+    if (pColumn->type == ColumnType::String) {
+        const auto it = pColumn->stringIdsByValue.constFind(QString(""));
+        if (it != pColumn->stringIdsByValue.constEnd()) {
+            const int emptyStringId = it.value();
+            for (int row = 0; row < rowCount(); ++row) {
+                if (pColumn->stringIds[row] == emptyStringId) {
+                    pSelection->matched.set(row);
+                }
+            }
+        }
+    }
+    pSelection->matched &= m_liveRows;
+    return true;
+}
+
+bool TrackCacheIndex::selectNull(
+        const QString& column, Selection* pSelection) const {
+    const int index = columnIndex(column);
+    if (index < 0 || index >= static_cast<int>(m_columnData.size())) {
+        return false;
+    }
+    *pSelection = Selection{m_columnData[index].nullRows, RowSet(rowCount())};
+    pSelection->matched &= m_liveRows;
+    return true;
+}
+
+bool TrackCacheIndex::updateSortKeys(ColumnData* pColumn) {
+    if (!pColumn->sortKeys.empty() || rowCount() == 0) {
+        return true;
+    }
+    std::vector<int> sortKeys(rowCount(), 0);
+    switch (pColumn->info.sortType) {
+    case SortType::Value:
+        // NULL < numbers < text
+        if (pColumn->type == ColumnType::Numeric) {
+            const std::vector<int> ranks = rankValues(pColumn->numbers,
+                    [](double lhs, double rhs) {
+                        // NaN for NULL first
+                        return (std::isnan(lhs) && !std::isnan(rhs)) || lhs < rhs;
+                    });
+            for (int row = 0; row < rowCount(); ++row) {
+                sortKeys[row] = ranks[row];
+            }
+        } else if (pColumn->type == ColumnType::String) {
+            const std::vector<int> ranks = rankValues(pColumn->strings,
+                    [](const QString& lhs, const QString& rhs) {
+                        return lhs < rhs;
+                    });
+            for (int row = 0; row < rowCount(); ++row) {
+                const int stringId = pColumn->stringIds[row];
+                sortKeys[row] = stringId >= 0 ? ranks[stringId] : 0;
+            }
+        }
+        break;
+    case SortType::Collated:
+    case SortType::CaseInsensitive:
+        if (pColumn->type == ColumnType::Numeric) {
+            // lower() converts numbers into text
+            return false;
+        } else if (pColumn->type == ColumnType::String) {
+            std::vector<int> ranks;
+            if (pColumn->info.sortType == SortType::Collated) {
+                ranks = rankValues(pColumn->strings,
+                        [this](const QString& lhs, const QString& rhs) {
+                            return m_collator.compare(lhs, rhs) < 0;
+                        });
+            } else {
+                // Same folding and byte order as lower(column) in SQLite
+                std::vector<QByteArray> lowerStrings;
+                lowerStrings.reserve(pColumn->strings.size());
+                for (const auto& string : pColumn->strings) {
+                    lowerStrings.push_back(toLowerAscii(string).toUtf8());
+                }
+                ranks = rankValues(lowerStrings,
+                        [](const QByteArray& lhs, const QByteArray& rhs) {
+                            return lhs < rhs;
+                        });
+            }
+            for (int row = 0; row < rowCount(); ++row) {
+                const int stringId = pColumn->stringIds[row];
+                sortKeys[row] = stringId >= 0 ? ranks[stringId] : 0;
+            }
+        }
+        break;
+    case SortType::Integer: {
+        if (pColumn->type == ColumnType::Null) {
+            break;
+        }
+        // NULL stays NULL and is sorted first
+        std::vector<qint64> integers(rowCount(), std::numeric_limits<qint64>::min());
+        if (pColumn->type == ColumnType::Numeric) {
+            for (int row = 0; row < rowCount(); ++row) {
+                if (!std::isnan(pColumn->numbers[row])) {
+                    integers[row] = static_cast<qint64>(pColumn->numbers[row]);
+                }
+            }
+        } else {
+            std::vector<qint64> stringIntegers;
+            stringIntegers.reserve(pColumn->strings.size());
+            for (const auto& string : pColumn->strings) {
+                stringIntegers.push_back(castStringToInteger(string));
+            }
+            for (int row = 0; row < rowCount(); ++row) {
+                const int stringId = pColumn->stringIds[row];
+                if (stringId >= 0) {
+                    integers[row] = stringIntegers[stringId];
+                }
+            }
+        }
+        sortKeys = rankValues(integers, std::less<qint64>());
+        break;
+    }
+    case SortType::Key: {
+        const int keyIdColumn = columnIndex(LIBRARYTABLE_KEY_ID);
+        if (keyIdColumn < 0 ||
+                m_columnData[keyIdColumn].type == ColumnType::String) {
+            return false;
+        }
+        const ColumnData& keyIds = m_columnData[keyIdColumn];
+        if (keyIds.type == ColumnType::Null) {
+            break;
+        }
+        for (int row = 0; row < rowCount(); ++row) {
+            const double keyId = keyIds.numbers[row];
+            // CASE key_id WHEN 0 ... WHEN 24 END, i.e. NULL otherwise
+            if (keyId >= 0 && keyId <= 24 && keyId == std::floor(keyId)) {
+                sortKeys[row] = 1 +
+                        KeyUtils::keyToCircleOfFifthsOrder(
+                                static_cast<mixxx::track::io::key::ChromaticKey>(
+                                        static_cast<int>(keyId)),
+                                m_keyNotation);
+            }
+        }
+        break;
+    }
+    }
+    pColumn->sortKeys = std::move(sortKeys);
+    return true;
+}
+
+bool TrackCacheIndex::sortRows(
+        std::vector<int>* pRows, const std::vector<SortKey>& sortKeys) {
+    std::vector<std::pair<const int*, bool>> keyColumns;
+    keyColumns.reserve(sortKeys.size());
+    for (const auto& sortKey : sortKeys) {
+        if (sortKey.column < 0 ||
+                sortKey.column >= static_cast<int>(m_columnData.size())) {
+            return false;
+        }
+        ColumnData* pColumn = &m_columnData[sortKey.column];
+        if (!updateSortKeys(pColumn)) {
+            return false;
+        }
+        if (rowCount() > 0) {
+            keyColumns.emplace_back(
+                    pColumn->sortKeys.data(),
+                    sortKey.order == Qt::DescendingOrder);
+        }
+    }
+    if (keyColumns.empty()) {
+        return true;
+    }
+    std::stable_sort(pRows->begin(), pRows->end(), [&keyColumns](int lhs, int rhs) {
+        for (const auto& [pKeys, descending] : keyColumns) {
+            if (pKeys[lhs] != pKeys[rhs]) {
+                return descending ? pKeys[lhs] > pKeys[rhs] : pKeys[lhs] < pKeys[rhs];
+            }
+        }
+        return false;
+    });
+    return true;
+}
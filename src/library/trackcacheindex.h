@@ -0,0 +1,256 @@
+#pragma once
+
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <QVariant>
+#include <QVector>
+#include <cmath>
+#include <vector>
+
+#include "track/keyutils.h"
+#include "track/trackid.h"
+#include "util/string.h"
+
+/// TrackCacheIndex is a column oriented copy of the rows of a BaseTrackCache
+/// for filtering and sorting tracks in memory instead of querying the
+/// database.
+///
+/// Each column is stored either as a plain array of doubles or as an array of
+/// ids of interned strings. The folded lower-case form of each distinct string
+/// is computed once when the string is interned, i.e. text filters only need
+/// to scan the distinct strings of a column and then the ids of all rows.
+/// Sort keys that reflect the collation order of the column are computed
+/// lazily and reused until the values of the column change.
+///
+/// The results of query nodes are bitsets with one bit per row. Queries are
+/// evaluated with the three-valued logic of SQL, i.e. comparisons with NULL
+/// are neither true nor false, to select exactly the same tracks as the
+/// SQL query that is generated from the same query nodes. Operations that
+/// cannot be evaluated exactly report a failure and the caller needs to fall
+/// back to the database.
+///
+/// Rows of removed tracks are only marked as deleted and reused when the index
+/// is rebuilt. Interned strings are reference counted and the ids of strings
+/// that are no longer referenced by any row are reused.
+class TrackCacheIndex final {
+  public:
+    /// The order of a column as defined by ColumnCache::columnSortForFieldIndex()
+    enum class SortType {
+        /// The plain values of the column
+        Value,
+        /// lower(column) COLLATE with the locale aware StringCollator
+        Collated,
+        /// lower(column), which only folds ASCII characters, compared
+        /// with the BINARY collation, i.e. by UTF-8 bytes
+        CaseInsensitive,
+        /// cast(column as integer)
+        Integer,
+        /// The circle of fifths order of the key_id column
+        Key,
+    };
+
+    struct Column {
+        QString name;
+        SortType sortType = SortType::Value;
+        /// The values are locations with native separators while the
+        /// database stores them with Qt separators
+        bool isLocation = false;
+    };
+
+    struct SortKey {
+        int column;
+        Qt::SortOrder order;
+    };
+
+    class RowSet final {
+      public:
+        explicit RowSet(int size = 0, bool value = false);
+
+        int size() const {
+            return m_size;
+        }
+        void resize(int size);
+
+        bool test(int row) const {
+            return (m_words[row / kBitsPerWord] >> (row % kBitsPerWord)) & 1;
+        }
+        void set(int row) {
+            m_words[row / kBitsPerWord] |= quint64(1) << (row % kBitsPerWord);
+        }
+        void reset(int row) {
+            m_words[row / kBitsPerWord] &= ~(quint64(1) << (row % kBitsPerWord));
+        }
+
+        RowSet& operator&=(const RowSet& other);
+        RowSet& operator|=(const RowSet& other);
+        /// Removes all rows that are contained in other
+        RowSet& subtract(const RowSet& other);
+
+        bool isEmpty() const;
+        int count() const;
+
+        /// Invokes fn(row) in ascending order for all contained rows
+        template<typename Fn>
+        void forEach(Fn fn) const {
+            for (int i = 0; i < static_cast<int>(m_words.size()); ++i) {
+                quint64 word = m_words[i];
+                while (word != 0) {
+                    fn(i * kBitsPerWord + countTrailingZeros(word));
+                    word &= word - 1;
+                }
+            }
+        }
+
+      private:
+        static constexpr int kBitsPerWord = 64;
+
+        static int countTrailingZeros(quint64 word);
+
+        // Clears the unused bits of the last word
+        void trim();
+
+        int m_size;
+        std::vector<quint64> m_words;
+    };
+
+    /// The result of a query node. A row is never contained in both sets.
+    struct Selection {
+        /// The rows for which the query evaluates to true
+        RowSet matched;
+        /// The rows for which the query evaluates to NULL
+        RowSet unknown;
+    };
+
+    explicit TrackCacheIndex(QVector<Column> columns);
+
+    bool isValid() const {
+        return m_valid;
+    }
+    /// Discards all rows. The index needs to be rebuilt before it could be
+    /// used again.
+    void invalidate();
+
+    /// Rebuilds the index from all rows of a BaseTrackCache
+    void build(const QHash<TrackId, QVector<QVariant>>& trackInfo);
+
+    /// Updates or adds a single row. Invalidates the index if the row could
+    /// not be updated in place, e.g. if the type of a column changes.
+    void updateRow(TrackId trackId, const QVector<QVariant>& values);
+    void removeRow(TrackId trackId);
+
+    void setKeyNotation(KeyUtils::KeyNotation keyNotation);
+
+    int rowCount() const {
+        return static_cast<int>(m_trackIds.size());
+    }
+    int columnIndex(const QString& name) const {
+        return m_columnIndicesByName.value(name, -1);
+    }
+    int rowForTrackId(TrackId trackId) const {
+        return m_rowsByTrackId.value(trackId, -1);
+    }
+    TrackId trackIdForRow(int row) const {
+        return m_trackIds[row];
+    }
+
+    /// A selection that matches all rows that have not been removed
+    Selection selectAll() const;
+    /// A selection that matches the rows of the given tracks
+    Selection selectTracks(const std::vector<TrackId>& trackIds) const;
+
+    /// column LIKE '%needle%' for a needle that has been folded with
+    /// DbConnection::makeStringLatinLow(). If requireSuffix is set at least
+    /// one more character needs to follow the needle.
+    bool selectContaining(
+            const QString& column,
+            const QString& foldedNeedle,
+            bool requireSuffix,
+            Selection* pSelection) const;
+    /// column IS NULL OR column IS ''
+    bool selectNullOrEmpty(const QString& column, Selection* pSelection) const;
+    /// column IS NULL
+    bool selectNull(const QString& column, Selection* pSelection) const;
+    /// Evaluates pred(value) for the numeric values of a column
+    template<typename Predicate>
+    bool selectNumeric(
+            const QString& column,
+            Predicate pred,
+            Selection* pSelection) const {
+        const ColumnData* pColumn = numericColumn(column);
+        if (!pColumn) {
+            return false;
+        }
+        *pSelection = Selection{RowSet(rowCount()), pColumn->nullRows};
+        pSelection->unknown &= m_liveRows;
+        if (pColumn->type == ColumnType::Numeric) {
+            const double* pValues = pColumn->numbers.data();
+            for (int row = 0; row < rowCount(); ++row) {
+                // NaN for NULL never satisfies a comparison
+                if (pred(pValues[row])) {
+                    pSelection->matched.set(row);
+                }
+            }
+            pSelection->matched &= m_liveRows;
+        }
+        return true;
+    }
+
+    /// Sorts the rows by the given columns. The order of rows that compare
+    /// equal is preserved.
+    bool sortRows(std::vector<int>* pRows, const std::vector<SortKey>& sortKeys);
+
+  private:
+    friend class TrackCacheIndexTest;
+
+    enum class ColumnType {
+        /// All values are NULL
+        Null,
+        Numeric,
+        String,
+    };
+
+    struct ColumnData {
+        Column info;
+        ColumnType type = ColumnType::Null;
+        RowSet nullRows;
+        // ColumnType::Numeric, NaN for NULL
+        std::vector<double> numbers;
+        // ColumnType::String, -1 for NULL
+        std::vector<int> stringIds;
+        std::vector<QString> strings;
+        std::vector<QString> foldedStrings;
+        // The number of rows that reference each string
+        std::vector<int> stringRefCounts;
+        // Ids of released strings for reuse
+        std::vector<int> freeStringIds;
+        QHash<QString, int> stringIdsByValue;
+        // The rank of each row in the sort order of the column, 0 for NULL.
+        // Empty if invalid.
+        std::vector<int> sortKeys;
+    };
+
+    static ColumnType typeOfValue(const QVariant& value);
+
+    const ColumnData* numericColumn(const QString& column) const;
+    const ColumnData* stringColumn(const QString& column) const;
+
+    int appendRow(TrackId trackId);
+    bool setValue(ColumnData* pColumn, int row, const QVariant& value);
+    int internString(ColumnData* pColumn, const QString& value);
+    void setStringId(ColumnData* pColumn, int row, int stringId);
+
+    bool updateSortKeys(ColumnData* pColumn);
+
+    const QVector<Column> m_columns;
+    QHash<QString, int> m_columnIndicesByName;
+
+    const mixxx::StringCollator m_collator;
+    KeyUtils::KeyNotation m_keyNotation;
+
+    bool m_valid;
+    std::vector<ColumnData> m_columnData;
+    std::vector<TrackId> m_trackIds;
+    QHash<TrackId, int> m_rowsByTrackId;
+    RowSet m_liveRows;
+};
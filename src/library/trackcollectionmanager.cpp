@@ -6,6 +6,7 @@
 #include "library/library_prefs.h"
 #include "library/scanner/libraryscanner.h"
 #include "library/trackcollection.h"
+#include "library/trackmetadataimportservice.h"
 #include "moc_trackcollectionmanager.cpp"
 #include "sources/soundsourceproxy.h"
 #include "track/track.h"
@@ -66,6 +67,17 @@ TrackCollectionManager::TrackCollectionManager(
         externalCollection->establishConnection();
     }
 
+    m_pMetadataImportService = std::make_unique<TrackMetadataImportService>(
+            [this](const TrackRef& trackRef) {
+                return getTrackByRef(trackRef);
+            });
+    connect(m_pMetadataImportService.get(),
+            &TrackMetadataImportService::tracksImported,
+            this,
+            [this](const TrackPointerList& tracks) {
+                afterTrackMetadataImported(tracks);
+            });
+
     // TODO: Extract and decouple LibraryScanner from TrackCollectionManager
     if (deleteTrackForTestingFn) {
         // Exclude the library scanner from tests
@@ -141,6 +153,10 @@ TrackCollectionManager::~TrackCollectionManager() {
         m_pScanner.reset();
     }
 
+    // Save all tracks that have already been imported
+    m_pMetadataImportService->shutdown();
+    m_pMetadataImportService.reset();
+
     const auto pWeakTrackSource = m_pInternalCollection->disconnectTrackSource();
     VERIFY_OR_DEBUG_ASSERT(pWeakTrackSource.isNull()) {
         kLogger.warning() << "BaseTrackCache is still in use";
@@ -563,6 +579,19 @@ void TrackCollectionManager::afterTracksRelocated(
     }
 }
 
+void TrackCollectionManager::afterTrackMetadataImported(
+        const TrackPointerList& tracks) const {
+    DEBUG_ASSERT_QOBJECT_THREAD_AFFINITY(this);
+
+    kLogger.debug()
+            << "Saving"
+            << tracks.size()
+            << "track(s) after importing metadata";
+    for (const auto& pTrack : tracks) {
+        saveTrack(pTrack);
+    }
+}
+
 TrackPointer TrackCollectionManager::getTrackById(
         TrackId trackId) const {
     return internalCollection()->getTrackById(
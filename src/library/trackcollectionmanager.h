@@ -15,6 +15,7 @@
 
 class LibraryScanner;
 class TrackCollection;
+class TrackMetadataImportService;
 class ExternalTrackCollection;
 
 // Manages Mixxx's internal database of tracks as well as external track collections.
@@ -47,6 +48,13 @@ class TrackCollectionManager: public QObject,
         return m_externalCollections;
     }
 
+    // Imports metadata from file tags in the background. Modified
+    // tracks are saved implicitly.
+    TrackMetadataImportService* metadataImportService() const {
+        DEBUG_ASSERT_QOBJECT_THREAD_AFFINITY(this);
+        return m_pMetadataImportService.get();
+    }
+
     TrackPointer getTrackById(
             TrackId trackId) const;
     TrackPointer getTrackByRef(
@@ -103,6 +111,7 @@ class TrackCollectionManager: public QObject,
     void afterTrackAdded(const TrackPointer& pTrack) const;
     void afterTracksUpdated(const QSet<TrackId>& updatedTrackIds) const;
     void afterTracksRelocated(const QList<RelocatedTrack>& relocatedTracks) const;
+    void afterTrackMetadataImported(const TrackPointerList& tracks) const;
 
     // Callback for GlobalTrackCache
     void saveEvictedTrack(Track* pTrack) noexcept override;
@@ -127,4 +136,6 @@ class TrackCollectionManager: public QObject,
 
     // TODO: Extract and decouple LibraryScanner from TrackCollectionManager
     std::unique_ptr<LibraryScanner> m_pScanner;
+
+    std::unique_ptr<TrackMetadataImportService> m_pMetadataImportService;
 };
@@ -0,0 +1,248 @@
+#include "library/trackmetadataimportservice.h"
+
+#include <QThread>
+#include <QtConcurrentRun>
+#include <utility>
+
+#include "moc_trackmetadataimportservice.cpp"
+#include "util/assert.h"
+#include "util/compatibility/qmutex.h"
+#include "util/logger.h"
+
+namespace {
+
+const mixxx::Logger kLogger("TrackMetadataImportService");
+
+// Number of tracks that are loaded in advance per worker thread.
+// Loading tracks from the database must be done on the GUI thread
+// and is spread out over time by refilling the queue of the workers
+// whenever requests have finished.
+constexpr int kRunningRequestsPerThread = 2;
+
+// Collect modified tracks for a short while before delivering them
+// to reduce the number of save operations on the GUI thread. The
+// tracks are delivered earlier if the batch is full.
+constexpr int kDeliveryIntervalMillis = 100;
+constexpr int kMaxDeliveryBatchSize = 256;
+
+bool isStrongerThan(
+        SoundSourceProxy::UpdateTrackFromSourceMode lhs,
+        SoundSourceProxy::UpdateTrackFromSourceMode rhs) {
+    return static_cast<int>(lhs) > static_cast<int>(rhs);
+}
+
+bool isTrackUpdated(
+        SoundSourceProxy::UpdateTrackFromSourceResult result) {
+    switch (result) {
+    case SoundSourceProxy::UpdateTrackFromSourceResult::MetadataImportedAndUpdated:
+    case SoundSourceProxy::UpdateTrackFromSourceResult::ExtraMetadataImportedAndMerged:
+        return true;
+    case SoundSourceProxy::UpdateTrackFromSourceResult::NotUpdated:
+    case SoundSourceProxy::UpdateTrackFromSourceResult::MetadataImportFailed:
+        return false;
+    }
+    DEBUG_ASSERT(!"unreachable");
+    return false;
+}
+
+} // anonymous namespace
+
+TrackMetadataImportService::TrackMetadataImportService(
+        LoadTrackFn loadTrackFn,
+        int maxThreadCount,
+        QObject* parent)
+        : QObject(parent),
+          m_loadTrackFn(std::move(loadTrackFn)),
+          m_maxRunningCount(kRunningRequestsPerThread *
+                  (maxThreadCount > 0 ? maxThreadCount : QThread::idealThreadCount())),
+          m_finishedCount(0),
+          m_totalCount(0),
+          m_finishedRequestsSignaled(0) {
+    DEBUG_ASSERT(m_loadTrackFn);
+    m_threadPool.setObjectName(QStringLiteral("TrackMetadataImportService"));
+    m_threadPool.setMaxThreadCount(
+            maxThreadCount > 0 ? maxThreadCount : QThread::idealThreadCount());
+    m_deliveryTimer.setSingleShot(true);
+    m_deliveryTimer.setInterval(kDeliveryIntervalMillis);
+    connect(&m_deliveryTimer,
+            &QTimer::timeout,
+            this,
+            &TrackMetadataImportService::slotDeliverImportedTracks);
+}
+
+TrackMetadataImportService::~TrackMetadataImportService() {
+    cancel();
+    // Results are discarded if shutdown() has not been invoked before
+    m_threadPool.waitForDone();
+}
+
+void TrackMetadataImportService::importTrackMetadata(
+        const QList<TrackRef>& trackRefs,
+        SoundSourceProxy::UpdateTrackFromSourceMode mode,
+        const SyncTrackMetadataParams& syncParams) {
+    int queuedCount = 0;
+    int mergedCount = 0;
+    for (const auto& trackRef : trackRefs) {
+        const QString& location = trackRef.getLocation();
+        VERIFY_OR_DEBUG_ASSERT(!location.isEmpty()) {
+            continue;
+        }
+        auto queued = m_queuedRequests.find(location);
+        if (queued != m_queuedRequests.end()) {
+            if (isStrongerThan(mode, queued->mode)) {
+                queued->mode = mode;
+            }
+            queued->syncParams = syncParams;
+            ++mergedCount;
+            continue;
+        }
+        const auto running = m_runningModes.constFind(location);
+        if (running != m_runningModes.constEnd() &&
+                !isStrongerThan(mode, running.value())) {
+            // The file is currently being read with the same or
+            // a stronger mode
+            ++mergedCount;
+            continue;
+        }
+        m_queuedTrackRefs.enqueue(trackRef);
+        m_queuedRequests.insert(location, Request{mode, syncParams});
+        ++queuedCount;
+    }
+    kLogger.debug()
+            << "Queued"
+            << queuedCount
+            << "and merged"
+            << mergedCount
+            << "requests";
+    m_totalCount += queuedCount;
+    startQueuedRequests();
+    updateProgress();
+}
+
+void TrackMetadataImportService::cancel() {
+    if (!m_queuedTrackRefs.isEmpty()) {
+        kLogger.info()
+                << "Canceling"
+                << m_queuedTrackRefs.size()
+                << "queued requests";
+    }
+    m_totalCount -= static_cast<int>(m_queuedTrackRefs.size());
+    m_queuedTrackRefs.clear();
+    m_queuedRequests.clear();
+    updateProgress();
+}
+
+void TrackMetadataImportService::shutdown() {
+    cancel();
+    m_threadPool.waitForDone();
+    slotProcessFinishedRequests();
+    slotDeliverImportedTracks();
+    DEBUG_ASSERT(m_runningModes.isEmpty());
+}
+
+void TrackMetadataImportService::startQueuedRequests() {
+    // Requests for files that are currently being read need to wait
+    // until the file has been read. They keep their position at the
+    // front of the queue.
+    QQueue<TrackRef> waitingTrackRefs;
+    while (m_runningModes.size() < m_maxRunningCount &&
+            !m_queuedTrackRefs.isEmpty()) {
+        TrackRef trackRef = m_queuedTrackRefs.dequeue();
+        QString location = trackRef.getLocation();
+        if (m_runningModes.contains(location)) {
+            waitingTrackRefs.enqueue(std::move(trackRef));
+            continue;
+        }
+        const Request request = m_queuedRequests.take(location);
+        TrackPointer pTrack = m_loadTrackFn(trackRef);
+        if (!pTrack) {
+            kLogger.warning()
+                    << "Failed to load track"
+                    << trackRef;
+            ++m_finishedCount;
+            continue;
+        }
+        m_runningModes.insert(location, request.mode);
+        // The worker reports its result through importFinished()
+        static_cast<void>(QtConcurrent::run(&m_threadPool,
+                [this,
+                        location = std::move(location),
+                        pTrack = std::move(pTrack),
+                        request]() mutable {
+                    const auto result =
+                            SoundSourceProxy(pTrack).updateTrackFromSource(
+                                    request.mode,
+                                    request.syncParams);
+                    importFinished(FinishedRequest{
+                            std::move(location),
+                            std::move(pTrack),
+                            result});
+                }));
+    }
+    if (!waitingTrackRefs.isEmpty()) {
+        waitingTrackRefs.append(m_queuedTrackRefs);
+        m_queuedTrackRefs.swap(waitingTrackRefs);
+    }
+}
+
+void TrackMetadataImportService::importFinished(
+        FinishedRequest finishedRequest) {
+    {
+        const auto locked = lockMutex(&m_finishedRequestsMutex);
+        m_finishedRequests.append(std::move(finishedRequest));
+    }
+    // Only a single notification is pending at any time. All requests
+    // that finished in the meantime are processed together.
+    if (m_finishedRequestsSignaled.testAndSetOrdered(0, 1)) {
+        QMetaObject::invokeMethod(this,
+                &TrackMetadataImportService::slotProcessFinishedRequests,
+                Qt::QueuedConnection);
+    }
+}
+
+void TrackMetadataImportService::slotProcessFinishedRequests() {
+    QList<FinishedRequest> finishedRequests;
+    {
+        const auto locked = lockMutex(&m_finishedRequestsMutex);
+        m_finishedRequestsSignaled.storeRelease(0);
+        finishedRequests.swap(m_finishedRequests);
+    }
+    m_finishedCount += static_cast<int>(finishedRequests.size());
+    for (auto& finishedRequest : finishedRequests) {
+        m_runningModes.remove(finishedRequest.location);
+        if (isTrackUpdated(finishedRequest.result)) {
+            m_importedTracks.append(std::move(finishedRequest.pTrack));
+        }
+    }
+    // Keep the workers busy before delivering the results
+    startQueuedRequests();
+    updateProgress();
+    if (m_importedTracks.size() >= kMaxDeliveryBatchSize ||
+            pendingCount() == 0) {
+        slotDeliverImportedTracks();
+    } else if (!m_importedTracks.isEmpty() && !m_deliveryTimer.isActive()) {
+        m_deliveryTimer.start();
+    }
+}
+
+void TrackMetadataImportService::slotDeliverImportedTracks() {
+    m_deliveryTimer.stop();
+    if (!m_importedTracks.isEmpty()) {
+        TrackPointerList importedTracks;
+        importedTracks.swap(m_importedTracks);
+        emit tracksImported(importedTracks);
+    }
+}
+
+void TrackMetadataImportService::updateProgress() {
+    if (m_totalCount == 0) {
+        return;
+    }
+    DEBUG_ASSERT(m_finishedCount + pendingCount() == m_totalCount);
+    emit progressChanged(m_finishedCount, m_totalCount);
+    if (pendingCount() == 0) {
+        // Start counting again with the next request
+        m_finishedCount = 0;
+        m_totalCount = 0;
+    }
+}
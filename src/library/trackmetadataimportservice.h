@@ -0,0 +1,108 @@
+#pragma once
+
+#include <QAtomicInt>
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QObject>
+#include <QQueue>
+#include <QThreadPool>
+#include <QTimer>
+#include <functional>
+
+#include "sources/soundsourceproxy.h"
+#include "track/track_decl.h"
+#include "track/trackref.h"
+
+/// Imports track metadata and cover art from file tags on a pool of
+/// worker threads.
+///
+/// Requests are queued by file location. Multiple requests for the same
+/// file are merged while they are waiting in the queue and the strongest
+/// update mode wins. A request for a file that is currently being read
+/// is only queued again if it requests a stronger update mode.
+///
+/// Tracks are loaded through the given function on the thread of the
+/// service, i.e. the GUI thread, but only a bounded number of tracks is
+/// loaded ahead of the workers. Modified tracks are delivered in batches
+/// through tracksImported() and need to be saved by the receiver.
+///
+/// The progress is reported through progressChanged() and counts all
+/// requests since the service has been idle.
+class TrackMetadataImportService : public QObject {
+    Q_OBJECT
+
+  public:
+    typedef std::function<TrackPointer(const TrackRef&)> LoadTrackFn;
+
+    /// Uses QThread::idealThreadCount() threads if maxThreadCount <= 0.
+    TrackMetadataImportService(
+            LoadTrackFn loadTrackFn,
+            int maxThreadCount = 0,
+            QObject* parent = nullptr);
+    ~TrackMetadataImportService() override;
+
+    void importTrackMetadata(
+            const QList<TrackRef>& trackRefs,
+            SoundSourceProxy::UpdateTrackFromSourceMode mode,
+            const SyncTrackMetadataParams& syncParams);
+
+    /// The number of requests that are either queued or in progress.
+    int pendingCount() const {
+        return m_queuedTrackRefs.size() + m_runningModes.size();
+    }
+
+    /// Discards all queued requests. Requests that are already in
+    /// progress are finished and their results will be delivered.
+    void cancel();
+
+    /// Cancels all requests and blocks until the workers have finished.
+    /// Pending results are delivered synchronously before returning.
+    void shutdown();
+
+  signals:
+    /// Tracks that have been modified by importing metadata from
+    /// their files.
+    void tracksImported(const TrackPointerList& tracks);
+    /// All requests have been processed if finishedCount == totalCount.
+    void progressChanged(int finishedCount, int totalCount);
+
+  private slots:
+    void slotProcessFinishedRequests();
+    void slotDeliverImportedTracks();
+
+  private:
+    struct Request {
+        SoundSourceProxy::UpdateTrackFromSourceMode mode;
+        SyncTrackMetadataParams syncParams;
+    };
+
+    struct FinishedRequest {
+        QString location;
+        TrackPointer pTrack;
+        SoundSourceProxy::UpdateTrackFromSourceResult result;
+    };
+
+    void startQueuedRequests();
+    void importFinished(FinishedRequest finishedRequest);
+    void updateProgress();
+
+    const LoadTrackFn m_loadTrackFn;
+
+    QThreadPool m_threadPool;
+    const int m_maxRunningCount;
+
+    // Only accessed from the thread of the service
+    QQueue<TrackRef> m_queuedTrackRefs;
+    QHash<QString, Request> m_queuedRequests;
+    QHash<QString, SoundSourceProxy::UpdateTrackFromSourceMode> m_runningModes;
+    TrackPointerList m_importedTracks;
+    QTimer m_deliveryTimer;
+    int m_finishedCount;
+    int m_totalCount;
+
+    // Shared between the workers and the thread of the service
+    QMutex m_finishedRequestsMutex;
+    QList<FinishedRequest> m_finishedRequests;
+    QAtomicInt m_finishedRequestsSignaled;
+};
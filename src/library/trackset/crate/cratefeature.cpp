@@ -4,7 +4,11 @@
 #include <QInputDialog>
 #include <QLineEdit>
 #include <QMenu>
+#include <QProgressDialog>
+#include <QTimer>
 #include <algorithm>
+#include <atomic>
+#include <memory>
 #include <vector>
 
 #include "analyzer/analyzerscheduledtrack.h"
@@ -20,6 +24,7 @@
 #include "library/trackset/crate/cratefeaturehelper.h"
 #include "library/treeitem.h"
 #include "moc_cratefeature.cpp"
+#include "sources/decodedaudiocache.h"
 #include "sources/soundsourceproxy.h"
 #include "track/track.h"
 #include "util/dnd.h"
@@ -102,6 +107,11 @@ void CrateFeature::initActions() {
             &QAction::triggered,
             this,
             &CrateFeature::slotAnalyzeCrate);
+    m_pPrewarmCrateAction = make_parented<QAction>(tr("Pre-warm Decoded Audio Cache"), this);
+    connect(m_pPrewarmCrateAction.get(),
+            &QAction::triggered,
+            this,
+            &CrateFeature::slotPrewarmCrate);
 
     m_pImportPlaylistAction = make_parented<QAction>(tr("Import Crate"), this);
     connect(m_pImportPlaylistAction.get(),
@@ -379,6 +389,9 @@ void CrateFeature::onRightClickChild(
     menu.addAction(m_pAutoDjTrackSourceAction.get());
     menu.addSeparator();
     menu.addAction(m_pAnalyzeCrateAction.get());
+    if (mixxx::DecodedAudioCache::isEnabled()) {
+        menu.addAction(m_pPrewarmCrateAction.get());
+    }
     menu.addSeparator();
     if (!crate.isLocked()) {
         menu.addAction(m_pImportPlaylistAction.get());
@@ -703,6 +716,77 @@ void CrateFeature::slotAnalyzeCrate() {
     }
 }
 
+void CrateFeature::slotPrewarmCrate() {
+    if (!m_lastRightClickedIndex.isValid()) {
+        return;
+    }
+    CrateId crateId = crateIdFromIndex(m_lastRightClickedIndex);
+    if (!crateId.isValid()) {
+        return;
+    }
+    // The tracks are loaded here because the database is only accessed
+    // from this thread. Decoding continues in the background.
+    QList<TrackPointer> tracks;
+    {
+        CrateTrackSelectResult crateTracks(
+                m_pTrackCollection->crates().selectCrateTracksSorted(crateId));
+        while (crateTracks.next()) {
+            TrackPointer pTrack =
+                    m_pLibrary->trackCollectionManager()->getTrackById(
+                            crateTracks.trackId());
+            if (pTrack) {
+                tracks.append(std::move(pTrack));
+            }
+        }
+    }
+    if (tracks.isEmpty()) {
+        return;
+    }
+    const int trackCount = static_cast<int>(tracks.size());
+
+    // The progress is reported on the background thread and polled
+    auto pProcessedCount = std::make_shared<std::atomic<int>>(0);
+    const int prewarmJobId = mixxx::DecodedAudioCache::prewarm(std::move(tracks),
+            [pProcessedCount](int processedCount, int /*totalCount*/) {
+                pProcessedCount->store(processedCount);
+            });
+    if (prewarmJobId == 0) {
+        return;
+    }
+
+    // Pre-warming takes a while. The non-modal dialog shows the progress
+    // and allows to cancel it while the library remains usable. Each
+    // dialog only cancels its own job.
+    auto* pProgressDlg = new QProgressDialog(
+            tr("Pre-warming decoded audio cache..."),
+            tr("Cancel"),
+            0,
+            trackCount,
+            m_pSidebarWidget);
+    pProgressDlg->setWindowModality(Qt::NonModal);
+    pProgressDlg->setMinimumDuration(0);
+    pProgressDlg->setValue(0);
+    connect(pProgressDlg,
+            &QProgressDialog::canceled,
+            pProgressDlg,
+            [pProgressDlg, prewarmJobId] {
+                mixxx::DecodedAudioCache::cancelPrewarming(prewarmJobId);
+                pProgressDlg->deleteLater();
+            });
+    auto* pProgressTimer = new QTimer(pProgressDlg);
+    connect(pProgressTimer,
+            &QTimer::timeout,
+            pProgressDlg,
+            [pProgressDlg, pProcessedCount] {
+                const int processedCount = pProcessedCount->load();
+                pProgressDlg->setValue(processedCount);
+                if (processedCount >= pProgressDlg->maximum()) {
+                    pProgressDlg->deleteLater();
+                }
+            });
+    pProgressTimer->start(250);
+}
+
 void CrateFeature::slotExportPlaylist() {
     CrateId crateId = m_crateTableModel.selectedCrate();
     Crate crate;
@@ -66,6 +66,8 @@ class CrateFeature : public BaseTrackSetFeature {
     // Copy all of the tracks in a crate to a new directory (like a thumbdrive).
     void slotExportTrackFiles();
     void slotAnalyzeCrate();
+    // Fill the decoded audio cache with all tracks of the crate
+    void slotPrewarmCrate();
     void slotCrateTableChanged(CrateId crateId);
     void slotCrateContentChanged(CrateId crateId);
     void htmlLinkClicked(const QUrl& link);
@@ -125,6 +127,7 @@ class CrateFeature : public BaseTrackSetFeature {
     parented_ptr<QAction> m_pExportCrateAction;
 #endif
     parented_ptr<QAction> m_pAnalyzeCrateAction;
+    parented_ptr<QAction> m_pPrewarmCrateAction;
 
     QPointer<WLibrarySidebar> m_pSidebarWidget;
 };
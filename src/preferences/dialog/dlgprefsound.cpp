@@ -4,6 +4,7 @@
 #include <QtDebug>
 
 #include "control/controlproxy.h"
+#include "engine/cachingreader/cachingreader.h"
 #include "engine/enginebuffer.h"
 #include "engine/enginemaster.h"
 #include "mixer/playermanager.h"
@@ -94,6 +95,11 @@ DlgPrefSound::DlgPrefSound(QWidget* pParent,
         }
     }
 
+    parallelProcessingComboBox->clear();
+    parallelProcessingComboBox->addItem(tr("Disabled"));
+    parallelProcessingComboBox->addItem(tr("Enabled (experimental)"));
+    m_pParallelProcessing = new ControlProxy("[Master]", "parallel_processing", this);
+
     m_pLatencyCompensation = new ControlProxy("[Master]", "microphoneLatencyCompensation", this);
     m_pMasterDelay = new ControlProxy("[Master]", "delay", this);
     m_pHeadDelay = new ControlProxy("[Master]", "headDelay", this);
@@ -165,6 +171,22 @@ DlgPrefSound::DlgPrefSound(QWidget* pParent,
             QOverload<int>::of(&QComboBox::currentIndexChanged),
             this,
             &DlgPrefSound::settingChanged);
+    connect(parallelProcessingComboBox,
+            QOverload<int>::of(&QComboBox::currentIndexChanged),
+            this,
+            &DlgPrefSound::settingChanged);
+    connect(preloadTracksCheckBox,
+            &QCheckBox::toggled,
+            this,
+            &DlgPrefSound::settingChanged);
+    connect(decodedAudioCacheSizeSpinBox,
+            QOverload<int>::of(&QSpinBox::valueChanged),
+            this,
+            &DlgPrefSound::settingChanged);
+    connect(decodedAudioCacheInt16CheckBox,
+            &QCheckBox::toggled,
+            this,
+            &DlgPrefSound::settingChanged);
 
     connect(queryButton, &QAbstractButton::clicked, this, &DlgPrefSound::queryClicked);
 
@@ -318,6 +340,18 @@ void DlgPrefSound::slotApply() {
         m_pSettings->set(ConfigKey("[Master]", "keylock_engine"),
                 ConfigValue(static_cast<int>(keylockEngine)));
 
+        m_pParallelProcessing->set(
+                parallelProcessingComboBox->currentIndex() == 1 ? 1.0 : 0.0);
+
+        // Preloading applies to tracks that are loaded from now on
+        m_pSettings->setValue(CachingReader::kPreloadTracksConfigKey,
+                preloadTracksCheckBox->isChecked());
+        m_pSettings->setValue(CachingReader::kDecodedAudioCacheSizeConfigKey,
+                decodedAudioCacheSizeSpinBox->value());
+        m_pSettings->setValue(CachingReader::kDecodedAudioCacheInt16ConfigKey,
+                decodedAudioCacheInt16CheckBox->isChecked());
+        CachingReader::configureDecodedAudioCache(m_pSettings);
+
         status = m_pSoundManager->setConfig(m_config);
     }
     if (status != SoundDeviceStatus::Ok) {
@@ -513,6 +547,15 @@ void DlgPrefSound::loadSettings(const SoundManagerConfig &config) {
         keylockComboBox->setCurrentIndex(keylockComboBox->count() - 1);
     }
 
+    parallelProcessingComboBox->setCurrentIndex(m_pParallelProcessing->toBool() ? 1 : 0);
+
+    preloadTracksCheckBox->setChecked(
+            m_pSettings->getValue(CachingReader::kPreloadTracksConfigKey, false));
+    decodedAudioCacheSizeSpinBox->setValue(
+            m_pSettings->getValue(CachingReader::kDecodedAudioCacheSizeConfigKey, 0));
+    decodedAudioCacheInt16CheckBox->setChecked(
+            m_pSettings->getValue(CachingReader::kDecodedAudioCacheInt16ConfigKey, false));
+
     m_loading = false;
     // DlgPrefSoundItem has it's own inhibit flag
     emit loadPaths(m_config);
@@ -702,6 +745,13 @@ void DlgPrefSound::slotResetToDefaults() {
     }
     m_pKeylockEngine->set(static_cast<double>(keylockEngine));
 
+    parallelProcessingComboBox->setCurrentIndex(0);
+    m_pParallelProcessing->set(0.0);
+
+    preloadTracksCheckBox->setChecked(false);
+    decodedAudioCacheSizeSpinBox->setValue(0);
+    decodedAudioCacheInt16CheckBox->setChecked(false);
+
     masterMixComboBox->setCurrentIndex(1);
     m_pMasterEnabled->set(1.0);
 
@@ -94,6 +94,7 @@ class DlgPrefSound : public DlgPreferencePage, public Ui::DlgPrefSoundDlg  {
     ControlProxy* m_pBoothDelay;
     ControlProxy* m_pLatencyCompensation;
     ControlProxy* m_pKeylockEngine;
+    ControlProxy* m_pParallelProcessing;
     ControlProxy* m_pMasterEnabled;
     ControlProxy* m_pMasterMonoMixdown;
     ControlProxy* m_pMicMonitorMode;
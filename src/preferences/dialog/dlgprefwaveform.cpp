@@ -178,6 +178,8 @@ void DlgPrefWaveform::slotUpdate() {
     enableWaveformCaching->setChecked(waveformSettings.waveformCachingEnabled());
     enableWaveformGenerationWithAnalysis->setChecked(
         waveformSettings.waveformGenerationWithAnalysisEnabled());
+    enableMappedWaveformCache->setChecked(
+            waveformSettings.mappedWaveformCacheEnabled());
     calculateCachedWaveformDiskUsage();
 }
 
@@ -190,6 +192,8 @@ void DlgPrefWaveform::slotApply() {
     waveformSettings.setWaveformCachingEnabled(enableWaveformCaching->isChecked());
     waveformSettings.setWaveformGenerationWithAnalysisEnabled(
         enableWaveformGenerationWithAnalysis->isChecked());
+    waveformSettings.setMappedWaveformCacheEnabled(
+            enableMappedWaveformCache->isChecked());
 }
 
 void DlgPrefWaveform::slotResetToDefaults() {
@@ -226,6 +230,7 @@ void DlgPrefWaveform::slotResetToDefaults() {
     // Waveform caching enabled.
     enableWaveformCaching->setChecked(true);
     enableWaveformGenerationWithAnalysis->setChecked(false);
+    enableMappedWaveformCache->setChecked(false);
 
     // Beat grid alpha default is 90
     beatGridAlphaSlider->setValue(90);
@@ -26,6 +26,18 @@ class WaveformSettings {
                 ConfigKey("[Library]", "EnableWaveformGenerationWithAnalysis"), enabled);
     }
 
+    // Keeps an uncompressed copy of cached waveforms that is mapped into
+    // memory when loading a track instead of being decompressed and parsed
+    bool mappedWaveformCacheEnabled() const {
+        return m_pConfig->getValue<bool>(
+                ConfigKey("[Library]", "EnableMappedWaveformCache"), false);
+    }
+
+    void setMappedWaveformCacheEnabled(bool enabled) {
+        m_pConfig->setValue<bool>(
+                ConfigKey("[Library]", "EnableMappedWaveformCache"), enabled);
+    }
+
   private:
     UserSettingsPointer m_pConfig;
 };
@@ -35,6 +35,14 @@ QmlEffectSlotProxy::QmlEffectSlotProxy(
             &EffectSlot::parametersChanged,
             this,
             &QmlEffectSlotProxy::parametersModelChanged);
+    connect(m_pEffectSlot.get(),
+            &EffectSlot::audioLatencyUsageChanged,
+            this,
+            &QmlEffectSlotProxy::audioLatencyUsageChanged);
+    connect(m_pEffectSlot.get(),
+            &EffectSlot::bypassedChanged,
+            this,
+            &QmlEffectSlotProxy::bypassedChanged);
 }
 
 int QmlEffectSlotProxy::getChainSlotNumber() const {
@@ -53,6 +61,14 @@ QString QmlEffectSlotProxy::getGroup() const {
     return m_pEffectSlot->getGroup();
 }
 
+double QmlEffectSlotProxy::getAudioLatencyUsage() const {
+    return m_pEffectSlot->getAudioLatencyUsage();
+}
+
+bool QmlEffectSlotProxy::isBypassed() const {
+    return m_pEffectSlot->isBypassed();
+}
+
 QString QmlEffectSlotProxy::getEffectId() const {
     return m_pEffectSlot->id();
 }
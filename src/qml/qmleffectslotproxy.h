@@ -18,6 +18,8 @@ class QmlEffectSlotProxy : public QObject {
     Q_PROPERTY(QString effectId READ getEffectId WRITE setEffectId NOTIFY effectIdChanged)
     Q_PROPERTY(mixxx::qml::QmlEffectManifestParametersModel* parametersModel
                     READ getParametersModel NOTIFY parametersModelChanged)
+    Q_PROPERTY(double audioLatencyUsage READ getAudioLatencyUsage NOTIFY audioLatencyUsageChanged)
+    Q_PROPERTY(bool bypassed READ isBypassed NOTIFY bypassedChanged)
     QML_NAMED_ELEMENT(EffectSlotProxy)
     QML_UNCREATABLE(
             "Only accessible via "
@@ -38,6 +40,8 @@ class QmlEffectSlotProxy : public QObject {
     QString getGroup() const;
     QString getEffectId() const;
     QmlEffectManifestParametersModel* getParametersModel() const;
+    double getAudioLatencyUsage() const;
+    bool isBypassed() const;
 
   public slots:
     void setEffectId(const QString& effectId);
@@ -45,6 +49,8 @@ class QmlEffectSlotProxy : public QObject {
   signals:
     void effectIdChanged();
     void parametersModelChanged();
+    void audioLatencyUsageChanged();
+    void bypassedChanged();
 
   private:
     /// FIXME: The reference to EffectManager is needed for loading effects.
@@ -1002,6 +1002,15 @@ void Tooltips::addStandardTooltips() {
             << tr("Controls linked parameters of this effect")
             << resetWithRightAndDoubleClick;
 
+    add("EffectSlot_audio_latency_usage")
+            << tr("Effect Latency Usage Meter")
+            << tr("Displays the fraction of latency used for processing this effect.");
+
+    add("EffectSlot_bypassed")
+            << tr("Effect Bypassed Indicator")
+            << tr("Indicates that the effect has been switched off because the audio buffer was too small to do all audio processing.")
+            << tr("Switch the effect off and on again to re-enable it.");
+
     add("EffectSlot_focus")
             << tr("Effect Focus Button")
             << QString("%1: %2").arg(leftClick, tr("Focuses this effect."))
@@ -0,0 +1,581 @@
+#include "sources/decodedaudiocache.h"
+
+#include <QDateTime>
+#include <QFile>
+#include <QHash>
+#include <QMutex>
+#include <QSaveFile>
+#include <QThreadPool>
+#include <QtConcurrentRun>
+#include <atomic>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "sources/audiosourcestereoproxy.h"
+#include "sources/derivedfile.h"
+#include "sources/soundsourceproxy.h"
+#include "track/track.h"
+#include "util/assert.h"
+#include "util/compatibility/qmutex.h"
+#include "util/logger.h"
+#include "util/math.h"
+#include "util/sample.h"
+#include "util/timer.h"
+
+namespace mixxx {
+
+namespace {
+
+const Logger kLogger("DecodedAudioCache");
+
+constexpr char kFileMagic[8] = {'M', 'X', 'P', 'C', 'M', 'C', 'A', 'C'};
+constexpr quint32 kFileFormatVersion = 1;
+
+constexpr audio::ChannelCount kChannelCount = audio::ChannelCount::stereo();
+
+const QString kFileSuffix = QStringLiteral(".pcm");
+
+// The number of frames that are converted and written at once
+constexpr SINT kWriteBlockFrames = 8192;
+
+struct FileHeader {
+    // formatDetail is the SampleFormat
+    derivedfile::Header common;
+    qint32 channelCount;
+    qint32 sampleRate;
+    qint64 frameIndexMin;
+    qint64 frameCount;
+    qint64 reserved[2];
+};
+
+QMutex s_configMutex;
+QString s_dirPath;
+qint64 s_maxBytes = 0;
+DecodedAudioCache::SampleFormat s_sampleFormat = DecodedAudioCache::SampleFormat::Float32;
+
+std::unique_ptr<QThreadPool> makeSingleThreadPool() {
+    auto pThreadPool = std::make_unique<QThreadPool>();
+    pThreadPool->setMaxThreadCount(1);
+    return pThreadPool;
+}
+
+// Pre-warming runs on a single thread to not compete with analysis
+// and playback for I/O and CPU
+QThreadPool* prewarmThreadPool() {
+    static const auto s_pThreadPool = makeSingleThreadPool();
+    return s_pThreadPool.get();
+}
+
+// Writes the samples of tracks that have been decoded for playback
+QThreadPool* storeThreadPool() {
+    static const auto s_pThreadPool = makeSingleThreadPool();
+    return s_pThreadPool.get();
+}
+
+// Aborts writing on shutdown
+std::atomic<bool> s_writingCanceled = false;
+// Each call of prewarm() starts a new job that can be canceled
+// individually. Maps the ids of all unfinished jobs to their
+// canceled flag.
+QMutex s_prewarmJobsMutex;
+int s_lastPrewarmJobId = 0;
+QHash<int, bool> s_prewarmJobsCanceled;
+
+bool isPrewarmJobCanceled(int jobId) {
+    const auto locker = lockMutex(&s_prewarmJobsMutex);
+    return s_prewarmJobsCanceled.value(jobId, true);
+}
+
+void finishPrewarmJob(int jobId) {
+    const auto locker = lockMutex(&s_prewarmJobsMutex);
+    s_prewarmJobsCanceled.remove(jobId);
+}
+
+qint64 bytesPerSample(DecodedAudioCache::SampleFormat sampleFormat) {
+    switch (sampleFormat) {
+    case DecodedAudioCache::SampleFormat::Float32:
+        return sizeof(CSAMPLE);
+    case DecodedAudioCache::SampleFormat::Int16:
+        return sizeof(SAMPLE);
+    }
+    DEBUG_ASSERT(!"unreachable");
+    return sizeof(CSAMPLE);
+}
+
+struct Config {
+    QString dirPath;
+    qint64 maxBytes;
+    DecodedAudioCache::SampleFormat sampleFormat;
+};
+
+Config config() {
+    const auto locker = lockMutex(&s_configMutex);
+    return Config{s_dirPath, s_maxBytes, s_sampleFormat};
+}
+
+/// Entries are keyed by the identity of the audio file. The sample rate
+/// is stored in the header of the entry.
+QString cacheFilePath(
+        const Config& config,
+        const QFileInfo& fileInfo) {
+    if (config.maxBytes <= 0) {
+        return QString();
+    }
+    return derivedfile::filePath(config.dirPath, fileInfo, kFileSuffix);
+}
+
+qint64 cacheFileDataBytes(
+        DecodedAudioCache::SampleFormat sampleFormat,
+        IndexRange frameIndexRange) {
+    return kChannelCount * frameIndexRange.length() * bytesPerSample(sampleFormat);
+}
+
+/// Deletes the least recently used files until the total size fits
+/// into the limit. Files of tracks that are currently played stay
+/// mapped until the track is unloaded.
+void evictLeastRecentlyUsed(const Config& config) {
+    derivedfile::evictLeastRecentlyUsed(
+            config.dirPath, QChar('*') + kFileSuffix, config.maxBytes);
+}
+
+/// Reads and validates the header of an entry without modifying it
+bool readFileHeader(
+        QFile* pFile,
+        const QFileInfo& fileInfo,
+        FileHeader* pHeader) {
+    if (pFile->read(reinterpret_cast<char*>(pHeader), sizeof(FileHeader)) !=
+                    sizeof(FileHeader) ||
+            derivedfile::checkHeader(pHeader->common,
+                    kFileMagic,
+                    kFileFormatVersion,
+                    sizeof(FileHeader),
+                    fileInfo) != derivedfile::HeaderStatus::Valid ||
+            pHeader->channelCount != kChannelCount ||
+            !audio::SampleRate(pHeader->sampleRate).isValid() ||
+            pHeader->frameCount <= 0 ||
+            pHeader->common.formatDetail >
+                    static_cast<quint32>(DecodedAudioCache::SampleFormat::Int16)) {
+        // Invalid or outdated
+        return false;
+    }
+    const auto sampleFormat =
+            static_cast<DecodedAudioCache::SampleFormat>(pHeader->common.formatDetail);
+    const qint64 dataBytes = kChannelCount * pHeader->frameCount * bytesPerSample(sampleFormat);
+    return pFile->size() == static_cast<qint64>(sizeof(FileHeader)) + dataBytes;
+}
+
+/// Reads frames with 2 channels into the destination buffer. Returns false
+/// on fatal errors.
+typedef std::function<bool(IndexRange frameIndexRange, CSAMPLE* pSamples)> ReadFramesFn;
+
+bool writeCacheFile(
+        const QFileInfo& fileInfo,
+        audio::SampleRate sampleRate,
+        IndexRange frameIndexRange,
+        const ReadFramesFn& readFrames) {
+    const Config cfg = config();
+    const QString filePath = cacheFilePath(cfg, fileInfo);
+    if (filePath.isEmpty() || !sampleRate.isValid() || frameIndexRange.empty()) {
+        return false;
+    }
+    if (cacheFileDataBytes(cfg.sampleFormat, frameIndexRange) > cfg.maxBytes) {
+        kLogger.info()
+                << "Not caching"
+                << fileInfo.absoluteFilePath()
+                << "that exceeds the size of the cache";
+        return false;
+    }
+    ScopedTimer t("DecodedAudioCache::store");
+
+    FileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    header.common = derivedfile::makeHeader(
+            kFileMagic, kFileFormatVersion, sizeof(FileHeader), fileInfo);
+    header.common.formatDetail = static_cast<quint32>(cfg.sampleFormat);
+    header.channelCount = kChannelCount;
+    header.sampleRate = sampleRate;
+    header.frameIndexMin = frameIndexRange.start();
+    header.frameCount = frameIndexRange.length();
+
+    // Concurrent writers of the same entry replace it atomically
+    const auto writeSamples = [&cfg, frameIndexRange, &readFrames](QSaveFile* pFile) {
+        std::vector<CSAMPLE> samples(kChannelCount * kWriteBlockFrames);
+        std::vector<SAMPLE> convertedSamples;
+        if (cfg.sampleFormat == DecodedAudioCache::SampleFormat::Int16) {
+            convertedSamples.resize(samples.size());
+        }
+        for (SINT frameIndex = frameIndexRange.start();
+                frameIndex < frameIndexRange.end();) {
+            if (s_writingCanceled.load(std::memory_order_relaxed)) {
+                return false;
+            }
+            const auto blockFrameIndexRange = IndexRange::between(frameIndex,
+                    math_min(frameIndex + kWriteBlockFrames, frameIndexRange.end()));
+            const SINT blockSampleCount = kChannelCount * blockFrameIndexRange.length();
+            if (!readFrames(blockFrameIndexRange, samples.data())) {
+                return false;
+            }
+            const char* pData = reinterpret_cast<const char*>(samples.data());
+            qint64 dataBytes = blockSampleCount * sizeof(CSAMPLE);
+            if (cfg.sampleFormat == DecodedAudioCache::SampleFormat::Int16) {
+                SampleUtil::convertFloat32ToS16(
+                        convertedSamples.data(), samples.data(), blockSampleCount);
+                pData = reinterpret_cast<const char*>(convertedSamples.data());
+                dataBytes = blockSampleCount * sizeof(SAMPLE);
+            }
+            if (pFile->write(pData, dataBytes) != dataBytes) {
+                return false;
+            }
+            frameIndex = blockFrameIndexRange.end();
+        }
+        return true;
+    };
+    if (!derivedfile::writeFile(filePath, &header.common, writeSamples)) {
+        return false;
+    }
+    kLogger.info()
+            << "Cached"
+            << frameIndexRange.length()
+            << "decoded frames of"
+            << fileInfo.absoluteFilePath();
+    evictLeastRecentlyUsed(cfg);
+    return true;
+}
+
+/// Decodes the whole audio source with 2 channels and stores it.
+/// Frames that cannot be decoded are stored as silence.
+bool storeDecodedAudioSource(
+        const QFileInfo& fileInfo,
+        const AudioSourcePointer& pAudioSource,
+        const std::function<bool()>& isCanceled) {
+    VERIFY_OR_DEBUG_ASSERT(pAudioSource) {
+        return false;
+    }
+    AudioSourceStereoProxy audioSourceProxy(pAudioSource, kWriteBlockFrames);
+    return writeCacheFile(fileInfo,
+            pAudioSource->getSignalInfo().getSampleRate(),
+            pAudioSource->frameIndexRange(),
+            [&audioSourceProxy, &isCanceled](
+                    IndexRange readFrameIndexRange, CSAMPLE* pOutput) {
+                if (isCanceled && isCanceled()) {
+                    return false;
+                }
+                const SINT sampleCount = kChannelCount * readFrameIndexRange.length();
+                const auto readableSampleFrames = audioSourceProxy.readSampleFrames(
+                        WritableSampleFrames(readFrameIndexRange,
+                                SampleBuffer::WritableSlice(pOutput, sampleCount)));
+                // Frames that could not be decoded are stored as silence
+                const auto readFrames = readableSampleFrames.frameIndexRange();
+                if (readFrames.empty()) {
+                    SampleUtil::clear(pOutput, sampleCount);
+                    return true;
+                }
+                if (readFrames.start() > readFrameIndexRange.start()) {
+                    SampleUtil::clear(pOutput,
+                            kChannelCount * (readFrames.start() - readFrameIndexRange.start()));
+                }
+                if (readFrames.end() < readFrameIndexRange.end()) {
+                    SampleUtil::clear(pOutput +
+                                    kChannelCount *
+                                            (readFrames.end() - readFrameIndexRange.start()),
+                            kChannelCount * (readFrameIndexRange.end() - readFrames.end()));
+                }
+                return true;
+            });
+}
+
+/// Reads the samples from a memory-mapped cache file
+class CachedAudioSource final : public AudioSource {
+  public:
+    CachedAudioSource(
+            const QFileInfo& fileInfo,
+            const QString& cacheFilePath)
+            : AudioSource(QUrl::fromLocalFile(fileInfo.absoluteFilePath())),
+              m_fileInfo(fileInfo),
+              m_file(cacheFilePath),
+              m_pSamples(nullptr),
+              m_sampleFormat(DecodedAudioCache::SampleFormat::Float32) {
+    }
+    ~CachedAudioSource() override {
+        close();
+    }
+
+    void close() override {
+        if (m_file.isOpen()) {
+            m_file.close(); // implicitly unmaps
+        }
+        m_pSamples = nullptr;
+    }
+
+  protected:
+    OpenResult tryOpen(
+            OpenMode /*mode*/,
+            const OpenParams& /*params*/) override {
+        if (!m_file.open(QIODevice::ReadOnly)) {
+            return OpenResult::Failed;
+        }
+        FileHeader header;
+        if (!readFileHeader(&m_file, m_fileInfo, &header)) {
+            return OpenResult::Failed;
+        }
+        m_sampleFormat = static_cast<DecodedAudioCache::SampleFormat>(
+                header.common.formatDetail);
+        const qint64 dataBytes = kChannelCount * header.frameCount *
+                bytesPerSample(m_sampleFormat);
+        m_pSamples = m_file.map(sizeof(FileHeader), dataBytes);
+        if (!m_pSamples) {
+            return OpenResult::Failed;
+        }
+        // Mark the entry as recently used
+        m_file.setFileTime(QDateTime::currentDateTimeUtc(),
+                QFileDevice::FileModificationTime);
+        if (!initChannelCountOnce(kChannelCount) ||
+                !initSampleRateOnce(audio::SampleRate(header.sampleRate)) ||
+                !initFrameIndexRangeOnce(IndexRange::forward(
+                        header.frameIndexMin, header.frameCount))) {
+            return OpenResult::Failed;
+        }
+        return OpenResult::Succeeded;
+    }
+
+    ReadableSampleFrames readSampleFramesClamped(
+            const WritableSampleFrames& writableSampleFrames) override {
+        const IndexRange readFrameIndexRange = writableSampleFrames.frameIndexRange();
+        const SINT sampleOffset = kChannelCount *
+                (readFrameIndexRange.start() - frameIndexMin());
+        const SINT sampleCount = kChannelCount * readFrameIndexRange.length();
+        CSAMPLE* pOutput = writableSampleFrames.writableData();
+        if (pOutput) {
+            switch (m_sampleFormat) {
+            case DecodedAudioCache::SampleFormat::Float32:
+                SampleUtil::copy(pOutput,
+                        reinterpret_cast<const CSAMPLE*>(m_pSamples) + sampleOffset,
+                        sampleCount);
+                break;
+            case DecodedAudioCache::SampleFormat::Int16:
+                SampleUtil::convertS16ToFloat32(pOutput,
+                        reinterpret_cast<const SAMPLE*>(m_pSamples) + sampleOffset,
+                        sampleCount);
+                break;
+            }
+        }
+        return ReadableSampleFrames(
+                readFrameIndexRange,
+                SampleBuffer::ReadableSlice(pOutput, pOutput ? sampleCount : 0));
+    }
+
+  private:
+    const QFileInfo m_fileInfo;
+    QFile m_file;
+    const uchar* m_pSamples;
+    DecodedAudioCache::SampleFormat m_sampleFormat;
+};
+
+} // anonymous namespace
+
+// static
+void DecodedAudioCache::configure(
+        const QString& dirPath,
+        qint64 maxBytes,
+        SampleFormat sampleFormat) {
+    {
+        const auto locker = lockMutex(&s_configMutex);
+        s_dirPath = dirPath;
+        s_maxBytes = maxBytes;
+        s_sampleFormat = sampleFormat;
+    }
+    if (isEnabled()) {
+        // The limit might have been decreased
+        evictLeastRecentlyUsed(config());
+    }
+}
+
+// static
+bool DecodedAudioCache::isEnabled() {
+    const auto locker = lockMutex(&s_configMutex);
+    return !s_dirPath.isEmpty() && s_maxBytes > 0;
+}
+
+// static
+AudioSourcePointer DecodedAudioCache::open(
+        const QFileInfo& fileInfo) {
+    const QString filePath = cacheFilePath(config(), fileInfo);
+    if (filePath.isEmpty() || !QFile::exists(filePath)) {
+        return nullptr;
+    }
+    auto pAudioSource = std::make_shared<CachedAudioSource>(fileInfo, filePath);
+    if (pAudioSource->open(AudioSource::OpenMode::Strict) !=
+            AudioSource::OpenResult::Succeeded) {
+        kLogger.info() << "Discarding outdated or invalid entry" << filePath;
+        pAudioSource.reset();
+        QFile::remove(filePath);
+        return nullptr;
+    }
+    return pAudioSource;
+}
+
+// static
+bool DecodedAudioCache::contains(
+        const QFileInfo& fileInfo) {
+    const QString filePath = cacheFilePath(config(), fileInfo);
+    if (filePath.isEmpty()) {
+        return false;
+    }
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    FileHeader header;
+    return readFileHeader(&file, fileInfo, &header);
+}
+
+// static
+bool DecodedAudioCache::store(
+        const QFileInfo& fileInfo,
+        audio::SampleRate sampleRate,
+        IndexRange frameIndexRange,
+        const CSAMPLE* pSamples) {
+    VERIFY_OR_DEBUG_ASSERT(pSamples) {
+        return false;
+    }
+    return writeCacheFile(fileInfo,
+            sampleRate,
+            frameIndexRange,
+            [frameIndexRange, pSamples](IndexRange readFrameIndexRange, CSAMPLE* pOutput) {
+                SampleUtil::copy(pOutput,
+                        pSamples +
+                                kChannelCount *
+                                        (readFrameIndexRange.start() -
+                                                frameIndexRange.start()),
+                        kChannelCount * readFrameIndexRange.length());
+                return true;
+            });
+}
+
+// static
+bool DecodedAudioCache::store(
+        const QFileInfo& fileInfo,
+        const AudioSourcePointer& pAudioSource) {
+    return storeDecodedAudioSource(fileInfo, pAudioSource, nullptr);
+}
+
+// static
+bool DecodedAudioCache::canStore(IndexRange frameIndexRange) {
+    const Config cfg = config();
+    return !cfg.dirPath.isEmpty() && cfg.maxBytes > 0 &&
+            cacheFileDataBytes(cfg.sampleFormat, frameIndexRange) <= cfg.maxBytes;
+}
+
+// static
+void DecodedAudioCache::storeAsync(
+        const QFileInfo& fileInfo,
+        audio::SampleRate sampleRate,
+        IndexRange frameIndexRange,
+        std::shared_ptr<const CSAMPLE> pSamples) {
+    VERIFY_OR_DEBUG_ASSERT(pSamples) {
+        return;
+    }
+    if (s_writingCanceled.load(std::memory_order_relaxed)) {
+        return;
+    }
+    QtConcurrent::run(storeThreadPool(),
+            [fileInfo, sampleRate, frameIndexRange, pSamples = std::move(pSamples)] {
+                store(fileInfo, sampleRate, frameIndexRange, pSamples.get());
+            });
+}
+
+// static
+void DecodedAudioCache::storeAsync(TrackPointer pTrack) {
+    VERIFY_OR_DEBUG_ASSERT(pTrack) {
+        return;
+    }
+    if (s_writingCanceled.load(std::memory_order_relaxed)) {
+        return;
+    }
+    QtConcurrent::run(storeThreadPool(),
+            [pTrack = std::move(pTrack)] {
+                AudioSource::OpenParams params;
+                params.setChannelCount(kChannelCount);
+                const auto pAudioSource = SoundSourceProxy(pTrack).openAudioSource(params);
+                if (!pAudioSource) {
+                    return;
+                }
+                storeDecodedAudioSource(pTrack->getFileInfo().asQFileInfo(),
+                        pAudioSource,
+                        [] {
+                            return s_writingCanceled.load(std::memory_order_relaxed);
+                        });
+            });
+}
+
+// static
+int DecodedAudioCache::prewarm(
+        QList<TrackPointer> tracks,
+        PrewarmProgressFn onProgress) {
+    if (!isEnabled() || tracks.isEmpty()) {
+        return 0;
+    }
+    int jobId;
+    {
+        const auto locker = lockMutex(&s_prewarmJobsMutex);
+        jobId = ++s_lastPrewarmJobId;
+        s_prewarmJobsCanceled.insert(jobId, false);
+    }
+    kLogger.info() << "Pre-warming" << tracks.size() << "tracks";
+    QtConcurrent::run(prewarmThreadPool(),
+            [tracks = std::move(tracks), onProgress = std::move(onProgress), jobId] {
+                const auto isCanceled = [jobId] {
+                    return s_writingCanceled.load(std::memory_order_relaxed) ||
+                            isPrewarmJobCanceled(jobId);
+                };
+                int processedCount = 0;
+                int cachedCount = 0;
+                for (const auto& pTrack : tracks) {
+                    if (isCanceled()) {
+                        kLogger.info() << "Pre-warming canceled";
+                        finishPrewarmJob(jobId);
+                        return;
+                    }
+                    const QFileInfo fileInfo = pTrack->getFileInfo().asQFileInfo();
+                    if (!contains(fileInfo)) {
+                        AudioSource::OpenParams params;
+                        params.setChannelCount(kChannelCount);
+                        const auto pAudioSource =
+                                SoundSourceProxy(pTrack).openAudioSource(params);
+                        if (pAudioSource &&
+                                storeDecodedAudioSource(
+                                        fileInfo, pAudioSource, isCanceled)) {
+                            ++cachedCount;
+                        }
+                    }
+                    ++processedCount;
+                    if (onProgress) {
+                        onProgress(processedCount, static_cast<int>(tracks.size()));
+                    }
+                }
+                kLogger.info() << "Pre-warming finished:" << cachedCount << "tracks decoded";
+                finishPrewarmJob(jobId);
+            });
+    return jobId;
+}
+
+// static
+void DecodedAudioCache::cancelPrewarming(int jobId) {
+    const auto locker = lockMutex(&s_prewarmJobsMutex);
+    const auto it = s_prewarmJobsCanceled.find(jobId);
+    if (it != s_prewarmJobsCanceled.end()) {
+        it.value() = true;
+    }
+}
+
+// static
+void DecodedAudioCache::shutdown() {
+    s_writingCanceled = true;
+    prewarmThreadPool()->waitForDone();
+    storeThreadPool()->waitForDone();
+}
+
+} // namespace mixxx
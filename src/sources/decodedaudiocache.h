@@ -0,0 +1,103 @@
+#pragma once
+
+#include <QFileInfo>
+#include <QList>
+#include <QString>
+#include <functional>
+#include <memory>
+
+#include "audio/types.h"
+#include "sources/audiosource.h"
+#include "track/track_decl.h"
+#include "util/indexrange.h"
+
+namespace mixxx {
+
+/// An optional, size-capped cache of decoded stereo audio data on disk.
+///
+/// Each entry contains all sample frames of a track as produced by the
+/// decoder, either as 32-bit float or as 16-bit integer samples. Entries
+/// are identified by the path of the audio file and the sample rate. They
+/// are discarded if the size or the modification time of the file have
+/// changed.
+///
+/// Cached tracks are read through a memory-mapped AudioSource without any
+/// decoding. The least recently used entries are deleted when the size of
+/// the cache exceeds the limit.
+///
+/// All functions are thread-safe.
+class DecodedAudioCache final {
+  public:
+    enum class SampleFormat {
+        Float32,
+        Int16,
+    };
+
+    /// Enables the cache. A size of 0 disables the cache.
+    static void configure(
+            const QString& dirPath,
+            qint64 maxBytes,
+            SampleFormat sampleFormat);
+    static bool isEnabled();
+
+    /// Returns an opened audio source with 2 channels or nullptr if the
+    /// file is not cached. The sample rate is read from the cached entry.
+    static AudioSourcePointer open(
+            const QFileInfo& fileInfo);
+
+    /// Checks only the header of the entry. Unlike open() the entry
+    /// is neither mapped nor marked as recently used.
+    static bool contains(
+            const QFileInfo& fileInfo);
+
+    /// Returns true if the cache is enabled and the decoded samples of
+    /// the frames would fit into it.
+    static bool canStore(IndexRange frameIndexRange);
+
+    /// Stores the decoded stereo samples of a whole track
+    static bool store(
+            const QFileInfo& fileInfo,
+            audio::SampleRate sampleRate,
+            IndexRange frameIndexRange,
+            const CSAMPLE* pSamples);
+
+    /// Same as store() but writes the samples on a background thread.
+    /// pSamples is kept alive until the samples have been written.
+    static void storeAsync(
+            const QFileInfo& fileInfo,
+            audio::SampleRate sampleRate,
+            IndexRange frameIndexRange,
+            std::shared_ptr<const CSAMPLE> pSamples);
+
+    /// Decodes the track from a separate audio source on a background
+    /// thread and stores it, e.g. for tracks that are played without
+    /// preloading them.
+    static void storeAsync(TrackPointer pTrack);
+
+    /// Decodes the whole audio source with 2 channels and stores it.
+    /// Frames that cannot be decoded are stored as silence.
+    static bool store(
+            const QFileInfo& fileInfo,
+            const AudioSourcePointer& pAudioSource);
+
+    /// Reports the number of tracks that have been processed. Called on
+    /// the background thread after each track.
+    typedef std::function<void(int processedCount, int totalCount)> PrewarmProgressFn;
+
+    /// Decodes and stores all tracks that are not cached yet in the
+    /// background, e.g. the tracks of a crate before a gig. Returns the
+    /// id of the pre-warming job or 0 if there is nothing to do.
+    static int prewarm(
+            QList<TrackPointer> tracks,
+            PrewarmProgressFn onProgress = nullptr);
+
+    /// Aborts the given pre-warming job. Other jobs continue.
+    /// Returns immediately.
+    static void cancelPrewarming(int jobId);
+
+    /// Aborts pre-warming and pending writes and waits until the
+    /// background tasks have finished.
+    static void shutdown();
+};
+
+} // namespace mixxx
@@ -0,0 +1,126 @@
+#include "sources/derivedfile.h"
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QSaveFile>
+#include <cstring>
+
+#include "util/assert.h"
+#include "util/logger.h"
+
+namespace mixxx {
+
+namespace derivedfile {
+
+namespace {
+
+const Logger kLogger("DerivedFile");
+
+constexpr quint32 kByteOrderMark = 0x01020304;
+
+qint64 lastModifiedMillis(const QFileInfo& fileInfo) {
+    return fileInfo.lastModified().toMSecsSinceEpoch();
+}
+
+} // anonymous namespace
+
+QString filePath(
+        const QString& dirPath,
+        const QFileInfo& audioFileInfo,
+        const QString& nameSuffix) {
+    if (dirPath.isEmpty()) {
+        return QString();
+    }
+    const QByteArray pathHash = QCryptographicHash::hash(
+            audioFileInfo.absoluteFilePath().toUtf8(), QCryptographicHash::Sha1)
+                                        .toHex();
+    return QDir(dirPath).filePath(QString::fromLatin1(pathHash) + nameSuffix);
+}
+
+Header makeHeader(
+        const char (&magic)[8],
+        quint32 formatVersion,
+        quint32 headerSize,
+        const QFileInfo& audioFileInfo) {
+    Header header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, magic, sizeof(header.magic));
+    header.byteOrderMark = kByteOrderMark;
+    header.formatVersion = formatVersion;
+    header.headerSize = headerSize;
+    header.fileSize = audioFileInfo.size();
+    header.fileLastModified = lastModifiedMillis(audioFileInfo);
+    return header;
+}
+
+HeaderStatus checkHeader(
+        const Header& header,
+        const char (&magic)[8],
+        quint32 formatVersion,
+        quint32 headerSize,
+        const QFileInfo& audioFileInfo) {
+    if (std::memcmp(header.magic, magic, sizeof(header.magic)) != 0 ||
+            header.byteOrderMark != kByteOrderMark ||
+            header.formatVersion != formatVersion ||
+            header.headerSize != headerSize) {
+        return HeaderStatus::Invalid;
+    }
+    if (header.fileSize != audioFileInfo.size() ||
+            header.fileLastModified != lastModifiedMillis(audioFileInfo)) {
+        return HeaderStatus::Outdated;
+    }
+    return HeaderStatus::Valid;
+}
+
+bool writeFile(
+        const QString& filePath,
+        const Header* pHeader,
+        const WriteDataFn& writeData) {
+    VERIFY_OR_DEBUG_ASSERT(pHeader && pHeader->headerSize >= sizeof(Header)) {
+        return false;
+    }
+    if (!QDir().mkpath(QFileInfo(filePath).absolutePath())) {
+        return false;
+    }
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+    const qint64 headerSize = pHeader->headerSize;
+    if (file.write(reinterpret_cast<const char*>(pHeader), headerSize) != headerSize ||
+            !writeData(&file)) {
+        file.cancelWriting();
+        return false;
+    }
+    if (!file.commit()) {
+        kLogger.warning()
+                << "Failed to write"
+                << filePath
+                << file.errorString();
+        return false;
+    }
+    return true;
+}
+
+void evictLeastRecentlyUsed(
+        const QString& dirPath,
+        const QString& nameFilter,
+        qint64 maxBytes) {
+    const QFileInfoList entries = QDir(dirPath).entryInfoList(
+            QStringList{nameFilter},
+            QDir::Files,
+            QDir::Time); // most recently used first
+    qint64 totalBytes = 0;
+    for (const auto& entry : entries) {
+        totalBytes += entry.size();
+        if (totalBytes > maxBytes) {
+            kLogger.debug() << "Evicting" << entry.absoluteFilePath();
+            QFile::remove(entry.absoluteFilePath());
+        }
+    }
+}
+
+} // namespace derivedfile
+
+} // namespace mixxx
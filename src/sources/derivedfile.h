@@ -0,0 +1,87 @@
+#pragma once
+
+#include <QFileInfo>
+#include <QString>
+#include <functional>
+
+class QSaveFile;
+
+namespace mixxx {
+
+/// Helpers for files that store data derived from an audio file, e.g.
+/// seek indexes or decoded samples.
+///
+/// The files are named after a hash of the path of the audio file. Each
+/// file starts with a Header that identifies the format and the contents
+/// of the audio file. A file is outdated if the size or the modification
+/// time of the audio file have changed.
+namespace derivedfile {
+
+struct Header {
+    char magic[8];
+    quint32 byteOrderMark;
+    quint32 formatVersion;
+    // The size of the format-specific header that starts with this Header
+    quint32 headerSize;
+    // Format-specific, e.g. the size of entries or the sample format
+    quint32 formatDetail;
+    // Identifies the contents of the audio file
+    qint64 fileSize;
+    qint64 fileLastModified;
+};
+
+enum class HeaderStatus {
+    Valid,
+    // Different format or corrupt
+    Invalid,
+    // The audio file has been modified
+    Outdated,
+};
+
+/// Returns the path of the file in dirPath for the audio file.
+QString filePath(
+        const QString& dirPath,
+        const QFileInfo& audioFileInfo,
+        const QString& nameSuffix);
+
+/// Returns a header for the audio file. formatDetail is 0.
+Header makeHeader(
+        const char (&magic)[8],
+        quint32 formatVersion,
+        quint32 headerSize,
+        const QFileInfo& audioFileInfo);
+
+/// Checks all fields of the header except formatDetail.
+HeaderStatus checkHeader(
+        const Header& header,
+        const char (&magic)[8],
+        quint32 formatVersion,
+        quint32 headerSize,
+        const QFileInfo& audioFileInfo);
+
+/// Writes the data after the header. Returns false on errors or if
+/// writing has been canceled.
+typedef std::function<bool(QSaveFile* pFile)> WriteDataFn;
+
+/// Writes the header followed by the data. The directory is created if
+/// needed.
+///
+/// Multiple threads might write the file of the same audio file
+/// concurrently. The data is written to a unique temporary file that
+/// replaces the file atomically. Existing mappings of the replaced file
+/// stay valid on POSIX systems.
+bool writeFile(
+        const QString& filePath,
+        const Header* pHeader,
+        const WriteDataFn& writeData);
+
+/// Deletes the least recently modified files in dirPath that match
+/// nameFilter until their total size does not exceed maxBytes.
+void evictLeastRecentlyUsed(
+        const QString& dirPath,
+        const QString& nameFilter,
+        qint64 maxBytes);
+
+} // namespace derivedfile
+
+} // namespace mixxx
@@ -0,0 +1,199 @@
+#include "sources/seekindex.h"
+
+#include <QDateTime>
+#include <QFile>
+#include <QMutex>
+#include <QSaveFile>
+#include <cstring>
+#include <utility>
+
+#include "sources/derivedfile.h"
+#include "util/assert.h"
+#include "util/compatibility/qmutex.h"
+#include "util/logger.h"
+
+namespace mixxx {
+
+namespace {
+
+const Logger kLogger("SeekIndex");
+
+constexpr char kFileMagic[8] = {'M', 'X', 'S', 'E', 'E', 'K', 'I', 'X'};
+
+const QString kFileSuffix = QStringLiteral(".seekindex");
+
+// Indexes are only stored for long files and an hour of MP3 audio
+// needs about 2 MiB. The least recently used indexes are deleted
+// when exceeding this limit.
+constexpr qint64 kMaxDirectoryBytes = qint64(128) << 20;
+
+QMutex s_directoryMutex;
+QString s_directory;
+double s_minDurationSeconds = SeekIndex::kDefaultMinDurationSeconds;
+
+} // anonymous namespace
+
+struct SeekIndex::FileHeader {
+    // formatDetail is the size of an Entry
+    derivedfile::Header common;
+    StreamInfo streamInfo;
+    qint64 entryCount;
+};
+
+// static
+void SeekIndex::setDirectory(const QString& dirPath, double minDurationSeconds) {
+    const auto locker = lockMutex(&s_directoryMutex);
+    s_directory = dirPath;
+    s_minDurationSeconds = minDurationSeconds;
+}
+
+// static
+QString SeekIndex::directory() {
+    const auto locker = lockMutex(&s_directoryMutex);
+    return s_directory;
+}
+
+// static
+bool SeekIndex::shouldSave(double durationSeconds) {
+    const auto locker = lockMutex(&s_directoryMutex);
+    return !s_directory.isEmpty() && durationSeconds >= s_minDurationSeconds;
+}
+
+// static
+QString SeekIndex::filePath(const QString& kind, const QFileInfo& fileInfo) {
+    return derivedfile::filePath(
+            directory(), fileInfo, QChar('.') + kind + kFileSuffix);
+}
+
+// static
+SeekIndex SeekIndex::load(const QString& kind, const QFileInfo& fileInfo) {
+    const QString indexFilePath = filePath(kind, fileInfo);
+    if (indexFilePath.isEmpty()) {
+        return SeekIndex();
+    }
+    auto pFile = std::make_unique<QFile>(indexFilePath);
+    if (!pFile->open(QIODevice::ReadOnly)) {
+        return SeekIndex();
+    }
+    FileHeader header;
+    if (pFile->read(reinterpret_cast<char*>(&header), sizeof(header)) != sizeof(header)) {
+        kLogger.info() << "Ignoring invalid seek index" << indexFilePath;
+        return SeekIndex();
+    }
+    switch (derivedfile::checkHeader(header.common,
+            kFileMagic,
+            kFileFormatVersion,
+            sizeof(FileHeader),
+            fileInfo)) {
+    case derivedfile::HeaderStatus::Valid:
+        break;
+    case derivedfile::HeaderStatus::Invalid:
+        kLogger.info() << "Ignoring invalid seek index" << indexFilePath;
+        return SeekIndex();
+    case derivedfile::HeaderStatus::Outdated:
+        // The audio file has been modified and the index will never
+        // become valid again
+        kLogger.debug() << "Deleting outdated seek index" << indexFilePath;
+        pFile->remove();
+        return SeekIndex();
+    }
+    if (header.common.formatDetail != sizeof(Entry) || header.entryCount <= 0) {
+        kLogger.info() << "Ignoring invalid seek index" << indexFilePath;
+        return SeekIndex();
+    }
+    const qint64 mappedSize = sizeof(FileHeader) + header.entryCount * sizeof(Entry);
+    if (pFile->size() != mappedSize) {
+        kLogger.info() << "Ignoring truncated seek index" << indexFilePath;
+        return SeekIndex();
+    }
+    // The entries are only read and pages are loaded on access
+    const uchar* pMapped = pFile->map(0, mappedSize);
+    if (!pMapped) {
+        kLogger.warning() << "Failed to map seek index" << indexFilePath
+                          << pFile->errorString();
+        return SeekIndex();
+    }
+    // Mark the index as recently used
+    pFile->setFileTime(QDateTime::currentDateTimeUtc(),
+            QFileDevice::FileModificationTime);
+    SeekIndex seekIndex;
+    seekIndex.m_pFile = std::move(pFile);
+    seekIndex.m_streamInfo = header.streamInfo;
+    seekIndex.m_pEntries = reinterpret_cast<const Entry*>(pMapped + sizeof(FileHeader));
+    seekIndex.m_entryCount = static_cast<SINT>(header.entryCount);
+    return seekIndex;
+}
+
+// static
+bool SeekIndex::save(const QString& kind,
+        const QFileInfo& fileInfo,
+        const StreamInfo& streamInfo,
+        const Entry* pEntries,
+        SINT entryCount) {
+    VERIFY_OR_DEBUG_ASSERT(pEntries && entryCount > 0) {
+        return false;
+    }
+    const QString indexFilePath = filePath(kind, fileInfo);
+    if (indexFilePath.isEmpty()) {
+        return false;
+    }
+    FileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    header.common = derivedfile::makeHeader(
+            kFileMagic, kFileFormatVersion, sizeof(FileHeader), fileInfo);
+    header.common.formatDetail = sizeof(Entry);
+    header.streamInfo = streamInfo;
+    header.entryCount = entryCount;
+
+    // Multiple sources might save the index of the same file concurrently
+    if (!derivedfile::writeFile(indexFilePath,
+                &header.common,
+                [pEntries, entryCount](QSaveFile* pFile) {
+                    const qint64 entryBytes =
+                            static_cast<qint64>(entryCount) * sizeof(Entry);
+                    return pFile->write(reinterpret_cast<const char*>(pEntries),
+                                   entryBytes) == entryBytes;
+                })) {
+        return false;
+    }
+    kLogger.debug() << "Saved seek index with" << entryCount
+                    << "entries for" << fileInfo.absoluteFilePath();
+    derivedfile::evictLeastRecentlyUsed(
+            QFileInfo(indexFilePath).absolutePath(),
+            QChar('*') + kFileSuffix,
+            kMaxDirectoryBytes);
+    return true;
+}
+
+// static
+void SeekIndex::remove(const QString& kind, const QFileInfo& fileInfo) {
+    const QString indexFilePath = filePath(kind, fileInfo);
+    if (!indexFilePath.isEmpty()) {
+        QFile::remove(indexFilePath);
+    }
+}
+
+SeekIndex::SeekIndex()
+        : m_streamInfo{},
+          m_pEntries(nullptr),
+          m_entryCount(0) {
+}
+
+SeekIndex::SeekIndex(SeekIndex&& other)
+        : m_pFile(std::move(other.m_pFile)),
+          m_streamInfo(other.m_streamInfo),
+          m_pEntries(std::exchange(other.m_pEntries, nullptr)),
+          m_entryCount(std::exchange(other.m_entryCount, 0)) {
+}
+
+SeekIndex& SeekIndex::operator=(SeekIndex&& other) {
+    m_pFile = std::move(other.m_pFile);
+    m_streamInfo = other.m_streamInfo;
+    m_pEntries = std::exchange(other.m_pEntries, nullptr);
+    m_entryCount = std::exchange(other.m_entryCount, 0);
+    return *this;
+}
+
+SeekIndex::~SeekIndex() = default;
+
+} // namespace mixxx
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <QFileInfo>
+#include <QString>
+#include <memory>
+
+#include "util/types.h"
+
+class QFile;
+
+namespace mixxx {
+
+/// A persistent index of the seek positions of an audio file.
+///
+/// Building the index of a long file requires to scan the whole file, e.g.
+/// all MP3 frame headers. The index is stored once in a separate file in
+/// the analysis directory and memory-mapped when the audio file is opened
+/// again. The index is discarded if the size or the modification time of
+/// the audio file have changed. Outdated indexes are deleted when
+/// loading them and the least recently used indexes are deleted when
+/// the size of the directory exceeds a fixed limit.
+///
+/// The format is private to each kind of audio source. The meaning of the
+/// fields of Entry is defined by the audio source.
+class SeekIndex final {
+  public:
+    /// Version of the file format. Files with a different version are
+    /// ignored and replaced.
+    static constexpr quint32 kFileFormatVersion = 1;
+
+    struct Entry {
+        /// The first sample frame or timestamp
+        qint64 frameIndex;
+        /// The position in the audio file
+        qint64 byteOffset;
+    };
+
+    /// Properties of the audio stream that would otherwise need to be
+    /// determined by scanning the file
+    struct StreamInfo {
+        qint64 frameIndexMin;
+        qint64 frameIndexMax;
+        qint32 channelCount;
+        qint32 sampleRate;
+        qint32 bitrate;
+        qint32 reserved;
+    };
+
+    /// Indexes of shorter streams are not stored, because they are
+    /// scanned fast enough.
+    static constexpr double kDefaultMinDurationSeconds = 10 * 60;
+
+    /// Sets the directory for the index files, i.e. enables the
+    /// persistence of indexes. Thread-safe.
+    static void setDirectory(const QString& dirPath,
+            double minDurationSeconds = kDefaultMinDurationSeconds);
+    static QString directory();
+
+    /// Returns true if the index of a stream with the given duration
+    /// should be stored. Thread-safe.
+    static bool shouldSave(double durationSeconds);
+
+    /// Maps the index of the given kind for an audio file. Returns an
+    /// invalid index if no up-to-date index exists.
+    static SeekIndex load(const QString& kind, const QFileInfo& fileInfo);
+
+    /// Stores an index. The entries are copied.
+    static bool save(const QString& kind,
+            const QFileInfo& fileInfo,
+            const StreamInfo& streamInfo,
+            const Entry* pEntries,
+            SINT entryCount);
+
+    /// Deletes a stored index, e.g. if it turned out to be invalid.
+    static void remove(const QString& kind, const QFileInfo& fileInfo);
+
+    SeekIndex();
+    SeekIndex(SeekIndex&&);
+    SeekIndex& operator=(SeekIndex&&);
+    ~SeekIndex();
+
+    bool isValid() const {
+        return m_pEntries != nullptr;
+    }
+
+    const StreamInfo& streamInfo() const {
+        return m_streamInfo;
+    }
+
+    const Entry* entries() const {
+        return m_pEntries;
+    }
+
+    SINT size() const {
+        return m_entryCount;
+    }
+
+  private:
+    struct FileHeader;
+
+    static QString filePath(const QString& kind, const QFileInfo& fileInfo);
+
+    std::unique_ptr<QFile> m_pFile;
+    StreamInfo m_streamInfo;
+    const Entry* m_pEntries;
+    SINT m_entryCount;
+};
+
+} // namespace mixxx
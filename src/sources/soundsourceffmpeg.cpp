@@ -4,8 +4,11 @@
 #include <libavutil/channel_layout.h>
 #endif
 
+#include <cstring>
+
 #include "util/logger.h"
 #include "util/sample.h"
+#include "util/timer.h"
 
 #if !defined(VERBOSE_DEBUG_LOG)
 #define VERBOSE_DEBUG_LOG false
@@ -38,6 +41,24 @@ constexpr uint64_t kavMaxDecodedFramesPerPacket = 16;
 // 0.5 sec @ 96 kHz / 1 sec @ 48 kHz / 1.09 sec @ 44.1 kHz
 constexpr FrameCount kDefaultFrameBufferCapacity = 48000;
 
+const QString kSeekIndexKind = QStringLiteral("ffmpeg");
+
+int getStreamIndexEntryCount(AVStream* pavStream) {
+#if LIBAVFORMAT_VERSION_INT >= AV_VERSION_INT(58, 78, 100) // FFmpeg 4.4
+    return avformat_index_get_entries_count(pavStream);
+#else
+    return pavStream->nb_index_entries;
+#endif
+}
+
+const AVIndexEntry* getStreamIndexEntry(AVStream* pavStream, int index) {
+#if LIBAVFORMAT_VERSION_INT >= AV_VERSION_INT(58, 78, 100) // FFmpeg 4.4
+    return avformat_index_get_entry(pavStream, index);
+#else
+    return &pavStream->index_entries[index];
+#endif
+}
+
 constexpr FrameCount kMinFrameBufferCapacity = kDefaultFrameBufferCapacity;
 
 inline FrameCount frameBufferCapacityForStream(
@@ -476,7 +497,8 @@ SoundSourceFFmpeg::SoundSourceFFmpeg(const QUrl& url)
           m_pavPacket(av_packet_alloc()),
           m_pavDecodedFrame(nullptr),
           m_pavResampledFrame(nullptr),
-          m_seekPrerollFrameCount(0) {
+          m_seekPrerollFrameCount(0),
+          m_seekIndexEntryCount(0) {
     DEBUG_ASSERT(m_pavPacket);
 #if LIBAVUTIL_VERSION_INT >= AV_VERSION_INT(57, 28, 100) // FFmpeg 5.1
     av_channel_layout_default(&m_avStreamChannelLayout, 0);
@@ -497,6 +519,7 @@ SoundSourceFFmpeg::~SoundSourceFFmpeg() {
 SoundSource::OpenResult SoundSourceFFmpeg::tryOpen(
         OpenMode /*mode*/,
         const OpenParams& params) {
+    ScopedTimer t("SoundSourceFFmpeg::tryOpen");
     // Open input
     {
         AVFormatContext* pavInputFormatContext =
@@ -719,6 +742,8 @@ SoundSource::OpenResult SoundSourceFFmpeg::tryOpen(
     kLogger.debug() << "Seek preroll frame count:" << m_seekPrerollFrameCount;
 #endif
 
+    loadSeekIndex();
+
     m_frameBuffer = ReadAheadFrameBuffer(
             getSignalInfo(),
             frameBufferCapacityForStream(*m_pavStream));
@@ -860,7 +885,92 @@ bool SoundSourceFFmpeg::initResampling(
     return true;
 }
 
+SeekIndex::StreamInfo SoundSourceFFmpeg::seekIndexStreamInfo() const {
+    DEBUG_ASSERT(m_pavStream);
+    const auto streamFrameIndexRange = getStreamFrameIndexRange(*m_pavStream);
+    return SeekIndex::StreamInfo{
+            streamFrameIndexRange.start(),
+            streamFrameIndexRange.end(),
+#if LIBAVUTIL_VERSION_INT >= AV_VERSION_INT(57, 28, 100) // FFmpeg 5.1
+            m_pavStream->codecpar->ch_layout.nb_channels,
+#else
+            m_pavStream->codecpar->channels,
+#endif
+            m_pavStream->codecpar->sample_rate,
+            0,
+            0,
+    };
+}
+
+void SoundSourceFFmpeg::loadSeekIndex() {
+    DEBUG_ASSERT(m_pavStream);
+    m_seekIndexEntryCount = getStreamIndexEntryCount(m_pavStream);
+    const SeekIndex seekIndex =
+            SeekIndex::load(kSeekIndexKind, QFileInfo(getLocalFileName()));
+    if (!seekIndex.isValid()) {
+        return;
+    }
+    const SeekIndex::StreamInfo streamInfo = seekIndexStreamInfo();
+    if (std::memcmp(&streamInfo, &seekIndex.streamInfo(), sizeof(streamInfo)) != 0) {
+        kLogger.warning()
+                << "Discarding seek index of a different stream"
+                << getLocalFileName();
+        SeekIndex::remove(kSeekIndexKind, QFileInfo(getLocalFileName()));
+        return;
+    }
+    // The demuxer keeps its own copy of the entries. Only keyframes
+    // have been stored and exact positions allow av_seek_frame() to
+    // jump directly to the packet instead of estimating the position
+    // from the bitrate and resyncing. Entries of the demuxer with the
+    // same timestamp are kept.
+    for (SINT i = 0; i < seekIndex.size(); ++i) {
+        const SeekIndex::Entry& entry = seekIndex.entries()[i];
+        av_add_index_entry(m_pavStream,
+                entry.byteOffset,
+                entry.frameIndex,
+                0,
+                0,
+                AVINDEX_KEYFRAME);
+    }
+    m_seekIndexEntryCount = getStreamIndexEntryCount(m_pavStream);
+}
+
+void SoundSourceFFmpeg::saveSeekIndex() {
+    if (!m_pavStream) {
+        return;
+    }
+    // Only store the index if the demuxer has discovered new positions
+    // while reading, e.g. if the whole stream has been decoded by the
+    // analyzer. Demuxers that read a complete index from the file
+    // headers don't add any entries.
+    const int entryCount = getStreamIndexEntryCount(m_pavStream);
+    if (entryCount <= m_seekIndexEntryCount ||
+            !hasDuration() ||
+            !SeekIndex::shouldSave(getDuration())) {
+        return;
+    }
+    std::vector<SeekIndex::Entry> entries;
+    entries.reserve(entryCount);
+    for (int i = 0; i < entryCount; ++i) {
+        const AVIndexEntry* pavIndexEntry = getStreamIndexEntry(m_pavStream, i);
+        if (pavIndexEntry->flags & AVINDEX_KEYFRAME) {
+            entries.push_back(SeekIndex::Entry{
+                    pavIndexEntry->timestamp,
+                    pavIndexEntry->pos});
+        }
+    }
+    if (entries.empty()) {
+        return;
+    }
+    SeekIndex::save(kSeekIndexKind,
+            QFileInfo(getLocalFileName()),
+            seekIndexStreamInfo(),
+            entries.data(),
+            static_cast<SINT>(entries.size()));
+}
+
 void SoundSourceFFmpeg::close() {
+    saveSeekIndex();
     av_frame_free(&m_pavResampledFrame);
     DEBUG_ASSERT(!m_pavResampledFrame);
     av_frame_free(&m_pavDecodedFrame);
@@ -869,6 +979,7 @@ void SoundSourceFFmpeg::close() {
     m_pavCodecContext.close();
     m_pavInputFormatContext.close();
     m_pavStream = nullptr;
+    m_seekIndexEntryCount = 0;
 }
 
 namespace {
@@ -949,6 +1060,8 @@ bool SoundSourceFFmpeg::adjustCurrentPosition(SINT startIndex) {
         return true;
     }
 
+    ScopedTimer t("SoundSourceFFmpeg::seek");
+
     // Flush internal decoder state before seeking
     avcodec_flush_buffers(m_pavCodecContext);
 
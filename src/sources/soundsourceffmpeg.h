@@ -9,6 +9,7 @@ extern "C" {
 } // extern "C"
 
 #include "sources/readaheadframebuffer.h"
+#include "sources/seekindex.h"
 #include "sources/soundsourceprovider.h"
 
 namespace mixxx {
@@ -189,6 +190,15 @@ class SoundSourceFFmpeg : public SoundSource {
 
     FrameCount m_seekPrerollFrameCount;
 
+    // Injects the persistent index into the demuxer
+    void loadSeekIndex();
+    // Stores the index entries that have been discovered by the demuxer
+    void saveSeekIndex();
+    SeekIndex::StreamInfo seekIndexStreamInfo() const;
+
+    // The number of index entries of the stream after opening
+    int m_seekIndexEntryCount;
+
     ReadAheadFrameBuffer m_frameBuffer;
 };
 
@@ -3,6 +3,7 @@
 
 #include "util/logger.h"
 #include "util/math.h"
+#include "util/timer.h"
 
 #include <id3tag.h>
 
@@ -85,6 +86,8 @@ constexpr SINT kMaxMp3FramesPerSecond = 39; // fixed: 1 MP3 frame = 26 ms -> ~ 1
 constexpr SINT kSeekFrameListCapacity =
         kMinutesPerFile * kSecondsPerMinute * kMaxMp3FramesPerSecond;
 
+const QString kSeekIndexKind = QStringLiteral("mp3");
+
 inline QString formatHeaderFlags(int headerFlags) {
     return QString("0x%1").arg(headerFlags, 4, 16, QLatin1Char('0'));
 }
@@ -175,6 +178,8 @@ SoundSourceMp3::SoundSourceMp3(const QUrl& url)
           m_file(getLocalFileName()),
           m_fileSize(0),
           m_pFileData(nullptr),
+          m_pSeekFrames(nullptr),
+          m_seekFrameCount(0),
           m_avgSeekFrameCount(0),
           m_curFrameIndex(0),
           m_madSynthCount(0),
@@ -204,6 +209,7 @@ void SoundSourceMp3::finishDecoding() {
 SoundSource::OpenResult SoundSourceMp3::tryOpen(
         OpenMode /*mode*/,
         const OpenParams& /*config*/) {
+    ScopedTimer t("SoundSourceMp3::tryOpen");
     DEBUG_ASSERT(!m_file.isOpen());
     if (!m_file.open(QIODevice::ReadOnly)) {
         kLogger.warning() << "Failed to open file:" << m_file.fileName();
@@ -225,8 +231,82 @@ SoundSource::OpenResult SoundSourceMp3::tryOpen(
     mad_stream_buffer(&m_madStream, m_pFileData, m_fileSize);
     DEBUG_ASSERT(m_pFileData == m_madStream.this_frame);
 
-    DEBUG_ASSERT(m_seekFrameList.empty());
     m_avgSeekFrameCount = 0;
+    // The index is only valid if the file has not been modified
+    // since it has been stored
+    SeekIndex seekIndex = SeekIndex::load(kSeekIndexKind, QFileInfo(m_file));
+    if (!initFromSeekIndex(std::move(seekIndex))) {
+        const OpenResult scanResult = scanSeekFrames();
+        if (scanResult != OpenResult::Succeeded) {
+            return scanResult;
+        }
+    }
+    DEBUG_ASSERT(m_seekFrameCount > 1);
+    DEBUG_ASSERT(m_pSeekFrames[0].frameIndex == frameIndexMin());
+    DEBUG_ASSERT(m_pSeekFrames[m_seekFrameCount - 1].frameIndex == frameIndexMax());
+    // The terminating seek frame is not a real MP3 frame
+    m_avgSeekFrameCount = frameLength() / (m_seekFrameCount - 1);
+
+    // Restart decoding at the beginning of the audio stream
+    restartDecoding(m_pSeekFrames[0]);
+
+    if (m_curFrameIndex != frameIndexMin()) {
+        kLogger.warning() << "Failed to start decoding:" << m_file.fileName();
+        // Abort
+        return OpenResult::Failed;
+    }
+
+    return OpenResult::Succeeded;
+}
+
+bool SoundSourceMp3::initFromSeekIndex(SeekIndex seekIndex) {
+    if (!seekIndex.isValid()) {
+        return false;
+    }
+    const SeekIndex::StreamInfo& streamInfo = seekIndex.streamInfo();
+    const SeekFrameType* pEntries = seekIndex.entries();
+    const SINT entryCount = seekIndex.size();
+    // Verify the stored contents before relying on them
+    if (entryCount < 2 ||
+            streamInfo.frameIndexMin != 0 ||
+            pEntries[0].frameIndex != streamInfo.frameIndexMin ||
+            pEntries[entryCount - 1].frameIndex != streamInfo.frameIndexMax ||
+            pEntries[entryCount - 1].byteOffset != static_cast<qint64>(m_fileSize) ||
+            streamInfo.channelCount <= 0 ||
+            streamInfo.channelCount > kChannelCountMax ||
+            getIndexBySampleRate(audio::SampleRate(streamInfo.sampleRate)) >=
+                    kSampleRateCount) {
+        kLogger.warning() << "Discarding corrupt seek index of" << m_file.fileName();
+        SeekIndex::remove(kSeekIndexKind, QFileInfo(m_file));
+        return false;
+    }
+    // Decoding must never start outside of the mapped file and seeking
+    // relies on the order of the entries
+    for (SINT i = 1; i < entryCount; ++i) {
+        if (pEntries[i - 1].byteOffset < 0 ||
+                pEntries[i - 1].byteOffset >= pEntries[i].byteOffset ||
+                pEntries[i - 1].frameIndex >= pEntries[i].frameIndex) {
+            kLogger.warning() << "Discarding corrupt seek index of" << m_file.fileName();
+            SeekIndex::remove(kSeekIndexKind, QFileInfo(m_file));
+            return false;
+        }
+    }
+    initChannelCountOnce(audio::ChannelCount(streamInfo.channelCount));
+    initSampleRateOnce(audio::SampleRate(streamInfo.sampleRate));
+    initFrameIndexRangeOnce(IndexRange::forward(
+            streamInfo.frameIndexMin,
+            streamInfo.frameIndexMax - streamInfo.frameIndexMin));
+    if (streamInfo.bitrate > 0) {
+        initBitrateOnce(streamInfo.bitrate);
+    }
+    m_seekIndex = std::move(seekIndex);
+    m_pSeekFrames = m_seekIndex.entries();
+    m_seekFrameCount = m_seekIndex.size();
+    return true;
+}
+
+SoundSource::OpenResult SoundSourceMp3::scanSeekFrames() {
+    DEBUG_ASSERT(m_seekFrameList.empty());
     m_curFrameIndex = 0;
     int headerPerSampleRate[kSampleRateCount];
     for (int i = 0; i < kSampleRateCount; ++i) {
@@ -304,7 +384,7 @@ SoundSource::OpenResult SoundSourceMp3::tryOpen(
         // Count valid frames separated by its sample rate
         headerPerSampleRate[sampleRateIndex]++;
 
-        addSeekFrame(m_curFrameIndex, m_madStream.this_frame);
+        addSeekFrame(m_curFrameIndex, m_madStream.this_frame - m_pFileData);
 
         // Accumulate data from the header
         if (audio::Bitrate(madHeader.bitrate).isValid()) {
@@ -391,8 +471,6 @@ SoundSource::OpenResult SoundSourceMp3::tryOpen(
     initFrameIndexRangeOnce(IndexRange::forward(0, m_curFrameIndex));
 
     // Calculate average bitrate values
-    DEBUG_ASSERT(m_seekFrameList.size() > 0); // see above
-    m_avgSeekFrameCount = frameLength() / static_cast<SINT>(m_seekFrameList.size());
     if (cntBitrateFrames > 0) {
         const unsigned long avgBitrate = sumBitrateFrames / cntBitrateFrames;
         initBitrateOnce(avgBitrate / 1000); // bps -> kbps
@@ -401,16 +479,26 @@ SoundSource::OpenResult SoundSourceMp3::tryOpen(
     }
 
     // Terminate m_seekFrameList
-    addSeekFrame(m_curFrameIndex, nullptr);
+    addSeekFrame(m_curFrameIndex, m_fileSize);
     DEBUG_ASSERT(m_seekFrameList.back().frameIndex == frameIndexMax());
-
-    // Restart decoding at the beginning of the audio stream
-    restartDecoding(m_seekFrameList.front());
-
-    if (m_curFrameIndex != frameIndexMin()) {
-        kLogger.warning() << "Failed to start decoding:" << m_file.fileName();
-        // Abort
-        return OpenResult::Failed;
+    m_pSeekFrames = m_seekFrameList.data();
+    m_seekFrameCount = static_cast<SINT>(m_seekFrameList.size());
+
+    // Only the seek frames of long files are stored persistently
+    if (hasDuration() && SeekIndex::shouldSave(getDuration())) {
+        const SeekIndex::StreamInfo streamInfo{
+                frameIndexMin(),
+                frameIndexMax(),
+                static_cast<qint32>(getSignalInfo().getChannelCount()),
+                static_cast<qint32>(getSignalInfo().getSampleRate()),
+                getBitrate().isValid() ? static_cast<qint32>(getBitrate()) : 0,
+                0,
+        };
+        SeekIndex::save(kSeekIndexKind,
+                QFileInfo(m_file),
+                streamInfo,
+                m_pSeekFrames,
+                m_seekFrameCount);
     }
 
     return OpenResult::Succeeded;
@@ -427,6 +515,9 @@ void SoundSourceMp3::close() {
     m_file.close();
 
     m_seekFrameList.clear();
+    m_seekIndex = SeekIndex();
+    m_pSeekFrames = nullptr;
+    m_seekFrameCount = 0;
 
     // Re-init the decoder, because the SoundSource might be reopened and
     // the destructor calls finishDecoding() after close().
@@ -456,7 +547,7 @@ void SoundSourceMp3::restartDecoding(
     }
 
     // Fill input buffer
-    mad_stream_buffer(&m_madStream, seekFrame.pInputData, m_fileSize - (seekFrame.pInputData - m_pFileData));
+    mad_stream_buffer(&m_madStream, m_pFileData + seekFrame.byteOffset, m_fileSize - seekFrame.byteOffset);
 
     if (frameIndexMin() < seekFrame.frameIndex) {
         // Muting is done here to eliminate potential pops/clicks
@@ -476,14 +567,13 @@ void SoundSourceMp3::restartDecoding(
 
 void SoundSourceMp3::addSeekFrame(
         SINT frameIndex,
-        const unsigned char* pInputData) {
+        SINT byteOffset) {
     DEBUG_ASSERT(m_seekFrameList.empty() ||
             (m_seekFrameList.back().frameIndex < frameIndex));
     DEBUG_ASSERT(m_seekFrameList.empty() ||
-            (nullptr == pInputData) ||
-            (0 < (pInputData - m_seekFrameList.back().pInputData)));
+            (m_seekFrameList.back().byteOffset < byteOffset));
     SeekFrameType seekFrame;
-    seekFrame.pInputData = pInputData;
+    seekFrame.byteOffset = byteOffset;
     seekFrame.frameIndex = frameIndex;
     m_seekFrameList.push_back(seekFrame);
 }
@@ -492,14 +582,14 @@ SINT SoundSourceMp3::findSeekFrameIndex(
         SINT frameIndex) const {
     // Check preconditions
     DEBUG_ASSERT(0 < m_avgSeekFrameCount);
-    DEBUG_ASSERT(!m_seekFrameList.empty());
-    DEBUG_ASSERT(frameIndexMin() == m_seekFrameList.front().frameIndex);
-    DEBUG_ASSERT(frameIndexMax() == m_seekFrameList.back().frameIndex);
+    DEBUG_ASSERT(m_seekFrameCount > 0);
+    DEBUG_ASSERT(frameIndexMin() == m_pSeekFrames[0].frameIndex);
+    DEBUG_ASSERT(frameIndexMax() == m_pSeekFrames[m_seekFrameCount - 1].frameIndex);
 
     SINT lowerBound =
             0;
     SINT upperBound =
-            m_seekFrameList.size();
+            m_seekFrameCount;
     DEBUG_ASSERT(lowerBound < upperBound);
 
     // Initial guess based on average frame size
@@ -512,8 +602,8 @@ SINT SoundSourceMp3::findSeekFrameIndex(
     while ((upperBound - lowerBound) > 1) {
         DEBUG_ASSERT(seekFrameIndex >= lowerBound);
         DEBUG_ASSERT(seekFrameIndex < upperBound);
-        DEBUG_ASSERT(m_seekFrameList[lowerBound].frameIndex <= frameIndex);
-        if (m_seekFrameList[seekFrameIndex].frameIndex <= frameIndex) {
+        DEBUG_ASSERT(m_pSeekFrames[lowerBound].frameIndex <= frameIndex);
+        if (m_pSeekFrames[seekFrameIndex].frameIndex <= frameIndex) {
             lowerBound = seekFrameIndex;
         } else {
             upperBound = seekFrameIndex;
@@ -524,10 +614,10 @@ SINT SoundSourceMp3::findSeekFrameIndex(
 
     // Check postconditions
     DEBUG_ASSERT(seekFrameIndex == lowerBound);
-    DEBUG_ASSERT(SINT(m_seekFrameList.size()) > seekFrameIndex);
-    DEBUG_ASSERT(m_seekFrameList[seekFrameIndex].frameIndex <= frameIndex);
-    DEBUG_ASSERT(((seekFrameIndex + 1) >= SINT(m_seekFrameList.size())) ||
-            (m_seekFrameList[seekFrameIndex + 1].frameIndex > frameIndex));
+    DEBUG_ASSERT(m_seekFrameCount > seekFrameIndex);
+    DEBUG_ASSERT(m_pSeekFrames[seekFrameIndex].frameIndex <= frameIndex);
+    DEBUG_ASSERT(((seekFrameIndex + 1) >= m_seekFrameCount) ||
+            (m_pSeekFrames[seekFrameIndex + 1].frameIndex > frameIndex));
 
     return seekFrameIndex;
 }
@@ -537,10 +627,11 @@ ReadableSampleFrames SoundSourceMp3::readSampleFramesClamped(
     const SINT firstFrameIndex = writableSampleFrames.frameIndexRange().start();
 
     if ((m_curFrameIndex != firstFrameIndex)) {
+        ScopedTimer t("SoundSourceMp3::seek");
         SINT seekFrameIndex = findSeekFrameIndex(firstFrameIndex);
-        DEBUG_ASSERT(SINT(m_seekFrameList.size()) > seekFrameIndex);
+        DEBUG_ASSERT(m_seekFrameCount > seekFrameIndex);
         const SINT curSeekFrameIndex = findSeekFrameIndex(m_curFrameIndex);
-        DEBUG_ASSERT(SINT(m_seekFrameList.size()) > curSeekFrameIndex);
+        DEBUG_ASSERT(m_seekFrameCount > curSeekFrameIndex);
         // some consistency checks
         DEBUG_ASSERT((curSeekFrameIndex >= seekFrameIndex) || (m_curFrameIndex < firstFrameIndex));
         DEBUG_ASSERT((curSeekFrameIndex <= seekFrameIndex) || (m_curFrameIndex > firstFrameIndex));
@@ -558,7 +649,7 @@ ReadableSampleFrames SoundSourceMp3::readSampleFramesClamped(
                 seekFrameIndex = 0;
             }
 
-            restartDecoding(m_seekFrameList[seekFrameIndex]);
+            restartDecoding(m_pSeekFrames[seekFrameIndex]);
 
             DEBUG_ASSERT(findSeekFrameIndex(m_curFrameIndex) == seekFrameIndex);
         }
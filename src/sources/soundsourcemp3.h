@@ -1,5 +1,6 @@
 #pragma once
 
+#include "sources/seekindex.h"
 #include "sources/soundsourceprovider.h"
 
 #ifdef _MSC_VER
@@ -36,11 +37,8 @@ class SoundSourceMp3 final : public SoundSource {
     quint64 m_fileSize;
     unsigned char* m_pFileData;
 
-    /** Struct used to store mad frames for seeking */
-    struct SeekFrameType {
-        SINT frameIndex;
-        const unsigned char* pInputData;
-    };
+    /** Seek frames are stored with the byte offset of the MP3 frame */
+    typedef SeekIndex::Entry SeekFrameType;
 
     /** It is not possible to make a precise seek in an mp3 file without decoding the whole stream.
      * To have precise seek within a limited range from the current decode position, we keep track
@@ -49,11 +47,20 @@ class SoundSourceMp3 final : public SoundSource {
      */
     typedef std::vector<SeekFrameType> SeekFrameList;
     SeekFrameList m_seekFrameList; // ordered-by frameIndex
-    SINT m_avgSeekFrameCount;      // avg. sample frames per MP3 frame
+    /** The persistent index that replaces m_seekFrameList if available */
+    SeekIndex m_seekIndex;
+    /** Points either into m_seekFrameList or into m_seekIndex */
+    const SeekFrameType* m_pSeekFrames;
+    SINT m_seekFrameCount;
+    SINT m_avgSeekFrameCount; // avg. sample frames per MP3 frame
 
-    void addSeekFrame(SINT frameIndex, const unsigned char* pInputData);
+    /** Scans all frame headers and initializes the stream properties */
+    OpenResult scanSeekFrames();
+    bool initFromSeekIndex(SeekIndex seekIndex);
 
-    /** Returns the position in m_seekFrameList of the requested frame index. */
+    void addSeekFrame(SINT frameIndex, SINT byteOffset);
+
+    /** Returns the position in m_pSeekFrames of the requested frame index. */
     SINT findSeekFrameIndex(SINT frameIndex) const;
 
     SINT m_curFrameIndex;
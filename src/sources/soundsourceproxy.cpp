@@ -5,6 +5,7 @@
 #include <QMimeType>
 #include <QRegularExpression>
 #include <QStandardPaths>
+#include <tuple>
 
 #include "sources/audiosourcetrackproxy.h"
 
@@ -572,6 +573,41 @@ SoundSourceProxy::importTrackMetadataAndCoverImageFromFile(
             resetMissingTagMetadata);
 }
 
+std::optional<SoundSourceProxy::ImportedMetadata>
+SoundSourceProxy::importMetadataOfUncachedFile(
+        mixxx::FileAccess trackFileAccess,
+        bool resetMissingTagMetadata) {
+    if (!trackFileAccess.info().checkFileExists()) {
+        return std::nullopt;
+    }
+    // The cached track must be released after unlocking the cache
+    TrackPointer pCachedTrack;
+    {
+        GlobalTrackCacheLocker locker;
+        pCachedTrack = locker.lookupTrackByRef(
+                TrackRef::fromFileInfo(trackFileAccess.info()));
+    }
+    if (pCachedTrack) {
+        return std::nullopt;
+    }
+    const mixxx::FileInfo trackFileInfo = trackFileAccess.info();
+    ImportedMetadata importedMetadata;
+    QImage coverImage;
+    std::tie(importedMetadata.importResult, importedMetadata.sourceSynchronizedAt) =
+            SoundSourceProxy(Track::newTemporary(std::move(trackFileAccess)))
+                    .importTrackMetadataAndCoverImage(
+                            &importedMetadata.trackMetadata,
+                            &coverImage,
+                            resetMissingTagMetadata);
+    if (!coverImage.isNull()) {
+        // The album is only needed for guessing cover art files
+        importedMetadata.embeddedCoverInfo =
+                CoverInfoGuesser().guessCoverInfo(
+                        trackFileInfo, QString(), coverImage);
+    }
+    return importedMetadata;
+}
+
 std::pair<mixxx::MetadataSource::ImportResult, QDateTime>
 SoundSourceProxy::importTrackMetadataAndCoverImage(
         mixxx::TrackMetadata* pTrackMetadata,
@@ -617,7 +653,8 @@ inline bool shouldImportSeratoTagsFromSource(
 
 SoundSourceProxy::UpdateTrackFromSourceResult SoundSourceProxy::updateTrackFromSource(
         UpdateTrackFromSourceMode mode,
-        const SyncTrackMetadataParams& syncParams) {
+        const SyncTrackMetadataParams& syncParams,
+        const ImportedMetadata* pImportedMetadata) {
     DEBUG_ASSERT(m_pTrack);
 
     if (getUrl().isEmpty()) {
@@ -687,13 +724,30 @@ SoundSourceProxy::UpdateTrackFromSourceResult SoundSourceProxy::updateTrackFromS
         }
     }
 
-    // Parse the tags stored in the audio file and the date and time when the
-    // file has been last modified to detect future changes of the tags.
-    auto [metadataImportResult, sourceSynchronizedAt] =
-            importTrackMetadataAndCoverImage(
-                    &trackMetadata,
-                    pCoverImg,
-                    syncParams.resetMissingTagMetadataOnImport);
+    mixxx::MetadataSource::ImportResult metadataImportResult;
+    QDateTime sourceSynchronizedAt;
+    const CoverInfoRelative* pImportedEmbeddedCoverInfo = nullptr;
+    if (pImportedMetadata &&
+            sourceSyncStatus == mixxx::TrackRecord::SourceSyncStatus::Void) {
+        // The metadata of a new track object has been imported in advance
+        // into an empty TrackMetadata object, i.e. without any defaults
+        // that could have been overwritten.
+        DEBUG_ASSERT(pCoverImg);
+        trackMetadata = pImportedMetadata->trackMetadata;
+        if (pImportedMetadata->embeddedCoverInfo) {
+            pImportedEmbeddedCoverInfo = &*pImportedMetadata->embeddedCoverInfo;
+        }
+        metadataImportResult = pImportedMetadata->importResult;
+        sourceSynchronizedAt = pImportedMetadata->sourceSynchronizedAt;
+    } else {
+        // Parse the tags stored in the audio file and the date and time when the
+        // file has been last modified to detect future changes of the tags.
+        std::tie(metadataImportResult, sourceSynchronizedAt) =
+                importTrackMetadataAndCoverImage(
+                        &trackMetadata,
+                        pCoverImg,
+                        syncParams.resetMissingTagMetadataOnImport);
+    }
     VERIFY_OR_DEBUG_ASSERT(!sourceSynchronizedAt.isValid() ||
             sourceSynchronizedAt.timeSpec() == Qt::UTC) {
         qWarning() << "Converting source synchronization time to UTC:" << sourceSynchronizedAt;
@@ -843,11 +897,12 @@ SoundSourceProxy::UpdateTrackFromSourceResult SoundSourceProxy::updateTrackFromS
 
     if (pCoverImg) {
         // If the pointer is not null then the cover art should be guessed
-        auto coverInfo =
-                CoverInfoGuesser().guessCoverInfo(
-                        m_pTrack->getFileInfo(),
-                        m_pTrack->getAlbum(),
-                        *pCoverImg);
+        auto coverInfo = pImportedEmbeddedCoverInfo
+                ? *pImportedEmbeddedCoverInfo
+                : CoverInfoGuesser().guessCoverInfo(
+                          m_pTrack->getFileInfo(),
+                          m_pTrack->getAlbum(),
+                          *pCoverImg);
         DEBUG_ASSERT(coverInfo.source == CoverInfo::GUESSED);
         m_pTrack->setCoverInfo(coverInfo);
     }
@@ -1,9 +1,13 @@
 #pragma once
 
+#include <QImage>
 #include <QMimeType>
+#include <optional>
 
+#include "library/coverart.h"
 #include "sources/soundsourceproviderregistry.h"
 #include "track/track_decl.h"
+#include "track/trackmetadata.h"
 #include "util/sandbox.h"
 
 namespace mixxx {
@@ -105,6 +109,37 @@ class SoundSourceProxy {
             QImage* pCoverImage,
             bool resetMissingTagMetadata);
 
+    /// Track metadata and embedded cover art of a file that have been
+    /// imported in advance, i.e. before the corresponding track object
+    /// has been created.
+    struct ImportedMetadata {
+        mixxx::MetadataSource::ImportResult importResult =
+                mixxx::MetadataSource::ImportResult::Unavailable;
+        QDateTime sourceSynchronizedAt;
+        mixxx::TrackMetadata trackMetadata;
+        /// Only the hash and the color of the embedded cover art are kept,
+        /// i.e. no decoded image. Cover art is loaded on demand later.
+        std::optional<CoverInfoRelative> embeddedCoverInfo;
+    };
+
+    /// Import both track metadata and the embedded cover image from
+    /// a file that is not referenced by any cached track object.
+    ///
+    /// In contrast to importTrackMetadataAndCoverImageFromFile() the
+    /// GlobalTrackCache is only locked while looking up the file and
+    /// not while parsing it. This allows to parse multiple files in
+    /// parallel, e.g. by the worker threads of the library scanner.
+    /// Metadata is only written into files through cached track objects.
+    ///
+    /// Returns std::nullopt if the file is missing or if it is currently
+    /// cached. In this case the metadata needs to be imported when
+    /// updating the track object from the source.
+    ///
+    /// This function is thread-safe and can be invoked from any thread.
+    static std::optional<ImportedMetadata> importMetadataOfUncachedFile(
+            mixxx::FileAccess trackFileAccess,
+            bool resetMissingTagMetadata);
+
     /// Import both track metadata and/or the cover image of the
     /// captured track object from the corresponding file.
     ///
@@ -172,10 +207,16 @@ class SoundSourceProxy {
     /// properly. The application log will contain warning messages for a detailed
     /// analysis in case unexpected behavior has been reported.
     ///
+    /// Metadata that has been imported in advance with
+    /// importMetadataOfUncachedFile() could optionally be passed to avoid
+    /// parsing the file again. It is only used for new track objects that
+    /// have never been synchronized with their source.
+    ///
     /// Returns true if the track has been modified and false otherwise.
     UpdateTrackFromSourceResult updateTrackFromSource(
             UpdateTrackFromSourceMode mode,
-            const SyncTrackMetadataParams& syncParams);
+            const SyncTrackMetadataParams& syncParams,
+            const ImportedMetadata* pImportedMetadata = nullptr);
 
     /// Opening the audio source through the proxy will update the
     /// audio properties of the corresponding track object. Returns
@@ -0,0 +1,168 @@
+#include "analyzer/analyzerpipeline.h"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "analyzer/constants.h"
+#include "test/mixxxtest.h"
+#include "track/track.h"
+
+namespace {
+
+constexpr int kNumChunks = 100;
+
+class CountingAnalyzer : public Analyzer {
+  public:
+    explicit CountingAnalyzer(bool slow)
+            : m_slow(slow),
+              m_numChunks(0),
+              m_numSamples(0),
+              m_inOrder(true) {
+    }
+
+    bool initialize(const AnalyzerTrack& tio,
+            mixxx::audio::SampleRate sampleRate,
+            SINT totalSamples) override {
+        Q_UNUSED(tio);
+        Q_UNUSED(sampleRate);
+        Q_UNUSED(totalSamples);
+        m_numChunks = 0;
+        m_numSamples = 0;
+        m_inOrder = true;
+        return true;
+    }
+
+    bool processSamples(const CSAMPLE* pIn, SINT iLen) override {
+        if (m_slow) {
+            QThread::usleep(100);
+        }
+        // Every chunk is filled with its index
+        if (pIn[0] != static_cast<CSAMPLE>(m_numChunks) ||
+                pIn[iLen - 1] != static_cast<CSAMPLE>(m_numChunks)) {
+            m_inOrder = false;
+        }
+        ++m_numChunks;
+        m_numSamples += iLen;
+        return true;
+    }
+
+    void storeResults(TrackPointer tio) override {
+        Q_UNUSED(tio);
+    }
+
+    void cleanup() override {
+    }
+
+    int numChunks() const {
+        return m_numChunks;
+    }
+    SINT numSamples() const {
+        return m_numSamples;
+    }
+    bool inOrder() const {
+        return m_inOrder;
+    }
+
+  private:
+    const bool m_slow;
+    int m_numChunks;
+    SINT m_numSamples;
+    bool m_inOrder;
+};
+
+class AnalyzerPipelineTest : public MixxxTest {
+  protected:
+    void SetUp() override {
+        for (bool slow : {false, true, false}) {
+            auto pAnalyzer = std::make_unique<CountingAnalyzer>(slow);
+            m_countingAnalyzers.push_back(pAnalyzer.get());
+            m_analyzers.push_back(AnalyzerWithState(std::move(pAnalyzer)));
+        }
+        m_pTrack = Track::newTemporary();
+    }
+
+    void TearDown() override {
+        for (auto&& analyzer : m_analyzers) {
+            analyzer.cancel();
+        }
+    }
+
+    void initializeAnalyzers() {
+        for (auto&& analyzer : m_analyzers) {
+            analyzer.initialize(
+                    AnalyzerTrack(m_pTrack),
+                    mixxx::audio::SampleRate(44100),
+                    kNumChunks * mixxx::kAnalysisSamplesPerChunk);
+        }
+    }
+
+    void publishChunks(AnalyzerPipeline* pPipeline, int numChunks) {
+        for (int i = 0; i < numChunks; ++i) {
+            const auto slot = pPipeline->nextWritableSlot();
+            ASSERT_EQ(mixxx::kAnalysisSamplesPerChunk, slot.length());
+            // The last chunk is incomplete
+            const SINT numSamples = (i == numChunks - 1)
+                    ? mixxx::kAnalysisSamplesPerChunk / 2
+                    : mixxx::kAnalysisSamplesPerChunk;
+            for (SINT j = 0; j < numSamples; ++j) {
+                slot[j] = static_cast<CSAMPLE>(i);
+            }
+            pPipeline->publishChunk(slot.data(), numSamples);
+        }
+    }
+
+    TrackPointer m_pTrack;
+    std::vector<AnalyzerWithState> m_analyzers;
+    std::vector<const CountingAnalyzer*> m_countingAnalyzers;
+};
+
+TEST_F(AnalyzerPipelineTest, AllAnalyzersProcessAllChunksInOrder) {
+    AnalyzerPipeline pipeline(&m_analyzers, QThread::InheritPriority);
+    constexpr SINT kNumSamplesPerTrack =
+            (kNumChunks - 1) * mixxx::kAnalysisSamplesPerChunk +
+            mixxx::kAnalysisSamplesPerChunk / 2;
+    // Multiple tracks in a row
+    for (int track = 0; track < 3; ++track) {
+        initializeAnalyzers();
+        publishChunks(&pipeline, kNumChunks);
+        pipeline.drain();
+        // The progress is counted across tracks
+        EXPECT_EQ(static_cast<quint64>((track + 1) * kNumSamplesPerTrack),
+                pipeline.numAnalyzedSamples());
+        for (const auto* pAnalyzer : m_countingAnalyzers) {
+            EXPECT_EQ(kNumChunks, pAnalyzer->numChunks());
+            EXPECT_EQ((kNumChunks - 1) * mixxx::kAnalysisSamplesPerChunk +
+                            mixxx::kAnalysisSamplesPerChunk / 2,
+                    pAnalyzer->numSamples());
+            EXPECT_TRUE(pAnalyzer->inOrder());
+        }
+        for (auto&& analyzer : m_analyzers) {
+            analyzer.finish(AnalyzerTrack(m_pTrack));
+        }
+    }
+}
+
+TEST_F(AnalyzerPipelineTest, DiscardPendingChunks) {
+    AnalyzerPipeline pipeline(&m_analyzers, QThread::InheritPriority);
+    initializeAnalyzers();
+    publishChunks(&pipeline, kNumChunks);
+    pipeline.discard();
+    for (const auto* pAnalyzer : m_countingAnalyzers) {
+        EXPECT_LE(pAnalyzer->numChunks(), kNumChunks);
+        EXPECT_TRUE(pAnalyzer->inOrder());
+    }
+    for (auto&& analyzer : m_analyzers) {
+        analyzer.cancel();
+    }
+
+    // The pipeline is still usable afterwards
+    initializeAnalyzers();
+    publishChunks(&pipeline, kNumChunks);
+    pipeline.drain();
+    for (const auto* pAnalyzer : m_countingAnalyzers) {
+        EXPECT_EQ(kNumChunks, pAnalyzer->numChunks());
+    }
+}
+
+} // namespace
@@ -0,0 +1,90 @@
+#include "engine/cachingreader/cachingreaderchunkarena.h"
+
+#include <gtest/gtest.h>
+
+#include <set>
+#include <thread>
+#include <vector>
+
+namespace {
+
+TEST(CachingReaderChunkArenaTest, NumChunksForMemoryBudget) {
+    const SINT chunkBytes = CachingReaderChunk::kSamples * sizeof(CSAMPLE);
+    EXPECT_EQ(1024 * 1024 * 1024 / chunkBytes,
+            CachingReaderChunkArena::numChunksForMemoryBudget(1024));
+    // Clamped to the minimum budget
+    EXPECT_EQ(CachingReaderChunkArena::numChunksForMemoryBudget(
+                      CachingReaderChunkArena::kMinMemoryBudgetMB),
+            CachingReaderChunkArena::numChunksForMemoryBudget(0));
+    // Clamped to the maximum budget
+    EXPECT_EQ(CachingReaderChunkArena::numChunksForMemoryBudget(
+                      CachingReaderChunkArena::kMaxMemoryBudgetMB),
+            CachingReaderChunkArena::numChunksForMemoryBudget(1000000));
+}
+
+TEST(CachingReaderChunkArenaTest, AllocateUntilExhausted) {
+    CachingReaderChunkArena arena(8);
+    EXPECT_EQ(8, arena.capacity());
+    EXPECT_FALSE(arena.isUnderPressure());
+
+    std::set<CachingReaderChunkForOwner*> chunks;
+    for (int i = 0; i < 8; ++i) {
+        auto* pChunk = arena.allocateChunk();
+        ASSERT_NE(nullptr, pChunk);
+        EXPECT_EQ(CachingReaderChunkForOwner::FREE, pChunk->getState());
+        chunks.insert(pChunk);
+    }
+    EXPECT_EQ(8u, chunks.size());
+    EXPECT_EQ(0, arena.numFreeChunks());
+    EXPECT_TRUE(arena.isUnderPressure());
+    EXPECT_EQ(nullptr, arena.allocateChunk());
+
+    auto* pChunk = *chunks.begin();
+    arena.freeChunk(pChunk);
+    EXPECT_EQ(1, arena.numFreeChunks());
+    EXPECT_EQ(pChunk, arena.allocateChunk());
+
+    for (auto* pAllocatedChunk : chunks) {
+        arena.freeChunk(pAllocatedChunk);
+    }
+    EXPECT_EQ(8, arena.numFreeChunks());
+}
+
+TEST(CachingReaderChunkArenaTest, ConcurrentAllocateAndFree) {
+    constexpr int kNumThreads = 4;
+    constexpr int kNumIterations = 20000;
+    CachingReaderChunkArena arena(6);
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kNumThreads; ++t) {
+        threads.emplace_back([&arena] {
+            for (int i = 0; i < kNumIterations; ++i) {
+                auto* pChunk1 = arena.allocateChunk();
+                auto* pChunk2 = arena.allocateChunk();
+                // A chunk must never be handed out twice
+                EXPECT_TRUE(!pChunk1 || pChunk1 != pChunk2);
+                if (pChunk1) {
+                    arena.freeChunk(pChunk1);
+                }
+                if (pChunk2) {
+                    arena.freeChunk(pChunk2);
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    // All chunks are available again and distinct
+    std::set<CachingReaderChunkForOwner*> chunks;
+    while (auto* pChunk = arena.allocateChunk()) {
+        chunks.insert(pChunk);
+    }
+    EXPECT_EQ(6u, chunks.size());
+    for (auto* pChunk : chunks) {
+        arena.freeChunk(pChunk);
+    }
+}
+
+} // namespace
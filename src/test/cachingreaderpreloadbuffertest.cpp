@@ -0,0 +1,113 @@
+#include "engine/cachingreader/cachingreaderpreloadbuffer.h"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+namespace {
+
+// 2.5 chunks
+mixxx::IndexRange trackFrameIndexRange() {
+    return mixxx::IndexRange::forward(
+            0, 2 * CachingReaderChunk::kFrames + CachingReaderChunk::kFrames / 2);
+}
+
+TEST(CachingReaderPreloadBufferTest, RejectTracksExceedingMemoryLimit) {
+    const SINT maxFrames = static_cast<SINT>(
+            CachingReaderPreloadBuffer::kMaxBytes /
+            (CachingReaderChunk::frames2samples(1) * sizeof(CSAMPLE)));
+    EXPECT_EQ(nullptr,
+            CachingReaderPreloadBuffer::allocate(
+                    mixxx::IndexRange::forward(0, maxFrames + 1)));
+}
+
+TEST(CachingReaderPreloadBufferTest, PreloadAllChunks) {
+    auto pPreloadBuffer = CachingReaderPreloadBuffer::allocate(trackFrameIndexRange());
+    ASSERT_NE(nullptr, pPreloadBuffer);
+    EXPECT_EQ(3, pPreloadBuffer->numChunks());
+    EXPECT_FALSE(pPreloadBuffer->isComplete());
+    EXPECT_FALSE(pPreloadBuffer->isChunkReady(-1));
+    EXPECT_FALSE(pPreloadBuffer->isChunkReady(3));
+
+    // Start in the middle and wrap around. Without an audio source all
+    // chunks are filled with silence.
+    mixxx::SampleBuffer tempBuffer(CachingReaderChunk::kSamples);
+    std::vector<SINT> chunkIndices;
+    SINT chunkIndex = 1;
+    while ((chunkIndex = pPreloadBuffer->nextMissingChunk(chunkIndex)) >= 0) {
+        chunkIndices.push_back(chunkIndex);
+        pPreloadBuffer->bufferChunk(chunkIndex,
+                mixxx::AudioSourcePointer(),
+                mixxx::SampleBuffer::WritableSlice(tempBuffer));
+        EXPECT_TRUE(pPreloadBuffer->isChunkReady(chunkIndex));
+        ++chunkIndex;
+    }
+    EXPECT_EQ((std::vector<SINT>{1, 2, 0}), chunkIndices);
+    EXPECT_TRUE(pPreloadBuffer->isComplete());
+    EXPECT_EQ(3, pPreloadBuffer->numReadyChunks());
+}
+
+TEST(CachingReaderPreloadBufferTest, ReadSampleFrames) {
+    auto pPreloadBuffer = CachingReaderPreloadBuffer::allocate(trackFrameIndexRange());
+    ASSERT_NE(nullptr, pPreloadBuffer);
+    mixxx::SampleBuffer tempBuffer(CachingReaderChunk::kSamples);
+    pPreloadBuffer->bufferChunk(2,
+            mixxx::AudioSourcePointer(),
+            mixxx::SampleBuffer::WritableSlice(tempBuffer));
+
+    // The last chunk ends with the track
+    const SINT lastChunkStart = 2 * CachingReaderChunk::kFrames;
+    const auto frameIndexRange = mixxx::IndexRange::forward(
+            lastChunkStart - 16, CachingReaderChunk::kFrames);
+    std::vector<CSAMPLE> buffer(
+            CachingReaderChunk::frames2samples(frameIndexRange.length()), 1.0f);
+    EXPECT_EQ(mixxx::IndexRange::between(lastChunkStart, trackFrameIndexRange().end()),
+            pPreloadBuffer->readSampleFrames(2, buffer.data(), frameIndexRange));
+    // Frames before the chunk are untouched
+    EXPECT_EQ(1.0f, buffer[CachingReaderChunk::frames2samples(16) - 1]);
+    EXPECT_EQ(0.0f, buffer[CachingReaderChunk::frames2samples(16)]);
+
+    std::vector<CSAMPLE> reverseBuffer(buffer.size(), 1.0f);
+    EXPECT_EQ(mixxx::IndexRange::between(lastChunkStart, trackFrameIndexRange().end()),
+            pPreloadBuffer->readSampleFramesReverse(2,
+                    reverseBuffer.data() + reverseBuffer.size(),
+                    frameIndexRange));
+    // The reversed frames before the chunk are at the end
+    EXPECT_EQ(1.0f, reverseBuffer[reverseBuffer.size() - 1]);
+    EXPECT_EQ(0.0f, reverseBuffer[reverseBuffer.size() - CachingReaderChunk::frames2samples(16) - 1]);
+}
+
+TEST(CachingReaderPreloadBufferTest, NonZeroReadableStart) {
+    // Starts within the second chunk of the cache and ends within the third
+    const SINT startFrame = CachingReaderChunk::kFrames + 100;
+    const auto frameIndexRange = mixxx::IndexRange::forward(
+            startFrame, CachingReaderChunk::kFrames);
+    auto pPreloadBuffer = CachingReaderPreloadBuffer::allocate(frameIndexRange);
+    ASSERT_NE(nullptr, pPreloadBuffer);
+    EXPECT_EQ(1, pPreloadBuffer->firstChunkIndex());
+    EXPECT_EQ(2, pPreloadBuffer->numChunks());
+    EXPECT_EQ(1, pPreloadBuffer->nextMissingChunk(0));
+
+    // Chunk indices are the same as those of the cache
+    mixxx::SampleBuffer tempBuffer(CachingReaderChunk::kSamples);
+    pPreloadBuffer->bufferChunk(
+            CachingReaderChunk::indexForFrame(startFrame),
+            mixxx::AudioSourcePointer(),
+            mixxx::SampleBuffer::WritableSlice(tempBuffer));
+    EXPECT_FALSE(pPreloadBuffer->isChunkReady(0));
+    EXPECT_TRUE(pPreloadBuffer->isChunkReady(1));
+    EXPECT_FALSE(pPreloadBuffer->isChunkReady(2));
+    EXPECT_EQ(2, pPreloadBuffer->nextMissingChunk(1));
+
+    const auto chunkFrameIndexRange = mixxx::IndexRange::forward(
+            CachingReaderChunk::kFrames, CachingReaderChunk::kFrames);
+    std::vector<CSAMPLE> buffer(
+            CachingReaderChunk::frames2samples(chunkFrameIndexRange.length()), 1.0f);
+    EXPECT_EQ(mixxx::IndexRange::between(startFrame, 2 * CachingReaderChunk::kFrames),
+            pPreloadBuffer->readSampleFrames(1, buffer.data(), chunkFrameIndexRange));
+    // Frames before the readable range are untouched
+    EXPECT_EQ(1.0f, buffer[CachingReaderChunk::frames2samples(100) - 1]);
+    EXPECT_EQ(0.0f, buffer[CachingReaderChunk::frames2samples(100)]);
+}
+
+} // namespace
@@ -0,0 +1,149 @@
+#include "engine/cachingreader/cachingreaderworker.h"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <set>
+#include <vector>
+
+#include "sources/soundsourceproxy.h"
+#include "test/mixxxtest.h"
+#include "test/soundsourceproviderregistration.h"
+#include "track/track.h"
+#include "util/samplebuffer.h"
+
+namespace {
+
+const QString kGroup = QStringLiteral("[Test]");
+
+// More than the worker reads concurrently
+constexpr int kNumChunks = 10;
+
+} // anonymous namespace
+
+class CachingReaderWorkerTest : public MixxxTest, SoundSourceProviderRegistration {
+  protected:
+    CachingReaderWorkerTest()
+            : m_chunkReadRequestFIFO(16),
+              m_readerStatusFIFO(16),
+              m_worker(kGroup, &m_chunkReadRequestFIFO, &m_readerStatusFIFO),
+              m_sampleBuffer(kNumChunks * CachingReaderChunk::kSamples) {
+        for (int i = 0; i < kNumChunks; ++i) {
+            m_chunks.push_back(std::make_unique<CachingReaderChunkForOwner>(
+                    mixxx::SampleBuffer::WritableSlice(m_sampleBuffer,
+                            i * CachingReaderChunk::kSamples,
+                            CachingReaderChunk::kSamples)));
+        }
+    }
+
+    void SetUp() override {
+        m_pTrack = Track::newTemporary(getTestDir().filePath(QStringLiteral("sine-30.wav")));
+        m_worker.loadTrack(m_pTrack, false); // without preloading
+        ReaderStatusUpdate update;
+        ASSERT_EQ(1, m_readerStatusFIFO.read(&update, 1));
+        ASSERT_EQ(TRACK_LOADED, update.status);
+    }
+
+    void requestAllChunks() {
+        for (int i = 0; i < kNumChunks; ++i) {
+            m_chunks[i]->init(i);
+            CachingReaderChunkReadRequest request;
+            request.giveToWorker(m_chunks[i].get());
+            ASSERT_EQ(1, m_chunkReadRequestFIFO.write(&request, 1));
+        }
+    }
+
+    void setNewTrackAvailable(bool available) {
+        m_worker.m_newTrackAvailable.storeRelease(available ? 1 : 0);
+    }
+
+    void processReadRequests() {
+        m_worker.processReadRequests();
+    }
+
+    void discardAllPendingRequests() {
+        m_worker.discardAllPendingRequests();
+    }
+
+    FIFO<CachingReaderChunkReadRequest> m_chunkReadRequestFIFO;
+    FIFO<ReaderStatusUpdate> m_readerStatusFIFO;
+    CachingReaderWorker m_worker;
+    mixxx::SampleBuffer m_sampleBuffer;
+    std::vector<std::unique_ptr<CachingReaderChunkForOwner>> m_chunks;
+    TrackPointer m_pTrack;
+};
+
+TEST_F(CachingReaderWorkerTest, ReadConcurrently) {
+    requestAllChunks();
+
+    std::vector<CachingReaderChunkForOwner*> reportedChunks;
+    while (m_chunkReadRequestFIFO.readAvailable() > 0) {
+        const int requestCount = m_chunkReadRequestFIFO.readAvailable();
+        processReadRequests();
+        const auto firstReported = reportedChunks.size();
+        ReaderStatusUpdate update;
+        while (m_readerStatusFIFO.read(&update, 1) == 1) {
+            EXPECT_EQ(CHUNK_READ_SUCCESS, update.status);
+            reportedChunks.push_back(update.takeFromWorker());
+        }
+        ASSERT_LT(firstReported, reportedChunks.size());
+        // The first request of each batch has the highest priority and
+        // is always reported first, independent of when the concurrently
+        // read chunks become available
+        EXPECT_EQ(m_chunks[kNumChunks - requestCount].get(),
+                reportedChunks[firstReported]);
+    }
+
+    // Each chunk is reported exactly once
+    ASSERT_EQ(static_cast<std::size_t>(kNumChunks), reportedChunks.size());
+    EXPECT_EQ(static_cast<std::size_t>(kNumChunks),
+            std::set<CachingReaderChunkForOwner*>(
+                    reportedChunks.begin(), reportedChunks.end())
+                    .size());
+
+    // The samples don't depend on the decoder that has read the chunk
+    mixxx::AudioSource::OpenParams params;
+    params.setChannelCount(CachingReaderChunk::kChannels);
+    const auto pAudioSource = SoundSourceProxy(m_pTrack).openAudioSource(params);
+    ASSERT_TRUE(pAudioSource);
+    mixxx::SampleBuffer expectedSamples(CachingReaderChunk::kSamples);
+    mixxx::SampleBuffer actualSamples(CachingReaderChunk::kSamples);
+    for (const auto& pChunk : m_chunks) {
+        const auto frameIndexRange = pChunk->frameIndexRange(pAudioSource);
+        ASSERT_FALSE(frameIndexRange.empty());
+        const auto expectedFrames = pAudioSource->readSampleFrames(
+                mixxx::WritableSampleFrames(frameIndexRange,
+                        mixxx::SampleBuffer::WritableSlice(expectedSamples)));
+        ASSERT_EQ(frameIndexRange, expectedFrames.frameIndexRange());
+        ASSERT_EQ(frameIndexRange,
+                pChunk->readBufferedSampleFrames(
+                        actualSamples.data(), frameIndexRange));
+        const SINT sampleCount = CachingReaderChunk::frames2samples(
+                frameIndexRange.length());
+        for (SINT i = 0; i < sampleCount; ++i) {
+            ASSERT_EQ(expectedSamples[i], actualSamples[i])
+                    << "chunk " << pChunk->getIndex() << ", sample " << i;
+        }
+    }
+}
+
+TEST_F(CachingReaderWorkerTest, KeepRequestsWhileTrackIsPending) {
+    requestAllChunks();
+
+    // Pending requests are discarded when loading the next track
+    setNewTrackAvailable(true);
+    processReadRequests();
+    EXPECT_EQ(kNumChunks, m_chunkReadRequestFIFO.readAvailable());
+    EXPECT_EQ(0, m_readerStatusFIFO.readAvailable());
+
+    setNewTrackAvailable(false);
+    discardAllPendingRequests();
+    ReaderStatusUpdate update;
+    int discardedCount = 0;
+    while (m_readerStatusFIFO.read(&update, 1) == 1) {
+        EXPECT_EQ(CHUNK_READ_DISCARDED, update.status);
+        EXPECT_TRUE(update.takeFromWorker());
+        ++discardedCount;
+    }
+    EXPECT_EQ(kNumChunks, discardedCount);
+}
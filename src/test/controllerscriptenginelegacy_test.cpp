@@ -2,6 +2,7 @@
 
 #include <QScopedPointer>
 #include <QTemporaryFile>
+#include <QTest>
 #include <QThread>
 #include <QtDebug>
 #include <memory>
@@ -620,3 +621,47 @@ TEST_F(ControllerScriptEngineLegacyTest, connectionExecutesWithCorrectThisObject
     // The counter should have been incremented exactly once.
     EXPECT_DOUBLE_EQ(1.0, pass->get());
 }
+
+TEST_F(ControllerScriptEngineLegacyTest, connectionCallbacksAreBatched) {
+    auto co1 = std::make_unique<ControlObject>(ConfigKey("[Test]", "co1"));
+    auto co2 = std::make_unique<ControlObject>(ConfigKey("[Test]", "co2"));
+
+    EXPECT_TRUE(evaluateAndAssert(
+            "var calls = [];"
+            "engine.setCallbackBatchInterval(10);"
+            "engine.makeConnection('[Test]', 'co1', function (value, group, key) {"
+            "  calls.push(key + '=' + value);"
+            "});"
+            "engine.makeConnection('[Test]', 'co2', function (value, group, key) {"
+            "  calls.push(key + '=' + value);"
+            "});"
+            "engine.makeConnection('[Test]', 'co1', function (value, group, key) {"
+            "  calls.push(key + ':' + value);"
+            "});"));
+
+    co2->set(1.0);
+    co1->set(1.0);
+    co1->set(2.0);
+    co2->set(3.0);
+    processEvents();
+    // Nothing is executed before the interval has elapsed
+    EXPECT_EQ(0, evaluate("calls.length").toInt());
+
+    QTest::qSleep(20); // millis
+    processEvents();
+    // Merged in the order of the first change of each control
+    EXPECT_EQ(QStringLiteral("co2=3,co1=2,co1:2"), evaluate("calls.join()").toString());
+
+    // Disabling executes all pending callbacks
+    co1->set(4.0);
+    processEvents();
+    EXPECT_TRUE(evaluateAndAssert("engine.setCallbackBatchInterval(0);"));
+    EXPECT_EQ(QStringLiteral("co2=3,co1=2,co1:2,co1=4,co1:4"),
+            evaluate("calls.join()").toString());
+
+    // Executed immediately without batching
+    co2->set(5.0);
+    processEvents();
+    EXPECT_EQ(QStringLiteral("co2=3,co1=2,co1:2,co1=4,co1:4,co2=5"),
+            evaluate("calls.join()").toString());
+}
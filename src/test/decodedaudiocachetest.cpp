@@ -0,0 +1,179 @@
+#include "sources/decodedaudiocache.h"
+
+#include <gtest/gtest.h>
+
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <vector>
+
+#include "test/derivedfiletest.h"
+
+namespace {
+
+constexpr mixxx::audio::SampleRate kSampleRate = mixxx::audio::SampleRate(44100);
+constexpr SINT kFrameCount = 20000;
+
+class DecodedAudioCacheTest : public DerivedFileTest {
+  protected:
+    void SetUp() override {
+        DerivedFileTest::SetUp();
+        configure(1024 * 1024, mixxx::DecodedAudioCache::SampleFormat::Float32);
+        m_samples.resize(2 * kFrameCount);
+        for (std::size_t i = 0; i < m_samples.size(); ++i) {
+            m_samples[i] = static_cast<CSAMPLE>(i % 200) / 100 - 1;
+        }
+    }
+
+    void TearDown() override {
+        mixxx::DecodedAudioCache::configure(
+                QString(), 0, mixxx::DecodedAudioCache::SampleFormat::Float32);
+    }
+
+    void configure(qint64 maxBytes, mixxx::DecodedAudioCache::SampleFormat sampleFormat) {
+        mixxx::DecodedAudioCache::configure(
+                m_tempDir.filePath("cache"), maxBytes, sampleFormat);
+    }
+
+    // Moves the last usage of all entries into the past
+    void ageEntries() {
+        const auto entries = QDir(m_tempDir.filePath("cache"))
+                                     .entryInfoList(QStringList{"*.pcm"}, QDir::Files);
+        for (const auto& entry : entries) {
+            QFile file(entry.absoluteFilePath());
+            ASSERT_TRUE(file.open(QIODevice::ReadWrite));
+            ASSERT_TRUE(file.setFileTime(entry.lastModified().addSecs(-10),
+                    QFileDevice::FileModificationTime));
+        }
+    }
+
+    bool store(const QString& filePath) {
+        return mixxx::DecodedAudioCache::store(QFileInfo(filePath),
+                kSampleRate,
+                mixxx::IndexRange::forward(0, kFrameCount),
+                m_samples.data());
+    }
+
+    std::vector<CSAMPLE> readAll(const mixxx::AudioSourcePointer& pAudioSource) {
+        std::vector<CSAMPLE> samples(2 * kFrameCount);
+        const auto readableSampleFrames = pAudioSource->readSampleFrames(
+                mixxx::WritableSampleFrames(
+                        mixxx::IndexRange::forward(0, kFrameCount),
+                        mixxx::SampleBuffer::WritableSlice(
+                                samples.data(), samples.size())));
+        EXPECT_EQ(mixxx::IndexRange::forward(0, kFrameCount),
+                readableSampleFrames.frameIndexRange());
+        return samples;
+    }
+
+    std::vector<CSAMPLE> m_samples;
+};
+
+TEST_F(DecodedAudioCacheTest, storeAndReadFloat32) {
+    ASSERT_TRUE(store(m_audioFilePath));
+
+    const auto pAudioSource = mixxx::DecodedAudioCache::open(QFileInfo(m_audioFilePath));
+    ASSERT_NE(nullptr, pAudioSource);
+    EXPECT_EQ(kSampleRate, pAudioSource->getSignalInfo().getSampleRate());
+    EXPECT_EQ(mixxx::audio::ChannelCount::stereo(),
+            pAudioSource->getSignalInfo().getChannelCount());
+    EXPECT_EQ(m_samples, readAll(pAudioSource));
+}
+
+TEST_F(DecodedAudioCacheTest, sampleRateOfEntry) {
+    // Entries are keyed by the audio file, not by its sample rate
+    constexpr auto kOtherSampleRate = mixxx::audio::SampleRate(48000);
+    ASSERT_TRUE(store(m_audioFilePath));
+    ASSERT_TRUE(mixxx::DecodedAudioCache::store(QFileInfo(m_audioFilePath),
+            kOtherSampleRate,
+            mixxx::IndexRange::forward(0, kFrameCount),
+            m_samples.data()));
+
+    const auto pAudioSource = mixxx::DecodedAudioCache::open(QFileInfo(m_audioFilePath));
+    ASSERT_NE(nullptr, pAudioSource);
+    EXPECT_EQ(kOtherSampleRate, pAudioSource->getSignalInfo().getSampleRate());
+    EXPECT_EQ(1,
+            QDir(m_tempDir.filePath("cache"))
+                    .entryList(QStringList{"*.pcm"}, QDir::Files)
+                    .size());
+}
+
+TEST_F(DecodedAudioCacheTest, storeAndReadInt16) {
+    configure(1024 * 1024, mixxx::DecodedAudioCache::SampleFormat::Int16);
+    ASSERT_TRUE(store(m_audioFilePath));
+
+    const auto pAudioSource = mixxx::DecodedAudioCache::open(QFileInfo(m_audioFilePath));
+    ASSERT_NE(nullptr, pAudioSource);
+    const auto samples = readAll(pAudioSource);
+    for (std::size_t i = 0; i < samples.size(); ++i) {
+        EXPECT_NEAR(m_samples[i], samples[i], 1.0 / 16384);
+    }
+}
+
+TEST_F(DecodedAudioCacheTest, modifiedFileInvalidatesEntry) {
+    ASSERT_TRUE(store(m_audioFilePath));
+
+    writeAudioFile(m_audioFilePath, QByteArray(2000, 'y'));
+
+    EXPECT_FALSE(mixxx::DecodedAudioCache::contains(QFileInfo(m_audioFilePath)));
+}
+
+TEST_F(DecodedAudioCacheTest, containsDoesNotMarkEntryAsUsed) {
+    ASSERT_TRUE(store(m_audioFilePath));
+    ageEntries();
+    const auto entries = QDir(m_tempDir.filePath("cache"))
+                                 .entryInfoList(QStringList{"*.pcm"}, QDir::Files);
+    ASSERT_EQ(1, entries.size());
+    const QDateTime lastUsed = entries.first().lastModified();
+
+    EXPECT_TRUE(mixxx::DecodedAudioCache::contains(QFileInfo(m_audioFilePath)));
+    EXPECT_EQ(lastUsed, QFileInfo(entries.first().absoluteFilePath()).lastModified());
+}
+
+TEST_F(DecodedAudioCacheTest, evictLeastRecentlyUsed) {
+    // Float32 entries need 160000 bytes each
+    configure(400000, mixxx::DecodedAudioCache::SampleFormat::Float32);
+    const QString otherFilePath = m_tempDir.filePath("other.mp3");
+    writeAudioFile(otherFilePath, QByteArray(1000, 'z'));
+    const QString thirdFilePath = m_tempDir.filePath("third.mp3");
+    writeAudioFile(thirdFilePath, QByteArray(1000, 'w'));
+
+    ASSERT_TRUE(store(m_audioFilePath));
+    ageEntries();
+    ASSERT_TRUE(store(otherFilePath));
+    ageEntries();
+    ASSERT_TRUE(store(thirdFilePath));
+
+    // Only the two most recently stored entries fit into the cache
+    EXPECT_TRUE(mixxx::DecodedAudioCache::contains(QFileInfo(thirdFilePath)));
+    EXPECT_TRUE(mixxx::DecodedAudioCache::contains(QFileInfo(otherFilePath)));
+    EXPECT_EQ(2,
+            QDir(m_tempDir.filePath("cache"))
+                    .entryList(QStringList{"*.pcm"}, QDir::Files)
+                    .size());
+}
+
+TEST_F(DecodedAudioCacheTest, canStore) {
+    // Float32 entries need 160000 bytes each
+    configure(100000, mixxx::DecodedAudioCache::SampleFormat::Float32);
+    EXPECT_FALSE(mixxx::DecodedAudioCache::canStore(
+            mixxx::IndexRange::forward(0, kFrameCount)));
+    EXPECT_FALSE(store(m_audioFilePath));
+
+    // Int16 entries only need half of the size
+    configure(100000, mixxx::DecodedAudioCache::SampleFormat::Int16);
+    EXPECT_TRUE(mixxx::DecodedAudioCache::canStore(
+            mixxx::IndexRange::forward(0, kFrameCount)));
+    EXPECT_TRUE(store(m_audioFilePath));
+}
+
+TEST_F(DecodedAudioCacheTest, disabled) {
+    configure(0, mixxx::DecodedAudioCache::SampleFormat::Float32);
+    EXPECT_FALSE(mixxx::DecodedAudioCache::isEnabled());
+    EXPECT_FALSE(mixxx::DecodedAudioCache::canStore(
+            mixxx::IndexRange::forward(0, kFrameCount)));
+    EXPECT_FALSE(store(m_audioFilePath));
+    EXPECT_FALSE(mixxx::DecodedAudioCache::contains(QFileInfo(m_audioFilePath)));
+}
+
+} // anonymous namespace
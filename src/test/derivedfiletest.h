@@ -0,0 +1,30 @@
+#pragma once
+
+#include <gtest/gtest.h>
+
+#include <QByteArray>
+#include <QFile>
+#include <QString>
+#include <QTemporaryDir>
+
+/// Common fixture for files that are derived from an audio file, see
+/// sources/derivedfile.h. The audio file is a fake with arbitrary content
+/// in a temporary directory.
+class DerivedFileTest : public testing::Test {
+  protected:
+    void SetUp() override {
+        ASSERT_TRUE(m_tempDir.isValid());
+        m_audioFilePath = m_tempDir.filePath("audio.mp3");
+        writeAudioFile(m_audioFilePath, QByteArray(1000, 'x'));
+    }
+
+    /// Modifies the size and the contents of a file
+    static void writeAudioFile(const QString& filePath, const QByteArray& content) {
+        QFile file(filePath);
+        ASSERT_TRUE(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+        ASSERT_EQ(content.size(), file.write(content));
+    }
+
+    QTemporaryDir m_tempDir;
+    QString m_audioFilePath;
+};
@@ -0,0 +1,356 @@
+#include "engine/effects/engineeffectsmanager.h"
+
+#include <gtest/gtest.h>
+
+#include <QList>
+#include <QSet>
+#include <memory>
+#include <vector>
+
+#include "effects/backends/builtin/echoeffect.h"
+#include "effects/backends/builtin/flangereffect.h"
+#include "effects/backends/builtin/reverbeffect.h"
+#include "effects/backends/effectsbackendmanager.h"
+#include "engine/effects/engineeffect.h"
+#include "engine/effects/engineeffectchain.h"
+#include "engine/engine.h"
+#include "engine/enginerealtimeworkerpool.h"
+#include "test/mixxxtest.h"
+#include "util/samplebuffer.h"
+
+namespace {
+
+constexpr int kNumChannels = 4;
+constexpr int kNumChains = 4;
+constexpr unsigned int kSampleRate = 44100;
+constexpr unsigned int kNumSamples = 256;
+constexpr int kMessagePipeFifoSize = 256;
+
+/// The post-fader effect chains of a mixer, which are wired up by sending
+/// requests to an EngineEffectsManager like EffectsManager does.
+class EffectsSetup {
+  public:
+    EffectsSetup(EffectsBackendManagerPointer pBackendManager,
+            const QSet<ChannelHandleAndGroup>& inputChannels,
+            const QSet<ChannelHandleAndGroup>& outputChannels)
+            : m_pBackendManager(pBackendManager),
+              m_inputChannels(inputChannels),
+              m_outputChannels(outputChannels) {
+        const auto pipes =
+                TwoWayMessagePipe<EffectsRequest*, EffectsResponse>::makeTwoWayMessagePipe(
+                        kMessagePipeFifoSize, kMessagePipeFifoSize);
+        m_pRequestPipe.reset(pipes.first);
+        m_pEngineEffectsManager = std::make_unique<EngineEffectsManager>(pipes.second);
+
+        const QStringList effectIds = {
+                EchoEffect::getId(),
+                ReverbEffect::getId(),
+                FlangerEffect::getId(),
+        };
+        for (int i = 0; i < kNumChains; ++i) {
+            auto pChain = std::make_unique<EngineEffectChain>(
+                    QStringLiteral("[EffectRack1_EffectUnit%1]").arg(i + 1),
+                    m_inputChannels,
+                    m_outputChannels);
+            auto* pRequest = newRequest(EffectsRequest::ADD_EFFECT_CHAIN);
+            pRequest->AddEffectChain.pChain = pChain.get();
+            pRequest->AddEffectChain.signalProcessingStage = SignalProcessingStage::Postfader;
+            for (int j = 0; j < effectIds.size(); ++j) {
+                addEffect(pChain.get(), j, effectIds[j]);
+            }
+            setChainParameters(pChain.get(), true);
+            m_chains.push_back(std::move(pChain));
+        }
+    }
+
+    EngineEffectsManager* engineEffectsManager() const {
+        return m_pEngineEffectsManager.get();
+    }
+
+    EngineEffectChain* chain(int index) const {
+        return m_chains[index].get();
+    }
+
+    const std::vector<std::unique_ptr<EngineEffect>>& effects() const {
+        return m_effects;
+    }
+
+    void setEffectEnabled(EngineEffect* pEffect, bool enabled) {
+        auto* pRequest = newRequest(EffectsRequest::SET_EFFECT_PARAMETERS);
+        pRequest->pTargetEffect = pEffect;
+        pRequest->SetEffectParameters.enabled = enabled;
+    }
+
+    void setChainEnabled(int chainIndex, bool enabled) {
+        setChainParameters(chain(chainIndex), enabled);
+    }
+
+    void setChannelRouted(int chainIndex, const ChannelHandle& inputHandle, bool routed) {
+        auto* pRequest = newRequest(routed
+                        ? EffectsRequest::ENABLE_EFFECT_CHAIN_FOR_INPUT_CHANNEL
+                        : EffectsRequest::DISABLE_EFFECT_CHAIN_FOR_INPUT_CHANNEL);
+        pRequest->pTargetChain = chain(chainIndex);
+        if (routed) {
+            pRequest->EnableInputChannelForChain.channelHandle = inputHandle;
+        } else {
+            pRequest->DisableInputChannelForChain.channelHandle = inputHandle;
+        }
+    }
+
+    /// Delivers the pending requests like at the start of an engine callback
+    void onCallbackStart() {
+        for (const auto& pRequest : m_pendingRequests) {
+            ASSERT_TRUE(m_pRequestPipe->writeMessage(pRequest.get()));
+        }
+        m_pEngineEffectsManager->onCallbackStart();
+        EffectsResponse response;
+        int numResponses = 0;
+        while (m_pRequestPipe->readMessage(&response)) {
+            EXPECT_TRUE(response.success);
+            ++numResponses;
+        }
+        EXPECT_EQ(static_cast<int>(m_pendingRequests.size()), numResponses);
+        m_pendingRequests.clear();
+    }
+
+  private:
+    EffectsRequest* newRequest(EffectsRequest::MessageType type) {
+        m_pendingRequests.push_back(std::make_unique<EffectsRequest>());
+        EffectsRequest* pRequest = m_pendingRequests.back().get();
+        pRequest->type = type;
+        pRequest->request_id = m_nextRequestId++;
+        return pRequest;
+    }
+
+    void addEffect(EngineEffectChain* pChain, int index, const QString& id) {
+        auto pEffect = std::make_unique<EngineEffect>(
+                m_pBackendManager->getManifest(id, EffectBackendType::BuiltIn),
+                m_pBackendManager,
+                m_inputChannels,
+                m_inputChannels,
+                m_outputChannels);
+        auto* pRequest = newRequest(EffectsRequest::ADD_EFFECT_TO_CHAIN);
+        pRequest->pTargetChain = pChain;
+        pRequest->AddEffectToChain.pEffect = pEffect.get();
+        pRequest->AddEffectToChain.iIndex = index;
+        setEffectEnabled(pEffect.get(), true);
+        m_effects.push_back(std::move(pEffect));
+    }
+
+    void setChainParameters(EngineEffectChain* pChain, bool enabled) {
+        auto* pRequest = newRequest(EffectsRequest::SET_EFFECT_CHAIN_PARAMETERS);
+        pRequest->pTargetChain = pChain;
+        pRequest->SetEffectChainParameters.enabled = enabled;
+        pRequest->SetEffectChainParameters.mix_mode = EffectChainMixMode::DrySlashWet;
+        pRequest->SetEffectChainParameters.mix = 0.75;
+    }
+
+    const EffectsBackendManagerPointer m_pBackendManager;
+    const QSet<ChannelHandleAndGroup> m_inputChannels;
+    const QSet<ChannelHandleAndGroup> m_outputChannels;
+    std::unique_ptr<EffectsRequestPipe> m_pRequestPipe;
+    std::vector<std::unique_ptr<EngineEffect>> m_effects;
+    std::vector<std::unique_ptr<EngineEffectChain>> m_chains;
+    std::unique_ptr<EngineEffectsManager> m_pEngineEffectsManager;
+    std::vector<std::unique_ptr<EffectsRequest>> m_pendingRequests;
+    qint64 m_nextRequestId = 0;
+};
+
+class EngineEffectsManagerTest : public MixxxTest {
+  protected:
+    EngineEffectsManagerTest()
+            : m_pChannelHandleFactory(std::make_shared<ChannelHandleFactory>()),
+              m_pBackendManager(new EffectsBackendManager()),
+              m_outputChannel(registerChannel(QStringLiteral("[Master]"))) {
+        for (int i = 0; i < kNumChannels; ++i) {
+            m_inputChannels.append(registerChannel(QStringLiteral("[Channel%1]").arg(i + 1)));
+        }
+    }
+
+    ChannelHandleAndGroup registerChannel(const QString& group) {
+        return ChannelHandleAndGroup(m_pChannelHandleFactory->getOrCreateHandle(group), group);
+    }
+
+    std::unique_ptr<EffectsSetup> newEffectsSetup() const {
+        QSet<ChannelHandleAndGroup> inputChannels;
+        for (const auto& inputChannel : m_inputChannels) {
+            inputChannels.insert(inputChannel);
+        }
+        return std::make_unique<EffectsSetup>(m_pBackendManager,
+                inputChannels,
+                QSet<ChannelHandleAndGroup>{m_outputChannel});
+    }
+
+    /// Fills the buffers with a different signal for each channel and callback
+    static void fillInputBuffers(std::vector<mixxx::SampleBuffer>* pBuffers, int callback) {
+        for (int channel = 0; channel < kNumChannels; ++channel) {
+            CSAMPLE* pBuffer = (*pBuffers)[channel].data();
+            for (unsigned int i = 0; i < kNumSamples; ++i) {
+                const int sample = callback * kNumSamples + i;
+                pBuffer[i] = static_cast<CSAMPLE>(
+                                     (sample * (channel + 3) + (i % 2) * 17) % 211) /
+                                211.0f -
+                        0.5f;
+            }
+        }
+    }
+
+    const ChannelHandleFactoryPointer m_pChannelHandleFactory;
+    const EffectsBackendManagerPointer m_pBackendManager;
+    const ChannelHandleAndGroup m_outputChannel;
+    QList<ChannelHandleAndGroup> m_inputChannels;
+};
+
+TEST_F(EngineEffectsManagerTest, concurrentProcessingMatchesSerial) {
+    EngineRealtimeWorkerPool workerPool(3);
+    auto pSerialSetup = newEffectsSetup();
+    auto pConcurrentSetup = newEffectsSetup();
+    // Channels 1 and 4 share the first chain and need to be processed in
+    // order. The last chain is not routed at all.
+    for (auto* pSetup : {pSerialSetup.get(), pConcurrentSetup.get()}) {
+        pSetup->setChannelRouted(0, m_inputChannels[0].handle(), true);
+        pSetup->setChannelRouted(0, m_inputChannels[3].handle(), true);
+        pSetup->setChannelRouted(1, m_inputChannels[1].handle(), true);
+        pSetup->setChannelRouted(2, m_inputChannels[2].handle(), true);
+    }
+
+    std::vector<mixxx::SampleBuffer> serialBuffers;
+    std::vector<mixxx::SampleBuffer> concurrentBuffers;
+    serialBuffers.reserve(kNumChannels);
+    concurrentBuffers.reserve(kNumChannels);
+    for (int i = 0; i < kNumChannels; ++i) {
+        serialBuffers.emplace_back(kNumSamples);
+        concurrentBuffers.emplace_back(kNumSamples);
+    }
+    const GroupFeatureState groupFeatures;
+
+    for (int callback = 0; callback < 40; ++callback) {
+        // Change the routing while processing
+        for (auto* pSetup : {pSerialSetup.get(), pConcurrentSetup.get()}) {
+            if (callback == 10) {
+                pSetup->setChannelRouted(1, m_inputChannels[1].handle(), false);
+                pSetup->setChannelRouted(1, m_inputChannels[2].handle(), true);
+            } else if (callback == 20) {
+                pSetup->setChainEnabled(2, false);
+            } else if (callback == 25) {
+                pSetup->setChainEnabled(2, true);
+            }
+            pSetup->onCallbackStart();
+        }
+        fillInputBuffers(&serialBuffers, callback);
+        fillInputBuffers(&concurrentBuffers, callback);
+
+        EngineEffectsManager::InPlaceChannels channels;
+        for (int i = 0; i < kNumChannels; ++i) {
+            const auto oldGain = static_cast<CSAMPLE_GAIN>(
+                    1.0 - 0.01 * ((callback + i) % 10));
+            const auto newGain = static_cast<CSAMPLE_GAIN>(
+                    1.0 - 0.01 * ((callback + i + 1) % 10));
+            // Pause one of the channels temporarily
+            const bool fadeout = i == 3 && callback == 30;
+            channels.append(EngineEffectsManager::InPlaceChannel{
+                    m_inputChannels[i].handle(),
+                    serialBuffers[i].data(),
+                    &groupFeatures,
+                    oldGain,
+                    fadeout ? CSAMPLE_GAIN_ZERO : newGain,
+                    fadeout});
+        }
+        for (const auto& channel : std::as_const(channels)) {
+            pSerialSetup->engineEffectsManager()->processPostFaderInPlace(
+                    channel.inputHandle,
+                    m_outputChannel.handle(),
+                    channel.pInOut,
+                    kNumSamples,
+                    kSampleRate,
+                    *channel.pGroupFeatures,
+                    channel.oldGain,
+                    channel.newGain,
+                    channel.fadeout);
+        }
+        for (int i = 0; i < kNumChannels; ++i) {
+            channels[i].pInOut = concurrentBuffers[i].data();
+        }
+        pConcurrentSetup->engineEffectsManager()->processPostFaderInPlace(
+                m_outputChannel.handle(),
+                channels,
+                kNumSamples,
+                kSampleRate,
+                &workerPool);
+
+        for (int channel = 0; channel < kNumChannels; ++channel) {
+            for (unsigned int i = 0; i < kNumSamples; ++i) {
+                // Bitwise identical
+                ASSERT_EQ(serialBuffers[channel].data()[i], concurrentBuffers[channel].data()[i])
+                        << "callback " << callback << ", channel " << channel
+                        << ", sample " << i;
+            }
+        }
+    }
+}
+
+TEST_F(EngineEffectsManagerTest, budgetGuardBypassesMostExpensiveEffect) {
+    auto pSetup = newEffectsSetup();
+    pSetup->setChannelRouted(0, m_inputChannels[0].handle(), true);
+    pSetup->onCallbackStart();
+    EngineEffectsManager* pManager = pSetup->engineEffectsManager();
+
+    mixxx::SampleBuffer buffer(kNumSamples);
+    const GroupFeatureState groupFeatures;
+    const auto callbackPeriod = mixxx::Duration::fromSeconds(
+            static_cast<double>(kNumSamples / mixxx::kEngineChannelCount) / kSampleRate);
+    const auto processCallback = [&](mixxx::Duration callbackDuration, bool budgetGuardEnabled) {
+        pManager->processPostFaderInPlace(m_inputChannels[0].handle(),
+                m_outputChannel.handle(),
+                buffer.data(),
+                kNumSamples,
+                kSampleRate,
+                groupFeatures,
+                CSAMPLE_GAIN_ONE,
+                CSAMPLE_GAIN_ONE,
+                false);
+        return pManager->onCallbackEnd(callbackDuration, callbackPeriod, budgetGuardEnabled);
+    };
+    const auto bypassedEffects = [&pSetup]() {
+        QList<EngineEffect*> bypassedEffects;
+        for (const auto& pEffect : pSetup->effects()) {
+            if (pEffect->isBypassed()) {
+                bypassedEffects.append(pEffect.get());
+            }
+        }
+        return bypassedEffects;
+    };
+
+    for (int i = 0; i < 10; ++i) {
+        EXPECT_FALSE(processCallback(callbackPeriod, false));
+    }
+    // Only the effects of the first chain have been processed
+    for (int i = 0; i < static_cast<int>(pSetup->effects().size()); ++i) {
+        if (i < 3) {
+            EXPECT_LT(0.0, pSetup->effects()[i]->processingLoad()) << i;
+        } else {
+            EXPECT_EQ(0.0, pSetup->effects()[i]->processingLoad()) << i;
+        }
+    }
+    EXPECT_TRUE(bypassedEffects().isEmpty());
+
+    // A single callback over budget is tolerated
+    EXPECT_FALSE(processCallback(callbackPeriod, true));
+    EXPECT_FALSE(processCallback(mixxx::Duration::empty(), true));
+    EXPECT_FALSE(processCallback(callbackPeriod, true));
+    EXPECT_TRUE(bypassedEffects().isEmpty());
+
+    EXPECT_TRUE(processCallback(callbackPeriod, true));
+    const auto bypassed = bypassedEffects();
+    ASSERT_EQ(1, bypassed.size());
+    for (int i = 0; i < 3; ++i) {
+        EXPECT_LE(pSetup->effects()[i]->processingLoad(), bypassed[0]->processingLoad());
+    }
+
+    // The enable switch overrides the budget guard
+    pSetup->setEffectEnabled(bypassed[0], true);
+    pSetup->onCallbackStart();
+    EXPECT_TRUE(bypassedEffects().isEmpty());
+}
+
+} // namespace
@@ -0,0 +1,189 @@
+#include <benchmark/benchmark.h>
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "effects/backends/builtin/bessel4lvmixeqeffect.h"
+#include "effects/backends/builtin/bessel8lvmixeqeffect.h"
+#include "engine/filters/enginefilterbessel4.h"
+#include "engine/filters/enginefilterbessel8.h"
+#include "engine/filters/enginefilterbutterworth8.h"
+#include "util/sample.h"
+
+// The benchmarks compare EngineFilterIIR, which processes both channels
+// together in SIMD lanes, with the scalar processing of one sample at a time
+// that has been used before:
+//   mixxx-test --benchmark --benchmark_filter=BM_EngineFilterIIR
+
+namespace {
+
+constexpr int kSampleRate = 44100;
+constexpr int kBufferSize = 1024;
+constexpr double kCornerFreq = 246;
+
+std::vector<CSAMPLE> makeSignal(int numSamples) {
+    std::vector<CSAMPLE> signal(numSamples);
+    for (int i = 0; i < numSamples; ++i) {
+        // Left and right channel differ
+        signal[i] = static_cast<CSAMPLE>((i * 37 + (i % 2) * 11) % 101) / 101.0f - 0.5f;
+    }
+    return signal;
+}
+
+/// Processes interleaved stereo samples one at a time like
+/// EngineFilterIIR::process() did before the channels have
+/// been moved into SIMD lanes.
+template<unsigned int SIZE, enum IIRPass PASS>
+class ScalarFilter {
+  public:
+    ScalarFilter(const char* spec, double freq) {
+        char spec_d[FIDSPEC_LENGTH];
+        std::strncpy(spec_d, spec, sizeof(spec_d));
+        m_coef[0] = fid_design_coef(m_coef + 1, SIZE, spec_d, kSampleRate, freq, 0, 0);
+    }
+
+    void process(const CSAMPLE* pIn, CSAMPLE* pOutput, int iBufferSize) {
+        for (int i = 0; i < iBufferSize; i += 2) {
+            pOutput[i] = static_cast<CSAMPLE>(
+                    EngineFilterIIRKernel<SIZE, PASS>::processSample(
+                            m_coef, m_buf1, static_cast<double>(pIn[i])));
+            pOutput[i + 1] = static_cast<CSAMPLE>(
+                    EngineFilterIIRKernel<SIZE, PASS>::processSample(
+                            m_coef, m_buf2, static_cast<double>(pIn[i + 1])));
+        }
+    }
+
+  private:
+    double m_coef[SIZE + 1];
+    double m_buf1[SIZE] = {};
+    double m_buf2[SIZE] = {};
+};
+
+class EngineFilterIIRTest : public testing::Test {
+  protected:
+    template<typename Filter, typename Reference>
+    void assertSameOutput(Filter* pFilter, Reference* pReference) {
+        pFilter->assumeSettled();
+        const auto input = makeSignal(kBufferSize);
+        std::vector<CSAMPLE> output(kBufferSize);
+        std::vector<CSAMPLE> expectedOutput(kBufferSize);
+        // Multiple buffers to verify that the state is kept
+        for (int buffer = 0; buffer < 4; ++buffer) {
+            pFilter->process(input.data(), output.data(), kBufferSize);
+            pReference->process(input.data(), expectedOutput.data(), kBufferSize);
+            for (int i = 0; i < kBufferSize; ++i) {
+                ASSERT_NEAR(expectedOutput[i], output[i], 1e-6) << buffer << ":" << i;
+            }
+        }
+    }
+};
+
+TEST_F(EngineFilterIIRTest, bessel4LowMatchesScalar) {
+    EngineFilterBessel4Low filter(kSampleRate, kCornerFreq);
+    ScalarFilter<4, IIR_LP> reference("LpBe4", kCornerFreq);
+    assertSameOutput(&filter, &reference);
+}
+
+TEST_F(EngineFilterIIRTest, bessel8HighMatchesScalar) {
+    EngineFilterBessel8High filter(kSampleRate, kCornerFreq);
+    ScalarFilter<8, IIR_HP> reference("HpBe8", kCornerFreq);
+    assertSameOutput(&filter, &reference);
+}
+
+TEST_F(EngineFilterIIRTest, butterworth8LowMatchesScalar) {
+    EngineFilterButterworth8Low filter(kSampleRate, kCornerFreq);
+    ScalarFilter<8, IIR_LP> reference("LpBu8", kCornerFreq);
+    assertSameOutput(&filter, &reference);
+}
+
+TEST_F(EngineFilterIIRTest, crossfadeAfterChangingCoefficients) {
+    EngineFilterBessel4Low filter(kSampleRate, kCornerFreq);
+    EngineFilterBessel4Low unchangedFilter(kSampleRate, kCornerFreq);
+    filter.assumeSettled();
+    unchangedFilter.assumeSettled();
+    const auto input = makeSignal(kBufferSize);
+    std::vector<CSAMPLE> output(kBufferSize);
+    std::vector<CSAMPLE> unchangedOutput(kBufferSize);
+    filter.process(input.data(), output.data(), kBufferSize);
+    unchangedFilter.process(input.data(), unchangedOutput.data(), kBufferSize);
+
+    filter.setFrequencyCorners(kSampleRate, kCornerFreq * 2);
+    filter.process(input.data(), output.data(), kBufferSize);
+    unchangedFilter.process(input.data(), unchangedOutput.data(), kBufferSize);
+    // The first half of the buffer is taken from the old filter before
+    // crossfading to the new one
+    for (int i = 0; i < kBufferSize / 2; ++i) {
+        ASSERT_FLOAT_EQ(unchangedOutput[i], output[i]) << i;
+    }
+    EXPECT_NE(unchangedOutput[kBufferSize - 1], output[kBufferSize - 1]);
+}
+
+template<typename Filter>
+static void BM_EngineFilterIIRProcess(benchmark::State& state) {
+    Filter filter(kSampleRate, kCornerFreq);
+    filter.assumeSettled();
+    const auto input = makeSignal(kBufferSize);
+    std::vector<CSAMPLE> output(kBufferSize);
+    for (auto _ : state) {
+        filter.process(input.data(), output.data(), kBufferSize);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * kBufferSize);
+}
+BENCHMARK_TEMPLATE(BM_EngineFilterIIRProcess, EngineFilterBessel4Low);
+BENCHMARK_TEMPLATE(BM_EngineFilterIIRProcess, EngineFilterBessel8Low);
+BENCHMARK_TEMPLATE(BM_EngineFilterIIRProcess, EngineFilterButterworth8Low);
+
+template<unsigned int SIZE, enum IIRPass PASS>
+void benchmarkScalarFilter(benchmark::State& state, const char* spec) {
+    ScalarFilter<SIZE, PASS> filter(spec, kCornerFreq);
+    const auto input = makeSignal(kBufferSize);
+    std::vector<CSAMPLE> output(kBufferSize);
+    for (auto _ : state) {
+        filter.process(input.data(), output.data(), kBufferSize);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * kBufferSize);
+}
+
+static void BM_EngineFilterIIRProcessScalarBessel4Low(benchmark::State& state) {
+    benchmarkScalarFilter<4, IIR_LP>(state, "LpBe4");
+}
+BENCHMARK(BM_EngineFilterIIRProcessScalarBessel4Low);
+
+static void BM_EngineFilterIIRProcessScalarBessel8Low(benchmark::State& state) {
+    benchmarkScalarFilter<8, IIR_LP>(state, "LpBe8");
+}
+BENCHMARK(BM_EngineFilterIIRProcessScalarBessel8Low);
+
+static void BM_EngineFilterIIRProcessScalarButterworth8Low(benchmark::State& state) {
+    benchmarkScalarFilter<8, IIR_LP>(state, "LpBu8");
+}
+BENCHMARK(BM_EngineFilterIIRProcessScalarButterworth8Low);
+
+// The cost of the equalizer of a single deck with all bands enabled
+template<typename GroupState>
+static void BM_EngineFilterIIRLVMixEQ(benchmark::State& state) {
+    const mixxx::EngineParameters engineParameters(
+            mixxx::audio::SampleRate(kSampleRate), kBufferSize / 2);
+    GroupState groupState(engineParameters);
+    const auto input = makeSignal(kBufferSize);
+    std::vector<CSAMPLE> output(kBufferSize);
+    for (auto _ : state) {
+        groupState.processChannel(input.data(),
+                output.data(),
+                kBufferSize,
+                engineParameters.sampleRate(),
+                0.5,
+                1.5,
+                0.8,
+                LVMixEQEffectGroupStateConstants::kStartupLoFreq,
+                LVMixEQEffectGroupStateConstants::kStartupHiFreq);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * kBufferSize);
+}
+BENCHMARK_TEMPLATE(BM_EngineFilterIIRLVMixEQ, Bessel4LVMixEQEffectGroupState);
+BENCHMARK_TEMPLATE(BM_EngineFilterIIRLVMixEQ, Bessel8LVMixEQEffectGroupState);
+
+} // namespace
@@ -0,0 +1,62 @@
+#include "engine/enginerealtimeworkerpool.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <vector>
+
+namespace {
+
+class CountingJob : public EngineRealtimeWorkerPool::Job {
+  public:
+    explicit CountingJob(int numTasks)
+            : m_counts(numTasks) {
+    }
+
+    void processTask(int taskIndex) override {
+        m_counts[taskIndex].fetch_add(1);
+    }
+
+    int count(int taskIndex) const {
+        return m_counts[taskIndex].load();
+    }
+
+  private:
+    std::vector<std::atomic<int>> m_counts;
+};
+
+TEST(EngineRealtimeWorkerPoolTest, ProcessesEveryTaskOnce) {
+    EngineRealtimeWorkerPool pool(3);
+    constexpr int kNumTasks = 20;
+    constexpr int kNumRuns = 1000;
+    CountingJob job(kNumTasks);
+    for (int run = 0; run < kNumRuns; ++run) {
+        pool.run(&job, kNumTasks);
+        // All tasks of a job must be done when run() returns
+        for (int i = 0; i < kNumTasks; ++i) {
+            ASSERT_EQ(run + 1, job.count(i));
+        }
+    }
+}
+
+TEST(EngineRealtimeWorkerPoolTest, VaryingNumberOfTasks) {
+    EngineRealtimeWorkerPool pool(2);
+    CountingJob job(8);
+    for (int numTasks = 0; numTasks <= 8; ++numTasks) {
+        pool.run(&job, numTasks);
+    }
+    for (int i = 0; i < 8; ++i) {
+        EXPECT_EQ(8 - i, job.count(i));
+    }
+}
+
+TEST(EngineRealtimeWorkerPoolTest, NoWorkers) {
+    EngineRealtimeWorkerPool pool(0);
+    CountingJob job(4);
+    pool.run(&job, 4);
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_EQ(1, job.count(i));
+    }
+}
+
+} // namespace
@@ -3021,3 +3021,48 @@ TEST_F(EngineSyncTest, ImplicitLeaderToInternalClock) {
     ASSERT_FALSE(isSoftLeader(m_sGroup2));
     ASSERT_FALSE(isSoftLeader(m_sInternalClockGroup));
 }
+
+TEST_F(EngineSyncTest, EnableSyncOnSeveralDecksWithParallelProcessing) {
+    // Synced decks must not access EngineSync concurrently. They are
+    // processed on the engine thread while the other decks are processed
+    // on the worker pool.
+    ControlObject::set(ConfigKey(m_sMasterGroup, "parallel_processing"), 1.0);
+
+    m_pMixerDeck1->loadFakeTrack(false, 120.0);
+    m_pMixerDeck2->loadFakeTrack(false, 124.0);
+    m_pMixerDeck3->loadFakeTrack(false, 128.0);
+    ProcessBuffer();
+
+    ControlObject::set(ConfigKey(m_sGroup1, "play"), 1.0);
+    ControlObject::set(ConfigKey(m_sGroup2, "play"), 1.0);
+    ControlObject::set(ConfigKey(m_sGroup3, "play"), 1.0);
+    ProcessBuffer();
+
+    // Enable sync on all decks within the same callback
+    ControlObject::set(ConfigKey(m_sGroup1, "sync_enabled"), 1.0);
+    ControlObject::set(ConfigKey(m_sGroup2, "sync_enabled"), 1.0);
+    ControlObject::set(ConfigKey(m_sGroup3, "sync_enabled"), 1.0);
+    ProcessBuffer();
+    ProcessBuffer();
+
+    // Exactly one deck leads and all decks play at its tempo
+    EXPECT_EQ(1,
+            static_cast<int>(isSoftLeader(m_sGroup1)) +
+                    static_cast<int>(isSoftLeader(m_sGroup2)) +
+                    static_cast<int>(isSoftLeader(m_sGroup3)));
+    const double syncedBpm = ControlObject::get(ConfigKey(m_sGroup1, "bpm"));
+    EXPECT_DOUBLE_EQ(syncedBpm, ControlObject::get(ConfigKey(m_sGroup2, "bpm")));
+    EXPECT_DOUBLE_EQ(syncedBpm, ControlObject::get(ConfigKey(m_sGroup3, "bpm")));
+
+    // A deck without sync is processed concurrently and keeps its tempo
+    ControlObject::set(ConfigKey(m_sGroup3, "sync_enabled"), 0.0);
+    ProcessBuffer();
+    ControlObject::set(ConfigKey(m_sGroup3, "rate"), getRateSliderValue(1.25));
+    ProcessBuffer();
+    ProcessBuffer();
+
+    assertSyncOff(m_sGroup3);
+    EXPECT_DOUBLE_EQ(ControlObject::get(ConfigKey(m_sGroup1, "bpm")),
+            ControlObject::get(ConfigKey(m_sGroup2, "bpm")));
+    EXPECT_DOUBLE_EQ(160.0, ControlObject::get(ConfigKey(m_sGroup3, "bpm")));
+}
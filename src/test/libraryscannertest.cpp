@@ -1,9 +1,24 @@
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
 
+#include <QCoreApplication>
+#include <QDir>
+#include <QFile>
+#include <QTemporaryDir>
+#include <QThread>
+#include <atomic>
+#include <thread>
+
 #include "test/librarytest.h"
 
+#include "library/dao/libraryhashdao.h"
 #include "library/scanner/libraryscanner.h"
+#include "library/scanner/librarywatcher.h"
+#include "library/scanner/recursivescandirectorytask.h"
+#include "library/scanner/scannerglobal.h"
+#include "library/scanner/scannerutil.h"
+#include "sources/soundsourceproxy.h"
+#include "track/track.h"
 
 class LibraryScannerTest : public LibraryTest {
   protected:
@@ -52,3 +67,195 @@ TEST_F(LibraryScannerTest, ScannerRoundtrip) {
     m_libraryScanner.changeScannerState(LibraryScanner::IDLE);
     EXPECT_EQ(m_libraryScanner.m_state, LibraryScanner::IDLE);
 }
+
+TEST_F(LibraryScannerTest, ImportMetadataOfUncachedFile) {
+    const QString filePath =
+            getTestDir().filePath(QStringLiteral("id3-test-data/cover-test-png.mp3"));
+
+    const auto importedMetadata = SoundSourceProxy::importMetadataOfUncachedFile(
+            mixxx::FileAccess(mixxx::FileInfo(filePath)), false);
+    ASSERT_TRUE(importedMetadata);
+    EXPECT_EQ(mixxx::MetadataSource::ImportResult::Succeeded,
+            importedMetadata->importResult);
+    ASSERT_TRUE(importedMetadata->embeddedCoverInfo);
+    EXPECT_EQ(CoverInfo::METADATA, importedMetadata->embeddedCoverInfo->type);
+
+    // Updating a new track from the imported metadata must have the
+    // same effect as parsing the file again
+    auto pExpectedTrack = Track::newTemporary(filePath);
+    EXPECT_EQ(SoundSourceProxy::UpdateTrackFromSourceResult::MetadataImportedAndUpdated,
+            SoundSourceProxy(pExpectedTrack)
+                    .updateTrackFromSource(
+                            SoundSourceProxy::UpdateTrackFromSourceMode::Once,
+                            SyncTrackMetadataParams{}));
+    auto pTrack = Track::newTemporary(filePath);
+    EXPECT_EQ(SoundSourceProxy::UpdateTrackFromSourceResult::MetadataImportedAndUpdated,
+            SoundSourceProxy(pTrack).updateTrackFromSource(
+                    SoundSourceProxy::UpdateTrackFromSourceMode::Once,
+                    SyncTrackMetadataParams{},
+                    &*importedMetadata));
+    EXPECT_EQ(pExpectedTrack->getMetadata(), pTrack->getMetadata());
+    EXPECT_EQ(pExpectedTrack->getCoverInfo(), pTrack->getCoverInfo());
+    EXPECT_TRUE(pTrack->checkSourceSynchronized());
+
+    // Files of cached tracks might be modified concurrently
+    const auto pCachedTrack = getOrAddTrackByLocation(filePath);
+    ASSERT_TRUE(pCachedTrack);
+    EXPECT_FALSE(SoundSourceProxy::importMetadataOfUncachedFile(
+            mixxx::FileAccess(mixxx::FileInfo(filePath)), false));
+}
+
+TEST_F(LibraryScannerTest, ImportedMetadataBackPressure) {
+    ScannerGlobal scannerGlobal(QSet<QString>{},
+            {},
+            QRegularExpression(),
+            QRegularExpression(),
+            QStringList{},
+            false);
+    constexpr int kMaxPending = ScannerGlobal::kMaxPendingImportedMetadata;
+    constexpr int kNumTracks = kMaxPending + 10;
+    std::atomic<int> numAdded = 0;
+    std::thread worker([&scannerGlobal, &numAdded] {
+        for (int i = 0; i < kNumTracks; ++i) {
+            scannerGlobal.addImportedMetadata(
+                    QString::number(i), SoundSourceProxy::ImportedMetadata{});
+            ++numAdded;
+        }
+    });
+
+    // The worker is blocked until the scanner thread takes metadata
+    while (numAdded.load() < kMaxPending) {
+        QThread::msleep(1);
+    }
+    QThread::msleep(50);
+    EXPECT_EQ(kMaxPending, numAdded.load());
+    EXPECT_EQ(kMaxPending, scannerGlobal.numPendingImportedMetadata());
+
+    for (int i = 0; i < kNumTracks - kMaxPending; ++i) {
+        EXPECT_TRUE(scannerGlobal.takeImportedMetadata(QString::number(i)));
+    }
+    worker.join();
+    EXPECT_EQ(kNumTracks, numAdded.load());
+    EXPECT_EQ(kMaxPending, scannerGlobal.numPendingImportedMetadata());
+
+    // Metadata is dropped instead of blocking after canceling the scan
+    scannerGlobal.cancel();
+    scannerGlobal.addImportedMetadata(
+            QStringLiteral("canceled"), SoundSourceProxy::ImportedMetadata{});
+    EXPECT_EQ(kMaxPending, scannerGlobal.numPendingImportedMetadata());
+    EXPECT_FALSE(scannerGlobal.takeImportedMetadata(QStringLiteral("canceled")));
+}
+
+TEST_F(LibraryScannerTest, ScannerFileStat) {
+    QTemporaryDir tempDir;
+    ASSERT_TRUE(tempDir.isValid());
+    const QString filePath = tempDir.filePath(QStringLiteral("track.mp3"));
+
+    EXPECT_FALSE(ScannerFileStat::fromPath(filePath).isValid());
+
+    QFile file(filePath);
+    ASSERT_TRUE(file.open(QIODevice::WriteOnly));
+    file.write("abc");
+    file.close();
+    const auto fileStat = ScannerFileStat::fromPath(filePath);
+    ASSERT_TRUE(fileStat.isValid());
+    EXPECT_EQ(3, fileStat.sizeInBytes);
+    EXPECT_EQ(fileStat, ScannerFileStat::fromPath(filePath));
+
+    ASSERT_TRUE(file.open(QIODevice::Append));
+    file.write("def");
+    file.close();
+    EXPECT_NE(fileStat, ScannerFileStat::fromPath(filePath));
+}
+
+TEST_F(LibraryScannerTest, IncrementalRescanSkipsUnchangedDirectory) {
+    QTemporaryDir tempDir;
+    ASSERT_TRUE(tempDir.isValid());
+    const QString dirPath = mixxx::FileInfo(tempDir.path()).location();
+    // Would be imported if the directory was hashed again
+    QFile file(dirPath + QStringLiteral("/track.mp3"));
+    ASSERT_TRUE(file.open(QIODevice::WriteOnly));
+    file.close();
+
+    // The stats of the previous scan are read back from the database
+    LibraryHashDAO libraryHashDao;
+    libraryHashDao.initialize(dbConnection());
+    libraryHashDao.saveDirectoryHash(dirPath,
+            mixxx::cacheKeyFromMessageDigest(QByteArrayLiteral("hash")),
+            ScannerFileStat::fromDirectoryPath(dirPath));
+
+    const auto pScannerGlobal = ScannerGlobalPointer::create(QSet<QString>{},
+            libraryHashDao.getDirectoryHashes(),
+            QRegularExpression(QStringLiteral("\\.mp3$")),
+            QRegularExpression(QStringLiteral("\\.jpg$")),
+            QStringList{},
+            false);
+    pScannerGlobal->setIncremental(libraryHashDao.getDirectoryStats(), {}, false);
+
+    // Like LibraryScanner::queueTask()
+    pScannerGlobal->getTaskWatcher().watchTask();
+    RecursiveScanDirectoryTask task(&m_libraryScanner,
+            pScannerGlobal,
+            mixxx::FileAccess(mixxx::FileInfo(dirPath)),
+            false);
+    int unchangedDirectories = 0;
+    int hashedDirectories = 0;
+    QObject::connect(&task,
+            &ScannerTask::directoryUnchanged,
+            [&unchangedDirectories](const QString&, const ScannerFileStat&) {
+                ++unchangedDirectories;
+            });
+    QObject::connect(&task,
+            &ScannerTask::directoryHashedAndScanned,
+            [&hashedDirectories]() {
+                ++hashedDirectories;
+            });
+    task.run();
+
+    EXPECT_EQ(1, unchangedDirectories);
+    EXPECT_EQ(0, hashedDirectories);
+    // The files of an unchanged directory are neither listed nor hashed
+    EXPECT_EQ(0, pScannerGlobal->numScannedFiles());
+}
+
+TEST_F(LibraryScannerTest, LibraryWatcher) {
+    if (!LibraryWatcher::isSupported()) {
+        GTEST_SKIP() << "Watching directories is not supported";
+    }
+    QTemporaryDir tempDir;
+    ASSERT_TRUE(tempDir.isValid());
+    const QString rootPath = tempDir.path();
+    const QString subdirPath = rootPath + QStringLiteral("/subdir");
+    ASSERT_TRUE(QDir(rootPath).mkdir(QStringLiteral("subdir")));
+
+    LibraryWatcher watcher;
+    EXPECT_FALSE(watcher.isValid());
+    watcher.watchDirectories({rootPath, subdirPath});
+    ASSERT_TRUE(watcher.isValid());
+    EXPECT_EQ(2, watcher.watchCount());
+    EXPECT_TRUE(watcher.takeChangedDirectories().isEmpty());
+
+    QFile file(subdirPath + QStringLiteral("/track.mp3"));
+    ASSERT_TRUE(file.open(QIODevice::WriteOnly));
+    file.close();
+    QSet<QString> changedDirectories;
+    for (int i = 0; i < 100 && changedDirectories.isEmpty(); ++i) {
+        QCoreApplication::processEvents(QEventLoop::AllEvents, 10);
+        changedDirectories = watcher.takeChangedDirectories();
+    }
+    // Only the modified directory is reported
+    EXPECT_EQ(QSet<QString>{subdirPath}, changedDirectories);
+
+    ASSERT_TRUE(QDir(subdirPath).removeRecursively());
+    changedDirectories.clear();
+    for (int i = 0; i < 100 && !changedDirectories.contains(rootPath); ++i) {
+        QCoreApplication::processEvents(QEventLoop::AllEvents, 10);
+        changedDirectories.unite(watcher.takeChangedDirectories());
+    }
+    EXPECT_TRUE(changedDirectories.contains(rootPath));
+    EXPECT_TRUE(changedDirectories.contains(subdirPath));
+
+    watcher.invalidate();
+    EXPECT_FALSE(watcher.isValid());
+    EXPECT_EQ(0, watcher.watchCount());
+}
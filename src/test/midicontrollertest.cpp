@@ -1,6 +1,8 @@
+#include <benchmark/benchmark.h>
 #include <gmock/gmock.h>
 
 #include <QScopedPointer>
+#include <QTemporaryFile>
 
 #include "control/controlpotmeter.h"
 #include "control/controlpushbutton.h"
@@ -8,6 +10,7 @@
 #include "controllers/midi/midicontroller.h"
 #include "controllers/midi/midimessage.h"
 #include "controllers/midi/midiutils.h"
+#include "controllers/scripting/legacy/controllerscriptenginelegacy.h"
 #include "test/mixxxtest.h"
 #include "util/time.h"
 
@@ -24,7 +27,6 @@ class MockMidiController : public MidiController {
                                     unsigned char byte1,
                                     unsigned char byte2));
     MOCK_METHOD1(sendBytes, void(const QByteArray& data));
-    MOCK_CONST_METHOD0(isPolling, bool());
 };
 
 class MidiControllerTest : public MixxxTest {
@@ -596,3 +598,306 @@ TEST_F(MidiControllerTest, ReceiveMessage_PotMeterCO_14BitPitchBend) {
     receivedShortMessage(MidiOpCode::PitchBendChange, channel, 0x01, 0x40);
     EXPECT_LT(kMiddleValue, potmeter.get());
 }
+
+TEST_F(MidiControllerTest, ReceiveMessage_ScaledTransform) {
+    ConfigKey key("[Channel1]", "rate");
+    ControlPotmeter potmeter(key, -1.0, 1.0);
+
+    unsigned char channel = 0x01;
+    unsigned char control = 0x10;
+
+    MidiInputMapping mapping(MidiKey(MidiUtils::statusFromOpCodeAndChannel(
+                                             MidiOpCode::ControlChange, channel),
+                                     control),
+            MidiOptions(),
+            key);
+    mapping.transform.mode = MidiInputTransform::Mode::Scaled;
+    mapping.transform.minimum = 0.5;
+    mapping.transform.maximum = -0.5;
+    addMapping(mapping);
+    m_pController->setMapping(m_pMapping->clone());
+
+    // The value is set directly and not converted as a MIDI parameter
+    receivedShortMessage(MidiOpCode::ControlChange, channel, control, 0x00);
+    EXPECT_DOUBLE_EQ(0.5, potmeter.get());
+    receivedShortMessage(MidiOpCode::ControlChange, channel, control, 0x7F);
+    EXPECT_DOUBLE_EQ(-0.5, potmeter.get());
+    receivedShortMessage(MidiOpCode::ControlChange, channel, control, 0x40);
+    EXPECT_DOUBLE_EQ(0.5 - 64.0 / 127.0, potmeter.get());
+}
+
+TEST_F(MidiControllerTest, ReceiveMessage_ScaledTransform_ButtonOption) {
+    ConfigKey key("[Channel1]", "hotcue_1_activate");
+    ControlPushButton cpb(key);
+
+    unsigned char channel = 0x01;
+    unsigned char control = 0x10;
+
+    MidiInputMapping mapping(MidiKey(MidiUtils::statusFromOpCodeAndChannel(
+                                             MidiOpCode::NoteOn, channel),
+                                     control),
+            MidiOptions(MidiOption::Button),
+            key);
+    mapping.transform.mode = MidiInputTransform::Mode::Scaled;
+    mapping.transform.minimum = 0.5;
+    mapping.transform.maximum = 0.25;
+    addMapping(mapping);
+    m_pController->setMapping(m_pMapping->clone());
+
+    // The button option takes precedence over the transform
+    receivedShortMessage(MidiOpCode::NoteOn, channel, control, 0x7F);
+    EXPECT_DOUBLE_EQ(1.0, cpb.get());
+    receivedShortMessage(MidiOpCode::NoteOn, channel, control, 0x00);
+    EXPECT_DOUBLE_EQ(0.0, cpb.get());
+}
+
+TEST_F(MidiControllerTest, ReceiveMessage_ScaledTransform_InvertOption) {
+    ConfigKey key("[Channel1]", "rate");
+    ControlPotmeter potmeter(key, -1.0, 1.0);
+
+    unsigned char channel = 0x01;
+    unsigned char control = 0x10;
+
+    MidiInputMapping mapping(MidiKey(MidiUtils::statusFromOpCodeAndChannel(
+                                             MidiOpCode::ControlChange, channel),
+                                     control),
+            MidiOptions(MidiOption::Invert),
+            key);
+    mapping.transform.mode = MidiInputTransform::Mode::Scaled;
+    mapping.transform.minimum = 0.5;
+    mapping.transform.maximum = -0.5;
+    addMapping(mapping);
+    m_pController->setMapping(m_pMapping->clone());
+
+    // Inverted and converted as a MIDI parameter like without a transform
+    receivedShortMessage(MidiOpCode::ControlChange, channel, control, 0x00);
+    EXPECT_DOUBLE_EQ(1.0, potmeter.get());
+    receivedShortMessage(MidiOpCode::ControlChange, channel, control, 0x7F);
+    EXPECT_DOUBLE_EQ(-1.0, potmeter.get());
+}
+
+TEST_F(MidiControllerTest, ReceiveMessage_ScaledTransform_SoftTakeover) {
+    ConfigKey key("[Channel1]", "pregain");
+    ControlPotmeter potmeter(key, 0.0, 4.0);
+    potmeter.set(2.0);
+
+    unsigned char channel = 0x01;
+    unsigned char control = 0x10;
+
+    MidiInputMapping mapping(MidiKey(MidiUtils::statusFromOpCodeAndChannel(
+                                             MidiOpCode::ControlChange, channel),
+                                     control),
+            MidiOptions(MidiOption::SoftTakeover),
+            key);
+    mapping.transform.mode = MidiInputTransform::Mode::Scaled;
+    mapping.transform.minimum = 0.0;
+    mapping.transform.maximum = 4.0;
+    addMapping(mapping);
+    m_pController->setMapping(m_pMapping->clone());
+
+    mixxx::Time::setTestMode(true);
+    mixxx::Time::setTestElapsedTime(mixxx::Duration::fromMillis(10));
+
+    // The first value is always ignored
+    receivedShortMessage(MidiOpCode::ControlChange, channel, control, 0x7F);
+    EXPECT_DOUBLE_EQ(2.0, potmeter.get());
+
+    // Close to the current value
+    mixxx::Time::setTestElapsedTime(mixxx::Duration::fromSeconds(10));
+    receivedShortMessage(MidiOpCode::ControlChange, channel, control, 0x41);
+    EXPECT_DOUBLE_EQ(4.0 * 65 / 127, potmeter.get());
+
+    // Far away from the current value
+    potmeter.set(0.0);
+    mixxx::Time::setTestElapsedTime(mixxx::Duration::fromSeconds(20));
+    receivedShortMessage(MidiOpCode::ControlChange, channel, control, 0x7F);
+    EXPECT_DOUBLE_EQ(0.0, potmeter.get());
+
+    mixxx::Time::setTestMode(false);
+}
+
+TEST_F(MidiControllerTest, ReceiveMessage_RelativeTransform) {
+    ConfigKey key("[Channel1]", "volume");
+    ControlPotmeter potmeter(key, 0.0, 1.0);
+    potmeter.set(0.5);
+
+    unsigned char channel = 0x01;
+    unsigned char control = 0x10;
+
+    // Two's complement encoding
+    MidiInputMapping mapping(MidiKey(MidiUtils::statusFromOpCodeAndChannel(
+                                             MidiOpCode::ControlChange, channel),
+                                     control),
+            MidiOptions(),
+            key);
+    mapping.transform.mode = MidiInputTransform::Mode::Relative;
+    mapping.transform.center = 0.0;
+    mapping.transform.factor = 0.125;
+    addMapping(mapping);
+    m_pController->setMapping(m_pMapping->clone());
+
+    receivedShortMessage(MidiOpCode::ControlChange, channel, control, 0x01);
+    EXPECT_DOUBLE_EQ(0.625, potmeter.get());
+    receivedShortMessage(MidiOpCode::ControlChange, channel, control, 0x7E);
+    EXPECT_DOUBLE_EQ(0.375, potmeter.get());
+
+    // Limited to [minimum, maximum]
+    receivedShortMessage(MidiOpCode::ControlChange, channel, control, 0x40);
+    EXPECT_DOUBLE_EQ(0.0, potmeter.get());
+    receivedShortMessage(MidiOpCode::ControlChange, channel, control, 0x3F);
+    EXPECT_DOUBLE_EQ(1.0, potmeter.get());
+}
+
+TEST_F(MidiControllerTest, ReceiveMessage_DeltaTransform) {
+    ConfigKey key("[Channel1]", "jog");
+    ControlObject jog(key);
+
+    unsigned char channel = 0x01;
+    unsigned char control = 0x10;
+
+    MidiInputMapping mapping(MidiKey(MidiUtils::statusFromOpCodeAndChannel(
+                                             MidiOpCode::ControlChange, channel),
+                                     control),
+            MidiOptions(),
+            key);
+    mapping.transform.mode = MidiInputTransform::Mode::Delta;
+    mapping.transform.center = 64.0;
+    mapping.transform.factor = 0.25;
+    addMapping(mapping);
+    m_pController->setMapping(m_pMapping->clone());
+
+    // The previous value does not matter
+    jog.set(10.0);
+    receivedShortMessage(MidiOpCode::ControlChange, channel, control, 0x42);
+    EXPECT_DOUBLE_EQ(0.5, jog.get());
+    receivedShortMessage(MidiOpCode::ControlChange, channel, control, 0x3C);
+    EXPECT_DOUBLE_EQ(-1.0, jog.get());
+}
+
+TEST_F(MidiControllerTest, ReceiveMessage_ScaledTransform_14BitCC) {
+    ConfigKey key("[Channel1]", "rate");
+    ControlPotmeter potmeter(key, -1.0, 1.0);
+
+    unsigned char channel = 0x01;
+    unsigned char lsb_control = 0x10;
+    unsigned char msb_control = 0x11;
+
+    MidiInputMapping lsb(MidiKey(MidiUtils::statusFromOpCodeAndChannel(
+                                         MidiOpCode::ControlChange, channel),
+                                 lsb_control),
+            MidiOptions(MidiOption::FourteenBitLSB),
+            key);
+    lsb.transform.mode = MidiInputTransform::Mode::Scaled;
+    lsb.transform.minimum = -1.0;
+    lsb.transform.maximum = 1.0;
+    MidiInputMapping msb = lsb;
+    msb.key = MidiKey(MidiUtils::statusFromOpCodeAndChannel(
+                              MidiOpCode::ControlChange, channel),
+            msb_control);
+    msb.options = MidiOptions(MidiOption::FourteenBitMSB);
+    addMapping(lsb);
+    addMapping(msb);
+    m_pController->setMapping(m_pMapping->clone());
+
+    receivedShortMessage(MidiOpCode::ControlChange, channel, msb_control, 0x7F);
+    receivedShortMessage(MidiOpCode::ControlChange, channel, lsb_control, 0x7F);
+    EXPECT_DOUBLE_EQ(1.0, potmeter.get());
+
+    receivedShortMessage(MidiOpCode::ControlChange, channel, msb_control, 0x00);
+    receivedShortMessage(MidiOpCode::ControlChange, channel, lsb_control, 0x00);
+    EXPECT_DOUBLE_EQ(-1.0, potmeter.get());
+
+    // The LSB adds resolution
+    receivedShortMessage(MidiOpCode::ControlChange, channel, msb_control, 0x00);
+    receivedShortMessage(MidiOpCode::ControlChange, channel, lsb_control, 0x01);
+    EXPECT_LT(-1.0, potmeter.get());
+    EXPECT_GT(-1.0 + 2.0 / 127.0, potmeter.get());
+}
+
+namespace {
+
+const QString kBenchmarkScript = QStringLiteral(
+        "var MidiBenchmark = {\n"
+        "    init: function() {},\n"
+        "    shutdown: function() {},\n"
+        "    jog: function(channel, control, value, status, group) {\n"
+        "        engine.setValue(group, 'jog', (value - 64) / 4);\n"
+        "    },\n"
+        "};\n");
+
+class BenchmarkMidiController : public MockMidiController {
+  public:
+    ~BenchmarkMidiController() override {
+        if (getScriptEngine()) {
+            stopEngine();
+        }
+    }
+
+    bool startScriptEngine(const QFileInfo& scriptFile) {
+        startEngine();
+        LegacyControllerMapping::ScriptFileInfo script;
+        script.name = scriptFile.fileName();
+        script.functionPrefix = QStringLiteral("MidiBenchmark");
+        script.file = scriptFile;
+        getScriptEngine()->setScriptFiles({script});
+        return getScriptEngine()->initialize();
+    }
+
+    using MidiController::receivedShortMessage;
+};
+
+// Receives the messages of a jog wheel that is mapped either natively
+// or by a script function
+void benchmarkJogWheel(benchmark::State& state, bool native) {
+    const ConfigKey key("[Channel1]", "jog");
+    ControlObject jog(key);
+
+    const unsigned char status = MidiUtils::statusFromOpCodeAndChannel(
+            MidiOpCode::ControlChange, 0x00);
+    const unsigned char control = 0x21;
+    auto pMapping = std::make_shared<LegacyMidiControllerMapping>();
+    MidiInputMapping mapping(MidiKey(status, control), MidiOptions(), key);
+    if (native) {
+        mapping.transform.mode = MidiInputTransform::Mode::Delta;
+        mapping.transform.center = 64.0;
+        mapping.transform.factor = 0.25;
+    } else {
+        mapping.options = MidiOptions(MidiOption::Script);
+        mapping.control = ConfigKey(key.group, QStringLiteral("MidiBenchmark.jog"));
+    }
+    pMapping->addInputMapping(mapping.key.key, mapping);
+
+    QTemporaryFile scriptFile;
+    scriptFile.open();
+    scriptFile.write(kBenchmarkScript.toUtf8());
+    scriptFile.close();
+
+    testing::NiceMock<BenchmarkMidiController> controller;
+    controller.setMapping(pMapping);
+    if (!controller.startScriptEngine(QFileInfo(scriptFile.fileName()))) {
+        state.SkipWithError("Failed to initialize the script engine");
+        return;
+    }
+
+    const mixxx::Duration timestamp = mixxx::Time::elapsed();
+    unsigned char value = 0x41;
+    for (auto _ : state) {
+        controller.receivedShortMessage(status, control, value, timestamp);
+        // Alternate between forward and backward
+        value = value == 0x41 ? 0x3F : 0x41;
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.SetLabel(QString::number(jog.get()).toStdString());
+}
+
+} // anonymous namespace
+
+static void BM_ReceiveJogWheel_Native(benchmark::State& state) {
+    benchmarkJogWheel(state, true);
+}
+BENCHMARK(BM_ReceiveJogWheel_Native);
+
+static void BM_ReceiveJogWheel_Script(benchmark::State& state) {
+    benchmarkJogWheel(state, false);
+}
+BENCHMARK(BM_ReceiveJogWheel_Script);
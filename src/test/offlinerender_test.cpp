@@ -0,0 +1,187 @@
+// Headless rendering of the whole engine graph.
+//
+// Adds a fourth deck and samplers to the decks of BaseSignalPathTest,
+// loads a real file through CachingReader into every player, engages the
+// default EQ and QuickEffect chains and drives EngineMaster::process()
+// without a sound device. The benchmark reports callbacks per second, the
+// worst case callback time and a breakdown of the time spent in the
+// processing stages.
+//
+// Run the benchmark with:
+//   mixxx-test --benchmark --benchmark_filter=BM_EngineMasterOfflineRender
+// The track can be overridden with the environment variable
+// MIXXX_BENCHMARK_TRACK.
+
+#include <benchmark/benchmark.h>
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <vector>
+
+#include "engine/engine.h"
+#include "mixer/playermanager.h"
+#include "test/signalpathtest.h"
+#include "util/duration.h"
+
+namespace {
+
+constexpr int kNumSamplers = 16;
+
+const QString kGroup4 = QStringLiteral("[Channel4]");
+
+class OfflineRenderTest : public BaseSignalPathTest {
+  public:
+    explicit OfflineRenderTest(bool parallelProcessing = false)
+            : BaseSignalPathTest(true) { // with sidechain
+        m_pMixerDeck4 = std::make_unique<Deck>(nullptr,
+                m_pConfig,
+                m_pEngineMaster,
+                m_pEffectsManager,
+                EngineChannel::CENTER,
+                m_pEngineMaster->registerChannelGroup(kGroup4));
+        addDeck(m_pMixerDeck4->getEngineDeck());
+        for (int i = 0; i < kNumSamplers; ++i) {
+            m_samplers.push_back(std::make_unique<Sampler>(nullptr,
+                    m_pConfig,
+                    m_pEngineMaster,
+                    m_pEffectsManager,
+                    EngineChannel::CENTER,
+                    m_pEngineMaster->registerChannelGroup(
+                            PlayerManager::groupForSampler(i))));
+        }
+
+        // Loads the default EQ and QuickEffect presets into the deck chains
+        for (const auto& group : decks()) {
+            m_pEffectsManager->addDeck(m_pEngineMaster->registerChannelGroup(group));
+        }
+        m_pEffectsManager->setup();
+        ControlObject::set(ConfigKey(m_sMasterGroup, "parallel_processing"),
+                parallelProcessing ? 1.0 : 0.0);
+
+        QString trackLocation = qEnvironmentVariable("MIXXX_BENCHMARK_TRACK");
+        if (trackLocation.isEmpty()) {
+            trackLocation = getTestDir().filePath(QStringLiteral("sine-30.wav"));
+        }
+        for (auto* pPlayer : players()) {
+            loadTrack(pPlayer, Track::newTemporary(trackLocation));
+        }
+
+        for (const auto& group : decks()) {
+            // Pitch shifting with keylock is the most expensive deck setup
+            ControlObject::set(ConfigKey(group, "keylock"), 1.0);
+            ControlObject::set(ConfigKey(group, "rate"), 0.1);
+            // Engage the default QuickEffect (filter)
+            ControlObject::set(ConfigKey(QStringLiteral("[QuickEffectRack1_") +
+                                               group + QChar(']'),
+                                       "super1"),
+                    0.3);
+        }
+        for (auto* pPlayer : players()) {
+            ControlObject::set(ConfigKey(pPlayer->getGroup(), "repeat"), 1.0);
+            ControlObject::set(ConfigKey(pPlayer->getGroup(), "play"), 1.0);
+        }
+
+        m_pEngineMaster->setStageTimingEnabled(true);
+    }
+
+    ~OfflineRenderTest() override {
+        m_samplers.clear();
+        m_pMixerDeck4.reset();
+    }
+
+    void process(int iBufferSize) {
+        m_pEngineMaster->process(iBufferSize);
+    }
+
+    const EngineMaster::StageTimes& stageTimes() const {
+        return m_pEngineMaster->getStageTimes();
+    }
+
+    mixxx::audio::SampleRate sampleRate() const {
+        return mixxx::audio::SampleRate::fromDouble(
+                ControlObject::get(ConfigKey(m_sMasterGroup, "samplerate")));
+    }
+
+  private:
+    std::vector<QString> decks() const {
+        return {m_sGroup1, m_sGroup2, m_sGroup3, kGroup4};
+    }
+
+    std::vector<BaseTrackPlayerImpl*> players() const {
+        std::vector<BaseTrackPlayerImpl*> players = {
+                m_pMixerDeck1, m_pMixerDeck2, m_pMixerDeck3, m_pMixerDeck4.get()};
+        for (const auto& pSampler : m_samplers) {
+            players.push_back(pSampler.get());
+        }
+        return players;
+    }
+
+    std::unique_ptr<Deck> m_pMixerDeck4;
+    std::vector<std::unique_ptr<Sampler>> m_samplers;
+};
+
+TEST_F(OfflineRenderTest, measureStageTimes) {
+    for (int i = 0; i < 10; ++i) {
+        process(kProcessBufferSize);
+        const EngineMaster::StageTimes& times = stageTimes();
+        EXPECT_GT(times.total, mixxx::Duration::empty());
+        EXPECT_GT(times.channels, mixxx::Duration::empty());
+        // The stages don't overlap
+        EXPECT_LE(times.channels + times.mixing + times.effects + times.sidechain,
+                times.total);
+    }
+}
+
+// Only used as a fixture for benchmarks
+class OfflineRenderBenchmark : public OfflineRenderTest {
+  public:
+    using OfflineRenderTest::OfflineRenderTest;
+
+  private:
+    void TestBody() override {
+    }
+};
+
+static void BM_EngineMasterOfflineRender(benchmark::State& state) {
+    const auto bufferFrames = static_cast<int>(state.range(0));
+    const bool parallelProcessing = state.range(1) != 0;
+    const int bufferSize = bufferFrames * mixxx::kEngineChannelCount;
+
+    OfflineRenderBenchmark engine(parallelProcessing);
+
+    EngineMaster::StageTimes sum;
+    mixxx::Duration worst;
+    for (auto _ : state) {
+        engine.process(bufferSize);
+        const EngineMaster::StageTimes& times = engine.stageTimes();
+        sum.channels += times.channels;
+        sum.mixing += times.mixing;
+        sum.effects += times.effects;
+        sum.sidechain += times.sidechain;
+        sum.total += times.total;
+        if (times.total > worst) {
+            worst = times.total;
+        }
+    }
+
+    const auto callbacks = static_cast<double>(state.iterations());
+    state.counters["callbacks/s"] = benchmark::Counter(callbacks, benchmark::Counter::kIsRate);
+    state.counters["worst_us"] = worst.toDoubleMicros();
+    state.counters["channels_us"] = sum.channels.toDoubleMicros() / callbacks;
+    state.counters["mixing_us"] = sum.mixing.toDoubleMicros() / callbacks;
+    state.counters["effects_us"] = sum.effects.toDoubleMicros() / callbacks;
+    state.counters["sidechain_us"] = sum.sidechain.toDoubleMicros() / callbacks;
+    // The time budget of the callbacks at the engine sample rate divided by
+    // the time it took
+    state.counters["realtime_factor"] = sum.total > mixxx::Duration::empty()
+            ? callbacks * bufferFrames / engine.sampleRate().toDouble() /
+                    sum.total.toDoubleSeconds()
+            : 0.0;
+}
+BENCHMARK(BM_EngineMasterOfflineRender)
+        ->ArgsProduct({benchmark::CreateRange(32, 4096, 2), {0, 1}})
+        ->ArgNames({"frames", "parallel"})
+        ->UseRealTime()
+        ->Unit(benchmark::kMicrosecond);
+
+} // namespace
@@ -0,0 +1,369 @@
+#include <benchmark/benchmark.h>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "util/sample.h"
+#include "util/samplekernels.h"
+
+// Compares every SampleKernels variant that is supported by the CPU against
+// the portable one, which is the first in the list.
+//
+// The benchmarks take the index of the variant as the first argument:
+//   mixxx-test --benchmark --benchmark_filter=BM_SampleKernels
+
+namespace {
+
+using mixxx::SampleKernels;
+
+// Covers all register widths and the scalar remainders
+const std::vector<std::ptrdiff_t> kNumFrames = {0, 1, 2, 3, 7, 8, 9, 15, 16, 17, 33, 1027};
+
+class SampleKernelsTest : public testing::Test {
+  protected:
+    static std::vector<CSAMPLE> makeSignal(std::ptrdiff_t numSamples, CSAMPLE scale) {
+        std::vector<CSAMPLE> signal(numSamples);
+        for (std::ptrdiff_t i = 0; i < numSamples; ++i) {
+            // Some values exceed the clip level
+            signal[i] = scale * static_cast<CSAMPLE>((i * 37) % 101 - 50) / 40.0f;
+        }
+        return signal;
+    }
+
+    static const SampleKernels& reference() {
+        return *SampleKernels::supported().front();
+    }
+
+    static void assertEqual(const std::vector<CSAMPLE>& expected,
+            const std::vector<CSAMPLE>& actual,
+            const SampleKernels& kernels) {
+        ASSERT_EQ(expected.size(), actual.size());
+        for (std::size_t i = 0; i < expected.size(); ++i) {
+            EXPECT_EQ(expected[i], actual[i]) << kernels.name << " at " << i;
+        }
+    }
+
+    // The ramping kernels are not bit-exact. The compiler may contract
+    // multiply-adds into FMA instructions and -ffast-math allows it to
+    // rearrange the auto-vectorized generic loops. The gains grow up to
+    // about 10, so the tolerance is relative.
+    static void assertNear(const std::vector<CSAMPLE>& expected,
+            const std::vector<CSAMPLE>& actual,
+            const SampleKernels& kernels) {
+        ASSERT_EQ(expected.size(), actual.size());
+        for (std::size_t i = 0; i < expected.size(); ++i) {
+            EXPECT_NEAR(expected[i],
+                    actual[i],
+                    1e-5f * std::max(1.0f, std::fabs(expected[i])))
+                    << kernels.name << " at " << i;
+        }
+    }
+};
+
+TEST_F(SampleKernelsTest, supportedStartsWithGeneric) {
+    ASSERT_FALSE(SampleKernels::supported().empty());
+    EXPECT_STREQ("generic", reference().name);
+    EXPECT_EQ(SampleKernels::supported().back(), &SampleKernels::active());
+}
+
+TEST_F(SampleKernelsTest, applyRampingGain) {
+    for (const auto* pKernels : SampleKernels::supported()) {
+        for (const auto numFrames : kNumFrames) {
+            // The odd trailing sample must not be touched
+            const auto input = makeSignal(numFrames * 2 + 1, 1.0f);
+            auto expected = input;
+            auto actual = input;
+            reference().applyRampingGain(expected.data(), 0.2f, 0.01f, numFrames);
+            pKernels->applyRampingGain(actual.data(), 0.2f, 0.01f, numFrames);
+            assertNear(expected, actual, *pKernels);
+        }
+    }
+}
+
+TEST_F(SampleKernelsTest, copyWithRampingGain) {
+    for (const auto* pKernels : SampleKernels::supported()) {
+        for (const auto numFrames : kNumFrames) {
+            const auto input = makeSignal(numFrames * 2, 1.0f);
+            std::vector<CSAMPLE> expected(numFrames * 2 + 1, 3.0f);
+            auto actual = expected;
+            reference().copyWithRampingGain(expected.data(), input.data(), 1.0f, -0.02f, numFrames);
+            pKernels->copyWithRampingGain(actual.data(), input.data(), 1.0f, -0.02f, numFrames);
+            assertNear(expected, actual, *pKernels);
+        }
+    }
+}
+
+TEST_F(SampleKernelsTest, addWithRampingGain) {
+    for (const auto* pKernels : SampleKernels::supported()) {
+        for (const auto numFrames : kNumFrames) {
+            const auto input = makeSignal(numFrames * 2, 1.0f);
+            auto expected = makeSignal(numFrames * 2 + 1, 0.5f);
+            auto actual = expected;
+            reference().addWithRampingGain(expected.data(), input.data(), 0.5f, 0.003f, numFrames);
+            pKernels->addWithRampingGain(actual.data(), input.data(), 0.5f, 0.003f, numFrames);
+            assertNear(expected, actual, *pKernels);
+        }
+    }
+}
+
+TEST_F(SampleKernelsTest, copy2WithRampingGain) {
+    for (const auto* pKernels : SampleKernels::supported()) {
+        for (const auto numFrames : kNumFrames) {
+            const auto input0 = makeSignal(numFrames * 2, 1.0f);
+            const auto input1 = makeSignal(numFrames * 2, -0.7f);
+            std::vector<CSAMPLE> expected(numFrames * 2 + 1, 3.0f);
+            auto actual = expected;
+            reference().copy2WithRampingGain(expected.data(),
+                    input0.data(),
+                    0.1f,
+                    0.004f,
+                    input1.data(),
+                    0.9f,
+                    -0.004f,
+                    numFrames);
+            pKernels->copy2WithRampingGain(actual.data(),
+                    input0.data(),
+                    0.1f,
+                    0.004f,
+                    input1.data(),
+                    0.9f,
+                    -0.004f,
+                    numFrames);
+            assertNear(expected, actual, *pKernels);
+        }
+    }
+}
+
+TEST_F(SampleKernelsTest, sumAbsPerChannel) {
+    for (const auto* pKernels : SampleKernels::supported()) {
+        for (const auto numFrames : kNumFrames) {
+            for (const CSAMPLE scale : {0.5f, 1.0f}) {
+                const auto input = makeSignal(numFrames * 2, scale);
+                CSAMPLE expectedL, expectedR, actualL, actualR;
+                bool expectedClippedL, expectedClippedR, actualClippedL, actualClippedR;
+                reference().sumAbsPerChannel(&expectedL,
+                        &expectedR,
+                        &expectedClippedL,
+                        &expectedClippedR,
+                        input.data(),
+                        CSAMPLE_PEAK,
+                        numFrames);
+                pKernels->sumAbsPerChannel(&actualL,
+                        &actualR,
+                        &actualClippedL,
+                        &actualClippedR,
+                        input.data(),
+                        CSAMPLE_PEAK,
+                        numFrames);
+                // The order of the additions differs between the variants
+                EXPECT_NEAR(expectedL, actualL, 1e-5f * numFrames) << pKernels->name;
+                EXPECT_NEAR(expectedR, actualR, 1e-5f * numFrames) << pKernels->name;
+                EXPECT_EQ(expectedClippedL, actualClippedL) << pKernels->name;
+                EXPECT_EQ(expectedClippedR, actualClippedR) << pKernels->name;
+            }
+        }
+    }
+}
+
+TEST_F(SampleKernelsTest, interleaveAndDeinterleave) {
+    for (const auto* pKernels : SampleKernels::supported()) {
+        for (const auto numFrames : kNumFrames) {
+            const auto input1 = makeSignal(numFrames, 1.0f);
+            const auto input2 = makeSignal(numFrames, -1.0f);
+            std::vector<CSAMPLE> expected(numFrames * 2 + 1, 3.0f);
+            auto actual = expected;
+            reference().interleave(expected.data(), input1.data(), input2.data(), numFrames);
+            pKernels->interleave(actual.data(), input1.data(), input2.data(), numFrames);
+            assertEqual(expected, actual, *pKernels);
+
+            std::vector<CSAMPLE> output1(numFrames + 1, 3.0f);
+            std::vector<CSAMPLE> output2(numFrames + 1, 3.0f);
+            pKernels->deinterleave(output1.data(), output2.data(), actual.data(), numFrames);
+            output1.pop_back();
+            output2.pop_back();
+            assertEqual(input1, output1, *pKernels);
+            assertEqual(input2, output2, *pKernels);
+        }
+    }
+}
+
+// Returns nullptr and skips the benchmark if the variant is not supported
+const SampleKernels* benchmarkKernels(benchmark::State& state) {
+    const auto& supported = SampleKernels::supported();
+    const auto index = static_cast<std::size_t>(state.range(0));
+    if (index >= supported.size()) {
+        state.SkipWithError("not supported by this CPU");
+        return nullptr;
+    }
+    state.SetLabel(supported[index]->name);
+    return supported[index];
+}
+
+void setBytesProcessed(benchmark::State& state, std::ptrdiff_t numFrames, int numBuffers) {
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) *
+            numFrames * 2 * numBuffers * static_cast<int64_t>(sizeof(CSAMPLE)));
+}
+
+// generic, SSE2 or NEON, AVX2, AVX-512
+const std::vector<int64_t> kBenchmarkVariants = {0, 1, 2, 3};
+
+static void BM_SampleKernelsApplyRampingGain(benchmark::State& state) {
+    const SampleKernels* pKernels = benchmarkKernels(state);
+    if (!pKernels) {
+        return;
+    }
+    const auto numFrames = static_cast<std::ptrdiff_t>(state.range(1));
+    CSAMPLE* pBuffer = SampleUtil::alloc(numFrames * 2);
+    SampleUtil::fill(pBuffer, 0.5f, numFrames * 2);
+    for (auto _ : state) {
+        pKernels->applyRampingGain(pBuffer, 1.0f, 0.0f, numFrames);
+        benchmark::ClobberMemory();
+    }
+    setBytesProcessed(state, numFrames, 1);
+    SampleUtil::free(pBuffer);
+}
+BENCHMARK(BM_SampleKernelsApplyRampingGain)
+        ->ArgsProduct({kBenchmarkVariants, benchmark::CreateRange(32, 4096, 8)})
+        ->ArgNames({"variant", "frames"});
+
+static void BM_SampleKernelsCopyWithRampingGain(benchmark::State& state) {
+    const SampleKernels* pKernels = benchmarkKernels(state);
+    if (!pKernels) {
+        return;
+    }
+    const auto numFrames = static_cast<std::ptrdiff_t>(state.range(1));
+    CSAMPLE* pDest = SampleUtil::alloc(numFrames * 2);
+    CSAMPLE* pSrc = SampleUtil::alloc(numFrames * 2);
+    SampleUtil::fill(pSrc, 0.5f, numFrames * 2);
+    for (auto _ : state) {
+        pKernels->copyWithRampingGain(pDest, pSrc, 1.0f, -0.0001f, numFrames);
+        benchmark::ClobberMemory();
+    }
+    setBytesProcessed(state, numFrames, 2);
+    SampleUtil::free(pDest);
+    SampleUtil::free(pSrc);
+}
+BENCHMARK(BM_SampleKernelsCopyWithRampingGain)
+        ->ArgsProduct({kBenchmarkVariants, benchmark::CreateRange(32, 4096, 8)})
+        ->ArgNames({"variant", "frames"});
+
+static void BM_SampleKernelsAddWithRampingGain(benchmark::State& state) {
+    const SampleKernels* pKernels = benchmarkKernels(state);
+    if (!pKernels) {
+        return;
+    }
+    const auto numFrames = static_cast<std::ptrdiff_t>(state.range(1));
+    CSAMPLE* pDest = SampleUtil::alloc(numFrames * 2);
+    CSAMPLE* pSrc = SampleUtil::alloc(numFrames * 2);
+    SampleUtil::clear(pDest, numFrames * 2);
+    SampleUtil::fill(pSrc, 0.5f, numFrames * 2);
+    for (auto _ : state) {
+        pKernels->addWithRampingGain(pDest, pSrc, 0.0f, 0.0f, numFrames);
+        benchmark::ClobberMemory();
+    }
+    setBytesProcessed(state, numFrames, 2);
+    SampleUtil::free(pDest);
+    SampleUtil::free(pSrc);
+}
+BENCHMARK(BM_SampleKernelsAddWithRampingGain)
+        ->ArgsProduct({kBenchmarkVariants, benchmark::CreateRange(32, 4096, 8)})
+        ->ArgNames({"variant", "frames"});
+
+static void BM_SampleKernelsCopy2WithRampingGain(benchmark::State& state) {
+    const SampleKernels* pKernels = benchmarkKernels(state);
+    if (!pKernels) {
+        return;
+    }
+    const auto numFrames = static_cast<std::ptrdiff_t>(state.range(1));
+    CSAMPLE* pDest = SampleUtil::alloc(numFrames * 2);
+    CSAMPLE* pSrc0 = SampleUtil::alloc(numFrames * 2);
+    CSAMPLE* pSrc1 = SampleUtil::alloc(numFrames * 2);
+    SampleUtil::fill(pSrc0, 0.5f, numFrames * 2);
+    SampleUtil::fill(pSrc1, -0.5f, numFrames * 2);
+    for (auto _ : state) {
+        pKernels->copy2WithRampingGain(
+                pDest, pSrc0, 1.0f, -0.0001f, pSrc1, 0.0f, 0.0001f, numFrames);
+        benchmark::ClobberMemory();
+    }
+    setBytesProcessed(state, numFrames, 3);
+    SampleUtil::free(pDest);
+    SampleUtil::free(pSrc0);
+    SampleUtil::free(pSrc1);
+}
+BENCHMARK(BM_SampleKernelsCopy2WithRampingGain)
+        ->ArgsProduct({kBenchmarkVariants, benchmark::CreateRange(32, 4096, 8)})
+        ->ArgNames({"variant", "frames"});
+
+static void BM_SampleKernelsSumAbsPerChannel(benchmark::State& state) {
+    const SampleKernels* pKernels = benchmarkKernels(state);
+    if (!pKernels) {
+        return;
+    }
+    const auto numFrames = static_cast<std::ptrdiff_t>(state.range(1));
+    CSAMPLE* pBuffer = SampleUtil::alloc(numFrames * 2);
+    SampleUtil::fill(pBuffer, 0.5f, numFrames * 2);
+    CSAMPLE sumL, sumR;
+    bool clippedL, clippedR;
+    for (auto _ : state) {
+        pKernels->sumAbsPerChannel(
+                &sumL, &sumR, &clippedL, &clippedR, pBuffer, CSAMPLE_PEAK, numFrames);
+        benchmark::DoNotOptimize(sumL);
+        benchmark::DoNotOptimize(sumR);
+    }
+    setBytesProcessed(state, numFrames, 1);
+    SampleUtil::free(pBuffer);
+}
+BENCHMARK(BM_SampleKernelsSumAbsPerChannel)
+        ->ArgsProduct({kBenchmarkVariants, benchmark::CreateRange(32, 4096, 8)})
+        ->ArgNames({"variant", "frames"});
+
+static void BM_SampleKernelsInterleave(benchmark::State& state) {
+    const SampleKernels* pKernels = benchmarkKernels(state);
+    if (!pKernels) {
+        return;
+    }
+    const auto numFrames = static_cast<std::ptrdiff_t>(state.range(1));
+    CSAMPLE* pDest = SampleUtil::alloc(numFrames * 2);
+    CSAMPLE* pSrc1 = SampleUtil::alloc(numFrames);
+    CSAMPLE* pSrc2 = SampleUtil::alloc(numFrames);
+    SampleUtil::fill(pSrc1, 0.5f, numFrames);
+    SampleUtil::fill(pSrc2, -0.5f, numFrames);
+    for (auto _ : state) {
+        pKernels->interleave(pDest, pSrc1, pSrc2, numFrames);
+        benchmark::ClobberMemory();
+    }
+    setBytesProcessed(state, numFrames, 2);
+    SampleUtil::free(pDest);
+    SampleUtil::free(pSrc1);
+    SampleUtil::free(pSrc2);
+}
+BENCHMARK(BM_SampleKernelsInterleave)
+        ->ArgsProduct({kBenchmarkVariants, benchmark::CreateRange(32, 4096, 8)})
+        ->ArgNames({"variant", "frames"});
+
+static void BM_SampleKernelsDeinterleave(benchmark::State& state) {
+    const SampleKernels* pKernels = benchmarkKernels(state);
+    if (!pKernels) {
+        return;
+    }
+    const auto numFrames = static_cast<std::ptrdiff_t>(state.range(1));
+    CSAMPLE* pSrc = SampleUtil::alloc(numFrames * 2);
+    CSAMPLE* pDest1 = SampleUtil::alloc(numFrames);
+    CSAMPLE* pDest2 = SampleUtil::alloc(numFrames);
+    SampleUtil::fill(pSrc, 0.5f, numFrames * 2);
+    for (auto _ : state) {
+        pKernels->deinterleave(pDest1, pDest2, pSrc, numFrames);
+        benchmark::ClobberMemory();
+    }
+    setBytesProcessed(state, numFrames, 2);
+    SampleUtil::free(pSrc);
+    SampleUtil::free(pDest1);
+    SampleUtil::free(pDest2);
+}
+BENCHMARK(BM_SampleKernelsDeinterleave)
+        ->ArgsProduct({kBenchmarkVariants, benchmark::CreateRange(32, 4096, 8)})
+        ->ArgNames({"variant", "frames"});
+
+} // namespace
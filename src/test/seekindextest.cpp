@@ -0,0 +1,110 @@
+#include "sources/seekindex.h"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "test/derivedfiletest.h"
+
+namespace {
+
+const QString kKind = QStringLiteral("test");
+
+class SeekIndexTest : public DerivedFileTest {
+  protected:
+    void SetUp() override {
+        DerivedFileTest::SetUp();
+        mixxx::SeekIndex::setDirectory(m_tempDir.filePath("seekindex"));
+    }
+
+    void TearDown() override {
+        mixxx::SeekIndex::setDirectory(QString());
+    }
+
+    static mixxx::SeekIndex::StreamInfo streamInfo() {
+        return mixxx::SeekIndex::StreamInfo{0, 4608, 2, 44100, 320, 0};
+    }
+
+    static std::vector<mixxx::SeekIndex::Entry> entries() {
+        return {{0, 0}, {1152, 100}, {2304, 200}, {3456, 300}, {4608, 1000}};
+    }
+};
+
+TEST_F(SeekIndexTest, saveAndLoad) {
+    const auto savedEntries = entries();
+    ASSERT_TRUE(mixxx::SeekIndex::save(kKind,
+            QFileInfo(m_audioFilePath),
+            streamInfo(),
+            savedEntries.data(),
+            savedEntries.size()));
+
+    const auto seekIndex = mixxx::SeekIndex::load(kKind, QFileInfo(m_audioFilePath));
+    ASSERT_TRUE(seekIndex.isValid());
+    EXPECT_EQ(4608, seekIndex.streamInfo().frameIndexMax);
+    EXPECT_EQ(2, seekIndex.streamInfo().channelCount);
+    EXPECT_EQ(44100, seekIndex.streamInfo().sampleRate);
+    EXPECT_EQ(320, seekIndex.streamInfo().bitrate);
+    ASSERT_EQ(static_cast<SINT>(savedEntries.size()), seekIndex.size());
+    for (SINT i = 0; i < seekIndex.size(); ++i) {
+        EXPECT_EQ(savedEntries[i].frameIndex, seekIndex.entries()[i].frameIndex);
+        EXPECT_EQ(savedEntries[i].byteOffset, seekIndex.entries()[i].byteOffset);
+    }
+
+    // Different kinds of sources don't share their indexes
+    EXPECT_FALSE(mixxx::SeekIndex::load(
+            QStringLiteral("other"), QFileInfo(m_audioFilePath))
+                         .isValid());
+}
+
+TEST_F(SeekIndexTest, modifiedFileInvalidatesIndex) {
+    const auto savedEntries = entries();
+    ASSERT_TRUE(mixxx::SeekIndex::save(kKind,
+            QFileInfo(m_audioFilePath),
+            streamInfo(),
+            savedEntries.data(),
+            savedEntries.size()));
+
+    writeAudioFile(m_audioFilePath, QByteArray(2000, 'y'));
+
+    EXPECT_FALSE(mixxx::SeekIndex::load(kKind, QFileInfo(m_audioFilePath)).isValid());
+}
+
+#ifndef __WINDOWS__
+// Mapped files cannot be replaced on Windows
+TEST_F(SeekIndexTest, replaceWhileMapped) {
+    auto savedEntries = entries();
+    ASSERT_TRUE(mixxx::SeekIndex::save(kKind,
+            QFileInfo(m_audioFilePath),
+            streamInfo(),
+            savedEntries.data(),
+            savedEntries.size()));
+    const auto seekIndex = mixxx::SeekIndex::load(kKind, QFileInfo(m_audioFilePath));
+    ASSERT_TRUE(seekIndex.isValid());
+
+    savedEntries.pop_back();
+    ASSERT_TRUE(mixxx::SeekIndex::save(kKind,
+            QFileInfo(m_audioFilePath),
+            streamInfo(),
+            savedEntries.data(),
+            savedEntries.size()));
+
+    // The first mapping still refers to the previous contents
+    EXPECT_EQ(static_cast<SINT>(savedEntries.size() + 1), seekIndex.size());
+    EXPECT_EQ(1000, seekIndex.entries()[seekIndex.size() - 1].byteOffset);
+    EXPECT_EQ(static_cast<SINT>(savedEntries.size()),
+            mixxx::SeekIndex::load(kKind, QFileInfo(m_audioFilePath)).size());
+}
+#endif
+
+TEST_F(SeekIndexTest, disabledWithoutDirectory) {
+    mixxx::SeekIndex::setDirectory(QString());
+    const auto savedEntries = entries();
+    EXPECT_FALSE(mixxx::SeekIndex::save(kKind,
+            QFileInfo(m_audioFilePath),
+            streamInfo(),
+            savedEntries.data(),
+            savedEntries.size()));
+    EXPECT_FALSE(mixxx::SeekIndex::load(kKind, QFileInfo(m_audioFilePath)).isValid());
+}
+
+} // anonymous namespace
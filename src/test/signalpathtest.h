@@ -72,7 +72,7 @@ class TestEngineMaster : public EngineMaster {
 
 class BaseSignalPathTest : public MixxxTest, SoundSourceProviderRegistration {
   protected:
-    BaseSignalPathTest() {
+    explicit BaseSignalPathTest(bool bEnableSidechain = false) {
         m_pControlIndicatorTimer = std::make_unique<mixxx::ControlIndicatorTimer>();
         m_pChannelHandleFactory = std::make_shared<ChannelHandleFactory>();
         m_pNumDecks = new ControlObject(ConfigKey(m_sMasterGroup, "num_decks"));
@@ -81,7 +81,7 @@ class BaseSignalPathTest : public MixxxTest, SoundSourceProviderRegistration {
                 m_sMasterGroup,
                 m_pEffectsManager,
                 m_pChannelHandleFactory,
-                false);
+                bEnableSidechain);
 
         m_pMixerDeck1 = new Deck(nullptr,
                 m_pConfig,
@@ -154,7 +154,7 @@ class BaseSignalPathTest : public MixxxTest, SoundSourceProviderRegistration {
         m_pNumDecks->set(m_pNumDecks->get() + 1);
     }
 
-    void loadTrack(Deck* pDeck, TrackPointer pTrack) {
+    void loadTrack(BaseTrackPlayerImpl* pDeck, TrackPointer pTrack) {
         EngineDeck* pEngineDeck = pDeck->getEngineDeck();
         if (pEngineDeck->getEngineBuffer()->isTrackLoaded()) {
             pEngineDeck->getEngineBuffer()->ejectTrack();
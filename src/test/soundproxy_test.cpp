@@ -1,8 +1,10 @@
 #include <QTemporaryDir>
 #include <QTemporaryFile>
 #include <QtDebug>
+#include <vector>
 
 #include "sources/audiosourcestereoproxy.h"
+#include "sources/seekindex.h"
 #include "sources/soundsourceproxy.h"
 #include "test/mixxxtest.h"
 #include "test/soundsourceproviderregistration.h"
@@ -944,3 +946,149 @@ TEST_F(SoundSourceProxyTest, fileSuffixWithDifferingType) {
                 SoundSourceProxy::isFileSuffixSupported(fileSuffix));
     }
 }
+
+TEST_F(SoundSourceProxyTest, seekIndex) {
+    QTemporaryDir seekIndexDir;
+    ASSERT_TRUE(seekIndexDir.isValid());
+    // Store the indexes of all files, even if they are short
+    mixxx::SeekIndex::setDirectory(seekIndexDir.path(), 0);
+
+    const QString filePaths[] = {
+            getTestDir().filePath(QStringLiteral("id3-test-data/cover-test-png.mp3")),
+            getTestDir().filePath(QStringLiteral("id3-test-data/cover-test-vbr.mp3")),
+    };
+    int indexedCount = 0;
+    for (const auto& filePath : filePaths) {
+        const auto providerRegistrations =
+                SoundSourceProxy::allProviderRegistrationsForUrl(
+                        QUrl::fromLocalFile(filePath));
+        for (const auto& providerRegistration : providerRegistrations) {
+            QDir(seekIndexDir.path()).removeRecursively();
+
+            // The first source scans the file and stores the index
+            mixxx::AudioSourcePointer pScannedSource = openAudioSource(
+                    filePath,
+                    providerRegistration.getProvider());
+            if (!pScannedSource) {
+                continue;
+            }
+            const auto frameIndexRange = pScannedSource->frameIndexRange();
+            mixxx::SampleBuffer scannedData(
+                    pScannedSource->getSignalInfo().frames2samples(
+                            frameIndexRange.length()));
+            ASSERT_EQ(frameIndexRange,
+                    pScannedSource->readSampleFrames(
+                                          mixxx::WritableSampleFrames(
+                                                  frameIndexRange,
+                                                  mixxx::SampleBuffer::WritableSlice(
+                                                          scannedData)))
+                            .frameIndexRange());
+            pScannedSource.reset();
+            if (QDir(seekIndexDir.path())
+                            .entryList(QDir::Files | QDir::NoDotAndDotDot)
+                            .isEmpty()) {
+                // The decoder doesn't store an index for this file
+                continue;
+            }
+            ++indexedCount;
+
+            // The second source seeks through the stored index
+            mixxx::AudioSourcePointer pIndexedSource = openAudioSource(
+                    filePath,
+                    providerRegistration.getProvider());
+            ASSERT_TRUE(pIndexedSource);
+            ASSERT_EQ(frameIndexRange, pIndexedSource->frameIndexRange());
+            const auto seekFrameIndexRange = mixxx::IndexRange::between(
+                    frameIndexRange.start() + frameIndexRange.length() / 2,
+                    frameIndexRange.end());
+            mixxx::SampleBuffer indexedData(scannedData.size());
+            ASSERT_EQ(seekFrameIndexRange,
+                    pIndexedSource->readSampleFrames(
+                                          mixxx::WritableSampleFrames(
+                                                  seekFrameIndexRange,
+                                                  mixxx::SampleBuffer::WritableSlice(
+                                                          indexedData)))
+                            .frameIndexRange());
+            expectDecodedSamplesEqual(
+                    pIndexedSource->getSignalInfo().frames2samples(
+                            seekFrameIndexRange.length()),
+                    &scannedData[pIndexedSource->getSignalInfo().frames2samples(
+                            seekFrameIndexRange.start() - frameIndexRange.start())],
+                    &indexedData[0],
+                    "Decoding mismatch after seeking through the index");
+            ASSERT_EQ(frameIndexRange,
+                    pIndexedSource->readSampleFrames(
+                                          mixxx::WritableSampleFrames(
+                                                  frameIndexRange,
+                                                  mixxx::SampleBuffer::WritableSlice(
+                                                          indexedData)))
+                            .frameIndexRange());
+            expectDecodedSamplesEqual(
+                    scannedData.size(),
+                    &scannedData[0],
+                    &indexedData[0],
+                    "Decoding mismatch when reading through the index");
+        }
+    }
+#ifdef __MAD__
+    // At least the MP3 decoder stores its index
+    EXPECT_LT(0, indexedCount);
+#endif
+
+    mixxx::SeekIndex::setDirectory(QString());
+}
+
+#ifdef __MAD__
+TEST_F(SoundSourceProxyTest, discardUnorderedSeekIndex) {
+    QTemporaryDir seekIndexDir;
+    ASSERT_TRUE(seekIndexDir.isValid());
+    mixxx::SeekIndex::setDirectory(seekIndexDir.path(), 0);
+    const QString filePath = getTestDir().filePath(
+            QStringLiteral("id3-test-data/cover-test-vbr.mp3"));
+    const QString kind = QStringLiteral("mp3");
+    const QFileInfo fileInfo(filePath);
+
+    // Store the index of the file and swap two of its entries
+    std::vector<mixxx::SeekIndex::Entry> entries;
+    mixxx::SeekIndex::StreamInfo streamInfo{};
+    for (const auto& providerRegistration :
+            SoundSourceProxy::allProviderRegistrationsForUrl(
+                    QUrl::fromLocalFile(filePath))) {
+        mixxx::AudioSourcePointer pAudioSource = openAudioSource(
+                filePath,
+                providerRegistration.getProvider());
+        pAudioSource.reset();
+        const auto seekIndex = mixxx::SeekIndex::load(kind, fileInfo);
+        if (seekIndex.isValid()) {
+            entries.assign(seekIndex.entries(), seekIndex.entries() + seekIndex.size());
+            streamInfo = seekIndex.streamInfo();
+            break;
+        }
+    }
+    ASSERT_LT(3u, entries.size());
+    std::swap(entries[1].byteOffset, entries[2].byteOffset);
+    ASSERT_TRUE(mixxx::SeekIndex::save(kind,
+            fileInfo,
+            streamInfo,
+            entries.data(),
+            static_cast<SINT>(entries.size())));
+
+    // The file is scanned again and the index is replaced
+    for (const auto& providerRegistration :
+            SoundSourceProxy::allProviderRegistrationsForUrl(
+                    QUrl::fromLocalFile(filePath))) {
+        EXPECT_TRUE(openAudioSource(
+                filePath,
+                providerRegistration.getProvider()));
+    }
+    const auto seekIndex = mixxx::SeekIndex::load(kind, fileInfo);
+    ASSERT_TRUE(seekIndex.isValid());
+    ASSERT_EQ(static_cast<SINT>(entries.size()), seekIndex.size());
+    for (SINT i = 1; i < seekIndex.size(); ++i) {
+        EXPECT_LT(seekIndex.entries()[i - 1].byteOffset,
+                seekIndex.entries()[i].byteOffset);
+    }
+
+    mixxx::SeekIndex::setDirectory(QString());
+}
+#endif
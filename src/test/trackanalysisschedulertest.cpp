@@ -0,0 +1,91 @@
+#include "analyzer/trackanalysisscheduler.h"
+
+#include <gtest/gtest.h>
+
+#include <deque>
+#include <vector>
+
+#include "analyzer/analyzerscheduledtrack.h"
+
+class TrackAnalysisSchedulerTest : public testing::Test {
+  protected:
+    typedef TrackAnalysisSchedulerEnvironment::TrackCostInfo TrackCostInfo;
+
+    // Returns the track ids in the order in which they would be analyzed
+    static std::vector<TrackId> sortTracksByCost(
+            const std::vector<TrackId>& trackIds,
+            const QHash<TrackId, TrackCostInfo>& costInfos) {
+        std::deque<TrackAnalysisScheduler::QueuedTrack> queuedTracks;
+        for (const auto& trackId : trackIds) {
+            queuedTracks.push_back(TrackAnalysisScheduler::QueuedTrack{
+                    AnalyzerScheduledTrack(trackId),
+                    0.0,
+                    TrackAnalysisScheduler::Clock::now()});
+        }
+        TrackAnalysisScheduler::sortTracksByCost(
+                queuedTracks.begin(), queuedTracks.end(), costInfos);
+        std::vector<TrackId> sortedTrackIds;
+        for (const auto& queuedTrack : queuedTracks) {
+            sortedTrackIds.push_back(queuedTrack.track.getTrackId());
+        }
+        return sortedTrackIds;
+    }
+
+    static TrackCostInfo costInfo(double durationSeconds, const QString& fileType) {
+        return TrackCostInfo{mixxx::Duration::fromSeconds(durationSeconds), fileType};
+    }
+};
+
+TEST_F(TrackAnalysisSchedulerTest, sortLongestFirst) {
+    const TrackId shortTrack(1);
+    const TrackId longTrack(2);
+    const TrackId mediumTrack(3);
+    const QHash<TrackId, TrackCostInfo> costInfos = {
+            {shortTrack, costInfo(60, QStringLiteral("wav"))},
+            {longTrack, costInfo(600, QStringLiteral("wav"))},
+            {mediumTrack, costInfo(240, QStringLiteral("wav"))},
+    };
+
+    EXPECT_EQ(std::vector<TrackId>({longTrack, mediumTrack, shortTrack}),
+            sortTracksByCost({shortTrack, longTrack, mediumTrack}, costInfos));
+}
+
+TEST_F(TrackAnalysisSchedulerTest, sortByDecodingCosts) {
+    // Compressed files take longer to decode than uncompressed files
+    // of the same or a slightly longer duration
+    const TrackId wavTrack(1);
+    const TrackId mp3Track(2);
+    const QHash<TrackId, TrackCostInfo> costInfos = {
+            {wavTrack, costInfo(320, QStringLiteral("WAV"))},
+            {mp3Track, costInfo(300, QStringLiteral("mp3"))},
+    };
+
+    EXPECT_EQ(std::vector<TrackId>({mp3Track, wavTrack}),
+            sortTracksByCost({wavTrack, mp3Track}, costInfos));
+}
+
+TEST_F(TrackAnalysisSchedulerTest, keepOrderOfUnknownAndEqualCosts) {
+    const TrackId unknownTrack1(1);
+    const TrackId equalTrack1(2);
+    const TrackId unknownTrack2(3);
+    const TrackId equalTrack2(4);
+    const TrackId longTrack(5);
+    const QHash<TrackId, TrackCostInfo> costInfos = {
+            {equalTrack1, costInfo(180, QStringLiteral("flac"))},
+            {equalTrack2, costInfo(180, QStringLiteral("flac"))},
+            {longTrack, costInfo(360, QStringLiteral("flac"))},
+    };
+
+    // Tracks without library metadata go to the end
+    EXPECT_EQ(std::vector<TrackId>({longTrack,
+                      equalTrack1,
+                      equalTrack2,
+                      unknownTrack1,
+                      unknownTrack2}),
+            sortTracksByCost({unknownTrack1,
+                                     equalTrack1,
+                                     unknownTrack2,
+                                     equalTrack2,
+                                     longTrack},
+                    costInfos));
+}
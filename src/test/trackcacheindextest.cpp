@@ -0,0 +1,353 @@
+#include "library/trackcacheindex.h"
+
+#include <benchmark/benchmark.h>
+#include <gtest/gtest.h>
+
+#include <QSqlDatabase>
+#include <algorithm>
+
+#include "library/searchquery.h"
+#include "util/db/dbconnection.h"
+
+namespace {
+
+enum Column {
+    kId,
+    kArtist,
+    kTitle,
+    kBpm,
+    kTrackNumber,
+    kKey,
+    kKeyId,
+    kNumColumns,
+};
+
+QVector<TrackCacheIndex::Column> testColumns() {
+    return {
+            {"id", TrackCacheIndex::SortType::Value},
+            {"artist", TrackCacheIndex::SortType::Collated},
+            {"title", TrackCacheIndex::SortType::Collated},
+            {"bpm", TrackCacheIndex::SortType::Value},
+            {"tracknumber", TrackCacheIndex::SortType::Integer},
+            {"key", TrackCacheIndex::SortType::Key},
+            {"key_id", TrackCacheIndex::SortType::Value},
+    };
+}
+
+QVector<QVariant> testRow(int id,
+        const QVariant& artist,
+        const QVariant& title,
+        const QVariant& bpm,
+        const QVariant& trackNumber = QVariant(),
+        mixxx::track::io::key::ChromaticKey key = mixxx::track::io::key::INVALID) {
+    return {id,
+            artist,
+            title,
+            bpm,
+            trackNumber,
+            KeyUtils::keyToString(key),
+            key == mixxx::track::io::key::INVALID ? QVariant() : QVariant(static_cast<int>(key))};
+}
+
+class TrackCacheIndexTest : public testing::Test {
+  protected:
+    TrackCacheIndexTest()
+            : m_index(testColumns()) {
+        addRow(testRow(1, "Björk", "Hyperballad", 125.0, "3", mixxx::track::io::key::C_MAJOR));
+        addRow(testRow(2, "björk", "Army of Me", 94.5, "10/12", mixxx::track::io::key::A_MINOR));
+        addRow(testRow(3, "Air", QVariant(), 104.0, "2"));
+        addRow(testRow(4, QVariant(), "Teardrop", QVariant(), QVariant()));
+        addRow(testRow(5, "", "Angel", 80.0, "1", mixxx::track::io::key::G_MAJOR));
+        m_index.build(m_trackInfo);
+    }
+
+    void addRow(const QVector<QVariant>& row) {
+        m_trackInfo.insert(TrackId(row[kId]), row);
+    }
+
+    std::vector<int> selectedIds(const QueryNode& node) const {
+        TrackCacheIndex::Selection selection;
+        EXPECT_TRUE(node.select(m_index, &selection));
+        std::vector<int> ids;
+        selection.matched.forEach([this, &ids](int row) {
+            ids.push_back(m_index.trackIdForRow(row).value());
+        });
+        std::sort(ids.begin(), ids.end());
+        return ids;
+    }
+
+    std::vector<int> sortedIds(const std::vector<TrackCacheIndex::SortKey>& sortKeys) {
+        std::vector<int> rows;
+        m_index.selectAll().matched.forEach([&rows](int row) {
+            rows.push_back(row);
+        });
+        EXPECT_TRUE(m_index.sortRows(&rows, sortKeys));
+        std::vector<int> ids;
+        for (int row : rows) {
+            ids.push_back(m_index.trackIdForRow(row).value());
+        }
+        return ids;
+    }
+
+    // The number of distinct strings that are interned for a column
+    int numStrings(Column column) const {
+        const auto& columnData = m_index.m_columnData[column];
+        return static_cast<int>(columnData.strings.size() -
+                columnData.freeStringIds.size());
+    }
+
+    QHash<TrackId, QVector<QVariant>> m_trackInfo;
+    TrackCacheIndex m_index;
+};
+
+TEST_F(TrackCacheIndexTest, TextFilter) {
+    // Decorations and case are ignored like by the LIKE operator
+    EXPECT_EQ(std::vector<int>({1, 2}),
+            selectedIds(TextFilterNode(QSqlDatabase(), {"artist"}, "BJORK")));
+    EXPECT_EQ(std::vector<int>({2, 4}),
+            selectedIds(TextFilterNode(QSqlDatabase(), {"artist", "title"}, "ar")));
+    // LIKE '%me _%' requires another character after the trailing space
+    EXPECT_EQ(std::vector<int>(),
+            selectedIds(TextFilterNode(QSqlDatabase(), {"title"}, "me ")));
+    EXPECT_EQ(std::vector<int>({2}),
+            selectedIds(TextFilterNode(QSqlDatabase(), {"title"}, "of ")));
+
+    // Wildcards are only supported by the database
+    TrackCacheIndex::Selection selection;
+    EXPECT_FALSE(TextFilterNode(QSqlDatabase(), {"title"}, "a%").select(m_index, &selection));
+    // Numbers are formatted differently by the database
+    EXPECT_FALSE(TextFilterNode(QSqlDatabase(), {"bpm"}, "1").select(m_index, &selection));
+}
+
+TEST_F(TrackCacheIndexTest, NegationWithNull) {
+    // NOT (artist LIKE ... OR title LIKE ...) is NULL for
+    // tracks with a NULL in any column that does not match
+    EXPECT_EQ(std::vector<int>({1, 2, 5}),
+            selectedIds(NotNode(std::make_unique<TextFilterNode>(
+                    QSqlDatabase(), QStringList{"artist", "title"}, "xyz"))));
+    EXPECT_EQ(std::vector<int>({1, 2, 5}),
+            selectedIds(NotNode(std::make_unique<TextFilterNode>(
+                    QSqlDatabase(), QStringList{"artist", "title"}, "air"))));
+    EXPECT_EQ(std::vector<int>({1, 2, 3, 5}),
+            selectedIds(NotNode(std::make_unique<TextFilterNode>(
+                    QSqlDatabase(), QStringList{"artist"}, "teardrop"))));
+}
+
+TEST_F(TrackCacheIndexTest, NullOrEmptyFilter) {
+    EXPECT_EQ(std::vector<int>({4, 5}),
+            selectedIds(NullOrEmptyTextFilterNode(QSqlDatabase(), {"artist"})));
+    EXPECT_EQ(std::vector<int>({4}),
+            selectedIds(NullNumericFilterNode({"bpm"})));
+}
+
+TEST_F(TrackCacheIndexTest, NumericFilter) {
+    EXPECT_EQ(std::vector<int>({1, 3}), selectedIds(NumericFilterNode({"bpm"}, ">100")));
+    EXPECT_EQ(std::vector<int>({2}), selectedIds(NumericFilterNode({"bpm"}, "=94.5")));
+    EXPECT_EQ(std::vector<int>({2, 3, 5}), selectedIds(NumericFilterNode({"bpm"}, "80-110")));
+    EXPECT_EQ(std::vector<int>({4}), selectedIds(NumericFilterNode({"bpm"}, "\"\"")));
+
+    // The database compares text columns with numbers as text
+    TrackCacheIndex::Selection selection;
+    EXPECT_FALSE(NumericFilterNode({"tracknumber"}, ">1").select(m_index, &selection));
+}
+
+TEST_F(TrackCacheIndexTest, KeyFilter) {
+    EXPECT_EQ(std::vector<int>({1}),
+            selectedIds(KeyFilterNode(mixxx::track::io::key::C_MAJOR, false)));
+    // Compatible keys of C major
+    EXPECT_EQ(std::vector<int>({1, 2, 5}),
+            selectedIds(KeyFilterNode(mixxx::track::io::key::C_MAJOR, true)));
+    // key_id IS x is never NULL
+    EXPECT_EQ(std::vector<int>({2, 3, 4, 5}),
+            selectedIds(NotNode(std::make_unique<KeyFilterNode>(
+                    mixxx::track::io::key::C_MAJOR, false))));
+}
+
+TEST_F(TrackCacheIndexTest, SqlNode) {
+    AndNode query;
+    query.addNode(std::make_unique<NumericFilterNode>(QStringList{"bpm"}, ">100"));
+    EXPECT_EQ(std::vector<int>({1, 3}), selectedIds(query));
+
+    query.addNode(std::make_unique<SqlNode>("bpm IS NOT NULL"));
+    TrackCacheIndex::Selection selection;
+    EXPECT_FALSE(query.select(m_index, &selection));
+}
+
+TEST_F(TrackCacheIndexTest, Sort) {
+    // NULL first, then case insensitive
+    EXPECT_EQ(std::vector<int>({4, 5, 3, 1, 2}),
+            sortedIds({{kArtist, Qt::AscendingOrder}, {kId, Qt::AscendingOrder}}));
+    EXPECT_EQ(std::vector<int>({2, 1, 3, 5, 4}),
+            sortedIds({{kArtist, Qt::DescendingOrder}, {kId, Qt::DescendingOrder}}));
+    // cast(tracknumber as integer)
+    EXPECT_EQ(std::vector<int>({4, 5, 3, 1, 2}),
+            sortedIds({{kTrackNumber, Qt::AscendingOrder}}));
+    EXPECT_EQ(std::vector<int>({4, 5, 2, 3, 1}),
+            sortedIds({{kBpm, Qt::AscendingOrder}}));
+}
+
+TEST_F(TrackCacheIndexTest, UpdateAndRemoveRows) {
+    m_index.updateRow(TrackId(6), testRow(6, "Moby", "Porcelain", 98.0));
+    m_index.updateRow(TrackId(1), testRow(1, "Björk", "Hyperballad", 99.0));
+    m_index.removeRow(TrackId(2));
+    ASSERT_TRUE(m_index.isValid());
+    EXPECT_EQ(std::vector<int>({1, 3, 5, 6}),
+            selectedIds(NumericFilterNode({"bpm"}, "<110")));
+    EXPECT_EQ(std::vector<int>({4, 5, 3, 1, 6}),
+            sortedIds({{kArtist, Qt::AscendingOrder}, {kId, Qt::AscendingOrder}}));
+
+    // A string in a numeric column needs a rebuild
+    m_index.updateRow(TrackId(3), testRow(3, "Air", QVariant(), "fast"));
+    EXPECT_FALSE(m_index.isValid());
+}
+
+TEST_F(TrackCacheIndexTest, CaseInsensitiveSort) {
+    TrackCacheIndex index({{"id", TrackCacheIndex::SortType::Value},
+            {"artist", TrackCacheIndex::SortType::CaseInsensitive}});
+    QHash<TrackId, QVector<QVariant>> trackInfo;
+    trackInfo.insert(TrackId(1), {1, "äa"});
+    trackInfo.insert(TrackId(2), {2, "Äb"});
+    trackInfo.insert(TrackId(3), {3, "Z"});
+    trackInfo.insert(TrackId(4), {4, "b"});
+    trackInfo.insert(TrackId(5), {5, "a"});
+    index.build(trackInfo);
+    std::vector<int> rows;
+    index.selectAll().matched.forEach([&rows](int row) {
+        rows.push_back(row);
+    });
+    ASSERT_TRUE(index.sortRows(&rows, {{kArtist, Qt::AscendingOrder}}));
+    std::vector<int> ids;
+    for (int row : rows) {
+        ids.push_back(index.trackIdForRow(row).value());
+    }
+    // Like SQLite lower() only ASCII characters are folded and the UTF-8
+    // bytes are compared, i.e. "Ä" (C3 84) < "ä" (C3 A4)
+    EXPECT_EQ(std::vector<int>({5, 4, 3, 2, 1}), ids);
+}
+
+TEST_F(TrackCacheIndexTest, ReleaseStrings) {
+    // "Björk", "björk", "Air" and ""
+    EXPECT_EQ(4, numStrings(kArtist));
+    for (int i = 0; i < 100; ++i) {
+        m_index.updateRow(TrackId(3),
+                testRow(3, QStringLiteral("Air %1").arg(i), QVariant(), 104.0, "2"));
+    }
+    EXPECT_EQ(4, numStrings(kArtist));
+    m_index.removeRow(TrackId(1));
+    EXPECT_EQ(3, numStrings(kArtist));
+    m_index.updateRow(TrackId(5), testRow(5, QVariant(), "Angel", 80.0, "1"));
+    EXPECT_EQ(2, numStrings(kArtist));
+    ASSERT_TRUE(m_index.isValid());
+
+    // Released strings are no longer matched
+    EXPECT_EQ(std::vector<int>({2}),
+            selectedIds(TextFilterNode(QSqlDatabase(), {"artist"}, "bjork")));
+    EXPECT_EQ(std::vector<int>({4, 5}),
+            selectedIds(NullOrEmptyTextFilterNode(QSqlDatabase(), {"artist"})));
+    m_index.updateRow(TrackId(6), testRow(6, "Moby", "Porcelain", 98.0));
+    EXPECT_EQ(3, numStrings(kArtist));
+    EXPECT_EQ(std::vector<int>({4, 5, 3, 2, 6}),
+            sortedIds({{kArtist, Qt::AscendingOrder}, {kId, Qt::AscendingOrder}}));
+}
+
+QString randomWord(int seed) {
+    static const char* const kSyllables[] = {
+            "ka", "ro", "mi", "tze", "lu", "bä", "no", "se", "quo", "vi", "dra", "ël"};
+    QString word;
+    for (int i = 0; i < 2 + seed % 3; ++i) {
+        word += kSyllables[(seed >> (i * 3)) % 12];
+    }
+    return word;
+}
+
+// A synthetic library with about 20 tracks per album and 5 albums per artist
+QHash<TrackId, QVector<QVariant>> createLibrary(int numTracks) {
+    QHash<TrackId, QVector<QVariant>> trackInfo;
+    trackInfo.reserve(numTracks);
+    for (int i = 1; i <= numTracks; ++i) {
+        const int seed = i * 7919;
+        trackInfo.insert(TrackId(i),
+                testRow(i,
+                        randomWord(i / 100) + " " + randomWord(i / 100 + 17),
+                        randomWord(seed) + " " + randomWord(seed / 13),
+                        70.0 + seed % 1000 / 10.0,
+                        QString::number(i % 20 + 1),
+                        static_cast<mixxx::track::io::key::ChromaticKey>(seed % 25)));
+    }
+    return trackInfo;
+}
+
+// The query "ka -ro bpm:>120" sorted by artist
+std::unique_ptr<QueryNode> benchmarkQuery() {
+    auto pQuery = std::make_unique<AndNode>();
+    pQuery->addNode(std::make_unique<TextFilterNode>(
+            QSqlDatabase(), QStringList{"artist", "title"}, "ka"));
+    pQuery->addNode(std::make_unique<NotNode>(std::make_unique<TextFilterNode>(
+            QSqlDatabase(), QStringList{"artist", "title"}, "ro")));
+    pQuery->addNode(std::make_unique<NumericFilterNode>(QStringList{"bpm"}, ">120"));
+    return pQuery;
+}
+
+// Evaluates the query for each row and compares QVariants like the
+// previous implementation that matched all rows one by one
+static void BM_FilterAndSortRows(benchmark::State& state) {
+    const auto trackInfo = createLibrary(static_cast<int>(state.range(0)));
+    const mixxx::StringCollator collator;
+    const auto contains = [](const QVariant& value, const QString& needle) {
+        QString string = value.toString();
+        mixxx::DbConnection::makeStringLatinLow(&string);
+        return string.contains(needle);
+    };
+    for (auto _ : state) {
+        std::vector<TrackId> trackIds;
+        for (auto it = trackInfo.constBegin(); it != trackInfo.constEnd(); ++it) {
+            const QVector<QVariant>& row = it.value();
+            if ((contains(row[kArtist], "ka") || contains(row[kTitle], "ka")) &&
+                    !(contains(row[kArtist], "ro") || contains(row[kTitle], "ro")) &&
+                    row[kBpm].toDouble() > 120) {
+                trackIds.push_back(it.key());
+            }
+        }
+        std::stable_sort(trackIds.begin(),
+                trackIds.end(),
+                [&trackInfo, &collator](TrackId lhs, TrackId rhs) {
+                    return collator.compare(trackInfo[lhs][kArtist].toString(),
+                                   trackInfo[rhs][kArtist].toString()) < 0;
+                });
+        benchmark::DoNotOptimize(trackIds.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_FilterAndSortRows)->Arg(1000)->Arg(10000)->Arg(100000);
+
+static void BM_FilterAndSortIndex(benchmark::State& state) {
+    const auto trackInfo = createLibrary(static_cast<int>(state.range(0)));
+    TrackCacheIndex index(testColumns());
+    index.build(trackInfo);
+    const auto pQuery = benchmarkQuery();
+    for (auto _ : state) {
+        TrackCacheIndex::Selection selection;
+        pQuery->select(index, &selection);
+        std::vector<int> rows;
+        selection.matched.forEach([&rows](int row) {
+            rows.push_back(row);
+        });
+        index.sortRows(&rows, {{kArtist, Qt::AscendingOrder}});
+        benchmark::DoNotOptimize(rows.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_FilterAndSortIndex)->Arg(1000)->Arg(10000)->Arg(100000);
+
+static void BM_BuildIndex(benchmark::State& state) {
+    const auto trackInfo = createLibrary(static_cast<int>(state.range(0)));
+    for (auto _ : state) {
+        TrackCacheIndex index(testColumns());
+        index.build(trackInfo);
+        benchmark::DoNotOptimize(index.rowCount());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_BuildIndex)->Arg(1000)->Arg(10000)->Arg(100000);
+
+} // namespace
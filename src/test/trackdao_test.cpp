@@ -1,6 +1,7 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include "library/dao/cuedao.h"
 #include "test/librarytest.h"
 #include "track/track.h"
 
@@ -56,3 +57,142 @@ TEST_F(TrackDAOTest, detectMovedTracks) {
     QSet<QString> trackLocations = trackDAO.getAllTrackLocations();
     EXPECT_THAT(trackLocations, UnorderedElementsAre(newFile.location(), otherFile.location()));
 }
+
+TEST_F(TrackDAOTest, addTrackRecords) {
+    TrackDAO& trackDAO = internalCollection()->getTrackDAO();
+
+    // The existing track is skipped
+    const mixxx::FileInfo existingFile(
+            QDir(QDir::tempPath() + QStringLiteral("/bulk")),
+            QStringLiteral("existing.mp3"));
+    const TrackId existingId = internalCollection()->addTrack(
+            Track::newTemporary(mixxx::FileAccess(existingFile)), false);
+    ASSERT_TRUE(existingId.isValid());
+
+    // More records than fit into a single multi-row statement
+    std::vector<TrackDAO::NewTrackRecord> records;
+    for (int i = 0; i < 50; ++i) {
+        TrackDAO::NewTrackRecord record;
+        record.fileInfo = mixxx::FileInfo(
+                QDir(QDir::tempPath() + QStringLiteral("/bulk")),
+                QStringLiteral("file%1.mp3").arg(i));
+        record.trackRecord.refMetadata().refTrackInfo().setTitle(
+                QStringLiteral("Title %1").arg(i));
+        if (i % 10 == 0) {
+            record.cuePoints.append(std::make_shared<Cue>(
+                    mixxx::CueType::HotCue,
+                    0,
+                    mixxx::audio::FramePos(i * 100),
+                    mixxx::audio::kInvalidFramePos));
+        }
+        records.push_back(std::move(record));
+    }
+    TrackDAO::NewTrackRecord existingRecord;
+    existingRecord.fileInfo = existingFile;
+    records.push_back(existingRecord);
+    // Duplicate
+    records.push_back(records.front());
+
+    QList<QSet<TrackId>> tracksAddedSignals;
+    // Disconnected when leaving the scope
+    QObject receiver;
+    QObject::connect(&trackDAO,
+            &TrackDAO::tracksAdded,
+            &receiver,
+            [&tracksAddedSignals](const QSet<TrackId>& trackIds) {
+                tracksAddedSignals.append(trackIds);
+            });
+    const QList<TrackId> trackIds = trackDAO.addTrackRecords(records, false);
+    ASSERT_EQ(static_cast<int>(records.size()), trackIds.size());
+    EXPECT_EQ(existingId, trackIds[50]);
+    EXPECT_EQ(trackIds.front(), trackIds.back());
+
+    QSet<TrackId> addedTrackIds;
+    for (int i = 0; i < 50; ++i) {
+        ASSERT_TRUE(trackIds[i].isValid());
+        addedTrackIds.insert(trackIds[i]);
+    }
+    EXPECT_EQ(50, addedTrackIds.size());
+    ASSERT_EQ(1, tracksAddedSignals.size());
+    EXPECT_EQ(addedTrackIds, tracksAddedSignals.front());
+
+    QSqlQuery query(dbConnection());
+    query.prepare(QStringLiteral(
+            "SELECT library.title FROM library "
+            "INNER JOIN track_locations ON library.location=track_locations.id "
+            "WHERE library.id=:id AND track_locations.location=:location"));
+    for (int i = 0; i < 50; ++i) {
+        query.bindValue(":id", trackIds[i].toVariant());
+        query.bindValue(":location", records[i].fileInfo.location());
+        ASSERT_TRUE(query.exec());
+        ASSERT_TRUE(query.next());
+        EXPECT_EQ(QStringLiteral("Title %1").arg(i), query.value(0).toString());
+    }
+
+    CueDAO cueDao;
+    cueDao.initialize(dbConnection());
+    for (int i = 0; i < 50; ++i) {
+        EXPECT_EQ(i % 10 == 0 ? 1 : 0, cueDao.getCuesForTrack(trackIds[i]).size());
+    }
+}
+
+TEST_F(TrackDAOTest, resolveTrackIdsAddMissing) {
+    TrackDAO& trackDAO = internalCollection()->getTrackDAO();
+
+    const QDir testDir(getTestDir().filePath(QStringLiteral("id3-test-data")));
+    const QList<mixxx::FileInfo> fileInfos = {
+            mixxx::FileInfo(testDir, QStringLiteral("artist.mp3")),
+            mixxx::FileInfo(testDir, QStringLiteral("missing.mp3")),
+            mixxx::FileInfo(testDir, QStringLiteral("cover-test.flac")),
+    };
+    EXPECT_TRUE(trackDAO.resolveTrackIds(fileInfos).isEmpty());
+
+    // The missing file is skipped
+    const QList<TrackId> trackIds = trackDAO.resolveTrackIds(
+            fileInfos, TrackDAO::ResolveTrackIdFlag::AddMissing);
+    ASSERT_EQ(2, trackIds.size());
+    EXPECT_TRUE(trackIds[0].isValid());
+    EXPECT_TRUE(trackIds[1].isValid());
+    EXPECT_EQ(trackIds,
+            trackDAO.resolveTrackIds(
+                    fileInfos, TrackDAO::ResolveTrackIdFlag::AddMissing));
+
+    // The metadata has been imported from the file
+    QSqlQuery query(dbConnection());
+    query.prepare(QStringLiteral(
+            "SELECT artist,filetype FROM library WHERE id=:id"));
+    query.bindValue(":id", trackIds[0].toVariant());
+    ASSERT_TRUE(query.exec());
+    ASSERT_TRUE(query.next());
+    EXPECT_EQ(QStringLiteral("Test Artist"), query.value(0).toString());
+    EXPECT_EQ(QStringLiteral("mp3"), query.value(1).toString());
+}
+
+TEST_F(TrackDAOTest, getTrackDurationsAndFileTypes) {
+    TrackDAO& trackDAO = internalCollection()->getTrackDAO();
+
+    const QDir dir(QDir::tempPath() + QStringLiteral("/durations"));
+    TrackPointer pMp3Track = Track::newTemporary(
+            mixxx::FileAccess(mixxx::FileInfo(dir, QStringLiteral("file.mp3"))));
+    pMp3Track->setDuration(180);
+    pMp3Track->setType(QStringLiteral("mp3"));
+    TrackPointer pFlacTrack = Track::newTemporary(
+            mixxx::FileAccess(mixxx::FileInfo(dir, QStringLiteral("file.flac"))));
+    pFlacTrack->setDuration(301.5);
+    pFlacTrack->setType(QStringLiteral("flac"));
+    const TrackId mp3Id = internalCollection()->addTrack(pMp3Track, false);
+    const TrackId flacId = internalCollection()->addTrack(pFlacTrack, false);
+    ASSERT_TRUE(mp3Id.isValid());
+    ASSERT_TRUE(flacId.isValid());
+
+    // Tracks that don't exist are omitted
+    const TrackId missingId(12345);
+    const auto durationsAndFileTypes = trackDAO.getTrackDurationsAndFileTypes(
+            QSet<TrackId>{mp3Id, flacId, missingId});
+
+    ASSERT_EQ(2, durationsAndFileTypes.size());
+    EXPECT_EQ(180.0, durationsAndFileTypes.value(mp3Id).first.toDoubleSeconds());
+    EXPECT_EQ(QStringLiteral("mp3"), durationsAndFileTypes.value(mp3Id).second);
+    EXPECT_EQ(301.5, durationsAndFileTypes.value(flacId).first.toDoubleSeconds());
+    EXPECT_EQ(QStringLiteral("flac"), durationsAndFileTypes.value(flacId).second);
+}
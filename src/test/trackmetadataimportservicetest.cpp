@@ -0,0 +1,156 @@
+#include <gtest/gtest.h>
+
+#include <QDir>
+#include <QElapsedTimer>
+#include <QHash>
+#include <memory>
+
+#include "library/trackmetadataimportservice.h"
+#include "test/mixxxtest.h"
+#include "test/soundsourceproviderregistration.h"
+#include "track/track.h"
+
+class TrackMetadataImportServiceTest : public MixxxTest, SoundSourceProviderRegistration {
+  protected:
+    TrackMetadataImportServiceTest()
+            : m_testDir(MixxxTest::getOrInitTestDir().filePath(
+                      QStringLiteral("id3-test-data"))) {
+    }
+
+    QList<TrackRef> testTrackRefs() const {
+        QList<TrackRef> trackRefs;
+        const auto fileInfos = m_testDir.entryInfoList(
+                QStringList{QStringLiteral("*.mp3")}, QDir::Files);
+        for (const auto& fileInfo : fileInfos) {
+            trackRefs.append(TrackRef::fromFilePath(fileInfo.absoluteFilePath()));
+        }
+        return trackRefs;
+    }
+
+    std::unique_ptr<TrackMetadataImportService> newService(int maxThreadCount) {
+        auto pService = std::make_unique<TrackMetadataImportService>(
+                [this](const TrackRef& trackRef) {
+                    ++m_loadCounts[trackRef.getLocation()];
+                    return Track::newTemporary(trackRef.getLocation());
+                },
+                maxThreadCount);
+        QObject::connect(pService.get(),
+                &TrackMetadataImportService::tracksImported,
+                [this](const TrackPointerList& tracks) {
+                    ++m_deliveryCount;
+                    m_importedTracks.append(tracks);
+                });
+        return pService;
+    }
+
+    bool waitUntilIdle(TrackMetadataImportService* pService) {
+        QElapsedTimer timer;
+        timer.start();
+        while (pService->pendingCount() > 0) {
+            if (timer.elapsed() > 10000) {
+                return false;
+            }
+            application()->processEvents(QEventLoop::AllEvents, 100);
+        }
+        // Deliver the remaining results
+        application()->processEvents();
+        return true;
+    }
+
+    const QDir m_testDir;
+    QHash<QString, int> m_loadCounts;
+    TrackPointerList m_importedTracks;
+    int m_deliveryCount = 0;
+};
+
+TEST_F(TrackMetadataImportServiceTest, importAll) {
+    const auto trackRefs = testTrackRefs();
+    ASSERT_FALSE(trackRefs.isEmpty());
+    const auto pService = newService(4);
+
+    pService->importTrackMetadata(
+            trackRefs,
+            SoundSourceProxy::UpdateTrackFromSourceMode::Once,
+            SyncTrackMetadataParams{});
+    ASSERT_TRUE(waitUntilIdle(pService.get()));
+
+    EXPECT_EQ(trackRefs.size(), m_loadCounts.size());
+    for (const auto& trackRef : trackRefs) {
+        EXPECT_EQ(1, m_loadCounts.value(trackRef.getLocation()));
+    }
+    // Only the tracks that could be parsed are delivered
+    EXPECT_FALSE(m_importedTracks.isEmpty());
+    EXPECT_LE(m_importedTracks.size(), trackRefs.size());
+    EXPECT_LE(m_deliveryCount, m_importedTracks.size());
+    for (const auto& pTrack : std::as_const(m_importedTracks)) {
+        EXPECT_TRUE(pTrack->checkSourceSynchronized());
+    }
+}
+
+TEST_F(TrackMetadataImportServiceTest, mergeDuplicateRequests) {
+    const auto trackRefs = testTrackRefs();
+    ASSERT_FALSE(trackRefs.isEmpty());
+    // A single worker keeps most requests in the queue
+    const auto pService = newService(1);
+
+    pService->importTrackMetadata(
+            trackRefs,
+            SoundSourceProxy::UpdateTrackFromSourceMode::Once,
+            SyncTrackMetadataParams{});
+    const int pendingCount = pService->pendingCount();
+    pService->importTrackMetadata(
+            trackRefs,
+            SoundSourceProxy::UpdateTrackFromSourceMode::Once,
+            SyncTrackMetadataParams{});
+    EXPECT_EQ(pendingCount, pService->pendingCount());
+    ASSERT_TRUE(waitUntilIdle(pService.get()));
+
+    for (const auto& trackRef : trackRefs) {
+        EXPECT_EQ(1, m_loadCounts.value(trackRef.getLocation()));
+    }
+}
+
+TEST_F(TrackMetadataImportServiceTest, cancel) {
+    const auto trackRefs = testTrackRefs();
+    ASSERT_LT(2, trackRefs.size());
+    const auto pService = newService(1);
+
+    pService->importTrackMetadata(
+            trackRefs,
+            SoundSourceProxy::UpdateTrackFromSourceMode::Once,
+            SyncTrackMetadataParams{});
+    pService->cancel();
+    // Only requests that have already been started are finished
+    pService->shutdown();
+
+    EXPECT_EQ(0, pService->pendingCount());
+    EXPECT_GT(trackRefs.size(), m_loadCounts.size());
+    EXPECT_LE(m_importedTracks.size(), m_loadCounts.size());
+}
+
+TEST_F(TrackMetadataImportServiceTest, reportProgress) {
+    const auto trackRefs = testTrackRefs();
+    ASSERT_FALSE(trackRefs.isEmpty());
+    const auto pService = newService(2);
+    QList<std::pair<int, int>> progress;
+    QObject::connect(pService.get(),
+            &TrackMetadataImportService::progressChanged,
+            [&progress](int finishedCount, int totalCount) {
+                progress.append(std::make_pair(finishedCount, totalCount));
+            });
+
+    pService->importTrackMetadata(
+            trackRefs,
+            SoundSourceProxy::UpdateTrackFromSourceMode::Once,
+            SyncTrackMetadataParams{});
+    ASSERT_TRUE(waitUntilIdle(pService.get()));
+
+    ASSERT_FALSE(progress.isEmpty());
+    EXPECT_EQ(std::make_pair(0, static_cast<int>(trackRefs.size())), progress.first());
+    EXPECT_EQ(std::make_pair(static_cast<int>(trackRefs.size()),
+                      static_cast<int>(trackRefs.size())),
+            progress.last());
+    for (int i = 1; i < progress.size(); ++i) {
+        EXPECT_LE(progress[i - 1].first, progress[i].first);
+    }
+}
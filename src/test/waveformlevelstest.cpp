@@ -0,0 +1,123 @@
+#include <benchmark/benchmark.h>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <memory>
+
+#include "waveform/waveform.h"
+
+namespace {
+
+constexpr int kSampleRate = 44100;
+
+std::unique_ptr<Waveform> createWaveform(int seconds) {
+    auto pWaveform = std::make_unique<Waveform>(
+            kSampleRate, kSampleRate * 2 * seconds, 441, -1);
+    WaveformData* pData = pWaveform->data();
+    for (int i = 0; i < pWaveform->getDataSize(); ++i) {
+        pData[i].filtered.low = static_cast<unsigned char>(i % 251);
+        pData[i].filtered.mid = static_cast<unsigned char>(i % 127);
+        pData[i].filtered.high = static_cast<unsigned char>(i % 63);
+        pData[i].filtered.all = static_cast<unsigned char>(255 - i % 255);
+    }
+    pWaveform->setCompletion(pWaveform->getDataSize());
+    return pWaveform;
+}
+
+TEST(WaveformLevelsTest, BuildLevels) {
+    const auto pWaveform = createWaveform(60);
+    EXPECT_EQ(1, pWaveform->getLevelCount());
+    pWaveform->buildLevels();
+    ASSERT_LT(1, pWaveform->getLevelCount());
+    EXPECT_GE(Waveform::kMaxLevelCount, pWaveform->getLevelCount());
+
+    for (int level = 1; level < pWaveform->getLevelCount(); ++level) {
+        const WaveformData* pPrev = pWaveform->getLevelData(level - 1);
+        const int prevDataSize = pWaveform->getLevelDataSize(level - 1);
+        const WaveformData* pData = pWaveform->getLevelData(level);
+        const int dataSize = pWaveform->getLevelDataSize(level);
+        EXPECT_EQ(0, dataSize % 2);
+        EXPECT_EQ((prevDataSize / 2 + 1) / 2 * 2, dataSize);
+        for (int i = 0; i < dataSize; ++i) {
+            // Left and right channels are reduced separately
+            const int first = (i / 2) * 4 + i % 2;
+            const int second = std::min(first + 2, prevDataSize - 2 + i % 2);
+            ASSERT_EQ(std::max(pPrev[first].filtered.low, pPrev[second].filtered.low),
+                    pData[i].filtered.low)
+                    << level << " " << i;
+            ASSERT_EQ(std::max(pPrev[first].filtered.all, pPrev[second].filtered.all),
+                    pData[i].filtered.all)
+                    << level << " " << i;
+        }
+    }
+}
+
+TEST(WaveformLevelsTest, SelectLevel) {
+    const auto pWaveform = createWaveform(60);
+    // Only the full resolution is available
+    EXPECT_EQ(0, pWaveform->levelForVisualSamplesPerPixel(100.0));
+    pWaveform->buildLevels();
+    const int maxLevel = pWaveform->getLevelCount() - 1;
+    EXPECT_EQ(0, pWaveform->levelForVisualSamplesPerPixel(0.5));
+    EXPECT_EQ(0, pWaveform->levelForVisualSamplesPerPixel(3.9));
+    EXPECT_EQ(1, pWaveform->levelForVisualSamplesPerPixel(4.0));
+    EXPECT_EQ(2, pWaveform->levelForVisualSamplesPerPixel(8.0));
+    EXPECT_EQ(maxLevel, pWaveform->levelForVisualSamplesPerPixel(1e9));
+}
+
+TEST(WaveformLevelsTest, PersistLevels) {
+    const auto pWaveform = createWaveform(60);
+    pWaveform->buildLevels();
+    const Waveform restored(pWaveform->toByteArray());
+    ASSERT_EQ(pWaveform->getLevelCount(), restored.getLevelCount());
+    for (int level = 1; level < restored.getLevelCount(); ++level) {
+        ASSERT_EQ(pWaveform->getLevelDataSize(level), restored.getLevelDataSize(level));
+        EXPECT_TRUE(std::equal(pWaveform->getLevelData(level),
+                pWaveform->getLevelData(level) + pWaveform->getLevelDataSize(level),
+                restored.getLevelData(level),
+                [](const WaveformData& lhs, const WaveformData& rhs) {
+                    return lhs.m_i == rhs.m_i;
+                }));
+    }
+}
+
+// Scans the visual samples of each pixel like the renderers do for a view
+// that is 1000 pixels wide and shows the given number of visual samples
+// per pixel.
+void scanPixels(benchmark::State& state, bool useLevels) {
+    const auto pWaveform = createWaveform(10 * 60);
+    pWaveform->buildLevels();
+    constexpr int kPixels = 1000;
+    const double visualSamplesPerPixel = static_cast<double>(state.range(0));
+    const int level = useLevels
+            ? pWaveform->levelForVisualSamplesPerPixel(visualSamplesPerPixel)
+            : 0;
+    const WaveformData* pData = pWaveform->getLevelData(level);
+    const int dataSize = pWaveform->getLevelDataSize(level);
+    const double gain = visualSamplesPerPixel * dataSize / pWaveform->getDataSize();
+    for (auto _ : state) {
+        int sum = 0;
+        for (int x = 0; x < kPixels; ++x) {
+            const int start = static_cast<int>(x * gain);
+            const int stop = std::min(static_cast<int>((x + 1) * gain), dataSize);
+            unsigned char maxAll = 0;
+            for (int i = start; i < stop; ++i) {
+                maxAll = std::max(maxAll, pData[i].filtered.all);
+            }
+            sum += maxAll;
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+}
+
+static void BM_ScanPixelsFullResolution(benchmark::State& state) {
+    scanPixels(state, false);
+}
+BENCHMARK(BM_ScanPixelsFullResolution)->RangeMultiplier(4)->Range(2, 512);
+
+static void BM_ScanPixelsLevels(benchmark::State& state) {
+    scanPixels(state, true);
+}
+BENCHMARK(BM_ScanPixelsLevels)->RangeMultiplier(4)->Range(2, 512);
+
+} // namespace
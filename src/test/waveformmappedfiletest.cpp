@@ -0,0 +1,133 @@
+#include <benchmark/benchmark.h>
+#include <gtest/gtest.h>
+
+#include <QFile>
+#include <QTemporaryDir>
+#include <memory>
+
+#include "waveform/waveform.h"
+
+namespace {
+
+constexpr int kSampleRate = 44100;
+constexpr quint32 kSourceChecksum = 0x1234;
+
+std::unique_ptr<Waveform> createWaveform(int seconds) {
+    auto pWaveform = std::make_unique<Waveform>(
+            kSampleRate, kSampleRate * 2 * seconds, 441, -1);
+    WaveformData* pData = pWaveform->data();
+    for (int i = 0; i < pWaveform->getDataSize(); ++i) {
+        pData[i].filtered.low = static_cast<unsigned char>(i);
+        pData[i].filtered.mid = static_cast<unsigned char>(i >> 8);
+        pData[i].filtered.high = static_cast<unsigned char>(i >> 16);
+        pData[i].filtered.all = static_cast<unsigned char>(255 - i);
+    }
+    pWaveform->setCompletion(pWaveform->getDataSize());
+    return pWaveform;
+}
+
+class WaveformMappedFileTest : public testing::Test {
+  protected:
+    QString mappedFilePath() const {
+        return m_tempDir.filePath(QStringLiteral("1.mapped"));
+    }
+
+    QTemporaryDir m_tempDir;
+};
+
+TEST_F(WaveformMappedFileTest, WriteAndMap) {
+    const auto pWaveform = createWaveform(60);
+    pWaveform->buildLevels();
+    ASSERT_TRUE(pWaveform->writeMappableFile(mappedFilePath(), kSourceChecksum));
+    EXPECT_TRUE(Waveform::isMappableFile(mappedFilePath(), kSourceChecksum));
+
+    const std::unique_ptr<Waveform> pMapped(
+            Waveform::mapFile(mappedFilePath(), kSourceChecksum));
+    ASSERT_NE(nullptr, pMapped);
+    EXPECT_TRUE(pMapped->isMapped());
+    EXPECT_TRUE(pMapped->isValid());
+    EXPECT_EQ(Waveform::SaveState::Saved, pMapped->saveState());
+    EXPECT_EQ(pWaveform->getDataSize(), pMapped->getDataSize());
+    EXPECT_EQ(pWaveform->getDataSize(), pMapped->getCompletion());
+    EXPECT_EQ(pWaveform->getTextureStride(), pMapped->getTextureStride());
+    EXPECT_EQ(pWaveform->getTextureSize(), pMapped->getTextureSize());
+    EXPECT_DOUBLE_EQ(pWaveform->getAudioVisualRatio(), pMapped->getAudioVisualRatio());
+    for (int i = 0; i < pWaveform->getTextureSize(); ++i) {
+        ASSERT_EQ(pWaveform->get(i).m_i, pMapped->get(i).m_i) << i;
+    }
+    ASSERT_EQ(pWaveform->getLevelCount(), pMapped->getLevelCount());
+    for (int level = 1; level < pMapped->getLevelCount(); ++level) {
+        ASSERT_EQ(pWaveform->getLevelDataSize(level), pMapped->getLevelDataSize(level));
+        for (int i = 0; i < pMapped->getLevelDataSize(level); ++i) {
+            ASSERT_EQ(pWaveform->getLevelData(level)[i].m_i,
+                    pMapped->getLevelData(level)[i].m_i)
+                    << level << " " << i;
+        }
+    }
+
+    // The compressed format can still be created from a mapped waveform
+    const Waveform restored(pMapped->toByteArray());
+    EXPECT_EQ(pWaveform->getDataSize(), restored.getDataSize());
+    EXPECT_EQ(pWaveform->getAll(42), restored.getAll(42));
+}
+
+TEST_F(WaveformMappedFileTest, RejectOutdatedFiles) {
+    const auto pWaveform = createWaveform(10);
+    ASSERT_TRUE(pWaveform->writeMappableFile(mappedFilePath(), kSourceChecksum));
+
+    // Created from a different compressed analysis
+    EXPECT_FALSE(Waveform::isMappableFile(mappedFilePath(), kSourceChecksum + 1));
+    EXPECT_EQ(nullptr, Waveform::mapFile(mappedFilePath(), kSourceChecksum + 1));
+
+    // Overwriting replaces the existing file
+    ASSERT_TRUE(pWaveform->writeMappableFile(mappedFilePath(), kSourceChecksum + 1));
+    EXPECT_TRUE(Waveform::isMappableFile(mappedFilePath(), kSourceChecksum + 1));
+}
+
+TEST_F(WaveformMappedFileTest, RejectCorruptFiles) {
+    EXPECT_EQ(nullptr, Waveform::mapFile(mappedFilePath(), kSourceChecksum));
+
+    const auto pWaveform = createWaveform(10);
+    ASSERT_TRUE(pWaveform->writeMappableFile(mappedFilePath(), kSourceChecksum));
+    QFile file(mappedFilePath());
+    ASSERT_TRUE(file.resize(file.size() - 1));
+    EXPECT_FALSE(Waveform::isMappableFile(mappedFilePath(), kSourceChecksum));
+    EXPECT_EQ(nullptr, Waveform::mapFile(mappedFilePath(), kSourceChecksum));
+
+    ASSERT_TRUE(file.open(QIODevice::WriteOnly));
+    ASSERT_EQ(4, file.write("MXXX", 4));
+    file.close();
+    EXPECT_EQ(nullptr, Waveform::mapFile(mappedFilePath(), kSourceChecksum));
+}
+
+// Compares the load latency of both formats for a track of the given
+// length in minutes. The compressed data is read from memory and the
+// mapped file is probably in the page cache, i.e. only CPU costs are
+// measured.
+static void BM_LoadCompressedWaveform(benchmark::State& state) {
+    const auto pWaveform = createWaveform(static_cast<int>(state.range(0)) * 60);
+    const QByteArray compressedData = qCompress(pWaveform->toByteArray());
+    for (auto _ : state) {
+        const Waveform loaded(qUncompress(compressedData));
+        benchmark::DoNotOptimize(loaded.getAll(loaded.getDataSize() / 2));
+    }
+}
+BENCHMARK(BM_LoadCompressedWaveform)->Arg(1)->Arg(5)->Arg(60);
+
+static void BM_MapWaveform(benchmark::State& state) {
+    const auto pWaveform = createWaveform(static_cast<int>(state.range(0)) * 60);
+    QTemporaryDir tempDir;
+    const QString fileName = tempDir.filePath(QStringLiteral("1.mapped"));
+    if (!pWaveform->writeMappableFile(fileName, kSourceChecksum)) {
+        state.SkipWithError("Failed to write mapped waveform file");
+        return;
+    }
+    for (auto _ : state) {
+        const std::unique_ptr<Waveform> pLoaded(
+                Waveform::mapFile(fileName, kSourceChecksum));
+        benchmark::DoNotOptimize(pLoaded->getAll(pLoaded->getDataSize() / 2));
+    }
+}
+BENCHMARK(BM_MapWaveform)->Arg(1)->Arg(5)->Arg(60);
+
+} // namespace
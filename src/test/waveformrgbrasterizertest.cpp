@@ -0,0 +1,258 @@
+#include "waveform/renderers/waveformrgbrasterizer.h"
+
+#include <benchmark/benchmark.h>
+#include <gtest/gtest.h>
+
+#include <QPainter>
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include "waveform/renderers/waveformrendererrgb.h"
+#include "waveform/waveform.h"
+
+// The benchmarks compare rendering all columns of a frame with rendering
+// only the columns that have been scrolled into view during playback:
+//   mixxx-test --benchmark --benchmark_filter=BM_WaveformRGBRasterizer
+
+namespace {
+
+constexpr int kSampleRate = 44100;
+constexpr int kWidth = 1000;
+constexpr int kHeight = 120;
+
+std::unique_ptr<Waveform> createWaveform(int seconds) {
+    auto pWaveform = std::make_unique<Waveform>(
+            kSampleRate, kSampleRate * 2 * seconds, 441, -1);
+    WaveformData* pData = pWaveform->data();
+    for (int i = 0; i < pWaveform->getDataSize(); ++i) {
+        pData[i].filtered.low = static_cast<unsigned char>(i % 251);
+        pData[i].filtered.mid = static_cast<unsigned char>(i % 127);
+        pData[i].filtered.high = static_cast<unsigned char>(i % 63);
+        pData[i].filtered.all = static_cast<unsigned char>(255 - i % 255);
+    }
+    pWaveform->setCompletion(pWaveform->getDataSize());
+    return pWaveform;
+}
+
+WaveformRGBRasterizer::Parameters createParameters() {
+    WaveformRGBRasterizer::Parameters parameters;
+    parameters.width = kWidth;
+    parameters.height = kHeight;
+    parameters.visualSamplesPerPixel = 3.0;
+    parameters.lowColor[0] = 1.0f;
+    parameters.midColor[1] = 1.0f;
+    parameters.highColor[2] = 1.0f;
+    return parameters;
+}
+
+class WaveformRGBRasterizerTest : public testing::Test {
+  protected:
+    WaveformRGBRasterizerTest()
+            : m_pWaveform(createWaveform(60)),
+              m_parameters(createParameters()) {
+    }
+
+    /// Renders all columns with a new rasterizer
+    QImage renderAll(qint64 firstPixel) const {
+        WaveformRGBRasterizer rasterizer;
+        EXPECT_EQ(kWidth, rasterizer.render(*m_pWaveform, 0, m_parameters, firstPixel));
+        return rasterizer.toImage();
+    }
+
+    const std::unique_ptr<Waveform> m_pWaveform;
+    WaveformRGBRasterizer::Parameters m_parameters;
+};
+
+TEST_F(WaveformRGBRasterizerTest, scrollRendersOnlyNewColumns) {
+    WaveformRGBRasterizer rasterizer;
+    EXPECT_EQ(kWidth, rasterizer.render(*m_pWaveform, 0, m_parameters, 1000));
+
+    EXPECT_EQ(0, rasterizer.render(*m_pWaveform, 0, m_parameters, 1000));
+    EXPECT_EQ(renderAll(1000), rasterizer.toImage());
+
+    // Wrap around the end of the ring buffer
+    EXPECT_EQ(7, rasterizer.render(*m_pWaveform, 0, m_parameters, 1007));
+    EXPECT_EQ(renderAll(1007), rasterizer.toImage());
+    EXPECT_EQ(kWidth - 1, rasterizer.render(*m_pWaveform, 0, m_parameters, 2006));
+    EXPECT_EQ(renderAll(2006), rasterizer.toImage());
+
+    // Backwards
+    EXPECT_EQ(3, rasterizer.render(*m_pWaveform, 0, m_parameters, 2003));
+    EXPECT_EQ(renderAll(2003), rasterizer.toImage());
+
+    // Jump
+    EXPECT_EQ(kWidth, rasterizer.render(*m_pWaveform, 0, m_parameters, 5000));
+    EXPECT_EQ(renderAll(5000), rasterizer.toImage());
+}
+
+TEST_F(WaveformRGBRasterizerTest, changesRenderAllColumns) {
+    WaveformRGBRasterizer rasterizer;
+    rasterizer.render(*m_pWaveform, 0, m_parameters, 0);
+
+    // Rounding errors of the zoom are ignored
+    m_parameters.visualSamplesPerPixel *= 1.0 + 1e-12;
+    EXPECT_EQ(0, rasterizer.render(*m_pWaveform, 0, m_parameters, 0));
+    m_parameters.visualSamplesPerPixel = 3.0;
+
+    m_parameters.lowGain = 0.5f;
+    EXPECT_EQ(kWidth, rasterizer.render(*m_pWaveform, 0, m_parameters, 0));
+    EXPECT_EQ(renderAll(0), rasterizer.toImage());
+
+    m_parameters.visualSamplesPerPixel = 6.0;
+    EXPECT_EQ(kWidth, rasterizer.render(*m_pWaveform, 0, m_parameters, 0));
+
+    m_pWaveform->buildLevels();
+    ASSERT_LT(1, m_pWaveform->getLevelCount());
+    EXPECT_EQ(kWidth, rasterizer.render(*m_pWaveform, 1, m_parameters, 0));
+
+
+    m_parameters.height = kHeight / 2;
+    EXPECT_EQ(kWidth, rasterizer.render(*m_pWaveform, 1, m_parameters, 0));
+    EXPECT_EQ(kHeight / 2, rasterizer.toImage().height());
+
+    rasterizer.invalidate();
+    EXPECT_EQ(kWidth, rasterizer.render(*m_pWaveform, 1, m_parameters, 0));
+}
+
+TEST_F(WaveformRGBRasterizerTest, completionRendersOnlyNewData) {
+    // The second half of the track has not been analyzed yet
+    const int dataSize = m_pWaveform->getDataSize();
+    WaveformData* pData = m_pWaveform->data();
+    std::vector<WaveformData> analyzedData(pData + dataSize / 2, pData + dataSize);
+    std::fill(pData + dataSize / 2, pData + dataSize, WaveformData{});
+    m_pWaveform->setCompletion(dataSize / 2);
+
+    // The end of the analyzed data is visible
+    const qint64 firstPixel =
+            static_cast<qint64>(dataSize / 2 / m_parameters.visualSamplesPerPixel) -
+            kWidth / 2;
+    WaveformRGBRasterizer rasterizer;
+    EXPECT_EQ(kWidth, rasterizer.render(*m_pWaveform, 0, m_parameters, firstPixel));
+
+    const int analyzedSize = 30;
+    std::copy(analyzedData.begin(),
+            analyzedData.begin() + analyzedSize,
+            pData + dataSize / 2);
+    m_pWaveform->setCompletion(dataSize / 2 + analyzedSize);
+    const int renderedColumns =
+            rasterizer.render(*m_pWaveform, 0, m_parameters, firstPixel);
+    EXPECT_LT(analyzedSize / m_parameters.visualSamplesPerPixel, renderedColumns);
+    EXPECT_GT(kWidth / 10, renderedColumns);
+    EXPECT_EQ(renderAll(firstPixel), rasterizer.toImage());
+}
+
+TEST_F(WaveformRGBRasterizerTest, alignment) {
+    // The columns before the start of the track are empty
+    const QImage image = renderAll(-kWidth / 2);
+    for (int y = 0; y < kHeight; ++y) {
+        ASSERT_EQ(0u, image.pixel(kWidth / 4, y)) << y;
+    }
+    const int x = kWidth * 3 / 4;
+    EXPECT_EQ(0u, image.pixel(x, 0));
+    EXPECT_EQ(0xff, qAlpha(image.pixel(x, kHeight / 2)));
+    EXPECT_EQ(0u, image.pixel(x, kHeight - 1));
+
+    m_parameters.alignment = Qt::AlignBottom;
+    const QImage bottomImage = renderAll(0);
+    EXPECT_EQ(0u, bottomImage.pixel(x, 0));
+    EXPECT_EQ(0xff, qAlpha(bottomImage.pixel(x, kHeight - 1)));
+
+    m_parameters.alignment = Qt::AlignTop;
+    const QImage topImage = renderAll(0);
+    EXPECT_EQ(0xff, qAlpha(topImage.pixel(x, 0)));
+    EXPECT_EQ(0u, topImage.pixel(x, kHeight - 1));
+}
+
+struct Column {
+    int top = 0;
+    int bottom = 0;
+    QRgb color = 0;
+};
+
+/// The range and the color of the opaque pixels
+Column opaqueColumn(const QImage& image, int x) {
+    Column column;
+    for (int y = 0; y < image.height(); ++y) {
+        const QRgb pixel = image.pixel(x, y);
+        if (qAlpha(pixel) != 0xff) {
+            continue;
+        }
+        if (column.bottom == 0) {
+            column.top = y;
+            column.color = pixel;
+        }
+        column.bottom = y + 1;
+    }
+    return column;
+}
+
+TEST_F(WaveformRGBRasterizerTest, sameColumnsAsWaveformRendererRGB) {
+    const Qt::Alignment alignments[] = {Qt::AlignCenter, Qt::AlignBottom, Qt::AlignTop};
+    for (const auto alignment : alignments) {
+        m_parameters.alignment = alignment;
+        m_parameters.lowGain = 0.8f;
+        m_parameters.highGain = 1.5f;
+        const qint64 firstPixel = 1234;
+        const QImage image = renderAll(firstPixel);
+
+        QImage expectedImage(kWidth, kHeight, QImage::Format_ARGB32_Premultiplied);
+        expectedImage.fill(Qt::transparent);
+        {
+            QPainter painter(&expectedImage);
+            painter.setRenderHints(QPainter::Antialiasing, false);
+            WaveformRendererRGB::drawSignal(&painter,
+                    m_pWaveform->getLevelData(0),
+                    m_pWaveform->getLevelDataSize(0),
+                    firstPixel * m_parameters.visualSamplesPerPixel,
+                    1.0,
+                    m_parameters);
+        }
+
+        // Lines are drawn with QPainter, which might round the ends and
+        // the colors differently
+        for (int x = 0; x < kWidth; ++x) {
+            const Column column = opaqueColumn(image, x);
+            const Column expectedColumn = opaqueColumn(expectedImage, x);
+            if (expectedColumn.bottom - expectedColumn.top <= 1) {
+                EXPECT_GE(1, column.bottom - column.top) << x;
+                continue;
+            }
+            EXPECT_NEAR(expectedColumn.top, column.top, 1) << x;
+            EXPECT_NEAR(expectedColumn.bottom, column.bottom, 1) << x;
+            EXPECT_NEAR(qRed(expectedColumn.color), qRed(column.color), 1) << x;
+            EXPECT_NEAR(qGreen(expectedColumn.color), qGreen(column.color), 1) << x;
+            EXPECT_NEAR(qBlue(expectedColumn.color), qBlue(column.color), 1) << x;
+        }
+    }
+}
+
+static void BM_WaveformRGBRasterizerFullFrame(benchmark::State& state) {
+    const auto pWaveform = createWaveform(300);
+    const auto parameters = createParameters();
+    WaveformRGBRasterizer rasterizer;
+    qint64 firstPixel = 0;
+    for (auto _ : state) {
+        rasterizer.invalidate();
+        rasterizer.render(*pWaveform, 0, parameters, firstPixel);
+        firstPixel += 2;
+    }
+    state.SetItemsProcessed(state.iterations() * kWidth);
+}
+BENCHMARK(BM_WaveformRGBRasterizerFullFrame);
+
+static void BM_WaveformRGBRasterizerScrolling(benchmark::State& state) {
+    const auto pWaveform = createWaveform(300);
+    const auto parameters = createParameters();
+    WaveformRGBRasterizer rasterizer;
+    qint64 firstPixel = 0;
+    for (auto _ : state) {
+        // About the distance of one frame at 60 fps and the default zoom
+        rasterizer.render(*pWaveform, 0, parameters, firstPixel);
+        firstPixel += 2;
+    }
+    state.SetItemsProcessed(state.iterations() * kWidth);
+}
+BENCHMARK(BM_WaveformRGBRasterizerScrolling);
+
+} // namespace
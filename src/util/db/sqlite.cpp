@@ -47,6 +47,26 @@ QVariant writeGeneratedTimestamp(const QDateTime& value) {
     return value.toUTC().toString(kGeneratedTimestampFormat);
 }
 
+QString multiRowPlaceholder(const QString& column, int row) {
+    return QChar(':') + column + QChar('_') + QString::number(row);
+}
+
+QString multiRowValuesPlaceholders(const QStringList& columns, int rowCount) {
+    DEBUG_ASSERT(columns.size() * rowCount <= kMaxHostParameters);
+    QStringList rows;
+    rows.reserve(rowCount);
+    QStringList placeholders;
+    placeholders.reserve(columns.size());
+    for (int row = 0; row < rowCount; ++row) {
+        placeholders.clear();
+        for (const auto& column : columns) {
+            placeholders.append(multiRowPlaceholder(column, row));
+        }
+        rows.append(QChar('(') + placeholders.join(QChar(',')) + QChar(')'));
+    }
+    return rows.join(QChar(','));
+}
+
 } // namespace sqlite
 
 } // namespace mixxx
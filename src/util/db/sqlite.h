@@ -1,6 +1,8 @@
 #pragma once
 
 #include <QDateTime>
+#include <QString>
+#include <QStringList>
 #include <QVariant>
 
 namespace mixxx {
@@ -10,6 +12,25 @@ QDateTime readGeneratedTimestamp(const QVariant& value);
 
 QVariant writeGeneratedTimestamp(const QDateTime& value);
 
+/// The maximum number of host parameters of a single statement
+/// (SQLITE_MAX_VARIABLE_NUMBER). SQLite versions before 3.32.0
+/// only support 999 parameters by default.
+constexpr int kMaxHostParameters = 999;
+
+/// The maximum number of rows that could be inserted by a single
+/// multi-row INSERT statement with the given number of columns.
+constexpr int maxRowsPerInsert(int columnCount) {
+    return columnCount > 0 ? kMaxHostParameters / columnCount : 0;
+}
+
+/// The named placeholder of a column in a multi-row INSERT statement,
+/// i.e. the column name with the row index as a suffix.
+QString multiRowPlaceholder(const QString& column, int row);
+
+/// The value lists "(:a_0,:b_0),(:a_1,:b_1),..." of a multi-row INSERT
+/// statement with placeholders as returned by multiRowPlaceholder().
+QString multiRowValuesPlaceholders(const QStringList& columns, int rowCount);
+
 } // namespace sqlite
 
 } // namespace mixxx
@@ -7,6 +7,7 @@
 
 #include "util/types.h"
 #include "util/platform.h"
+#include "util/samplekernels.h"
 
 // A group of utilities for working with samples.
 class SampleUtil {
@@ -0,0 +1,193 @@
+#include "util/samplekernels.h"
+
+#include <cmath>
+
+#include "util/logger.h"
+#include "util/platform.h"
+
+namespace mixxx {
+
+// Defined in the samplekernels_*.cpp files
+#if defined(__SSE2__) || defined(_M_X64)
+extern const SampleKernels kSampleKernelsSse2;
+#endif
+#ifdef MIXXX_SAMPLEKERNELS_AVX
+extern const SampleKernels kSampleKernelsAvx2;
+extern const SampleKernels kSampleKernelsAvx512;
+#endif
+#if defined(__ARM_NEON) && defined(__aarch64__)
+extern const SampleKernels kSampleKernelsNeon;
+#endif
+
+namespace {
+
+const Logger kLogger("SampleKernels");
+
+// The portable implementation, which relies on the auto-vectorization of the
+// compiler for the baseline instruction set. These are the loops SampleUtil
+// used before the kernels were split out.
+
+void applyRampingGainGeneric(float* M_RESTRICT pBuffer,
+        float startGain,
+        float gainDelta,
+        std::ptrdiff_t numFrames) {
+    // note: LOOP VECTORIZED.
+    for (int i = 0; i < numFrames; ++i) {
+        const float gain = startGain + gainDelta * i;
+        // a loop counter i += 2 prevents vectorizing.
+        pBuffer[i * 2] *= gain;
+        pBuffer[i * 2 + 1] *= gain;
+    }
+}
+
+void copyWithRampingGainGeneric(float* M_RESTRICT pDest,
+        const float* M_RESTRICT pSrc,
+        float startGain,
+        float gainDelta,
+        std::ptrdiff_t numFrames) {
+    // note: LOOP VECTORIZED only with "int i" (not SINT i)
+    for (int i = 0; i < numFrames; ++i) {
+        const float gain = startGain + gainDelta * i;
+        pDest[i * 2] = pSrc[i * 2] * gain;
+        pDest[i * 2 + 1] = pSrc[i * 2 + 1] * gain;
+    }
+}
+
+void addWithRampingGainGeneric(float* M_RESTRICT pDest,
+        const float* M_RESTRICT pSrc,
+        float startGain,
+        float gainDelta,
+        std::ptrdiff_t numFrames) {
+    // note: LOOP VECTORIZED.
+    for (int i = 0; i < numFrames; ++i) {
+        const float gain = startGain + gainDelta * i;
+        pDest[i * 2] += pSrc[i * 2] * gain;
+        pDest[i * 2 + 1] += pSrc[i * 2 + 1] * gain;
+    }
+}
+
+void copy2WithRampingGainGeneric(float* M_RESTRICT pDest,
+        const float* M_RESTRICT pSrc0,
+        float startGain0,
+        float gainDelta0,
+        const float* M_RESTRICT pSrc1,
+        float startGain1,
+        float gainDelta1,
+        std::ptrdiff_t numFrames) {
+    // note: LOOP VECTORIZED.
+    for (int i = 0; i < numFrames; ++i) {
+        const float gain0 = startGain0 + gainDelta0 * i;
+        const float gain1 = startGain1 + gainDelta1 * i;
+        pDest[i * 2] = pSrc0[i * 2] * gain0 +
+                pSrc1[i * 2] * gain1;
+        pDest[i * 2 + 1] = pSrc0[i * 2 + 1] * gain0 +
+                pSrc1[i * 2 + 1] * gain1;
+    }
+}
+
+void sumAbsPerChannelGeneric(float* pSumL,
+        float* pSumR,
+        bool* pClippedL,
+        bool* pClippedR,
+        const float* pBuffer,
+        float clipLevel,
+        std::ptrdiff_t numFrames) {
+    float sumL = 0.0f;
+    float sumR = 0.0f;
+    float clippedL = 0.0f;
+    float clippedR = 0.0f;
+
+    // note: LOOP VECTORIZED.
+    for (std::ptrdiff_t i = 0; i < numFrames; ++i) {
+        const float absL = std::fabs(pBuffer[i * 2]);
+        sumL += absL;
+        clippedL += absL > clipLevel ? 1 : 0;
+        const float absR = std::fabs(pBuffer[i * 2 + 1]);
+        sumR += absR;
+        // Replacing the code with a bool clipped will prevent vetorizing
+        clippedR += absR > clipLevel ? 1 : 0;
+    }
+
+    *pSumL = sumL;
+    *pSumR = sumR;
+    *pClippedL = clippedL > 0;
+    *pClippedR = clippedR > 0;
+}
+
+void interleaveGeneric(float* M_RESTRICT pDest,
+        const float* M_RESTRICT pSrc1,
+        const float* M_RESTRICT pSrc2,
+        std::ptrdiff_t numFrames) {
+    // note: LOOP VECTORIZED.
+    for (std::ptrdiff_t i = 0; i < numFrames; ++i) {
+        pDest[2 * i] = pSrc1[i];
+        pDest[2 * i + 1] = pSrc2[i];
+    }
+}
+
+void deinterleaveGeneric(float* M_RESTRICT pDest1,
+        float* M_RESTRICT pDest2,
+        const float* M_RESTRICT pSrc,
+        std::ptrdiff_t numFrames) {
+    // note: LOOP VECTORIZED.
+    for (std::ptrdiff_t i = 0; i < numFrames; ++i) {
+        pDest1[i] = pSrc[i * 2];
+        pDest2[i] = pSrc[i * 2 + 1];
+    }
+}
+
+const SampleKernels kSampleKernelsGeneric = {
+        "generic",
+        applyRampingGainGeneric,
+        copyWithRampingGainGeneric,
+        addWithRampingGainGeneric,
+        copy2WithRampingGainGeneric,
+        sumAbsPerChannelGeneric,
+        interleaveGeneric,
+        deinterleaveGeneric,
+};
+
+std::vector<const SampleKernels*> detectSupportedKernels() {
+    std::vector<const SampleKernels*> kernels;
+    kernels.push_back(&kSampleKernelsGeneric);
+#if defined(__SSE2__) || defined(_M_X64)
+    kernels.push_back(&kSampleKernelsSse2);
+#endif
+#ifdef MIXXX_SAMPLEKERNELS_AVX
+    // May run before the static constructors of libgcc
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        kernels.push_back(&kSampleKernelsAvx2);
+    }
+    if (__builtin_cpu_supports("avx512f")) {
+        kernels.push_back(&kSampleKernelsAvx512);
+    }
+#endif
+#if defined(__ARM_NEON) && defined(__aarch64__)
+    kernels.push_back(&kSampleKernelsNeon);
+#endif
+    return kernels;
+}
+
+} // anonymous namespace
+
+// static
+const std::vector<const SampleKernels*>& SampleKernels::supported() {
+    static const std::vector<const SampleKernels*> s_kernels =
+            detectSupportedKernels();
+    return s_kernels;
+}
+
+// static
+void SampleKernels::initialize() {
+    kLogger.info() << "Using" << active().name << "sample kernels";
+}
+
+// static
+const SampleKernels& SampleKernels::active() {
+    // The list is ordered by preference
+    static const SampleKernels& s_kernels = *supported().back();
+    return s_kernels;
+}
+
+} // namespace mixxx
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace mixxx {
+
+/// A table of hand-vectorized implementations of the innermost loops of
+/// SampleUtil for one instruction set.
+///
+/// Distribution packages are built for the baseline of the target
+/// architecture (SSE2 on x86-64), so the auto-vectorized loops in SampleUtil
+/// never use wider registers. The kernels for the wider instruction sets are
+/// compiled in their own translation units with the corresponding compiler
+/// flags and the best table for the CPU we are running on is picked once at
+/// startup.
+///
+/// The kernels only contain the loops. The early exits and the computation
+/// of the gain ramps stay in SampleUtil. All ramping kernels work on
+/// interleaved stereo frames and apply the gain startGain + gainDelta * i to
+/// both samples of frame i.
+///
+/// This header must not include any Mixxx or Qt headers, because it is
+/// included by the translation units that are compiled for instruction sets
+/// that are not available on every CPU.
+struct SampleKernels {
+    /// Name of the instruction set, e.g. "AVX2"
+    const char* name;
+
+    void (*applyRampingGain)(float* pBuffer,
+            float startGain,
+            float gainDelta,
+            std::ptrdiff_t numFrames);
+    void (*copyWithRampingGain)(float* pDest,
+            const float* pSrc,
+            float startGain,
+            float gainDelta,
+            std::ptrdiff_t numFrames);
+    void (*addWithRampingGain)(float* pDest,
+            const float* pSrc,
+            float startGain,
+            float gainDelta,
+            std::ptrdiff_t numFrames);
+    void (*copy2WithRampingGain)(float* pDest,
+            const float* pSrc0,
+            float startGain0,
+            float gainDelta0,
+            const float* pSrc1,
+            float startGain1,
+            float gainDelta1,
+            std::ptrdiff_t numFrames);
+
+    /// Sums up the absolute values per channel and reports whether any
+    /// sample of a channel exceeds clipLevel.
+    void (*sumAbsPerChannel)(float* pSumL,
+            float* pSumR,
+            bool* pClippedL,
+            bool* pClippedR,
+            const float* pBuffer,
+            float clipLevel,
+            std::ptrdiff_t numFrames);
+
+    void (*interleave)(float* pDest,
+            const float* pSrc1,
+            const float* pSrc2,
+            std::ptrdiff_t numFrames);
+    void (*deinterleave)(float* pDest1,
+            float* pDest2,
+            const float* pSrc,
+            std::ptrdiff_t numFrames);
+
+    /// Selects and logs the active kernels. Called once at startup, so
+    /// that the real-time threads never detect the CPU features or log.
+    static void initialize();
+
+    /// The fastest kernels supported by the CPU we are running on.
+    static const SampleKernels& active();
+
+    /// All kernels that are compiled into this build and supported by the
+    /// CPU, starting with the portable scalar ones. Used for testing and
+    /// benchmarking the variants against each other.
+    static const std::vector<const SampleKernels*>& supported();
+};
+
+} // namespace mixxx
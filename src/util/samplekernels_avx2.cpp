@@ -0,0 +1,65 @@
+// SampleKernels for AVX2. This file is compiled with -mavx2 and must only be
+// entered after checking the CPU features at runtime.
+
+#include <immintrin.h>
+
+#include "util/samplekernels_impl.h"
+
+namespace {
+
+struct Avx2 {
+    using Vec = __m256;
+    static constexpr int kFloats = 8;
+
+    static Vec load(const float* p) {
+        return _mm256_loadu_ps(p);
+    }
+    static void store(float* p, Vec v) {
+        _mm256_storeu_ps(p, v);
+    }
+    static Vec set1(float x) {
+        return _mm256_set1_ps(x);
+    }
+    static Vec add(Vec a, Vec b) {
+        return _mm256_add_ps(a, b);
+    }
+    static Vec mul(Vec a, Vec b) {
+        return _mm256_mul_ps(a, b);
+    }
+    static Vec abs(Vec v) {
+        return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), v);
+    }
+    static Vec above(Vec v, Vec level) {
+        return _mm256_and_ps(_mm256_cmp_ps(v, level, _CMP_GT_OQ), _mm256_set1_ps(1.0f));
+    }
+    static Vec frameOffsets() {
+        return _mm256_setr_ps(0.0f, 0.0f, 1.0f, 1.0f, 2.0f, 2.0f, 3.0f, 3.0f);
+    }
+    static void storeInterleaved(float* p, Vec a, Vec b) {
+        // The unpack instructions work within each 128 bit lane:
+        // lo = a0 b0 a1 b1 | a4 b4 a5 b5, hi = a2 b2 a3 b3 | a6 b6 a7 b7
+        const Vec lo = _mm256_unpacklo_ps(a, b);
+        const Vec hi = _mm256_unpackhi_ps(a, b);
+        _mm256_storeu_ps(p, _mm256_permute2f128_ps(lo, hi, 0x20));
+        _mm256_storeu_ps(p + 8, _mm256_permute2f128_ps(lo, hi, 0x31));
+    }
+    static void loadDeinterleaved(const float* p, Vec* pA, Vec* pB) {
+        const Vec lo = _mm256_loadu_ps(p);
+        const Vec hi = _mm256_loadu_ps(p + 8);
+        // a0 a1 a4 a5 | a2 a3 a6 a7, then restore the order of the 64 bit pairs
+        const Vec even = _mm256_shuffle_ps(lo, hi, _MM_SHUFFLE(2, 0, 2, 0));
+        const Vec odd = _mm256_shuffle_ps(lo, hi, _MM_SHUFFLE(3, 1, 3, 1));
+        *pA = _mm256_castpd_ps(_mm256_permute4x64_pd(
+                _mm256_castps_pd(even), _MM_SHUFFLE(3, 1, 2, 0)));
+        *pB = _mm256_castpd_ps(_mm256_permute4x64_pd(
+                _mm256_castps_pd(odd), _MM_SHUFFLE(3, 1, 2, 0)));
+    }
+};
+
+} // anonymous namespace
+
+namespace mixxx {
+
+extern const SampleKernels kSampleKernelsAvx2 = makeSampleKernels<Avx2>("AVX2");
+
+} // namespace mixxx
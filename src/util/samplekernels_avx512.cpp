@@ -0,0 +1,67 @@
+// SampleKernels for AVX-512F. This file is compiled with -mavx512f and must
+// only be entered after checking the CPU features at runtime.
+
+#include <immintrin.h>
+
+#include "util/samplekernels_impl.h"
+
+namespace {
+
+struct Avx512 {
+    using Vec = __m512;
+    static constexpr int kFloats = 16;
+
+    static Vec load(const float* p) {
+        return _mm512_loadu_ps(p);
+    }
+    static void store(float* p, Vec v) {
+        _mm512_storeu_ps(p, v);
+    }
+    static Vec set1(float x) {
+        return _mm512_set1_ps(x);
+    }
+    static Vec add(Vec a, Vec b) {
+        return _mm512_add_ps(a, b);
+    }
+    static Vec mul(Vec a, Vec b) {
+        return _mm512_mul_ps(a, b);
+    }
+    static Vec abs(Vec v) {
+        return _mm512_abs_ps(v);
+    }
+    static Vec above(Vec v, Vec level) {
+        const __mmask16 mask = _mm512_cmp_ps_mask(v, level, _CMP_GT_OQ);
+        return _mm512_maskz_mov_ps(mask, _mm512_set1_ps(1.0f));
+    }
+    static Vec frameOffsets() {
+        return _mm512_setr_ps(0.0f, 0.0f, 1.0f, 1.0f, 2.0f, 2.0f, 3.0f, 3.0f,
+                4.0f, 4.0f, 5.0f, 5.0f, 6.0f, 6.0f, 7.0f, 7.0f);
+    }
+    static void storeInterleaved(float* p, Vec a, Vec b) {
+        // Indices >= 16 select from b
+        const __m512i lo = _mm512_setr_epi32(
+                0, 16, 1, 17, 2, 18, 3, 19, 4, 20, 5, 21, 6, 22, 7, 23);
+        const __m512i hi = _mm512_setr_epi32(
+                8, 24, 9, 25, 10, 26, 11, 27, 12, 28, 13, 29, 14, 30, 15, 31);
+        _mm512_storeu_ps(p, _mm512_permutex2var_ps(a, lo, b));
+        _mm512_storeu_ps(p + 16, _mm512_permutex2var_ps(a, hi, b));
+    }
+    static void loadDeinterleaved(const float* p, Vec* pA, Vec* pB) {
+        const __m512i even = _mm512_setr_epi32(
+                0, 2, 4, 6, 8, 10, 12, 14, 16, 18, 20, 22, 24, 26, 28, 30);
+        const __m512i odd = _mm512_setr_epi32(
+                1, 3, 5, 7, 9, 11, 13, 15, 17, 19, 21, 23, 25, 27, 29, 31);
+        const Vec lo = _mm512_loadu_ps(p);
+        const Vec hi = _mm512_loadu_ps(p + 16);
+        *pA = _mm512_permutex2var_ps(lo, even, hi);
+        *pB = _mm512_permutex2var_ps(lo, odd, hi);
+    }
+};
+
+} // anonymous namespace
+
+namespace mixxx {
+
+extern const SampleKernels kSampleKernelsAvx512 = makeSampleKernels<Avx512>("AVX-512");
+
+} // namespace mixxx
@@ -0,0 +1,246 @@
+#pragma once
+
+// Generic kernel implementations shared by the samplekernels_*.cpp files.
+// Each of them instantiates the templates below with a traits type that maps
+// the operations to the intrinsics of its instruction set:
+//
+//   using Vec                     register type holding kFloats floats
+//   kFloats                       number of floats per register (even)
+//   load(p), store(p, v)          unaligned load and store
+//   set1(x), add(a, b), mul(a, b)
+//   abs(v)
+//   above(v, level)               1.0f in every lane where v > level,
+//                                 0.0f otherwise
+//   frameOffsets()                {0, 0, 1, 1, 2, 2, ...}, i.e. the index of
+//                                 the stereo frame of each lane
+//   storeInterleaved(p, a, b)     stores a0 b0 a1 b1 ... to 2 * kFloats floats
+//   loadDeinterleaved(p, a, b)    the inverse of storeInterleaved()
+//
+// The remainder of each buffer that does not fill a whole register is
+// processed with the same formulas in scalar code. Everything lives in an
+// anonymous namespace so that the instantiations for different instruction
+// sets never get merged by the linker. For the same reason no inline
+// functions with external linkage (e.g. from <cmath>) must be used here.
+
+#include <cstddef>
+
+#include "util/samplekernels.h"
+
+namespace {
+
+template<typename V>
+constexpr std::ptrdiff_t kFramesPerVec = V::kFloats / 2;
+
+// The gains are always computed from the frame index instead of being
+// accumulated, so that rounding errors do not build up over long buffers.
+// The results may still differ from the scalar code in the last bits,
+// because the compiler is free to contract the multiply-adds into FMA
+// instructions, e.g. with -mavx512f.
+template<typename V>
+inline typename V::Vec rampGains(
+        typename V::Vec startGain, typename V::Vec gainDelta, typename V::Vec frames) {
+    return V::add(startGain, V::mul(gainDelta, frames));
+}
+
+template<typename V>
+void applyRampingGain(float* pBuffer,
+        float startGain,
+        float gainDelta,
+        std::ptrdiff_t numFrames) {
+    constexpr std::ptrdiff_t kFrames = kFramesPerVec<V>;
+    const auto start = V::set1(startGain);
+    const auto delta = V::set1(gainDelta);
+    const auto step = V::set1(static_cast<float>(kFrames));
+    auto frames = V::frameOffsets();
+    std::ptrdiff_t i = 0;
+    for (; i + kFrames <= numFrames; i += kFrames) {
+        const auto gains = rampGains<V>(start, delta, frames);
+        V::store(pBuffer + i * 2, V::mul(V::load(pBuffer + i * 2), gains));
+        frames = V::add(frames, step);
+    }
+    for (; i < numFrames; ++i) {
+        const float gain = startGain + gainDelta * i;
+        pBuffer[i * 2] *= gain;
+        pBuffer[i * 2 + 1] *= gain;
+    }
+}
+
+template<typename V>
+void copyWithRampingGain(float* pDest,
+        const float* pSrc,
+        float startGain,
+        float gainDelta,
+        std::ptrdiff_t numFrames) {
+    constexpr std::ptrdiff_t kFrames = kFramesPerVec<V>;
+    const auto start = V::set1(startGain);
+    const auto delta = V::set1(gainDelta);
+    const auto step = V::set1(static_cast<float>(kFrames));
+    auto frames = V::frameOffsets();
+    std::ptrdiff_t i = 0;
+    for (; i + kFrames <= numFrames; i += kFrames) {
+        const auto gains = rampGains<V>(start, delta, frames);
+        V::store(pDest + i * 2, V::mul(V::load(pSrc + i * 2), gains));
+        frames = V::add(frames, step);
+    }
+    for (; i < numFrames; ++i) {
+        const float gain = startGain + gainDelta * i;
+        pDest[i * 2] = pSrc[i * 2] * gain;
+        pDest[i * 2 + 1] = pSrc[i * 2 + 1] * gain;
+    }
+}
+
+template<typename V>
+void addWithRampingGain(float* pDest,
+        const float* pSrc,
+        float startGain,
+        float gainDelta,
+        std::ptrdiff_t numFrames) {
+    constexpr std::ptrdiff_t kFrames = kFramesPerVec<V>;
+    const auto start = V::set1(startGain);
+    const auto delta = V::set1(gainDelta);
+    const auto step = V::set1(static_cast<float>(kFrames));
+    auto frames = V::frameOffsets();
+    std::ptrdiff_t i = 0;
+    for (; i + kFrames <= numFrames; i += kFrames) {
+        const auto gains = rampGains<V>(start, delta, frames);
+        V::store(pDest + i * 2,
+                V::add(V::load(pDest + i * 2),
+                        V::mul(V::load(pSrc + i * 2), gains)));
+        frames = V::add(frames, step);
+    }
+    for (; i < numFrames; ++i) {
+        const float gain = startGain + gainDelta * i;
+        pDest[i * 2] += pSrc[i * 2] * gain;
+        pDest[i * 2 + 1] += pSrc[i * 2 + 1] * gain;
+    }
+}
+
+template<typename V>
+void copy2WithRampingGain(float* pDest,
+        const float* pSrc0,
+        float startGain0,
+        float gainDelta0,
+        const float* pSrc1,
+        float startGain1,
+        float gainDelta1,
+        std::ptrdiff_t numFrames) {
+    constexpr std::ptrdiff_t kFrames = kFramesPerVec<V>;
+    const auto start0 = V::set1(startGain0);
+    const auto delta0 = V::set1(gainDelta0);
+    const auto start1 = V::set1(startGain1);
+    const auto delta1 = V::set1(gainDelta1);
+    const auto step = V::set1(static_cast<float>(kFrames));
+    auto frames = V::frameOffsets();
+    std::ptrdiff_t i = 0;
+    for (; i + kFrames <= numFrames; i += kFrames) {
+        const auto gains0 = rampGains<V>(start0, delta0, frames);
+        const auto gains1 = rampGains<V>(start1, delta1, frames);
+        V::store(pDest + i * 2,
+                V::add(V::mul(V::load(pSrc0 + i * 2), gains0),
+                        V::mul(V::load(pSrc1 + i * 2), gains1)));
+        frames = V::add(frames, step);
+    }
+    for (; i < numFrames; ++i) {
+        const float gain0 = startGain0 + gainDelta0 * i;
+        const float gain1 = startGain1 + gainDelta1 * i;
+        pDest[i * 2] = pSrc0[i * 2] * gain0 + pSrc1[i * 2] * gain1;
+        pDest[i * 2 + 1] = pSrc0[i * 2 + 1] * gain0 + pSrc1[i * 2 + 1] * gain1;
+    }
+}
+
+template<typename V>
+void sumAbsPerChannel(float* pSumL,
+        float* pSumR,
+        bool* pClippedL,
+        bool* pClippedR,
+        const float* pBuffer,
+        float clipLevel,
+        std::ptrdiff_t numFrames) {
+    constexpr std::ptrdiff_t kFrames = kFramesPerVec<V>;
+    const auto level = V::set1(clipLevel);
+    auto sums = V::set1(0.0f);
+    auto clipped = V::set1(0.0f);
+    std::ptrdiff_t i = 0;
+    for (; i + kFrames <= numFrames; i += kFrames) {
+        const auto absValues = V::abs(V::load(pBuffer + i * 2));
+        sums = V::add(sums, absValues);
+        clipped = V::add(clipped, V::above(absValues, level));
+    }
+
+    float lanes[V::kFloats];
+    float clippedLanes[V::kFloats];
+    V::store(lanes, sums);
+    V::store(clippedLanes, clipped);
+    float sumL = 0.0f;
+    float sumR = 0.0f;
+    float clippedL = 0.0f;
+    float clippedR = 0.0f;
+    for (int lane = 0; lane < V::kFloats; lane += 2) {
+        sumL += lanes[lane];
+        sumR += lanes[lane + 1];
+        clippedL += clippedLanes[lane];
+        clippedR += clippedLanes[lane + 1];
+    }
+    for (; i < numFrames; ++i) {
+        const float absL = pBuffer[i * 2] < 0.0f ? -pBuffer[i * 2] : pBuffer[i * 2];
+        const float absR = pBuffer[i * 2 + 1] < 0.0f ? -pBuffer[i * 2 + 1] : pBuffer[i * 2 + 1];
+        sumL += absL;
+        sumR += absR;
+        clippedL += absL > clipLevel ? 1.0f : 0.0f;
+        clippedR += absR > clipLevel ? 1.0f : 0.0f;
+    }
+    *pSumL = sumL;
+    *pSumR = sumR;
+    *pClippedL = clippedL > 0.0f;
+    *pClippedR = clippedR > 0.0f;
+}
+
+template<typename V>
+void interleave(float* pDest,
+        const float* pSrc1,
+        const float* pSrc2,
+        std::ptrdiff_t numFrames) {
+    std::ptrdiff_t i = 0;
+    for (; i + V::kFloats <= numFrames; i += V::kFloats) {
+        V::storeInterleaved(pDest + i * 2, V::load(pSrc1 + i), V::load(pSrc2 + i));
+    }
+    for (; i < numFrames; ++i) {
+        pDest[i * 2] = pSrc1[i];
+        pDest[i * 2 + 1] = pSrc2[i];
+    }
+}
+
+template<typename V>
+void deinterleave(float* pDest1,
+        float* pDest2,
+        const float* pSrc,
+        std::ptrdiff_t numFrames) {
+    std::ptrdiff_t i = 0;
+    for (; i + V::kFloats <= numFrames; i += V::kFloats) {
+        typename V::Vec first;
+        typename V::Vec second;
+        V::loadDeinterleaved(pSrc + i * 2, &first, &second);
+        V::store(pDest1 + i, first);
+        V::store(pDest2 + i, second);
+    }
+    for (; i < numFrames; ++i) {
+        pDest1[i] = pSrc[i * 2];
+        pDest2[i] = pSrc[i * 2 + 1];
+    }
+}
+
+template<typename V>
+constexpr mixxx::SampleKernels makeSampleKernels(const char* name) {
+    return mixxx::SampleKernels{
+            name,
+            applyRampingGain<V>,
+            copyWithRampingGain<V>,
+            addWithRampingGain<V>,
+            copy2WithRampingGain<V>,
+            sumAbsPerChannel<V>,
+            interleave<V>,
+            deinterleave<V>,
+    };
+}
+
+} // anonymous namespace
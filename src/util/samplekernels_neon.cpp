@@ -0,0 +1,60 @@
+// SampleKernels for NEON, which is part of the AArch64 baseline and needs no
+// special compiler flags.
+
+#if defined(__ARM_NEON) && defined(__aarch64__)
+
+#include <arm_neon.h>
+
+#include "util/samplekernels_impl.h"
+
+namespace {
+
+struct Neon {
+    using Vec = float32x4_t;
+    static constexpr int kFloats = 4;
+
+    static Vec load(const float* p) {
+        return vld1q_f32(p);
+    }
+    static void store(float* p, Vec v) {
+        vst1q_f32(p, v);
+    }
+    static Vec set1(float x) {
+        return vdupq_n_f32(x);
+    }
+    static Vec add(Vec a, Vec b) {
+        return vaddq_f32(a, b);
+    }
+    static Vec mul(Vec a, Vec b) {
+        return vmulq_f32(a, b);
+    }
+    static Vec abs(Vec v) {
+        return vabsq_f32(v);
+    }
+    static Vec above(Vec v, Vec level) {
+        return vreinterpretq_f32_u32(vandq_u32(
+                vcgtq_f32(v, level), vreinterpretq_u32_f32(vdupq_n_f32(1.0f))));
+    }
+    static Vec frameOffsets() {
+        static const float kOffsets[] = {0.0f, 0.0f, 1.0f, 1.0f};
+        return vld1q_f32(kOffsets);
+    }
+    static void storeInterleaved(float* p, Vec a, Vec b) {
+        vst2q_f32(p, float32x4x2_t{{a, b}});
+    }
+    static void loadDeinterleaved(const float* p, Vec* pA, Vec* pB) {
+        const float32x4x2_t pair = vld2q_f32(p);
+        *pA = pair.val[0];
+        *pB = pair.val[1];
+    }
+};
+
+} // anonymous namespace
+
+namespace mixxx {
+
+extern const SampleKernels kSampleKernelsNeon = makeSampleKernels<Neon>("NEON");
+
+} // namespace mixxx
+
+#endif
@@ -0,0 +1,60 @@
+// SampleKernels for SSE2, which is part of the x86-64 baseline and needs no
+// special compiler flags.
+
+#if defined(__SSE2__) || defined(_M_X64)
+
+#include <emmintrin.h>
+
+#include "util/samplekernels_impl.h"
+
+namespace {
+
+struct Sse2 {
+    using Vec = __m128;
+    static constexpr int kFloats = 4;
+
+    static Vec load(const float* p) {
+        return _mm_loadu_ps(p);
+    }
+    static void store(float* p, Vec v) {
+        _mm_storeu_ps(p, v);
+    }
+    static Vec set1(float x) {
+        return _mm_set1_ps(x);
+    }
+    static Vec add(Vec a, Vec b) {
+        return _mm_add_ps(a, b);
+    }
+    static Vec mul(Vec a, Vec b) {
+        return _mm_mul_ps(a, b);
+    }
+    static Vec abs(Vec v) {
+        return _mm_andnot_ps(_mm_set1_ps(-0.0f), v);
+    }
+    static Vec above(Vec v, Vec level) {
+        return _mm_and_ps(_mm_cmpgt_ps(v, level), _mm_set1_ps(1.0f));
+    }
+    static Vec frameOffsets() {
+        return _mm_setr_ps(0.0f, 0.0f, 1.0f, 1.0f);
+    }
+    static void storeInterleaved(float* p, Vec a, Vec b) {
+        _mm_storeu_ps(p, _mm_unpacklo_ps(a, b));
+        _mm_storeu_ps(p + 4, _mm_unpackhi_ps(a, b));
+    }
+    static void loadDeinterleaved(const float* p, Vec* pA, Vec* pB) {
+        const Vec lo = _mm_loadu_ps(p);
+        const Vec hi = _mm_loadu_ps(p + 4);
+        *pA = _mm_shuffle_ps(lo, hi, _MM_SHUFFLE(2, 0, 2, 0));
+        *pB = _mm_shuffle_ps(lo, hi, _MM_SHUFFLE(3, 1, 3, 1));
+    }
+};
+
+} // anonymous namespace
+
+namespace mixxx {
+
+extern const SampleKernels kSampleKernelsSse2 = makeSampleKernels<Sse2>("SSE2");
+
+} // namespace mixxx
+
+#endif
@@ -37,12 +37,14 @@ void GLWaveformRendererRGB::draw(QPainter* painter, QPaintEvent* /*event*/) {
         return;
     }
 
-    const int dataSize = waveform->getDataSize();
+    // Zoomed out waveforms are drawn from a coarser level
+    const int level = selectWaveformLevel(*waveform);
+    const int dataSize = waveform->getLevelDataSize(level);
     if (dataSize <= 1) {
         return;
     }
 
-    const WaveformData* data = waveform->data();
+    const WaveformData* data = waveform->getLevelData(level);
     if (data == nullptr) {
         return;
     }
@@ -107,12 +107,14 @@ int QtWaveformRendererFilteredSignal::buildPolygon() {
         return 0;
     }
 
-    const int dataSize = waveform->getDataSize();
+    // Zoomed out waveforms are drawn from a coarser level
+    const int level = selectWaveformLevel(*waveform);
+    const int dataSize = waveform->getLevelDataSize(level);
     if (dataSize <= 1) {
         return 0;
     }
 
-    const WaveformData* data = waveform->data();
+    const WaveformData* data = waveform->getLevelData(level);
     if (data == nullptr) {
         return 0;
     }
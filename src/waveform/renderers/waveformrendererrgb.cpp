@@ -8,6 +8,7 @@
 #include "widget/wwidget.h"
 #include "util/math.h"
 #include "util/painterscope.h"
+#include "util/timer.h"
 
 WaveformRendererRGB::WaveformRendererRGB(
         WaveformWidgetRenderer* waveformWidgetRenderer)
@@ -22,6 +23,7 @@ void WaveformRendererRGB::onSetup(const QDomNode& /* node */) {
 
 void WaveformRendererRGB::draw(QPainter* painter,
                                           QPaintEvent* /*event*/) {
+    ScopedTimer t("WaveformRendererRGB::draw");
     const TrackPointer trackInfo = m_waveformRenderer->getTrackInfo();
     if (!trackInfo) {
         return;
@@ -32,12 +34,14 @@ void WaveformRendererRGB::draw(QPainter* painter,
         return;
     }
 
-    const int dataSize = waveform->getDataSize();
+    // Zoomed out waveforms are drawn from a coarser level
+    const int level = selectWaveformLevel(*waveform);
+    const int dataSize = waveform->getLevelDataSize(level);
     if (dataSize <= 1) {
         return;
     }
 
-    const WaveformData* data = waveform->data();
+    const WaveformData* data = waveform->getLevelData(level);
     if (data == nullptr) {
         return;
     }
@@ -57,32 +61,68 @@ void WaveformRendererRGB::draw(QPainter* painter,
     const double firstVisualIndex = m_waveformRenderer->getFirstDisplayedPosition() * dataSize;
     const double lastVisualIndex = m_waveformRenderer->getLastDisplayedPosition() * dataSize;
 
-    const double offset = firstVisualIndex;
-
+    WaveformRGBRasterizer::Parameters parameters;
+    parameters.width = m_waveformRenderer->getLength();
+    parameters.height = m_waveformRenderer->getBreadth();
+    parameters.alignment = m_alignment;
     // Represents the # of waveform data points per horizontal pixel.
-    const double gain = (lastVisualIndex - firstVisualIndex) /
+    parameters.visualSamplesPerPixel = (lastVisualIndex - firstVisualIndex) /
             (double)m_waveformRenderer->getLength();
 
     // Per-band gain from the EQ knobs.
-    float allGain(1.0), lowGain(1.0), midGain(1.0), highGain(1.0);
-    getGains(&allGain, &lowGain, &midGain, &highGain);
+    getGains(&parameters.allGain,
+            &parameters.lowGain,
+            &parameters.midGain,
+            &parameters.highGain);
+    parameters.lowColor[0] = static_cast<float>(m_rgbLowColor_r);
+    parameters.lowColor[1] = static_cast<float>(m_rgbLowColor_g);
+    parameters.lowColor[2] = static_cast<float>(m_rgbLowColor_b);
+    parameters.midColor[0] = static_cast<float>(m_rgbMidColor_r);
+    parameters.midColor[1] = static_cast<float>(m_rgbMidColor_g);
+    parameters.midColor[2] = static_cast<float>(m_rgbMidColor_b);
+    parameters.highColor[0] = static_cast<float>(m_rgbHighColor_r);
+    parameters.highColor[1] = static_cast<float>(m_rgbHighColor_g);
+    parameters.highColor[2] = static_cast<float>(m_rgbHighColor_b);
+
+    // Draw reference line
+    const float halfBreadth = static_cast<float>(parameters.height) / 2.0f;
+    painter->setPen(m_pColors->getAxesColor());
+    painter->drawLine(QLineF(0, halfBreadth, m_waveformRenderer->getLength(), halfBreadth));
+
+    drawSignal(painter,
+            data,
+            dataSize,
+            firstVisualIndex,
+            math_max(1.0, 1.0 / m_waveformRenderer->getVisualSamplePerPixel()),
+            parameters);
+}
+
+// static
+void WaveformRendererRGB::drawSignal(QPainter* painter,
+        const WaveformData* data,
+        int dataSize,
+        double firstVisualIndex,
+        qreal penWidth,
+        const WaveformRGBRasterizer::Parameters& parameters) {
+    const double offset = firstVisualIndex;
+    const double gain = parameters.visualSamplesPerPixel;
+    const float allGain = parameters.allGain;
+    const float lowGain = parameters.lowGain;
+    const float midGain = parameters.midGain;
+    const float highGain = parameters.highGain;
 
     QColor color;
 
     QPen pen;
     pen.setCapStyle(Qt::FlatCap);
-    pen.setWidthF(math_max(1.0, 1.0 / m_waveformRenderer->getVisualSamplePerPixel()));
+    pen.setWidthF(penWidth);
 
-    const int breadth = m_waveformRenderer->getBreadth();
+    const int breadth = parameters.height;
     const float halfBreadth = static_cast<float>(breadth) / 2.0f;
 
     const float heightFactor = allGain * halfBreadth / sqrtf(255 * 255 * 3);
 
-    // Draw reference line
-    painter->setPen(m_pColors->getAxesColor());
-    painter->drawLine(QLineF(0, halfBreadth, m_waveformRenderer->getLength(), halfBreadth));
-
-    for (int x = 0; x < m_waveformRenderer->getLength(); ++x) {
+    for (int x = 0; x < parameters.width; ++x) {
         // Width of the x position in visual indices.
         const double xSampleWidth = gain * x;
 
@@ -141,9 +181,9 @@ void WaveformRendererRGB::draw(QPainter* painter,
         qreal maxMidF = maxMid * midGain;
         qreal maxHighF = maxHigh * highGain;
 
-        qreal red   = maxLowF * m_rgbLowColor_r + maxMidF * m_rgbMidColor_r + maxHighF * m_rgbHighColor_r;
-        qreal green = maxLowF * m_rgbLowColor_g + maxMidF * m_rgbMidColor_g + maxHighF * m_rgbHighColor_g;
-        qreal blue  = maxLowF * m_rgbLowColor_b + maxMidF * m_rgbMidColor_b + maxHighF * m_rgbHighColor_b;
+        qreal red   = maxLowF * parameters.lowColor[0] + maxMidF * parameters.midColor[0] + maxHighF * parameters.highColor[0];
+        qreal green = maxLowF * parameters.lowColor[1] + maxMidF * parameters.midColor[1] + maxHighF * parameters.highColor[1];
+        qreal blue  = maxLowF * parameters.lowColor[2] + maxMidF * parameters.midColor[2] + maxHighF * parameters.highColor[2];
 
         // Compute maximum (needed for value normalization)
         qreal max = math_max3(red, green, blue);
@@ -156,7 +196,7 @@ void WaveformRendererRGB::draw(QPainter* painter,
             pen.setColor(color);
 
             painter->setPen(pen);
-            switch (m_alignment) {
+            switch (parameters.alignment) {
                 case Qt::AlignBottom:
                 case Qt::AlignRight:
                     painter->drawLine(
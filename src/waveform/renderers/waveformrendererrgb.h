@@ -1,6 +1,7 @@
 #pragma once
 
 #include "util/class.h"
+#include "waveform/renderers/waveformrgbrasterizer.h"
 #include "waveformrenderersignalbase.h"
 
 class WaveformRendererRGB : public WaveformRendererSignalBase {
@@ -12,6 +13,17 @@ class WaveformRendererRGB : public WaveformRendererSignalBase {
     virtual void onSetup(const QDomNode& node);
     virtual void draw(QPainter* painter, QPaintEvent* event);
 
+    /// Draws one line per column x in [0, parameters.width), which shows
+    /// the visual samples around firstVisualIndex + x *
+    /// parameters.visualSamplesPerPixel. The size in the parameters is
+    /// given in the coordinates of the painter.
+    static void drawSignal(QPainter* painter,
+            const WaveformData* data,
+            int dataSize,
+            double firstVisualIndex,
+            qreal penWidth,
+            const WaveformRGBRasterizer::Parameters& parameters);
+
   private:
     DISALLOW_COPY_AND_ASSIGN(WaveformRendererRGB);
 };
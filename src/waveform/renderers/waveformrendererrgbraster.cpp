@@ -0,0 +1,133 @@
+#include "waveform/renderers/waveformrendererrgbraster.h"
+
+#include <cmath>
+
+#include "track/track.h"
+#include "util/painterscope.h"
+#include "util/timer.h"
+#include "waveform/renderers/waveformwidgetrenderer.h"
+
+WaveformRendererRGBRaster::WaveformRendererRGBRaster(
+        WaveformWidgetRenderer* waveformWidgetRenderer)
+        : WaveformRendererSignalBase(waveformWidgetRenderer),
+          m_level(0),
+          m_firstPixel(0),
+          m_pixelOffset(0.0),
+          m_renderPending(false) {
+}
+
+void WaveformRendererRGBRaster::onSetup(const QDomNode& /* node */) {
+}
+
+void WaveformRendererRGBRaster::onSetTrack() {
+    m_pWaveform.reset();
+    m_rasterizer.invalidate();
+}
+
+void WaveformRendererRGBRaster::prepareImage() {
+    m_renderPending = false;
+    m_pWaveform.reset();
+
+    const TrackPointer pTrack = m_waveformRenderer->getTrackInfo();
+    if (!pTrack || m_waveformRenderer->getTrackSamples() <= 0) {
+        return;
+    }
+    ConstWaveformPointer pWaveform = pTrack->getWaveform();
+    if (pWaveform.isNull()) {
+        return;
+    }
+    // Zoomed out waveforms are drawn from a coarser level
+    const int level = selectWaveformLevel(*pWaveform);
+    const int dataSize = pWaveform->getLevelDataSize(level);
+    if (dataSize <= 1 || pWaveform->getLevelData(level) == nullptr) {
+        return;
+    }
+
+    const qreal devicePixelRatio = m_waveformRenderer->getDevicePixelRatio();
+    const int width = static_cast<int>(
+            std::lround(m_waveformRenderer->getLength() * devicePixelRatio));
+    const int height = static_cast<int>(
+            std::lround(m_waveformRenderer->getBreadth() * devicePixelRatio));
+    if (width <= 0 || height <= 0) {
+        return;
+    }
+
+    const double firstVisualIndex = m_waveformRenderer->getFirstDisplayedPosition() * dataSize;
+    const double lastVisualIndex = m_waveformRenderer->getLastDisplayedPosition() * dataSize;
+    const double visualSamplesPerPixel = (lastVisualIndex - firstVisualIndex) / width;
+    if (visualSamplesPerPixel <= 0) {
+        return;
+    }
+
+    // The first column is only partially visible if the waveform is
+    // shifted by a fraction of a pixel
+    m_parameters.width = width + 1;
+    m_parameters.height = height;
+    m_parameters.devicePixelRatio = devicePixelRatio;
+    m_parameters.alignment = m_alignment;
+    m_parameters.visualSamplesPerPixel = visualSamplesPerPixel;
+    // Fetched on the GUI thread, because ControlProxys must not be used
+    // by the worker threads
+    getGains(&m_parameters.allGain,
+            &m_parameters.lowGain,
+            &m_parameters.midGain,
+            &m_parameters.highGain);
+    m_parameters.lowColor[0] = static_cast<float>(m_rgbLowColor_r);
+    m_parameters.lowColor[1] = static_cast<float>(m_rgbLowColor_g);
+    m_parameters.lowColor[2] = static_cast<float>(m_rgbLowColor_b);
+    m_parameters.midColor[0] = static_cast<float>(m_rgbMidColor_r);
+    m_parameters.midColor[1] = static_cast<float>(m_rgbMidColor_g);
+    m_parameters.midColor[2] = static_cast<float>(m_rgbMidColor_b);
+    m_parameters.highColor[0] = static_cast<float>(m_rgbHighColor_r);
+    m_parameters.highColor[1] = static_cast<float>(m_rgbHighColor_g);
+    m_parameters.highColor[2] = static_cast<float>(m_rgbHighColor_b);
+
+    m_pWaveform = pWaveform;
+    m_level = level;
+    // Columns are rendered at whole pixels to be reused while scrolling.
+    // The remaining fraction is applied when drawing, like the position
+    // of the columns in WaveformRendererRGB.
+    const double firstPixel = firstVisualIndex / visualSamplesPerPixel;
+    m_firstPixel = static_cast<qint64>(std::floor(firstPixel));
+    m_pixelOffset = firstPixel - static_cast<double>(m_firstPixel);
+    m_renderPending = true;
+}
+
+void WaveformRendererRGBRaster::renderImage() {
+    if (!m_renderPending) {
+        return;
+    }
+    m_renderPending = false;
+    ScopedTimer t("WaveformRendererRGBRaster::renderImage");
+    m_rasterizer.render(*m_pWaveform, m_level, m_parameters, m_firstPixel);
+}
+
+void WaveformRendererRGBRaster::draw(QPainter* painter, QPaintEvent* /*event*/) {
+    ScopedTimer t("WaveformRendererRGBRaster::draw");
+    // The image has not been rendered in advance if the widget is
+    // painted outside of the render loop of the WaveformWidgetFactory
+    renderImage();
+    if (m_pWaveform.isNull()) {
+        return;
+    }
+
+    PainterScope PainterScope(painter);
+
+    painter->setRenderHints(QPainter::Antialiasing, false);
+    // Interpolate the pixels that are shifted by a fraction of a pixel
+    painter->setRenderHints(QPainter::SmoothPixmapTransform, true);
+    painter->setWorldMatrixEnabled(false);
+    painter->resetTransform();
+
+    // Rotate if drawing vertical waveforms
+    if (m_waveformRenderer->getOrientation() == Qt::Vertical) {
+        painter->setTransform(QTransform(0, 1, 1, 0, 0, 0));
+    }
+
+    // Draw reference line
+    const float halfBreadth = static_cast<float>(m_waveformRenderer->getBreadth()) / 2.0f;
+    painter->setPen(m_pColors->getAxesColor());
+    painter->drawLine(QLineF(0, halfBreadth, m_waveformRenderer->getLength(), halfBreadth));
+
+    m_rasterizer.draw(painter, m_pixelOffset);
+}
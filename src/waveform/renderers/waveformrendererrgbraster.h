@@ -0,0 +1,42 @@
+#pragma once
+
+#include "util/class.h"
+#include "waveform/renderers/waveformrgbrasterizer.h"
+#include "waveform/waveform.h"
+#include "waveformrenderersignalbase.h"
+
+/// Renders the same waveform as WaveformRendererRGB, but rasterizes it into
+/// an image with WaveformRGBRasterizer and only renders the columns that have
+/// been scrolled into view.
+///
+/// The image is rendered by renderImage(), which the WaveformWidgetFactory
+/// invokes for all decks concurrently before the widgets are painted.
+/// draw() only copies the image into the widget.
+class WaveformRendererRGBRaster : public WaveformRendererSignalBase {
+  public:
+    explicit WaveformRendererRGBRaster(
+            WaveformWidgetRenderer* waveformWidgetRenderer);
+
+    void onSetup(const QDomNode& node) override;
+    void onSetTrack() override;
+    void draw(QPainter* painter, QPaintEvent* event) override;
+
+    /// Collects the parameters for the next frame. Must be called on the
+    /// GUI thread after the play position has been updated.
+    void prepareImage();
+    /// Renders the prepared frame. May be invoked on any thread, but not
+    /// concurrently with other member functions.
+    void renderImage();
+
+  private:
+    WaveformRGBRasterizer m_rasterizer;
+    ConstWaveformPointer m_pWaveform;
+    WaveformRGBRasterizer::Parameters m_parameters;
+    int m_level;
+    qint64 m_firstPixel;
+    // The fraction of a device pixel that the first pixel is scrolled out
+    double m_pixelOffset;
+    bool m_renderPending;
+
+    DISALLOW_COPY_AND_ASSIGN(WaveformRendererRGBRaster);
+};
@@ -2,6 +2,7 @@
 
 #include <QDomNode>
 
+#include "waveform/waveform.h"
 #include "waveform/waveformwidgetfactory.h"
 #include "waveformwidgetrenderer.h"
 #include "control/controlobject.h"
@@ -226,3 +227,15 @@ void WaveformRendererSignalBase::getGains(float* pAllGain, float* pLowGain,
         }
     }
 }
+
+int WaveformRendererSignalBase::selectWaveformLevel(const Waveform& waveform) const {
+    const int length = m_waveformRenderer->getLength();
+    if (length <= 0) {
+        return 0;
+    }
+    const double visualSamplesPerPixel =
+            (m_waveformRenderer->getLastDisplayedPosition() -
+                    m_waveformRenderer->getFirstDisplayedPosition()) *
+            waveform.getDataSize() / length;
+    return waveform.levelForVisualSamplesPerPixel(visualSamplesPerPixel);
+}
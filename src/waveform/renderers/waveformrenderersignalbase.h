@@ -6,6 +6,7 @@
 
 class ControlObject;
 class ControlProxy;
+class Waveform;
 
 class WaveformRendererSignalBase : public WaveformRendererAbstract {
 public:
@@ -24,6 +25,11 @@ public:
     void getGains(float* pAllGain, float* pLowGain, float* pMidGain,
                   float* highGain);
 
+    // Selects the level of the waveform pyramid that provides one to two
+    // visual frames per pixel at the current zoom. The render costs stay
+    // the same when zooming out.
+    int selectWaveformLevel(const Waveform& waveform) const;
+
   protected:
     ControlProxy* m_pEQEnabled;
     ControlProxy* m_pLowFilterControlObject;
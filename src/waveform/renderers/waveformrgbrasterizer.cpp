@@ -0,0 +1,280 @@
+#include "waveform/renderers/waveformrgbrasterizer.h"
+
+#include <QPainter>
+#include <algorithm>
+#include <cmath>
+
+#include "util/assert.h"
+#include "util/math.h"
+#include "waveform/waveform.h"
+
+namespace {
+
+// Tiny rounding differences of the zoom between two frames must not cause
+// rendering all columns again.
+constexpr double kVisualSamplesPerPixelTolerance = 1e-9;
+
+} // anonymous namespace
+
+WaveformRGBRasterizer::WaveformRGBRasterizer()
+        : m_pData(nullptr),
+          m_dataSize(0),
+          m_completion(0),
+          m_firstPixel(0),
+          m_endPixel(0),
+          m_dirtyFirstPixel(0),
+          m_dirtyEndPixel(0) {
+}
+
+void WaveformRGBRasterizer::invalidate() {
+    m_endPixel = m_firstPixel;
+}
+
+void WaveformRGBRasterizer::invalidateData(int beginIndex, int endIndex) {
+    // The visual samples of a column extend by up to one column and one
+    // visual frame to either side
+    const double visualSamplesPerPixel = m_parameters.visualSamplesPerPixel;
+    m_dirtyFirstPixel = static_cast<qint64>(std::floor(
+                                (beginIndex - visualSamplesPerPixel - 2) /
+                                visualSamplesPerPixel)) -
+            1;
+    m_dirtyEndPixel = static_cast<qint64>(std::ceil(
+                              (endIndex + visualSamplesPerPixel + 2) /
+                              visualSamplesPerPixel)) +
+            2;
+}
+
+int WaveformRGBRasterizer::render(const Waveform& waveform,
+        int level,
+        const Parameters& parameters,
+        qint64 firstPixel) {
+    VERIFY_OR_DEBUG_ASSERT(parameters.width > 0 && parameters.height > 0) {
+        return 0;
+    }
+    const WaveformData* pData = waveform.getLevelData(level);
+    const int dataSize = waveform.getLevelDataSize(level);
+    const int completion = waveform.getCompletion();
+
+    Parameters newParameters = parameters;
+    if (std::abs(newParameters.visualSamplesPerPixel - m_parameters.visualSamplesPerPixel) <=
+            kVisualSamplesPerPixelTolerance * m_parameters.visualSamplesPerPixel) {
+        newParameters.visualSamplesPerPixel = m_parameters.visualSamplesPerPixel;
+    }
+    if (newParameters != m_parameters ||
+            pData != m_pData ||
+            dataSize != m_dataSize) {
+        m_parameters = newParameters;
+        m_pData = pData;
+        m_dataSize = dataSize;
+        invalidate();
+    } else if (completion != m_completion && waveform.getDataSize() > 0) {
+        // The completion refers to the data of the finest level
+        const auto levelIndex = [&](int completionIndex) {
+            return static_cast<int>(static_cast<qint64>(completionIndex) *
+                    dataSize / waveform.getDataSize());
+        };
+        invalidateData(levelIndex(std::min(completion, m_completion)),
+                levelIndex(std::max(completion, m_completion)));
+    }
+    m_completion = completion;
+
+    if (m_image.width() != m_parameters.width || m_image.height() != m_parameters.height) {
+        m_image = QImage(m_parameters.width,
+                m_parameters.height,
+                QImage::Format_ARGB32_Premultiplied);
+        const auto width = static_cast<std::size_t>(m_parameters.width);
+        m_low.resize(width);
+        m_mid.resize(width);
+        m_high.resize(width);
+        m_maxAll.resize(width);
+        m_maxAllNext.resize(width);
+        m_colors.resize(width);
+        m_top.resize(width);
+        m_bottom.resize(width);
+        invalidate();
+    }
+    m_image.setDevicePixelRatio(m_parameters.devicePixelRatio);
+
+    const qint64 endPixel = firstPixel + m_parameters.width;
+    int renderedColumns = 0;
+    // Columns that are still visible, but whose data has changed
+    const qint64 dirtyFirstPixel = std::max({m_dirtyFirstPixel, m_firstPixel, firstPixel});
+    const qint64 dirtyEndPixel = std::min({m_dirtyEndPixel, m_endPixel, endPixel});
+    if (dirtyFirstPixel < dirtyEndPixel) {
+        renderPixels(dirtyFirstPixel, dirtyEndPixel);
+        renderedColumns += static_cast<int>(dirtyEndPixel - dirtyFirstPixel);
+    }
+    m_dirtyFirstPixel = 0;
+    m_dirtyEndPixel = 0;
+    if (firstPixel >= m_endPixel || endPixel <= m_firstPixel) {
+        renderPixels(firstPixel, endPixel);
+        renderedColumns = m_parameters.width;
+    } else {
+        // Only render the columns that have been scrolled into view
+        if (firstPixel < m_firstPixel) {
+            renderPixels(firstPixel, m_firstPixel);
+            renderedColumns += static_cast<int>(m_firstPixel - firstPixel);
+        }
+        if (endPixel > m_endPixel) {
+            renderPixels(m_endPixel, endPixel);
+            renderedColumns += static_cast<int>(endPixel - m_endPixel);
+        }
+    }
+    m_firstPixel = firstPixel;
+    m_endPixel = endPixel;
+    return renderedColumns;
+}
+
+int WaveformRGBRasterizer::ringColumn(qint64 pixel) const {
+    const qint64 column = pixel % m_image.width();
+    return static_cast<int>(column < 0 ? column + m_image.width() : column);
+}
+
+void WaveformRGBRasterizer::renderPixels(qint64 beginPixel, qint64 endPixel) {
+    qint64 pixel = beginPixel;
+    while (pixel < endPixel) {
+        // Split the range where it wraps around at the end of the image
+        const int column = ringColumn(pixel);
+        const int count = static_cast<int>(
+                std::min(endPixel - pixel, static_cast<qint64>(m_image.width() - column)));
+        renderColumns(pixel, column, count);
+        pixel += count;
+    }
+}
+
+void WaveformRGBRasterizer::renderColumns(qint64 firstPixel, int firstColumn, int count) {
+    const Parameters& p = m_parameters;
+
+    // Find the maximum of each band within the visual samples of each
+    // column like WaveformRendererRGB::draw()
+    const double maxSamplingRange = p.visualSamplesPerPixel / 2.0;
+    const int lastVisualFrame = m_dataSize / 2 - 1;
+    for (int i = 0; i < count; ++i) {
+        const double xVisualSampleIndex =
+                static_cast<double>(firstPixel + i) * p.visualSamplesPerPixel;
+        int visualFrameStart = int(xVisualSampleIndex / 2.0 - maxSamplingRange + 0.5);
+        int visualFrameStop = int(xVisualSampleIndex / 2.0 + maxSamplingRange + 0.5);
+        visualFrameStart = math_clamp(visualFrameStart, 0, lastVisualFrame);
+        visualFrameStop = math_clamp(visualFrameStop, 0, lastVisualFrame);
+        const int visualIndexStart = visualFrameStart * 2;
+        const int visualIndexStop = visualFrameStop * 2;
+
+        unsigned char maxLow = 0;
+        unsigned char maxMid = 0;
+        unsigned char maxHigh = 0;
+        float maxAll = 0;
+        float maxAllNext = 0;
+        for (int j = visualIndexStart;
+                j >= 0 && j + 1 < m_dataSize && j + 1 <= visualIndexStop;
+                j += 2) {
+            const WaveformData& waveformData = m_pData[j];
+            const WaveformData& waveformDataNext = m_pData[j + 1];
+            maxLow = math_max3(maxLow, waveformData.filtered.low, waveformDataNext.filtered.low);
+            maxMid = math_max3(maxMid, waveformData.filtered.mid, waveformDataNext.filtered.mid);
+            maxHigh = math_max3(maxHigh,
+                    waveformData.filtered.high,
+                    waveformDataNext.filtered.high);
+            const float low = waveformData.filtered.low * p.lowGain;
+            const float mid = waveformData.filtered.mid * p.midGain;
+            const float high = waveformData.filtered.high * p.highGain;
+            maxAll = math_max(maxAll, low * low + mid * mid + high * high);
+            const float lowNext = waveformDataNext.filtered.low * p.lowGain;
+            const float midNext = waveformDataNext.filtered.mid * p.midGain;
+            const float highNext = waveformDataNext.filtered.high * p.highGain;
+            maxAllNext = math_max(maxAllNext,
+                    lowNext * lowNext + midNext * midNext + highNext * highNext);
+        }
+        m_low[i] = maxLow * p.lowGain;
+        m_mid[i] = maxMid * p.midGain;
+        m_high[i] = maxHigh * p.highGain;
+        m_maxAll[i] = maxAll;
+        m_maxAllNext[i] = maxAllNext;
+    }
+
+    // Blend the colors of the bands and normalize them to full brightness.
+    // Branch free to allow the compiler to vectorize the loop.
+    for (int i = 0; i < count; ++i) {
+        const float red = m_low[i] * p.lowColor[0] + m_mid[i] * p.midColor[0] +
+                m_high[i] * p.highColor[0];
+        const float green = m_low[i] * p.lowColor[1] + m_mid[i] * p.midColor[1] +
+                m_high[i] * p.highColor[1];
+        const float blue = m_low[i] * p.lowColor[2] + m_mid[i] * p.midColor[2] +
+                m_high[i] * p.highColor[2];
+        const float max = std::max(red, std::max(green, blue));
+        const float scale = max > 0.0f ? 255.0f / max : 0.0f;
+        // Columns without signal stay transparent
+        const auto alpha = static_cast<QRgb>(max > 0.0f ? 0xff000000u : 0u);
+        m_colors[i] = alpha |
+                static_cast<QRgb>(red * scale) << 16 |
+                static_cast<QRgb>(green * scale) << 8 |
+                static_cast<QRgb>(blue * scale);
+    }
+
+    const float halfHeight = static_cast<float>(p.height) / 2.0f;
+    const float heightFactor = p.allGain * halfHeight / std::sqrt(255.0f * 255.0f * 3.0f);
+    switch (p.alignment) {
+    case Qt::AlignBottom:
+    case Qt::AlignRight:
+        for (int i = 0; i < count; ++i) {
+            m_top[i] = p.height -
+                    static_cast<int>(heightFactor *
+                            std::sqrt(std::max(m_maxAll[i], m_maxAllNext[i])));
+            m_bottom[i] = p.height;
+        }
+        break;
+    case Qt::AlignTop:
+    case Qt::AlignLeft:
+        for (int i = 0; i < count; ++i) {
+            m_top[i] = 0;
+            m_bottom[i] = static_cast<int>(heightFactor *
+                    std::sqrt(std::max(m_maxAll[i], m_maxAllNext[i])));
+        }
+        break;
+    default:
+        for (int i = 0; i < count; ++i) {
+            m_top[i] = static_cast<int>(halfHeight - heightFactor * std::sqrt(m_maxAll[i]));
+            m_bottom[i] = static_cast<int>(halfHeight + heightFactor * std::sqrt(m_maxAllNext[i]));
+        }
+    }
+
+    // Fill the columns scanline by scanline to write contiguous memory
+    uchar* pBits = m_image.bits();
+    const auto bytesPerLine = m_image.bytesPerLine();
+    for (int y = 0; y < p.height; ++y) {
+        QRgb* pLine = reinterpret_cast<QRgb*>(pBits + y * bytesPerLine) + firstColumn;
+        for (int i = 0; i < count; ++i) {
+            pLine[i] = (y >= m_top[i] && y < m_bottom[i]) ? m_colors[i] : 0u;
+        }
+    }
+}
+
+void WaveformRGBRasterizer::draw(QPainter* pPainter, qreal pixelOffset) const {
+    if (m_image.isNull() || m_firstPixel == m_endPixel) {
+        return;
+    }
+    const int width = m_image.width();
+    const int height = m_image.height();
+    const int column = ringColumn(m_firstPixel);
+    const qreal x = -pixelOffset / m_image.devicePixelRatio();
+    // The columns from the first pixel up to the end of the image are
+    // followed by the columns that wrapped around to the start
+    pPainter->drawImage(QPointF(x, 0), m_image, QRectF(column, 0, width - column, height));
+    if (column > 0) {
+        pPainter->drawImage(QPointF(x + (width - column) / m_image.devicePixelRatio(), 0),
+                m_image,
+                QRectF(0, 0, column, height));
+    }
+}
+
+QImage WaveformRGBRasterizer::toImage() const {
+    if (m_image.isNull()) {
+        return QImage();
+    }
+    QImage image(m_image.size(), m_image.format());
+    image.setDevicePixelRatio(m_image.devicePixelRatio());
+    image.fill(Qt::transparent);
+    QPainter painter(&image);
+    painter.setCompositionMode(QPainter::CompositionMode_Source);
+    draw(&painter);
+    return image;
+}
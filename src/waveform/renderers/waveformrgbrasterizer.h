@@ -0,0 +1,97 @@
+#pragma once
+
+#include <QImage>
+#include <QtGlobal>
+#include <vector>
+
+class QPainter;
+class Waveform;
+union WaveformData;
+
+/// Rasterizes RGB waveforms by writing the columns directly into the
+/// scanlines of a QImage instead of drawing one line per column with
+/// QPainter like WaveformRendererRGB.
+///
+/// The image is used as a ring buffer of columns. The column of the
+/// absolute pixel position p, i.e. the visual samples around
+/// p * visualSamplesPerPixel, is stored at p modulo the width of the image.
+/// While the waveform is scrolling only the newly exposed columns are
+/// rendered. All columns are rendered again when the parameters or the
+/// data of the waveform change. While the waveform is analyzed only the
+/// columns of the newly analyzed data are rendered again.
+///
+/// An instance must only be used by one thread at a time, but different
+/// instances may render concurrently.
+class WaveformRGBRasterizer {
+  public:
+    struct Parameters {
+        /// The size of the image in device pixels
+        int width = 0;
+        int height = 0;
+        qreal devicePixelRatio = 1.0;
+        Qt::Alignment alignment = Qt::AlignCenter;
+        /// The number of visual samples of the rendered level per device pixel
+        double visualSamplesPerPixel = 0.0;
+        float allGain = 1.0f;
+        float lowGain = 1.0f;
+        float midGain = 1.0f;
+        float highGain = 1.0f;
+        /// The red, green and blue components of the bands in the range [0, 1]
+        float lowColor[3] = {};
+        float midColor[3] = {};
+        float highColor[3] = {};
+
+        bool operator==(const Parameters& other) const = default;
+    };
+
+    WaveformRGBRasterizer();
+
+    /// Renders the pixels [firstPixel, firstPixel + parameters.width) from
+    /// the given level of the waveform. Returns the number of columns that
+    /// had to be rendered.
+    int render(const Waveform& waveform,
+            int level,
+            const Parameters& parameters,
+            qint64 firstPixel);
+
+    /// Draws the pixels of the last render() call from left to right,
+    /// starting at the origin of the painter. The image is shifted to the
+    /// left by the fraction of a device pixel given by pixelOffset.
+    void draw(QPainter* pPainter, qreal pixelOffset = 0.0) const;
+
+    /// Renders all columns with the next call of render().
+    void invalidate();
+
+    /// Returns a copy of the image with the columns in display order.
+    /// Used for testing only.
+    QImage toImage() const;
+
+  private:
+    int ringColumn(qint64 pixel) const;
+    void invalidateData(int beginIndex, int endIndex);
+    void renderPixels(qint64 beginPixel, qint64 endPixel);
+    void renderColumns(qint64 firstPixel, int firstColumn, int count);
+
+    Parameters m_parameters;
+    const WaveformData* m_pData;
+    int m_dataSize;
+    int m_completion;
+
+    QImage m_image;
+    // The range of absolute pixel positions that is stored in the image
+    qint64 m_firstPixel;
+    qint64 m_endPixel;
+    // The range of absolute pixel positions whose data has changed
+    qint64 m_dirtyFirstPixel;
+    qint64 m_dirtyEndPixel;
+
+    // Intermediate values per column, kept to avoid allocations
+    std::vector<float> m_low;
+    std::vector<float> m_mid;
+    std::vector<float> m_high;
+    std::vector<float> m_maxAll;
+    std::vector<float> m_maxAllNext;
+    std::vector<QRgb> m_colors;
+    std::vector<int> m_top;
+    std::vector<int> m_bottom;
+};
@@ -1,12 +1,70 @@
+#include <QFile>
+#include <QSaveFile>
 #include <QtDebug>
+#include <algorithm>
+#include <cstring>
+#include <numeric>
 
 #include "waveform/waveform.h"
 #include "proto/waveform.pb.h"
+#include "util/assert.h"
 
 using namespace mixxx::track;
 
 constexpr int kNumChannels = 2;
 
+// The mappable file is a local cache and uses the native byte order
+constexpr char kMappableFileMagic[8] = {'M', 'X', 'X', 'X', 'W', 'A', 'V', 'E'};
+constexpr quint32 kMappableFileByteOrderMark = 0x01020304;
+
+// The coarsest level must still cover a few pixels
+constexpr int kMinLevelFrames = 32;
+
+// The data sizes of the coarser levels starting with level 1
+std::vector<int> levelDataSizes(int dataSize) {
+    std::vector<int> dataSizes;
+    int frames = dataSize / kNumChannels;
+    while (static_cast<int>(dataSizes.size()) + 1 < Waveform::kMaxLevelCount) {
+        frames = (frames + 1) / 2;
+        if (frames < kMinLevelFrames) {
+            break;
+        }
+        dataSizes.push_back(frames * kNumChannels);
+    }
+    return dataSizes;
+}
+
+// Combines pairs of visual frames
+void reduceLevel(const WaveformData* pSrc,
+        int srcDataSize,
+        WaveformData* pDest,
+        int destDataSize) {
+    for (int i = 0; i < destDataSize; ++i) {
+        const int channel = i % kNumChannels;
+        const int srcIndex = (i - channel) * 2 + channel;
+        WaveformData datum(0);
+        for (int j = srcIndex; j <= srcIndex + kNumChannels && j < srcDataSize;
+                j += kNumChannels) {
+            const WaveformData& src = pSrc[j];
+            datum.filtered.low = std::max(datum.filtered.low, src.filtered.low);
+            datum.filtered.mid = std::max(datum.filtered.mid, src.filtered.mid);
+            datum.filtered.high = std::max(datum.filtered.high, src.filtered.high);
+            datum.filtered.all = std::max(datum.filtered.all, src.filtered.all);
+        }
+        pDest[i] = datum;
+    }
+}
+
+qint64 levelDataBytes(int dataSize, int levelCount) {
+    if (levelCount <= 1) {
+        return 0;
+    }
+    const auto dataSizes = levelDataSizes(dataSize);
+    DEBUG_ASSERT(levelCount == static_cast<int>(dataSizes.size()) + 1);
+    return static_cast<qint64>(std::accumulate(dataSizes.begin(), dataSizes.end(), 0)) *
+            sizeof(WaveformData);
+}
+
 // Return the smallest power of 2 which is greater than the desired size when
 // squared.
 int computeTextureStride(int size) {
@@ -17,10 +75,30 @@ int computeTextureStride(int size) {
     return stride;
 }
 
+struct Waveform::MappableFileHeader {
+    char magic[8];
+    quint32 byteOrderMark;
+    quint32 formatVersion;
+    quint32 headerSize;
+    // Identifies the compressed analysis this file has been created from
+    quint32 sourceChecksum;
+    qint32 dataSize;
+    qint32 textureStride;
+    double visualSampleRate;
+    double audioVisualRatio;
+    // Including level 0. The coarser levels are stored between the header
+    // and the data of level 0.
+    qint32 levelCount;
+    char reserved[12];
+};
+
 Waveform::Waveform(const QByteArray& data)
         : m_id(-1),
           m_saveState(SaveState::NotSaved),
           m_dataSize(0),
+          m_pData(nullptr),
+          m_textureSize(0),
+          m_levelCount(1),
           m_visualSampleRate(0),
           m_audioVisualRatio(0),
           m_textureStride(computeTextureStride(0)),
@@ -33,6 +111,9 @@ Waveform::Waveform(int audioSampleRate, int audioSamples,
         : m_id(-1),
           m_saveState(SaveState::NotSaved),
           m_dataSize(0),
+          m_pData(nullptr),
+          m_textureSize(0),
+          m_levelCount(1),
           m_visualSampleRate(0),
           m_audioVisualRatio(0),
           m_textureStride(1024),
@@ -64,7 +145,164 @@ Waveform::Waveform(int audioSampleRate, int audioSamples,
     setCompletion(0);
 }
 
+Waveform::Waveform(std::unique_ptr<QFile> pMappedFile,
+        const MappableFileHeader& header,
+        WaveformData* pMappedData,
+        std::vector<Level> mappedLevels)
+        : m_id(-1),
+          m_saveState(SaveState::Saved),
+          m_dataSize(header.dataSize),
+          m_pData(pMappedData),
+          m_textureSize(header.textureStride * header.textureStride),
+          m_pMappedFile(std::move(pMappedFile)),
+          m_levels(std::move(mappedLevels)),
+          m_levelCount(static_cast<int>(m_levels.size()) + 1),
+          m_visualSampleRate(header.visualSampleRate),
+          m_audioVisualRatio(header.audioVisualRatio),
+          m_textureStride(header.textureStride),
+          m_completion(header.dataSize) {
+}
+
 Waveform::~Waveform() {
+    // The mapping is released when closing the file
+}
+
+// static
+bool Waveform::readMappableFileHeader(QFile* pFile,
+        quint32 sourceChecksum,
+        MappableFileHeader* pHeader) {
+    static_assert(sizeof(MappableFileHeader) == 64,
+            "The waveform data that follows the header must be aligned");
+    if (pFile->read(reinterpret_cast<char*>(pHeader), sizeof(MappableFileHeader)) !=
+            sizeof(MappableFileHeader)) {
+        return false;
+    }
+    if (std::memcmp(pHeader->magic, kMappableFileMagic, sizeof(kMappableFileMagic)) != 0 ||
+            pHeader->byteOrderMark != kMappableFileByteOrderMark ||
+            pHeader->headerSize != sizeof(MappableFileHeader)) {
+        qWarning() << "Invalid mappable waveform file" << pFile->fileName();
+        return false;
+    }
+    if (pHeader->formatVersion != kMappableFileFormatVersion ||
+            pHeader->sourceChecksum != sourceChecksum) {
+        // Outdated, needs to be recreated
+        return false;
+    }
+    if (pHeader->dataSize < 0 ||
+            pHeader->textureStride != computeTextureStride(pHeader->dataSize) ||
+            !(pHeader->visualSampleRate > 0) ||
+            !(pHeader->audioVisualRatio > 0) ||
+            (pHeader->levelCount != 1 &&
+                    pHeader->levelCount !=
+                            static_cast<int>(levelDataSizes(pHeader->dataSize).size()) +
+                                    1)) {
+        qWarning() << "Corrupt mappable waveform file" << pFile->fileName();
+        return false;
+    }
+    const qint64 fileSize = sizeof(MappableFileHeader) +
+            levelDataBytes(pHeader->dataSize, pHeader->levelCount) +
+            static_cast<qint64>(pHeader->textureStride) * pHeader->textureStride *
+                    sizeof(WaveformData);
+    if (pFile->size() < fileSize) {
+        qWarning() << "Truncated mappable waveform file" << pFile->fileName();
+        return false;
+    }
+    return true;
+}
+
+// static
+bool Waveform::isMappableFile(const QString& fileName, quint32 sourceChecksum) {
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    MappableFileHeader header;
+    return readMappableFileHeader(&file, sourceChecksum, &header);
+}
+
+// static
+Waveform* Waveform::mapFile(const QString& fileName, quint32 sourceChecksum) {
+    auto pFile = std::make_unique<QFile>(fileName);
+    if (!pFile->open(QIODevice::ReadOnly)) {
+        return nullptr;
+    }
+    MappableFileHeader header;
+    if (!readMappableFileHeader(pFile.get(), sourceChecksum, &header)) {
+        return nullptr;
+    }
+    const qint64 levelBytes = levelDataBytes(header.dataSize, header.levelCount);
+    const qint64 dataBytes = static_cast<qint64>(header.textureStride) *
+            header.textureStride * sizeof(WaveformData);
+    // Private mappings are copy-on-write and the file is never modified
+    uchar* pMapped = pFile->map(0,
+            sizeof(MappableFileHeader) + levelBytes + dataBytes,
+            QFileDevice::MapPrivateOption);
+    if (!pMapped) {
+        qWarning() << "Failed to map waveform file" << fileName
+                   << pFile->errorString();
+        return nullptr;
+    }
+    std::vector<Level> levels;
+    const auto* pLevelData = reinterpret_cast<const WaveformData*>(
+            pMapped + sizeof(MappableFileHeader));
+    if (header.levelCount > 1) {
+        const auto dataSizes = levelDataSizes(header.dataSize);
+        levels.reserve(dataSizes.size());
+        for (int dataSize : dataSizes) {
+            levels.push_back(Level{pLevelData, dataSize});
+            pLevelData += dataSize;
+        }
+    }
+    auto* pMappedData = reinterpret_cast<WaveformData*>(
+            pMapped + sizeof(MappableFileHeader) + levelBytes);
+    return new Waveform(std::move(pFile), header, pMappedData, std::move(levels));
+}
+
+bool Waveform::writeMappableFile(const QString& fileName, quint32 sourceChecksum) const {
+    VERIFY_OR_DEBUG_ASSERT(m_textureSize == m_textureStride * m_textureStride) {
+        return false;
+    }
+    MappableFileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, kMappableFileMagic, sizeof(kMappableFileMagic));
+    header.byteOrderMark = kMappableFileByteOrderMark;
+    header.formatVersion = kMappableFileFormatVersion;
+    header.headerSize = sizeof(MappableFileHeader);
+    header.sourceChecksum = sourceChecksum;
+    header.dataSize = m_dataSize;
+    header.textureStride = m_textureStride;
+    header.visualSampleRate = m_visualSampleRate;
+    header.audioVisualRatio = m_audioVisualRatio;
+    const int levelCount = getLevelCount();
+    header.levelCount = levelCount;
+
+    // QSaveFile writes to a temp file and atomically renames it over the
+    // existing file on commit(). Existing mappings of the replaced file stay
+    // valid on POSIX systems and readers never see a partially written file.
+    QSaveFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+    bool success = file.write(reinterpret_cast<const char*>(&header),
+                           sizeof(header)) == sizeof(header);
+    for (int level = 1; success && level < levelCount; ++level) {
+        const qint64 bytes = static_cast<qint64>(getLevelDataSize(level)) *
+                sizeof(WaveformData);
+        success = file.write(reinterpret_cast<const char*>(getLevelData(level)),
+                          bytes) == bytes;
+    }
+    const qint64 dataBytes = static_cast<qint64>(m_dataSize) * sizeof(WaveformData);
+    const qint64 fileSize = sizeof(MappableFileHeader) +
+            levelDataBytes(m_dataSize, levelCount) +
+            static_cast<qint64>(m_textureSize) * sizeof(WaveformData);
+    if (!success ||
+            file.write(reinterpret_cast<const char*>(m_pData), dataBytes) !=
+                    dataBytes ||
+            !file.resize(fileSize)) {
+        file.cancelWriting();
+        return false;
+    }
+    return file.commit();
 }
 
 QByteArray Waveform::toByteArray() const {
@@ -108,13 +346,22 @@ QByteArray Waveform::toByteArray() const {
 
     int dataSize = getDataSize();
     for (int i = 0; i < dataSize; ++i) {
-        const WaveformData& datum = m_data.at(i);
+        const WaveformData& datum = m_pData[i];
         all->add_value(datum.filtered.all);
         low->add_value(datum.filtered.low);
         mid->add_value(datum.filtered.mid);
         high->add_value(datum.filtered.high);
     }
 
+    // WaveformData only consists of bytes and is stored independent of
+    // the byte order
+    static_assert(sizeof(WaveformData) == 4);
+    const int levelCount = getLevelCount();
+    for (int level = 1; level < levelCount; ++level) {
+        waveform.add_levels(getLevelData(level),
+                getLevelDataSize(level) * sizeof(WaveformData));
+    }
+
     qDebug() << "Writing waveform from byte array:"
              << "dataSize" << dataSize
              << "allSignalSize" << all->value_size()
@@ -193,26 +440,93 @@ void Waveform::readByteArray(const QByteArray& data) {
         m_data[i].filtered.mid = use_mid ? static_cast<unsigned char>(mid.value(i)) : 0;
         m_data[i].filtered.high = use_high ? static_cast<unsigned char>(high.value(i)) : 0;
     }
+    if (waveform.levels_size() > 0) {
+        const auto dataSizes = levelDataSizes(dataSize);
+        bool levelsValid = waveform.levels_size() == static_cast<int>(dataSizes.size());
+        for (int i = 0; levelsValid && i < waveform.levels_size(); ++i) {
+            levelsValid = waveform.levels(i).size() ==
+                    dataSizes[i] * sizeof(WaveformData);
+        }
+        if (levelsValid) {
+            m_levelData.resize(std::accumulate(dataSizes.begin(), dataSizes.end(), 0));
+            WaveformData* pLevelData = m_levelData.data();
+            m_levels.reserve(dataSizes.size());
+            for (int i = 0; i < waveform.levels_size(); ++i) {
+                std::memcpy(pLevelData,
+                        waveform.levels(i).data(),
+                        waveform.levels(i).size());
+                m_levels.push_back(Level{pLevelData, dataSizes[i]});
+                pLevelData += dataSizes[i];
+            }
+            m_levelCount.storeRelease(static_cast<int>(m_levels.size()) + 1);
+        } else {
+            qDebug() << "WARNING: Ignoring waveform levels with unexpected sizes.";
+        }
+    }
+
     m_completion = dataSize;
     m_saveState = SaveState::Saved;
 }
 
+void Waveform::buildLevels() {
+    VERIFY_OR_DEBUG_ASSERT(getLevelCount() == 1) {
+        return;
+    }
+    const auto dataSizes = levelDataSizes(m_dataSize);
+    if (dataSizes.empty()) {
+        return;
+    }
+    m_levelData.resize(std::accumulate(dataSizes.begin(), dataSizes.end(), 0));
+    m_levels.reserve(dataSizes.size());
+    const WaveformData* pSrc = m_pData;
+    int srcDataSize = m_dataSize;
+    WaveformData* pDest = m_levelData.data();
+    for (int dataSize : dataSizes) {
+        reduceLevel(pSrc, srcDataSize, pDest, dataSize);
+        m_levels.push_back(Level{pDest, dataSize});
+        pSrc = pDest;
+        srcDataSize = dataSize;
+        pDest += dataSize;
+    }
+    // Publish the new levels for concurrent renderers
+    m_levelCount.storeRelease(static_cast<int>(m_levels.size()) + 1);
+}
+
+int Waveform::levelForVisualSamplesPerPixel(double visualSamplesPerPixel) const {
+    const int levelCount = getLevelCount();
+    // Two visual samples per visual frame
+    double visualFramesPerPixel = visualSamplesPerPixel / kNumChannels;
+    int level = 0;
+    while (level + 1 < levelCount && visualFramesPerPixel >= 2.0) {
+        visualFramesPerPixel /= 2.0;
+        ++level;
+    }
+    return level;
+}
+
 void Waveform::resize(int size) {
+    DEBUG_ASSERT(!m_pMappedFile);
     m_dataSize = size;
     m_textureStride = computeTextureStride(size);
     m_data.resize(m_textureStride * m_textureStride);
+    m_pData = m_data.data();
+    m_textureSize = static_cast<int>(m_data.size());
 }
 
 void Waveform::assign(int size, int value) {
+    DEBUG_ASSERT(!m_pMappedFile);
     m_dataSize = size;
     m_textureStride = computeTextureStride(size);
     m_data.assign(m_textureStride * m_textureStride, value);
+    m_pData = m_data.data();
+    m_textureSize = static_cast<int>(m_data.size());
     m_saveState = SaveState::SavePending;
 }
 
 void Waveform::dump() const {
     qDebug() << "Waveform" << this
              << "size("+QString::number(getDataSize())+")"
+             << "mapped("+QString::number(isMapped())+")"
              << "textureStride("+QString::number(m_textureStride)+")"
              << "completion("+QString::number(getCompletion())+")"
              << "visualSampleRate("+QString::number(m_visualSampleRate)+")"
@@ -5,11 +5,15 @@
 #include <QMutex>
 #include <QSharedPointer>
 #include <QString>
+#include <memory>
 #include <vector>
 
+#include "util/assert.h"
 #include "util/class.h"
 #include "util/compatibility/qmutex.h"
 
+class QFile;
+
 enum FilterIndex { Low = 0, Mid = 1, High = 2, FilterCount = 3};
 enum ChannelIndex { Left = 0, Right = 1, ChannelCount = 2};
 
@@ -34,12 +38,69 @@ class Waveform {
         Saved
     };
 
+    /// Version of the uncompressed file format for memory-mapping, see
+    /// writeMappableFile(). Files with a different version are ignored.
+    static constexpr quint32 kMappableFileFormatVersion = 2;
+
+    /// Upper bound for the number of levels of the pyramid, including
+    /// the full-resolution level 0.
+    static constexpr int kMaxLevelCount = 16;
+
     explicit Waveform(const QByteArray& pData = QByteArray());
     Waveform(int audioSampleRate, int audioSamples,
              int desiredVisualSampleRate, int maxVisualSamples);
 
     virtual ~Waveform();
 
+    /// Maps a file that has been written by writeMappableFile() into
+    /// memory instead of reading it. Returns nullptr if the file does not
+    /// exist, is invalid, or was created from a different source, i.e.
+    /// sourceChecksum doesn't match.
+    ///
+    /// The mapping is private and copy-on-write. The file is neither
+    /// decompressed nor copied and pages are only loaded on access.
+    static Waveform* mapFile(const QString& fileName, quint32 sourceChecksum);
+
+    /// Checks if the header of a mappable file is valid without mapping
+    /// the whole file.
+    static bool isMappableFile(const QString& fileName, quint32 sourceChecksum);
+
+    /// Writes the raw data including the texture padding together with a
+    /// fixed-size header. The padding is appended by resizing the file, so
+    /// it occupies no disk space on file systems that support sparse files.
+    bool writeMappableFile(const QString& fileName, quint32 sourceChecksum) const;
+
+    bool isMapped() const {
+        return static_cast<bool>(m_pMappedFile);
+    }
+
+    /// Builds a pyramid of coarser levels from the complete data for
+    /// rendering zoomed out waveforms. Each level combines two visual frames
+    /// of the previous level by taking the maximum of each band and channel.
+    ///
+    /// Must only be invoked once. Renderers may access the waveform
+    /// concurrently and will pick up the new levels when they are ready.
+    void buildLevels();
+
+    /// The number of levels including the full-resolution level 0.
+    int getLevelCount() const {
+        return m_levelCount.loadAcquire();
+    }
+
+    /// Selects the coarsest level that still provides at least one visual
+    /// frame per pixel, i.e. between one and two.
+    int levelForVisualSamplesPerPixel(double visualSamplesPerPixel) const;
+
+    const WaveformData* getLevelData(int level) const {
+        DEBUG_ASSERT(level >= 0 && level < getLevelCount());
+        return level == 0 ? m_pData : m_levels[level - 1].pData;
+    }
+
+    int getLevelDataSize(int level) const {
+        DEBUG_ASSERT(level >= 0 && level < getLevelCount());
+        return level == 0 ? m_dataSize : m_levels[level - 1].dataSize;
+    }
+
     int getId() const {
         const auto locker = lockMutex(&m_mutex);
         return m_id;
@@ -109,39 +170,53 @@ class Waveform {
 
     // We do not lock the mutex since m_data is not resized after the
     // constructor runs.
-    inline int getTextureSize() const { return static_cast<int>(m_data.size()); }
+    inline int getTextureSize() const { return m_textureSize; }
 
     // Atomically get the number of data elements in this Waveform. We do not
     // lock the mutex since m_dataSize is not changed after the constructor
     // runs.
     inline int getDataSize() const { return m_dataSize; }
 
-    inline const WaveformData& get(int i) const { return m_data[i];}
-    inline unsigned char getLow(int i) const { return m_data[i].filtered.low;}
-    inline unsigned char getMid(int i) const { return m_data[i].filtered.mid;}
-    inline unsigned char getHigh(int i) const { return m_data[i].filtered.high;}
-    inline unsigned char getAll(int i) const { return m_data[i].filtered.all;}
+    inline const WaveformData& get(int i) const { return m_pData[i];}
+    inline unsigned char getLow(int i) const { return m_pData[i].filtered.low;}
+    inline unsigned char getMid(int i) const { return m_pData[i].filtered.mid;}
+    inline unsigned char getHigh(int i) const { return m_pData[i].filtered.high;}
+    inline unsigned char getAll(int i) const { return m_pData[i].filtered.all;}
 
     // We do not lock the mutex since m_data is not resized after the
     // constructor runs.
-    WaveformData* data() { return &m_data[0];}
+    WaveformData* data() { return m_pData;}
 
     // We do not lock the mutex since m_data is not resized after the
     // constructor runs.
-    const WaveformData* data() const { return &m_data[0];}
+    const WaveformData* data() const { return m_pData;}
 
     void dump() const;
 
   private:
+    struct MappableFileHeader;
+    struct Level {
+        const WaveformData* pData;
+        int dataSize;
+    };
+
+    Waveform(std::unique_ptr<QFile> pMappedFile,
+            const MappableFileHeader& header,
+            WaveformData* pMappedData,
+            std::vector<Level> mappedLevels);
+    static bool readMappableFileHeader(QFile* pFile,
+            quint32 sourceChecksum,
+            MappableFileHeader* pHeader);
+
     void readByteArray(const QByteArray& data);
     void resize(int size);
     void assign(int size, int value = 0);
 
-    inline WaveformData& at(int i) { return m_data[i];}
-    inline unsigned char& low(int i) { return m_data[i].filtered.low;}
-    inline unsigned char& mid(int i) { return m_data[i].filtered.mid;}
-    inline unsigned char& high(int i) { return m_data[i].filtered.high;}
-    inline unsigned char& all(int i) { return m_data[i].filtered.all;}
+    inline WaveformData& at(int i) { return m_pData[i];}
+    inline unsigned char& low(int i) { return m_pData[i].filtered.low;}
+    inline unsigned char& mid(int i) { return m_pData[i].filtered.mid;}
+    inline unsigned char& high(int i) { return m_pData[i].filtered.high;}
+    inline unsigned char& all(int i) { return m_pData[i].filtered.all;}
     double getVisualSampleRate() const { return m_visualSampleRate; }
 
     // If stored in the database, the ID of the waveform.
@@ -162,6 +237,19 @@ class Waveform {
     // TODO(XXX): In the future we should switch to QVector and use the raw data
     // pointer when performance matters.
     std::vector<WaveformData> m_data;
+    // Either points to m_data or into the memory-mapped file, which then
+    // stays open for the lifetime of the Waveform. Not allowed to change
+    // after the constructor runs.
+    WaveformData* m_pData;
+    int m_textureSize;
+    std::unique_ptr<QFile> m_pMappedFile;
+
+    // Storage for the coarser levels unless mapped from a file
+    std::vector<WaveformData> m_levelData;
+    // The coarser levels starting with level 1. Not modified after they
+    // have been published by updating m_levelCount.
+    std::vector<Level> m_levels;
+    QAtomicInt m_levelCount;
     // Not allowed to change after the constructor runs.
     double m_visualSampleRate;
     // Not allowed to change after the constructor runs.
@@ -6,7 +6,35 @@
 // static
 Waveform* WaveformFactory::loadWaveformFromAnalysis(
         const AnalysisDao::AnalysisInfo& analysis) {
-    Waveform* pWaveform = new Waveform(analysis.data);
+    Waveform* pWaveform = nullptr;
+    if (!analysis.mappedDataPath.isEmpty()) {
+        pWaveform = Waveform::mapFile(analysis.mappedDataPath, analysis.dataChecksum);
+    }
+    if (!pWaveform) {
+        QByteArray data = analysis.data;
+        if (data.isEmpty() && !analysis.mappedDataPath.isEmpty()) {
+            // The mapped file has been modified or removed after
+            // AnalysisDao has skipped loading the compressed data
+            data = AnalysisDao::loadAnalysisData(
+                    analysis.dataPath, analysis.dataChecksum);
+        }
+        pWaveform = new Waveform(data);
+        if (analysis.type == AnalysisDao::TYPE_WAVEFORM &&
+                pWaveform->isValid() &&
+                pWaveform->getLevelCount() == 1) {
+            // Stored before the waveform levels have been introduced
+            pWaveform->buildLevels();
+        }
+        if (!analysis.mappedDataPath.isEmpty() && pWaveform->isValid()) {
+            // Migrate the compressed analysis. The next time the
+            // waveform will be mapped without decompressing it.
+            if (!pWaveform->writeMappableFile(
+                        analysis.mappedDataPath, analysis.dataChecksum)) {
+                qWarning() << "Failed to write mapped waveform file"
+                           << analysis.mappedDataPath;
+            }
+        }
+    }
     pWaveform->setId(analysis.analysisId);
     pWaveform->setVersion(analysis.version);
     pWaveform->setDescription(analysis.description);
@@ -5,9 +5,11 @@
 #include <QGuiApplication>
 #include <QOpenGLFunctions>
 #include <QStringList>
+#include <QThread>
 #include <QTime>
 #include <QWidget>
 #include <QWindow>
+#include <QtConcurrentRun>
 #include <QtDebug>
 
 #include "control/controlpotmeter.h"
@@ -33,6 +35,7 @@
 #include "waveform/widgets/qtsimplewaveformwidget.h"
 #include "waveform/widgets/qtvsynctestwidget.h"
 #include "waveform/widgets/qtwaveformwidget.h"
+#include "waveform/widgets/rgbrasterwaveformwidget.h"
 #include "waveform/widgets/rgbwaveformwidget.h"
 #include "waveform/widgets/softwarewaveformwidget.h"
 #include "widget/wvumeter.h"
@@ -125,6 +128,11 @@ WaveformWidgetFactory::WaveformWidgetFactory()
     m_visualGain[Mid] = 1.0;
     m_visualGain[High] = 1.0;
 
+    // One deck is rendered on the GUI thread while waiting for the others
+    m_offscreenRenderThreadPool.setObjectName(QStringLiteral("WaveformOffscreenRender"));
+    m_offscreenRenderThreadPool.setMaxThreadCount(
+            math_max(1, QThread::idealThreadCount() - 1));
+
     QGLWidget* pGlWidget = SharedGLContext::getWidget();
     if (pGlWidget && pGlWidget->isValid()) {
         // will be false if SafeMode is enabled
@@ -652,6 +660,7 @@ void WaveformWidgetFactory::render() {
             // next rendered frame is displayed after next buffer swap and than after VSync
             QVarLengthArray<bool, 10> shouldRenderWaveforms(
                     static_cast<int>(m_waveformWidgetHolders.size()));
+            QVarLengthArray<WaveformWidgetAbstract*, 10> offscreenWaveforms;
             for (decltype(m_waveformWidgetHolders)::size_type i = 0;
                     i < m_waveformWidgetHolders.size();
                     i++) {
@@ -665,9 +674,14 @@ void WaveformWidgetFactory::render() {
                 }
                 // Calculate play position for the new Frame in following run
                 pWaveformWidget->preRender(m_vsyncThread);
+                if (pWaveformWidget->hasOffscreenRendering()) {
+                    offscreenWaveforms.append(pWaveformWidget);
+                }
             }
             //qDebug() << "prerender" << m_vsyncThread->elapsed();
 
+            renderOffscreen(offscreenWaveforms);
+
             // It may happen that there is an artificially delayed due to
             // anti tearing driver settings
             // all render commands are delayed until the swap from the previous run is executed
@@ -713,6 +727,27 @@ void WaveformWidgetFactory::render() {
     m_vsyncThread->vsyncSlotFinished();
 }
 
+void WaveformWidgetFactory::renderOffscreen(
+        const QVarLengthArray<WaveformWidgetAbstract*, 10>& waveformWidgets) {
+    if (waveformWidgets.isEmpty()) {
+        return;
+    }
+    ScopedTimer t("WaveformWidgetFactory::renderOffscreen() %1waveforms",
+            waveformWidgets.size());
+    QVarLengthArray<QFuture<void>, 10> futures;
+    for (int i = 0; i < waveformWidgets.size() - 1; ++i) {
+        futures.append(QtConcurrent::run(&m_offscreenRenderThreadPool,
+                [pWaveformWidget = waveformWidgets[i]] {
+                    pWaveformWidget->renderOffscreen();
+                }));
+    }
+    // Use this thread instead of waiting idle
+    waveformWidgets.last()->renderOffscreen();
+    for (auto& future : futures) {
+        future.waitForFinished();
+    }
+}
+
 void WaveformWidgetFactory::swap() {
     ScopedTimer t("WaveformWidgetFactory::swap() %1waveforms",
             static_cast<int>(m_waveformWidgetHolders.size()));
@@ -819,6 +854,17 @@ void WaveformWidgetFactory::evaluateWidgets() {
             useOpenGLShaders = RGBWaveformWidget::useOpenGLShaders();
             developerOnly = RGBWaveformWidget::developerOnly();
             break;
+#endif
+        case WaveformWidgetType::RGBRasterWaveform:
+#ifdef __APPLE__
+            continue;
+#else
+            widgetName = RGBRasterWaveformWidget::getWaveformWidgetName();
+            useOpenGl = RGBRasterWaveformWidget::useOpenGl();
+            useOpenGles = RGBRasterWaveformWidget::useOpenGles();
+            useOpenGLShaders = RGBRasterWaveformWidget::useOpenGLShaders();
+            developerOnly = RGBRasterWaveformWidget::developerOnly();
+            break;
 #endif
         case WaveformWidgetType::QtSimpleWaveform:
             widgetName = QtSimpleWaveformWidget::getWaveformWidgetName();
@@ -974,6 +1020,9 @@ WaveformWidgetAbstract* WaveformWidgetFactory::createWaveformWidget(
         case WaveformWidgetType::RGBWaveform:
             widget = new RGBWaveformWidget(viewer->getGroup(), viewer);
             break;
+        case WaveformWidgetType::RGBRasterWaveform:
+            widget = new RGBRasterWaveformWidget(viewer->getGroup(), viewer);
+            break;
         case WaveformWidgetType::QtSimpleWaveform:
             widget = new QtSimpleWaveformWidget(viewer->getGroup(), viewer);
             break;
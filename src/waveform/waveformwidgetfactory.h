@@ -1,6 +1,8 @@
 #pragma once
 
 #include <QObject>
+#include <QThreadPool>
+#include <QVarLengthArray>
 #include <QVector>
 #include <vector>
 
@@ -160,6 +162,7 @@ class WaveformWidgetFactory : public QObject, public Singleton<WaveformWidgetFac
 
   private:
     void evaluateWidgets();
+    void renderOffscreen(const QVarLengthArray<WaveformWidgetAbstract*, 10>& waveformWidgets);
     WaveformWidgetAbstract* createWaveformWidget(WaveformWidgetType::Type type, WWaveformViewer* viewer);
     int findIndexOf(WWaveformViewer* viewer) const;
 
@@ -194,6 +197,7 @@ class WaveformWidgetFactory : public QObject, public Singleton<WaveformWidgetFac
     VSyncThread* m_vsyncThread;
     GuiTick* m_pGuiTick;  // not owned
     VisualsManager* m_pVisualsManager;  // not owned
+    QThreadPool m_offscreenRenderThreadPool;
 
     //Debug
     PerformanceTimer m_time;
@@ -0,0 +1,50 @@
+#include "waveform/widgets/rgbrasterwaveformwidget.h"
+
+#include <QPainter>
+
+#include "moc_rgbrasterwaveformwidget.cpp"
+#include "waveform/renderers/waveformrenderbackground.h"
+#include "waveform/renderers/waveformrenderbeat.h"
+#include "waveform/renderers/waveformrendererendoftrack.h"
+#include "waveform/renderers/waveformrendererpreroll.h"
+#include "waveform/renderers/waveformrendererrgbraster.h"
+#include "waveform/renderers/waveformrendermark.h"
+#include "waveform/renderers/waveformrendermarkrange.h"
+#include "waveform/renderers/waveformwidgetrenderer.h"
+
+RGBRasterWaveformWidget::RGBRasterWaveformWidget(const QString& group, QWidget* parent)
+        : NonGLWaveformWidgetAbstract(group, parent) {
+    addRenderer<WaveformRenderBackground>();
+    addRenderer<WaveformRendererEndOfTrack>();
+    addRenderer<WaveformRendererPreroll>();
+    addRenderer<WaveformRenderMarkRange>();
+    m_pRasterRenderer = addRenderer<WaveformRendererRGBRaster>();
+    addRenderer<WaveformRenderBeat>();
+    addRenderer<WaveformRenderMark>();
+
+    setAttribute(Qt::WA_NoSystemBackground);
+    setAttribute(Qt::WA_OpaquePaintEvent);
+
+    m_initSuccess = init();
+}
+
+RGBRasterWaveformWidget::~RGBRasterWaveformWidget() {
+}
+
+void RGBRasterWaveformWidget::castToQWidget() {
+    m_widget = this;
+}
+
+void RGBRasterWaveformWidget::preRender(VSyncThread* vsyncThread) {
+    NonGLWaveformWidgetAbstract::preRender(vsyncThread);
+    m_pRasterRenderer->prepareImage();
+}
+
+void RGBRasterWaveformWidget::renderOffscreen() {
+    m_pRasterRenderer->renderImage();
+}
+
+void RGBRasterWaveformWidget::paintEvent(QPaintEvent* event) {
+    QPainter painter(this);
+    draw(&painter, event);
+}
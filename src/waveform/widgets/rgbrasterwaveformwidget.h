@@ -0,0 +1,43 @@
+#pragma once
+
+#include <QWidget>
+
+#include "nonglwaveformwidgetabstract.h"
+
+class WaveformRendererRGBRaster;
+
+/// The RGB waveform of RGBWaveformWidget, rasterized into images that are
+/// rendered concurrently for all decks. Intended for systems without GPU
+/// acceleration where drawing the waveform line by line with QPainter is
+/// too slow.
+class RGBRasterWaveformWidget : public NonGLWaveformWidgetAbstract {
+    Q_OBJECT
+  public:
+    ~RGBRasterWaveformWidget() override;
+
+    WaveformWidgetType::Type getType() const override {
+        return WaveformWidgetType::RGBRasterWaveform;
+    }
+
+    static inline QString getWaveformWidgetName() { return tr("RGB Raster"); }
+    static inline bool useOpenGl() { return false; }
+    static inline bool useOpenGles() { return false; }
+    static inline bool useOpenGLShaders() { return false; }
+    static inline bool developerOnly() { return false; }
+
+    void preRender(VSyncThread* vsyncThread) override;
+    bool hasOffscreenRendering() const override {
+        return true;
+    }
+    void renderOffscreen() override;
+
+  protected:
+    void castToQWidget() override;
+    void paintEvent(QPaintEvent* event) override;
+
+  private:
+    RGBRasterWaveformWidget(const QString& group, QWidget* parent);
+    friend class WaveformWidgetFactory;
+
+    WaveformRendererRGBRaster* m_pRasterRenderer;
+};
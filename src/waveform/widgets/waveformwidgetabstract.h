@@ -29,6 +29,15 @@ class WaveformWidgetAbstract : public WaveformWidgetRenderer {
     void release();
 
     virtual void preRender(VSyncThread* vsyncThread);
+    /// Widgets that render parts of their content without a QPainter on
+    /// the widget, e.g. into an image, may do so in renderOffscreen(). The
+    /// factory invokes it after preRender() on worker threads concurrently
+    /// for all such widgets. The QWidget must not be accessed.
+    virtual bool hasOffscreenRendering() const {
+        return false;
+    }
+    virtual void renderOffscreen() {
+    }
     virtual mixxx::Duration render();
     virtual void resize(int width, int height);
 
@@ -22,6 +22,7 @@ class WaveformWidgetType {
         QtHSVWaveform,           // 14 HSV Qt
         QtRGBWaveform,           // 15 RGB Qt
         GLSLRGBStackedWaveform,  // 16 RGB Stacked
-        Count_WaveformwidgetType // 17 Also used as invalid value
+        RGBRasterWaveform,       // 17 RGB Raster
+        Count_WaveformwidgetType // 18 Also used as invalid value
     };
 };
@@ -46,6 +46,8 @@ WOverview::WOverview(
         QWidget* parent)
         : WWidget(parent),
           m_actualCompletion(0),
+          m_scaledCompletion(0),
+          m_scaledPixmapDone(false),
           m_pixmapDone(false),
           m_waveformPeak(-1.0),
           m_diffGain(0),
@@ -64,6 +66,8 @@ WOverview::WOverview(
           m_bTimeRulerActive(false),
           m_orientation(Qt::Horizontal),
           m_iLabelFontSize(10),
+          m_marksImageDirty(true),
+          m_marksImageGain(0.0f),
           m_a(1.0),
           m_b(0.0),
           m_analyzerProgress(kAnalyzerProgressUnknown),
@@ -284,6 +288,7 @@ void WOverview::slotWaveformSummaryUpdated() {
         // If the waveform is already complete, just draw it.
         if (m_pWaveform->getCompletion() == m_pWaveform->getDataSize()) {
             m_actualCompletion = 0;
+            m_waveformImageScaled = QImage();
             if (drawNextPixmapPart()) {
                 update();
             }
@@ -291,6 +296,7 @@ void WOverview::slotWaveformSummaryUpdated() {
     } else {
         // Null waveform pointer means waveform was cleared.
         m_waveformSourceImage = QImage();
+        m_waveformImageScaled = QImage();
         m_analyzerProgress = kAnalyzerProgressUnknown;
         m_actualCompletion = 0;
         m_waveformPeak = -1.0;
@@ -335,12 +341,15 @@ void WOverview::slotLoadingTrack(TrackPointer pNewTrack, TrackPointer pOldTrack)
     }
 
     m_waveformSourceImage = QImage();
+    m_waveformImageScaled = QImage();
     m_analyzerProgress = kAnalyzerProgressUnknown;
     m_actualCompletion = 0;
     m_waveformPeak = -1.0;
     m_pixmapDone = false;
     m_trackLoaded = false;
     m_endOfTrack = false;
+    m_marksImageDirty = true;
+    m_marksImageHoveredMark.clear();
 
     if (pNewTrack) {
         m_pCurrentTrack = pNewTrack;
@@ -377,6 +386,7 @@ void WOverview::onMarkChanged(double v) {
 void WOverview::onMarkRangeChange(double v) {
     Q_UNUSED(v);
     //qDebug() << "WOverview::onMarkRangeChange()" << v;
+    m_marksImageDirty = true;
     update();
 }
 
@@ -397,6 +407,7 @@ void WOverview::onPassthroughChange(double v) {
 }
 
 void WOverview::updateCues(const QList<CuePointer> &loadedCues) {
+    m_marksImageDirty = true;
     m_marksToRender.clear();
     for (const CuePointer& currentCue : loadedCues) {
         const WaveformMarkPointer pMark = m_marks.getHotCueMark(currentCue->getHotCue());
@@ -633,8 +644,8 @@ void WOverview::paintEvent(QPaintEvent* pEvent) {
             const auto gain = static_cast<CSAMPLE_GAIN>(length() - 2) /
                     static_cast<CSAMPLE_GAIN>(m_trackSamplesControl->get());
 
-            drawRangeMarks(&painter, offset, gain);
-            drawMarks(&painter, offset, gain);
+            drawMarksLayer(&painter, offset, gain);
+            prerenderCuePositionLabels(&painter);
             drawPickupPosition(&painter);
             drawTimeRuler(&painter);
             drawMarkLabels(&painter, offset, gain);
@@ -682,27 +693,89 @@ void WOverview::drawWaveformPixmap(QPainter* pPainter) {
             diffGain = 255.0f - (255.0f / visualGain);
         }
 
-        if (m_diffGain != diffGain || m_waveformImageScaled.isNull()) {
-            QRect sourceRect(0,
-                    static_cast<int>(diffGain),
+        if (m_diffGain != diffGain || m_waveformImageScaled.isNull() ||
+                m_scaledCompletion > m_actualCompletion ||
+                (m_pixmapDone && !m_scaledPixmapDone)) {
+            // Scale the whole image only after resizing, loading a track,
+            // changing the gain or finishing the waveform. The parts that
+            // are scaled separately while the analyzer is running are not
+            // smoothed across their borders. These seams are replaced once
+            // the waveform is complete.
+            m_waveformImageScaled = scaleWaveformSourceImage(0,
                     m_waveformSourceImage.width(),
-                    m_waveformSourceImage.height() -
-                            2 * static_cast<int>(diffGain));
-            QImage croppedImage = m_waveformSourceImage.copy(sourceRect);
-            if (m_orientation == Qt::Vertical) {
-                // Rotate pixmap
-                croppedImage = croppedImage.transformed(QTransform(0, 1, 1, 0, 0, 0));
-            }
-            m_waveformImageScaled = croppedImage.scaled(size() * m_devicePixelRatio,
-                    Qt::IgnoreAspectRatio,
-                    Qt::SmoothTransformation);
+                    diffGain,
+                    size() * m_devicePixelRatio);
             m_diffGain = diffGain;
+            m_scaledCompletion = m_actualCompletion;
+            m_scaledPixmapDone = m_pixmapDone;
+        } else if (m_scaledCompletion < m_actualCompletion) {
+            // While the analyzer is filling the waveform summary only the
+            // columns that have been drawn since the last paint are scaled.
+            updateScaledWaveformImage(m_scaledCompletion / 2, m_actualCompletion / 2);
+            m_scaledCompletion = m_actualCompletion;
         }
 
         pPainter->drawImage(rect(), m_waveformImageScaled);
     }
 }
 
+QImage WOverview::scaleWaveformSourceImage(int firstColumn,
+        int endColumn,
+        float diffGain,
+        const QSize& scaledSize) const {
+    QRect sourceRect(firstColumn,
+            static_cast<int>(diffGain),
+            endColumn - firstColumn,
+            m_waveformSourceImage.height() - 2 * static_cast<int>(diffGain));
+    QImage croppedImage = m_waveformSourceImage.copy(sourceRect);
+    if (m_orientation == Qt::Vertical) {
+        // Rotate pixmap
+        croppedImage = croppedImage.transformed(QTransform(0, 1, 1, 0, 0, 0));
+    }
+    return croppedImage.scaled(scaledSize,
+            Qt::IgnoreAspectRatio,
+            Qt::SmoothTransformation);
+}
+
+void WOverview::updateScaledWaveformImage(int firstColumn, int endColumn) {
+    ScopedTimer t("WOverview::updateScaledWaveformImage");
+
+    // Map the changed columns of the source image to the scaled image and
+    // back to get the source columns of whole scaled pixels
+    const auto sourceLength = static_cast<qint64>(m_waveformSourceImage.width());
+    const auto scaledLength = static_cast<qint64>(m_orientation == Qt::Horizontal
+                    ? m_waveformImageScaled.width()
+                    : m_waveformImageScaled.height());
+    if (sourceLength == 0 || scaledLength == 0) {
+        return;
+    }
+    const auto scaledBegin = static_cast<int>(firstColumn * scaledLength / sourceLength);
+    const auto scaledEnd = static_cast<int>(math_min(scaledLength,
+            (endColumn * scaledLength + sourceLength - 1) / sourceLength));
+    if (scaledBegin >= scaledEnd) {
+        return;
+    }
+    const auto sourceBegin = static_cast<int>(scaledBegin * sourceLength / scaledLength);
+    const auto sourceEnd = static_cast<int>(math_min(sourceLength,
+            (scaledEnd * sourceLength + scaledLength - 1) / scaledLength));
+
+    QSize scaledSize;
+    QPoint scaledPosition;
+    if (m_orientation == Qt::Horizontal) {
+        scaledSize = QSize(scaledEnd - scaledBegin, m_waveformImageScaled.height());
+        scaledPosition = QPoint(scaledBegin, 0);
+    } else {
+        scaledSize = QSize(m_waveformImageScaled.width(), scaledEnd - scaledBegin);
+        scaledPosition = QPoint(0, scaledBegin);
+    }
+    const QImage scaledImage =
+            scaleWaveformSourceImage(sourceBegin, sourceEnd, m_diffGain, scaledSize);
+
+    QPainter painter(&m_waveformImageScaled);
+    painter.setCompositionMode(QPainter::CompositionMode_Source);
+    painter.drawImage(scaledPosition, scaledImage);
+}
+
 void WOverview::drawPlayedOverlay(QPainter* pPainter) {
     // Overlay the played part of the overview-waveform with a skin defined color
     if (!m_waveformSourceImage.isNull() && m_playedOverlayColor.alpha() > 0) {
@@ -831,6 +904,34 @@ void WOverview::drawRangeMarks(QPainter* pPainter, const float& offset, const fl
     }
 }
 
+void WOverview::drawMarksLayer(QPainter* pPainter, const float offset, const float gain) {
+    // The range marks, the lines of the marks and their prerendered labels
+    // don't change with the play position. Only render them again if the
+    // marks, the size of the widget, the length of the track or the hovered
+    // mark, which is allowed to overlap the following labels, have changed.
+    if (m_marksImageDirty ||
+            m_marksImageGain != gain ||
+            m_marksImageHoveredMark != m_pHoveredMark) {
+        ScopedTimer t("WOverview::drawMarksLayer");
+        const QSize imageSize = size() * m_devicePixelRatio;
+        if (m_marksImage.size() != imageSize) {
+            m_marksImage = QImage(imageSize, QImage::Format_ARGB32_Premultiplied);
+        }
+        m_marksImage.setDevicePixelRatio(m_devicePixelRatio);
+        m_marksImage.fill(Qt::transparent);
+
+        QPainter painter(&m_marksImage);
+        painter.setFont(pPainter->font());
+        drawRangeMarks(&painter, offset, gain);
+        drawMarks(&painter, offset, gain);
+
+        m_marksImageDirty = false;
+        m_marksImageGain = gain;
+        m_marksImageHoveredMark = m_pHoveredMark;
+    }
+    pPainter->drawImage(QPointF(0, 0), m_marksImage);
+}
+
 void WOverview::drawMarks(QPainter* pPainter, const float offset, const float gain) {
     QFont markerFont = pPainter->font();
     markerFont.setPixelSize(static_cast<int>(m_iLabelFontSize * m_scaleFactor));
@@ -849,7 +950,6 @@ void WOverview::drawMarks(QPainter* pPainter, const float offset, const float ga
     // drawMarkLabels function so it can be called after drawCurrentPosition so
     // the view of labels is not obscured by the playhead.
 
-    bool markHovered = false;
     for (int i = 0; i < m_marksToRender.size(); ++i) {
         WaveformMarkPointer pMark = m_marksToRender.at(i);
         PainterScope painterScope(pPainter);
@@ -979,72 +1079,81 @@ void WOverview::drawMarks(QPainter* pPainter, const float offset, const float ga
                     width(),
                     devicePixelRatioF());
         }
+    }
+}
 
-        // Show cue position when hovered
-        // The area it will be drawn in needs to be calculated here
-        // before drawMarkLabels so drawMarkLabels can avoid drawing
-        // labels over the cue position.
-        // This can happen for example if the user shows the cue position
-        // of a hotcue which is near the intro end position because the
-        // intro_end_position WaveformMark label is drawn at the top.
-        // However, the drawing of this text needs to happen in
-        // drawMarkLabels so none of the WaveformMark lines are drawn
-        // on top of the position text.
-
-        // WaveformMark::m_align refers to the alignment of the label,
-        // so if the label is on bottom draw the position text on top and
-        // vice versa.
-        if (pMark == m_pHoveredMark) {
-            Qt::Alignment valign = pMark->m_align & Qt::AlignVertical_Mask;
-            QPointF positionTextPoint(markPosition + 1.5, 0);
-            if (valign == Qt::AlignTop) {
-                positionTextPoint.setY(float(height()) - 0.5f);
-            } else {
-                positionTextPoint.setY(fontMetrics.height());
-            }
-
-            double markSamples = pMark->getSamplePosition();
-            double trackSamples = m_trackSamplesControl->get();
-            double currentPositionSamples = m_playpositionControl->get() * trackSamples;
-            double markTime = samplePositionToSeconds(markSamples);
-            double markTimeRemaining = samplePositionToSeconds(trackSamples - markSamples);
-            double markTimeDistance = samplePositionToSeconds(markSamples - currentPositionSamples);
-            QString cuePositionText = mixxx::Duration::formatTime(markTime) + " -" +
-                    mixxx::Duration::formatTime(markTimeRemaining);
-            QString cueTimeDistanceText = mixxx::Duration::formatTime(fabs(markTimeDistance));
-            // Cast to int to avoid confusingly switching from -0:00 to 0:00 as
-            // the playhead passes the cue
-            if (static_cast<int>(markTimeDistance) < 0) {
-                cueTimeDistanceText = "-" + cueTimeDistanceText;
-            }
-
-            m_cuePositionLabel.prerender(positionTextPoint,
-                    QPixmap(),
-                    cuePositionText,
-                    markerFont,
-                    m_labelTextColor,
-                    m_labelBackgroundColor,
-                    width(),
-                    devicePixelRatioF());
+void WOverview::prerenderCuePositionLabels(QPainter* pPainter) {
+    if (!m_pHoveredMark || !m_marksToRender.contains(m_pHoveredMark)) {
+        m_cuePositionLabel.clear();
+        m_cueTimeDistanceLabel.clear();
+        return;
+    }
 
-            QPointF timeDistancePoint(positionTextPoint.x(),
-                    (fontMetrics.height() + height()) / 2);
+    QFont markerFont = pPainter->font();
+    markerFont.setPixelSize(static_cast<int>(m_iLabelFontSize * m_scaleFactor));
+    QFontMetricsF fontMetrics(markerFont);
 
-            m_cueTimeDistanceLabel.prerender(timeDistancePoint,
-                    QPixmap(),
-                    cueTimeDistanceText,
-                    markerFont,
-                    m_labelTextColor,
-                    m_labelBackgroundColor,
-                    width(),
-                    devicePixelRatioF());
-            markHovered = true;
-        }
+    // Show cue position when hovered
+    // The area it will be drawn in needs to be calculated here
+    // before drawMarkLabels so drawMarkLabels can avoid drawing
+    // labels over the cue position.
+    // This can happen for example if the user shows the cue position
+    // of a hotcue which is near the intro end position because the
+    // intro_end_position WaveformMark label is drawn at the top.
+    // However, the drawing of this text needs to happen in
+    // drawMarkLabels so none of the WaveformMark lines are drawn
+    // on top of the position text.
+    // In contrast to the marks layer this is updated on every paint,
+    // because the time distance depends on the play position.
+
+    // WaveformMark::m_align refers to the alignment of the label,
+    // so if the label is on bottom draw the position text on top and
+    // vice versa.
+    const WaveformMarkPointer& pMark = m_pHoveredMark;
+    const float markPosition = pMark->m_linePosition;
+    Qt::Alignment valign = pMark->m_align & Qt::AlignVertical_Mask;
+    QPointF positionTextPoint(markPosition + 1.5, 0);
+    if (valign == Qt::AlignTop) {
+        positionTextPoint.setY(float(height()) - 0.5f);
+    } else {
+        positionTextPoint.setY(fontMetrics.height());
     }
-    if (!markHovered) {
-        m_cuePositionLabel.clear();
-        m_cueTimeDistanceLabel.clear();
+
+    double markSamples = pMark->getSamplePosition();
+    double trackSamples = m_trackSamplesControl->get();
+    double currentPositionSamples = m_playpositionControl->get() * trackSamples;
+    double markTime = samplePositionToSeconds(markSamples);
+    double markTimeRemaining = samplePositionToSeconds(trackSamples - markSamples);
+    double markTimeDistance = samplePositionToSeconds(markSamples - currentPositionSamples);
+    QString cuePositionText = mixxx::Duration::formatTime(markTime) + " -" +
+            mixxx::Duration::formatTime(markTimeRemaining);
+    QString cueTimeDistanceText = mixxx::Duration::formatTime(fabs(markTimeDistance));
+    // Cast to int to avoid confusingly switching from -0:00 to 0:00 as
+    // the playhead passes the cue
+    if (static_cast<int>(markTimeDistance) < 0) {
+        cueTimeDistanceText = "-" + cueTimeDistanceText;
     }
+
+    m_cuePositionLabel.prerender(positionTextPoint,
+            QPixmap(),
+            cuePositionText,
+            markerFont,
+            m_labelTextColor,
+            m_labelBackgroundColor,
+            width(),
+            devicePixelRatioF());
+
+    QPointF timeDistancePoint(positionTextPoint.x(),
+            (fontMetrics.height() + height()) / 2);
+
+    m_cueTimeDistanceLabel.prerender(timeDistancePoint,
+            QPixmap(),
+            cueTimeDistanceText,
+            markerFont,
+            m_labelTextColor,
+            m_labelBackgroundColor,
+            width(),
+            devicePixelRatioF());
 }
 
 void WOverview::drawPickupPosition(QPainter* pPainter) {
@@ -1289,6 +1398,7 @@ void WOverview::resizeEvent(QResizeEvent* pEvent) {
 
     m_waveformImageScaled = QImage();
     m_diffGain = 0;
+    m_marksImageDirty = true;
     Init();
 }
 
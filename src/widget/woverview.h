@@ -85,6 +85,11 @@ class WOverview : public WWidget, public TrackDropTarget {
 
     // Hold the last visual sample processed to generate the pixmap
     int m_actualCompletion;
+    // Hold the last visual sample that is contained in m_waveformImageScaled
+    int m_scaledCompletion;
+    // m_waveformImageScaled has been scaled at once from the complete
+    // waveform, i.e. without seams between incrementally scaled parts
+    bool m_scaledPixmapDone;
 
     bool m_pixmapDone;
     float m_waveformPeak;
@@ -111,12 +116,19 @@ class WOverview : public WWidget, public TrackDropTarget {
     void drawEndOfTrackBackground(QPainter* pPainter);
     void drawAxis(QPainter* pPainter);
     void drawWaveformPixmap(QPainter* pPainter);
+    QImage scaleWaveformSourceImage(int firstColumn,
+            int endColumn,
+            float diffGain,
+            const QSize& scaledSize) const;
+    void updateScaledWaveformImage(int firstColumn, int endColumn);
     void drawPlayedOverlay(QPainter* pPainter);
     void drawPlayPosition(QPainter* pPainter);
     void drawEndOfTrackFrame(QPainter* pPainter);
     void drawAnalyzerProgress(QPainter* pPainter);
     void drawRangeMarks(QPainter* pPainter, const float& offset, const float& gain);
+    void drawMarksLayer(QPainter* pPainter, const float offset, const float gain);
     void drawMarks(QPainter* pPainter, const float offset, const float gain);
+    void prerenderCuePositionLabels(QPainter* pPainter);
     void drawPickupPosition(QPainter* pPainter);
     void drawTimeRuler(QPainter* pPainter);
     void drawMarkLabels(QPainter* pPainter, const float offset, const float gain);
@@ -189,6 +201,13 @@ class WOverview : public WWidget, public TrackDropTarget {
     WaveformMarkLabel m_cuePositionLabel;
     WaveformMarkLabel m_cueTimeDistanceLabel;
 
+    // Cached layer with the range marks and the lines of the marks that is
+    // only rendered again when the marks, the size or the hovered mark change
+    QImage m_marksImage;
+    bool m_marksImageDirty;
+    float m_marksImageGain;
+    WaveformMarkPointer m_marksImageHoveredMark;
+
     // Coefficient value-position linear transposition
     double m_a;
     double m_b;
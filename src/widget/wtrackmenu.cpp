@@ -7,6 +7,8 @@
 #include <QInputDialog>
 #include <QListWidget>
 #include <QModelIndex>
+#include <QPointer>
+#include <QProgressDialog>
 #include <QVBoxLayout>
 
 #include "analyzer/analyzerscheduledtrack.h"
@@ -24,6 +26,7 @@
 #include "library/librarytablemodel.h"
 #include "library/trackcollection.h"
 #include "library/trackcollectionmanager.h"
+#include "library/trackmetadataimportservice.h"
 #include "library/trackmodel.h"
 #include "library/trackmodeliterator.h"
 #include "library/trackprocessing.h"
@@ -1098,31 +1101,6 @@ void WTrackMenu::slotSelectInLibrary() {
     }
 }
 
-namespace {
-
-class ImportMetadataFromFileTagsTrackPointerOperation : public mixxx::TrackPointerOperation {
-  public:
-    explicit ImportMetadataFromFileTagsTrackPointerOperation(
-            const UserSettings& userSettings)
-            : m_params(SyncTrackMetadataParams::readFromUserSettings(userSettings)) {
-    }
-
-  private:
-    void doApply(
-            const TrackPointer& pTrack) const override {
-        // The user has explicitly requested to reload metadata from the file
-        // to override the information within Mixxx! Custom cover art must be
-        // reloaded separately.
-        SoundSourceProxy(pTrack).updateTrackFromSource(
-                SoundSourceProxy::UpdateTrackFromSourceMode::Always,
-                m_params);
-    }
-
-    const SyncTrackMetadataParams m_params;
-};
-
-} // anonymous namespace
-
 void WTrackMenu::slotUpdateReplayGainFromPregain() {
     VERIFY_OR_DEBUG_ASSERT(m_pTrack) {
         return;
@@ -1139,18 +1117,80 @@ void WTrackMenu::slotUpdateReplayGainFromPregain() {
     m_pTrack->adjustReplayGainFromPregain(gain);
 }
 
+namespace {
+
+// Shared by all track menus, because the progress of the
+// TrackMetadataImportService covers all pending requests
+QPointer<QProgressDialog> s_pImportMetadataProgressDlg;
+
+void showImportMetadataProgress(
+        const QString& labelText,
+        TrackMetadataImportService* pImportService) {
+    if (s_pImportMetadataProgressDlg) {
+        return;
+    }
+    // The import runs in the background. The non-modal dialog shows
+    // the progress and allows to cancel it while the library remains
+    // usable.
+    auto* pProgressDlg = new QProgressDialog(
+            labelText,
+            QObject::tr("Cancel"),
+            0,
+            0);
+    pProgressDlg->setWindowModality(Qt::NonModal);
+    pProgressDlg->setAutoReset(false);
+    pProgressDlg->setMinimumDuration(
+            mixxx::TaskMonitor::kDefaultMinimumProgressDuration.toIntegerMillis());
+    QObject::connect(pImportService,
+            &TrackMetadataImportService::progressChanged,
+            pProgressDlg,
+            [pProgressDlg](int finishedCount, int totalCount) {
+                if (finishedCount >= totalCount) {
+                    pProgressDlg->deleteLater();
+                    return;
+                }
+                pProgressDlg->setMaximum(totalCount);
+                pProgressDlg->setValue(finishedCount);
+            });
+    QObject::connect(pProgressDlg,
+            &QProgressDialog::canceled,
+            pImportService,
+            [pProgressDlg, pImportService] {
+                // Requests that are already in progress are finished
+                // and saved
+                pImportService->cancel();
+                pProgressDlg->deleteLater();
+            });
+    s_pImportMetadataProgressDlg = pProgressDlg;
+}
+
+} // anonymous namespace
+
 void WTrackMenu::slotImportMetadataFromFileTags() {
-    const auto progressLabelText =
-            tr("Importing metadata of %n track(s) from file tags", "", getTrackCount());
-    const auto trackOperator =
-            ImportMetadataFromFileTagsTrackPointerOperation(*m_pConfig);
-    applyTrackPointerOperation(
-            progressLabelText,
-            &trackOperator,
-            // Update the database to reflect the recent changes. This is
-            // crucial for additional metadata like custom tags that are
-            // directly fetched from the database for certain use cases!
-            mixxx::ModalTrackBatchOperationProcessor::Mode::ApplyAndSave);
+    const auto trackRefs = getTrackRefs();
+    if (trackRefs.isEmpty()) {
+        return;
+    }
+    auto* pImportService =
+            m_pLibrary->trackCollectionManager()->metadataImportService();
+    showImportMetadataProgress(
+            tr("Importing metadata of %n track(s) from file tags", "", getTrackCount()),
+            pImportService);
+    // The user has explicitly requested to reload metadata from the file
+    // to override the information within Mixxx! Custom cover art must be
+    // reloaded separately.
+    // Files are read in the background. Modified tracks are saved to update
+    // the database to reflect the recent changes. This is crucial for
+    // additional metadata like custom tags that are directly fetched from
+    // the database for certain use cases!
+    pImportService->importTrackMetadata(
+            trackRefs,
+            SoundSourceProxy::UpdateTrackFromSourceMode::Always,
+            SyncTrackMetadataParams::readFromUserSettings(*m_pConfig));
+    if (pImportService->pendingCount() == 0 && s_pImportMetadataProgressDlg) {
+        // Nothing to do, e.g. all files are already being read
+        s_pImportMetadataProgressDlg->deleteLater();
+    }
 }
 
 namespace {
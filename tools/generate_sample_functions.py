@@ -3,7 +3,7 @@ import argparse
 import sys
 
 # To use, run this from the top level of the Git repository tree:
-# scripts/generate_sample_functions.py
+# tools/generate_sample_functions.py
 #     --sample_autogen_h src/util/sample_autogen.h
 
 BASIC_INDENT = 4
@@ -22,6 +22,13 @@ def copy_with_ramping_gain_method_name(i):
     return RAMPING_GAIN_METHOD_PATTERN % {"i": i}
 
 
+# The ramping functions with a hand-vectorized loop in mixxx::SampleKernels
+RAMPING_GAIN_KERNELS = {
+    1: "copyWithRampingGain",
+    2: "copy2WithRampingGain",
+}
+
+
 def method_call(method_name, args):
     return "%(method_name)s(%(args)s)" % {
         "method_name": method_name,
@@ -44,19 +51,16 @@ def hanging_indent(base, groups, hanging_suffix, terminator, depth=0):
 
 
 def write_sample_autogen(output, num_channels):
-    output.append("#ifndef MIXXX_UTIL_SAMPLEAUTOGEN_H")
-    output.append("#define MIXXX_UTIL_SAMPLEAUTOGEN_H")
+    output.append("#pragma once")
     output.append("////////////////////////////////////////////////////////")
     output.append("// THIS FILE IS AUTO-GENERATED. DO NOT EDIT DIRECTLY! //")
-    output.append("// SEE scripts/generate_sample_functions.py           //")
+    output.append("// SEE tools/generate_sample_functions.py             //")
     output.append("////////////////////////////////////////////////////////")
 
     for i in range(1, num_channels + 1):
         copy_with_gain(output, 0, i)
         copy_with_ramping_gain(output, 0, i)
 
-    output.append("#endif /* MIXXX_UTIL_SAMPLEAUTOGEN_H */")
-
 
 def copy_with_gain(output, base_indent_depth, num_channels):
     def write(data, depth=0):
@@ -192,6 +196,28 @@ def copy_with_ramping_gain(output, base_indent_depth, num_channels):
             depth=1,
         )
 
+    if num_channels in RAMPING_GAIN_KERNELS:
+        args = (
+            ["pDest"]
+            + [
+                "pSrc%(i)d, start_gain%(i)d, gain_delta%(i)d" % {"i": i}
+                for i in range(num_channels)
+            ]
+            + ["iNumSamples / 2"]
+        )
+        output.extend(
+            hanging_indent(
+                "mixxx::SampleKernels::active().%s("
+                % RAMPING_GAIN_KERNELS[num_channels],
+                args,
+                ",",
+                ");",
+                depth=1,
+            )
+        )
+        write("}")
+        return
+
     write("// note: LOOP VECTORIZED.", depth=1)
     write("for (int i = 0; i < iNumSamples / 2; ++i) {", depth=1)
 